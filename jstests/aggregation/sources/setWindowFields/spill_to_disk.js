@@ -240,6 +240,41 @@ assert.eq(results.length, numDocs);
 for (let i = 0; i < numDocs; i++) {
     assert.eq(results[i].arr, 616605, results);
 }
+// Test that sliding windows over removable functions give the correct results when the documents
+// they remove have been spilled to disk.
+const windowSize = 600;
+setParameterOnAllHosts(DiscoverTopology.findNonConfigNodes(db.getMongo()),
+                       "internalDocumentSourceSetWindowFieldsMaxMemoryBytes",
+                       200 * avgDocSize);
+for (let window of [{documents: [-windowSize, 0]}, {range: [-windowSize, 0]}]) {
+    resetProfiler(db);
+    results = coll.aggregate(
+                      [
+                          {
+                              $setWindowFields: {
+                                  sortBy: {val: 1},
+                                  output: {
+                                      sum: {$sum: "$val", window: window},
+                                      avg: {$avg: "$val", window: window},
+                                      stdDev: {$stdDevPop: "$val", window: window}
+                                  }
+                              }
+                          },
+                          {$sort: {_id: 1}}
+                      ],
+                      {allowDiskUse: true})
+                  .toArray();
+    checkProfilerForDiskWrite(db);
+    assert.eq(results.length, numDocs);
+    for (let i = 0; i < numDocs; i++) {
+        // The window holds the consecutive integers from 'lower' to 'i'.
+        const lower = Math.max(0, i - windowSize);
+        const count = i - lower + 1;
+        assert.eq(results[i].sum, (lower + i) * count / 2, results[i]);
+        assert.close(results[i].avg, (lower + i) / 2, results[i]);
+        assert.close(results[i].stdDev, Math.sqrt((count * count - 1) / 12), results[i]);
+    }
+}
 // Reset limit for other tests.
 setParameterOnAllHosts(DiscoverTopology.findNonConfigNodes(db.getMongo()),
                        "internalDocumentSourceSetWindowFieldsMaxMemoryBytes",
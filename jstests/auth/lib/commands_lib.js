@@ -290,6 +290,42 @@ var authCommandsLib = {
               {runOnDb: secondDbName, roles: {}}
           ]
         },
+        {
+          testname: "analyze",
+          command: {analyze: "foo", key: "a"},
+          skipSharded: true,
+          setup: function(db) {
+              assert.commandWorked(db.foo.insert({a: 1}));
+          },
+          teardown: function(db) {
+              db.foo.drop();
+              db.getCollection("system.statistics.foo").drop();
+          },
+          testcases: [
+              {
+                runOnDb: firstDbName,
+                roles: {root: 1, __system: 1},
+                privileges: [
+                    {resource: {db: firstDbName, collection: "foo"}, actions: ["find"]},
+                    {
+                      resource: {db: firstDbName, collection: "system.statistics.foo"},
+                      actions: ["insert", "update"]
+                    }
+                ]
+              },
+              {
+                runOnDb: secondDbName,
+                roles: {root: 1, __system: 1},
+                privileges: [
+                    {resource: {db: secondDbName, collection: "foo"}, actions: ["find"]},
+                    {
+                      resource: {db: secondDbName, collection: "system.statistics.foo"},
+                      actions: ["insert", "update"]
+                    }
+                ]
+              }
+          ]
+        },
         {
           testname: "addShard",
           command: {addShard: "x"},
@@ -0,0 +1,78 @@
+/**
+ * Tests that the statistics built by the 'analyze' command are used for cardinality estimation.
+ */
+(function() {
+"use strict";
+
+load("jstests/libs/optimizer_utils.js");  // For checkCascadesOptimizerEnabled.
+if (!checkCascadesOptimizerEnabled(db)) {
+    jsTestLog("Skipping test because the optimizer is not enabled");
+    return;
+}
+
+const coll = db.cqf_histogram;
+coll.drop();
+db.getCollection("system.statistics." + coll.getName()).drop();
+
+const bulk = coll.initializeUnorderedBulkOp();
+const nDocs = 10000;
+
+// The values of 'a' are skewed so that the estimate differs from both the heuristic and uniform
+// estimates: 70% of the documents have 'a' below 1.
+Random.srand(0);
+for (let i = 0; i < nDocs; i++) {
+    const valA = (i % 10 < 7) ? Random.rand() : 1.0 + 9.0 * Random.rand();
+    bulk.insert({a: valA, b: i});
+}
+assert.commandWorked(bulk.execute());
+
+const getSamplingParam = {getParameter: 1, internalQueryEnableSamplingCardinalityEstimator: 1};
+const samplingParam = assert.commandWorked(db.adminCommand(getSamplingParam))
+                          .internalQueryEnableSamplingCardinalityEstimator;
+assert.commandWorked(
+    db.adminCommand({setParameter: 1, internalQueryEnableSamplingCardinalityEstimator: false}));
+
+try {
+    assert.commandFailedWithCode(db.runCommand({analyze: coll.getName(), key: "$a"}), 7131820);
+    assert.commandFailedWithCode(db.runCommand({analyze: "cqf_histogram_missing", key: "a"}),
+                                 ErrorCodes.NamespaceNotFound);
+    assert.commandWorked(db.runCommand({analyze: coll.getName(), key: "a", numberBuckets: 20}));
+
+    const statsDoc = db.getCollection("system.statistics." + coll.getName()).findOne({_id: "a"});
+    assert.neq(null, statsDoc);
+    assert.eq(nDocs, statsDoc.numDocuments, statsDoc);
+    assert.lte(statsDoc.histogram.buckets.length, 20, statsDoc);
+
+    function getAdjustedCE(pipeline) {
+        const res = coll.explain().aggregate(pipeline);
+        assert(res.queryPlanner.winningPlan.optimizerPlan.hasOwnProperty("properties"));
+        return res.queryPlanner.winningPlan.optimizerPlan.properties.adjustedCE;
+    }
+
+    // Verify the winning plan cardinality is within roughly 10% of the expected documents.
+    let ce = getAdjustedCE([{$match: {a: {$lt: 1}}}]);
+    assert.lt(nDocs * 0.7 * 0.9, ce);
+    assert.gt(nDocs * 0.7 * 1.1, ce);
+
+    ce = getAdjustedCE([{$match: {a: {$gte: 1, $lt: 5.5}}}]);
+    assert.lt(nDocs * 0.15 * 0.9, ce);
+    assert.gt(nDocs * 0.15 * 1.1, ce);
+
+    // Statistics built from a sample give a similar estimate.
+    assert.commandWorked(db.runCommand({analyze: coll.getName(), key: "a", sampleSize: 2000}));
+    ce = getAdjustedCE([{$match: {a: {$lt: 1}}}]);
+    assert.lt(nDocs * 0.7 * 0.8, ce);
+    assert.gt(nDocs * 0.7 * 1.2, ce);
+
+    // The values read by 'analyze' must fit within its memory limit.
+    assert.commandWorked(
+        db.adminCommand({setParameter: 1, internalQueryAnalyzeMaxMemoryUsageBytes: 1024}));
+    assert.commandFailedWithCode(db.runCommand({analyze: coll.getName(), key: "a"}),
+                                 ErrorCodes.ExceededMemoryLimit);
+} finally {
+    assert.commandWorked(db.adminCommand(
+        {setParameter: 1, internalQueryEnableSamplingCardinalityEstimator: samplingParam}));
+    assert.commandWorked(db.adminCommand(
+        {setParameter: 1, internalQueryAnalyzeMaxMemoryUsageBytes: 100 * 1024 * 1024}));
+}
+}());
@@ -0,0 +1,225 @@
+(function() {
+"use strict";
+
+load("jstests/libs/optimizer_utils.js");  // For checkCascadesOptimizerEnabled.
+if (!checkCascadesOptimizerEnabled(db)) {
+    jsTestLog("Skipping test because the optimizer is not enabled");
+    return;
+}
+
+load("jstests/aggregation/extras/utils.js");  // For arrayEq.
+
+const orders = db.cqf_lookup_orders;
+const customers = db.cqf_lookup_customers;
+const items = db.cqf_lookup_items;
+orders.drop();
+customers.drop();
+items.drop();
+
+const nCustomers = 20;
+const nItems = 50;
+const nOrders = 500;
+
+let docs = [];
+for (let i = 0; i < nCustomers; i++) {
+    docs.push({_id: i, name: "customer" + i, vip: i % 5 == 0});
+}
+assert.commandWorked(customers.insert(docs));
+
+docs = [];
+for (let i = 0; i < nItems; i++) {
+    docs.push({_id: i, price: i * 10});
+}
+assert.commandWorked(items.insert(docs));
+
+docs = [];
+for (let i = 0; i < nOrders; i++) {
+    // Some orders refer to an unknown customer, and some have no item.
+    const order = {_id: i, customer: i % (nCustomers + 5)};
+    if (i % 7 != 0) {
+        order.detail = {item: i % nItems};
+    }
+    docs.push(order);
+}
+assert.commandWorked(orders.insert(docs));
+
+// The joins can only be implemented with an equality of the keys if non-multikey indexes prove that
+// no array appears along the local key paths. The foreign key paths are covered by the _id indexes.
+assert.commandWorked(orders.createIndex({customer: 1}));
+assert.commandWorked(orders.createIndex({"detail.item": 1}));
+
+// Computes the expected result of joining each order with its customer and item.
+function expectedResult(filterFn) {
+    const result = [];
+    for (let order of orders.find().toArray()) {
+        const customer = customers.findOne({_id: order.customer});
+        if (customer === null) {
+            continue;
+        }
+        if (order.detail === undefined) {
+            // A missing local field matches a foreign null, and there is no such item.
+            continue;
+        }
+        const item = items.findOne({_id: order.detail.item});
+        const doc = Object.assign({}, order, {customer_doc: customer, item_doc: item});
+        if (filterFn(doc)) {
+            result.push(doc);
+        }
+    }
+    return result;
+}
+
+function findNodeTypes(node, result) {
+    if (typeof node !== "object" || node === null) {
+        return result;
+    }
+    if (node.hasOwnProperty("nodeType")) {
+        result.push(node.nodeType);
+    }
+    for (let key of Object.keys(node)) {
+        findNodeTypes(node[key], result);
+    }
+    return result;
+}
+
+const pipeline = [
+    {
+        $lookup: {
+            from: customers.getName(),
+            localField: "customer",
+            foreignField: "_id",
+            as: "customer_doc"
+        }
+    },
+    {$unwind: "$customer_doc"},
+    {
+        $lookup:
+            {from: items.getName(), localField: "detail.item", foreignField: "_id", as: "item_doc"}
+    },
+    {$unwind: "$item_doc"},
+];
+
+let res = orders.aggregate(pipeline).toArray();
+let expected = expectedResult(doc => true);
+assert.eq(expected.length, res.length);
+assert(arrayEq(expected, res), {expected: expected, actual: res});
+
+// The joins are not implemented as nested loop joins.
+let explain = orders.explain().aggregate(pipeline);
+let nodeTypes = findNodeTypes(explain.queryPlanner.winningPlan.optimizerPlan, []);
+assert(!nodeTypes.includes("BinaryJoin"), nodeTypes);
+assert.eq(2,
+          nodeTypes.filter(type => type === "HashJoin" || type === "MergeJoin").length,
+          nodeTypes);
+
+// A filter on the joined documents is applied before the join.
+const filteredPipeline = pipeline.concat([{$match: {"customer_doc.vip": true}}]);
+res = orders.aggregate(filteredPipeline).toArray();
+expected = expectedResult(doc => doc.customer_doc.vip);
+assert.eq(expected.length, res.length);
+assert(arrayEq(expected, res), {expected: expected, actual: res});
+
+// Lookups into a non-existent collection return no results.
+res = orders
+          .aggregate([
+              {
+                  $lookup:
+                      {from: "non_existent", localField: "customer", foreignField: "_id", as: "c"}
+              },
+              {$unwind: "$c"}
+          ])
+          .toArray();
+assert.eq(0, res.length);
+
+// Nested loop joins produce the same results.
+assert.commandWorked(
+    db.adminCommand({setParameter: 1, internalCascadesOptimizerDisableHashJoin: true}));
+assert.commandWorked(
+    db.adminCommand({setParameter: 1, internalCascadesOptimizerDisableMergeJoin: true}));
+try {
+    res = orders.aggregate(filteredPipeline).toArray();
+    assert(arrayEq(expected, res), {expected: expected, actual: res});
+
+    explain = orders.explain().aggregate(filteredPipeline);
+    nodeTypes = findNodeTypes(explain.queryPlanner.winningPlan.optimizerPlan, []);
+    assert.eq(2, nodeTypes.filter(type => type === "BinaryJoin").length, nodeTypes);
+} finally {
+    assert.commandWorked(
+        db.adminCommand({setParameter: 1, internalCascadesOptimizerDisableHashJoin: false}));
+    assert.commandWorked(
+        db.adminCommand({setParameter: 1, internalCascadesOptimizerDisableMergeJoin: false}));
+}
+
+// Runs 'pipeline' over 'coll' with the Cascades optimizer and with the classic $lookup, and checks
+// that both produce the same results.
+function assertSameResultsAsClassic(coll, pipeline) {
+    const res = coll.aggregate(pipeline).toArray();
+    assert.commandWorked(
+        db.adminCommand({setParameter: 1, internalQueryEnableCascadesOptimizer: false}));
+    let expected;
+    try {
+        expected = coll.aggregate(pipeline).toArray();
+    } finally {
+        assert.commandWorked(
+            db.adminCommand({setParameter: 1, internalQueryEnableCascadesOptimizer: true}));
+    }
+    assert(arrayEq(expected, res), {expected: expected, actual: res});
+    return res;
+}
+
+// Arrays along the local key paths are matched element-wise, so an order refers to every customer
+// and item in its arrays. Duplicates within an array match a foreign document only once.
+assert.commandWorked(orders.insert([
+    {_id: nOrders, customer: [1, 2], detail: {item: 3}},
+    {_id: nOrders + 1, customer: 3, detail: [{item: 4}, {item: 4}, {item: [5, 6]}, {other: 1}]},
+    {_id: nOrders + 2, customer: [], detail: {item: 7}},
+]));
+res = assertSameResultsAsClassic(orders, pipeline);
+assert.eq(2, res.filter(doc => doc._id === nOrders).length, res);
+assert.eq(3, res.filter(doc => doc._id === nOrders + 1).length, res);
+assert.eq(0, res.filter(doc => doc._id === nOrders + 2).length, res);
+
+// The indexes on the local key paths are now multikey, so the joins match the keys element-wise.
+explain = orders.explain().aggregate(pipeline);
+nodeTypes = findNodeTypes(explain.queryPlanner.winningPlan.optimizerPlan, []);
+assert.eq(2, nodeTypes.filter(type => type === "BinaryJoin").length, nodeTypes);
+
+// Arrays along the foreign key path, and nulls and missing values on either side, match like an
+// equality in a $match would.
+const local = db.cqf_lookup_local;
+const foreign = db.cqf_lookup_foreign;
+local.drop();
+foreign.drop();
+assert.commandWorked(local.insert([
+    {_id: 0, a: 1},
+    {_id: 1, a: [2, 3]},
+    {_id: 2, a: [[4, 5]]},
+    {_id: 3, a: null},
+    {_id: 4},
+    {_id: 5, a: [{b: 1}, {b: [2, 3]}]},
+]));
+assert.commandWorked(foreign.insert([
+    {_id: 0, k: 1},
+    {_id: 1, k: [1, 2]},
+    {_id: 2, k: [[4, 5], 6]},
+    {_id: 3, k: {c: [1, 3]}},
+    {_id: 4, k: null},
+    {_id: 5},
+    {_id: 6, k: [{c: 2}, {d: 1}]},
+]));
+for (let localField of ["a", "a.b"]) {
+    for (let foreignField of ["k", "k.c"]) {
+        assertSameResultsAsClassic(local, [
+            {
+                $lookup: {
+                    from: foreign.getName(),
+                    localField: localField,
+                    foreignField: foreignField,
+                    as: "f"
+                }
+            },
+            {$unwind: "$f"},
+        ]);
+    }
+}
+}());
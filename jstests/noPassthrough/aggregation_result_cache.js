@@ -0,0 +1,118 @@
+/**
+ * Tests that the results of read-only aggregations are cached when the aggregation result cache is
+ * enabled, and that writes to the collections they read invalidate them.
+ * @tags: [
+ *   requires_replication,
+ *   uses_transactions,
+ * ]
+ */
+(function() {
+"use strict";
+
+const rst = new ReplSetTest({
+    nodes: 1,
+    nodeOptions: {setParameter: {internalQueryAggregationResultCacheMaxSizeBytes: 1024 * 1024}}
+});
+rst.startSet();
+rst.initiate();
+
+const primary = rst.getPrimary();
+const db = primary.getDB("test");
+const coll = db.aggregation_result_cache;
+const foreign = db.aggregation_result_cache_foreign;
+coll.drop();
+foreign.drop();
+assert.commandWorked(coll.insert([{_id: 1, k: 1}, {_id: 2, k: 2}, {_id: 3, k: 1}]));
+assert.commandWorked(foreign.insert([{_id: 1, v: "a"}, {_id: 2, v: "b"}]));
+
+function getMetrics() {
+    return assert.commandWorked(db.serverStatus()).metrics.query.aggregationResultCache;
+}
+
+/**
+ * Runs 'pipeline' against 'coll' and returns its results, asserting whether they were served from
+ * the cache.
+ */
+function runAndCheck(pipeline, expectHit, options = {}) {
+    const before = getMetrics();
+    const res = coll.aggregate(pipeline, options).toArray();
+    const after = getMetrics();
+    assert.eq(expectHit ? 1 : 0, after.hits - before.hits, {pipeline, before, after});
+    return res;
+}
+
+const groupPipeline = [{$group: {_id: "$k", n: {$sum: 1}}}, {$sort: {_id: 1}}];
+const expected = runAndCheck(groupPipeline, false);
+assert.eq([{_id: 1, n: 2}, {_id: 2, n: 1}], expected);
+assert.eq(expected, runAndCheck(groupPipeline, true));
+assert.gt(getMetrics().sizeBytes, 0);
+
+// A write to the collection invalidates the cached results.
+assert.commandWorked(coll.insert({_id: 4, k: 2}));
+assert.eq([{_id: 1, n: 2}, {_id: 2, n: 2}], runAndCheck(groupPipeline, false));
+assert.eq([{_id: 1, n: 2}, {_id: 2, n: 2}], runAndCheck(groupPipeline, true));
+assert.commandWorked(coll.update({_id: 4}, {$set: {k: 1}}));
+assert.eq([{_id: 1, n: 3}, {_id: 2, n: 1}], runAndCheck(groupPipeline, false));
+assert.commandWorked(coll.remove({_id: 4}));
+assert.eq(expected, runAndCheck(groupPipeline, false));
+
+// So does a write to a collection read by a sub-pipeline.
+const lookupPipeline = [
+    {$lookup: {from: foreign.getName(), localField: "k", foreignField: "_id", as: "f"}},
+    {$sort: {_id: 1}}
+];
+runAndCheck(lookupPipeline, false);
+assert.eq("a", runAndCheck(lookupPipeline, true)[0].f[0].v);
+assert.commandWorked(foreign.update({_id: 1}, {$set: {v: "c"}}));
+assert.eq("c", runAndCheck(lookupPipeline, false)[0].f[0].v);
+
+// A write committed in a transaction invalidates the cached results once it commits.
+runAndCheck(groupPipeline, true);
+const session = primary.startSession();
+const sessionColl = session.getDatabase("test").getCollection(coll.getName());
+session.startTransaction();
+assert.commandWorked(sessionColl.insert({_id: 5, k: 2}));
+assert.eq(expected, runAndCheck(groupPipeline, true));
+assert.commandWorked(session.commitTransaction_forTesting());
+assert.eq([{_id: 1, n: 2}, {_id: 2, n: 2}], runAndCheck(groupPipeline, false));
+session.endSession();
+
+// Different pipelines, collations and variables are cached separately.
+runAndCheck([{$match: {k: 1}}], false);
+runAndCheck([{$match: {k: 1}}], true);
+runAndCheck([{$match: {k: 1}}], false, {collation: {locale: "fr"}});
+runAndCheck([{$match: {$expr: {$eq: ["$k", "$$k"]}}}], false, {let: {k: 1}});
+runAndCheck([{$match: {$expr: {$eq: ["$k", "$$k"]}}}], false, {let: {k: 2}});
+runAndCheck([{$match: {$expr: {$eq: ["$k", "$$k"]}}}], true, {let: {k: 2}});
+
+// Results which do not fit in the first batch are not cached.
+runAndCheck([{$sort: {_id: 1}}], false, {cursor: {batchSize: 1}});
+runAndCheck([{$sort: {_id: 1}}], false, {cursor: {batchSize: 1}});
+
+// Neither are the results of pipelines which are not deterministic or which write data, nor reads
+// of data older than the latest.
+for (let [pipeline, options] of [[[{$project: {r: {$rand: {}}}}], {}],
+                                 [[{$addFields: {now: "$$NOW"}}], {}],
+                                 [[{$sample: {size: 1}}], {}],
+                                 [[{$match: {k: 1}}], {readConcern: {level: "majority"}}]]) {
+    runAndCheck(pipeline, false, options);
+    runAndCheck(pipeline, false, options);
+}
+coll.aggregate([{$out: "aggregation_result_cache_out"}]);
+coll.aggregate([{$out: "aggregation_result_cache_out"}]);
+assert.eq(coll.find().itcount(), db.aggregation_result_cache_out.find().itcount());
+
+// Explain does not read from the cache.
+runAndCheck(groupPipeline, true);
+const before = getMetrics();
+coll.explain("executionStats").aggregate(groupPipeline);
+assert.eq(before.hits, getMetrics().hits);
+
+// Disabling the cache stops it from serving results.
+assert.commandWorked(
+    db.adminCommand({setParameter: 1, internalQueryAggregationResultCacheMaxSizeBytes: 0}));
+runAndCheck(groupPipeline, false);
+runAndCheck(groupPipeline, false);
+
+rst.stopSet();
+})();
@@ -0,0 +1,163 @@
+/**
+ * Tests the $approxCountDistinct and $percentileApprox accumulators and window functions, including
+ * their partial results being merged across the shards of a sharded collection.
+ */
+(function() {
+"use strict";
+
+const featureFlagOptions = {
+    setParameter: {featureFlagApproxAccumulators: true}
+};
+
+const nDocs = 20000;
+const nDistinct = 2000;
+
+function populate(coll) {
+    const docs = [];
+    for (let i = 0; i < nDocs; ++i) {
+        docs.push({_id: i, g: i % 2, v: (i * 7919) % nDocs, s: "str" + (i % nDistinct)});
+    }
+    assert.commandWorked(coll.insert(docs));
+}
+
+function assertWithin(expected, actual, tolerance, msg) {
+    assert.lte(Math.abs(actual - expected), tolerance, {expected, actual, msg});
+}
+
+function testGroup(coll) {
+    const group = {
+        $group: {
+            _id: "$g",
+            distinct: {$approxCountDistinct: "$s"},
+            exactDistinct: {$addToSet: "$s"},
+            percentiles: {$percentileApprox: {input: "$v", p: [0, 0.5, 0.99, 1]}}
+        }
+    };
+    const res = coll.aggregate([group, {$sort: {_id: 1}}]).toArray();
+    assert.eq(2, res.length, res);
+    for (let group of res) {
+        // Half of the distinct strings land in each group, few enough to be counted exactly.
+        assert.eq(group.exactDistinct.length, group.distinct, group._id);
+        assert.eq(nDistinct / 2, group.distinct, group._id);
+
+        // Each group holds every other value between 0 and nDocs - 1.
+        assert.eq(4, group.percentiles.length, group);
+        assert.eq(group._id, group.percentiles[0], group);
+        assertWithin(nDocs / 2, group.percentiles[1], nDocs * 0.01, group);
+        assertWithin(nDocs * 0.99, group.percentiles[2], nDocs * 0.01, group);
+        assert.eq(nDocs - 2 + group._id, group.percentiles[3], group);
+    }
+
+    // A large number of distinct values is estimated.
+    const [all] = coll.aggregate([{$group: {_id: null, distinct: {$approxCountDistinct: "$v"}}}])
+                      .toArray();
+    assertWithin(nDocs, all.distinct, nDocs * 0.03, all);
+
+    // Groups without numeric values have no percentiles.
+    const [none] =
+        coll.aggregate([{$group: {_id: null, p: {$percentileApprox: {input: "$s", p: [0.5]}}}}])
+            .toArray();
+    assert.eq(null, none.p, none);
+}
+
+function testWindowFunctions(coll) {
+    const res = coll.aggregate([
+                        {$match: {_id: {$lt: 100}}},
+                        {
+                            $setWindowFields: {
+                                sortBy: {_id: 1},
+                                output: {
+                                    distinct: {
+                                        $approxCountDistinct: {$mod: ["$_id", 10]},
+                                        window: {documents: ["unbounded", "current"]}
+                                    },
+                                    median: {
+                                        $percentileApprox: {input: "$_id", p: [0.5]},
+                                        window: {documents: ["unbounded", "current"]}
+                                    }
+                                }
+                            }
+                        },
+                        {$sort: {_id: 1}}
+                    ])
+                    .toArray();
+    assert.eq(100, res.length);
+    for (let doc of res) {
+        assert.eq(Math.min(doc._id + 1, 10), doc.distinct, doc);
+        assertWithin(doc._id / 2, doc.median[0], 0.5, doc);
+    }
+
+    // The sketches cannot forget values, so removable windows are rejected.
+    assert.throwsWithCode(
+        () => coll.aggregate([{
+            $setWindowFields: {
+                sortBy: {_id: 1},
+                output: {d: {$approxCountDistinct: "$s", window: {documents: [-1, 1]}}}
+            }
+        }]),
+        5461500);
+    assert.throwsWithCode(
+        () => coll.aggregate([{
+            $setWindowFields: {
+                sortBy: {_id: 1},
+                output:
+                    {p: {$percentileApprox: {input: "$v", p: [0.5]}, window: {documents: [-1, 1]}}}
+            }
+        }]),
+        7132207);
+}
+
+function testParseErrors(coll) {
+    for (let [spec, code] of [[{input: "$v"}, 7132206],
+                              [{p: [0.5]}, 7132205],
+                              [{input: "$v", p: [2]}, 7132203],
+                              [{input: "$v", p: 0.5}, 7132202]]) {
+        assert.throwsWithCode(
+            () => coll.aggregate([{$group: {_id: null, p: {$percentileApprox: spec}}}]), code);
+    }
+}
+
+(function testStandalone() {
+    const conn = MongoRunner.runMongod(featureFlagOptions);
+    assert.neq(null, conn, "mongod was unable to start up");
+    const coll = conn.getDB("test").approx_accumulators;
+    populate(coll);
+
+    testGroup(coll);
+    testWindowFunctions(coll);
+    testParseErrors(coll);
+
+    MongoRunner.stopMongod(conn);
+})();
+
+(function testWithoutFeatureFlag() {
+    const conn = MongoRunner.runMongod();
+    assert.neq(null, conn, "mongod was unable to start up");
+    const coll = conn.getDB("test").approx_accumulators;
+    assert.commandWorked(coll.insert({v: 1}));
+    assert.throwsWithCode(
+        () => coll.aggregate([{$group: {_id: null, d: {$approxCountDistinct: "$v"}}}]), 15952);
+    MongoRunner.stopMongod(conn);
+})();
+
+(function testSharded() {
+    const st = new ShardingTest({
+        shards: 2,
+        mongos: 1,
+        other: {shardOptions: featureFlagOptions, mongosOptions: featureFlagOptions}
+    });
+    const db = st.s.getDB("test");
+    const coll = db.approx_accumulators;
+    populate(coll);
+    st.shardColl(coll.getName(), {_id: 1}, {_id: nDocs / 2}, {_id: nDocs / 2 + 1}, db.getName());
+
+    // The $group is split, and the partial sketches of the shards are merged.
+    const explain = coll.explain().aggregate(
+        [{$group: {_id: "$g", distinct: {$approxCountDistinct: "$s"}}}]);
+    assert(explain.hasOwnProperty("splitPipeline"), explain);
+
+    testGroup(coll);
+
+    st.stop();
+})();
+})();
@@ -0,0 +1,106 @@
+/**
+ * Tests that classic plans cached with internalQueryCacheEnableParameterizedClassicPlans are
+ * rebuilt from the parameters of later queries of the same shape, and that those queries return
+ * the same results as when the plans are rebuilt from the cached index tags.
+ */
+(function() {
+"use strict";
+
+load("jstests/aggregation/extras/utils.js");  // For arrayEq.
+
+const conn = MongoRunner.runMongod({setParameter: {internalQueryForceClassicEngine: true}});
+assert.neq(null, conn, "mongod was unable to start up");
+const db = conn.getDB("classic_parameterized_plan_cache");
+const coll = db.coll;
+coll.drop();
+
+const docs = [];
+for (let i = 0; i < 2000; ++i) {
+    docs.push({
+        _id: i,
+        a: i % 50,
+        b: i % 13,
+        c: i,
+        d: (i % 4 == 0) ? null : i % 9,
+        t: "w" + (i % 5) + " v" + (i % 3),
+        loc: {type: "Point", coordinates: [i % 40, i % 37]},
+        w: {x: i % 50, y: i % 7, o: (i % 3 == 0) ? {v: i % 50} : i % 50},
+    });
+}
+assert.commandWorked(coll.insert(docs));
+for (let index of [{a: 1},
+                   {b: 1},
+                   {a: 1, b: 1},
+                   {c: -1},
+                   {d: 1},
+                   {t: "text"},
+                   {loc: "2dsphere"},
+                   {loc: "2dsphere", b: 1},
+                   {"w.$**": 1}]) {
+    assert.commandWorked(coll.createIndex(index));
+}
+
+function setParameterized(enabled) {
+    assert.commandWorked(db.adminCommand(
+        {setParameter: 1, internalQueryCacheEnableParameterizedClassicPlans: enabled}));
+}
+
+// Each query is run once per set of constants. The first run of each shape creates an inactive
+// cache entry, the second activates it, and the remaining runs are planned from the cache.
+const shapes = [
+    (k) => coll.find({a: k, b: (k * 3) % 13}),
+    (k) => coll.find({a: {$gte: k, $lt: k + 5}, b: {$ne: k % 13}}),
+    (k) => coll.find({a: {$in: [k, k + 1, k + 2].slice(0, 1 + k % 3)}, b: {$gt: 2}}),
+    (k) => coll.find({$or: [{a: k, b: k % 13}, {c: {$lt: k * 10}}]}),
+    (k) => coll.find({c: {$gt: k * 20}, b: k % 13}).sort({c: -1}).limit(10),
+    (k) => coll.find({d: (k % 2 == 0) ? null : k % 9, a: {$lte: k}}),
+    (k) => coll.find({a: k, b: {$exists: true}}, {_id: 0, a: 1, b: 1}),
+    (k) => coll.find({$text: {$search: "w" + (k % 5)}, a: {$lte: k}}),
+    (k) => coll.find(
+        {loc: {$near: {$geometry: {type: "Point", coordinates: [10, 10]}}}, b: k % 13}),
+    (k) => coll.find({"w.x": k, "w.y": {$lt: k % 7}}),
+    // Object values need the wildcard index scan to cover the subpaths of 'w.o', so the cached
+    // plan cannot be rebuilt from them.
+    (k) => coll.find({"w.o": (k % 2 == 0) ? k : {v: k}, "w.y": {$gte: k % 7}}),
+];
+const constants = [3, 7, 11, 20, 42, 0, 49];
+
+function runQueries() {
+    coll.getPlanCache().clear();
+    const results = [];
+    for (let shape of shapes) {
+        for (let k of constants) {
+            results.push(shape(k).toArray());
+        }
+    }
+    return results;
+}
+
+setParameterized(false);
+const expected = runQueries();
+
+setParameterized(true);
+const actual = runQueries();
+assert.eq(expected.length, actual.length);
+for (let i = 0; i < expected.length; ++i) {
+    assert(arrayEq(expected[i], actual[i]), {i: i, expected: expected[i], actual: actual[i]});
+}
+
+// Sorted queries must also preserve their order when planned from the cache.
+const sortedShape = shapes[4];
+for (let k of constants) {
+    assert.eq(sortedShape(k).toArray(),
+              coll.find({c: {$gt: k * 20}, b: k % 13}).sort({c: -1}).limit(10).toArray());
+}
+
+// The same shape with different constants shares a single active cache entry.
+coll.getPlanCache().clear();
+for (let k of constants) {
+    assert.eq(shapes[0](k).itcount(), expected[constants.indexOf(k)].length);
+}
+const entries = coll.getPlanCache().list([{$match: {"createdFromQuery.query.a": {$exists: true}}}]);
+assert.eq(1, entries.length, entries);
+assert(entries[0].isActive, entries);
+
+MongoRunner.stopMongod(conn);
+})();
@@ -0,0 +1,76 @@
+/**
+ * Tests that aggregation pipelines return the same results and execution stats whether or not
+ * documents are passed between pipeline stages in batches.
+ */
+(function() {
+"use strict";
+
+load("jstests/aggregation/extras/utils.js");  // For arrayEq.
+
+const conn = MongoRunner.runMongod();
+assert.neq(null, conn, "mongod was unable to start up");
+const db = conn.getDB("document_source_batching");
+const coll = db.coll;
+coll.drop();
+
+const nDocs = 1000;
+const docs = [];
+for (let i = 0; i < nDocs; ++i) {
+    docs.push({_id: i, a: i % 10, b: i % 3 == 0 ? [] : [i, i + 1, i + 2], c: {d: i % 7}});
+}
+assert.commandWorked(coll.insert(docs));
+
+function setBatchSize(batchSize) {
+    assert.commandWorked(
+        db.adminCommand({setParameter: 1, internalDocumentSourceGetNextBatchSize: batchSize}));
+}
+
+// Stages which cannot be pushed down to the query layer are kept in the pipeline by prefixing them
+// with $_internalInhibitOptimization.
+const inhibit = {$_internalInhibitOptimization: {}};
+const pipelines = {
+    match: [inhibit, {$match: {a: {$in: [1, 4, 7]}, "c.d": {$ne: 3}}}],
+    matchNone: [inhibit, {$match: {a: 11}}],
+    project: [inhibit, {$project: {a: 1, d: "$c.d"}}],
+    addFields: [inhibit, {$addFields: {e: {$add: ["$a", "$c.d"]}}}, {$match: {e: {$gt: 8}}}],
+    unwind: [inhibit, {$unwind: "$b"}, {$match: {b: {$mod: [5, 0]}}}],
+    unwindPreserve: [inhibit, {$unwind: {path: "$b", preserveNullAndEmptyArrays: true}}],
+    group: [
+        inhibit,
+        {$match: {a: {$lt: 5}}},
+        {$group: {_id: "$c.d", n: {$sum: 1}, s: {$sum: "$a"}}},
+    ],
+    unwindGroup: [inhibit, {$unwind: "$b"}, {$group: {_id: "$a", s: {$sum: "$b"}}}],
+    limit: [inhibit, {$match: {a: 2}}, {$limit: 13}],
+};
+
+function runPipelines() {
+    const results = {};
+    for (let name of Object.keys(pipelines)) {
+        results[name] = coll.aggregate(pipelines[name], {cursor: {batchSize: 7}}).toArray();
+    }
+    return results;
+}
+
+function nReturnedPerStage(pipeline) {
+    const explain = coll.explain("executionStats").aggregate(pipeline);
+    return explain.stages.map(stage => stage.nReturned);
+}
+
+setBatchSize(1);
+const expected = runPipelines();
+const expectedStats = nReturnedPerStage(pipelines.unwind);
+
+for (let batchSize of [2, 64, 5000]) {
+    setBatchSize(batchSize);
+    const actual = runPipelines();
+    for (let name of Object.keys(pipelines)) {
+        assert(arrayEq(expected[name], actual[name]),
+               {name: name, batchSize: batchSize, expected: expected[name], actual: actual[name]});
+    }
+    assert.eq(expected.limit.length, 13);
+    assert.eq(expectedStats, nReturnedPerStage(pipelines.unwind), {batchSize: batchSize});
+}
+
+MongoRunner.stopMongod(conn);
+})();
@@ -0,0 +1,156 @@
+/**
+ * Tests that $facet stages return the same results when their sub-pipelines run concurrently on
+ * worker threads.
+ */
+(function() {
+"use strict";
+
+load("jstests/aggregation/extras/utils.js");  // For arrayEq.
+
+const conn = MongoRunner.runMongod();
+assert.neq(null, conn, "mongod was unable to start up");
+const db = conn.getDB("facet_parallel_execution");
+const coll = db.coll;
+const foreign = db.foreign;
+coll.drop();
+foreign.drop();
+
+const nDocs = 3000;
+const docs = [];
+for (let i = 0; i < nDocs; ++i) {
+    docs.push({
+        _id: i,
+        a: i % 10,
+        b: i % 13,
+        tags: ["t" + (i % 3), "t" + (i % 5)],
+        s: "x".repeat(i % 50),
+    });
+}
+assert.commandWorked(coll.insert(docs));
+assert.commandWorked(foreign.insert([{_id: 0, name: "zero"}, {_id: 1, name: "one"}]));
+
+function setParameter(name, value) {
+    assert.commandWorked(db.adminCommand({setParameter: 1, [name]: value}));
+}
+
+const facet = {
+    $facet: {
+        byA: [{$group: {_id: "$a", n: {$sum: 1}, sumB: {$sum: "$b"}}}, {$sort: {_id: 1}}],
+        top: [{$sort: {b: -1, _id: 1}}, {$limit: 5}, {$project: {s: 0}}],
+        first: [{$limit: 3}, {$project: {_id: 1}}],
+        buckets: [{$bucket: {groupBy: "$b", boundaries: [0, 4, 8, 13], default: "other"}}],
+        tags: [{$unwind: "$tags"}, {$sortByCount: "$tags"}],
+        count: [{$match: {a: {$gte: 5}}}, {$count: "n"}],
+        empty: [{$match: {a: 100}}],
+    }
+};
+const lookupFacet = {
+    $facet: {
+        joined: [
+            {$match: {_id: {$lt: 4}}},
+            {$lookup: {from: foreign.getName(), localField: "a", foreignField: "_id", as: "f"}},
+            {$project: {f: 1}},
+        ],
+        count: [{$count: "n"}],
+    }
+};
+
+function runQueries() {
+    return {
+        facet: coll.aggregate([facet]).toArray(),
+        lookup: coll.aggregate([lookupFacet]).toArray(),
+        afterMatch: coll.aggregate([{$match: {b: {$lt: 3}}}, facet]).toArray(),
+    };
+}
+
+setParameter("internalQueryFacetMaxParallelWorkers", 0);
+const expected = runQueries();
+assert.eq(expected.facet[0].count, [{n: nDocs / 2}]);
+assert.eq(expected.facet[0].first.length, 3);
+
+// Run the sub-pipelines concurrently, including with a buffer which only holds one batch.
+setParameter("internalQueryFacetMaxParallelWorkers", 64);
+for (let bufferSize of [100 * 1024 * 1024, 1]) {
+    setParameter("internalQueryFacetBufferSizeBytes", bufferSize);
+    const actual = runQueries();
+    for (let key of Object.keys(expected)) {
+        assert.eq(expected[key].length, actual[key].length, key);
+        assert(arrayEq(expected[key], actual[key]),
+               {key: key, bufferSize: bufferSize, expected: expected[key], actual: actual[key]});
+    }
+}
+setParameter("internalQueryFacetBufferSizeBytes", 100 * 1024 * 1024);
+
+// If there are not enough worker threads available, the sub-pipelines run one after another.
+setParameter("internalQueryFacetMaxParallelWorkers", 2);
+assert(arrayEq(expected.facet, coll.aggregate([facet]).toArray()));
+setParameter("internalQueryFacetMaxParallelWorkers", 64);
+
+// The size limit of the output document applies to the results of all facets together.
+setParameter("internalQueryFacetMaxOutputDocSizeBytes", 10 * 1024);
+assert.throwsWithCode(
+    () => coll.aggregate([{$facet: {all: [{$match: {}}], other: [{$project: {s: 1}}]}}]).toArray(),
+    4031700);
+setParameter("internalQueryFacetMaxOutputDocSizeBytes", 100 * 1024 * 1024);
+
+// An error in one sub-pipeline fails the whole stage.
+assert.throwsWithCode(() => coll.aggregate([{
+                                   $facet: {
+                                       ok: [{$group: {_id: null, n: {$sum: 1}}}],
+                                       bad: [{$project: {x: {$divide: ["$a", 0]}}}],
+                                   }
+                               }])
+                                .toArray(),
+                      [2, 16608]);
+
+// The worker threads inherit the time limit of the operation.
+const sleep = {$function: {body: "sleep(100); return true;", args: [], lang: "js"}};
+assert.commandFailedWithCode(db.runCommand({
+    aggregate: coll.getName(),
+    pipeline: [{$facet: {slow: [{$match: {$expr: sleep}}], fast: [{$count: "n"}]}}],
+    cursor: {},
+    maxTimeMS: 500,
+}),
+                             ErrorCodes.MaxTimeMSExpired);
+
+// A killOp of the operation stops the worker threads, even while they are busy in a stage which
+// does not read any more input.
+const comment = "facet_parallel_killop";
+const awaitShell = startParallelShell(
+    funWithArgs(function(dbName, collName, comment) {
+        const sleep = {$function: {body: "sleep(100); return true;", args: [], lang: "js"}};
+        const res = db.getSiblingDB(dbName).runCommand({
+            aggregate: collName,
+            pipeline: [{$facet: {slow: [{$match: {$expr: sleep}}], fast: [{$count: "n"}]}}],
+            cursor: {},
+            comment: comment,
+        });
+        assert.commandFailedWithCode(res, ErrorCodes.Interrupted);
+    }, db.getName(), coll.getName(), comment), conn.port);
+
+function getFacetWorkerOps() {
+    return db.getSiblingDB("admin")
+        .aggregate([{$currentOp: {allUsers: true, idleConnections: false}},
+                    {$match: {desc: /^FacetWorker/, active: true}}])
+        .toArray();
+}
+let opId;
+assert.soon(() => {
+    const ops = db.getSiblingDB("admin")
+                    .aggregate([
+                        {$currentOp: {allUsers: true}},
+                        {$match: {"command.comment": comment}},
+                    ])
+                    .toArray();
+    if (ops.length !== 1 || getFacetWorkerOps().length === 0) {
+        return false;
+    }
+    opId = ops[0].opid;
+    return true;
+});
+assert.commandWorked(db.killOp(opId));
+awaitShell();
+assert.soon(() => getFacetWorkerOps().length === 0, () => tojson(getFacetWorkerOps()));
+
+MongoRunner.stopMongod(conn);
+})();
@@ -0,0 +1,123 @@
+/**
+ * Tests that $group stages return the same results when their groups are partitioned across worker
+ * threads, including when the partitions spill to disk.
+ */
+(function() {
+"use strict";
+
+load("jstests/aggregation/extras/utils.js");  // For arrayEq.
+load("jstests/libs/analyze_plan.js");         // For getAggPlanStage.
+
+// The parallel $group is implemented by the classic engine.
+const conn = MongoRunner.runMongod({setParameter: {internalQueryForceClassicEngine: true}});
+assert.neq(null, conn, "mongod was unable to start up");
+const db = conn.getDB("group_parallel_execution");
+const coll = db.coll;
+coll.drop();
+
+const nDocs = 20000;
+const nGroups = 5000;
+const docs = [];
+for (let i = 0; i < nDocs; ++i) {
+    docs.push({_id: i, a: i % nGroups, b: i % 7, s: "x".repeat(i % 50)});
+}
+assert.commandWorked(coll.insert(docs));
+
+function setParameter(name, value) {
+    assert.commandWorked(db.adminCommand({setParameter: 1, [name]: value}));
+}
+
+const pipelines = [
+    [{$group: {_id: "$a", n: {$sum: 1}, sumB: {$sum: "$b"}, avgB: {$avg: "$b"}}}],
+    [{$group: {_id: {a: "$a", b: "$b"}, first: {$first: "$_id"}, last: {$last: "$_id"}}}],
+    [{$group: {_id: "$b", distinctA: {$addToSet: "$a"}, maxS: {$max: "$s"}}}],
+    [{$group: {_id: {$mod: ["$a", 100]}, ids: {$push: "$_id"}}}],
+    [{$group: {_id: null, n: {$sum: 1}, minA: {$min: "$a"}}}],
+];
+
+function runAll(options = {}) {
+    return pipelines.map(pipeline => coll.aggregate(pipeline, options).toArray());
+}
+
+function getGroupStage(pipeline, options = {}) {
+    return getAggPlanStage(coll.explain("executionStats").aggregate(pipeline, options), "$group");
+}
+
+setParameter("internalQueryGroupMaxParallelWorkers", 0);
+const expected = runAll();
+const serialStage = getGroupStage(pipelines[0]);
+assert(!serialStage.hasOwnProperty("parallelPartitions"), serialStage);
+
+setParameter("internalQueryGroupMaxParallelWorkers", 8);
+setParameter("internalQueryGroupParallelPartitions", 4);
+const parallelStage = getGroupStage(pipelines[0]);
+assert.eq(4, parallelStage.parallelPartitions, parallelStage);
+const actual = runAll();
+for (let i = 0; i < pipelines.length; ++i) {
+    assert(arrayEq(expected[i], actual[i]), {pipeline: pipelines[i]});
+}
+
+// A $group which cannot reserve enough threads builds its groups on a single thread.
+setParameter("internalQueryGroupParallelPartitions", 16);
+assert(!getGroupStage(pipelines[0]).hasOwnProperty("parallelPartitions"));
+setParameter("internalQueryGroupParallelPartitions", 4);
+
+// $accumulator runs in the JavaScript scope of the operation, so it is never partitioned.
+const jsPipeline = [{
+    $group: {
+        _id: "$b",
+        n: {
+            $accumulator: {
+                init: function() {
+                    return 0;
+                },
+                accumulate: function(state) {
+                    return state + 1;
+                },
+                accumulateArgs: [],
+                merge: function(s1, s2) {
+                    return s1 + s2;
+                },
+                lang: "js"
+            }
+        }
+    }
+}];
+assert(!getGroupStage(jsPipeline).hasOwnProperty("parallelPartitions"));
+
+// The workers evaluate the group keys and the arguments, except when they run JavaScript.
+const jsArgumentPipeline = [{
+    $group: {
+        _id: "$b",
+        n: {$sum: {$function: {body: "return 1;", args: [], lang: "js"}}},
+    }
+}];
+assert(!getGroupStage(jsArgumentPipeline).hasOwnProperty("parallelPartitions"));
+
+// The partitions spill to disk when they exceed their share of the memory limit, and their groups
+// are merged back in order.
+setParameter("internalDocumentSourceGroupMaxMemoryBytes", 200 * 1024);
+const spillingStage = getGroupStage(pipelines[3], {allowDiskUse: true});
+assert.eq(4, spillingStage.parallelPartitions, spillingStage);
+assert(spillingStage.usedDisk, spillingStage);
+const spilled = runAll({allowDiskUse: true});
+for (let i = 0; i < pipelines.length; ++i) {
+    assert(arrayEq(expected[i], spilled[i]), {pipeline: pipelines[i]});
+}
+
+// An error on a worker thread fails the operation.
+assert.commandFailedWithCode(db.runCommand({
+    aggregate: coll.getName(),
+    pipeline: pipelines[3],
+    cursor: {},
+    allowDiskUse: false,
+}),
+                             ErrorCodes.QueryExceededMemoryLimitNoDiskUseAllowed);
+
+// Every worker thread has been released.
+setParameter("internalDocumentSourceGroupMaxMemoryBytes", 100 * 1024 * 1024);
+setParameter("internalQueryGroupMaxParallelWorkers", 4);
+assert.eq(4, getGroupStage(pipelines[0]).parallelPartitions);
+
+MongoRunner.stopMongod(conn);
+})();
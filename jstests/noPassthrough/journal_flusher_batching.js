@@ -0,0 +1,63 @@
+/**
+ * Tests that the journal flusher reports the callers it releases in each round, and the latency of
+ * its flushes, while concurrent {j: true} writers wait on it.
+ *
+ * @tags: [requires_journaling]
+ */
+(function() {
+"use strict";
+
+const conn = MongoRunner.runMongod();
+assert.neq(null, conn, "mongod was unable to start up");
+const db = conn.getDB("test");
+const adminDB = conn.getDB("admin");
+
+function journalFlusherStats() {
+    const stats = assert.commandWorked(adminDB.runCommand({serverStatus: 1})).journalFlusher;
+    assert(stats, "serverStatus is missing the journalFlusher section");
+    return stats;
+}
+
+const before = journalFlusherStats();
+
+const nWriters = 4;
+const nWritesPerWriter = 50;
+const writers = [];
+for (let i = 0; i < nWriters; ++i) {
+    writers.push(startParallelShell(funWithArgs(function(writer, nWrites) {
+                                        const coll = db.getSiblingDB("test").journal_flusher;
+                                        for (let j = 0; j < nWrites; ++j) {
+                                            assert.commandWorked(coll.insert(
+                                                {writer: writer, j: j}, {writeConcern: {j: true}}));
+                                        }
+                                    }, i, nWritesPerWriter), conn.port));
+}
+writers.forEach((join) => join());
+assert.eq(nWriters * nWritesPerWriter, db.journal_flusher.countDocuments({}));
+
+// Stop the periodic rounds of the flusher, so that the counters of its rounds stop changing once
+// the round the write below requests is recorded. The counters are not updated atomically.
+assert.commandWorked(
+    adminDB.runCommand({configureFailPoint: "pauseJournalFlusherThread", mode: "alwaysOn"}));
+assert.commandWorked(db.journal_flusher.insert({paused: true}, {writeConcern: {j: true}}));
+let after;
+assert.soon(() => {
+    after = journalFlusherStats();
+    return after.rounds == after.waitersPerRound.totalCount &&
+        after.rounds == after.flushLatencyMicros.totalCount;
+}, () => tojson(after));
+assert.commandWorked(
+    adminDB.runCommand({configureFailPoint: "pauseJournalFlusherThread", mode: "off"}));
+
+// Every {j: true} write waited for a round of the flusher.
+assert.gt(after.rounds, before.rounds, after);
+assert.gte(after.waitersReleased - before.waitersReleased, nWriters * nWritesPerWriter, after);
+assert.gte(after.batchDelayMicros, 0, after);
+
+// The delay can be disabled, and is bounded.
+assert.commandWorked(adminDB.runCommand({setParameter: 1, journalFlusherMaxBatchDelayMicros: 0}));
+assert.commandWorked(db.journal_flusher.insert({disabled: true}, {writeConcern: {j: true}}));
+assert.commandFailed(adminDB.runCommand({setParameter: 1, journalFlusherMaxBatchDelayMicros: -1}));
+
+MongoRunner.stopMongod(conn);
+})();
@@ -590,23 +590,6 @@ MongoRunner.stopMongod(conn);
             null /* indexKeyPattern */,
             {allowDiskUse: true});
 
-    // The fcollStats.count means the number of documents in a collection, the fcollStats.size means
-    // the collection's data size, and the fcollStats.storageSize means the allocated storage size.
-    const fcollStats = assert.commandWorked(fcoll.stats());
-    assert.commandWorked(db.adminCommand({
-        setParameter: 1,
-        internalQueryCollectionMaxNoOfDocumentsToChooseHashJoin: fcollStats.count,
-        internalQueryCollectionMaxDataSizeBytesToChooseHashJoin: fcollStats.size,
-        internalQueryCollectionMaxStorageSizeBytesToChooseHashJoin: fcollStats.storageSize
-    }));
-
-    // Verifies that the HJ is still chosen.
-    runTest(lcoll,
-            [{$lookup: {from: fcoll.getName(), localField: "a", foreignField: "a", as: "out"}}],
-            JoinAlgorithm.HJ,
-            null /* indexKeyPattern */,
-            {allowDiskUse: true});
-
     // Setting the 'internalQueryDisableLookupExecutionUsingHashJoin' knob to true will disable
     // HJ plans from being chosen and since the pipeline is SBE compatible it will fallback to
     // NLJ.
@@ -633,48 +616,22 @@ MongoRunner.stopMongod(conn);
             null /* indexKeyPattern */,
             {allowDiskUse: true});
 
-    // Setting the 'internalQueryCollectionMaxNoOfDocumentsToChooseHashJoin' to count - 1 results in
-    // choosing the NLJ algorithm.
-    assert.commandWorked(db.adminCommand({
-        setParameter: 1,
-        internalQueryCollectionMaxNoOfDocumentsToChooseHashJoin: fcollStats.count - 1
-    }));
-
-    runTest(lcoll,
-            [{$lookup: {from: fcoll.getName(), localField: "a", foreignField: "a", as: "out"}}],
-            JoinAlgorithm.NLJ,
-            null /* indexKeyPattern */,
-            {allowDiskUse: true});
-
-    // Reverting back 'internalQueryCollectionMaxNoOfDocumentsToChooseHashJoin' to the previous
-    // value. Setting the 'internalQueryCollectionMaxDataSizeBytesToChooseHashJoin' to size - 1
-    // results in choosing the NLJ algorithm.
-    assert.commandWorked(db.adminCommand({
-        setParameter: 1,
-        internalQueryCollectionMaxNoOfDocumentsToChooseHashJoin: fcollStats.count,
-        internalQueryCollectionMaxDataSizeBytesToChooseHashJoin: fcollStats.size - 1
-    }));
-
-    runTest(lcoll,
-            [{$lookup: {from: fcoll.getName(), localField: "a", foreignField: "a", as: "out"}}],
-            JoinAlgorithm.NLJ,
-            null /* indexKeyPattern */,
-            {allowDiskUse: true});
-
-    // Reverting back 'internalQueryCollectionMaxDataSizeBytesToChooseHashJoin' to the previous
-    // value. Setting the 'internalQueryCollectionMaxStorageSizeBytesToChooseHashJoin' to
-    // storageSize - 1 results in choosing the NLJ algorithm.
+    // The HJ is chosen regardless of the size of the foreign collection, since the hash lookup
+    // spills the foreign side to disk once it exceeds the memory limit. Verify that the matches
+    // are still returned in the foreign collection order after spilling.
     assert.commandWorked(db.adminCommand({
         setParameter: 1,
-        internalQueryCollectionMaxDataSizeBytesToChooseHashJoin: fcollStats.size,
-        internalQueryCollectionMaxStorageSizeBytesToChooseHashJoin: fcollStats.storageSize - 1
+        internalQuerySlotBasedExecutionHashLookupApproxMemoryUseInBytesBeforeSpill: 1,
     }));
+    assert.commandWorked(fcoll.insert([{a: 2}, {a: [1, 2]}]));
 
-    runTest(lcoll,
-            [{$lookup: {from: fcoll.getName(), localField: "a", foreignField: "a", as: "out"}}],
-            JoinAlgorithm.NLJ,
-            null /* indexKeyPattern */,
-            {allowDiskUse: true});
+    const pipeline = [
+        {$lookup: {from: fcoll.getName(), localField: "a", foreignField: "a", as: "out"}},
+        {$project: {_id: 0, "out._id": 0}}
+    ];
+    runTest(lcoll, pipeline, JoinAlgorithm.HJ, null /* indexKeyPattern */, {allowDiskUse: true});
+    assert.eq([{a: 1, out: [{a: 1}, {a: 1}, {a: [1, 2]}]}],
+              lcoll.aggregate(pipeline, {allowDiskUse: true}).toArray());
 
     MongoRunner.stopMongod(conn);
 }());
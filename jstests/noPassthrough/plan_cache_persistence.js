@@ -0,0 +1,94 @@
+/**
+ * Tests that the active classic plan cache entries are saved to 'config.planCacheSnapshot', and
+ * that a restarted node prewarms its plan caches from the saved entries which are still valid.
+ */
+(function() {
+"use strict";
+
+const dbName = "plan_cache_persistence";
+const options = {
+    setParameter: {
+        internalQueryForceClassicEngine: true,
+        internalQueryPlanCacheSnapshotIntervalSecs: 1,
+    }
+};
+
+let conn = MongoRunner.runMongod(options);
+assert.neq(null, conn, "mongod was unable to start up");
+let db = conn.getDB(dbName);
+let coll = db.coll;
+
+const docs = [];
+for (let i = 0; i < 1000; ++i) {
+    docs.push({_id: i, a: i % 10, b: i % 100, c: i % 7});
+}
+assert.commandWorked(coll.insert(docs));
+for (let index of [{a: 1}, {b: 1}, {c: 1}, {a: 1, c: 1}]) {
+    assert.commandWorked(coll.createIndex(index));
+}
+
+const queries = {
+    ab: {a: 3, b: 13},
+    bc: {b: {$gte: 90}, c: 2},
+};
+// Only the shapes of the queries are saved, with their values replaced by placeholders.
+const shapes = {
+    ab: {a: 0, b: 0},
+    bc: {b: {$gte: 0}, c: 0},
+};
+const expected = {};
+
+// Running each query twice creates an active cache entry for its shape.
+for (let name of Object.keys(queries)) {
+    expected[name] = coll.find(queries[name]).sort({_id: 1}).toArray();
+    coll.find(queries[name]).sort({_id: 1}).toArray();
+}
+
+function activeEntries(coll) {
+    return coll.getPlanCache().list([{$match: {isActive: true}}]);
+}
+assert.eq(2, activeEntries(coll).length, coll.getPlanCache().list());
+
+const snapshot = conn.getDB("config").planCacheSnapshot;
+assert.soon(() => snapshot.find({ns: coll.getFullName()}).itcount() == 2,
+            () => tojson(snapshot.find().toArray()));
+for (let name of Object.keys(shapes)) {
+    assert.eq(1, snapshot.find({filter: shapes[name]}).itcount(), snapshot.find().toArray());
+}
+
+// Make one of the saved entries refer to an index with a different key pattern, as if the index
+// had been dropped and recreated before the restart. This entry must not be restored.
+const staleEntry = snapshot.findOne({"filter.c": {$exists: true}});
+assert.neq(null, staleEntry, snapshot.find().toArray());
+assert.gt(staleEntry.indexes.length, 0, staleEntry);
+assert.commandWorked(snapshot.update(
+    {_id: staleEntry._id}, {$set: {"indexes.0.keyPattern": {doesNotExist: 1}}}));
+
+// Stop the periodic snapshots, so that the stale entry is not overwritten before the restart.
+assert.commandWorked(
+    db.adminCommand({setParameter: 1, internalQueryPlanCacheSnapshotIntervalSecs: 0}));
+MongoRunner.stopMongod(conn);
+
+conn = MongoRunner.runMongod(
+    Object.assign({restart: true, cleanData: false, dbpath: conn.dbpath}, options));
+assert.neq(null, conn, "mongod was unable to restart");
+db = conn.getDB(dbName);
+coll = db.coll;
+
+// Only the valid entry is restored, as an active entry, before any query runs.
+assert.soon(() => activeEntries(coll).length > 0, () => tojson(coll.getPlanCache().list()));
+const restored = activeEntries(coll);
+assert.eq(1, restored.length, restored);
+assert.eq(shapes.ab, restored[0].createdFromQuery.query, restored);
+assert.eq(
+    0, coll.getPlanCache().list([{$match: {"createdFromQuery.query.c": {$exists: true}}}]).length);
+
+// The restored plan is used as is, and produces the same results.
+for (let name of Object.keys(queries)) {
+    assert.eq(expected[name], coll.find(queries[name]).sort({_id: 1}).toArray(), name);
+}
+const explain = coll.find(queries.ab).sort({_id: 1}).explain("executionStats");
+assert.eq(0, explain.queryPlanner.rejectedPlans.length, explain);
+
+MongoRunner.stopMongod(conn);
+})();
@@ -15,6 +15,7 @@ const expectedParamDefaults = {
     internalQueryPlanEvaluationWorksSbe: 10000,
     internalQueryPlanEvaluationCollFraction: 0.3,
     internalQueryPlanEvaluationCollFractionSbe: 0.0,
+    internalQueryPlanEvaluationParallelTrialsSbe: 1,
     internalQueryPlanEvaluationMaxResults: 101,
     internalQueryCacheMaxEntriesPerCollection: 5000,
     // This is a deprecated alias for "internalQueryCacheMaxEntriesPerCollection".
@@ -22,6 +23,10 @@ const expectedParamDefaults = {
     internalQueryCacheEvictionRatio: 10.0,
     internalQueryCacheWorksGrowthCoefficient: 2.0,
     internalQueryCacheDisableInactiveEntries: false,
+    internalQueryCacheEnableParameterizedClassicPlans: false,
+    internalQueryPlanCacheSnapshotIntervalSecs: 0,
+    internalQueryPlanCacheSnapshotMaxEntries: 5000,
+    internalQueryPlanCachePrewarmEnabled: true,
     internalQueryCacheMaxSizeBytesBeforeStripDebugInfo: 512 * 1024 * 1024,
     internalQueryPlannerMaxIndexedSolutions: 64,
     internalQueryEnumerationMaxOrSolutions: 10,
@@ -32,13 +37,21 @@ const expectedParamDefaults = {
     internalQueryPlanOrChildrenIndependently: true,
     internalQueryMaxScansToExplode: 200,
     internalQueryMaxBlockingSortMemoryUsageBytes: 100 * 1024 * 1024,
+    internalQueryAnalyzeMaxMemoryUsageBytes: 100 * 1024 * 1024,
     internalQueryExecYieldIterations: 1000,
     internalQueryExecYieldPeriodMS: 10,
+    internalQueryExecMaxScanBatchSize: 64,
     internalQueryFacetBufferSizeBytes: 100 * 1024 * 1024,
+    internalQueryFacetMaxParallelWorkers: 0,
     internalDocumentSourceCursorBatchSizeBytes: 4 * 1024 * 1024,
+    internalDocumentSourceGetNextBatchSize: 64,
     internalDocumentSourceLookupCacheSizeBytes: 100 * 1024 * 1024,
     internalLookupStageIntermediateDocumentMaxSizeBytes: 100 * 1024 * 1024,
     internalDocumentSourceGroupMaxMemoryBytes: 100 * 1024 * 1024,
+    internalQueryGroupMaxParallelWorkers: 0,
+    internalQueryGroupParallelPartitions: 4,
+    internalQueryAggregationResultCacheMaxSizeBytes: 0,
+    internalQueryAggregationResultCacheMaxEntryAgeSecs: 300,
     internalDocumentSourceSetWindowFieldsMaxMemoryBytes: 100 * 1024 * 1024,
     internalQueryMaxJsEmitBytes: 100 * 1024 * 1024,
     internalQueryMaxPushBytes: 100 * 1024 * 1024,
@@ -50,9 +63,12 @@ const expectedParamDefaults = {
     internalQueryIgnoreUnknownJSONSchemaKeywords: false,
     internalQueryProhibitBlockingMergeOnMongoS: false,
     internalQuerySlotBasedExecutionMaxStaticIndexScanIntervals: 1000,
-    internalQueryCollectionMaxNoOfDocumentsToChooseHashJoin: 10 * 1000,
-    internalQueryCollectionMaxDataSizeBytesToChooseHashJoin: 100 * 1024 * 1024,
-    internalQueryCollectionMaxStorageSizeBytesToChooseHashJoin: 100 * 1024 * 1024,
+    internalQuerySlotBasedExecutionBlockSize: 0,
+    internalQuerySlotBasedExecutionEnableNativeCode: true,
+    internalQuerySlotBasedExecutionNativeCodeThreshold: 1000,
+    internalQuerySlotBasedExecutionHashLookupApproxMemoryUseInBytesBeforeSpill: 100 * 1024 * 1024,
+    internalQuerySlotBasedExecutionDegreeOfParallelism: 1,
+    internalQuerySlotBasedExecutionParallelScanMinRecords: 100000,
     internalQueryDisableLookupExecutionUsingHashJoin: false,
 };
 
@@ -105,6 +121,11 @@ for (let paramName of ["internalQueryPlanEvaluationCollFraction",
     assertSetParameterFails(paramName, 1.0001);
 }
 
+assertSetParameterSucceeds("internalQueryPlanEvaluationParallelTrialsSbe", 4);
+assertSetParameterSucceeds("internalQueryPlanEvaluationParallelTrialsSbe", 1);
+assertSetParameterFails("internalQueryPlanEvaluationParallelTrialsSbe", 0);
+assertSetParameterFails("internalQueryPlanEvaluationParallelTrialsSbe", 65);
+
 assertSetParameterSucceeds("internalQueryPlanEvaluationMaxResults", 11);
 assertSetParameterSucceeds("internalQueryPlanEvaluationMaxResults", 0);
 assertSetParameterFails("internalQueryPlanEvaluationMaxResults", -1);
@@ -129,6 +150,13 @@ assertSetParameterSucceeds("internalQueryCacheWorksGrowthCoefficient", 1.1);
 assertSetParameterFails("internalQueryCacheWorksGrowthCoefficient", 1.0);
 assertSetParameterFails("internalQueryCacheWorksGrowthCoefficient", 0.1);
 
+assertSetParameterSucceeds("internalQueryPlanCacheSnapshotIntervalSecs", 0);
+assertSetParameterSucceeds("internalQueryPlanCacheSnapshotIntervalSecs", 60);
+assertSetParameterFails("internalQueryPlanCacheSnapshotIntervalSecs", -1);
+
+assertSetParameterSucceeds("internalQueryPlanCacheSnapshotMaxEntries", 1);
+assertSetParameterFails("internalQueryPlanCacheSnapshotMaxEntries", 0);
+
 assertSetParameterSucceeds("internalQueryPlannerMaxIndexedSolutions", 11);
 assertSetParameterSucceeds("internalQueryPlannerMaxIndexedSolutions", 0);
 assertSetParameterFails("internalQueryPlannerMaxIndexedSolutions", -1);
@@ -149,6 +177,10 @@ assertSetParameterSucceeds("internalQueryMaxBlockingSortMemoryUsageBytes", 11);
 assertSetParameterSucceeds("internalQueryMaxBlockingSortMemoryUsageBytes", 0);
 assertSetParameterFails("internalQueryMaxBlockingSortMemoryUsageBytes", -1);
 
+assertSetParameterSucceeds("internalQueryAnalyzeMaxMemoryUsageBytes", 1024);
+assertSetParameterFails("internalQueryAnalyzeMaxMemoryUsageBytes", 0);
+assertSetParameterFails("internalQueryAnalyzeMaxMemoryUsageBytes", -1);
+
 assertSetParameterSucceeds("internalQueryExecYieldIterations", 10);
 assertSetParameterSucceeds("internalQueryExecYieldIterations", 0);
 assertSetParameterSucceeds("internalQueryExecYieldIterations", -1);
@@ -161,14 +193,41 @@ assertSetParameterSucceeds("internalQueryExecYieldPeriodMS", 11);
 assertSetParameterSucceeds("internalQueryExecYieldPeriodMS", 0);
 assertSetParameterFails("internalQueryExecYieldPeriodMS", -1);
 
+assertSetParameterSucceeds("internalQueryExecMaxScanBatchSize", 1);
+assertSetParameterSucceeds("internalQueryExecMaxScanBatchSize", 1024);
+assertSetParameterFails("internalQueryExecMaxScanBatchSize", 0);
+assertSetParameterFails("internalQueryExecMaxScanBatchSize", 1025);
+
 assertSetParameterSucceeds("internalQueryFacetBufferSizeBytes", 1);
 assertSetParameterFails("internalQueryFacetBufferSizeBytes", 0);
 assertSetParameterFails("internalQueryFacetBufferSizeBytes", -1);
 
+assertSetParameterSucceeds("internalQueryFacetMaxParallelWorkers", 0);
+assertSetParameterSucceeds("internalQueryFacetMaxParallelWorkers", 64);
+assertSetParameterFails("internalQueryFacetMaxParallelWorkers", -1);
+assertSetParameterFails("internalQueryFacetMaxParallelWorkers", 65);
+
 assertSetParameterSucceeds("internalDocumentSourceGroupMaxMemoryBytes", 11);
 assertSetParameterFails("internalDocumentSourceGroupMaxMemoryBytes", 0);
 assertSetParameterFails("internalDocumentSourceGroupMaxMemoryBytes", -1);
 
+assertSetParameterSucceeds("internalQueryGroupMaxParallelWorkers", 0);
+assertSetParameterSucceeds("internalQueryGroupMaxParallelWorkers", 64);
+assertSetParameterFails("internalQueryGroupMaxParallelWorkers", -1);
+assertSetParameterFails("internalQueryGroupMaxParallelWorkers", 65);
+
+assertSetParameterSucceeds("internalQueryGroupParallelPartitions", 2);
+assertSetParameterSucceeds("internalQueryGroupParallelPartitions", 64);
+assertSetParameterFails("internalQueryGroupParallelPartitions", 1);
+assertSetParameterFails("internalQueryGroupParallelPartitions", 65);
+
+assertSetParameterSucceeds("internalQueryAggregationResultCacheMaxSizeBytes", 0);
+assertSetParameterSucceeds("internalQueryAggregationResultCacheMaxSizeBytes", 1024 * 1024);
+assertSetParameterFails("internalQueryAggregationResultCacheMaxSizeBytes", -1);
+
+assertSetParameterSucceeds("internalQueryAggregationResultCacheMaxEntryAgeSecs", 1);
+assertSetParameterFails("internalQueryAggregationResultCacheMaxEntryAgeSecs", 0);
+
 assertSetParameterSucceeds("internalDocumentSourceSetWindowFieldsMaxMemoryBytes", 11);
 assertSetParameterFails("internalDocumentSourceSetWindowFieldsMaxMemoryBytes", 0);
 assertSetParameterFails("internalDocumentSourceSetWindowFieldsMaxMemoryBytes", -1);
@@ -202,6 +261,11 @@ assertSetParameterSucceeds("internalDocumentSourceCursorBatchSizeBytes", 11);
 assertSetParameterSucceeds("internalDocumentSourceCursorBatchSizeBytes", 0);
 assertSetParameterFails("internalDocumentSourceCursorBatchSizeBytes", -1);
 
+assertSetParameterSucceeds("internalDocumentSourceGetNextBatchSize", 1);
+assertSetParameterSucceeds("internalDocumentSourceGetNextBatchSize", 1000);
+assertSetParameterFails("internalDocumentSourceGetNextBatchSize", 0);
+assertSetParameterFails("internalDocumentSourceGetNextBatchSize", -1);
+
 assertSetParameterSucceeds("internalDocumentSourceLookupCacheSizeBytes", 11);
 assertSetParameterSucceeds("internalDocumentSourceLookupCacheSizeBytes", 0);
 assertSetParameterFails("internalDocumentSourceLookupCacheSizeBytes", -1);
@@ -210,20 +274,34 @@ assertSetParameterSucceeds("internalQuerySlotBasedExecutionMaxStaticIndexScanInt
 assertSetParameterFails("internalQuerySlotBasedExecutionMaxStaticIndexScanIntervals", 0);
 assertSetParameterFails("internalQuerySlotBasedExecutionMaxStaticIndexScanIntervals", -1);
 
+assertSetParameterSucceeds("internalQuerySlotBasedExecutionBlockSize", 128);
+assertSetParameterSucceeds("internalQuerySlotBasedExecutionBlockSize", 0);
+assertSetParameterFails("internalQuerySlotBasedExecutionBlockSize", -1);
+
+assertSetParameterSucceeds("internalQuerySlotBasedExecutionEnableNativeCode", false);
+assertSetParameterSucceeds("internalQuerySlotBasedExecutionEnableNativeCode", true);
+
+assertSetParameterSucceeds("internalQuerySlotBasedExecutionNativeCodeThreshold", 1);
+assertSetParameterFails("internalQuerySlotBasedExecutionNativeCodeThreshold", 0);
+assertSetParameterFails("internalQuerySlotBasedExecutionNativeCodeThreshold", -1);
+
 assertSetParameterSucceeds("internalQueryForceClassicEngine", true);
 assertSetParameterSucceeds("internalQueryForceClassicEngine", false);
 
-assertSetParameterSucceeds("internalQueryCollectionMaxNoOfDocumentsToChooseHashJoin", 1);
-assertSetParameterFails("internalQueryCollectionMaxNoOfDocumentsToChooseHashJoin", 0);
-assertSetParameterFails("internalQueryCollectionMaxNoOfDocumentsToChooseHashJoin", -1);
+assertSetParameterSucceeds(
+    "internalQuerySlotBasedExecutionHashLookupApproxMemoryUseInBytesBeforeSpill", 100);
+assertSetParameterFails(
+    "internalQuerySlotBasedExecutionHashLookupApproxMemoryUseInBytesBeforeSpill", 0);
+assertSetParameterFails(
+    "internalQuerySlotBasedExecutionHashLookupApproxMemoryUseInBytesBeforeSpill", -1);
 
-assertSetParameterSucceeds("internalQueryCollectionMaxDataSizeBytesToChooseHashJoin", 100);
-assertSetParameterFails("internalQueryCollectionMaxDataSizeBytesToChooseHashJoin", 0);
-assertSetParameterFails("internalQueryCollectionMaxDataSizeBytesToChooseHashJoin", -1);
+assertSetParameterSucceeds("internalQuerySlotBasedExecutionDegreeOfParallelism", 4);
+assertSetParameterSucceeds("internalQuerySlotBasedExecutionDegreeOfParallelism", 1);
+assertSetParameterFails("internalQuerySlotBasedExecutionDegreeOfParallelism", 0);
+assertSetParameterFails("internalQuerySlotBasedExecutionDegreeOfParallelism", 65);
 
-assertSetParameterSucceeds("internalQueryCollectionMaxStorageSizeBytesToChooseHashJoin", 100);
-assertSetParameterFails("internalQueryCollectionMaxStorageSizeBytesToChooseHashJoin", 0);
-assertSetParameterFails("internalQueryCollectionMaxStorageSizeBytesToChooseHashJoin", -1);
+assertSetParameterSucceeds("internalQuerySlotBasedExecutionParallelScanMinRecords", 0);
+assertSetParameterFails("internalQuerySlotBasedExecutionParallelScanMinRecords", -1);
 
 assertSetParameterSucceeds("internalQueryDisableLookupExecutionUsingHashJoin", true);
 assertSetParameterSucceeds("internalQueryDisableLookupExecutionUsingHashJoin", false);
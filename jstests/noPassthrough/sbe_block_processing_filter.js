@@ -0,0 +1,172 @@
+/**
+ * Tests that SBE collection scans which apply the comparisons of their filter to blocks of rows,
+ * and the $group stages which compute their accumulators over these blocks, when
+ * 'internalQuerySlotBasedExecutionBlockSize' is set, return the same results as the row-at-a-time
+ * plans.
+ */
+(function() {
+"use strict";
+
+load("jstests/libs/analyze_plan.js");
+load("jstests/libs/sbe_util.js");  // For checkSBEEnabled.
+
+const conn = MongoRunner.runMongod();
+assert.neq(null, conn, "mongod was unable to start up");
+
+const db = conn.getDB("test");
+if (!checkSBEEnabled(db)) {
+    jsTestLog("Skipping test because SBE is not enabled");
+    MongoRunner.stopMongod(conn);
+    return;
+}
+
+const coll = db.sbe_block_processing_filter;
+coll.drop();
+
+const values = [
+    1,
+    2,
+    NumberLong(3),
+    3.5,
+    NumberDecimal("4.5"),
+    NaN,
+    NumberDecimal("NaN"),
+    -Infinity,
+    "5",
+    null,
+    [1, 7],
+    [],
+    {x: 1},
+];
+let docs = [];
+let id = 0;
+for (let a of values) {
+    for (let b of values) {
+        docs.push({_id: id++, a: a, b: b});
+    }
+}
+docs.push({_id: id++});
+docs.push({_id: id++, a: 2});
+docs.push({_id: id++, b: 2});
+assert.commandWorked(coll.insert(docs));
+
+function setBlockSize(blockSize) {
+    assert.commandWorked(
+        db.adminCommand({setParameter: 1, internalQuerySlotBasedExecutionBlockSize: blockSize}));
+}
+
+function runQuery(filter) {
+    return coll.find(filter).sort({_id: 1}).toArray();
+}
+
+const filters = [
+    {a: {$gt: 2}},
+    {a: {$gte: 2}},
+    {a: {$lt: 3.5}},
+    {a: {$lte: NumberLong(3)}},
+    {a: 2},
+    {a: {$eq: NumberDecimal("4.5")}},
+    {a: {$gt: 1}, b: {$lte: 3}},
+    {a: {$gt: 1, $lt: 4}},
+    {a: {$gt: 1}, b: {$type: "string"}},
+    {$and: [{a: {$gte: -Infinity}}, {b: {$lt: 2}}]},
+    {a: {$gt: 1}, "b.x": 1},
+    // Filters which are not applied to blocks of rows.
+    {a: {$gt: "4"}},
+    {a: NaN},
+    {$or: [{a: 1}, {b: 2}]},
+];
+
+for (let blockSize of [1, 3, 64]) {
+    for (let filter of filters) {
+        setBlockSize(0);
+        const expected = runQuery(filter);
+        setBlockSize(blockSize);
+        assert.eq(expected, runQuery(filter), {filter: filter, blockSize: blockSize});
+    }
+}
+
+// Only the plans of filters with comparisons to numbers use the block stages.
+setBlockSize(64);
+function usesBlocks(filter) {
+    const explain = coll.find(filter).explain("executionStats");
+    return getPlanStages(explain.executionStats.executionStages, "block_to_row").length > 0;
+}
+assert(usesBlocks({a: {$gt: 2}}));
+assert(usesBlocks({a: {$gt: 1}, b: {$type: "string"}}));
+assert(!usesBlocks({a: {$gt: "4"}}));
+assert(!usesBlocks({$or: [{a: 1}, {b: 2}]}));
+setBlockSize(0);
+assert(!usesBlocks({a: {$gt: 2}}));
+
+// A cached auto-parameterized plan can be reused with constants which cannot be applied to blocks.
+const paramFilters = [];
+for (let rhs of [2, 3.5, "5", NaN, NumberDecimal("NaN"), null, 2]) {
+    paramFilters.push({a: {$gte: rhs}}, {a: {$lte: rhs}}, {a: rhs});
+}
+setBlockSize(0);
+const paramExpected = paramFilters.map(runQuery);
+setBlockSize(64);
+paramFilters.forEach((filter, idx) => {
+    // Run each query twice, so that it is also executed from the plan cache.
+    assert.eq(paramExpected[idx], runQuery(filter), {filter: filter});
+    assert.eq(paramExpected[idx], runQuery(filter), {filter: filter});
+});
+
+// A $group with a constant _id computes its accumulators over the blocks of an unfiltered scan,
+// or of a scan whose filter is entirely applied to the blocks.
+function runGroup(pipeline) {
+    return coll.aggregate(pipeline).toArray();
+}
+const groupAccumulators = {
+    n: {$sum: 1},
+    twice: {$sum: 2},
+    sumA: {$sum: "$a"},
+    minA: {$min: "$a"},
+    maxB: {$max: "$b"},
+};
+const groupPipelines = [
+    [{$group: Object.assign({_id: null}, groupAccumulators)}],
+    [{$match: {a: {$gt: 1}}}, {$group: Object.assign({_id: "x"}, groupAccumulators)}],
+    [{$match: {a: {$gte: 2}, b: {$lt: 3.5}}}, {$group: Object.assign({_id: 1}, groupAccumulators)}],
+    [{$match: {a: {$gt: 100}}}, {$group: {_id: null, n: {$sum: 1}}}],
+    // Groups which are not computed over blocks of rows.
+    [{$match: {a: {$gt: 1}, b: {$type: "string"}}}, {$group: {_id: null, n: {$sum: 1}}}],
+    [{$group: {_id: "$a", n: {$sum: 1}}}, {$sort: {_id: 1}}],
+    [{$group: {_id: null, n: {$sum: "$b.x"}, first: {$first: "$a"}}}],
+];
+for (let blockSize of [1, 3, 64]) {
+    for (let pipeline of groupPipelines) {
+        setBlockSize(0);
+        const expected = runGroup(pipeline);
+        setBlockSize(blockSize);
+        assert.eq(expected, runGroup(pipeline), {pipeline: pipeline, blockSize: blockSize});
+    }
+}
+
+// The groups over blocks do not turn the blocks back into rows.
+setBlockSize(64);
+function groupUsesBlocks(pipeline) {
+    const explain = tojson(coll.explain("executionStats").aggregate(pipeline));
+    return explain.includes("row_to_block") && !explain.includes("block_to_row");
+}
+assert(groupUsesBlocks(groupPipelines[0]), groupPipelines[0]);
+assert(groupUsesBlocks(groupPipelines[1]), groupPipelines[1]);
+assert(!groupUsesBlocks(groupPipelines[5]), groupPipelines[5]);
+setBlockSize(0);
+assert(!groupUsesBlocks(groupPipelines[0]), groupPipelines[0]);
+
+// The auto-parameterized groups over blocks fall back to the row-at-a-time group when they are
+// reused with constants which cannot be applied to blocks.
+const paramGroups = [2, 3.5, "5", NaN, null, 2].map(
+    rhs => [{$match: {a: {$gte: rhs}}}, {$group: Object.assign({_id: null}, groupAccumulators)}]);
+setBlockSize(0);
+const paramGroupExpected = paramGroups.map(runGroup);
+setBlockSize(64);
+paramGroups.forEach((pipeline, idx) => {
+    assert.eq(paramGroupExpected[idx], runGroup(pipeline), {pipeline: pipeline});
+    assert.eq(paramGroupExpected[idx], runGroup(pipeline), {pipeline: pipeline});
+});
+
+MongoRunner.stopMongod(conn);
+}());
@@ -0,0 +1,91 @@
+/**
+ * Tests that SBE collection scans and $group stages split across several threads by an exchange
+ * return the same results as their serial counterparts.
+ */
+(function() {
+"use strict";
+
+load("jstests/aggregation/extras/utils.js");  // For arrayEq.
+load("jstests/libs/sbe_util.js");             // For checkSBEEnabled.
+
+const conn = MongoRunner.runMongod();
+assert.neq(null, conn, "mongod was unable to start up");
+const db = conn.getDB("sbe_parallel_collscan");
+
+if (!checkSBEEnabled(db)) {
+    jsTestLog("Skipping test because SBE is not enabled");
+    MongoRunner.stopMongod(conn);
+    return;
+}
+
+const coll = db.coll;
+coll.drop();
+
+// Insert enough documents for the scan to be split into several ranges.
+const nDocs = 50000;
+const docs = [];
+for (let i = 0; i < nDocs; ++i) {
+    docs.push({_id: i, a: i % 10, b: i, c: (i % 3 == 0) ? NumberDecimal(i) : i * 0.5});
+}
+assert.commandWorked(coll.insert(docs));
+
+function setParallelism(degreeOfParallelism) {
+    assert.commandWorked(db.adminCommand({
+        setParameter: 1,
+        internalQuerySlotBasedExecutionDegreeOfParallelism: degreeOfParallelism,
+        internalQuerySlotBasedExecutionParallelScanMinRecords: 1000,
+    }));
+}
+
+const groupPipeline = [{
+    $group: {
+        _id: "$a",
+        sum: {$sum: "$b"},
+        decimalSum: {$sum: "$c"},
+        avg: {$avg: "$c"},
+        min: {$min: "$b"},
+        max: {$max: "$c"},
+        count: {$count: {}},
+    }
+}];
+
+function runQueries() {
+    return {
+        all: coll.find().toArray(),
+        filtered: coll.find({a: 3, b: {$gte: 100}}, {_id: 0, b: 1}).toArray(),
+        limited: [coll.find({a: 7}).limit(5).itcount()],
+        sorted: coll.find({a: 1}).sort({b: -1}).limit(10).toArray(),
+        natural: coll.find({}).sort({$natural: 1}).limit(10).toArray(),
+        group: coll.aggregate(groupPipeline).toArray(),
+        // The order of the pushed values depends on the scan order, so normalize it.
+        groupWithPush:
+            coll.aggregate([{$match: {b: {$lt: 100}}}, {$group: {_id: "$a", b: {$push: "$b"}}}])
+                .toArray()
+                .map(doc => Object.assign(doc, {b: doc.b.sort((x, y) => x - y)})),
+        count: coll.aggregate([{$match: {a: {$gt: 4}}}, {$count: "n"}]).toArray(),
+    };
+}
+
+setParallelism(1);
+const expected = runQueries();
+
+for (let degreeOfParallelism of [2, 4, 7]) {
+    setParallelism(degreeOfParallelism);
+    const actual = runQueries();
+
+    assert.eq(nDocs, actual.all.length);
+    for (let key of Object.keys(expected)) {
+        assert(arrayEq(expected[key], actual[key]),
+               {key: key, expected: expected[key], actual: actual[key]});
+    }
+    // Non-blocking plans over a parallel scan give no ordering guarantees, but $natural order must
+    // still be honoured by scanning serially.
+    assert.eq(expected.natural, actual.natural);
+    assert.eq(expected.sorted, actual.sorted);
+
+    // Explain always runs serially.
+    assert.commandWorked(coll.find({a: 3}).explain("executionStats"));
+}
+
+MongoRunner.stopMongod(conn);
+})();
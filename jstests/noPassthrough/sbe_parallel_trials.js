@@ -0,0 +1,159 @@
+/**
+ * Tests that the SBE multi-planner picks plans which return the same results when it runs the
+ * trial periods of the candidate plans concurrently.
+ */
+(function() {
+"use strict";
+
+load("jstests/aggregation/extras/utils.js");  // For arrayEq.
+load("jstests/libs/analyze_plan.js");         // For getWinningPlan and getPlanStages.
+load("jstests/libs/fail_point_util.js");      // For configureFailPoint.
+load("jstests/libs/sbe_util.js");             // For checkSBEEnabled.
+
+const conn = MongoRunner.runMongod();
+assert.neq(null, conn, "mongod was unable to start up");
+const db = conn.getDB("sbe_parallel_trials");
+
+if (!checkSBEEnabled(db)) {
+    jsTestLog("Skipping test because SBE is not enabled");
+    MongoRunner.stopMongod(conn);
+    return;
+}
+
+const coll = db.coll;
+coll.drop();
+
+const nDocs = 5000;
+const docs = [];
+for (let i = 0; i < nDocs; ++i) {
+    docs.push({_id: i, a: i % 10, b: i % 100, c: i % 7, d: i});
+}
+assert.commandWorked(coll.insert(docs));
+for (let index of [{a: 1}, {b: 1}, {c: 1}, {d: 1}, {a: 1, b: 1}, {b: 1, c: 1}]) {
+    assert.commandWorked(coll.createIndex(index));
+}
+
+function setParallelTrials(numTrials) {
+    assert.commandWorked(db.adminCommand(
+        {setParameter: 1, internalQueryPlanEvaluationParallelTrialsSbe: numTrials}));
+}
+
+function runQueries() {
+    coll.getPlanCache().clear();
+    return {
+        equality: coll.find({a: 3, b: 13, c: 6}).toArray(),
+        range: coll.find({a: {$gte: 8}, d: {$lt: 400}, c: {$ne: 2}}).toArray(),
+        noResults: coll.find({a: 1, b: 2, c: 3}).toArray(),
+        sorted: coll.find({a: 5, c: {$lt: 3}}).sort({d: -1}).limit(20).toArray(),
+        blocking: coll.find({b: {$gt: 90}, c: 1}).sort({a: 1, d: 1}).toArray(),
+        projected: coll.find({a: 2, b: {$in: [2, 12, 22]}}, {_id: 0, d: 1}).toArray(),
+        group: coll.aggregate([{$match: {a: 4, c: {$gte: 3}}}, {$group: {_id: "$b", n: {$sum: 1}}}])
+                   .toArray(),
+    };
+}
+
+// Queries for which one candidate plan is clearly better than the others. There are more
+// candidates than worker threads for some of the tested concurrencies.
+const rankedQueries = {
+    equality: {a: 3, b: 13, c: 6},
+    range: {a: {$gte: 8}, d: {$lt: 400}, c: {$ne: 2}},
+    projected: {a: 2, b: {$in: [2, 12, 22]}},
+};
+
+// Returns the key patterns of the indexes scanned by the winning plan of 'filter'.
+function getWinningIndexes(filter) {
+    coll.getPlanCache().clear();
+    const explain = coll.find(filter).explain();
+    return getPlanStages(getWinningPlan(explain.queryPlanner), "IXSCAN")
+        .map(stage => stage.keyPattern);
+}
+
+setParallelTrials(1);
+const expected = runQueries();
+const expectedWinningIndexes = {};
+for (let key of Object.keys(rankedQueries)) {
+    expectedWinningIndexes[key] = getWinningIndexes(rankedQueries[key]);
+}
+
+for (let numTrials of [2, 4, 16]) {
+    setParallelTrials(numTrials);
+    const actual = runQueries();
+    for (let key of Object.keys(expected)) {
+        assert(arrayEq(expected[key], actual[key]),
+               {key: key, numTrials: numTrials, expected: expected[key], actual: actual[key]});
+    }
+    assert.eq(expected.sorted, actual.sorted);
+    assert.eq(expected.blocking, actual.blocking);
+
+    // The plans are still multi-planned, and the winning plan is cached.
+    const explain = coll.find({a: 3, b: 13, c: 6}).explain("allPlansExecution");
+    assert.gt(explain.queryPlanner.rejectedPlans.length, 0, explain);
+    assert.eq(explain.queryPlanner.rejectedPlans.length + 1,
+              explain.executionStats.allPlansExecution.length,
+              explain);
+    assert.eq(expected.equality.length, coll.find({a: 3, b: 13, c: 6}).itcount());
+    assert.gt(coll.getPlanCache().list().length, 0);
+
+    // The same plan wins as when the trials run one after another.
+    for (let key of Object.keys(rankedQueries)) {
+        assert.eq(expectedWinningIndexes[key],
+                  getWinningIndexes(rankedQueries[key]),
+                  {key: key, numTrials: numTrials});
+    }
+
+    // Every candidate gets the budget of reads of the most efficient plan which completed its
+    // trial, including the candidates whose trial starts after that plan has completed. The reads
+    // are estimated from the keys and documents examined, with some slack.
+    const candidates = explain.executionStats.allPlansExecution;
+    assert.gt(candidates.length, 2, explain);
+    const getReads = (candidate) => candidate.totalKeysExamined + candidate.totalDocsExamined;
+    const budget =
+        Math.min(...candidates.filter(c => c.nReturned === expected.equality.length).map(getReads));
+    assert(Number.isFinite(budget), explain);
+    for (let candidate of candidates) {
+        assert.gte(getReads(candidate), budget / 2, {numTrials: numTrials, explain: explain});
+    }
+}
+
+// A killOp of the query stops the trials running on the worker threads.
+setParallelTrials(4);
+coll.getPlanCache().clear();
+const comment = "sbe_parallel_trials_killop";
+const hangInWorker = configureFailPoint(conn, "hangInSbeTrialRunWorker");
+const awaitShell = startParallelShell(
+    funWithArgs(function(dbName, collName, comment) {
+        const res = db.getSiblingDB(dbName).runCommand(
+            {find: collName, filter: {a: 3, b: 13, c: 6}, comment: comment});
+        assert.commandFailedWithCode(res, ErrorCodes.Interrupted);
+    }, db.getName(), coll.getName(), comment), conn.port);
+hangInWorker.wait();
+
+let opId;
+assert.soon(() => {
+    const ops = db.getSiblingDB("admin")
+                    .aggregate([
+                        {$currentOp: {allUsers: true}},
+                        {$match: {"command.comment": comment}},
+                    ])
+                    .toArray();
+    if (ops.length !== 1) {
+        return false;
+    }
+    opId = ops[0].opid;
+    return true;
+});
+assert.commandWorked(db.killOp(opId));
+awaitShell();
+hangInWorker.off();
+
+// The workers are all gone, and the next query is planned normally.
+assert.soon(() => db.getSiblingDB("admin")
+                      .aggregate([
+                          {$currentOp: {allUsers: true}},
+                          {$match: {desc: /^TrialRun/, active: true}},
+                      ])
+                      .itcount() === 0);
+assert(arrayEq(expected.equality, coll.find({a: 3, b: 13, c: 6}).toArray()));
+
+MongoRunner.stopMongod(conn);
+})();
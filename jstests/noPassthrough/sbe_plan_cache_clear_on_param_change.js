@@ -30,11 +30,11 @@ const paramList = [
     {name: "internalQueryPlannerGenerateCoveredWholeIndexScans", value: true},
     {name: "internalQueryMaxBlockingSortMemoryUsageBytes", value: 1024},
     {name: "internalQuerySlotBasedExecutionMaxStaticIndexScanIntervals", value: 20},
+    {name: "internalQuerySlotBasedExecutionBlockSize", value: 64},
     {name: "internalQueryDefaultDOP", value: 2},
-    {name: "internalQueryCollectionMaxNoOfDocumentsToChooseHashJoin", value: 1},
-    {name: "internalQueryCollectionMaxDataSizeBytesToChooseHashJoin", value: 100},
-    {name: "internalQueryCollectionMaxStorageSizeBytesToChooseHashJoin", value: 100},
     {name: "internalQueryDisableLookupExecutionUsingHashJoin", value: true},
+    {name: "internalQuerySlotBasedExecutionDegreeOfParallelism", value: 2},
+    {name: "internalQuerySlotBasedExecutionParallelScanMinRecords", value: 10},
 ];
 
 const conn = MongoRunner.runMongod();
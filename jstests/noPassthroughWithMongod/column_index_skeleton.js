@@ -5,6 +5,7 @@
 (function() {
 "use strict";
 
+load("jstests/aggregation/extras/utils.js");  // For arrayEq.
 load("jstests/libs/fail_point_util.js");
 load("jstests/libs/analyze_plan.js");
 load("jstests/libs/sbe_util.js");  // For checkSBEEnabled.
@@ -36,4 +37,53 @@ try {
 } finally {
     failPoint.off();
 }
+
+// Test that the predicates pushed down into the column scan, as well as those applied on top of it,
+// return the same results as a collection scan.
+const filterColl = db.column_index_skeleton_filters;
+filterColl.drop();
+
+const docs = [];
+for (let i = 0; i < 100; ++i) {
+    docs.push({
+        _id: i,
+        a: i % 10,
+        b: {c: (i % 2 == 0) ? i : [i, i + 100], d: "str" + (i % 7)},
+        e: (i % 3 == 0) ? [{f: i}, {f: -i}] : {f: i},
+    });
+}
+docs.push({_id: 100, b: {c: []}});
+docs.push({_id: 101, b: [{c: 1}, {c: [2, 3]}]});
+assert.commandWorked(filterColl.insert(docs));
+
+const filterTests = [
+    {filter: {a: 3}, proj: {_id: 0, a: 1, "b.c": 1}},
+    {filter: {a: {$gt: 7}}, proj: {_id: 1, a: 1}},
+    {filter: {a: {$gte: 2, $lt: 5}}, proj: {_id: 1}},
+    {filter: {"b.c": {$lte: 3}}, proj: {_id: 1, "b.c": 1}},
+    {filter: {"b.c": {$gt: 150}}, proj: {_id: 1}},
+    {filter: {"b.c": {$eq: []}}, proj: {_id: 1}},
+    {filter: {"b.c": {$in: [2, 104, 105]}}, proj: {_id: 1}},
+    {filter: {"e.f": {$lt: -80}}, proj: {_id: 1, "e.f": 1}},
+    {filter: {a: {$in: [1, 2]}, "b.d": "str1"}, proj: {_id: 1, a: 1}},
+    // Regexes are not pushed down into the scan.
+    {filter: {a: {$lt: 5}, "b.d": /str[12]/}, proj: {_id: 1, "b.d": 1}},
+    {filter: {"b.d": {$in: ["str3", /^str4/]}}, proj: {_id: 1}},
+];
+
+const expectedResults = filterTests.map(test => filterColl.find(test.filter, test.proj).toArray());
+
+const filterFailPoint = configureFailPoint(testDB, "includeFakeColumnarIndex");
+try {
+    filterTests.forEach((test, idx) => {
+        const expl = filterColl.find(test.filter, test.proj).explain();
+        assert(planHasStage(db, expl, "COLUMN_IXSCAN"), {test: test, explain: expl});
+
+        const results = filterColl.find(test.filter, test.proj).toArray();
+        assert(arrayEq(expectedResults[idx], results),
+               {test: test, expected: expectedResults[idx], actual: results});
+    });
+} finally {
+    filterFailPoint.off();
+}
 })();
@@ -211,6 +211,14 @@ let testCases = {
         checkReadConcern: true,
         checkWriteConcern: true,
     },
+    analyze: {
+        setUp: function(conn) {
+            assert.commandWorked(conn.getCollection(nss).insert({x: 1}, {writeConcern: {w: 1}}));
+        },
+        command: {analyze: coll, key: "x"},
+        checkReadConcern: false,
+        checkWriteConcern: true,
+    },
     appendOplogNote: {
         command: {appendOplogNote: 1, data: {foo: 1}},
         checkReadConcern: false,
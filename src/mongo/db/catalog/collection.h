@@ -64,6 +64,7 @@ namespace mongo {
 
 class CappedCallback;
 class CollectionPtr;
+class FieldRefSet;
 class IndexCatalog;
 class IndexCatalogEntry;
 class MatchExpression;
@@ -100,6 +101,10 @@ struct CollectionUpdateArgs {
 
     // Set if OpTimes were reserved for the update ahead of time.
     std::vector<OplogSlot> oplogSlots;
+
+    // Paths written by the update, if known. Indexes over none of these paths keep their keys
+    // untouched. Must outlive the call to Collection::updateDocument().
+    const FieldRefSet* modifiedPaths = nullptr;
 };
 
 /**
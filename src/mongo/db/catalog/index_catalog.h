@@ -47,6 +47,7 @@ namespace mongo {
 class Client;
 class Collection;
 class CollectionPtr;
+class FieldRefSet;
 
 class IndexDescriptor;
 struct InsertDeleteOptions;
@@ -458,6 +459,9 @@ public:
      * Both 'keysInsertedOut' and 'keysDeletedOut' are required and will be set to the number of
      * index keys inserted and deleted by this operation, respectively.
      *
+     * If 'modifiedPaths' is not null, only indexes over at least one of those paths regenerate
+     * their keys; the keys of the other indexes cannot differ between 'oldDoc' and 'newDoc'.
+     *
      * This method may throw.
      */
     virtual Status updateRecord(OperationContext* opCtx,
@@ -465,6 +469,7 @@ public:
                                 const BSONObj& oldDoc,
                                 const BSONObj& newDoc,
                                 const RecordId& recordId,
+                                const FieldRefSet* modifiedPaths,
                                 int64_t* keysInsertedOut,
                                 int64_t* keysDeletedOut) const = 0;
 
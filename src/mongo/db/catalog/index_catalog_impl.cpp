@@ -33,6 +33,7 @@
 
 #include "mongo/db/catalog/index_catalog_impl.h"
 
+#include <algorithm>
 #include <vector>
 
 #include "mongo/base/init.h"
@@ -50,6 +51,7 @@
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/curop.h"
 #include "mongo/db/field_ref.h"
+#include "mongo/db/field_ref_set.h"
 #include "mongo/db/fts/fts_spec.h"
 #include "mongo/db/index/index_access_method.h"
 #include "mongo/db/index/index_descriptor.h"
@@ -1504,8 +1506,21 @@ Status IndexCatalogImpl::_updateRecord(OperationContext* const opCtx,
                                        const BSONObj& oldDoc,
                                        const BSONObj& newDoc,
                                        const RecordId& recordId,
+                                       const FieldRefSet* modifiedPaths,
                                        int64_t* const keysInsertedOut,
                                        int64_t* const keysDeletedOut) const {
+    if (modifiedPaths) {
+        // The keys of an index can only change if the update wrote to one of its paths.
+        const UpdateIndexData* indexedPaths = CollectionQueryInfo::get(coll).getIndexKeys(
+            opCtx, index->descriptor()->indexName());
+        if (indexedPaths &&
+            std::none_of(modifiedPaths->begin(), modifiedPaths->end(), [&](const FieldRef* path) {
+                return indexedPaths->mightBeIndexed(*path);
+            })) {
+            return Status::OK();
+        }
+    }
+
     SharedBufferFragmentBuilder pooledBuilder(KeyString::HeapBuilder::kHeapAllocatorDefaultBytes);
 
     InsertDeleteOptions options;
@@ -1633,6 +1648,7 @@ Status IndexCatalogImpl::updateRecord(OperationContext* const opCtx,
                                       const BSONObj& oldDoc,
                                       const BSONObj& newDoc,
                                       const RecordId& recordId,
+                                      const FieldRefSet* modifiedPaths,
                                       int64_t* const keysInsertedOut,
                                       int64_t* const keysDeletedOut) const {
     *keysInsertedOut = 0;
@@ -1643,8 +1659,15 @@ Status IndexCatalogImpl::updateRecord(OperationContext* const opCtx,
          it != _readyIndexes.end();
          ++it) {
         IndexCatalogEntry* entry = it->get();
-        auto status = _updateRecord(
-            opCtx, coll, entry, oldDoc, newDoc, recordId, keysInsertedOut, keysDeletedOut);
+        auto status = _updateRecord(opCtx,
+                                    coll,
+                                    entry,
+                                    oldDoc,
+                                    newDoc,
+                                    recordId,
+                                    modifiedPaths,
+                                    keysInsertedOut,
+                                    keysDeletedOut);
         if (!status.isOK())
             return status;
     }
@@ -1654,8 +1677,15 @@ Status IndexCatalogImpl::updateRecord(OperationContext* const opCtx,
          it != _buildingIndexes.end();
          ++it) {
         IndexCatalogEntry* entry = it->get();
-        auto status = _updateRecord(
-            opCtx, coll, entry, oldDoc, newDoc, recordId, keysInsertedOut, keysDeletedOut);
+        auto status = _updateRecord(opCtx,
+                                    coll,
+                                    entry,
+                                    oldDoc,
+                                    newDoc,
+                                    recordId,
+                                    modifiedPaths,
+                                    keysInsertedOut,
+                                    keysDeletedOut);
         if (!status.isOK())
             return status;
     }
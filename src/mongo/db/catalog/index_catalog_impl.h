@@ -247,6 +247,7 @@ public:
                         const BSONObj& oldDoc,
                         const BSONObj& newDoc,
                         const RecordId& recordId,
+                        const FieldRefSet* modifiedPaths,
                         int64_t* keysInsertedOut,
                         int64_t* keysDeletedOut) const override;
     /**
@@ -322,6 +323,7 @@ private:
                          const BSONObj& oldDoc,
                          const BSONObj& newDoc,
                          const RecordId& recordId,
+                         const FieldRefSet* modifiedPaths,
                          int64_t* keysInsertedOut,
                          int64_t* keysDeletedOut) const;
 
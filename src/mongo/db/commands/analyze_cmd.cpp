@@ -0,0 +1,237 @@
+/**
+ *    Copyright (C) 2022-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#define MONGO_LOGV2_DEFAULT_COMPONENT ::mongo::logv2::LogComponent::kCommand
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/auth/authorization_session.h"
+#include "mongo/db/bson/dotted_path_support.h"
+#include "mongo/db/catalog/collection.h"
+#include "mongo/db/commands.h"
+#include "mongo/db/commands/analyze_gen.h"
+#include "mongo/db/db_raii.h"
+#include "mongo/db/dbdirectclient.h"
+#include "mongo/db/exec/multi_iterator.h"
+#include "mongo/db/exec/working_set.h"
+#include "mongo/db/field_ref.h"
+#include "mongo/db/ops/write_ops.h"
+#include "mongo/db/pipeline/expression_context.h"
+#include "mongo/db/query/ce/collection_statistics.h"
+#include "mongo/db/query/internal_plans.h"
+#include "mongo/db/query/plan_executor_factory.h"
+#include "mongo/db/query/query_knobs_gen.h"
+#include "mongo/logv2/log.h"
+
+namespace mongo {
+namespace {
+
+/**
+ * Returns a yielding executor which reads a random sample of 'sampleSize' documents of
+ * 'collection', or all of its documents if it holds no more than 'sampleSize' documents or its
+ * storage engine cannot sample records at random.
+ */
+std::unique_ptr<PlanExecutor, PlanExecutor::Deleter> makeSampleExecutor(
+    OperationContext* opCtx, const CollectionPtr& collection, long long sampleSize) {
+    std::unique_ptr<RecordCursor> randomCursor;
+    if (sampleSize < collection->numRecords(opCtx)) {
+        randomCursor = collection->getRecordStore()->getRandomCursor(opCtx);
+    }
+    if (!randomCursor) {
+        return InternalPlanner::collectionScan(
+            opCtx, &collection, PlanYieldPolicy::YieldPolicy::YIELD_AUTO);
+    }
+
+    auto expCtx =
+        make_intrusive<ExpressionContext>(opCtx, nullptr /* collator */, collection->ns());
+    auto ws = std::make_unique<WorkingSet>();
+    auto root = std::make_unique<MultiIteratorStage>(expCtx.get(), ws.get(), collection);
+    root->addIterator(std::move(randomCursor));
+    return uassertStatusOK(plan_executor_factory::make(expCtx,
+                                                       std::move(ws),
+                                                       std::move(root),
+                                                       &collection,
+                                                       PlanYieldPolicy::YieldPolicy::YIELD_AUTO,
+                                                       QueryPlannerParams::DEFAULT));
+}
+
+/**
+ * Example analyze command:
+ *   {
+ *       analyze: <collection>,
+ *       key: <dotted path>,
+ *       numberBuckets: <int>,
+ *       sampleSize: <int>
+ *   }
+ *
+ * Reads the values of 'key' in a random sample of 'sampleSize' documents of the collection, or in
+ * every document if the collection is not larger than the sample, builds an equi-depth histogram
+ * of them and stores it in the '<db>.system.statistics.<collection>' collection, replacing any
+ * previous statistics for 'key'. The collection is read by a yielding executor, and the values
+ * read may use at most 'internalQueryAnalyzeMaxMemoryUsageBytes' of memory.
+ */
+class AnalyzeCmd final : public TypedCommand<AnalyzeCmd> {
+public:
+    using Request = Analyze;
+
+    AllowedOnSecondary secondaryAllowed(ServiceContext*) const override {
+        return AllowedOnSecondary::kNever;
+    }
+
+    bool adminOnly() const override {
+        return false;
+    }
+
+    std::string help() const override {
+        return "Builds a histogram of the values of a field and stores it for use by the "
+               "cost-based optimizer";
+    }
+
+    class Invocation final : public InvocationBase {
+    public:
+        using InvocationBase::InvocationBase;
+
+        void typedRun(OperationContext* opCtx) {
+            const auto& nss = request().getNamespace();
+            const std::string key = request().getKey().toString();
+            const FieldRef keyRef(key);
+            bool validKey = keyRef.numParts() > 0;
+            for (size_t i = 0; validKey && i < keyRef.numParts(); ++i) {
+                validKey = !keyRef.getPart(i).empty() && !keyRef.getPart(i).startsWith("$");
+            }
+            uassert(7131820, str::stream() << "Invalid key to analyze: '" << key << "'", validKey);
+
+            // Keep the values of every document, as owned BSON objects, so that they outlive the
+            // snapshot of the collection.
+            std::vector<BSONObj> documentValues;
+            long long numDocuments = 0;
+            long long memoryUsageBytes = 0;
+            const long long maxMemoryUsageBytes = internalQueryAnalyzeMaxMemoryUsageBytes.load();
+            {
+                AutoGetCollectionForReadCommand collection(
+                    opCtx, nss, AutoGetCollectionViewMode::kViewsPermitted);
+                uassert(ErrorCodes::CommandNotSupportedOnView,
+                        "Cannot analyze a view",
+                        !collection.getView());
+                uassert(ErrorCodes::NamespaceNotFound,
+                        str::stream() << "Collection " << nss << " does not exist",
+                        collection.getCollection());
+
+                const auto sampleSize = request().getSampleSize();
+                auto exec = makeSampleExecutor(opCtx, collection.getCollection(), sampleSize);
+                BSONObj doc;
+                while (numDocuments < sampleSize &&
+                       exec->getNext(&doc, nullptr) == PlanExecutor::ADVANCED) {
+                    ++numDocuments;
+
+                    BSONElementSet values;
+                    dotted_path_support::extractAllElementsAlongPath(doc, key, values);
+                    if (values.empty()) {
+                        continue;
+                    }
+                    BSONArrayBuilder valuesBuilder;
+                    for (auto&& value : values) {
+                        valuesBuilder.append(value);
+                    }
+                    auto valuesObj = valuesBuilder.obj();
+
+                    memoryUsageBytes += valuesObj.objsize();
+                    uassert(ErrorCodes::ExceededMemoryLimit,
+                            str::stream()
+                                << "The values of '" << key << "' exceeded the memory limit of "
+                                << maxMemoryUsageBytes << " bytes, use a smaller sampleSize",
+                            memoryUsageBytes <= maxMemoryUsageBytes);
+                    documentValues.push_back(std::move(valuesObj));
+                }
+            }
+
+            std::vector<BSONElement> elements;
+            for (auto&& values : documentValues) {
+                for (auto&& value : values) {
+                    elements.push_back(value);
+                }
+            }
+            const size_t numValues = elements.size();
+            ce::PathStatistics stats{static_cast<double>(numDocuments),
+                                     ce::Histogram::build(std::move(elements),
+                                                          request().getNumberBuckets())};
+
+            const auto statsNss = nss.makeStatisticsNamespace();
+            const auto statsDoc =
+                ce::CollectionStatistics::makeStatisticsDocument(key, stats, Date_t::now());
+            DBDirectClient client(opCtx);
+            write_ops::checkWriteErrors(client.update([&] {
+                write_ops::UpdateCommandRequest updateOp(statsNss);
+                write_ops::UpdateOpEntry updateEntry(
+                    BSON("_id" << key),
+                    write_ops::UpdateModification::parseFromClassicUpdate(statsDoc));
+                updateEntry.setMulti(false);
+                updateEntry.setUpsert(true);
+                updateOp.setUpdates({updateEntry});
+                return updateOp;
+            }()));
+
+            LOGV2(7131821,
+                  "Built statistics",
+                  "namespace"_attr = nss,
+                  "key"_attr = key,
+                  "numDocuments"_attr = numDocuments,
+                  "numValues"_attr = numValues,
+                  "numBuckets"_attr = stats.histogram.getBuckets().size());
+        }
+
+    private:
+        bool supportsWriteConcern() const override {
+            return true;
+        }
+
+        NamespaceString ns() const override {
+            return request().getNamespace();
+        }
+
+        void doCheckAuthorization(OperationContext* opCtx) const override {
+            // The statistics are upserted into the statistics collection of the analyzed
+            // collection. As a system collection, it is not covered by the privileges on the
+            // normal collections of the database.
+            auto authSession = AuthorizationSession::get(opCtx->getClient());
+            const auto& nss = request().getNamespace();
+            uassert(ErrorCodes::Unauthorized,
+                    "Unauthorized",
+                    authSession->isAuthorizedForActionsOnNamespace(nss, ActionType::find));
+            uassert(ErrorCodes::Unauthorized,
+                    "Unauthorized",
+                    authSession->isAuthorizedForActionsOnNamespace(
+                        nss.makeStatisticsNamespace(), {ActionType::insert, ActionType::update}));
+        }
+    };
+} analyzeCmd;
+
+}  // namespace
+}  // namespace mongo
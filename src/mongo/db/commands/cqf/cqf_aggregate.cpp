@@ -27,12 +27,16 @@
  *    it in the license file.
  */
 
+#define MONGO_LOGV2_DEFAULT_COMPONENT ::mongo::logv2::LogComponent::kQuery
+
 #include "mongo/db/commands/cqf/cqf_aggregate.h"
 
 #include "mongo/db/exec/sbe/abt/abt_lower.h"
 #include "mongo/db/pipeline/abt/abt_document_source_visitor.h"
 #include "mongo/db/pipeline/abt/match_expression_visitor.h"
+#include "mongo/db/query/ce/ce_histogram.h"
 #include "mongo/db/query/ce/ce_sampling.h"
+#include "mongo/db/query/ce/collection_statistics_cache.h"
 #include "mongo/db/query/optimizer/cascades/ce_heuristic.h"
 #include "mongo/db/query/optimizer/cascades/cost_derivation.h"
 #include "mongo/db/query/optimizer/explain.h"
@@ -43,6 +47,7 @@
 #include "mongo/db/query/query_planner_params.h"
 #include "mongo/db/query/sbe_stage_builder.h"
 #include "mongo/db/query/yield_policy_callbacks_impl.h"
+#include "mongo/logv2/log.h"
 
 namespace mongo {
 
@@ -186,6 +191,8 @@ static QueryHints getHintsFromQueryKnobs() {
         internalCascadesOptimizerDisableMergeJoinRIDIntersect.load();
     hints._disableGroupByAndUnionRIDIntersect =
         internalCascadesOptimizerDisableGroupByAndUnionRIDIntersect.load();
+    hints._disableHashJoin = internalCascadesOptimizerDisableHashJoin.load();
+    hints._disableMergeJoin = internalCascadesOptimizerDisableMergeJoin.load();
     hints._keepRejectedPlans = internalCascadesOptimizerKeepRejectedPlans.load();
     hints._disableBranchAndBound = internalCascadesOptimizerDisableBranchAndBound.load();
 
@@ -324,6 +331,36 @@ static void populateAdditionalScanDefs(OperationContext* opCtx,
     }
 }
 
+/**
+ * Reads the statistics built by the 'analyze' command for the collection 'nss' from its statistics
+ * collection 'statsNss'. Documents of the statistics collection which cannot be parsed are skipped.
+ */
+static ce::CollectionStatistics loadCollectionStatistics(OperationContext* opCtx,
+                                                         const NamespaceString& nss,
+                                                         const NamespaceString& statsNss) {
+    ce::CollectionStatistics result;
+
+    AutoGetCollectionForReadCommandMaybeLockFree ctx(
+        opCtx, statsNss, AutoGetCollectionViewMode::kViewsForbidden);
+    const CollectionPtr& statsCollection = ctx ? ctx.getCollection() : CollectionPtr::null;
+    if (!statsCollection) {
+        return result;
+    }
+
+    auto cursor = statsCollection->getCursor(opCtx);
+    while (auto record = cursor->next()) {
+        const Status status = result.addStatisticsDocument(record->data.toBson());
+        if (!status.isOK()) {
+            LOGV2_WARNING(7131812,
+                          "Skipping invalid statistics document",
+                          "namespace"_attr = nss,
+                          "recordId"_attr = record->id,
+                          "error"_attr = status);
+        }
+    }
+    return result;
+}
+
 std::unique_ptr<PlanExecutor, PlanExecutor::Deleter> getSBEExecutorViaCascadesOptimizer(
     OperationContext* opCtx,
     boost::intrusive_ptr<ExpressionContext> expCtx,
@@ -387,6 +424,28 @@ std::unique_ptr<PlanExecutor, PlanExecutor::Deleter> getSBEExecutorViaCascadesOp
     std::cerr << ExplainGenerator::explainV2(abtTree) << std::endl;
     std::cerr << "******* Translated ABT **********\n";
 
+    if (collectionExists && numRecords > 0 &&
+        internalQueryEnableHistogramCardinalityEstimator.load()) {
+        const auto statsNss = nss.makeStatisticsNamespace();
+        auto stats = ce::CollectionStatisticsCache::get(opCtx->getServiceContext())
+                         .getOrLoad(statsNss,
+                                    [&] { return loadCollectionStatistics(opCtx, nss, statsNss); });
+        if (!stats->empty()) {
+            OptPhaseManager phaseManager{
+                OptPhaseManager::getAllRewritesSet(),
+                prefixId,
+                false /*requireRID*/,
+                std::move(metadata),
+                std::make_unique<CEHistogramTransport>(scanDefName, std::move(stats)),
+                std::make_unique<DefaultCosting>(),
+                DebugInfo::kDefaultForProd};
+            phaseManager.getHints() = queryHints;
+
+            return optimizeAndCreateExecutor(
+                phaseManager, std::move(abtTree), opCtx, expCtx, nss, collection);
+        }
+    }
+
     if (collectionExists && numRecords > 0 &&
         internalQueryEnableSamplingCardinalityEstimator.load()) {
         Metadata metadataForSampling = metadata;
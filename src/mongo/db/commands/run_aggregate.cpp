@@ -51,6 +51,7 @@
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/pipeline/accumulator.h"
 #include "mongo/db/pipeline/aggregation_request_helper.h"
+#include "mongo/db/pipeline/aggregation_result_cache.h"
 #include "mongo/db/pipeline/change_stream_invalidation_info.h"
 #include "mongo/db/pipeline/document_source.h"
 #include "mongo/db/pipeline/document_source_exchange.h"
@@ -123,7 +124,8 @@ bool canOptimizeAwayPipeline(const Pipeline* pipeline,
  * Returns true if we need to keep a ClientCursor saved for this pipeline (for future getMore
  * requests). Otherwise, returns false. The passed 'nsForCursor' is only used to determine the
  * namespace used in the returned cursor, which will be registered with the global cursor manager,
- * and thus will be different from that in 'request'.
+ * and thus will be different from that in 'request'. If 'firstBatch' is given, the documents
+ * returned in the first batch are appended to it.
  */
 bool handleCursorCommand(OperationContext* opCtx,
                          boost::intrusive_ptr<ExpressionContext> expCtx,
@@ -131,7 +133,8 @@ bool handleCursorCommand(OperationContext* opCtx,
                          std::vector<ClientCursor*> cursors,
                          const AggregateCommandRequest& request,
                          const BSONObj& cmdObj,
-                         rpc::ReplyBuilderInterface* result) {
+                         rpc::ReplyBuilderInterface* result,
+                         std::vector<BSONObj>* firstBatch = nullptr) {
     invariant(!cursors.empty());
     long long batchSize =
         request.getCursor().getBatchSize().value_or(aggregation_request_helper::kDefaultBatchSize);
@@ -255,6 +258,9 @@ bool handleCursorCommand(OperationContext* opCtx,
         responseBuilder.setPostBatchResumeToken(exec->getPostBatchResumeToken());
         responseBuilder.append(nextDoc);
         docUnitsReturned.observeOne(nextDoc.objsize());
+        if (firstBatch) {
+            firstBatch->push_back(nextDoc.getOwned());
+        }
     }
 
     if (cursor) {
@@ -288,6 +294,39 @@ bool handleCursorCommand(OperationContext* opCtx,
     return static_cast<bool>(cursor);
 }
 
+/**
+ * Replies to the aggregation with 'results' cached by an identical earlier aggregation, on a cursor
+ * which is already exhausted. Returns false, without replying, if 'results' do not fit in the first
+ * batch requested.
+ */
+bool handleCachedResults(OperationContext* opCtx,
+                         const NamespaceString& nsForCursor,
+                         const std::vector<BSONObj>& results,
+                         const AggregateCommandRequest& request,
+                         rpc::ReplyBuilderInterface* result) {
+    const auto batchSize =
+        request.getCursor().getBatchSize().value_or(aggregation_request_helper::kDefaultBatchSize);
+    if (static_cast<long long>(results.size()) > batchSize) {
+        return false;
+    }
+
+    CursorResponseBuilder::Options options;
+    options.isInitialResponse = true;
+    CursorResponseBuilder responseBuilder(result, options);
+    ResourceConsumption::DocumentUnitCounter docUnitsReturned;
+    for (auto&& doc : results) {
+        responseBuilder.append(doc);
+        docUnitsReturned.observeOne(doc.objsize());
+    }
+    responseBuilder.done(0LL, nsForCursor.ns());
+
+    auto curOp = CurOp::get(opCtx);
+    curOp->debug().cursorExhausted = true;
+    curOp->debug().nreturned = results.size();
+    ResourceConsumption::MetricsCollector::get(opCtx).incrementDocUnitsReturned(docUnitsReturned);
+    return true;
+}
+
 StatusWith<StringMap<ExpressionContext::ResolvedNamespace>> resolveInvolvedNamespaces(
     OperationContext* opCtx, const AggregateCommandRequest& request) {
     const LiteParsedPipeline liteParsedPipeline(request);
@@ -663,6 +702,16 @@ Status runAggregate(OperationContext* opCtx,
     // aggregation command.
     performValidationChecks(opCtx, request, liteParsedPipeline);
 
+    // If the results of this aggregation may be cached, capture the write generations of all
+    // collections before opening a storage snapshot. A write which commits while the aggregation
+    // runs then prevents its results from being cached.
+    boost::optional<AggregationResultCache::Generations> resultCacheGenerations;
+    if (AggregationResultCache::isEnabled()) {
+        resultCacheGenerations =
+            AggregationResultCache::get(opCtx->getServiceContext()).getGenerations();
+    }
+    boost::optional<AggregationResultCache::Key> resultCacheKey;
+
     // For operations on views, this will be the underlying namespace.
     NamespaceString nss = request.getNamespace();
 
@@ -918,6 +967,24 @@ Status runAggregate(OperationContext* opCtx,
         constexpr bool alreadyOptimized = true;
         pipeline->validateCommon(alreadyOptimized);
 
+        // Answer the aggregation from the result cache if an identical aggregation has already run
+        // over the current contents of the collections it reads.
+        if (resultCacheGenerations && uuid) {
+            resultCacheKey = AggregationResultCache::makeKey(
+                opCtx, origNss, request, liteParsedPipeline, *pipeline, *uuid);
+        }
+        if (resultCacheKey) {
+            auto results = AggregationResultCache::get(opCtx->getServiceContext())
+                               .lookup(*resultCacheKey,
+                                       opCtx->getServiceContext()->getFastClockSource()->now());
+            if (results && handleCachedResults(opCtx, origNss, *results, request, result)) {
+                liteParsedPipeline.tickGlobalStageCounters();
+                stdx::lock_guard<Client> lk(*opCtx->getClient());
+                curOp->setNS_inlock(origNss.ns());
+                return Status::OK();
+            }
+        }
+
         if (feature_flags::gfeatureFlagCommonQueryFramework.isEnabled(
                 serverGlobalParams.featureCompatibility) &&
             internalQueryEnableCascadesOptimizer.load()) {
@@ -1009,10 +1076,24 @@ Status runAggregate(OperationContext* opCtx,
         }
     } else {
         // Cursor must be specified, if explain is not.
-        const bool keepCursor = handleCursorCommand(
-            opCtx, expCtx, origNss, std::move(cursors), request, cmdObj, result);
+        std::vector<BSONObj> firstBatch;
+        const bool keepCursor = handleCursorCommand(opCtx,
+                                                    expCtx,
+                                                    origNss,
+                                                    std::move(cursors),
+                                                    request,
+                                                    cmdObj,
+                                                    result,
+                                                    resultCacheKey ? &firstBatch : nullptr);
         if (keepCursor) {
             cursorFreer.dismiss();
+        } else if (resultCacheKey) {
+            // All of the results were returned in the first batch, so they can be cached.
+            AggregationResultCache::get(opCtx->getServiceContext())
+                .insert(*resultCacheKey,
+                        std::move(firstBatch),
+                        *resultCacheGenerations,
+                        opCtx->getServiceContext()->getFastClockSource()->now());
         }
 
         PlanSummaryStats stats;
@@ -42,6 +42,7 @@
 #include "mongo/db/exec/scoped_timer.h"
 #include "mongo/db/exec/working_set.h"
 #include "mongo/db/exec/working_set_common.h"
+#include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/db/record_id_helpers.h"
 #include "mongo/db/repl/optime.h"
 #include "mongo/logv2/log.h"
@@ -57,6 +58,16 @@ const char* getStageName(const CollectionPtr& coll, const CollectionScanParams&
     return (!coll->ns().isOplog() && (params.minRecord || params.maxRecord)) ? "CLUSTERED_IXSCAN"
                                                                              : "COLLSCAN";
 }
+
+/**
+ * Only plain scans of uncapped collections read in batches. Tailable and oplog scans depend on the
+ * position of every record they return, and bounded scans should not read far past their bounds.
+ */
+bool shouldReadInBatches(const CollectionPtr& coll, const CollectionScanParams& params) {
+    return !params.tailable && !params.shouldTrackLatestOplogTimestamp &&
+        !params.assertTsHasNotFallenOffOplog && !params.minRecord && !params.maxRecord &&
+        !coll->isCapped() && internalQueryExecMaxScanBatchSize.load() > 1;
+}
 }  // namespace
 
 
@@ -70,7 +81,8 @@ CollectionScan::CollectionScan(ExpressionContext* expCtx,
           getStageName(collection, params), expCtx, collection, relaxCappedConstraints),
       _workingSet(workingSet),
       _filter((filter && !filter->isTriviallyTrue()) ? filter : nullptr),
-      _params(params) {
+      _params(params),
+      _readsInBatches(shouldReadInBatches(collection, params)) {
     // Explain reports the direction of the collection scan.
     _specificStats.direction = params.direction;
     _specificStats.minRecord = params.minRecord;
@@ -160,6 +172,9 @@ PlanStage::StageState CollectionScan::doWork(WorkingSetID* out) {
             }
 
             _cursor = collection()->getCursor(opCtx(), forward);
+            if (forward && !_params.tailable && !_params.minRecord && !_params.maxRecord) {
+                _cursor->enableReadAhead();
+            }
 
             if (!_lastSeenId.isNull()) {
                 invariant(_params.tailable);
@@ -213,7 +228,7 @@ PlanStage::StageState CollectionScan::doWork(WorkingSetID* out) {
         }
 
         if (!record) {
-            record = _cursor->next();
+            record = _readsInBatches ? nextFromBatch() : _cursor->next();
         }
     } catch (const WriteConflictException&) {
         // Leave us in a state to try again next time.
@@ -245,12 +260,28 @@ PlanStage::StageState CollectionScan::doWork(WorkingSetID* out) {
     WorkingSetID id = _workingSet->allocate();
     WorkingSetMember* member = _workingSet->get(id);
     member->recordId = std::move(record->id);
-    member->resetDocument(opCtx()->recoveryUnit()->getSnapshotId(), record->data.releaseToBson());
+    member->resetDocument(
+        _readsInBatches ? _batchSnapshotId : opCtx()->recoveryUnit()->getSnapshotId(),
+        record->data.releaseToBson());
     _workingSet->transitionToRecordIdAndObj(id);
 
     return returnIfMatches(member, id, out);
 }
 
+boost::optional<Record> CollectionScan::nextFromBatch() {
+    if (_batchPos == _batch.size()) {
+        _batch.clear();
+        _batchPos = 0;
+        _batchSnapshotId = opCtx()->recoveryUnit()->getSnapshotId();
+        if (!_cursor->nextBatch(&_batch, _batchSize)) {
+            return boost::none;
+        }
+        _batchSize = std::min(_batchSize * 2,
+                              static_cast<size_t>(internalQueryExecMaxScanBatchSize.load()));
+    }
+    return std::move(_batch[_batchPos++]);
+}
+
 void CollectionScan::setLatestOplogEntryTimestamp(const Record& record) {
     auto tsElem = record.data.toBson()[repl::OpTime::kTimestampFieldName];
     uassert(ErrorCodes::Error(4382100),
@@ -381,6 +412,11 @@ bool CollectionScan::isEOF() {
 }
 
 void CollectionScan::doSaveStateRequiresCollection() {
+    // The records that have been read ahead must outlive the position of the cursor.
+    for (auto it = _batch.begin() + _batchPos; it != _batch.end(); ++it) {
+        it->data.makeOwned();
+    }
+
     if (_cursor) {
         _cursor->save();
     }
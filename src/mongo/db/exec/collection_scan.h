@@ -35,6 +35,7 @@
 #include "mongo/db/exec/requires_collection_stage.h"
 #include "mongo/db/matcher/expression_leaf.h"
 #include "mongo/db/record_id.h"
+#include "mongo/db/storage/snapshot.h"
 #include "mongo/s/resharding/resume_token_gen.h"
 
 namespace mongo {
@@ -122,6 +123,12 @@ private:
      */
     void assertTsHasNotFallenOffOplog(const Record& record);
 
+    /**
+     * Returns the next record of '_batch', reading another batch from '_cursor' once every record
+     * of the current one has been returned. Returns boost::none at EOF.
+     */
+    boost::optional<Record> nextFromBatch();
+
     // WorkingSet is not owned by us.
     WorkingSet* _workingSet;
 
@@ -134,6 +141,15 @@ private:
 
     RecordId _lastSeenId;  // Null if nothing has been returned from _cursor yet.
 
+    // Plain scans read their records from '_cursor' in batches, which start with a single record
+    // and double up to 'internalQueryExecMaxScanBatchSize'. '_batchPos' is the position of the next
+    // record of '_batch' to return, and '_batchSnapshotId' the snapshot the batch was read from.
+    const bool _readsInBatches;
+    std::vector<Record> _batch;
+    size_t _batchPos = 0;
+    size_t _batchSize = 1;
+    SnapshotId _batchSnapshotId;
+
     // If _params.shouldTrackLatestOplogTimestamp is set and the collection is the oplog, the latest
     // timestamp seen in the collection.  Otherwise, this is a null timestamp.
     Timestamp _latestOplogEntryTimestamp;
@@ -42,6 +42,7 @@
 #include "mongo/db/index/index_access_method.h"
 #include "mongo/db/index_names.h"
 #include "mongo/db/query/index_bounds_builder.h"
+#include "mongo/db/query/query_knobs_gen.h"
 
 namespace {
 
@@ -73,6 +74,7 @@ IndexScan::IndexScan(ExpressionContext* expCtx,
       _forward(params.direction == 1),
       _shouldDedup(params.shouldDedup),
       _addKeyMetadata(params.addKeyMetadata),
+      _readsInBatches(internalQueryExecMaxScanBatchSize.load() > 1),
       _startKeyInclusive(IndexBounds::isStartIncludedInBound(params.bounds.boundInclusion)),
       _endKeyInclusive(IndexBounds::isEndIncludedInBound(params.bounds.boundInclusion)) {
     _specificStats.indexName = params.name;
@@ -140,13 +142,21 @@ boost::optional<IndexKeyEntry> IndexScan::initIndexScan() {
 PlanStage::StageState IndexScan::doWork(WorkingSetID* out) {
     // Get the next kv pair from the index, if any.
     boost::optional<IndexKeyEntry> kv;
+    bool fromBatch = false;
     try {
         switch (_scanState) {
             case INITIALIZING:
                 kv = initIndexScan();
                 break;
             case GETTING_NEXT:
-                kv = _indexCursor->next();
+                // Scans checking their keys against multiple intervals may need to seek after any
+                // key, so only single interval scans read ahead.
+                if (_readsInBatches && !_checker) {
+                    kv = nextFromBatch();
+                    fromBatch = true;
+                } else {
+                    kv = _indexCursor->next();
+                }
                 break;
             case NEED_SEEK:
                 ++_specificStats.seeks;
@@ -232,7 +242,10 @@ PlanStage::StageState IndexScan::doWork(WorkingSetID* out) {
     WorkingSetMember* member = _workingSet->get(id);
     member->recordId = kv->loc;
     member->keyData.push_back(IndexKeyDatum(
-        _keyPattern, kv->key, workingSetIndexId(), opCtx()->recoveryUnit()->getSnapshotId()));
+        _keyPattern,
+        kv->key,
+        workingSetIndexId(),
+        fromBatch ? _batchSnapshotId : opCtx()->recoveryUnit()->getSnapshotId()));
     _workingSet->transitionToRecordIdAndIdx(id);
 
     if (_addKeyMetadata) {
@@ -243,6 +256,20 @@ PlanStage::StageState IndexScan::doWork(WorkingSetID* out) {
     return PlanStage::ADVANCED;
 }
 
+boost::optional<IndexKeyEntry> IndexScan::nextFromBatch() {
+    if (_batchPos == _batch.size()) {
+        _batch.clear();
+        _batchPos = 0;
+        _batchSnapshotId = opCtx()->recoveryUnit()->getSnapshotId();
+        if (!_indexCursor->nextBatch(&_batch, _batchSize)) {
+            return boost::none;
+        }
+        _batchSize = std::min(_batchSize * 2,
+                              static_cast<size_t>(internalQueryExecMaxScanBatchSize.load()));
+    }
+    return std::move(_batch[_batchPos++]);
+}
+
 bool IndexScan::isEOF() {
     return _commonStats.isEOF;
 }
@@ -36,6 +36,7 @@
 #include "mongo/db/query/index_bounds.h"
 #include "mongo/db/record_id.h"
 #include "mongo/db/storage/index_entry_comparison.h"
+#include "mongo/db/storage/snapshot.h"
 #include "mongo/db/storage/sorted_data_interface.h"
 #include "mongo/stdx/unordered_set.h"
 
@@ -142,6 +143,12 @@ private:
      */
     boost::optional<IndexKeyEntry> initIndexScan();
 
+    /**
+     * Returns the next key of '_batch', reading another batch from '_indexCursor' once every key
+     * of the current one has been returned. Returns boost::none at the end of the scan.
+     */
+    boost::optional<IndexKeyEntry> nextFromBatch();
+
     // The WorkingSet we fill with results.  Not owned by us.
     WorkingSet* const _workingSet;
 
@@ -163,6 +170,15 @@ private:
     // Do we want to add the key as metadata?
     const bool _addKeyMetadata;
 
+    // Scans of a single interval read their keys from '_indexCursor' in batches, which start with a
+    // single key and double up to 'internalQueryExecMaxScanBatchSize'. '_batchPos' is the position
+    // of the next key of '_batch' to return, and '_batchSnapshotId' the snapshot it was read from.
+    const bool _readsInBatches;
+    std::vector<IndexKeyEntry> _batch;
+    size_t _batchPos = 0;
+    size_t _batchSize = 1;
+    SnapshotId _batchSnapshotId;
+
     // Stats
     IndexScanStats _specificStats;
 
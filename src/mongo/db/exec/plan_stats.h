@@ -1034,6 +1034,10 @@ struct GroupStats : public SpecificStats {
 
     // The number of times that we spilled data to disk while grouping the data.
     uint64_t spills = 0u;
+
+    // The number of threads among which the groups were partitioned, or 0 if they were built on a
+    // single thread.
+    uint64_t parallelPartitions = 0u;
 };
 
 struct DocumentSourceCursorStats : public SpecificStats {
@@ -419,6 +419,8 @@ static stdx::unordered_map<std::string, BuiltinFn> kBuiltinFunctions = {
      BuiltinFn{[](size_t n) { return n > 0; }, vm::Builtin::doubleDoubleSum, false}},
     {"aggDoubleDoubleSum",
      BuiltinFn{[](size_t n) { return n == 1; }, vm::Builtin::aggDoubleDoubleSum, true}},
+    {"aggMergeDoubleDoubleSums",
+     BuiltinFn{[](size_t n) { return n == 1; }, vm::Builtin::aggMergeDoubleDoubleSums, true}},
     {"doubleDoubleSumFinalize",
      BuiltinFn{[](size_t n) { return n > 0; }, vm::Builtin::doubleDoubleSumFinalize, false}},
     {"doubleDoubleMergeSumFinalize",
@@ -502,6 +504,54 @@ static stdx::unordered_map<std::string, BuiltinFn> kBuiltinFunctions = {
     {"tsSecond", BuiltinFn{[](size_t n) { return n == 1; }, vm::Builtin::tsSecond, false}},
     {"tsIncrement", BuiltinFn{[](size_t n) { return n == 1; }, vm::Builtin::tsIncrement, false}},
     {"typeMatch", BuiltinFn{[](size_t n) { return n == 2; }, vm::Builtin::typeMatch, false}},
+    {"valueBlockFillEmpty",
+     BuiltinFn{[](size_t n) { return n == 2; }, vm::Builtin::valueBlockFillEmpty, false}},
+    {"valueBlockIsNumber",
+     BuiltinFn{[](size_t n) { return n == 1; }, vm::Builtin::valueBlockIsNumber, false}},
+    {"valueBlockGtScalar",
+     BuiltinFn{[](size_t n) { return n == 2; }, vm::Builtin::valueBlockGtScalar, false}},
+    {"valueBlockGteScalar",
+     BuiltinFn{[](size_t n) { return n == 2; }, vm::Builtin::valueBlockGteScalar, false}},
+    {"valueBlockLtScalar",
+     BuiltinFn{[](size_t n) { return n == 2; }, vm::Builtin::valueBlockLtScalar, false}},
+    {"valueBlockLteScalar",
+     BuiltinFn{[](size_t n) { return n == 2; }, vm::Builtin::valueBlockLteScalar, false}},
+    {"valueBlockEqScalar",
+     BuiltinFn{[](size_t n) { return n == 2; }, vm::Builtin::valueBlockEqScalar, false}},
+    {"valueBlockNeqScalar",
+     BuiltinFn{[](size_t n) { return n == 2; }, vm::Builtin::valueBlockNeqScalar, false}},
+    {"valueBlockMatchGtScalar",
+     BuiltinFn{[](size_t n) { return n == 2; }, vm::Builtin::valueBlockMatchGtScalar, false}},
+    {"valueBlockMatchGteScalar",
+     BuiltinFn{[](size_t n) { return n == 2; }, vm::Builtin::valueBlockMatchGteScalar, false}},
+    {"valueBlockMatchLtScalar",
+     BuiltinFn{[](size_t n) { return n == 2; }, vm::Builtin::valueBlockMatchLtScalar, false}},
+    {"valueBlockMatchLteScalar",
+     BuiltinFn{[](size_t n) { return n == 2; }, vm::Builtin::valueBlockMatchLteScalar, false}},
+    {"valueBlockMatchEqScalar",
+     BuiltinFn{[](size_t n) { return n == 2; }, vm::Builtin::valueBlockMatchEqScalar, false}},
+    {"valueBlockAdd",
+     BuiltinFn{[](size_t n) { return n == 2; }, vm::Builtin::valueBlockAdd, false}},
+    {"valueBlockSub",
+     BuiltinFn{[](size_t n) { return n == 2; }, vm::Builtin::valueBlockSub, false}},
+    {"valueBlockMult",
+     BuiltinFn{[](size_t n) { return n == 2; }, vm::Builtin::valueBlockMult, false}},
+    {"valueBlockLogicalAnd",
+     BuiltinFn{[](size_t n) { return n == 2; }, vm::Builtin::valueBlockLogicalAnd, false}},
+    {"valueBlockLogicalOr",
+     BuiltinFn{[](size_t n) { return n == 2; }, vm::Builtin::valueBlockLogicalOr, false}},
+    {"valueBlockCount",
+     BuiltinFn{[](size_t n) { return n == 2; }, vm::Builtin::valueBlockCount, false}},
+    {"valueBlockSum",
+     BuiltinFn{[](size_t n) { return n == 2; }, vm::Builtin::valueBlockSum, false}},
+    {"valueBlockAggDoubleDoubleSum",
+     BuiltinFn{[](size_t n) { return n == 2 || n == 3; },
+               vm::Builtin::valueBlockAggDoubleDoubleSum,
+               false}},
+    {"valueBlockMin",
+     BuiltinFn{[](size_t n) { return n == 2; }, vm::Builtin::valueBlockMin, false}},
+    {"valueBlockMax",
+     BuiltinFn{[](size_t n) { return n == 2; }, vm::Builtin::valueBlockMax, false}},
 };
 
 /**
@@ -0,0 +1,179 @@
+/**
+ *    Copyright (C) 2022-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/db/exec/sbe/expression_test_base.h"
+#include "mongo/idl/server_parameter_test_util.h"
+
+namespace mongo::sbe {
+namespace {
+#if defined(__x86_64__) && defined(__linux__)
+constexpr bool kHaveNativeCode = true;
+#else
+constexpr bool kHaveNativeCode = false;
+#endif
+
+class SBENativeCodeTest : public EExpressionTestFixture {
+protected:
+    /**
+     * Builds the predicate 'getField(input, "a") > 5 && exists(getField(input, "b"))', which uses
+     * constants, field accesses, comparisons, builtins and conditional jumps.
+     */
+    std::unique_ptr<EExpression> makePredicate(value::SlotId inputSlot) {
+        auto getField = [&](StringData field) {
+            return makeE<EFunction>(
+                "getField", makeEs(makeE<EVariable>(inputSlot), makeE<EConstant>(field)));
+        };
+        auto [fiveTag, fiveVal] = makeInt32(5);
+        return makeE<EPrimBinary>(
+            EPrimBinary::logicAnd,
+            makeE<EPrimBinary>(
+                EPrimBinary::greater, getField("a"), makeE<EConstant>(fiveTag, fiveVal)),
+            makeE<EFunction>("exists", makeEs(getField("b"))));
+    }
+
+    bool runPredicate(const vm::CodeFragment* code, const BSONObj& input) {
+        _inputAccessor.reset(value::TypeTags::bsonObject,
+                             value::bitcastFrom<const char*>(input.objdata()));
+        return runCompiledExpressionPredicate(code);
+    }
+
+    value::ViewOfValueAccessor _inputAccessor;
+};
+
+TEST_F(SBENativeCodeTest, CompilesHotPredicate) {
+    RAIIServerParameterControllerForTest threshold{
+        "internalQuerySlotBasedExecutionNativeCodeThreshold", 3};
+    auto inputSlot = bindAccessor(&_inputAccessor);
+    auto code = compileExpression(*makePredicate(inputSlot));
+
+    std::vector<std::pair<BSONObj, bool>> inputs{{BSON("a" << 6 << "b" << 1), true},
+                                                 {BSON("a" << 5 << "b" << 1), false},
+                                                 {BSON("a" << 7), false},
+                                                 {BSON("a" << 7.5 << "b" << BSONNULL), true},
+                                                 {BSON("b" << 1), false},
+                                                 {BSON("a"
+                                                       << "str"
+                                                       << "b" << 1),
+                                                  false}};
+    // The first two runs are interpreted and the following ones run the native code, which must
+    // return the same results.
+    for (size_t round = 0; round < 3; ++round) {
+        for (auto& [input, expected] : inputs) {
+            ASSERT_EQ(runPredicate(code.get(), input), expected) << input;
+        }
+    }
+    ASSERT_EQ(code->getNativeCode() != nullptr, kHaveNativeCode);
+}
+
+TEST_F(SBENativeCodeTest, RunsLambdasInTheInterpreter) {
+    RAIIServerParameterControllerForTest threshold{
+        "internalQuerySlotBasedExecutionNativeCodeThreshold", 1};
+    value::ViewOfValueAccessor arrayAccessor;
+    auto arraySlot = bindAccessor(&arrayAccessor);
+    FrameId frame = 10;
+    auto [oneTag, oneVal] = makeInt32(1);
+    auto expr = makeE<EFunction>(
+        "traverseP",
+        makeEs(makeE<EVariable>(arraySlot),
+               makeE<ELocalLambda>(frame,
+                                   makeE<EPrimBinary>(EPrimBinary::add,
+                                                      makeE<EVariable>(frame, 0),
+                                                      makeE<EConstant>(oneTag, oneVal)))));
+    auto code = compileExpression(*expr);
+
+    auto input = BSON_ARRAY(1 << 2 << 3);
+    auto expected = BSON_ARRAY(2 << 3 << 4);
+    auto expectedVal = value::bitcastFrom<const char*>(expected.objdata());
+    for (size_t round = 0; round < 2; ++round) {
+        arrayAccessor.reset(value::TypeTags::bsonArray,
+                            value::bitcastFrom<const char*>(input.objdata()));
+        auto [tag, val] = runCompiledExpression(code.get());
+        value::ValueGuard guard(tag, val);
+
+        auto [cmpTag, cmpVal] =
+            value::compareValue(tag, val, value::TypeTags::bsonArray, expectedVal);
+        ASSERT_EQ(cmpTag, value::TypeTags::NumberInt32);
+        ASSERT_EQ(value::bitcastTo<int32_t>(cmpVal), 0);
+    }
+    ASSERT_EQ(code->getNativeCode() != nullptr, kHaveNativeCode);
+}
+
+TEST_F(SBENativeCodeTest, RethrowsErrorsOfTheNativeCode) {
+    RAIIServerParameterControllerForTest threshold{
+        "internalQuerySlotBasedExecutionNativeCodeThreshold", 1};
+    auto inputSlot = bindAccessor(&_inputAccessor);
+    auto [trueTag, trueVal] = makeBool(true);
+    auto expr = makeE<EIf>(makePredicate(inputSlot),
+                           makeE<EFail>(ErrorCodes::Error{7132222}, "failed"),
+                           makeE<EConstant>(trueTag, trueVal));
+    auto code = compileExpression(*expr);
+
+    for (size_t round = 0; round < 2; ++round) {
+        ASSERT_THROWS_CODE(
+            runPredicate(code.get(), BSON("a" << 6 << "b" << 1)), DBException, 7132222);
+        // The stack is left empty after an error, so that the next evaluation succeeds.
+        ASSERT_TRUE(runPredicate(code.get(), BSON("a" << 1)));
+    }
+    ASSERT_EQ(code->getNativeCode() != nullptr, kHaveNativeCode);
+}
+
+TEST_F(SBENativeCodeTest, InterpretsUnsupportedInstructions) {
+    RAIIServerParameterControllerForTest threshold{
+        "internalQuerySlotBasedExecutionNativeCodeThreshold", 1};
+    value::ViewOfValueAccessor numberAccessor;
+    auto numberSlot = bindAccessor(&numberAccessor);
+    auto code = compileExpression(
+        *makeE<ENumericConvert>(makeE<EVariable>(numberSlot), value::TypeTags::NumberInt64));
+    ASSERT(!vm::NativeCode::compile(*code));
+
+    for (int32_t number = 0; number < 3; ++number) {
+        auto [inputTag, inputVal] = makeInt32(number);
+        numberAccessor.reset(inputTag, inputVal);
+        auto [tag, val] = runCompiledExpression(code.get());
+        ASSERT_EQ(tag, value::TypeTags::NumberInt64);
+        ASSERT_EQ(value::bitcastTo<int64_t>(val), number);
+    }
+    ASSERT(!code->getNativeCode());
+}
+
+TEST_F(SBENativeCodeTest, CanBeDisabled) {
+    RAIIServerParameterControllerForTest enabled{"internalQuerySlotBasedExecutionEnableNativeCode",
+                                                 false};
+    RAIIServerParameterControllerForTest threshold{
+        "internalQuerySlotBasedExecutionNativeCodeThreshold", 1};
+    auto inputSlot = bindAccessor(&_inputAccessor);
+    auto code = compileExpression(*makePredicate(inputSlot));
+
+    for (size_t round = 0; round < 2; ++round) {
+        ASSERT_TRUE(runPredicate(code.get(), BSON("a" << 6 << "b" << 1)));
+    }
+    ASSERT(!code->getNativeCode());
+}
+}  // namespace
+}  // namespace mongo::sbe
@@ -1091,6 +1091,9 @@ void Parser::walkColumnScan(AstQuery& ast) {
                                        std::move(evalPathExpr),
                                        std::move(pathExprs),
                                        rowStoreSlot,
+                                       std::vector<ColumnScanStage::PathFilter>{},
+                                       *lookupSlot(rowStoreInput + "cell"),
+                                       nullptr,
                                        nullptr,
                                        getCurrentPlanNodeId());
 }
@@ -1138,7 +1141,7 @@ void Parser::walkSort(AstQuery& ast) {
                                  lookupSlots(ast.nodes[2]->identifiers),
                                  limit,
                                  std::numeric_limits<std::size_t>::max(),
-                                 true /* allowDiskUse */,
+                                 _allowDiskUse,
                                  getCurrentPlanNodeId());
 }
 
@@ -1309,7 +1312,7 @@ void Parser::walkGroup(AstQuery& ast) {
         true,
         collatorSlotPos ? lookupSlot(std::move(ast.nodes[collatorSlotPos]->identifier))
                         : boost::none,
-        true,  // allowDiskUse
+        _allowDiskUse,
         getCurrentPlanNodeId());
 }
 
@@ -1333,6 +1336,7 @@ void Parser::walkHashJoin(AstQuery& ast) {
                              lookupSlots(innerNode->nodes[0]->identifiers),  // inner conditions
                              lookupSlots(innerNode->nodes[1]->identifiers),  // inner projections
                              collatorSlot,                                   // collator
+                             _allowDiskUse,                                  // allowDiskUse
                              getCurrentPlanNodeId());
 }
 
@@ -2035,11 +2039,13 @@ Parser::Parser(RuntimeEnvironment* env) : _env(env) {
 
 std::unique_ptr<PlanStage> Parser::parse(OperationContext* opCtx,
                                          StringData defaultDb,
-                                         StringData line) {
+                                         StringData line,
+                                         bool allowDiskUse) {
     std::shared_ptr<AstQuery> ast;
 
     _opCtx = opCtx;
     _defaultDb = defaultDb.toString();
+    _allowDiskUse = allowDiskUse;
 
     auto result = _parser.parse_n(line.rawData(), line.size(), ast);
     uassert(4885904, str::stream() << "Syntax error in query: " << line, result);
@@ -64,9 +64,14 @@ using AstQuery = peg::AstBase<ParsedQueryTree>;
 class Parser {
 public:
     Parser(RuntimeEnvironment* env);
+    /**
+     * Parses the plan in 'line'. The stages which can spill to disk, such as sort, group and hash
+     * join, are only allowed to if 'allowDiskUse' is true.
+     */
     std::unique_ptr<PlanStage> parse(OperationContext* opCtx,
                                      StringData defaultDb,
-                                     StringData line);
+                                     StringData line,
+                                     bool allowDiskUse);
 
     std::pair<boost::optional<value::SlotId>, boost::optional<value::SlotId>> getTopLevelSlots()
         const {
@@ -79,6 +84,7 @@ private:
     peg::parser _parser;
     OperationContext* _opCtx{nullptr};
     std::string _defaultDb;
+    bool _allowDiskUse{false};
     SymbolTable _symbolsLookupTable;
     SpoolBufferLookupTable _spoolBuffersLookupTable;
     value::SlotIdGenerator _slotIdGenerator;
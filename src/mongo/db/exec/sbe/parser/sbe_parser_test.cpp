@@ -424,6 +424,7 @@ protected:
                                            sbe::makeSV(1, 2) /* inner conditions */,
                                            sbe::makeSV(5, 6) /* inner projections */,
                                            boost::none, /* optional collator slot */
+                                           true /* allowDiskUse */,
                                            planNodeId),
             // HJOIN with a collator slot.
             sbe::makeS<sbe::HashJoinStage>(sbe::makeS<sbe::CoScanStage>(planNodeId),
@@ -433,6 +434,7 @@ protected:
                                            sbe::makeSV(1, 2) /* inner conditions */,
                                            sbe::makeSV(5, 6) /* inner projections */,
                                            sbe::value::SlotId{7}, /* optional collator slot */
+                                           true /* allowDiskUse */,
                                            planNodeId),
             // FILTER
             sbe::makeS<sbe::FilterStage<false>>(
@@ -594,7 +596,8 @@ TEST_F(SBEParserTest, TestIdenticalDebugOutputAfterParse) {
         sbe::Parser parser(env.get());
         const auto stageText = printer.print(*stage);
 
-        const auto parsedStage = parser.parse(nullptr, "testDb", stageText);
+        const auto parsedStage =
+            parser.parse(nullptr, "testDb", stageText, true /* allowDiskUse */);
         const auto stageTextAfterParse = printer.print(*parsedStage);
 
         ASSERT_EQ(normalizeSbePlanString(stageText), normalizeSbePlanString(stageTextAfterParse));
@@ -608,7 +611,8 @@ TEST_F(SBEParserTest, TestPlanNodeIdIsParsed) {
 
     for (const auto& stage : stages) {
         const auto stageText = printer.print(*stage);
-        const auto parsedStage = parser.parse(nullptr, "testDb", stageText);
+        const auto parsedStage =
+            parser.parse(nullptr, "testDb", stageText, true /* allowDiskUse */);
         ASSERT_EQ(parsedStage->getCommonStats()->nodeId, planNodeId);
     }
 }
@@ -0,0 +1,453 @@
+/**
+ *    Copyright (C) 2022-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+/**
+ * This file contains tests for the block-at-a-time execution mode: sbe::RowToBlockStage,
+ * sbe::BlockToRowStage and the 'valueBlock*' builtins.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/exec/sbe/sbe_plan_stage_test.h"
+#include "mongo/db/exec/sbe/stages/block_to_row.h"
+#include "mongo/db/exec/sbe/stages/project.h"
+#include "mongo/db/exec/sbe/stages/row_to_block.h"
+#include "mongo/db/query/sbe_stage_builder_helpers.h"
+
+namespace mongo::sbe {
+class BlockStageTest : public PlanStageTestFixture {
+public:
+    /**
+     * Streams 'input' through a row_to_block stage with the given 'blockSize', computes
+     * 'makeExpr(blockSlot)' over each batch, and returns all of the values of the computed slot.
+     */
+    std::pair<value::TypeTags, value::Value> runBlockExpr(
+        const BSONArray& input,
+        size_t blockSize,
+        const std::function<std::unique_ptr<EExpression>(value::SlotId)>& makeExpr) {
+        auto [scanSlot, scan] = generateVirtualScan(input);
+        auto blockSlot = generateSlotId();
+        auto resultSlot = generateSlotId();
+        auto stage = makeProjectStage(makeS<RowToBlockStage>(std::move(scan),
+                                                             makeSV(scanSlot),
+                                                             makeSV(blockSlot),
+                                                             blockSize,
+                                                             kEmptyPlanNodeId),
+                                      kEmptyPlanNodeId,
+                                      resultSlot,
+                                      makeExpr(blockSlot));
+
+        auto ctx = makeCompileCtx();
+        auto resultAccessor = prepareTree(ctx.get(), stage.get(), resultSlot);
+        return getAllResults(stage.get(), resultAccessor);
+    }
+
+    /**
+     * Like runBlockExpr(), but unpacks the blocks produced by 'makeExpr' back into rows.
+     */
+    std::pair<value::TypeTags, value::Value> runBlockExprToRows(
+        const BSONArray& input,
+        size_t blockSize,
+        const std::function<std::unique_ptr<EExpression>(value::SlotId)>& makeExpr) {
+        auto [scanSlot, scan] = generateVirtualScan(input);
+        auto blockSlot = generateSlotId();
+        auto resultBlockSlot = generateSlotId();
+        auto resultSlot = generateSlotId();
+        auto project = makeProjectStage(makeS<RowToBlockStage>(std::move(scan),
+                                                               makeSV(scanSlot),
+                                                               makeSV(blockSlot),
+                                                               blockSize,
+                                                               kEmptyPlanNodeId),
+                                        kEmptyPlanNodeId,
+                                        resultBlockSlot,
+                                        makeExpr(blockSlot));
+        auto stage = makeS<BlockToRowStage>(std::move(project),
+                                            makeSV(resultBlockSlot),
+                                            makeSV(resultSlot),
+                                            boost::none,
+                                            kEmptyPlanNodeId);
+
+        auto ctx = makeCompileCtx();
+        auto resultAccessor = prepareTree(ctx.get(), stage.get(), resultSlot);
+        return getAllResults(stage.get(), resultAccessor);
+    }
+
+    void assertResults(std::pair<value::TypeTags, value::Value> results,
+                       const BSONArray& expected) {
+        value::ValueGuard resultsGuard{results};
+        auto [expectedTag, expectedVal] = stage_builder::makeValue(expected);
+        value::ValueGuard expectedGuard{expectedTag, expectedVal};
+        ASSERT_TRUE(valueEquals(results.first, results.second, expectedTag, expectedVal))
+            << "expected: " << std::make_pair(expectedTag, expectedVal)
+            << " but got: " << results;
+    }
+};
+
+TEST_F(BlockStageTest, RowToBlockAndBlockToRowRoundTrip) {
+    auto input = BSON_ARRAY(1 << 2.5 << "a" << BSONNULL << BSON("b" << 1) << 6LL << 7);
+
+    for (size_t blockSize : {1, 2, 3, 7, 100}) {
+        auto makeStageFn = [&](value::SlotId scanSlot, std::unique_ptr<PlanStage> scanStage) {
+            auto blockSlot = generateSlotId();
+            auto outSlot = generateSlotId();
+            auto stage = makeS<BlockToRowStage>(makeS<RowToBlockStage>(std::move(scanStage),
+                                                                       makeSV(scanSlot),
+                                                                       makeSV(blockSlot),
+                                                                       blockSize,
+                                                                       kEmptyPlanNodeId),
+                                                makeSV(blockSlot),
+                                                makeSV(outSlot),
+                                                boost::none,
+                                                kEmptyPlanNodeId);
+            return std::make_pair(outSlot, std::move(stage));
+        };
+
+        auto [inputTag, inputVal] = stage_builder::makeValue(input);
+        auto [expectedTag, expectedVal] = stage_builder::makeValue(input);
+        runTest(inputTag, inputVal, expectedTag, expectedVal, makeStageFn);
+    }
+}
+
+TEST_F(BlockStageTest, RowToBlockProducesBatches) {
+    assertResults(runBlockExpr(BSON_ARRAY(1 << 2 << 3 << 4 << 5),
+                               2,
+                               [](value::SlotId blockSlot) {
+                                   return stage_builder::makeFunction(
+                                       "valueBlockCount",
+                                       stage_builder::makeFunction(
+                                           "valueBlockIsNumber",
+                                           stage_builder::makeVariable(blockSlot)),
+                                       stage_builder::makeVariable(blockSlot));
+                               }),
+                  BSON_ARRAY(2LL << 2LL << 1LL));
+}
+
+TEST_F(BlockStageTest, RowToBlockKeepsViewsIntoRecords) {
+    auto [scanSlot, scan] = generateVirtualScan(BSON_ARRAY(BSON("a"
+                                                                << "foo")
+                                                           << BSON("a" << BSON("b" << 1))
+                                                           << BSON("a" << 1)
+                                                           << BSON("a" << BSON_ARRAY("x"
+                                                                                     << "y"))));
+    auto fieldSlot = generateSlotId();
+    auto recordBlockSlot = generateSlotId();
+    auto fieldBlockSlot = generateSlotId();
+    auto recordSlot = generateSlotId();
+    auto outSlot = generateSlotId();
+
+    // The values of the field are views into the records, which the first block holds copies of.
+    auto project = makeProjectStage(std::move(scan),
+                                    kEmptyPlanNodeId,
+                                    fieldSlot,
+                                    stage_builder::makeFunction(
+                                        "getField",
+                                        stage_builder::makeVariable(scanSlot),
+                                        stage_builder::makeConstant("a")));
+    auto rowToBlock = makeS<RowToBlockStage>(std::move(project),
+                                             makeSV(scanSlot, fieldSlot),
+                                             makeSV(recordBlockSlot, fieldBlockSlot),
+                                             2,
+                                             kEmptyPlanNodeId);
+    auto stage = makeS<BlockToRowStage>(std::move(rowToBlock),
+                                        makeSV(recordBlockSlot, fieldBlockSlot),
+                                        makeSV(recordSlot, outSlot),
+                                        boost::none,
+                                        kEmptyPlanNodeId);
+
+    auto ctx = makeCompileCtx();
+    auto resultAccessor = prepareTree(ctx.get(), stage.get(), outSlot);
+    assertResults(getAllResults(stage.get(), resultAccessor),
+                  BSON_ARRAY("foo" << BSON("b" << 1) << 1
+                                   << BSON_ARRAY("x"
+                                                 << "y")));
+}
+
+TEST_F(BlockStageTest, BlockToRowAppliesBitmap) {
+    auto [scanSlot, scan] = generateVirtualScan(BSON_ARRAY(1 << 5 << 2 << 8 << 3 << "x" << 9));
+    auto blockSlot = generateSlotId();
+    auto bitmapSlot = generateSlotId();
+    auto outSlot = generateSlotId();
+    auto project = makeProjectStage(
+        makeS<RowToBlockStage>(
+            std::move(scan), makeSV(scanSlot), makeSV(blockSlot), 3, kEmptyPlanNodeId),
+        kEmptyPlanNodeId,
+        bitmapSlot,
+        stage_builder::makeFunction("valueBlockGtScalar",
+                                    stage_builder::makeVariable(blockSlot),
+                                    stage_builder::makeConstant(value::TypeTags::NumberInt32, 2)));
+    auto stage = makeS<BlockToRowStage>(
+        std::move(project), makeSV(blockSlot), makeSV(outSlot), bitmapSlot, kEmptyPlanNodeId);
+
+    auto ctx = makeCompileCtx();
+    auto resultAccessor = prepareTree(ctx.get(), stage.get(), outSlot);
+    assertResults(getAllResults(stage.get(), resultAccessor), BSON_ARRAY(5 << 8 << 3 << 9));
+
+    // The stage can be reopened.
+    stage->close();
+    stage->open(false);
+    assertResults(getAllResults(stage.get(), resultAccessor), BSON_ARRAY(5 << 8 << 3 << 9));
+}
+
+TEST_F(BlockStageTest, BlockToRowSelectsAllRowsForNothingBitmap) {
+    auto [scanSlot, scan] = generateVirtualScan(BSON_ARRAY(1 << 5 << 2 << 8));
+    auto blockSlot = generateSlotId();
+    auto bitmapSlot = generateSlotId();
+    auto outSlot = generateSlotId();
+    auto project = makeProjectStage(
+        makeS<RowToBlockStage>(
+            std::move(scan), makeSV(scanSlot), makeSV(blockSlot), 3, kEmptyPlanNodeId),
+        kEmptyPlanNodeId,
+        bitmapSlot,
+        stage_builder::makeConstant(value::TypeTags::Nothing, 0));
+    auto stage = makeS<BlockToRowStage>(
+        std::move(project), makeSV(blockSlot), makeSV(outSlot), bitmapSlot, kEmptyPlanNodeId);
+
+    auto ctx = makeCompileCtx();
+    auto resultAccessor = prepareTree(ctx.get(), stage.get(), outSlot);
+    assertResults(getAllResults(stage.get(), resultAccessor), BSON_ARRAY(1 << 5 << 2 << 8));
+}
+
+TEST_F(BlockStageTest, CompareScalar) {
+    auto input = BSON_ARRAY(1.0 << 2.5 << -3.0 << 4.0);
+
+    // Blocks of doubles compared with a double take the fast path.
+    assertResults(runBlockExprToRows(input,
+                                     3,
+                                     [](value::SlotId blockSlot) {
+                                         return stage_builder::makeFunction(
+                                             "valueBlockGtScalar",
+                                             stage_builder::makeVariable(blockSlot),
+                                             stage_builder::makeConstant(
+                                                 value::TypeTags::NumberDouble, 1.0));
+                                     }),
+                  BSON_ARRAY(false << true << false << true));
+    assertResults(runBlockExprToRows(input,
+                                     3,
+                                     [](value::SlotId blockSlot) {
+                                         return stage_builder::makeFunction(
+                                             "valueBlockLteScalar",
+                                             stage_builder::makeVariable(blockSlot),
+                                             stage_builder::makeConstant(
+                                                 value::TypeTags::NumberDouble, 2.5));
+                                     }),
+                  BSON_ARRAY(true << true << true << false));
+
+    // Mixed types take the generic path, which returns Nothing for incomparable values.
+    assertResults(runBlockExprToRows(BSON_ARRAY(1 << 2LL << 2.0 << "a" << BSONNULL),
+                                     2,
+                                     [](value::SlotId blockSlot) {
+                                         return stage_builder::makeFunction(
+                                             "valueBlockFillEmpty",
+                                             stage_builder::makeFunction(
+                                                 "valueBlockEqScalar",
+                                                 stage_builder::makeVariable(blockSlot),
+                                                 stage_builder::makeConstant(
+                                                     value::TypeTags::NumberInt32, 2)),
+                                             stage_builder::makeConstant(value::TypeTags::Null,
+                                                                         0));
+                                     }),
+                  BSON_ARRAY(false << true << true << BSONNULL << BSONNULL));
+}
+
+TEST_F(BlockStageTest, MatchCompareScalar) {
+    const auto nan = std::numeric_limits<double>::quiet_NaN();
+    auto matchGt = [](auto rhsTag, auto rhsVal) {
+        return [=](value::SlotId blockSlot) {
+            return stage_builder::makeFunction("valueBlockMatchGtScalar",
+                                               stage_builder::makeVariable(blockSlot),
+                                               stage_builder::makeConstant(rhsTag, rhsVal));
+        };
+    };
+
+    // Blocks of doubles take the fast path, on which NaN does not match.
+    assertResults(runBlockExprToRows(BSON_ARRAY(1.0 << 7.5 << nan),
+                                     3,
+                                     matchGt(value::TypeTags::NumberDouble, 5.0)),
+                  BSON_ARRAY(false << true << false));
+
+    // Arrays match if any of their elements does, and the values of the other types never match.
+    assertResults(runBlockExprToRows(BSON_ARRAY(1 << 5.5 << BSON_ARRAY(2 << 20) << "x" << BSONNULL
+                                                  << nan << 10LL),
+                                     4,
+                                     matchGt(value::TypeTags::NumberInt32, 5)),
+                  BSON_ARRAY(false << true << true << false << false << false << true));
+    assertResults(runBlockExprToRows(BSON_ARRAY(10 << 10.0 << BSON_ARRAY(1 << 10LL) << "10"),
+                                     4,
+                                     [](value::SlotId blockSlot) {
+                                         return stage_builder::makeFunction(
+                                             "valueBlockMatchEqScalar",
+                                             stage_builder::makeVariable(blockSlot),
+                                             stage_builder::makeConstant(
+                                                 value::TypeTags::NumberInt64, int64_t{10}));
+                                     }),
+                  BSON_ARRAY(true << true << true << false));
+
+    // The comparisons to the constants other than numbers are not decided on blocks, so all of
+    // the rows are selected.
+    assertResults(runBlockExprToRows(BSON_ARRAY(1 << "a"),
+                                     2,
+                                     [](value::SlotId blockSlot) {
+                                         return stage_builder::makeFunction(
+                                             "valueBlockMatchGtScalar",
+                                             stage_builder::makeVariable(blockSlot),
+                                             stage_builder::makeConstant("a"));
+                                     }),
+                  BSON_ARRAY(true << true));
+    assertResults(runBlockExprToRows(BSON_ARRAY(1 << 2),
+                                     2,
+                                     matchGt(value::TypeTags::NumberDouble, nan)),
+                  BSON_ARRAY(true << true));
+}
+
+TEST_F(BlockStageTest, Arithmetic) {
+    // Blocks of doubles take the fast path.
+    assertResults(runBlockExprToRows(BSON_ARRAY(1.5 << 2.0 << 3.5),
+                                     2,
+                                     [](value::SlotId blockSlot) {
+                                         return stage_builder::makeFunction(
+                                             "valueBlockAdd",
+                                             stage_builder::makeVariable(blockSlot),
+                                             stage_builder::makeConstant(
+                                                 value::TypeTags::NumberDouble, 1.0));
+                                     }),
+                  BSON_ARRAY(2.5 << 3.0 << 4.5));
+
+    assertResults(runBlockExprToRows(BSON_ARRAY(1 << 2LL << 3.5 << "a"),
+                                     3,
+                                     [](value::SlotId blockSlot) {
+                                         return stage_builder::makeFunction(
+                                             "valueBlockFillEmpty",
+                                             stage_builder::makeFunction(
+                                                 "valueBlockMult",
+                                                 stage_builder::makeVariable(blockSlot),
+                                                 stage_builder::makeVariable(blockSlot)),
+                                             stage_builder::makeConstant(value::TypeTags::Null,
+                                                                         0));
+                                     }),
+                  BSON_ARRAY(1 << 4LL << 12.25 << BSONNULL));
+}
+
+TEST_F(BlockStageTest, FillEmptyAndLogicalOps) {
+    assertResults(
+        runBlockExprToRows(BSON_ARRAY(1 << 5 << 10), 3, [](value::SlotId blockSlot) {
+            return stage_builder::makeFunction(
+                "valueBlockLogicalAnd",
+                stage_builder::makeFunction(
+                    "valueBlockGtScalar",
+                    stage_builder::makeVariable(blockSlot),
+                    stage_builder::makeConstant(value::TypeTags::NumberInt32, 1)),
+                stage_builder::makeFunction(
+                    "valueBlockLtScalar",
+                    stage_builder::makeVariable(blockSlot),
+                    stage_builder::makeConstant(value::TypeTags::NumberInt32, 10)));
+        }),
+        BSON_ARRAY(false << true << false));
+
+    assertResults(
+        runBlockExprToRows(BSON_ARRAY(1 << "a" << 10), 3, [](value::SlotId blockSlot) {
+            return stage_builder::makeFunction(
+                "valueBlockFillEmpty",
+                stage_builder::makeFunction(
+                    "valueBlockGtScalar",
+                    stage_builder::makeVariable(blockSlot),
+                    stage_builder::makeConstant(value::TypeTags::NumberInt32, 5)),
+                stage_builder::makeConstant(value::TypeTags::Boolean, false));
+        }),
+        BSON_ARRAY(false << false << true));
+}
+
+TEST_F(BlockStageTest, Aggregates) {
+    auto input = BSON_ARRAY(1 << 7 << 2.5 << "a" << 4LL);
+    auto agg = [](StringData name) {
+        return [name](value::SlotId blockSlot) {
+            return stage_builder::makeFunction(name,
+                                               stage_builder::makeConstant(
+                                                   value::TypeTags::Nothing, 0),
+                                               stage_builder::makeVariable(blockSlot));
+        };
+    };
+
+    assertResults(runBlockExpr(input, 3, agg("valueBlockSum")), BSON_ARRAY(10.5 << 4LL));
+    // Doubles are summed with the same compensated summation as the row-based sum.
+    assertResults(runBlockExpr(BSON_ARRAY(1e16 << 1.0 << 1.0 << -1e16), 4, agg("valueBlockSum")),
+                  BSON_ARRAY(2.0));
+    assertResults(runBlockExpr(input, 3, agg("valueBlockMin")), BSON_ARRAY(1 << 4LL));
+    assertResults(runBlockExpr(input, 3, agg("valueBlockMax")), BSON_ARRAY(7 << "a"));
+    assertResults(runBlockExpr(input, 3, agg("valueBlockCount")), BSON_ARRAY(3LL << 2LL));
+
+    // Like the $min and $max accumulators, valueBlockMin and valueBlockMax ignore nulls.
+    assertResults(runBlockExpr(BSON_ARRAY(BSONNULL << 3 << 1), 3, agg("valueBlockMin")),
+                  BSON_ARRAY(1));
+    assertResults(runBlockExpr(BSON_ARRAY(3 << BSONNULL << 1), 3, agg("valueBlockMax")),
+                  BSON_ARRAY(3));
+
+    // The partial sums are finalized like the ones of 'aggDoubleDoubleSum', so the sum of integers
+    // stays an integer, and the sum of a block without numbers is 0.
+    auto sumFinalized = [](value::SlotId blockSlot) {
+        return stage_builder::makeFunction(
+            "doubleDoubleSumFinalize",
+            stage_builder::makeFunction(
+                "valueBlockAggDoubleDoubleSum",
+                stage_builder::makeConstant(value::TypeTags::Nothing, 0),
+                stage_builder::makeVariable(blockSlot)));
+    };
+    assertResults(runBlockExpr(input, 3, sumFinalized), BSON_ARRAY(10.5 << 4LL));
+    assertResults(runBlockExpr(BSON_ARRAY(1 << 2 << "a"), 2, sumFinalized), BSON_ARRAY(3 << 0));
+
+    // The sum of a constant adds it once per row.
+    assertResults(runBlockExpr(input,
+                               3,
+                               [](value::SlotId blockSlot) {
+                                   return stage_builder::makeFunction(
+                                       "doubleDoubleSumFinalize",
+                                       stage_builder::makeFunction(
+                                           "valueBlockAggDoubleDoubleSum",
+                                           stage_builder::makeConstant(value::TypeTags::Nothing, 0),
+                                           stage_builder::makeVariable(blockSlot),
+                                           stage_builder::makeConstant(
+                                               value::TypeTags::NumberInt32, 2)));
+                               }),
+                  BSON_ARRAY(6 << 4));
+
+    // Only the positions selected by the bitmap are aggregated.
+    assertResults(runBlockExpr(input, 5,
+                               [](value::SlotId blockSlot) {
+                                   return stage_builder::makeFunction(
+                                       "valueBlockSum",
+                                       stage_builder::makeFunction(
+                                           "valueBlockLtScalar",
+                                           stage_builder::makeVariable(blockSlot),
+                                           stage_builder::makeConstant(
+                                               value::TypeTags::NumberInt32, 5)),
+                                       stage_builder::makeVariable(blockSlot));
+                               }),
+                  BSON_ARRAY(7.5));
+}
+}  // namespace mongo::sbe
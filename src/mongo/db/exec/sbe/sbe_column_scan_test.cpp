@@ -33,7 +33,320 @@
 
 #include "mongo/platform/basic.h"
 
+#include "mongo/db/db_raii.h"
 #include "mongo/db/exec/sbe/sbe_plan_stage_test.h"
+#include "mongo/db/exec/sbe/stages/column_scan.h"
+#include "mongo/db/repl/oplog.h"
+#include "mongo/db/repl/replication_coordinator_mock.h"
+#include "mongo/db/repl/storage_interface_impl.h"
 #include "mongo/db/storage/column_store.h"
 
-namespace mongo::sbe {}  // namespace mongo::sbe
+namespace mongo::sbe {
+namespace {
+/**
+ * A ColumnStore holding its cells in memory, which the tests fill directly.
+ */
+class InMemoryColumnStore final : public ColumnStore {
+public:
+    using CellMap = std::map<std::pair<PathValue, RecordId>, CellValue>;
+
+    InMemoryColumnStore() : ColumnStore("in-memory-column-store") {}
+
+    std::unique_ptr<WriteCursor> newWriteCursor(OperationContext*) final {
+        MONGO_UNREACHABLE;
+    }
+    void insert(OperationContext*, PathView path, RecordId rid, CellView cell) final {
+        _cells[{path.toString(), rid}] = cell.toString();
+    }
+    void remove(OperationContext*, PathView path, RecordId rid) final {
+        _cells.erase({path.toString(), rid});
+    }
+    void update(OperationContext*, PathView path, RecordId rid, CellView cell) final {
+        _cells[{path.toString(), rid}] = cell.toString();
+    }
+    std::unique_ptr<ColumnStore::Cursor> newCursor(OperationContext*) const final {
+        return std::make_unique<Cursor>(_cells);
+    }
+    std::unique_ptr<BulkBuilder> makeBulkBuilder(OperationContext*) final {
+        MONGO_UNREACHABLE;
+    }
+    Status compact(OperationContext*) final {
+        return Status::OK();
+    }
+    void fullValidate(OperationContext*, int64_t* numKeysOut, IndexValidateResults*) const final {
+        *numKeysOut = _cells.size();
+    }
+    bool appendCustomStats(OperationContext*, BSONObjBuilder*, double) const final {
+        return false;
+    }
+    long long getSpaceUsedBytes(OperationContext*) const final {
+        return 0;
+    }
+    long long getFreeStorageBytes(OperationContext*) const final {
+        return 0;
+    }
+    bool isEmpty(OperationContext*) final {
+        return _cells.empty();
+    }
+
+private:
+    // Nothing is ever erased while a cursor is open, so its position survives save() and restore().
+    class Cursor final : public ColumnStore::Cursor {
+    public:
+        explicit Cursor(const CellMap& cells) : _cells(cells), _it(cells.end()) {}
+
+        boost::optional<FullCellView> next() final {
+            if (_it == _cells.end()) {
+                return {};
+            }
+            ++_it;
+            return current();
+        }
+        boost::optional<FullCellView> seekAtOrPast(PathView path, RecordId rid) final {
+            _it = _cells.lower_bound({path.toString(), rid});
+            return current();
+        }
+        boost::optional<FullCellView> seekExact(PathView path, RecordId rid) final {
+            _it = _cells.find({path.toString(), rid});
+            return current();
+        }
+
+        void save() final {}
+        void restore() final {}
+        void detachFromOperationContext() final {}
+        void reattachToOperationContext(OperationContext*) final {}
+
+    private:
+        boost::optional<FullCellView> current() const {
+            if (_it == _cells.end()) {
+                return {};
+            }
+            return FullCellView{_it->first.first, _it->first.second, _it->second};
+        }
+
+        const CellMap& _cells;
+        CellMap::const_iterator _it;
+    };
+
+    CellMap _cells;
+};
+
+class ColumnScanStageTest : public PlanStageTestFixture {
+public:
+    void setUp() override {
+        PlanStageTestFixture::setUp();
+
+        auto service = getServiceContext();
+        auto replCoord = std::make_unique<repl::ReplicationCoordinatorMock>(service);
+        ASSERT_OK(replCoord->setFollowerMode(repl::MemberState::RS_PRIMARY));
+        repl::ReplicationCoordinator::set(service, std::move(replCoord));
+        repl::createOplog(opCtx());
+
+        ASSERT_OK(repl::StorageInterfaceImpl().createCollection(opCtx(), _nss, {}));
+    }
+
+    void tearDown() override {
+        _collLock.reset();
+        PlanStageTestFixture::tearDown();
+    }
+
+    /**
+     * Inserts 'docs' into the collection, and adds the cells of their top level 'paths' to the
+     * column store. Scalars are stored as a single value and arrays of scalars as their values
+     * followed by the array info.
+     */
+    void insertDocuments(const std::vector<BSONObj>& docs, const std::vector<std::string>& paths) {
+        std::vector<InsertStatement> inserts{docs.begin(), docs.end()};
+        _collLock = std::make_unique<AutoGetCollection>(opCtx(), _nss, LockMode::MODE_X);
+        {
+            WriteUnitOfWork wuow{opCtx()};
+            ASSERT_OK(_collLock->getWritableCollection(opCtx())->insertDocuments(
+                opCtx(), inserts.begin(), inserts.end(), nullptr /* opDebug */));
+            wuow.commit();
+        }
+        _collLock = std::make_unique<AutoGetCollection>(opCtx(), _nss, LockMode::MODE_IS);
+
+        auto cursor = _collLock->getCollection()->getCursor(opCtx());
+        while (auto record = cursor->next()) {
+            auto doc = record->data.toBson();
+            _columnStore.insert(opCtx(), ColumnStore::kRowIdPath, record->id, ""_sd);
+            for (auto& path : paths) {
+                if (auto elem = doc[path]) {
+                    _columnStore.insert(opCtx(), path, record->id, encodeCell(elem));
+                }
+            }
+        }
+    }
+
+    static CellValue encodeCell(const BSONElement& elem) {
+        auto appendValue = [](CellValue& cell, const BSONElement& value) {
+            // A value is stored as a BSON element with an empty field name.
+            BSONObjBuilder bob;
+            bob.appendAs(value, ""_sd);
+            auto obj = bob.obj();
+            cell.append(obj.firstElement().rawdata(), obj.firstElement().size());
+        };
+
+        CellValue cell;
+        if (elem.type() != BSONType::Array) {
+            appendValue(cell, elem);
+            return cell;
+        }
+
+        const StringData arrInfo = "[";
+        cell.push_back(char(ColumnStore::Bytes::TinySize::kArrInfoZero + arrInfo.size()));
+        for (auto&& value : elem.Obj()) {
+            appendValue(cell, value);
+        }
+        cell.append(arrInfo.rawData(), arrInfo.size());
+        return cell;
+    }
+
+    /**
+     * Returns a filter on the top level 'path' holding a value less than 'bound', as both the
+     * predicate on the row store document and the predicate on a cell.
+     */
+    ColumnScanStage::PathFilter makeLessThanFilter(StringData path,
+                                                   int32_t bound,
+                                                   value::SlotId rowStoreSlot,
+                                                   value::SlotId cellSlot) {
+        auto lessThan = [&](std::unique_ptr<EExpression> input) {
+            return makeE<EFunction>(
+                "fillEmpty",
+                makeEs(makeE<EPrimBinary>(
+                           EPrimBinary::less,
+                           std::move(input),
+                           makeE<EConstant>(value::TypeTags::NumberInt32,
+                                            value::bitcastFrom<int32_t>(bound))),
+                       makeE<EConstant>(value::TypeTags::Boolean,
+                                        value::bitcastFrom<bool>(false))));
+        };
+
+        auto getField = makeE<EFunction>(
+            "getField", makeEs(makeE<EVariable>(rowStoreSlot), makeE<EConstant>(path)));
+        auto filterExpr = makeE<EFunction>(
+            "traverseF",
+            makeEs(std::move(getField),
+                   makeE<ELocalLambda>(_frameId, lessThan(makeE<EVariable>(_frameId, 0))),
+                   makeE<EConstant>(value::TypeTags::Boolean, value::bitcastFrom<bool>(false))));
+        ++_frameId;
+        return {path.toString(), std::move(filterExpr), lessThan(makeE<EVariable>(cellSlot))};
+    }
+
+    /**
+     * Runs a column scan with the filters built by 'makeFilters', which is given the row store and
+     * the cell slots. Returns the '_id's of the rows produced and the debug stats of the scan.
+     */
+    template <typename MakeFilters>
+    std::pair<std::vector<int>, BSONObj> runScan(const ColumnStore* columnStore,
+                                                 const MakeFilters& makeFilters) {
+        auto recordSlot = generateSlotId();
+        auto rowStoreSlot = generateSlotId();
+        auto cellSlot = generateSlotId();
+        auto stage = makeS<ColumnScanStage>(_collLock->getCollection()->uuid(),
+                                            "columnstore",
+                                            value::SlotVector{},
+                                            std::vector<std::string>{},
+                                            recordSlot,
+                                            boost::none,
+                                            makeE<EVariable>(rowStoreSlot),
+                                            std::vector<std::unique_ptr<EExpression>>{},
+                                            rowStoreSlot,
+                                            makeFilters(rowStoreSlot, cellSlot),
+                                            cellSlot,
+                                            columnStore,
+                                            nullptr /* yieldPolicy */,
+                                            kEmptyPlanNodeId);
+
+        auto ctx = makeCompileCtx();
+        auto recordAccessor = prepareTree(ctx.get(), stage.get(), recordSlot);
+
+        std::vector<int> ids;
+        while (stage->getNext() == PlanState::ADVANCED) {
+            auto [tag, val] = recordAccessor->getViewOfValue();
+            ASSERT_EQ(tag, value::TypeTags::bsonObject);
+            ids.push_back(BSONObj(value::bitcastTo<const char*>(val))["_id"].numberInt());
+        }
+        auto stats = stage->getStats(true /* includeDebugInfo */);
+        stage->close();
+        return {ids, stats->debugInfo.getOwned()};
+    }
+
+protected:
+    const NamespaceString _nss{"testdb.sbe_column_scan"};
+    std::unique_ptr<AutoGetCollection> _collLock;
+    InMemoryColumnStore _columnStore;
+    FrameId _frameId{10};
+};
+
+TEST_F(ColumnScanStageTest, FiltersCellsBeforeAssemblingRows) {
+    std::vector<BSONObj> docs;
+    for (int i = 0; i < 10; ++i) {
+        docs.push_back(BSON("_id" << i << "a" << i));
+    }
+    // An array cannot be filtered on its cell and has to be checked on the row, a missing path
+    // has no cell at all, and a string fails the comparison on the cell.
+    docs.push_back(BSON("_id" << 10 << "a" << BSON_ARRAY(7 << 1)));
+    docs.push_back(BSON("_id" << 11));
+    docs.push_back(BSON("_id" << 12 << "a"
+                              << "str"));
+    insertDocuments(docs, {"a"});
+
+    auto makeFilters = [&](value::SlotId rowStoreSlot, value::SlotId cellSlot) {
+        std::vector<ColumnScanStage::PathFilter> filters;
+        filters.push_back(makeLessThanFilter("a", 3, rowStoreSlot, cellSlot));
+        return filters;
+    };
+    const std::vector<int> expectedIds{0, 1, 2, 10};
+
+    auto [ids, stats] = runScan(&_columnStore, makeFilters);
+    ASSERT(ids == expectedIds);
+    // Every cell of 'a' is scanned, but only the rows passing the cell predicate and the row
+    // holding an array are read from the row store.
+    ASSERT_EQ(stats["numCellsScanned"].numberLong(), 12);
+    ASSERT_EQ(stats["numRowsAssembled"].numberLong(), 4);
+    ASSERT_LT(stats["numRowsAssembled"].numberLong(), stats["numCellsScanned"].numberLong());
+
+    // Without a column store, every row is assembled before being filtered.
+    auto [rowStoreIds, rowStoreStats] = runScan(nullptr, makeFilters);
+    ASSERT(rowStoreIds == expectedIds);
+    ASSERT_EQ(rowStoreStats["numRowsAssembled"].numberLong(), 13);
+}
+
+TEST_F(ColumnScanStageTest, SkipsRowsMissingAFilteredPath) {
+    std::vector<BSONObj> docs;
+    for (int i = 0; i < 10; ++i) {
+        if (i % 4 == 0) {
+            docs.push_back(BSON("_id" << i << "a" << i << "b" << 0));
+        } else {
+            docs.push_back(BSON("_id" << i << "a" << i));
+        }
+    }
+    insertDocuments(docs, {"a", "b"});
+
+    auto makeFilters = [&](value::SlotId rowStoreSlot, value::SlotId cellSlot) {
+        std::vector<ColumnScanStage::PathFilter> filters;
+        filters.push_back(makeLessThanFilter("a", 6, rowStoreSlot, cellSlot));
+        filters.push_back(makeLessThanFilter("b", 1, rowStoreSlot, cellSlot));
+        return filters;
+    };
+
+    auto [ids, stats] = runScan(&_columnStore, makeFilters);
+    ASSERT(ids == std::vector<int>({0, 4}));
+    // The cursor on 'b' jumps over the rows without 'b', so neither they nor the row failing the
+    // predicate on 'a' are read from the row store.
+    ASSERT_EQ(stats["numRowsAssembled"].numberLong(), 2);
+    ASSERT_LT(stats["numRowsAssembled"].numberLong(), stats["numCellsScanned"].numberLong());
+}
+
+TEST_F(ColumnScanStageTest, ScansAllRowIdsWithoutFilters) {
+    insertDocuments({BSON("_id" << 0 << "a" << 1), BSON("_id" << 1)}, {"a"});
+
+    auto [ids, stats] = runScan(&_columnStore, [](value::SlotId, value::SlotId) {
+        return std::vector<ColumnScanStage::PathFilter>{};
+    });
+    ASSERT(ids == std::vector<int>({0, 1}));
+    ASSERT_EQ(stats["numRowsAssembled"].numberLong(), 2);
+}
+}  // namespace
+}  // namespace mongo::sbe
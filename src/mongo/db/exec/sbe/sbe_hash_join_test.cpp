@@ -37,6 +37,7 @@
 #include "mongo/db/exec/sbe/sbe_plan_stage_test.h"
 #include "mongo/db/exec/sbe/stages/hash_join.h"
 #include "mongo/db/query/collation/collator_interface_mock.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo::sbe {
 
@@ -79,6 +80,7 @@ TEST_F(HashJoinStageTest, HashJoinCollationTest) {
                                      makeSV(innerCondSlot),
                                      makeSV(),
                                      boost::optional<value::SlotId>{useCollator, collatorSlot},
+                                     false /* allowDiskUse */,
                                      kEmptyPlanNodeId);
 
             return std::make_pair(makeSV(innerCondSlot, outerCondSlot), std::move(hashJoinStage));
@@ -137,4 +139,67 @@ TEST_F(HashJoinStageTest, HashJoinCollationTest) {
     }
 }
 
+TEST_F(HashJoinStageTest, HashJoinSpillTest) {
+    // Set the memory threshold so low that the build side spills on the first memory check, and
+    // the join runs partition by partition.
+    auto defaultMemoryLimit = internalQuerySBEHashJoinApproxMemoryUseInBytesBeforeSpill.load();
+    internalQuerySBEHashJoinApproxMemoryUseInBytesBeforeSpill.store(1);
+    auto defaultPartitions = internalQuerySBEHashJoinSpillPartitions.load();
+    internalQuerySBEHashJoinSpillPartitions.store(4);
+    ON_BLOCK_EXIT([&] {
+        internalQuerySBEHashJoinApproxMemoryUseInBytesBeforeSpill.store(defaultMemoryLimit);
+        internalQuerySBEHashJoinSpillPartitions.store(defaultPartitions);
+    });
+
+    auto ctx = makeCompileCtx();
+
+    auto [outerSlots, outerStage] =
+        generateVirtualScanMulti(2,
+                                 BSON_ARRAY(BSON_ARRAY(1 << "o1") << BSON_ARRAY(2 << "o2a")
+                                                                  << BSON_ARRAY(2 << "o2b")
+                                                                  << BSON_ARRAY(3 << "o3")
+                                                                  << BSON_ARRAY(5 << "o5")));
+    auto [innerSlots, innerStage] =
+        generateVirtualScanMulti(2,
+                                 BSON_ARRAY(BSON_ARRAY(2 << "i2") << BSON_ARRAY(3 << "i3a")
+                                                                  << BSON_ARRAY(3 << "i3b")
+                                                                  << BSON_ARRAY(4 << "i4")
+                                                                  << BSON_ARRAY(1 << "i1")));
+
+    auto stage = makeS<HashJoinStage>(std::move(outerStage),
+                                      std::move(innerStage),
+                                      makeSV(outerSlots[0]),
+                                      makeSV(outerSlots[1]),
+                                      makeSV(innerSlots[0]),
+                                      makeSV(innerSlots[1]),
+                                      boost::none,
+                                      true /* allowDiskUse */,
+                                      kEmptyPlanNodeId);
+
+    auto resultAccessors =
+        prepareTree(ctx.get(), stage.get(), makeSV(outerSlots[1], innerSlots[1]));
+
+    std::multiset<std::pair<std::string, std::string>> results;
+    while (stage->getNext() == PlanState::ADVANCED) {
+        auto [outerTag, outerVal] = resultAccessors[0]->getViewOfValue();
+        auto [innerTag, innerVal] = resultAccessors[1]->getViewOfValue();
+        results.emplace(value::getStringView(outerTag, outerVal).toString(),
+                        value::getStringView(innerTag, innerVal).toString());
+    }
+
+    std::multiset<std::pair<std::string, std::string>> expected{
+        {"o1", "i1"}, {"o2a", "i2"}, {"o2b", "i2"}, {"o3", "i3a"}, {"o3", "i3b"}};
+    ASSERT(results == expected);
+
+    // Every row of the outer side is spilled, while the inner rows are spilled only if their
+    // partition received any rows from the outer side.
+    auto stats = static_cast<const HashJoinStats*>(stage->getSpecificStats());
+    ASSERT_TRUE(stats->usedDisk);
+    ASSERT_EQ(4, stats->numPartitions);
+    ASSERT_GTE(stats->spilledRecords, 5 + 4);
+    ASSERT_GT(stats->spilledBytes, 0);
+
+    stage->close();
+}
+
 }  // namespace mongo::sbe
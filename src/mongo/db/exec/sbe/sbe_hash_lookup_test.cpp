@@ -40,6 +40,7 @@
 #include "mongo/db/query/collation/collator_interface_mock.h"
 #include "mongo/unittest/golden_test.h"
 #include "mongo/util/assert_util.h"
+#include "mongo/util/scopeguard.h"
 namespace mongo::sbe {
 
 unittest::GoldenTestConfig goldenTestConfig{"src/mongo/db/test_output/exec/sbe"};
@@ -97,17 +98,21 @@ public:
 
         // Build and prepare for execution loop join of the two scan stages.
         auto lookupAggSlot = generateSlotId();
-        auto aggs =
-            makeEM(lookupAggSlot,
-                   stage_builder::makeFunction("addToArray", makeE<EVariable>(innerScanSlots[0])));
-        auto lookupStage = makeS<HashLookupStage>(std::move(outerScanStage),
-                                                  std::move(innerScanStage),
-                                                  outerScanSlots[1],
-                                                  innerScanSlots[1],
-                                                  makeSV(innerScanSlots[0]),
-                                                  std::move(aggs),
-                                                  collatorSlot,
-                                                  kEmptyPlanNodeId);
+        auto makeLookupStage = [&](bool allowDiskUse) {
+            auto aggs = makeEM(
+                lookupAggSlot,
+                stage_builder::makeFunction("addToArray", makeE<EVariable>(innerScanSlots[0])));
+            return makeS<HashLookupStage>(outerScanStage->clone(),
+                                          innerScanStage->clone(),
+                                          outerScanSlots[1],
+                                          innerScanSlots[1],
+                                          makeSV(innerScanSlots[0]),
+                                          std::move(aggs),
+                                          collatorSlot,
+                                          allowDiskUse,
+                                          kEmptyPlanNodeId);
+        };
+        auto lookupStage = makeLookupStage(false);
 
         stream << "-- OUTPUT ";
         StageResultsPrinters::SlotNames slotNames;
@@ -118,7 +123,34 @@ public:
         }
         slotNames.emplace_back(lookupAggSlot, "inner_agg");
 
-        prepareAndEvalStageWithReopen(ctx.get(), stream, slotNames, lookupStage.get());
+        std::stringstream inMemoryStream;
+        prepareAndEvalStageWithReopen(ctx.get(), inMemoryStream, slotNames, lookupStage.get());
+        stream << inMemoryStream.str();
+
+        // Spilling is not supported with a collator.
+        if (collator) {
+            return;
+        }
+
+        // Run the same lookup with the memory limit set so low that all 'inner' rows but the first
+        // one are spilled to disk, and verify that the output does not change.
+        const auto defaultMemoryLimit =
+            internalQuerySBELookupApproxMemoryUseInBytesBeforeSpill.load();
+        internalQuerySBELookupApproxMemoryUseInBytesBeforeSpill.store(1);
+        ON_BLOCK_EXIT([&] {
+            internalQuerySBELookupApproxMemoryUseInBytesBeforeSpill.store(defaultMemoryLimit);
+        });
+
+        auto spillingCtx = makeCompileCtx();
+        auto spillingStage = makeLookupStage(true);
+        std::stringstream spillingStream;
+        prepareAndEvalStageWithReopen(
+            spillingCtx.get(), spillingStream, slotNames, spillingStage.get());
+        ASSERT_EQ(inMemoryStream.str(), spillingStream.str());
+
+        auto stats = static_cast<const HashLookupStats*>(spillingStage->getSpecificStats());
+        ASSERT_EQ(inner.nFields() > 0, stats->usedDisk);
+        ASSERT_EQ(inner.nFields() > 1, stats->spilledBuffRecords > 0);
     }
 
     void cloneAndEvalStage(std::ostream& stream,
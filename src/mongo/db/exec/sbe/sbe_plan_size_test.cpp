@@ -27,6 +27,7 @@
  *    it in the license file.
  */
 
+#include "mongo/db/exec/sbe/stages/block_to_row.h"
 #include "mongo/db/exec/sbe/stages/branch.h"
 #include "mongo/db/exec/sbe/stages/bson_scan.h"
 #include "mongo/db/exec/sbe/stages/check_bounds.h"
@@ -41,6 +42,7 @@
 #include "mongo/db/exec/sbe/stages/makeobj.h"
 #include "mongo/db/exec/sbe/stages/merge_join.h"
 #include "mongo/db/exec/sbe/stages/project.h"
+#include "mongo/db/exec/sbe/stages/row_to_block.h"
 #include "mongo/db/exec/sbe/stages/scan.h"
 #include "mongo/db/exec/sbe/stages/sort.h"
 #include "mongo/db/exec/sbe/stages/sorted_merge.h"
@@ -96,6 +98,12 @@ private:
     std::unique_ptr<value::SlotIdGenerator> _slotIdGenerator;
 };
 
+TEST_F(PlanSizeTest, BlockToRow) {
+    auto stage =
+        makeS<BlockToRowStage>(mockS(), mockSV(), mockSV(), generateSlotId(), kEmptyPlanNodeId);
+    assertPlanSize(*stage);
+}
+
 TEST_F(PlanSizeTest, Branch) {
     auto stage = makeS<BranchStage>(
         mockS(), mockS(), mockE(), mockSV(), mockSV(), mockSV(), kEmptyPlanNodeId);
@@ -156,6 +164,7 @@ TEST_F(PlanSizeTest, HashJoin) {
                                       mockSV(),
                                       makeSV(),
                                       generateSlotId(),
+                                      false /* allowDiskUse */,
                                       kEmptyPlanNodeId);
     assertPlanSize(*stage);
 }
@@ -221,6 +230,11 @@ TEST_F(PlanSizeTest, Project) {
     assertPlanSize(*stage);
 }
 
+TEST_F(PlanSizeTest, RowToBlock) {
+    auto stage = makeS<RowToBlockStage>(mockS(), mockSV(), mockSV(), 128, kEmptyPlanNodeId);
+    assertPlanSize(*stage);
+}
+
 TEST_F(PlanSizeTest, Scan) {
     auto collUuid = UUID::parse("00000000-0000-0000-0000-000000000000").getValue();
     auto stage = makeS<ScanStage>(collUuid,
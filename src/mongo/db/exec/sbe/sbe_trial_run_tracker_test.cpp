@@ -330,4 +330,30 @@ TEST_F(TrialRunTrackerTest, SiblingBlockingStagesBothGetTrialRunTracker) {
                        DBException,
                        ErrorCodes::QueryTrialRunCompleted);
 }
+
+TEST_F(TrialRunTrackerTest, SharedMaxNumReadsLowersTheBudgetOfReads) {
+    AtomicWord<size_t> sharedMaxNumReads{10};
+    TrialRunTracker tracker{size_t{0}, size_t{10}};
+    tracker.setSharedMaxNumReads(&sharedMaxNumReads);
+
+    // The shared budget does not apply to the other metrics.
+    ASSERT_FALSE(tracker.trackProgress<TrialRunTracker::kNumResults>(100));
+    for (size_t i = 0; i < 3; ++i) {
+        ASSERT_FALSE(tracker.trackProgress<TrialRunTracker::kNumReads>(1));
+    }
+
+    // A tracker which has not done more reads than the lowered budget can continue.
+    sharedMaxNumReads.store(5);
+    ASSERT_FALSE(tracker.trackProgress<TrialRunTracker::kNumReads>(1));
+    ASSERT_FALSE(tracker.trackProgress<TrialRunTracker::kNumReads>(1));
+    ASSERT_TRUE(tracker.trackProgress<TrialRunTracker::kNumReads>(1));
+    ASSERT_EQ(tracker.getMetric<TrialRunTracker::kNumReads>(), 6);
+
+    // A tracker which has already done more reads stops on the next read.
+    TrialRunTracker otherTracker{size_t{0}, size_t{10}};
+    otherTracker.setSharedMaxNumReads(&sharedMaxNumReads);
+    ASSERT_FALSE(otherTracker.trackProgress<TrialRunTracker::kNumReads>(4));
+    sharedMaxNumReads.store(2);
+    ASSERT_TRUE(otherTracker.trackProgress<TrialRunTracker::kNumReads>(1));
+}
 }  // namespace mongo::sbe
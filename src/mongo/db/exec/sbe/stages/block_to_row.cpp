@@ -0,0 +1,229 @@
+/**
+ *    Copyright (C) 2022-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/exec/sbe/stages/block_to_row.h"
+
+#include "mongo/db/exec/sbe/size_estimator.h"
+#include "mongo/db/exec/sbe/values/value_block.h"
+
+namespace mongo::sbe {
+BlockToRowStage::BlockToRowStage(std::unique_ptr<PlanStage> input,
+                                 value::SlotVector blockSlots,
+                                 value::SlotVector outputSlots,
+                                 boost::optional<value::SlotId> bitmapSlot,
+                                 PlanNodeId planNodeId)
+    : PlanStage("block_to_row"_sd, planNodeId),
+      _blockSlots(std::move(blockSlots)),
+      _outputSlots(std::move(outputSlots)),
+      _bitmapSlot(bitmapSlot) {
+    _children.emplace_back(std::move(input));
+    tassert(7131420,
+            "block_to_row requires the same number of block and output slots",
+            _blockSlots.size() == _outputSlots.size());
+}
+
+std::unique_ptr<PlanStage> BlockToRowStage::clone() const {
+    return std::make_unique<BlockToRowStage>(
+        _children[0]->clone(), _blockSlots, _outputSlots, _bitmapSlot, _commonStats.nodeId);
+}
+
+void BlockToRowStage::prepare(CompileCtx& ctx) {
+    _children[0]->prepare(ctx);
+
+    value::SlotSet dupCheck;
+    for (size_t idx = 0; idx < _blockSlots.size(); ++idx) {
+        auto [it, inserted] = dupCheck.emplace(_outputSlots[idx]);
+        uassert(7131421, str::stream() << "duplicate field: " << _outputSlots[idx], inserted);
+
+        _blockAccessors.push_back(_children[0]->getAccessor(ctx, _blockSlots[idx]));
+    }
+    if (_bitmapSlot) {
+        _bitmapAccessor = _children[0]->getAccessor(ctx, *_bitmapSlot);
+    }
+    _outAccessors.resize(_outputSlots.size());
+    _blocks.resize(_blockSlots.size());
+}
+
+value::SlotAccessor* BlockToRowStage::getAccessor(CompileCtx& ctx, value::SlotId slot) {
+    for (size_t idx = 0; idx < _outputSlots.size(); ++idx) {
+        if (_outputSlots[idx] == slot) {
+            return &_outAccessors[idx];
+        }
+    }
+
+    return _children[0]->getAccessor(ctx, slot);
+}
+
+void BlockToRowStage::open(bool reOpen) {
+    auto optTimer(getOptTimer(_opCtx));
+
+    _commonStats.opens++;
+    _children[0]->open(reOpen);
+    _batchSize = 0;
+    _position = 0;
+}
+
+void BlockToRowStage::readBatch() {
+    auto getBlock = [](value::SlotAccessor* accessor) {
+        auto [tag, val] = accessor->getViewOfValue();
+        const auto msgTag = tag;
+        tassert(7131422,
+                str::stream() << "block_to_row expects a block but got: " << msgTag,
+                tag == value::TypeTags::valueBlock);
+        return value::getValueBlockView(val);
+    };
+
+    _batchSize = 0;
+    for (size_t idx = 0; idx < _blockAccessors.size(); ++idx) {
+        _blocks[idx] = getBlock(_blockAccessors[idx]);
+        tassert(7131423,
+                "all of the blocks of a batch must have the same size",
+                idx == 0 || _blocks[idx]->size() == _batchSize);
+        _batchSize = _blocks[idx]->size();
+    }
+
+    _bitmap = nullptr;
+    if (_bitmapAccessor && _bitmapAccessor->getViewOfValue().first != value::TypeTags::Nothing) {
+        _bitmap = getBlock(_bitmapAccessor);
+        tassert(7131424,
+                "the bitmap must have the same size as the blocks",
+                _blockAccessors.empty() || _bitmap->size() == _batchSize);
+        _batchSize = _bitmap->size();
+    }
+    _position = 0;
+}
+
+PlanState BlockToRowStage::getNext() {
+    auto optTimer(getOptTimer(_opCtx));
+
+    for (;;) {
+        // Skip the positions that are not selected by the bitmap.
+        if (_bitmap) {
+            const value::TypeTags* tags = _bitmap->tags();
+            const value::Value* vals = _bitmap->vals();
+            while (_position < _batchSize &&
+                   !(tags[_position] == value::TypeTags::Boolean &&
+                     value::bitcastTo<bool>(vals[_position]))) {
+                ++_position;
+            }
+        }
+
+        if (_position < _batchSize) {
+            for (size_t idx = 0; idx < _blocks.size(); ++idx) {
+                auto [tag, val] = _blocks[idx]->at(_position);
+                _outAccessors[idx].reset(tag, val);
+            }
+            ++_position;
+            return trackPlanState(PlanState::ADVANCED);
+        }
+
+        // The output slots are views into the blocks of the child, which are about to be replaced.
+        disableSlotAccess();
+        auto state = _children[0]->getNext();
+        if (state != PlanState::ADVANCED) {
+            _batchSize = 0;
+            _position = 0;
+            return trackPlanState(state);
+        }
+        readBatch();
+    }
+}
+
+void BlockToRowStage::close() {
+    auto optTimer(getOptTimer(_opCtx));
+
+    trackClose();
+    _children[0]->close();
+    _batchSize = 0;
+    _position = 0;
+}
+
+std::unique_ptr<PlanStageStats> BlockToRowStage::getStats(bool includeDebugInfo) const {
+    auto ret = std::make_unique<PlanStageStats>(_commonStats);
+
+    if (includeDebugInfo) {
+        BSONObjBuilder bob;
+        bob.append("blockSlots", _blockSlots.begin(), _blockSlots.end());
+        bob.append("outputSlots", _outputSlots.begin(), _outputSlots.end());
+        if (_bitmapSlot) {
+            bob.appendNumber("bitmapSlot", static_cast<long long>(*_bitmapSlot));
+        }
+        ret->debugInfo = bob.obj();
+    }
+
+    ret->children.emplace_back(_children[0]->getStats(includeDebugInfo));
+    return ret;
+}
+
+const SpecificStats* BlockToRowStage::getSpecificStats() const {
+    return nullptr;
+}
+
+std::vector<DebugPrinter::Block> BlockToRowStage::debugPrint() const {
+    auto ret = PlanStage::debugPrint();
+
+    ret.emplace_back(DebugPrinter::Block("[`"));
+    for (size_t idx = 0; idx < _outputSlots.size(); ++idx) {
+        if (idx) {
+            ret.emplace_back(DebugPrinter::Block("`,"));
+        }
+        DebugPrinter::addIdentifier(ret, _outputSlots[idx]);
+    }
+    ret.emplace_back(DebugPrinter::Block("`]"));
+
+    ret.emplace_back(DebugPrinter::Block("[`"));
+    for (size_t idx = 0; idx < _blockSlots.size(); ++idx) {
+        if (idx) {
+            ret.emplace_back(DebugPrinter::Block("`,"));
+        }
+        DebugPrinter::addIdentifier(ret, _blockSlots[idx]);
+    }
+    ret.emplace_back(DebugPrinter::Block("`]"));
+
+    if (_bitmapSlot) {
+        DebugPrinter::addIdentifier(ret, *_bitmapSlot);
+    }
+
+    DebugPrinter::addNewLine(ret);
+    DebugPrinter::addBlocks(ret, _children[0]->debugPrint());
+
+    return ret;
+}
+
+size_t BlockToRowStage::estimateCompileTimeSize() const {
+    size_t size = sizeof(*this);
+    size += size_estimator::estimate(_children);
+    size += size_estimator::estimate(_blockSlots);
+    size += size_estimator::estimate(_outputSlots);
+    return size;
+}
+}  // namespace mongo::sbe
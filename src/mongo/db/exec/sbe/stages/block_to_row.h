@@ -0,0 +1,94 @@
+/**
+ *    Copyright (C) 2022-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include "mongo/db/exec/sbe/stages/stages.h"
+
+namespace mongo::sbe {
+/**
+ * Turns the batches produced by a RowToBlockStage, and possibly transformed by the 'valueBlock*'
+ * builtins, back into individual rows. For each batch of the child stage, the value::ValueBlock
+ * values of the 'blockSlots' are unpacked one position at a time into the corresponding
+ * 'outputSlots'. All of the blocks of a batch must have the same size.
+ *
+ * If a 'bitmapSlot' is provided, it holds a block of the same size and only the positions at which
+ * it holds a true boolean are returned. This is how a filter evaluated over a whole batch
+ * with the 'valueBlock*' comparison builtins is applied. If the bitmap slot holds Nothing instead
+ * of a block, all of the positions of the batch are returned, like in the 'valueBlock*' aggregates.
+ *
+ * The values of the 'outputSlots' are views into the blocks owned by the child stage.
+ *
+ * Debug string representation:
+ *
+ *   block_to_row [<output slots>] [<block slots>] bitmapSlot? childStage
+ */
+class BlockToRowStage final : public PlanStage {
+public:
+    BlockToRowStage(std::unique_ptr<PlanStage> input,
+                    value::SlotVector blockSlots,
+                    value::SlotVector outputSlots,
+                    boost::optional<value::SlotId> bitmapSlot,
+                    PlanNodeId planNodeId);
+
+    std::unique_ptr<PlanStage> clone() const final;
+
+    void prepare(CompileCtx& ctx) final;
+    value::SlotAccessor* getAccessor(CompileCtx& ctx, value::SlotId slot) final;
+    void open(bool reOpen) final;
+    PlanState getNext() final;
+    void close() final;
+
+    std::unique_ptr<PlanStageStats> getStats(bool includeDebugInfo) const final;
+    const SpecificStats* getSpecificStats() const final;
+    std::vector<DebugPrinter::Block> debugPrint() const final;
+    size_t estimateCompileTimeSize() const final;
+
+private:
+    /**
+     * Reads the blocks of the current batch of the child stage.
+     */
+    void readBatch();
+
+    const value::SlotVector _blockSlots;
+    const value::SlotVector _outputSlots;
+    const boost::optional<value::SlotId> _bitmapSlot;
+
+    std::vector<value::SlotAccessor*> _blockAccessors;
+    value::SlotAccessor* _bitmapAccessor{nullptr};
+    std::vector<value::ViewOfValueAccessor> _outAccessors;
+
+    // The blocks of the current batch, and the position of the next row to return.
+    std::vector<const value::ValueBlock*> _blocks;
+    const value::ValueBlock* _bitmap{nullptr};
+    size_t _batchSize{0};
+    size_t _position{0};
+};
+}  // namespace mongo::sbe
@@ -32,9 +32,83 @@
 
 #include "mongo/db/exec/sbe/expressions/expression.h"
 #include "mongo/db/exec/sbe/size_estimator.h"
+#include "mongo/db/exec/sbe/values/bson.h"
 
 namespace mongo {
 namespace sbe {
+namespace {
+/**
+ * Converts a value decoded from a cell into an owned SBE value. The values which the cell
+ * predicates do not handle, namely the empty objects and arrays and the UUIDs, are converted to
+ * Nothing so that the predicate is run on the row store document instead.
+ */
+struct CellValueEncoder {
+    using Out = std::pair<value::TypeTags, value::Value>;
+
+    Out operator()(const BSONElement& elem) {
+        return bson::convertFrom<false>(elem);
+    }
+    Out operator()(int32_t val) {
+        return {value::TypeTags::NumberInt32, value::bitcastFrom<int32_t>(val)};
+    }
+    Out operator()(int64_t val) {
+        return {value::TypeTags::NumberInt64, value::bitcastFrom<int64_t>(val)};
+    }
+    Out operator()(double val) {
+        return {value::TypeTags::NumberDouble, value::bitcastFrom<double>(val)};
+    }
+    Out operator()(bool val) {
+        return {value::TypeTags::Boolean, value::bitcastFrom<bool>(val)};
+    }
+    Out operator()(StringData str) {
+        return value::makeNewString(str);
+    }
+    Out operator()(const Decimal128& val) {
+        return value::makeCopyDecimal(val);
+    }
+    Out operator()(const OID& oid) {
+        value::ObjectIdType id;
+        std::memcpy(id.data(), oid.view().view(), id.size());
+        return value::makeCopyObjectId(id);
+    }
+    Out operator()(NullLabeler) {
+        return {value::TypeTags::Null, 0};
+    }
+    Out operator()(MinKeyLabeler) {
+        return {value::TypeTags::MinKey, 0};
+    }
+    Out operator()(MaxKeyLabeler) {
+        return {value::TypeTags::MaxKey, 0};
+    }
+    Out operator()(const BSONObj&) {
+        return {value::TypeTags::Nothing, 0};
+    }
+    Out operator()(const UUID&) {
+        return {value::TypeTags::Nothing, 0};
+    }
+};
+
+/**
+ * Decodes 'cell' into an owned SBE value if it holds a single scalar with no array along its path,
+ * which is the only case where a predicate on the cell gives the same result as on the document.
+ * Returns Nothing otherwise.
+ */
+std::pair<value::TypeTags, value::Value> decodeScalarCell(CellView cell) {
+    auto split = SplitCellView::parse(cell);
+    if (split.hasSubObjects || !split.arrInfo.empty()) {
+        return {value::TypeTags::Nothing, 0};
+    }
+
+    const char* ptr = split.firstElementPtr;
+    auto [tag, val] = SplitCellView::decodeAndAdvance(ptr, CellValueEncoder{});
+    if (ptr != split.arrInfo.rawData()) {
+        value::releaseValue(tag, val);
+        return {value::TypeTags::Nothing, 0};
+    }
+    return {tag, val};
+}
+}  // namespace
+
 ColumnScanStage::ColumnScanStage(UUID collectionUuid,
                                  StringData columnIndexName,
                                  value::SlotVector fieldSlots,
@@ -44,6 +118,9 @@ ColumnScanStage::ColumnScanStage(UUID collectionUuid,
                                  std::unique_ptr<EExpression> recordExpr,
                                  std::vector<std::unique_ptr<EExpression>> pathExprs,
                                  value::SlotId rowStoreSlot,
+                                 std::vector<PathFilter> filteredPaths,
+                                 value::SlotId cellSlot,
+                                 const ColumnStore* columnStore,
                                  PlanYieldPolicy* yieldPolicy,
                                  PlanNodeId nodeId)
     : PlanStage("columnscan"_sd, yieldPolicy, nodeId),
@@ -55,7 +132,10 @@ ColumnScanStage::ColumnScanStage(UUID collectionUuid,
       _recordIdSlot(recordIdSlot),
       _recordExpr(std::move(recordExpr)),
       _pathExprs(std::move(pathExprs)),
-      _rowStoreSlot(rowStoreSlot) {
+      _rowStoreSlot(rowStoreSlot),
+      _filteredPaths(std::move(filteredPaths)),
+      _cellSlot(cellSlot),
+      _columnStore(columnStore) {
     invariant(_fieldSlots.size() == _paths.size());
     invariant(_fieldSlots.size() == _pathExprs.size());
 }
@@ -65,6 +145,13 @@ std::unique_ptr<PlanStage> ColumnScanStage::clone() const {
     for (auto& expr : _pathExprs) {
         pathExprs.emplace_back(expr->clone());
     }
+    std::vector<PathFilter> filteredPaths;
+    for (auto& filter : _filteredPaths) {
+        filteredPaths.emplace_back(filter.path,
+                                   filter.filterExpr->clone(),
+                                   filter.cellFilterExpr ? filter.cellFilterExpr->clone()
+                                                         : nullptr);
+    }
     return std::make_unique<ColumnScanStage>(_collUuid,
                                              _columnIndexName,
                                              _fieldSlots,
@@ -74,6 +161,9 @@ std::unique_ptr<PlanStage> ColumnScanStage::clone() const {
                                              _recordExpr ? _recordExpr->clone() : nullptr,
                                              std::move(pathExprs),
                                              _rowStoreSlot,
+                                             std::move(filteredPaths),
+                                             _cellSlot,
+                                             _columnStore,
                                              _yieldPolicy,
                                              _commonStats.nodeId);
 }
@@ -94,6 +184,7 @@ void ColumnScanStage::prepare(CompileCtx& ctx) {
     }
 
     _rowStoreAccessor = std::make_unique<value::OwnedValueAccessor>();
+    _cellAccessor = std::make_unique<value::OwnedValueAccessor>();
     if (_recordExpr) {
         ctx.root = this;
         _recordExprCode = _recordExpr->compile(ctx);
@@ -102,6 +193,14 @@ void ColumnScanStage::prepare(CompileCtx& ctx) {
         ctx.root = this;
         _pathExprsCode.emplace_back(expr->compile(ctx));
     }
+    for (auto& filter : _filteredPaths) {
+        ctx.root = this;
+        _filterExprsCode.emplace_back(filter.filterExpr->compile(ctx));
+        ctx.root = this;
+        _cellFilterExprsCode.emplace_back(
+            filter.cellFilterExpr ? filter.cellFilterExpr->compile(ctx) : nullptr);
+    }
+    _filtersToCheck.resize(_filteredPaths.size(), true);
 
     tassert(6298602, "'_coll' should not be initialized prior to 'acquireCollection()'", !_coll);
     std::tie(_coll, _collName, _catalogEpoch) = acquireCollection(_opCtx, _collUuid);
@@ -123,6 +222,10 @@ value::SlotAccessor* ColumnScanStage::getAccessor(CompileCtx& ctx, value::SlotId
     if (_rowStoreSlot == slot) {
         return _rowStoreAccessor.get();
     }
+
+    if (_cellSlot == slot) {
+        return _cellAccessor.get();
+    }
     return ctx.getAccessor(slot);
 }
 
@@ -135,6 +238,12 @@ void ColumnScanStage::doSaveState(bool relinquishCursor) {
         _cursor->setSaveStorageCursorOnDetachFromOperationContext(!relinquishCursor);
     }
 
+    if (relinquishCursor) {
+        for (auto& cursor : _columnCursors) {
+            cursor->save();
+        }
+    }
+
     _coll.reset();
 }
 
@@ -156,18 +265,30 @@ void ColumnScanStage::doRestoreState(bool relinquishCursor) {
             invariant(couldRestore);
         }
     }
+
+    if (relinquishCursor) {
+        for (auto& cursor : _columnCursors) {
+            cursor->restore();
+        }
+    }
 }
 
 void ColumnScanStage::doDetachFromOperationContext() {
     if (_cursor) {
         _cursor->detachFromOperationContext();
     }
+    for (auto& cursor : _columnCursors) {
+        cursor->detachFromOperationContext();
+    }
 }
 
 void ColumnScanStage::doAttachToOperationContext(OperationContext* opCtx) {
     if (_cursor) {
         _cursor->reattachToOperationContext(opCtx);
     }
+    for (auto& cursor : _columnCursors) {
+        cursor->reattachToOperationContext(opCtx);
+    }
 }
 
 void ColumnScanStage::doDetachFromTrialRunTracker() {
@@ -206,6 +327,20 @@ void ColumnScanStage::open(bool reOpen) {
         _cursor = _coll->getCursor(_opCtx, true);
     }
 
+    if (_columnStore && _columnCursors.empty()) {
+        // Only the paths whose predicate can run on the cells need a cursor. The others are
+        // checked once the row is read from the row store.
+        for (size_t idx = 0; idx < _filteredPaths.size(); ++idx) {
+            if (_cellFilterExprsCode[idx]) {
+                _columnCursors.emplace_back(
+                    _columnStore->newCursor(_opCtx, _filteredPaths[idx].path));
+            }
+        }
+        if (_columnCursors.empty()) {
+            _columnCursors.emplace_back(_columnStore->newCursor(_opCtx, ColumnStore::kRowIdPath));
+        }
+    }
+
     _open = true;
     _firstGetNext = true;
 }
@@ -217,29 +352,24 @@ PlanState ColumnScanStage::getNext() {
     // case it yields as the state will be completely overwritten after the next() call.
     disableSlotAccess();
 
-    // This call to checkForInterrupt() may result in a call to save() or restore() on the entire
-    // PlanStage tree if a yield occurs. It's important that we call checkForInterrupt() before
-    // checking '_needsToCheckCappedPositionLost' since a call to restoreState() may set
-    // '_needsToCheckCappedPositionLost'.
-    checkForInterrupt(_opCtx);
-
-    auto nextRecord = _cursor->next();
-    _firstGetNext = false;
+    // Keep reading rows until one passes the predicates on the filtered paths. The rejected rows
+    // are never assembled.
+    do {
+        const bool hasRecord = _columnStore ? nextColumnStoreRecord() : nextRowStoreRecord();
+        _firstGetNext = false;
 
-    if (!nextRecord) {
-        return trackPlanState(PlanState::IS_EOF);
-    }
+        if (!hasRecord) {
+            return trackPlanState(PlanState::IS_EOF);
+        }
+        ++_numRowsAssembled;
+    } while (!passesFilters(_filtersToCheck));
 
     if (_recordIdAccessor) {
-        _recordId = nextRecord->id;
+        _recordId = _record->id;
         _recordIdAccessor->reset(
             false, value::TypeTags::RecordId, value::bitcastFrom<RecordId*>(&_recordId));
     }
 
-    _rowStoreAccessor->reset(false,
-                             value::TypeTags::bsonObject,
-                             value::bitcastFrom<const char*>(nextRecord->data.data()));
-
     if (_recordExpr) {
         auto [owned, tag, val] = _bytecode.run(_recordExprCode.get());
         _recordAccessor->reset(owned, tag, val);
@@ -250,6 +380,116 @@ PlanState ColumnScanStage::getNext() {
         _outputFields[idx].reset(owned, tag, val);
     }
 
+    return trackPlanState(PlanState::ADVANCED);
+}
+
+bool ColumnScanStage::nextRowStoreRecord() {
+    // This call to checkForInterrupt() may result in a call to save() or restore() on the entire
+    // PlanStage tree if a yield occurs.
+    checkForInterrupt(_opCtx);
+
+    _record = _cursor->next();
+    if (!_record) {
+        return false;
+    }
+
+    _rowStoreAccessor->reset(
+        false, value::TypeTags::bsonObject, value::bitcastFrom<const char*>(_record->data.data()));
+    trackRead();
+    return true;
+}
+
+bool ColumnScanStage::nextColumnStoreRecord() {
+    // The first cursor proposes a RecordId, which every other cursor must then hold a passing cell
+    // for. A cursor landing past the candidate means that the path is missing from the rows in
+    // between, so the scan jumps straight to the RecordId that cursor landed on.
+    auto& leadCursor = _columnCursors[0];
+    boost::optional<RecordId> seekTo;
+    bool advance = !_firstGetNext;
+    while (true) {
+        // This call to checkForInterrupt() may result in a call to save() or restore() on the
+        // entire PlanStage tree if a yield occurs, so it must happen before any cell is read.
+        checkForInterrupt(_opCtx);
+
+        boost::optional<FullCellView> leadCell;
+        if (seekTo) {
+            leadCell = leadCursor->seekAtOrPast(*seekTo);
+        } else if (advance) {
+            leadCell = leadCursor->next();
+        } else {
+            leadCell = leadCursor->seekAtOrPast(RecordId());
+        }
+        if (!leadCell) {
+            return false;
+        }
+        ++_numCellsScanned;
+        trackRead();
+
+        const RecordId candidate = leadCell->rid;
+        std::fill(_filtersToCheck.begin(), _filtersToCheck.end(), false);
+        seekTo = boost::none;
+        advance = true;
+
+        bool rejected = false;
+        for (size_t idx = 0, cursorIdx = 0; idx < _filteredPaths.size() && !rejected; ++idx) {
+            if (!_cellFilterExprsCode[idx]) {
+                _filtersToCheck[idx] = true;
+                continue;
+            }
+
+            auto cell = leadCell;
+            if (cursorIdx++ > 0) {
+                cell = _columnCursors[cursorIdx - 1]->seekAtOrPast(candidate);
+                if (!cell) {
+                    return false;
+                }
+                ++_numCellsScanned;
+                trackRead();
+                if (cell->rid != candidate) {
+                    seekTo = cell->rid;
+                    rejected = true;
+                    break;
+                }
+            }
+
+            auto result = filterCell(idx, cell->value);
+            rejected = result == CellFilterResult::kFail;
+            _filtersToCheck[idx] = result == CellFilterResult::kUnknown;
+        }
+
+        if (rejected) {
+            ++_numRowsFiltered;
+            continue;
+        }
+
+        _record = _cursor->seekExact(candidate);
+        if (!_record) {
+            // The cells of a row removed from the row store in the same snapshot are removed too,
+            // so this only happens if the stores are out of sync. Skip the row rather than produce
+            // a partial one.
+            continue;
+        }
+
+        _rowStoreAccessor->reset(false,
+                                 value::TypeTags::bsonObject,
+                                 value::bitcastFrom<const char*>(_record->data.data()));
+        trackRead();
+        return true;
+    }
+}
+
+ColumnScanStage::CellFilterResult ColumnScanStage::filterCell(size_t idx, CellView cell) {
+    auto [tag, val] = decodeScalarCell(cell);
+    if (tag == value::TypeTags::Nothing) {
+        return CellFilterResult::kUnknown;
+    }
+
+    _cellAccessor->reset(true, tag, val);
+    return _bytecode.runPredicate(_cellFilterExprsCode[idx].get()) ? CellFilterResult::kPass
+                                                                  : CellFilterResult::kFail;
+}
+
+void ColumnScanStage::trackRead() {
     ++_specificStats.numReads;
     if (_tracker && _tracker->trackProgress<TrialRunTracker::kNumReads>(1)) {
         // If we're collecting execution stats during multi-planning and reached the end of the
@@ -260,13 +500,23 @@ PlanState ColumnScanStage::getNext() {
         _tracker = nullptr;
         uasserted(ErrorCodes::QueryTrialRunCompleted, "Trial run early exit in scan");
     }
-    return trackPlanState(PlanState::ADVANCED);
+}
+
+bool ColumnScanStage::passesFilters(const std::vector<bool>& filtersToCheck) {
+    for (size_t idx = 0; idx < _filterExprsCode.size(); ++idx) {
+        if (filtersToCheck[idx] && !_bytecode.runPredicate(_filterExprsCode[idx].get())) {
+            ++_numRowsFiltered;
+            return false;
+        }
+    }
+    return true;
 }
 
 void ColumnScanStage::close() {
     auto optTimer(getOptTimer(_opCtx));
 
     trackClose();
+    _columnCursors.clear();
     _cursor.reset();
     _coll.reset();
     _open = false;
@@ -284,6 +534,19 @@ std::unique_ptr<PlanStageStats> ColumnScanStage::getStats(bool includeDebugInfo)
         bob.append("paths", _paths);
         bob.append("outputSlots", _fieldSlots.begin(), _fieldSlots.end());
 
+        if (!_filteredPaths.empty()) {
+            BSONArrayBuilder filteredPathsBob(bob.subarrayStart("filteredPaths"));
+            for (auto& filter : _filteredPaths) {
+                filteredPathsBob.append(filter.path);
+            }
+            filteredPathsBob.doneFast();
+            bob.appendNumber("numRowsFiltered", static_cast<long long>(_numRowsFiltered));
+        }
+        if (_columnStore) {
+            bob.appendNumber("numCellsScanned", static_cast<long long>(_numCellsScanned));
+        }
+        bob.appendNumber("numRowsAssembled", static_cast<long long>(_numRowsAssembled));
+
         ret->debugInfo = bob.obj();
     }
     return ret;
@@ -330,6 +593,21 @@ std::vector<DebugPrinter::Block> ColumnScanStage::debugPrint() const {
     }
     ret.emplace_back(DebugPrinter::Block("`]"));
 
+    // Print out the filtered paths, if any.
+    if (!_filteredPaths.empty()) {
+        ret.emplace_back(DebugPrinter::Block("[`"));
+        for (size_t idx = 0; idx < _filteredPaths.size(); ++idx) {
+            if (idx) {
+                ret.emplace_back(DebugPrinter::Block("`,"));
+            }
+
+            ret.emplace_back(str::stream() << "\"" << _filteredPaths[idx].path << "\"");
+            ret.emplace_back("=");
+            DebugPrinter::addBlocks(ret, _filteredPaths[idx].filterExpr->debugPrint());
+        }
+        ret.emplace_back(DebugPrinter::Block("`]"));
+    }
+
     ret.emplace_back("@\"`");
     DebugPrinter::addIdentifier(ret, _collUuid.toString());
     ret.emplace_back("`\"");
@@ -345,6 +623,11 @@ size_t ColumnScanStage::estimateCompileTimeSize() const {
     size_t size = sizeof(*this);
     size += size_estimator::estimate(_fieldSlots);
     size += size_estimator::estimate(_paths);
+    for (auto& filter : _filteredPaths) {
+        size += size_estimator::estimate(filter.path);
+        size += filter.filterExpr->estimateSize();
+        size += filter.cellFilterExpr ? filter.cellFilterExpr->estimateSize() : 0;
+    }
     size += size_estimator::estimate(_specificStats);
     return size;
 }
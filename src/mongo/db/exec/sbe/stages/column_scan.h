@@ -33,15 +33,44 @@
 #include "mongo/db/exec/sbe/expressions/expression.h"
 #include "mongo/db/exec/sbe/stages/collection_helpers.h"
 #include "mongo/db/exec/sbe/stages/stages.h"
+#include "mongo/db/storage/column_store.h"
 
 namespace mongo {
 namespace sbe {
 /**
  * A stage that scans provided columnar index. A set of paths is retrieved from the index and values
  * are put in output slots.
+ *
+ * Each of the 'filteredPaths' holds a predicate on a single path which is evaluated before any of
+ * the output values or the output record are produced. Rows which fail one of the predicates are
+ * skipped without being assembled.
+ *
+ * When a 'columnStore' is provided, the scan is driven by one cursor per filtered path. The
+ * 'cellFilterExpr' of a path is evaluated on the value decoded from the cell returned by the cursor
+ * of that path, which is bound to 'cellSlot'. When a cell fails its predicate, or a path has no
+ * cell for the current RecordId, the cursors are advanced past that RecordId and the row is never
+ * read from the row store. Cells which cannot be decoded into a single scalar, and paths without a
+ * 'cellFilterExpr', are instead checked by running 'filterExpr' against the row store document held
+ * in 'rowStoreSlot' once the row is fetched. Without a 'columnStore', all of the rows are read from
+ * the row store and only the 'filterExpr's are used.
  */
 class ColumnScanStage final : public PlanStage {
 public:
+    struct PathFilter {
+        PathFilter(std::string path,
+                   std::unique_ptr<EExpression> filterExpr,
+                   std::unique_ptr<EExpression> cellFilterExpr)
+            : path(std::move(path)),
+              filterExpr(std::move(filterExpr)),
+              cellFilterExpr(std::move(cellFilterExpr)) {}
+
+        std::string path;
+        // The predicate evaluated against the row store document.
+        std::unique_ptr<EExpression> filterExpr;
+        // The same predicate evaluated against a scalar decoded from a cell, if it can be.
+        std::unique_ptr<EExpression> cellFilterExpr;
+    };
+
     ColumnScanStage(UUID collectionUuid,
                     StringData columnIndexName,
                     value::SlotVector fieldSlots,
@@ -51,6 +80,9 @@ public:
                     std::unique_ptr<EExpression> internalExpr,
                     std::vector<std::unique_ptr<EExpression>> pathExprs,
                     value::SlotId internalSlot,
+                    std::vector<PathFilter> filteredPaths,
+                    value::SlotId cellSlot,
+                    const ColumnStore* columnStore,
                     PlanYieldPolicy* yieldPolicy,
                     PlanNodeId nodeId);
 
@@ -77,6 +109,39 @@ protected:
         TrialRunTracker* tracker, TrialRunTrackerAttachResultMask childrenAttachResult) override;
 
 private:
+    // The result of evaluating the predicate of a filtered path on a single cell.
+    enum class CellFilterResult { kPass, kFail, kUnknown };
+
+    /**
+     * Returns true if the current row passes the predicates on all of the filtered paths whose bit
+     * is set in 'filtersToCheck'.
+     */
+    bool passesFilters(const std::vector<bool>& filtersToCheck);
+
+    /**
+     * Reads the next row from the row store and leaves it in '_rowStoreAccessor', or returns false
+     * at EOF.
+     */
+    bool nextRowStoreRecord();
+
+    /**
+     * Positions the column store cursors on the next RecordId whose cells pass all of the
+     * predicates that can be evaluated on cells, then fetches that row from the row store. The
+     * filtered paths whose predicate still needs to run against the row are flagged in
+     * '_filtersToCheck'. Returns false at EOF.
+     */
+    bool nextColumnStoreRecord();
+
+    /**
+     * Evaluates the predicate of the filtered path 'idx' on 'cell'.
+     */
+    CellFilterResult filterCell(size_t idx, CellView cell);
+
+    /**
+     * Accounts for one read from either store, ending the trial run if its budget is exhausted.
+     */
+    void trackRead();
+
     const UUID _collUuid;
     const std::string _columnIndexName;
     const value::SlotVector _fieldSlots;
@@ -90,6 +155,12 @@ private:
     const std::vector<std::unique_ptr<EExpression>> _pathExprs;
     // An internal slot that points to the row store document.
     const value::SlotId _rowStoreSlot;
+    // Predicates on single paths, evaluated before the row is assembled.
+    const std::vector<PathFilter> _filteredPaths;
+    // An internal slot that points to the value decoded from a cell of a filtered path.
+    const value::SlotId _cellSlot;
+    // The column store holding the cells of the filtered paths, if any.
+    const ColumnStore* const _columnStore;
 
     std::vector<value::OwnedValueAccessor> _outputFields;
     value::SlotAccessorMap _outputFieldsMap;
@@ -99,6 +170,9 @@ private:
     std::unique_ptr<vm::CodeFragment> _recordExprCode;
     std::vector<std::unique_ptr<vm::CodeFragment>> _pathExprsCode;
     std::unique_ptr<value::OwnedValueAccessor> _rowStoreAccessor;
+    std::vector<std::unique_ptr<vm::CodeFragment>> _filterExprsCode;
+    std::unique_ptr<value::OwnedValueAccessor> _cellAccessor;
+    std::vector<std::unique_ptr<vm::CodeFragment>> _cellFilterExprsCode;
 
     vm::ByteCode _bytecode;
 
@@ -111,6 +185,13 @@ private:
 
     std::unique_ptr<SeekableRecordCursor> _cursor;
 
+    // With a column store, the cursors of the filtered paths, or a single cursor over all of the
+    // RecordIds if no path is filtered. The first cursor drives the scan.
+    std::vector<std::unique_ptr<ColumnStore::CursorForPath>> _columnCursors;
+    // Whether the row store predicate of each filtered path must run on the current row.
+    std::vector<bool> _filtersToCheck;
+
+    boost::optional<Record> _record;
     RecordId _recordId;
 
     bool _open{false};
@@ -121,6 +202,12 @@ private:
     TrialRunTracker* _tracker{nullptr};
 
     ScanStats _specificStats;
+
+    // The number of rows rejected by the predicates on the filtered paths.
+    size_t _numRowsFiltered{0};
+    // The number of cells read from the column store, and of rows read from the row store.
+    size_t _numCellsScanned{0};
+    size_t _numRowsAssembled{0};
 };
 }  // namespace sbe
 }  // namespace mongo
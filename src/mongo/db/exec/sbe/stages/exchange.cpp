@@ -35,6 +35,7 @@
 #include "mongo/db/client.h"
 #include "mongo/db/concurrency/d_concurrency.h"
 #include "mongo/db/exec/sbe/size_estimator.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo::sbe {
 std::unique_ptr<ThreadPool> s_globalThreadPool;
@@ -49,6 +50,15 @@ MONGO_INITIALIZER(s_globalThreadPool)(InitializerContext* context) {
     s_globalThreadPool->startup();
 }
 
+namespace {
+// Set while an exchange consumer clones its subtree for the producers.
+thread_local bool cloningForExchangeProducers = false;
+}  // namespace
+
+bool isCloningForExchangeProducers() {
+    return cloningForExchangeProducers;
+}
+
 ExchangePipe::ExchangePipe(size_t size) {
     // All buffers start empty.
     _fullCount = 0;
@@ -192,7 +202,24 @@ ExchangeConsumer::ExchangeConsumer(std::shared_ptr<ExchangeState> state, PlanNod
     _orderPreserving = _state->isOrderPreserving();
 }
 std::unique_ptr<PlanStage> ExchangeConsumer::clone() const {
-    return std::make_unique<ExchangeConsumer>(_state, _commonStats.nodeId);
+    if (isCloningForExchangeProducers()) {
+        return std::make_unique<ExchangeConsumer>(_state, _commonStats.nodeId);
+    }
+
+    // Any other clone gets its own exchange state, so that it can be opened independently of this
+    // consumer. Only consumer ID 0 owns the subtree, and only until it is opened.
+    tassert(7131320,
+            "Only an exchange consumer that has not been opened can be cloned",
+            !_children.empty());
+    auto partition = _state->partitionExpr();
+    auto orderLess = _state->orderLessExpr();
+    return std::make_unique<ExchangeConsumer>(_children[0]->clone(),
+                                              _state->numOfProducers(),
+                                              _state->fields(),
+                                              _state->policy(),
+                                              partition ? partition->clone() : nullptr,
+                                              orderLess ? orderLess->clone() : nullptr,
+                                              _commonStats.nodeId);
 }
 void ExchangeConsumer::prepare(CompileCtx& ctx) {
     for (size_t idx = 0; idx < _state->fields().size(); ++idx) {
@@ -260,6 +287,8 @@ void ExchangeConsumer::open(bool reOpen) {
             PlanStage* masterSubTree = _children[0].get();
             masterSubTree->detachFromOperationContext();
 
+            cloningForExchangeProducers = true;
+            ON_BLOCK_EXIT([] { cloningForExchangeProducers = false; });
             for (size_t idx = 0; idx < _state->numOfProducers(); ++idx) {
                 if (idx == 0) {
                     _state->producerPlans().emplace_back(std::make_unique<ExchangeProducer>(
@@ -44,6 +44,14 @@ class ExchangeProducer;
 
 enum class ExchangePolicy { broadcast, roundrobin, hashpartition, rangepartition };
 
+/**
+ * Returns true while the calling thread clones the subtree of an exchange for its producers. Stages
+ * that share runtime state between their clones, like the exchange itself or the ParallelScanStage,
+ * only do so for these clones. Any other clone, e.g. one made for the plan cache or for a trial run
+ * of a candidate plan, is an independent copy of the plan.
+ */
+bool isCloningForExchangeProducers();
+
 // A unit of exchange between a consumer and a producer
 class ExchangeBuffer {
 public:
@@ -220,6 +228,10 @@ public:
         return _partition.get();
     }
 
+    auto orderLessExpr() const {
+        return _orderLess.get();
+    }
+
     ExchangePipe* pipe(size_t consumerTid, size_t producerTid);
 
     size_t estimateCompileTimeSize() const;
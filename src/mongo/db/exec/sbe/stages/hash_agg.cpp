@@ -206,18 +206,6 @@ value::SlotAccessor* HashAggStage::getAccessor(CompileCtx& ctx, value::SlotId sl
 }
 
 namespace {
-// Proactively assert that this operation can safely write before hitting an assertion in the
-// storage engine. We can safely write if we are enforcing prepare conflicts by blocking or if we
-// are ignoring prepare conflicts and explicitly allowing writes. Ignoring prepare conflicts
-// without allowing writes will cause this operation to fail in the storage engine.
-void assertIgnorePrepareConflictsBehavior(OperationContext* opCtx) {
-    tassert(5907502,
-            "The operation must be ignoring conflicts and allowing writes or enforcing prepare "
-            "conflicts entirely",
-            opCtx->recoveryUnit()->getPrepareConflictBehavior() !=
-                PrepareConflictBehavior::kIgnoreConflicts);
-}
-
 /**
  * This helper takes the 'rid' RecordId (the group-by key) and rehydrates it into a KeyString::Value
  * from the typeBits.
@@ -316,8 +304,7 @@ void HashAggStage::checkMemoryUsageAndSpillIfNecessary(MemoryCheckData& mcd) {
         return;
     }
 
-    mcd.memoryCheckpointCounter++;
-    if (mcd.memoryCheckpointCounter >= mcd.nextMemoryCheckpoint) {
+    if (mcd.needsMemoryCheck()) {
         if (_htIt == _ht->end()) {
             _htIt = _ht->begin();
         }
@@ -325,8 +312,7 @@ void HashAggStage::checkMemoryUsageAndSpillIfNecessary(MemoryCheckData& mcd) {
             _htIt->first.memUsageForSorter() + _htIt->second.memUsageForSorter();
         long long estimatedTotalSize = _ht->size() * estimatedRowSize;
         const double estimatedGainPerChildAdvance =
-            (static_cast<double>(estimatedTotalSize - mcd.lastEstimatedMemoryUsage) /
-             mcd.memoryCheckpointCounter);
+            mcd.estimateGainPerChildAdvance(estimatedTotalSize);
 
         if (estimatedTotalSize >= _approxMemoryUseInBytesBeforeSpill) {
             uassert(ErrorCodes::QueryExceededMemoryLimitNoDiskUseAllowed,
@@ -348,25 +334,10 @@ void HashAggStage::checkMemoryUsageAndSpillIfNecessary(MemoryCheckData& mcd) {
             estimatedTotalSize = _ht->size() * estimatedRowSize;
         }
 
-        // Calculate the next memory checkpoint. We estimate it based on the prior growth of the
-        // '_ht' and the remaining available memory. We have to keep doing this even after starting
-        // to spill because some accumulators can grow in size inside '_ht' (with no bounds).
-        // Value of 'estimatedGainPerChildAdvance' can be negative if the previous checkpoint
-        // evicted any records. And a value close to zero indicates a stable size of '_ht' so can
-        // delay the next check progressively.
-        const long nextCheckpointCandidate = (estimatedGainPerChildAdvance > 0.1)
-            ? mcd.checkpointMargin * (_approxMemoryUseInBytesBeforeSpill - estimatedTotalSize) /
-                estimatedGainPerChildAdvance
-            : (estimatedGainPerChildAdvance < -0.1) ? mcd.atMostCheckFrequency
-                                                    : mcd.nextMemoryCheckpoint * 2;
-        mcd.nextMemoryCheckpoint =
-            std::min<long>(mcd.memoryCheckFrequency,
-                           std::max<long>(mcd.atMostCheckFrequency, nextCheckpointCandidate));
-
-        mcd.lastEstimatedMemoryUsage = estimatedTotalSize;
-        mcd.memoryCheckpointCounter = 0;
-        mcd.memoryCheckFrequency =
-            std::min<long>(mcd.memoryCheckFrequency * 2, mcd.atLeastMemoryCheckFrequency);
+        // Some accumulators can grow in size inside '_ht' (with no bounds), so we have to keep
+        // scheduling checks even after starting to spill.
+        mcd.scheduleNextCheckpoint(
+            estimatedGainPerChildAdvance, estimatedTotalSize, _approxMemoryUseInBytesBeforeSpill);
     }
 }
 
@@ -33,6 +33,7 @@
 
 #include "mongo/db/exec/sbe/expressions/expression.h"
 #include "mongo/db/exec/sbe/stages/stages.h"
+#include "mongo/db/exec/sbe/util/spilling.h"
 #include "mongo/db/exec/sbe/vm/vm.h"
 #include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/db/storage/temporary_record_store.h"
@@ -139,29 +140,6 @@ private:
      * 'checkMemoryUsageAndSpillIfNecessary()' will create '_recordStore' and might spill some of
      * the already accumulated data into it.
      */
-    struct MemoryCheckData {
-        const double checkpointMargin = internalQuerySBEAggMemoryUseCheckMargin.load();
-        const long atMostCheckFrequency = internalQuerySBEAggMemoryCheckPerAdvanceAtMost.load();
-        const long atLeastMemoryCheckFrequency =
-            internalQuerySBEAggMemoryCheckPerAdvanceAtLeast.load();
-
-        // The check frequency upper bound, which start at 'atMost' and exponentially backs off
-        // to 'atLeast' as more data is accumulated. If 'atLeast' is less than 'atMost', the memory
-        // checks will be done every 'atLeast' incoming records.
-        long memoryCheckFrequency = 1;
-
-        // The number of incoming records to process before the next memory checkpoint.
-        long nextMemoryCheckpoint = 0;
-
-        // The counter of the incoming records between memory checkpoints.
-        long memoryCheckpointCounter = 0;
-
-        long long lastEstimatedMemoryUsage = 0;
-
-        MemoryCheckData() {
-            memoryCheckFrequency = std::min(atMostCheckFrequency, atLeastMemoryCheckFrequency);
-        }
-    };
     void checkMemoryUsageAndSpillIfNecessary(MemoryCheckData& mcd);
 
     const value::SlotVector _gbs;
@@ -33,6 +33,8 @@
 
 #include "mongo/db/exec/sbe/expressions/expression.h"
 #include "mongo/db/exec/sbe/size_estimator.h"
+#include "mongo/db/storage/storage_engine.h"
+#include "mongo/db/storage/write_unit_of_work.h"
 #include "mongo/util/str.h"
 
 namespace mongo {
@@ -44,6 +46,7 @@ HashJoinStage::HashJoinStage(std::unique_ptr<PlanStage> outer,
                              value::SlotVector innerCond,
                              value::SlotVector innerProjects,
                              boost::optional<value::SlotId> collatorSlot,
+                             bool allowDiskUse,
                              PlanNodeId planNodeId)
     : PlanStage("hj"_sd, planNodeId),
       _outerCond(std::move(outerCond)),
@@ -51,7 +54,8 @@ HashJoinStage::HashJoinStage(std::unique_ptr<PlanStage> outer,
       _innerCond(std::move(innerCond)),
       _innerProjects(std::move(innerProjects)),
       _collatorSlot(collatorSlot),
-      _probeKey(0) {
+      _probeKey(0),
+      _allowDiskUse(allowDiskUse) {
     if (_outerCond.size() != _innerCond.size()) {
         uasserted(4822823, "left and right size do not match");
     }
@@ -68,9 +72,41 @@ std::unique_ptr<PlanStage> HashJoinStage::clone() const {
                                            _innerCond,
                                            _innerProjects,
                                            _collatorSlot,
+                                           _allowDiskUse,
                                            _commonStats.nodeId);
 }
 
+void HashJoinStage::doSaveState(bool relinquishCursor) {
+    if (relinquishCursor) {
+        if (_rsCursor) {
+            _rsCursor->save();
+        }
+    }
+    if (_rsCursor) {
+        _rsCursor->setSaveStorageCursorOnDetachFromOperationContext(!relinquishCursor);
+    }
+}
+
+void HashJoinStage::doRestoreState(bool relinquishCursor) {
+    invariant(_opCtx);
+    if (_rsCursor && relinquishCursor) {
+        auto couldRestore = _rsCursor->restore();
+        uassert(7131200, "HashJoinStage could not restore cursor", couldRestore);
+    }
+}
+
+void HashJoinStage::doDetachFromOperationContext() {
+    if (_rsCursor) {
+        _rsCursor->detachFromOperationContext();
+    }
+}
+
+void HashJoinStage::doAttachToOperationContext(OperationContext* opCtx) {
+    if (_rsCursor) {
+        _rsCursor->reattachToOperationContext(opCtx);
+    }
+}
+
 void HashJoinStage::prepare(CompileCtx& ctx) {
     _children[0]->prepare(ctx);
     _children[1]->prepare(ctx);
@@ -93,12 +129,38 @@ void HashJoinStage::prepare(CompileCtx& ctx) {
         _outOuterAccessors[slot] = _outOuterKeyAccessors.back().get();
     }
 
+    // The inner side slots are produced either by the inner child directly, or from the inner
+    // rows read back from the '_recordStore' when the join is partitioned. A SwitchAccessor allows
+    // toggling between the two so the parent stage can read them through '_outInnerAccessors'.
+    auto makeInnerSwitchAccessor = [&](value::SlotId slot,
+                                       value::SlotAccessor* childAccessor,
+                                       value::MaterializedRow& spilledRow,
+                                       size_t idx) {
+        _outSpilledInnerAccessors.emplace_back(
+            std::make_unique<value::MaterializedSingleRowAccessor>(spilledRow, idx));
+        _outInnerSwitchAccessors.emplace_back(
+            std::make_unique<value::SwitchAccessor>(std::vector<value::SlotAccessor*>{
+                childAccessor, _outSpilledInnerAccessors.back().get()}));
+        _outInnerAccessors.emplace(slot, _outInnerSwitchAccessors.back().get());
+    };
+
     counter = 0;
     for (auto& slot : _innerCond) {
         auto [it, inserted] = dupCheck.emplace(slot);
         uassert(4822825, str::stream() << "duplicate field: " << slot, inserted);
 
         _inInnerKeyAccessors.emplace_back(_children[1]->getAccessor(ctx, slot));
+        makeInnerSwitchAccessor(slot, _inInnerKeyAccessors.back(), _spilledInnerKey, counter++);
+    }
+
+    counter = 0;
+    for (auto& slot : _innerProjects) {
+        _inInnerProjectAccessors.emplace_back(_children[1]->getAccessor(ctx, slot));
+        if (!_outInnerAccessors.contains(slot)) {
+            makeInnerSwitchAccessor(
+                slot, _inInnerProjectAccessors.back(), _spilledInnerProject, counter);
+        }
+        counter++;
     }
 
     counter = 0;
@@ -113,6 +175,8 @@ void HashJoinStage::prepare(CompileCtx& ctx) {
     }
 
     _probeKey.resize(_inInnerKeyAccessors.size());
+    _spilledInnerKey.resize(_inInnerKeyAccessors.size());
+    _spilledInnerProject.resize(_inInnerProjectAccessors.size());
 
     _compiled = true;
 }
@@ -122,6 +186,9 @@ value::SlotAccessor* HashJoinStage::getAccessor(CompileCtx& ctx, value::SlotId s
         if (auto it = _outOuterAccessors.find(slot); it != _outOuterAccessors.end()) {
             return it->second;
         }
+        if (auto it = _outInnerAccessors.find(slot); it != _outInnerAccessors.end()) {
+            return it->second;
+        }
 
         return _children[1]->getAccessor(ctx, slot);
     }
@@ -129,24 +196,175 @@ value::SlotAccessor* HashJoinStage::getAccessor(CompileCtx& ctx, value::SlotId s
     return ctx.getAccessor(slot);
 }
 
-void HashJoinStage::open(bool reOpen) {
-    auto optTimer(getOptTimer(_opCtx));
-
+HashJoinStage::TableType HashJoinStage::makeHashTable() const {
     if (_collatorAccessor) {
         auto [tag, collatorVal] = _collatorAccessor->getViewOfValue();
         uassert(5402504, "collatorSlot must be of collator type", tag == value::TypeTags::collator);
         auto collatorView = value::getCollatorView(collatorVal);
         const value::MaterializedRowHasher hasher(collatorView);
         const value::MaterializedRowEq equator(collatorView);
-        _ht.emplace(0, hasher, equator);
-    } else {
-        _ht.emplace();
+        return TableType(0, hasher, equator);
+    }
+    return TableType();
+}
+
+void HashJoinStage::makeTemporaryRecordStore() {
+    tassert(
+        7131201,
+        "HashJoinStage attempted to write to disk in an environment which is not prepared to do so",
+        _opCtx->getServiceContext());
+    tassert(7131202,
+            "No storage engine so HashJoinStage cannot spill to disk",
+            _opCtx->getServiceContext()->getStorageEngine());
+    assertIgnorePrepareConflictsBehavior(_opCtx);
+    _recordStore = _opCtx->getServiceContext()->getStorageEngine()->makeTemporaryRecordStore(
+        _opCtx, KeyFormat::Long);
+
+    _partitionHasBuildRows.assign(_numSpillPartitions, false);
+    _specificStats.usedDisk = true;
+    _specificStats.numPartitions = _numSpillPartitions;
+}
+
+namespace {
+// The spilled records are keyed by a RecordId composed of the partition in the top bits, followed
+// by the side of the join and a sequence number. The partitions count is limited to 128 so the
+// RecordId is always positive.
+constexpr int kPartitionShift = 56;
+constexpr int kSideShift = 55;
+constexpr int64_t kSequenceMask = (int64_t{1} << kSideShift) - 1;
+
+// The number of bytes of spilled rows to accumulate before writing them to the record store.
+constexpr int kSpillBatchBytes = 1024 * 1024;
+}  // namespace
+
+size_t HashJoinStage::getPartition(const value::MaterializedRow& key) const {
+    // The hash table buckets are derived from the same hash, so mix it before choosing a partition
+    // to keep the keys of a single partition well distributed among the buckets.
+    const uint64_t hash = _ht->hash_function()(key);
+    return ((hash * 0x9E3779B97F4A7C15ULL) >> 32) % _numSpillPartitions;
+}
+
+void HashJoinStage::spillRowToDisk(SpillSide side,
+                                   const value::MaterializedRow& key,
+                                   const value::MaterializedRow& project) {
+    const auto partition = getPartition(key);
+    if (side == SpillSide::kBuild) {
+        _partitionHasBuildRows[partition] = true;
+    } else if (!_partitionHasBuildRows[partition]) {
+        // No row of the build side can match this key.
+        return;
+    }
+
+    const int64_t seq = ++_spilledRecordCounter;
+    tassert(7131203, "HashJoinStage spilled too many records", seq <= kSequenceMask);
+    const RecordId rid{(static_cast<int64_t>(partition) << kPartitionShift) |
+                       (static_cast<int64_t>(side) << kSideShift) | seq};
+
+    const int offset = _spillBuffer.len();
+    key.serializeForSorter(_spillBuffer);
+    project.serializeForSorter(_spillBuffer);
+    _spillBatch.push_back({rid, offset, _spillBuffer.len() - offset});
+
+    if (_spillBuffer.len() >= kSpillBatchBytes) {
+        flushSpilledRows();
+    }
+}
+
+void HashJoinStage::flushSpilledRows() {
+    if (_spillBatch.empty()) {
+        return;
+    }
+
+    std::vector<Record> records;
+    records.reserve(_spillBatch.size());
+    for (auto&& row : _spillBatch) {
+        records.push_back({row.rid, RecordData(_spillBuffer.buf() + row.offset, row.size)});
+    }
+
+    assertIgnorePrepareConflictsBehavior(_opCtx);
+
+    WriteUnitOfWork wuow(_opCtx);
+    auto status = _recordStore->rs()->insertRecords(
+        _opCtx, &records, std::vector<Timestamp>(records.size(), Timestamp{}));
+    wuow.commit();
+    tassert(7131204,
+            str::stream() << "Failed to write to disk because " << status.reason(),
+            status.isOK());
+
+    _specificStats.spilledRecords += _spillBatch.size();
+    _specificStats.spilledBytes += _spillBuffer.len();
+
+    _spillBatch.clear();
+    _spillBuffer.reset();
+}
+
+// Checks memory usage. Like in HashAggStage, the size of the hash table is estimated based on the
+// last inserted row. If the estimate exceeds the limit, every row of the build side accumulated so
+// far is moved to the spilled partitions, and the rest of the build side is spilled directly.
+void HashJoinStage::checkMemoryUsageAndSpillIfNecessary(MemoryCheckData& mcd) {
+    if (!_allowDiskUse || !mcd.needsMemoryCheck()) {
+        return;
+    }
+
+    const long estimatedRowSize =
+        _htIt->first.memUsageForSorter() + _htIt->second.memUsageForSorter();
+    const long long estimatedTotalSize = _ht->size() * estimatedRowSize;
+    const double estimatedGainPerChildAdvance = mcd.estimateGainPerChildAdvance(estimatedTotalSize);
+
+    if (estimatedTotalSize < _approxMemoryUseInBytesBeforeSpill) {
+        mcd.scheduleNextCheckpoint(
+            estimatedGainPerChildAdvance, estimatedTotalSize, _approxMemoryUseInBytesBeforeSpill);
+        return;
+    }
+
+    makeTemporaryRecordStore();
+    for (auto&& [key, project] : *_ht) {
+        spillRowToDisk(SpillSide::kBuild, key, project);
+    }
+    _ht->clear();
+    _htIt = _ht->end();
+}
+
+void HashJoinStage::open(bool reOpen) {
+    auto optTimer(getOptTimer(_opCtx));
+
+    _ht.emplace(makeHashTable());
+    _rsCursor.reset();
+    _recordStore.reset();
+    _spilledRecordCounter = 0;
+    _currentPartition = boost::none;
+    _innerSpilled = false;
+    for (auto&& accessor : _outInnerSwitchAccessors) {
+        accessor->setIndex(0);
     }
 
     _commonStats.opens++;
     _children[0]->open(reOpen);
+
+    MemoryCheckData memoryCheckData;
+    value::MaterializedRow spilledKey{_inOuterKeyAccessors.size()};
+    value::MaterializedRow spilledProject{_inOuterProjectAccessors.size()};
+
     // Insert the outer side into the hash table.
     while (_children[0]->getNext() == PlanState::ADVANCED) {
+        if (_recordStore) {
+            // The build side has been partitioned, so spill the row directly to its partition.
+            size_t idx = 0;
+            for (auto& p : _inOuterKeyAccessors) {
+                auto [tag, val] = p->getViewOfValue();
+                spilledKey.reset(idx++, false, tag, val);
+            }
+
+            idx = 0;
+            for (auto& p : _inOuterProjectAccessors) {
+                auto [tag, val] = p->getViewOfValue();
+                spilledProject.reset(idx++, false, tag, val);
+            }
+
+            spillRowToDisk(SpillSide::kBuild, spilledKey, spilledProject);
+            continue;
+        }
+
         value::MaterializedRow key{_inOuterKeyAccessors.size()};
         value::MaterializedRow project{_inOuterProjectAccessors.size()};
 
@@ -164,20 +382,105 @@ void HashJoinStage::open(bool reOpen) {
             project.reset(idx++, true, tag, val);
         }
 
-        _ht->emplace(std::move(key), std::move(project));
+        _htIt = _ht->emplace(std::move(key), std::move(project));
+
+        // Estimates how much memory is being used and might start spilling.
+        checkMemoryUsageAndSpillIfNecessary(memoryCheckData);
     }
 
     _children[0]->close();
 
+    if (_recordStore) {
+        flushSpilledRows();
+    }
+
     _children[1]->open(reOpen);
 
     _htIt = _ht->end();
     _htItEnd = _ht->end();
 }
 
+void HashJoinStage::spillInnerSide() {
+    value::MaterializedRow project{_inInnerProjectAccessors.size()};
+
+    while (_children[1]->getNext() == PlanState::ADVANCED) {
+        size_t idx = 0;
+        for (auto& p : _inInnerKeyAccessors) {
+            auto [tag, val] = p->getViewOfValue();
+            _probeKey.reset(idx++, false, tag, val);
+        }
+
+        idx = 0;
+        for (auto& p : _inInnerProjectAccessors) {
+            auto [tag, val] = p->getViewOfValue();
+            project.reset(idx++, false, tag, val);
+        }
+
+        spillRowToDisk(SpillSide::kProbe, _probeKey, project);
+    }
+    flushSpilledRows();
+
+    // From now on the inner side slots are produced from the spilled inner rows.
+    for (auto&& accessor : _outInnerSwitchAccessors) {
+        accessor->setIndex(1);
+    }
+    _rsCursor = _recordStore->rs()->getCursor(_opCtx);
+    _innerSpilled = true;
+}
+
+PlanState HashJoinStage::getNextSpilled() {
+    if (!_innerSpilled) {
+        spillInnerSide();
+    }
+
+    if (_htIt != _htItEnd) {
+        ++_htIt;
+    }
+
+    while (_htIt == _htItEnd) {
+        auto nextRecord = _rsCursor->next();
+        if (!nextRecord) {
+            return trackPlanState(PlanState::IS_EOF);
+        }
+
+        const int64_t rid = nextRecord->id.getLong();
+        const size_t partition = rid >> kPartitionShift;
+        const auto side = static_cast<SpillSide>((rid >> kSideShift) & 1);
+
+        if (partition != _currentPartition) {
+            // Every inner row of the previous partition has been processed, release its build side
+            // before loading the next one.
+            _ht->clear();
+            _currentPartition = partition;
+        }
+
+        BufReader reader(nextRecord->data.data(), nextRecord->data.size());
+        if (side == SpillSide::kBuild) {
+            auto key = value::MaterializedRow::deserializeForSorter(reader, {});
+            auto project = value::MaterializedRow::deserializeForSorter(reader, {});
+            _ht->emplace(std::move(key), std::move(project));
+            _htIt = _ht->end();
+            _htItEnd = _ht->end();
+        } else {
+            _spilledInnerKey = value::MaterializedRow::deserializeForSorter(reader, {});
+            _spilledInnerProject = value::MaterializedRow::deserializeForSorter(reader, {});
+
+            auto [low, hi] = _ht->equal_range(_spilledInnerKey);
+            _htIt = low;
+            _htItEnd = hi;
+        }
+    }
+
+    return trackPlanState(PlanState::ADVANCED);
+}
+
 PlanState HashJoinStage::getNext() {
     auto optTimer(getOptTimer(_opCtx));
 
+    if (_recordStore) {
+        return getNextSpilled();
+    }
+
     if (_htIt != _htItEnd) {
         ++_htIt;
     }
@@ -214,17 +517,36 @@ void HashJoinStage::close() {
     trackClose();
     _children[1]->close();
     _ht = boost::none;
+    if (_recordStore) {
+        // A record store was created to spill to disk. Clean it up.
+        _rsCursor.reset();
+        _recordStore.reset();
+        _spillBatch.clear();
+        _spillBuffer.reset();
+    }
 }
 
 std::unique_ptr<PlanStageStats> HashJoinStage::getStats(bool includeDebugInfo) const {
     auto ret = std::make_unique<PlanStageStats>(_commonStats);
+    ret->specific = std::make_unique<HashJoinStats>(_specificStats);
+
+    if (includeDebugInfo) {
+        BSONObjBuilder bob;
+        // Spilling stats.
+        bob.appendBool("usedDisk", _specificStats.usedDisk);
+        bob.appendNumber("spillPartitions", _specificStats.numPartitions);
+        bob.appendNumber("spilledRecords", _specificStats.spilledRecords);
+        bob.appendNumber("spilledBytes", _specificStats.spilledBytes);
+        ret->debugInfo = bob.obj();
+    }
+
     ret->children.emplace_back(_children[0]->getStats(includeDebugInfo));
     ret->children.emplace_back(_children[1]->getStats(includeDebugInfo));
     return ret;
 }
 
 const SpecificStats* HashJoinStage::getSpecificStats() const {
-    return nullptr;
+    return &_specificStats;
 }
 
 std::vector<DebugPrinter::Block> HashJoinStage::debugPrint() const {
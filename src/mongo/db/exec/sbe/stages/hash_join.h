@@ -32,7 +32,10 @@
 #include <vector>
 
 #include "mongo/db/exec/sbe/stages/stages.h"
+#include "mongo/db/exec/sbe/util/spilling.h"
 #include "mongo/db/exec/sbe/vm/vm.h"
+#include "mongo/db/query/query_knobs_gen.h"
+#include "mongo/db/storage/temporary_record_store.h"
 
 namespace mongo::sbe {
 /**
@@ -51,6 +54,14 @@ namespace mongo::sbe {
  * for string equality. For example, this can be used to perform a case-insensitive join on string
  * values.
  *
+ * If 'allowDiskUse' is true and the build side grows beyond
+ * 'internalQuerySBEHashJoinApproxMemoryUseInBytesBeforeSpill', the stage switches to a partitioned
+ * (grace hash) join: the rows of both sides are hashed into partitions that are written to a
+ * temporary record store, and the partitions are then joined one at a time so that only a single
+ * partition of the build side is held in memory. In this mode the rows of the inner side are
+ * materialized as well, so only the 'innerCond' and 'innerProjects' slots of the inner side are
+ * visible to the stages higher in the tree.
+ *
  * Debug string representation:
  *
  *   hj collatorSlot?
@@ -66,6 +77,7 @@ public:
                   value::SlotVector innerCond,
                   value::SlotVector innerProjects,
                   boost::optional<value::SlotId> collatorSlot,
+                  bool allowDiskUse,
                   PlanNodeId planNodeId);
 
     std::unique_ptr<PlanStage> clone() const final;
@@ -81,6 +93,12 @@ public:
     std::vector<DebugPrinter::Block> debugPrint() const final;
     size_t estimateCompileTimeSize() const final;
 
+protected:
+    void doSaveState(bool relinquishCursor) override;
+    void doRestoreState(bool relinquishCursor) override;
+    void doDetachFromOperationContext() override;
+    void doAttachToOperationContext(OperationContext* opCtx) override;
+
 private:
     using TableType = std::unordered_multimap<value::MaterializedRow,  // NOLINT
                                               value::MaterializedRow,
@@ -90,6 +108,48 @@ private:
     using HashKeyAccessor = value::MaterializedRowKeyAccessor<TableType::iterator>;
     using HashProjectAccessor = value::MaterializedRowValueAccessor<TableType::iterator>;
 
+    // The sides of the join as recorded in the spilled partitions. The build (outer) side must sort
+    // before the probe (inner) side so that each build partition is loaded before it is probed.
+    enum class SpillSide : int64_t { kBuild = 0, kProbe = 1 };
+
+    TableType makeHashTable() const;
+
+    void makeTemporaryRecordStore();
+
+    /**
+     * Estimates the memory used by the build side hash table. When it exceeds the limit, switches
+     * the stage to the partitioned mode by moving every row of '_ht' into the spilled partitions.
+     */
+    void checkMemoryUsageAndSpillIfNecessary(MemoryCheckData& mcd);
+
+    /**
+     * Returns the spill partition of the given join key.
+     */
+    size_t getPartition(const value::MaterializedRow& key) const;
+
+    /**
+     * Appends a (key, project) row of the given side to the partition of the 'key' in the
+     * temporary record store. The RecordId is composed such that the records are ordered by
+     * partition first, then by side and finally by insertion order.
+     */
+    void spillRowToDisk(SpillSide side,
+                        const value::MaterializedRow& key,
+                        const value::MaterializedRow& project);
+    void flushSpilledRows();
+
+    /**
+     * Drains the inner side into the spilled partitions. Called on the first 'getNext()' after the
+     * build side has been spilled.
+     */
+    void spillInnerSide();
+
+    /**
+     * Produces the next joined row in the partitioned mode by walking the temporary record store
+     * in partition order. Each build partition is loaded into '_ht' and then probed with the
+     * spilled inner rows of the same partition.
+     */
+    PlanState getNextSpilled();
+
     const value::SlotVector _outerCond;
     const value::SlotVector _outerProjects;
     const value::SlotVector _innerCond;
@@ -114,6 +174,16 @@ private:
     // Accessors of input condition values (keys) that are being inserted into the hash table.
     std::vector<value::SlotAccessor*> _inInnerKeyAccessors;
 
+    // Accessors of the inner side projections. Only used when the inner side is spilled.
+    std::vector<value::SlotAccessor*> _inInnerProjectAccessors;
+
+    // Accessors of the inner side condition and projection slots. A SwitchAccessor is used so we
+    // can produce the values from either the inner child or from the inner row read back from the
+    // '_recordStore' when the join is partitioned.
+    value::SlotAccessorMap _outInnerAccessors;
+    std::vector<std::unique_ptr<value::MaterializedSingleRowAccessor>> _outSpilledInnerAccessors;
+    std::vector<std::unique_ptr<value::SwitchAccessor>> _outInnerSwitchAccessors;
+
     // Accessor for collator. Only set if collatorSlot provided during construction.
     value::SlotAccessor* _collatorAccessor = nullptr;
 
@@ -127,5 +197,38 @@ private:
     vm::ByteCode _bytecode;
 
     bool _compiled{false};
+
+    // Memory tracking and spilling to disk.
+    const bool _allowDiskUse;
+    const long long _approxMemoryUseInBytesBeforeSpill =
+        internalQuerySBEHashJoinApproxMemoryUseInBytesBeforeSpill.load();
+    const size_t _numSpillPartitions = internalQuerySBEHashJoinSpillPartitions.load();
+    std::unique_ptr<TemporaryRecordStore> _recordStore;
+    std::unique_ptr<SeekableRecordCursor> _rsCursor;
+
+    // Rows waiting to be written to the '_recordStore' in a single storage transaction. The rows
+    // are serialized back to back into '_spillBuffer' and located by their offset and size.
+    struct PendingSpilledRow {
+        RecordId rid;
+        int offset;
+        int size;
+    };
+    std::vector<PendingSpilledRow> _spillBatch;
+    BufBuilder _spillBuffer;
+    int64_t _spilledRecordCounter{0};
+
+    // Tracks which partitions received rows from the build side. Inner rows which fall into a
+    // partition without any build rows cannot produce a match and are not spilled.
+    std::vector<bool> _partitionHasBuildRows;
+
+    // The partition currently loaded into '_ht' when the join is partitioned.
+    boost::optional<size_t> _currentPartition;
+    bool _innerSpilled{false};
+
+    // The inner row read back from the '_recordStore' and probing the current partition.
+    value::MaterializedRow _spilledInnerKey{0};
+    value::MaterializedRow _spilledInnerProject{0};
+
+    HashJoinStats _specificStats;
 };
 }  // namespace mongo::sbe
@@ -33,6 +33,9 @@
 
 #include "mongo/db/exec/sbe/expressions/expression.h"
 #include "mongo/db/exec/sbe/size_estimator.h"
+#include "mongo/db/storage/key_string.h"
+#include "mongo/db/storage/storage_engine.h"
+#include "mongo/db/storage/write_unit_of_work.h"
 #include "mongo/util/str.h"
 
 namespace mongo {
@@ -45,6 +48,7 @@ HashLookupStage::HashLookupStage(std::unique_ptr<PlanStage> outer,
                                  value::SlotVector innerProjects,
                                  value::SlotMap<std::unique_ptr<EExpression>> innerAggs,
                                  boost::optional<value::SlotId> collatorSlot,
+                                 bool allowDiskUse,
                                  PlanNodeId planNodeId)
     : PlanStage("hash_lookup"_sd, planNodeId),
       _outerCond(outerCond),
@@ -52,6 +56,7 @@ HashLookupStage::HashLookupStage(std::unique_ptr<PlanStage> outer,
       _innerProjects(innerProjects),
       _innerAggs(std::move(innerAggs)),
       _collatorSlot(collatorSlot),
+      _allowDiskUse(allowDiskUse),
       _probeKey(0) {
     _children.emplace_back(std::move(outer));
     _children.emplace_back(std::move(inner));
@@ -70,9 +75,51 @@ std::unique_ptr<PlanStage> HashLookupStage::clone() const {
                                              _innerProjects,
                                              std::move(innerAggs),
                                              _collatorSlot,
+                                             _allowDiskUse,
                                              _commonStats.nodeId);
 }
 
+void HashLookupStage::doSaveState(bool relinquishCursor) {
+    for (auto cursor : {_rsCursorHt.get(), _rsCursorBuf.get()}) {
+        if (!cursor) {
+            continue;
+        }
+        if (relinquishCursor) {
+            cursor->save();
+        }
+        cursor->setSaveStorageCursorOnDetachFromOperationContext(!relinquishCursor);
+    }
+}
+
+void HashLookupStage::doRestoreState(bool relinquishCursor) {
+    invariant(_opCtx);
+    if (!relinquishCursor) {
+        return;
+    }
+    for (auto cursor : {_rsCursorHt.get(), _rsCursorBuf.get()}) {
+        if (cursor) {
+            auto couldRestore = cursor->restore();
+            uassert(7131205, "HashLookupStage could not restore cursor", couldRestore);
+        }
+    }
+}
+
+void HashLookupStage::doDetachFromOperationContext() {
+    for (auto cursor : {_rsCursorHt.get(), _rsCursorBuf.get()}) {
+        if (cursor) {
+            cursor->detachFromOperationContext();
+        }
+    }
+}
+
+void HashLookupStage::doAttachToOperationContext(OperationContext* opCtx) {
+    for (auto cursor : {_rsCursorHt.get(), _rsCursorBuf.get()}) {
+        if (cursor) {
+            cursor->reattachToOperationContext(opCtx);
+        }
+    }
+}
+
 void HashLookupStage::prepare(CompileCtx& ctx) {
     outerChild()->prepare(ctx);
     innerChild()->prepare(ctx);
@@ -98,6 +145,8 @@ void HashLookupStage::prepare(CompileCtx& ctx) {
     size_t idx = 0;
     value::SlotSet innerProjectDupCheck;
     _outInnerProjectAccessors.reserve(_innerProjects.size());
+    _outSpilledInnerProjectAccessors.reserve(_innerProjects.size());
+    _outInnerProjectSwitchAccessors.reserve(_innerProjects.size());
     for (auto slot : _innerProjects) {
         inputSlots.emplace(slot);
         auto [it, inserted] = innerProjectDupCheck.emplace(slot);
@@ -107,10 +156,15 @@ void HashLookupStage::prepare(CompileCtx& ctx) {
         _inInnerProjectAccessors.push_back(accessor);
 
         _outInnerProjectAccessors.emplace_back(_buffer, _bufferIt, idx);
+        _outSpilledInnerProjectAccessors.emplace_back(_spilledBufferRow, idx);
 
-        // '_outInnerProjectAccessors' has been preallocated, so it's element pointers will be
-        // stable.
-        _outInnerProjectAccessorMap.emplace(slot, &_outInnerProjectAccessors.back());
+        // The accumulated 'inner' row is either held in '_buffer', or read back from the
+        // '_recordStoreBuf' into '_spilledBufferRow' if it was spilled.
+        _outInnerProjectSwitchAccessors.emplace_back(std::vector<value::SlotAccessor*>{
+            &_outInnerProjectAccessors.back(), &_outSpilledInnerProjectAccessors.back()});
+
+        // The accessors have been preallocated, so their element pointers will be stable.
+        _outInnerProjectAccessorMap.emplace(slot, &_outInnerProjectSwitchAccessors.back());
         idx++;
     }
 
@@ -151,6 +205,7 @@ void HashLookupStage::prepare(CompileCtx& ctx) {
 
     _resultAggRow.resize(_outResultAggAccessors.size());
     _probeKey.resize(1);
+    _spilledBufferRow.resize(_inInnerProjectAccessors.size());
 }
 
 value::SlotAccessor* HashLookupStage::getAccessor(CompileCtx& ctx, value::SlotId slot) {
@@ -175,6 +230,118 @@ void HashLookupStage::reset() {
 
     // Erase but don't change its reference. Otherwise it will invalidate the slot accessors.
     _buffer.clear();
+
+    _memoryUseInBytes = 0;
+    if (_recordStoreHt) {
+        // Record stores were created to spill to disk. Clean them up.
+        _rsCursorHt.reset();
+        _rsCursorBuf.reset();
+        _rsCursorBufIdx = boost::none;
+        _recordStoreHt.reset();
+        _recordStoreBuf.reset();
+        _pendingHtRecords.clear();
+        _pendingBufRecords.clear();
+        _spillBuffer.reset();
+    }
+}
+
+void HashLookupStage::makeTemporaryRecordStores() {
+    tassert(7131206,
+            "HashLookupStage attempted to write to disk in an environment which is not prepared to "
+            "do so",
+            _opCtx->getServiceContext());
+    tassert(7131207,
+            "No storage engine so HashLookupStage cannot spill to disk",
+            _opCtx->getServiceContext()->getStorageEngine());
+    assertIgnorePrepareConflictsBehavior(_opCtx);
+
+    auto storageEngine = _opCtx->getServiceContext()->getStorageEngine();
+    _recordStoreHt = storageEngine->makeTemporaryRecordStore(_opCtx, KeyFormat::String);
+    _recordStoreBuf = storageEngine->makeTemporaryRecordStore(_opCtx, KeyFormat::Long);
+    _specificStats.usedDisk = true;
+}
+
+void HashLookupStage::checkMemoryUsageAndSpillIfNecessary() {
+    // The match keys are compared using the collator, which cannot be done on their KeyString
+    // representation, so we can't spill in this case.
+    if (!_allowDiskUse || _collatorAccessor || _recordStoreHt ||
+        _memoryUseInBytes < _approxMemoryUseInBytesBeforeSpill) {
+        return;
+    }
+
+    makeTemporaryRecordStores();
+}
+
+namespace {
+// The number of bytes of spilled records to accumulate before writing them to the record stores.
+constexpr int kSpillBatchBytes = 1024 * 1024;
+}  // namespace
+
+void HashLookupStage::spillHashTableEntry(const value::MaterializedRow& key, size_t valueIndex) {
+    // The entries for the same key share the KeyString prefix and are ordered by the row id.
+    KeyString::Builder kb{KeyString::Version::kLatestVersion};
+    key.serializeIntoKeyString(kb);
+    kb.appendNumberLong(valueIndex);
+
+    const int offset = _spillBuffer.len();
+    _spillBuffer.appendNum(static_cast<long long>(valueIndex));
+    _pendingHtRecords.push_back({RecordId(kb.getBuffer(), kb.getSize()),
+                                 offset,
+                                 static_cast<int>(_spillBuffer.len() - offset)});
+
+    if (_spillBuffer.len() >= kSpillBatchBytes) {
+        flushSpilledRecords();
+    }
+}
+
+void HashLookupStage::spillBufferedValue(const value::MaterializedRow& value, size_t valueIndex) {
+    const int offset = _spillBuffer.len();
+    value.serializeForSorter(_spillBuffer);
+    // RecordId 0 is not a valid record id, so shift the row ids by one.
+    _pendingBufRecords.push_back({RecordId(static_cast<int64_t>(valueIndex) + 1),
+                                  offset,
+                                  static_cast<int>(_spillBuffer.len() - offset)});
+
+    if (_spillBuffer.len() >= kSpillBatchBytes) {
+        flushSpilledRecords();
+    }
+}
+
+void HashLookupStage::flushSpilledRecords() {
+    auto writeRecords = [&](RecordStore* rs, std::vector<PendingRecord>& pending) {
+        if (pending.empty()) {
+            return 0LL;
+        }
+
+        long long bytes = 0;
+        std::vector<Record> records;
+        records.reserve(pending.size());
+        for (auto&& record : pending) {
+            records.push_back(
+                {record.rid, RecordData(_spillBuffer.buf() + record.offset, record.size)});
+            bytes += record.rid.memUsage() + record.size;
+        }
+
+        WriteUnitOfWork wuow(_opCtx);
+        auto status = rs->insertRecords(
+            _opCtx, &records, std::vector<Timestamp>(records.size(), Timestamp{}));
+        wuow.commit();
+        tassert(7131208,
+                str::stream() << "Failed to write to disk because " << status.reason(),
+                status.isOK());
+
+        pending.clear();
+        return bytes;
+    };
+
+    assertIgnorePrepareConflictsBehavior(_opCtx);
+
+    _specificStats.spilledHtRecords += _pendingHtRecords.size();
+    _specificStats.spilledHtBytes += writeRecords(_recordStoreHt->rs(), _pendingHtRecords);
+    _specificStats.spilledBuffRecords += _pendingBufRecords.size();
+    _specificStats.spilledBuffBytes += writeRecords(_recordStoreBuf->rs(), _pendingBufRecords);
+
+    _spillBuffer.reset();
 }
 
 void HashLookupStage::addHashTableEntry(value::SlotAccessor* keyAccessor, size_t valueIndex) {
@@ -182,18 +349,25 @@ void HashLookupStage::addHashTableEntry(value::SlotAccessor* keyAccessor, size_t
     auto [tagKeyView, valKeyView] = keyAccessor->getViewOfValue();
     _probeKey.reset(0, false, tagKeyView, valKeyView);
 
+    if (_recordStoreHt) {
+        spillHashTableEntry(_probeKey, valueIndex);
+        return;
+    }
+
     auto htIt = _ht->find(_probeKey);
     if (htIt == _ht->end()) {
         // We have to insert an owned key, attempt a move, but force copy if necessary.
         value::MaterializedRow key{1};
         auto [tagKey, valKey] = keyAccessor->copyOrMoveValue();
         key.reset(0, true, tagKey, valKey);
+        _memoryUseInBytes += key.memUsageForSorter() + sizeof(HashTableType::mapped_type);
         auto [it, inserted] = _ht->try_emplace(std::move(key));
         invariant(inserted);
         htIt = it;
     }
 
     htIt->second.push_back(valueIndex);
+    _memoryUseInBytes += sizeof(size_t);
 }
 
 void HashLookupStage::open(bool reOpen) {
@@ -218,18 +392,29 @@ void HashLookupStage::open(bool reOpen) {
     innerChild()->open(false);
 
     // Insert the inner side into the hash table.
-    while (innerChild()->getNext() == PlanState::ADVANCED) {
-        value::MaterializedRow value{_inInnerProjectAccessors.size()};
-
-        // Copy all projected values.
-        size_t idx = 0;
-        for (auto accessor : _inInnerProjectAccessors) {
-            auto [tag, val] = accessor->copyOrMoveValue();
-            value.reset(idx++, true, tag, val);
-        }
+    size_t bufferIndex = 0;
+    value::MaterializedRow spilledValue{_inInnerProjectAccessors.size()};
+    for (; innerChild()->getNext() == PlanState::ADVANCED; ++bufferIndex) {
+        if (_recordStoreBuf) {
+            size_t idx = 0;
+            for (auto accessor : _inInnerProjectAccessors) {
+                auto [tag, val] = accessor->getViewOfValue();
+                spilledValue.reset(idx++, false, tag, val);
+            }
+            spillBufferedValue(spilledValue, bufferIndex);
+        } else {
+            value::MaterializedRow value{_inInnerProjectAccessors.size()};
+
+            // Copy all projected values.
+            size_t idx = 0;
+            for (auto accessor : _inInnerProjectAccessors) {
+                auto [tag, val] = accessor->copyOrMoveValue();
+                value.reset(idx++, true, tag, val);
+            }
 
-        size_t bufferIndex = _buffer.size();
-        _buffer.emplace_back(std::move(value));
+            _memoryUseInBytes += value.memUsageForSorter();
+            _buffer.emplace_back(std::move(value));
+        }
 
         auto [tagKeyView, valKeyView] = _inInnerMatchAccessor->getViewOfValue();
 
@@ -244,20 +429,77 @@ void HashLookupStage::open(bool reOpen) {
         } else {
             addHashTableEntry(_inInnerMatchAccessor, bufferIndex);
         }
+
+        // Once the memory limit is exceeded, the following rows are spilled to disk.
+        checkMemoryUsageAndSpillIfNecessary();
     }
 
     innerChild()->close();
+
+    if (_recordStoreHt) {
+        flushSpilledRecords();
+        _rsCursorHt = _recordStoreHt->rs()->getCursor(_opCtx);
+        _rsCursorBuf = _recordStoreBuf->rs()->getCursor(_opCtx);
+    }
+
     outerChild()->open(reOpen);
 }
 
+template <typename C>
+void HashLookupStage::findSpilledValueIndices(C& indices) {
+    KeyString::Builder kb{KeyString::Version::kLatestVersion};
+    _probeKey.serializeIntoKeyString(kb);
+    const RecordId prefix(kb.getBuffer(), kb.getSize());
+    const auto prefixStr = prefix.getStr();
+
+    // All the entries for the key are strictly greater than the key itself, so the cursor is
+    // positioned either on the first of them, or on the entry right before them.
+    auto record = _rsCursorHt->seekNear(prefix);
+    if (record && record->id < prefix) {
+        record = _rsCursorHt->next();
+    }
+
+    for (; record && record->id.getStr().startsWith(prefixStr); record = _rsCursorHt->next()) {
+        BufReader reader(record->data.data(), record->data.size());
+        indices.insert(indices.end(), static_cast<size_t>(reader.read<LittleEndian<long long>>()));
+    }
+}
+
+void HashLookupStage::setInnerRow(size_t bufferIdx) {
+    if (bufferIdx < _buffer.size()) {
+        // Point iterator to a row to accumulate.
+        _bufferIt = bufferIdx;
+        for (auto&& accessor : _outInnerProjectSwitchAccessors) {
+            accessor.setIndex(0);
+        }
+        return;
+    }
+
+    // RecordId 0 is not a valid record id, so the row ids are shifted by one.
+    const RecordId rid(static_cast<int64_t>(bufferIdx) + 1);
+    boost::optional<Record> record;
+    if (_rsCursorBufIdx && *_rsCursorBufIdx + 1 == bufferIdx) {
+        record = _rsCursorBuf->next();
+    } else {
+        record = _rsCursorBuf->seekExact(rid);
+    }
+    tassert(7131209, "Spilled 'inner' row not found", record && record->id == rid);
+    _rsCursorBufIdx = bufferIdx;
+
+    BufReader reader(record->data.data(), record->data.size());
+    _spilledBufferRow = value::MaterializedRow::deserializeForSorter(reader, {});
+    for (auto&& accessor : _outInnerProjectSwitchAccessors) {
+        accessor.setIndex(1);
+    }
+}
+
 template <typename C>
 void HashLookupStage::accumulateFromValueIndices(const C& bufferIndices) {
     boost::optional<size_t> prevIdx;
     for (auto bufferIdx : bufferIndices) {
         tassert(6367811, "Indices expected to be sorted", !prevIdx || prevIdx < bufferIdx);
 
-        // Point iterator to a row to accumulate.
-        _bufferIt = bufferIdx;
+        setInnerRow(bufferIdx);
 
         for (size_t idx = 0; idx < _outResultAggAccessors.size(); idx++) {
             auto [owned, tag, val] = _bytecode.run(_aggCodes[idx].get());
@@ -294,13 +536,25 @@ PlanState HashLookupStage::getNext() {
                 if (htIt != _ht->end()) {
                     indices.insert(htIt->second.begin(), htIt->second.end());
                 }
+                if (_recordStoreHt) {
+                    findSpilledValueIndices(indices);
+                }
                 enumerator.advance();
             }
             accumulateFromValueIndices(indices);
         } else {
             _probeKey.reset(0, false, tagKeyView, valKeyView);
             auto htIt = _ht->find(_probeKey);
-            if (htIt != _ht->end()) {
+            if (_recordStoreHt) {
+                // The ids of the spilled rows are greater than the ids of the rows in memory, so
+                // appending them keeps '_valueIndices' sorted.
+                _valueIndices.clear();
+                if (htIt != _ht->end()) {
+                    _valueIndices = htIt->second;
+                }
+                findSpilledValueIndices(_valueIndices);
+                accumulateFromValueIndices(_valueIndices);
+            } else if (htIt != _ht->end()) {
                 accumulateFromValueIndices(htIt->second);
             }
         }
@@ -322,13 +576,26 @@ void HashLookupStage::close() {
 
 std::unique_ptr<PlanStageStats> HashLookupStage::getStats(bool includeDebugInfo) const {
     auto ret = std::make_unique<PlanStageStats>(_commonStats);
+    ret->specific = std::make_unique<HashLookupStats>(_specificStats);
+
+    if (includeDebugInfo) {
+        BSONObjBuilder bob;
+        // Spilling stats.
+        bob.appendBool("usedDisk", _specificStats.usedDisk);
+        bob.appendNumber("spilledHtRecords", _specificStats.spilledHtRecords);
+        bob.appendNumber("spilledHtBytes", _specificStats.spilledHtBytes);
+        bob.appendNumber("spilledBuffRecords", _specificStats.spilledBuffRecords);
+        bob.appendNumber("spilledBuffBytes", _specificStats.spilledBuffBytes);
+        ret->debugInfo = bob.obj();
+    }
+
     ret->children.emplace_back(outerChild()->getStats(includeDebugInfo));
     ret->children.emplace_back(innerChild()->getStats(includeDebugInfo));
     return ret;
 }
 
 const SpecificStats* HashLookupStage::getSpecificStats() const {
-    return nullptr;
+    return &_specificStats;
 }
 
 std::vector<DebugPrinter::Block> HashLookupStage::debugPrint() const {
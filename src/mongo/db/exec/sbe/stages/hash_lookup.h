@@ -33,7 +33,9 @@
 
 #include "mongo/db/exec/sbe/expressions/expression.h"
 #include "mongo/db/exec/sbe/stages/stages.h"
+#include "mongo/db/exec/sbe/util/spilling.h"
 #include "mongo/db/exec/sbe/vm/vm.h"
+#include "mongo/db/storage/temporary_record_store.h"
 
 namespace mongo::sbe {
 /**
@@ -70,6 +72,16 @@ namespace mongo::sbe {
  * for string equality. For example, this can be used to perform a case-insensitive matching on
  * string values.
  *
+ * If 'allowDiskUse' is true and the estimated size of the hash table and the buffered 'inner' rows
+ * exceeds 'internalQuerySlotBasedExecutionHashLookupApproxMemoryUseInBytesBeforeSpill', the rest of
+ * the 'inner' side is spilled to disk. The spilled hash table entries are keyed by the KeyString of
+ * the match key followed by the row id, so all ids for a key can be retrieved with a prefix scan,
+ * and the spilled rows are keyed by their id. Since the ids are handed out sequentially, the ids of
+ * the spilled rows are always greater than the ids of the rows held in memory, so the matches are
+ * still aggregated in the 'inner' order, and runs of matching spilled rows are read sequentially.
+ * The 'outer' side is streamed as before. Spilling is not supported when a 'collatorSlot' is
+ * provided, as the KeyString of a match key does not respect the collation.
+ *
  * Debug string representation:
  *
  *   hash_lookup [slot_1 = expr_1, ..., slot_n = expr_n] collatorSlot?
@@ -85,6 +97,7 @@ public:
                     value::SlotVector innerProjects,
                     value::SlotMap<std::unique_ptr<EExpression>> innerAggs,
                     boost::optional<value::SlotId> collatorSlot,
+                    bool allowDiskUse,
                     PlanNodeId planNodeId);
 
     std::unique_ptr<PlanStage> clone() const final;
@@ -100,6 +113,12 @@ public:
     std::vector<DebugPrinter::Block> debugPrint() const final;
     size_t estimateCompileTimeSize() const final;
 
+protected:
+    void doSaveState(bool relinquishCursor) override;
+    void doRestoreState(bool relinquishCursor) override;
+    void doDetachFromOperationContext() override;
+    void doAttachToOperationContext(OperationContext* opCtx) override;
+
 private:
     using HashTableType = std::unordered_map<value::MaterializedRow,  // NOLINT
                                              std::vector<size_t>,
@@ -114,6 +133,34 @@ private:
     void reset();
     void addHashTableEntry(value::SlotAccessor* keyAccessor, size_t valueIndex);
 
+    /**
+     * Tracks the memory used by the hash table and the buffer, and switches to spilling the rest
+     * of the 'inner' side once the limit is exceeded.
+     */
+    void checkMemoryUsageAndSpillIfNecessary();
+    void makeTemporaryRecordStores();
+
+    /**
+     * Appends a record to the batch of pending writes and flushes the batch if it grows too large.
+     */
+    void spillHashTableEntry(const value::MaterializedRow& key, size_t valueIndex);
+    void spillBufferedValue(const value::MaterializedRow& value, size_t valueIndex);
+    void flushSpilledRecords();
+
+    /**
+     * Appends to 'indices' the ids of the spilled 'inner' rows that match '_probeKey'.
+     */
+    template <typename C>
+    void findSpilledValueIndices(C& indices);
+
+    /**
+     * Points the 'inner' project accessors to the row with the given id, reading it from the
+     * spilled buffer if necessary. The matching rows are visited in increasing id order, so the
+     * spilled ones are read with a single cursor, which only seeks when the next matching row is
+     * not the one that follows the previous match.
+     */
+    void setInnerRow(size_t bufferIdx);
+
     template <typename C>
     void accumulateFromValueIndices(const C& projectIndices);
 
@@ -129,6 +176,7 @@ private:
     const value::SlotVector _innerProjects;
     const value::SlotMap<std::unique_ptr<EExpression>> _innerAggs;
     const boost::optional<value::SlotId> _collatorSlot;
+    const bool _allowDiskUse;
 
     value::SlotAccessorMap _outAccessorMap;
     value::SlotAccessorMap _outInnerProjectAccessorMap;
@@ -138,6 +186,8 @@ private:
     value::SlotAccessor* _inInnerMatchAccessor;
     std::vector<value::SlotAccessor*> _inInnerProjectAccessors;
     std::vector<BufferAccessor> _outInnerProjectAccessors;
+    std::vector<value::MaterializedSingleRowAccessor> _outSpilledInnerProjectAccessors;
+    std::vector<value::SwitchAccessor> _outInnerProjectSwitchAccessors;
     std::vector<value::MaterializedSingleRowAccessor> _outResultAggAccessors;
     std::vector<std::unique_ptr<vm::CodeFragment>> _aggCodes;
 
@@ -157,5 +207,40 @@ private:
     vm::ByteCode _bytecode;
 
     bool _compileInnerAgg{false};
+
+    // Memory tracking and spilling to disk.
+    const long long _approxMemoryUseInBytesBeforeSpill =
+        internalQuerySBELookupApproxMemoryUseInBytesBeforeSpill.load();
+    long long _memoryUseInBytes{0};
+
+    // The spilled hash table entries, keyed by the match key followed by the row id.
+    std::unique_ptr<TemporaryRecordStore> _recordStoreHt;
+    // The spilled 'inner' rows, keyed by the row id.
+    std::unique_ptr<TemporaryRecordStore> _recordStoreBuf;
+    // The cursor used for prefix scans of '_recordStoreHt'.
+    std::unique_ptr<SeekableRecordCursor> _rsCursorHt;
+    // The cursor used to read the spilled 'inner' rows from '_recordStoreBuf', and the id of the
+    // row it is positioned on, if any.
+    std::unique_ptr<SeekableRecordCursor> _rsCursorBuf;
+    boost::optional<size_t> _rsCursorBufIdx;
+
+    // A batch of records waiting to be written to '_recordStoreHt' or '_recordStoreBuf'. The data
+    // of the records is held in '_spillBuffer'.
+    struct PendingRecord {
+        RecordId rid;
+        int offset;
+        int size;
+    };
+    std::vector<PendingRecord> _pendingHtRecords;
+    std::vector<PendingRecord> _pendingBufRecords;
+    BufBuilder _spillBuffer;
+
+    // The 'inner' row read back from '_recordStoreBuf'.
+    value::MaterializedRow _spilledBufferRow;
+
+    // Reused to collect the matching ids when some of them were spilled.
+    std::vector<size_t> _valueIndices;
+
+    HashLookupStats _specificStats;
 };
 }  // namespace mongo::sbe
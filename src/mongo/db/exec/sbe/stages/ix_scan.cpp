@@ -37,6 +37,7 @@
 #include "mongo/db/exec/sbe/values/bson.h"
 #include "mongo/db/exec/trial_run_tracker.h"
 #include "mongo/db/index/index_access_method.h"
+#include "mongo/db/query/query_knobs_gen.h"
 
 namespace mongo::sbe {
 IndexScanStage::IndexScanStage(UUID collUuid,
@@ -270,6 +271,17 @@ void IndexScanStage::open(bool reOpen) {
     _open = true;
     _firstGetNext = true;
 
+    _readsInBatches = internalQueryExecMaxScanBatchSize.load() > 1;
+    _batch.clear();
+    _batchPos = 0;
+    _batchSize = 1;
+    if (_snapshotIdAccessor) {
+        // A previous batch may have reported an older snapshot than the one being read from now.
+        _snapshotIdAccessor->reset(
+            value::TypeTags::NumberInt64,
+            value::bitcastFrom<uint64_t>(_opCtx->recoveryUnit()->getSnapshotId().toNumber()));
+    }
+
     auto entry = _weakIndexCatalogEntry.lock();
     tassert(4938502,
             str::stream() << "expected IndexCatalogEntry for index named: " << _indexName,
@@ -325,6 +337,20 @@ const KeyString::Value* IndexScanStage::getSeekKeyHigh() const {
     return value::getKeyStringView(value);
 }
 
+boost::optional<KeyStringEntry> IndexScanStage::nextFromBatch() {
+    if (_batchPos == _batch.size()) {
+        _batch.clear();
+        _batchPos = 0;
+        _batchSnapshotId = _opCtx->recoveryUnit()->getSnapshotId();
+        if (!_cursor->nextKeyStringBatch(&_batch, _batchSize)) {
+            return boost::none;
+        }
+        _batchSize = std::min(_batchSize * 2,
+                              static_cast<size_t>(internalQueryExecMaxScanBatchSize.load()));
+    }
+    return std::move(_batch[_batchPos++]);
+}
+
 PlanState IndexScanStage::getNext() {
     auto optTimer(getOptTimer(_opCtx));
 
@@ -338,6 +364,14 @@ PlanState IndexScanStage::getNext() {
         _firstGetNext = false;
         _nextRecord = _cursor->seekForKeyString(getSeekKeyLow());
         ++_specificStats.seeks;
+    } else if (_readsInBatches) {
+        _nextRecord = nextFromBatch();
+        if (_snapshotIdAccessor) {
+            // The entries that have been read ahead belong to the snapshot of their batch, which
+            // precedes the current one if the stage has yielded since.
+            _snapshotIdAccessor->reset(value::TypeTags::NumberInt64,
+                                       value::bitcastFrom<uint64_t>(_batchSnapshotId.toNumber()));
+        }
     } else {
         _nextRecord = _cursor->nextKeyString();
     }
@@ -399,6 +433,8 @@ void IndexScanStage::close() {
 
     trackClose();
 
+    _batch.clear();
+    _batchPos = 0;
     _cursor.reset();
     _coll.reset();
     _open = false;
@@ -118,6 +118,12 @@ private:
     const KeyString::Value& getSeekKeyLow() const;
     const KeyString::Value* getSeekKeyHigh() const;
 
+    /**
+     * Returns the next entry of '_batch', reading another batch from '_cursor' once every entry of
+     * the current one has been returned. Returns boost::none at the end of the index.
+     */
+    boost::optional<KeyStringEntry> nextFromBatch();
+
     const UUID _collUuid;
     const std::string _indexName;
     const bool _forward;
@@ -156,6 +162,16 @@ private:
     boost::optional<Ordering> _ordering{boost::none};
     boost::optional<KeyStringEntry> _nextRecord;
 
+    // After the initial seek, the keys are read from '_cursor' in batches, which start with a
+    // single entry and double up to 'internalQueryExecMaxScanBatchSize' for every open().
+    // '_batchPos' is the position of the next entry of '_batch' to return, and '_batchSnapshotId'
+    // the snapshot the batch was read from.
+    bool _readsInBatches{false};
+    std::vector<KeyStringEntry> _batch;
+    size_t _batchPos{0};
+    size_t _batchSize{1};
+    SnapshotId _batchSnapshotId;
+
     // This buffer stores values that are projected out of the index entry. Values in the
     // '_accessors' list that are pointers point to data in this buffer.
     BufBuilder _valuesBuffer;
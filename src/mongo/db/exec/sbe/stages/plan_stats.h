@@ -282,6 +282,55 @@ struct HashAggStats : public SpecificStats {
     long long lastSpilledRecordSize{0};
 };
 
+struct HashJoinStats : public SpecificStats {
+    std::unique_ptr<SpecificStats> clone() const final {
+        return std::make_unique<HashJoinStats>(*this);
+    }
+
+    uint64_t estimateObjectSizeInBytes() const final {
+        return sizeof(*this);
+    }
+
+    void acceptVisitor(PlanStatsConstVisitor* visitor) const final {
+        visitor->visit(this);
+    }
+
+    void acceptVisitor(PlanStatsMutableVisitor* visitor) final {
+        visitor->visit(this);
+    }
+
+    bool usedDisk{false};
+    long long numPartitions{0};
+    long long spilledRecords{0};
+    long long spilledBytes{0};
+};
+
+struct HashLookupStats : public SpecificStats {
+    std::unique_ptr<SpecificStats> clone() const final {
+        return std::make_unique<HashLookupStats>(*this);
+    }
+
+    uint64_t estimateObjectSizeInBytes() const final {
+        return sizeof(*this);
+    }
+
+    void acceptVisitor(PlanStatsConstVisitor* visitor) const final {
+        visitor->visit(this);
+    }
+
+    void acceptVisitor(PlanStatsMutableVisitor* visitor) final {
+        visitor->visit(this);
+    }
+
+    bool usedDisk{false};
+    // The number of hash table entries and the total size of them written to disk.
+    long long spilledHtRecords{0};
+    long long spilledHtBytes{0};
+    // The number of buffered 'inner' rows and the total size of them written to disk.
+    long long spilledBuffRecords{0};
+    long long spilledBuffBytes{0};
+};
+
 /**
  * Visitor for calculating the number of storage reads during plan execution.
  */
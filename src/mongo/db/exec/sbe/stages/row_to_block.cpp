@@ -0,0 +1,228 @@
+/**
+ *    Copyright (C) 2022-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/exec/sbe/stages/row_to_block.h"
+
+#include "mongo/base/data_type_endian.h"
+#include "mongo/base/data_view.h"
+#include "mongo/db/exec/sbe/size_estimator.h"
+#include "mongo/db/exec/sbe/values/value_block.h"
+
+namespace mongo::sbe {
+RowToBlockStage::RowToBlockStage(std::unique_ptr<PlanStage> input,
+                                 value::SlotVector inputSlots,
+                                 value::SlotVector outputSlots,
+                                 size_t blockSize,
+                                 PlanNodeId planNodeId)
+    : PlanStage("row_to_block"_sd, planNodeId),
+      _inputSlots(std::move(inputSlots)),
+      _outputSlots(std::move(outputSlots)),
+      _blockSize(blockSize) {
+    _children.emplace_back(std::move(input));
+    tassert(7131410,
+            "row_to_block requires the same number of input and output slots",
+            _inputSlots.size() == _outputSlots.size());
+    tassert(7131411, "row_to_block requires a positive block size", _blockSize > 0);
+}
+
+std::unique_ptr<PlanStage> RowToBlockStage::clone() const {
+    return std::make_unique<RowToBlockStage>(
+        _children[0]->clone(), _inputSlots, _outputSlots, _blockSize, _commonStats.nodeId);
+}
+
+void RowToBlockStage::prepare(CompileCtx& ctx) {
+    _children[0]->prepare(ctx);
+
+    value::SlotSet dupCheck;
+    for (size_t idx = 0; idx < _inputSlots.size(); ++idx) {
+        auto [it, inserted] = dupCheck.emplace(_outputSlots[idx]);
+        uassert(7131412, str::stream() << "duplicate field: " << _outputSlots[idx], inserted);
+
+        _inAccessors.push_back(_children[0]->getAccessor(ctx, _inputSlots[idx]));
+    }
+    _outAccessors.resize(_outputSlots.size());
+}
+
+value::SlotAccessor* RowToBlockStage::getAccessor(CompileCtx& ctx, value::SlotId slot) {
+    for (size_t idx = 0; idx < _outputSlots.size(); ++idx) {
+        if (_outputSlots[idx] == slot) {
+            return &_outAccessors[idx];
+        }
+    }
+
+    return ctx.getAccessor(slot);
+}
+
+void RowToBlockStage::open(bool reOpen) {
+    auto optTimer(getOptTimer(_opCtx));
+
+    _commonStats.opens++;
+    _children[0]->open(reOpen);
+    _childExhausted = false;
+}
+
+PlanState RowToBlockStage::getNext() {
+    auto optTimer(getOptTimer(_opCtx));
+
+    if (_childExhausted) {
+        return trackPlanState(PlanState::IS_EOF);
+    }
+
+    std::vector<std::unique_ptr<value::ValueBlock>> blocks;
+    blocks.reserve(_inAccessors.size());
+    for (size_t idx = 0; idx < _inAccessors.size(); ++idx) {
+        blocks.emplace_back(std::make_unique<value::ValueBlock>());
+        blocks.back()->reserve(_blockSize);
+    }
+
+    // The values of the batch are copied into the blocks, so there is no need to save the state
+    // of the slots of the child in case it yields.
+    disableSlotAccess();
+    size_t numRows = 0;
+    while (numRows < _blockSize) {
+        auto state = _children[0]->getNext();
+        if (state != PlanState::ADVANCED) {
+            _childExhausted = true;
+            break;
+        }
+
+        // The values of the other slots which are views into the BSON object of the first slot,
+        // such as the fields of a scanned record, are stored as views into the copy of that object
+        // rather than being copied one by one.
+        auto [viewBaseTag, viewBaseVal] = _inAccessors[0]->getViewOfValue();
+        const char* viewBase = nullptr;
+        size_t viewBaseSize = 0;
+        if (viewBaseTag == value::TypeTags::bsonObject) {
+            viewBase = value::bitcastTo<const char*>(viewBaseVal);
+            viewBaseSize = ConstDataView(viewBase).read<LittleEndian<int32_t>>();
+        }
+
+        auto [copyTag, copyVal] = _inAccessors[0]->copyOrMoveValue();
+        blocks[0]->push_back(copyTag, copyVal);
+        const char* copyBase =
+            viewBase ? value::bitcastTo<const char*>(copyVal) : static_cast<const char*>(nullptr);
+
+        for (size_t idx = 1; idx < _inAccessors.size(); ++idx) {
+            auto [tag, val] = _inAccessors[idx]->getViewOfValue();
+            if (viewBase && !value::isShallowType(tag)) {
+                auto ptr = value::bitcastTo<const char*>(val);
+                if (ptr >= viewBase && ptr < viewBase + viewBaseSize) {
+                    blocks[idx]->pushBackView(
+                        tag, value::bitcastFrom<const char*>(copyBase + (ptr - viewBase)));
+                    continue;
+                }
+            }
+            std::tie(tag, val) = _inAccessors[idx]->copyOrMoveValue();
+            blocks[idx]->push_back(tag, val);
+        }
+        ++numRows;
+    }
+
+    if (numRows == 0) {
+        return trackPlanState(PlanState::IS_EOF);
+    }
+
+    for (size_t idx = 0; idx < blocks.size(); ++idx) {
+        _outAccessors[idx].reset(true,
+                                 value::TypeTags::valueBlock,
+                                 value::bitcastFrom<value::ValueBlock*>(blocks[idx].release()));
+    }
+
+    return trackPlanState(PlanState::ADVANCED);
+}
+
+void RowToBlockStage::close() {
+    auto optTimer(getOptTimer(_opCtx));
+
+    trackClose();
+    _children[0]->close();
+    for (auto& accessor : _outAccessors) {
+        accessor.reset();
+    }
+}
+
+std::unique_ptr<PlanStageStats> RowToBlockStage::getStats(bool includeDebugInfo) const {
+    auto ret = std::make_unique<PlanStageStats>(_commonStats);
+
+    if (includeDebugInfo) {
+        BSONObjBuilder bob;
+        bob.append("inputSlots", _inputSlots.begin(), _inputSlots.end());
+        bob.append("outputSlots", _outputSlots.begin(), _outputSlots.end());
+        bob.appendNumber("blockSize", static_cast<long long>(_blockSize));
+        ret->debugInfo = bob.obj();
+    }
+
+    ret->children.emplace_back(_children[0]->getStats(includeDebugInfo));
+    return ret;
+}
+
+const SpecificStats* RowToBlockStage::getSpecificStats() const {
+    return nullptr;
+}
+
+std::vector<DebugPrinter::Block> RowToBlockStage::debugPrint() const {
+    auto ret = PlanStage::debugPrint();
+
+    ret.emplace_back(DebugPrinter::Block("[`"));
+    for (size_t idx = 0; idx < _outputSlots.size(); ++idx) {
+        if (idx) {
+            ret.emplace_back(DebugPrinter::Block("`,"));
+        }
+        DebugPrinter::addIdentifier(ret, _outputSlots[idx]);
+    }
+    ret.emplace_back(DebugPrinter::Block("`]"));
+
+    ret.emplace_back(DebugPrinter::Block("[`"));
+    for (size_t idx = 0; idx < _inputSlots.size(); ++idx) {
+        if (idx) {
+            ret.emplace_back(DebugPrinter::Block("`,"));
+        }
+        DebugPrinter::addIdentifier(ret, _inputSlots[idx]);
+    }
+    ret.emplace_back(DebugPrinter::Block("`]"));
+
+    ret.emplace_back(std::to_string(_blockSize));
+
+    DebugPrinter::addNewLine(ret);
+    DebugPrinter::addBlocks(ret, _children[0]->debugPrint());
+
+    return ret;
+}
+
+size_t RowToBlockStage::estimateCompileTimeSize() const {
+    size_t size = sizeof(*this);
+    size += size_estimator::estimate(_children);
+    size += size_estimator::estimate(_inputSlots);
+    size += size_estimator::estimate(_outputSlots);
+    return size;
+}
+}  // namespace mongo::sbe
@@ -0,0 +1,86 @@
+/**
+ *    Copyright (C) 2022-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include "mongo/db/exec/sbe/stages/stages.h"
+
+namespace mongo::sbe {
+/**
+ * Groups up to 'blockSize' consecutive rows of the child stage into a batch. For each of the
+ * 'inputSlots' the values of the batch are copied into a value::ValueBlock, which is exposed in the
+ * corresponding slot of 'outputSlots'. Expressions over the output slots can then use the
+ * 'valueBlock*' builtins to process the whole batch at once, and a BlockToRowStage can turn the
+ * batch back into individual rows.
+ *
+ * If the first input slot holds a BSON object, the values of the other input slots which point
+ * into that object are not copied. Their blocks hold views into the copy of the object held by the
+ * first block, so the first block must outlive them.
+ *
+ * This is a binding reflector: only the 'outputSlots' are visible to the stages above.
+ *
+ * Debug string representation:
+ *
+ *   row_to_block [<output slots>] [<input slots>] blockSize childStage
+ */
+class RowToBlockStage final : public PlanStage {
+public:
+    RowToBlockStage(std::unique_ptr<PlanStage> input,
+                    value::SlotVector inputSlots,
+                    value::SlotVector outputSlots,
+                    size_t blockSize,
+                    PlanNodeId planNodeId);
+
+    std::unique_ptr<PlanStage> clone() const final;
+
+    void prepare(CompileCtx& ctx) final;
+    value::SlotAccessor* getAccessor(CompileCtx& ctx, value::SlotId slot) final;
+    void open(bool reOpen) final;
+    PlanState getNext() final;
+    void close() final;
+
+    std::unique_ptr<PlanStageStats> getStats(bool includeDebugInfo) const final;
+    const SpecificStats* getSpecificStats() const final;
+    std::vector<DebugPrinter::Block> debugPrint() const final;
+    size_t estimateCompileTimeSize() const final;
+
+private:
+    const value::SlotVector _inputSlots;
+    const value::SlotVector _outputSlots;
+    const size_t _blockSize;
+
+    std::vector<value::SlotAccessor*> _inAccessors;
+    std::vector<value::OwnedValueAccessor> _outAccessors;
+
+    // Set once the child has returned EOF, so that we do not call getNext() on it again after the
+    // last, partially filled batch has been returned.
+    bool _childExhausted{false};
+};
+}  // namespace mongo::sbe
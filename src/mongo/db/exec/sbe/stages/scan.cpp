@@ -34,8 +34,10 @@
 #include "mongo/config.h"
 #include "mongo/db/exec/sbe/expressions/expression.h"
 #include "mongo/db/exec/sbe/size_estimator.h"
+#include "mongo/db/exec/sbe/stages/exchange.h"
 #include "mongo/db/exec/trial_run_tracker.h"
 #include "mongo/db/index/index_access_method.h"
+#include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/db/repl/optime.h"
 #include "mongo/util/str.h"
 
@@ -194,6 +196,13 @@ void ScanStage::doSaveState(bool relinquishCursor) {
         }
     }
 
+    // The records that have been read ahead must outlive the position of the cursor.
+    if (relinquishCursor) {
+        for (auto it = _batch.begin() + _batchPos; it != _batch.end(); ++it) {
+            it->data.makeOwned();
+        }
+    }
+
 #if defined(MONGO_CONFIG_DEBUG_BUILD)
     if (!_recordAccessor || !slotsAccessible()) {
         _lastReturned.clear();
@@ -333,16 +342,41 @@ void ScanStage::open(bool reOpen) {
                 _randomCursor = _coll->getRecordStore()->getRandomCursor(_opCtx);
             } else {
                 _cursor = _coll->getCursor(_opCtx, _forward);
+                // A scan that does not seek reads the collection from one end.
+                if (!_seekKeyAccessor) {
+                    _cursor->enableReadAhead();
+                }
             }
         }
     } else {
         MONGO_UNREACHABLE_TASSERT(5959701);
     }
 
+    // Seeking and random scans return the record under the cursor, and capped collections must
+    // check the position of the cursor after every yield, so neither reads ahead.
+    _readsInBatches = !_seekKeyAccessor && !_useRandomCursor && !_coll->isCapped() &&
+        internalQueryExecMaxScanBatchSize.load() > 1;
+    _batch.clear();
+    _batchPos = 0;
+    _batchSize = 1;
+
     _open = true;
     _firstGetNext = true;
 }
 
+const Record* ScanStage::nextFromBatch() {
+    if (_batchPos == _batch.size()) {
+        _batch.clear();
+        _batchPos = 0;
+        if (!_cursor->nextBatch(&_batch, _batchSize)) {
+            return nullptr;
+        }
+        _batchSize = std::min(_batchSize * 2,
+                              static_cast<size_t>(internalQueryExecMaxScanBatchSize.load()));
+    }
+    return &_batch[_batchPos++];
+}
+
 PlanState ScanStage::getNext() {
     auto optTimer(getOptTimer(_opCtx));
 
@@ -367,8 +401,15 @@ PlanState ScanStage::getNext() {
     }
 
     auto res = _firstGetNext && _seekKeyAccessor;
-    auto nextRecord = _useRandomCursor ? _randomCursor->next()
-                                       : (res ? _cursor->seekExact(_key) : _cursor->next());
+    boost::optional<Record> unbatchedRecord;
+    const Record* nextRecord = nullptr;
+    if (_readsInBatches) {
+        nextRecord = nextFromBatch();
+    } else {
+        unbatchedRecord = _useRandomCursor ? _randomCursor->next()
+                                           : (res ? _cursor->seekExact(_key) : _cursor->next());
+        nextRecord = unbatchedRecord.get_ptr();
+    }
     _firstGetNext = false;
 
     if (!nextRecord) {
@@ -457,6 +498,8 @@ void ScanStage::close() {
     auto optTimer(getOptTimer(_opCtx));
 
     trackClose();
+    _batch.clear();
+    _batchPos = 0;
     _cursor.reset();
     _randomCursor.reset();
     _coll.reset();
@@ -638,7 +681,10 @@ ParallelScanStage::ParallelScanStage(const std::shared_ptr<ParallelState>& state
 }
 
 std::unique_ptr<PlanStage> ParallelScanStage::clone() const {
-    return std::make_unique<ParallelScanStage>(_state,
+    // Only the clones running in the producers of the same exchange split the ranges between them.
+    return std::make_unique<ParallelScanStage>(isCloningForExchangeProducers()
+                                                   ? _state
+                                                   : std::make_shared<ParallelState>(),
                                                _collUuid,
                                                _recordSlot,
                                                _recordIdSlot,
@@ -850,7 +896,18 @@ boost::optional<Record> ParallelScanStage::nextRange() {
     if (_currentRange < _state->ranges.size()) {
         _range = _state->ranges[_currentRange];
 
-        return _range.begin.isNull() ? _cursor->next() : _cursor->seekExact(_range.begin);
+        if (_range.begin.isNull()) {
+            return _cursor->next();
+        }
+
+        // Every producer reads from its own snapshot, so the record at the start of the range may
+        // have been deleted since the ranges were sampled. Position the cursor on the first record
+        // at or after the start of the range instead.
+        auto nextRecord = _cursor->seekNear(_range.begin);
+        if (nextRecord && nextRecord->id < _range.begin) {
+            nextRecord = _cursor->next();
+        }
+        return nextRecord;
     } else {
         return boost::none;
     }
@@ -892,7 +949,7 @@ PlanState ParallelScanStage::getNext() {
             return trackPlanState(PlanState::IS_EOF);
         }
 
-        if (!_range.end.isNull() && nextRecord->id == _range.end) {
+        if (!_range.end.isNull() && nextRecord->id >= _range.end) {
             setNeedsRange();
             nextRecord = boost::none;
             continue;
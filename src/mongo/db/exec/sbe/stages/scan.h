@@ -136,6 +136,11 @@ private:
     // Returns the primary cursor or the random cursor depending on whether _useRandomCursor is set.
     RecordCursor* getActiveCursor() const;
 
+    // Returns the next record of '_batch', reading another batch from '_cursor' once every record
+    // of the current one has been returned, or nullptr at EOF. The record stays in '_batch', so
+    // the slots can keep pointing into its data until the following call.
+    const Record* nextFromBatch();
+
     const UUID _collUuid;
     const boost::optional<value::SlotId> _recordSlot;
     const boost::optional<value::SlotId> _recordIdSlot;
@@ -191,6 +196,14 @@ private:
     RecordId _key;
     bool _firstGetNext{false};
 
+    // Plain scans of uncapped collections read their records from '_cursor' in batches, which start
+    // with a single record and double up to 'internalQueryExecMaxScanBatchSize' for every open().
+    // '_batchPos' is the position of the next record of '_batch' to return.
+    bool _readsInBatches{false};
+    std::vector<Record> _batch;
+    size_t _batchPos{0};
+    size_t _batchSize{1};
+
     ScanStats _specificStats;
 
     // Flag set upon restoring the stage that indicates whether the cursor's position in the
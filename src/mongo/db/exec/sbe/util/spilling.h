@@ -0,0 +1,117 @@
+/**
+ *    Copyright (C) 2022-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <algorithm>
+
+#include "mongo/db/operation_context.h"
+#include "mongo/db/query/query_knobs_gen.h"
+
+namespace mongo {
+namespace sbe {
+/**
+ * Proactively assert that this operation can safely write before hitting an assertion in the
+ * storage engine. We can safely write if we are enforcing prepare conflicts by blocking or if we
+ * are ignoring prepare conflicts and explicitly allowing writes. Ignoring prepare conflicts
+ * without allowing writes will cause this operation to fail in the storage engine.
+ */
+void assertIgnorePrepareConflictsBehavior(OperationContext* opCtx);
+
+/**
+ * Spilling stages check the amount of used memory every T processed incoming records, where T is
+ * calculated based on the estimated used memory and its recent growth. This structure holds the
+ * bookkeeping for that adaptive schedule; the estimation of the memory itself and what to do when
+ * the limit is exceeded is up to the stage.
+ */
+struct MemoryCheckData {
+    const double checkpointMargin = internalQuerySBEAggMemoryUseCheckMargin.load();
+    const long atMostCheckFrequency = internalQuerySBEAggMemoryCheckPerAdvanceAtMost.load();
+    const long atLeastMemoryCheckFrequency = internalQuerySBEAggMemoryCheckPerAdvanceAtLeast.load();
+
+    // The check frequency upper bound, which start at 'atMost' and exponentially backs off
+    // to 'atLeast' as more data is accumulated. If 'atLeast' is less than 'atMost', the memory
+    // checks will be done every 'atLeast' incoming records.
+    long memoryCheckFrequency = 1;
+
+    // The number of incoming records to process before the next memory checkpoint.
+    long nextMemoryCheckpoint = 0;
+
+    // The counter of the incoming records between memory checkpoints.
+    long memoryCheckpointCounter = 0;
+
+    long long lastEstimatedMemoryUsage = 0;
+
+    MemoryCheckData() {
+        memoryCheckFrequency = std::min(atMostCheckFrequency, atLeastMemoryCheckFrequency);
+    }
+
+    /**
+     * Counts one more processed incoming record and returns true if the memory usage must be
+     * checked now.
+     */
+    bool needsMemoryCheck() {
+        memoryCheckpointCounter++;
+        return memoryCheckpointCounter >= nextMemoryCheckpoint;
+    }
+
+    /**
+     * Returns the estimated growth of the used memory per processed incoming record since the
+     * previous checkpoint.
+     */
+    double estimateGainPerChildAdvance(long long estimatedTotalSize) const {
+        return static_cast<double>(estimatedTotalSize - lastEstimatedMemoryUsage) /
+            memoryCheckpointCounter;
+    }
+
+    /**
+     * Calculates the next memory checkpoint. We estimate it based on the prior growth of the
+     * tracked data structure and the remaining available memory. Stages have to keep doing this
+     * even after starting to spill because some values can grow in size in memory (with no
+     * bounds). Value of 'estimatedGainPerChildAdvance' can be negative if the previous checkpoint
+     * evicted any records. And a value close to zero indicates a stable size so can delay the next
+     * check progressively.
+     */
+    void scheduleNextCheckpoint(double estimatedGainPerChildAdvance,
+                                long long estimatedTotalSize,
+                                long long memoryLimit) {
+        const long nextCheckpointCandidate = (estimatedGainPerChildAdvance > 0.1)
+            ? checkpointMargin * (memoryLimit - estimatedTotalSize) / estimatedGainPerChildAdvance
+            : (estimatedGainPerChildAdvance < -0.1) ? atMostCheckFrequency
+                                                    : nextMemoryCheckpoint * 2;
+        nextMemoryCheckpoint = std::min<long>(
+            memoryCheckFrequency, std::max<long>(atMostCheckFrequency, nextCheckpointCandidate));
+
+        lastEstimatedMemoryUsage = estimatedTotalSize;
+        memoryCheckpointCounter = 0;
+        memoryCheckFrequency = std::min<long>(memoryCheckFrequency * 2, atLeastMemoryCheckFrequency);
+    }
+};
+}  // namespace sbe
+}  // namespace mongo
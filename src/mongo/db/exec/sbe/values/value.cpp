@@ -35,6 +35,7 @@
 #include "mongo/db/exec/js_function.h"
 #include "mongo/db/exec/sbe/values/bson.h"
 #include "mongo/db/exec/sbe/values/sort_spec.h"
+#include "mongo/db/exec/sbe/values/value_block.h"
 #include "mongo/db/exec/sbe/values/value_builder.h"
 #include "mongo/db/exec/sbe/values/value_printer.h"
 #include "mongo/db/query/collation/collator_interface.h"
@@ -244,6 +245,11 @@ std::pair<TypeTags, Value> makeCopySortSpec(const SortSpec& ss) {
     return {TypeTags::sortSpec, ssCopy};
 }
 
+std::pair<TypeTags, Value> makeCopyValueBlock(const ValueBlock& block) {
+    auto blockCopy = bitcastFrom<ValueBlock*>(new ValueBlock(block));
+    return {TypeTags::valueBlock, blockCopy};
+}
+
 std::pair<TypeTags, Value> makeCopyCollator(const CollatorInterface& collator) {
     auto collatorCopy = bitcastFrom<CollatorInterface*>(collator.clone().release());
     return {TypeTags::collator, collatorCopy};
@@ -317,6 +323,9 @@ void releaseValue(TypeTags tag, Value val) noexcept {
         case TypeTags::sortSpec:
             delete getSortSpecView(val);
             break;
+        case TypeTags::valueBlock:
+            delete getValueBlockView(val);
+            break;
         case TypeTags::collator:
             delete getCollatorView(val);
             break;
@@ -0,0 +1,151 @@
+/**
+ *    Copyright (C) 2022-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include <vector>
+
+#include "mongo/db/exec/sbe/values/value.h"
+
+namespace mongo::sbe::value {
+/**
+ * A batch of values of a single slot, used by the block-at-a-time execution mode. The tags and the
+ * values are stored column-wise in two parallel vectors so that the 'valueBlock*' builtins can run
+ * tight loops over them. A block owns its values, except for the ones appended as views with
+ * 'pushBackView()', which must outlive the block.
+ */
+class ValueBlock {
+public:
+    ValueBlock() = default;
+
+    ValueBlock(const ValueBlock& other) {
+        reserve(other.size());
+        for (size_t idx = 0; idx < other.size(); ++idx) {
+            auto [tag, val] = copyValue(other._tags[idx], other._vals[idx]);
+            push_back(tag, val);
+        }
+    }
+
+    ValueBlock(ValueBlock&& other) noexcept
+        : _tags(std::move(other._tags)),
+          _vals(std::move(other._vals)),
+          _owned(std::move(other._owned)) {}
+
+    ValueBlock& operator=(const ValueBlock&) = delete;
+    ValueBlock& operator=(ValueBlock&&) = delete;
+
+    ~ValueBlock() {
+        clear();
+    }
+
+    size_t size() const {
+        return _tags.size();
+    }
+
+    bool empty() const {
+        return _tags.empty();
+    }
+
+    void reserve(size_t size) {
+        _tags.reserve(size);
+        _vals.reserve(size);
+        _owned.reserve(size);
+    }
+
+    /**
+     * Appends the value to the block. The block takes the ownership of the value.
+     */
+    void push_back(TypeTags tag, Value val) {
+        _tags.push_back(tag);
+        _vals.push_back(val);
+        _owned.push_back(true);
+    }
+
+    /**
+     * Appends a view of the value to the block. The block does not release the value, so whatever
+     * owns it must outlive the block.
+     */
+    void pushBackView(TypeTags tag, Value val) {
+        _tags.push_back(tag);
+        _vals.push_back(val);
+        _owned.push_back(false);
+    }
+
+    /**
+     * Appends 'size' values with the same tag. The values must not own any memory.
+     */
+    void appendShallow(TypeTags tag, const Value* vals, size_t size) {
+        _tags.insert(_tags.end(), size, tag);
+        _vals.insert(_vals.end(), vals, vals + size);
+        _owned.insert(_owned.end(), size, false);
+    }
+
+    std::pair<TypeTags, Value> at(size_t idx) const {
+        return {_tags[idx], _vals[idx]};
+    }
+
+    const TypeTags* tags() const {
+        return _tags.data();
+    }
+
+    const Value* vals() const {
+        return _vals.data();
+    }
+
+    /**
+     * Returns true if every value in the block has the given 'tag'.
+     */
+    bool allOfType(TypeTags tag) const {
+        for (auto t : _tags) {
+            if (t != tag) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void clear() {
+        for (size_t idx = 0; idx < _tags.size(); ++idx) {
+            if (_owned[idx]) {
+                releaseValue(_tags[idx], _vals[idx]);
+            }
+        }
+        _tags.clear();
+        _vals.clear();
+        _owned.clear();
+    }
+
+private:
+    std::vector<TypeTags> _tags;
+    std::vector<Value> _vals;
+    // Whether the block has to release the value at the same position in '_vals'.
+    std::vector<bool> _owned;
+};
+}  // namespace mongo::sbe::value
@@ -29,6 +29,7 @@
 #include "mongo/db/exec/sbe/values/value_printer.h"
 #include "mongo/db/exec/sbe/values/sort_spec.h"
 #include "mongo/db/exec/sbe/values/value.h"
+#include "mongo/db/exec/sbe/values/value_block.h"
 #include "mongo/platform/basic.h"
 
 namespace mongo::sbe::value {
@@ -153,6 +154,9 @@ void ValuePrinter<T>::writeTagToStream(TypeTags tag) {
         case TypeTags::sortSpec:
             stream << "sortSpec";
             break;
+        case TypeTags::valueBlock:
+            stream << "valueBlock";
+            break;
         default:
             stream << "unknown tag";
             break;
@@ -460,6 +464,23 @@ void ValuePrinter<T>::writeValueToStream(TypeTags tag, Value val, size_t depth)
             writeCollatorToStream(getSortSpecView(val)->getCollator());
             stream << ')';
             break;
+        case TypeTags::valueBlock: {
+            auto block = getValueBlockView(val);
+            stream << "ValueBlock([";
+            for (size_t idx = 0; idx < block->size(); ++idx) {
+                if (idx > 0) {
+                    stream << ", ";
+                }
+                if (idx == options.arrayObjectOrNestingMaxDepth()) {
+                    stream << "...";
+                    break;
+                }
+                auto [elemTag, elemVal] = block->at(idx);
+                writeValueToStream(elemTag, elemVal, depth + 1);
+            }
+            stream << "])";
+            break;
+        }
         default:
             MONGO_UNREACHABLE;
     }
@@ -503,6 +503,60 @@ void ByteCode::aggDoubleDoubleSumImpl(value::Array* arr,
     }
 }
 
+void ByteCode::aggMergeDoubleDoubleSumsImpl(value::Array* arr, const value::Array* rhsArr) {
+    for (auto partialSum : {static_cast<const value::Array*>(arr), rhsArr}) {
+        tassert(7131302,
+                str::stream() << "The partial sum must have at least "
+                              << AggSumValueElems::kMaxSizeOfArray - 1
+                              << " elements but got: " << partialSum->size(),
+                partialSum->size() >= AggSumValueElems::kMaxSizeOfArray - 1);
+        tassert(7131303,
+                "The sum and addend must be NumberDouble",
+                partialSum->getAt(AggSumValueElems::kNonDecimalTotalSum).first ==
+                        TypeTags::NumberDouble &&
+                    partialSum->getAt(AggSumValueElems::kNonDecimalTotalAddend).first ==
+                        TypeTags::NumberDouble);
+    }
+
+    auto nonDecimalTotalTag =
+        getWidestNumericalType(arr->getAt(AggSumValueElems::kNonDecimalTotalTag).first,
+                               rhsArr->getAt(AggSumValueElems::kNonDecimalTotalTag).first);
+    tassert(7131304,
+            "The nonDecimalTag can't be NumberDecimal",
+            nonDecimalTotalTag != TypeTags::NumberDecimal);
+
+    // Merges the non-decimal totals the same way the classic $sum accumulator merges the partial
+    // sums of the shards.
+    auto nonDecimalTotal = DoubleDoubleSummation::create(
+        value::bitcastTo<double>(arr->getAt(AggSumValueElems::kNonDecimalTotalSum).second),
+        value::bitcastTo<double>(arr->getAt(AggSumValueElems::kNonDecimalTotalAddend).second));
+    nonDecimalTotal.addDouble(
+        value::bitcastTo<double>(rhsArr->getAt(AggSumValueElems::kNonDecimalTotalSum).second));
+    nonDecimalTotal.addDouble(
+        value::bitcastTo<double>(rhsArr->getAt(AggSumValueElems::kNonDecimalTotalAddend).second));
+
+    if (rhsArr->size() < AggSumValueElems::kMaxSizeOfArray) {
+        // The 'rhsArr' has not seen any decimal value, so the decimal total stays as it is.
+        setNonDecimalTotal(nonDecimalTotalTag, nonDecimalTotal, arr);
+        return;
+    }
+
+    auto [rhsDecimalTotalTag, rhsDecimalTotalVal] = rhsArr->getAt(AggSumValueElems::kDecimalTotal);
+    tassert(7131305,
+            "The decimalTotal must be NumberDecimal",
+            rhsDecimalTotalTag == TypeTags::NumberDecimal);
+    auto decimalTotal = value::bitcastTo<Decimal128>(rhsDecimalTotalVal);
+    if (arr->size() == AggSumValueElems::kMaxSizeOfArray) {
+        auto [decimalTotalTag, decimalTotalVal] = arr->getAt(AggSumValueElems::kDecimalTotal);
+        tassert(7131306,
+                "The decimalTotal must be NumberDecimal",
+                decimalTotalTag == TypeTags::NumberDecimal);
+        decimalTotal = value::bitcastTo<Decimal128>(decimalTotalVal).add(decimalTotal);
+    }
+
+    setDecimalTotal(nonDecimalTotalTag, nonDecimalTotal, decimalTotal, arr);
+}
+
 void ByteCode::aggStdDevImpl(value::Array* arr, value::TypeTags rhsTag, value::Value rhsValue) {
     if (!isNumber(rhsTag)) {
         return;
@@ -0,0 +1,717 @@
+/**
+ *    Copyright (C) 2022-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOGV2_DEFAULT_COMPONENT ::mongo::logv2::LogComponent::kQuery
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/exec/sbe/vm/native_code.h"
+
+#if defined(__x86_64__) && defined(__linux__)
+#include <sys/mman.h>
+#include <unistd.h>
+#define MONGO_SBE_HAVE_NATIVE_CODE 1
+#endif
+
+#include "mongo/db/exec/sbe/vm/vm.h"
+#include "mongo/logv2/log.h"
+#include "mongo/util/errno_util.h"
+
+namespace mongo {
+namespace sbe {
+namespace vm {
+/**
+ * The helpers called by the native code, one per supported instruction. Each of them does exactly
+ * what the interpreter does for the instruction, and returns 0, or 'NativeCode::kException' after
+ * storing the exception thrown by the instruction in the ByteCode. The helpers of the conditional
+ * jumps return 1 if the jump is taken.
+ */
+struct NativeCodeTemplates {
+    template <typename F>
+    static int32_t guard(ByteCode* bytecode, F&& f) noexcept {
+        try {
+            f();
+            return 0;
+        } catch (...) {
+            bytecode->_nativeException = std::current_exception();
+            return NativeCode::kException;
+        }
+    }
+
+    static int32_t pushConstVal(ByteCode* bytecode, value::TypeTags tag, value::Value val) {
+        return guard(bytecode, [&] { bytecode->pushStack(false, tag, val); });
+    }
+
+    static int32_t pushAccessVal(ByteCode* bytecode, value::SlotAccessor* accessor) {
+        return guard(bytecode, [&] {
+            auto [tag, val] = accessor->getViewOfValue();
+            bytecode->pushStack(false, tag, val);
+        });
+    }
+
+    static int32_t pushMoveVal(ByteCode* bytecode, value::SlotAccessor* accessor) {
+        return guard(bytecode, [&] {
+            auto [tag, val] = accessor->copyOrMoveValue();
+            bytecode->pushStack(true, tag, val);
+        });
+    }
+
+    static int32_t pushLocalVal(ByteCode* bytecode, int stackOffset) {
+        return guard(bytecode, [&] {
+            auto [owned, tag, val] = bytecode->getFromStack(stackOffset);
+            bytecode->pushStack(false, tag, val);
+        });
+    }
+
+    static int32_t pushMoveLocalVal(ByteCode* bytecode, int stackOffset) {
+        return guard(bytecode, [&] {
+            auto [owned, tag, val] = bytecode->getFromStack(stackOffset);
+            bytecode->setStack(stackOffset, false, value::TypeTags::Nothing, 0);
+            bytecode->pushStack(owned, tag, val);
+        });
+    }
+
+    static int32_t pushLocalLambda(ByteCode* bytecode, int64_t position) {
+        return guard(bytecode, [&] {
+            bytecode->pushStack(
+                false, value::TypeTags::LocalLambda, value::bitcastFrom<int64_t>(position));
+        });
+    }
+
+    static int32_t pop(ByteCode* bytecode) {
+        bytecode->popAndReleaseStack();
+        return 0;
+    }
+
+    static int32_t swap(ByteCode* bytecode) {
+        bytecode->swapStack();
+        return 0;
+    }
+
+    template <std::tuple<bool, value::TypeTags, value::Value> (ByteCode::*Op)(
+        value::TypeTags, value::Value, value::TypeTags, value::Value)>
+    static int32_t arithmetic(ByteCode* bytecode) {
+        return guard(bytecode, [&] {
+            auto [rhsOwned, rhsTag, rhsVal] = bytecode->getFromStack(0);
+            bytecode->popStack();
+            auto [lhsOwned, lhsTag, lhsVal] = bytecode->getFromStack(0);
+
+            auto [owned, tag, val] = (bytecode->*Op)(lhsTag, lhsVal, rhsTag, rhsVal);
+
+            bytecode->topStack(owned, tag, val);
+
+            if (rhsOwned) {
+                value::releaseValue(rhsTag, rhsVal);
+            }
+            if (lhsOwned) {
+                value::releaseValue(lhsTag, lhsVal);
+            }
+        });
+    }
+
+    static int32_t add(ByteCode* bytecode) {
+        return arithmetic<&ByteCode::genericAdd>(bytecode);
+    }
+
+    static int32_t sub(ByteCode* bytecode) {
+        return arithmetic<&ByteCode::genericSub>(bytecode);
+    }
+
+    static int32_t mul(ByteCode* bytecode) {
+        return arithmetic<&ByteCode::genericMul>(bytecode);
+    }
+
+    static int32_t div(ByteCode* bytecode) {
+        return arithmetic<&ByteCode::genericDiv>(bytecode);
+    }
+
+    static int32_t logicNot(ByteCode* bytecode) {
+        return guard(bytecode, [&] {
+            auto [owned, tag, val] = bytecode->getFromStack(0);
+
+            auto [resultTag, resultVal] = bytecode->genericNot(tag, val);
+
+            bytecode->topStack(false, resultTag, resultVal);
+
+            if (owned) {
+                value::releaseValue(tag, val);
+            }
+        });
+    }
+
+    template <typename Op, bool Negate = false>
+    static int32_t compare(ByteCode* bytecode) {
+        return guard(bytecode, [&] {
+            auto [rhsOwned, rhsTag, rhsVal] = bytecode->getFromStack(0);
+            bytecode->popStack();
+            auto [lhsOwned, lhsTag, lhsVal] = bytecode->getFromStack(0);
+
+            auto [tag, val] = genericCompare<Op>(lhsTag, lhsVal, rhsTag, rhsVal);
+            if constexpr (Negate) {
+                std::tie(tag, val) = bytecode->genericNot(tag, val);
+            }
+
+            bytecode->topStack(false, tag, val);
+
+            if (rhsOwned) {
+                value::releaseValue(rhsTag, rhsVal);
+            }
+            if (lhsOwned) {
+                value::releaseValue(lhsTag, lhsVal);
+            }
+        });
+    }
+
+    static int32_t cmp3w(ByteCode* bytecode) {
+        return guard(bytecode, [&] {
+            auto [rhsOwned, rhsTag, rhsVal] = bytecode->getFromStack(0);
+            bytecode->popStack();
+            auto [lhsOwned, lhsTag, lhsVal] = bytecode->getFromStack(0);
+
+            auto [tag, val] = bytecode->compare3way(lhsTag, lhsVal, rhsTag, rhsVal);
+
+            bytecode->topStack(false, tag, val);
+
+            if (rhsOwned) {
+                value::releaseValue(rhsTag, rhsVal);
+            }
+            if (lhsOwned) {
+                value::releaseValue(lhsTag, lhsVal);
+            }
+        });
+    }
+
+    static int32_t fillEmpty(ByteCode* bytecode) {
+        auto [rhsOwned, rhsTag, rhsVal] = bytecode->getFromStack(0);
+        bytecode->popStack();
+        auto [lhsOwned, lhsTag, lhsVal] = bytecode->getFromStack(0);
+
+        if (lhsTag == value::TypeTags::Nothing) {
+            bytecode->topStack(rhsOwned, rhsTag, rhsVal);
+
+            if (lhsOwned) {
+                value::releaseValue(lhsTag, lhsVal);
+            }
+        } else {
+            if (rhsOwned) {
+                value::releaseValue(rhsTag, rhsVal);
+            }
+        }
+        return 0;
+    }
+
+    static int32_t getField(ByteCode* bytecode) {
+        return guard(bytecode, [&] {
+            auto [rhsOwned, rhsTag, rhsVal] = bytecode->getFromStack(0);
+            bytecode->popStack();
+            auto [lhsOwned, lhsTag, lhsVal] = bytecode->getFromStack(0);
+
+            auto [owned, tag, val] = bytecode->getField(lhsTag, lhsVal, rhsTag, rhsVal);
+
+            bytecode->topStack(owned, tag, val);
+
+            if (rhsOwned) {
+                value::releaseValue(rhsTag, rhsVal);
+            }
+            if (lhsOwned) {
+                value::releaseValue(lhsTag, lhsVal);
+            }
+        });
+    }
+
+    static int32_t traverseP(ByteCode* bytecode, const CodeFragment* code) {
+        return guard(bytecode, [&] {
+            auto [owned, tag, val] = bytecode->traverseP(code);
+            for (uint8_t cnt = 0; cnt < 2; ++cnt) {
+                bytecode->popAndReleaseStack();
+            }
+
+            bytecode->pushStack(owned, tag, val);
+        });
+    }
+
+    static int32_t traverseF(ByteCode* bytecode, const CodeFragment* code) {
+        return guard(bytecode, [&] {
+            auto [owned, tag, val] = bytecode->traverseF(code);
+            for (uint8_t cnt = 0; cnt < 3; ++cnt) {
+                bytecode->popAndReleaseStack();
+            }
+
+            bytecode->pushStack(owned, tag, val);
+        });
+    }
+
+    static int32_t exists(ByteCode* bytecode) {
+        auto [owned, tag, val] = bytecode->getFromStack(0);
+
+        bytecode->topStack(false,
+                           value::TypeTags::Boolean,
+                           value::bitcastFrom<bool>(tag != value::TypeTags::Nothing));
+
+        if (owned) {
+            value::releaseValue(tag, val);
+        }
+        return 0;
+    }
+
+    template <bool (*Check)(value::TypeTags)>
+    static int32_t checkType(ByteCode* bytecode) {
+        auto [owned, tag, val] = bytecode->getFromStack(0);
+
+        if (tag != value::TypeTags::Nothing) {
+            bytecode->topStack(
+                false, value::TypeTags::Boolean, value::bitcastFrom<bool>(Check(tag)));
+        }
+
+        if (owned) {
+            value::releaseValue(tag, val);
+        }
+        return 0;
+    }
+
+    static bool isNullTag(value::TypeTags tag) {
+        return tag == value::TypeTags::Null;
+    }
+
+    static int32_t function(ByteCode* bytecode, Builtin f, ArityType arity) {
+        return guard(bytecode, [&] {
+            auto [owned, tag, val] = bytecode->dispatchBuiltin(f, arity);
+
+            for (ArityType cnt = 0; cnt < arity; ++cnt) {
+                bytecode->popAndReleaseStack();
+            }
+
+            bytecode->pushStack(owned, tag, val);
+        });
+    }
+
+    static int32_t jmpTrue(ByteCode* bytecode) {
+        auto [owned, tag, val] = bytecode->getFromStack(0);
+        bytecode->popStack();
+
+        bool jump = tag == value::TypeTags::Boolean && value::bitcastTo<bool>(val);
+
+        if (owned) {
+            value::releaseValue(tag, val);
+        }
+        return jump;
+    }
+
+    static int32_t jmpNothing(ByteCode* bytecode) {
+        auto [owned, tag, val] = bytecode->getFromStack(0);
+        return tag == value::TypeTags::Nothing;
+    }
+
+    static int32_t fail(ByteCode* bytecode) {
+        return guard(bytecode, [&] {
+            auto [ownedCode, tagCode, valCode] = bytecode->getFromStack(1);
+            invariant(tagCode == value::TypeTags::NumberInt64);
+
+            auto [ownedMsg, tagMsg, valMsg] = bytecode->getFromStack(0);
+            invariant(value::isString(tagMsg));
+
+            ErrorCodes::Error code{
+                static_cast<ErrorCodes::Error>(value::bitcastTo<int64_t>(valCode))};
+            std::string message{value::getStringView(tagMsg, valMsg)};
+
+            uasserted(code, message);
+        });
+    }
+};
+
+#ifdef MONGO_SBE_HAVE_NATIVE_CODE
+namespace {
+template <typename T>
+T readFromMemory(const uint8_t* ptr) noexcept {
+    T val;
+    memcpy(&val, ptr, sizeof(T));
+    return val;
+}
+
+/**
+ * Emits the x86-64 machine code of the templates. The native code follows the System V calling
+ * convention: it receives the ByteCode in 'rdi' and the CodeFragment in 'rsi', and keeps them in
+ * the callee-saved registers 'rbx' and 'r12' so that it can pass them to the helpers.
+ */
+class Emitter {
+public:
+    enum Register : uint8_t { rsi = 0xBE, rdx = 0xBA };
+
+    size_t size() const {
+        return _code.size();
+    }
+
+    const uint8_t* data() const {
+        return _code.data();
+    }
+
+    void prologue() {
+        emit({0x55});              // push rbp
+        emit({0x48, 0x89, 0xE5});  // mov rbp, rsp
+        emit({0x53});              // push rbx
+        emit({0x41, 0x54});        // push r12
+        emit({0x48, 0x89, 0xFB});  // mov rbx, rdi
+        emit({0x49, 0x89, 0xF4});  // mov r12, rsi
+    }
+
+    /**
+     * Returns with 'eax' holding 0, or 'NativeCode::kException' if 'exception' is true.
+     */
+    void epilogue(bool exception) {
+        if (exception) {
+            emit({0xB8});  // mov eax, imm32
+            emitImm<int32_t>(NativeCode::kException);
+        } else {
+            emit({0x31, 0xC0});  // xor eax, eax
+        }
+        emit({0x41, 0x5C});  // pop r12
+        emit({0x5B});        // pop rbx
+        emit({0x5D});        // pop rbp
+        emit({0xC3});        // ret
+    }
+
+    void loadImm(Register reg, uint64_t imm) {
+        emit({0x48, reg});  // mov reg, imm64
+        emitImm(imm);
+    }
+
+    void loadCode() {
+        emit({0x4C, 0x89, 0xE6});  // mov rsi, r12
+    }
+
+    void call(const void* fn) {
+        emit({0x48, 0x89, 0xDF});  // mov rdi, rbx
+        emit({0x48, 0xB8});        // mov rax, imm64
+        emitImm(reinterpret_cast<uint64_t>(fn));
+        emit({0xFF, 0xD0});  // call rax
+    }
+
+    /**
+     * Emits a jump, taken if the result of the last call is negative, non-zero, or always. Returns
+     * the position of its displacement for 'patch()'.
+     */
+    size_t jumpIfNegative() {
+        emit({0x85, 0xC0, 0x0F, 0x88});  // test eax, eax; js rel32
+        return emitDisplacement();
+    }
+
+    size_t jumpIfNonZero() {
+        emit({0x85, 0xC0, 0x0F, 0x85});  // test eax, eax; jnz rel32
+        return emitDisplacement();
+    }
+
+    size_t jump() {
+        emit({0xE9});  // jmp rel32
+        return emitDisplacement();
+    }
+
+    void patch(size_t displacement, size_t target) {
+        int32_t rel = static_cast<int32_t>(target) - static_cast<int32_t>(displacement + 4);
+        memcpy(_code.data() + displacement, &rel, sizeof(rel));
+    }
+
+private:
+    void emit(std::initializer_list<uint8_t> bytes) {
+        _code.insert(_code.end(), bytes);
+    }
+
+    template <typename T>
+    void emitImm(T imm) {
+        auto oldSize = _code.size();
+        _code.resize(oldSize + sizeof(T));
+        memcpy(_code.data() + oldSize, &imm, sizeof(T));
+    }
+
+    size_t emitDisplacement() {
+        auto displacement = _code.size();
+        emitImm<int32_t>(0);
+        return displacement;
+    }
+
+    std::vector<uint8_t> _code;
+};
+}  // namespace
+#endif
+
+std::unique_ptr<NativeCode> NativeCode::compile(const CodeFragment& code) {
+#ifdef MONGO_SBE_HAVE_NATIVE_CODE
+    using T = NativeCodeTemplates;
+
+    const auto pcBegin = code.instrs().data();
+    const auto codeSize = code.instrs().size();
+    auto pcPointer = pcBegin;
+    auto pcEnd = pcBegin + codeSize;
+
+    Emitter emitter;
+    emitter.prologue();
+
+    // The position in the native code of each instruction, indexed by its position in the bytecode.
+    // The end of the bytecode maps to the epilogue.
+    std::vector<int64_t> labels(codeSize + 1, -1);
+    // The jumps to patch once all of the labels are known, as the positions of their displacement
+    // in the native code and of their target in the bytecode.
+    std::vector<std::pair<size_t, size_t>> jumps;
+    std::vector<size_t> exceptionJumps;
+
+    auto callAndCheck = [&](const void* fn) {
+        emitter.call(fn);
+        exceptionJumps.push_back(emitter.jumpIfNegative());
+    };
+    auto jumpTarget = [&](int jumpOffset) -> boost::optional<size_t> {
+        auto target = pcPointer - pcBegin + jumpOffset;
+        if (target < 0 || target > static_cast<int64_t>(codeSize)) {
+            return boost::none;
+        }
+        return static_cast<size_t>(target);
+    };
+
+    while (pcPointer != pcEnd) {
+        labels[pcPointer - pcBegin] = emitter.size();
+
+        auto i = readFromMemory<Instruction>(pcPointer);
+        pcPointer += sizeof(i);
+        switch (i.tag) {
+            case Instruction::pushConstVal: {
+                auto tag = readFromMemory<value::TypeTags>(pcPointer);
+                pcPointer += sizeof(tag);
+                auto val = readFromMemory<value::Value>(pcPointer);
+                pcPointer += sizeof(val);
+
+                emitter.loadImm(Emitter::rsi, static_cast<uint64_t>(tag));
+                emitter.loadImm(Emitter::rdx, val);
+                callAndCheck(reinterpret_cast<const void*>(&T::pushConstVal));
+                break;
+            }
+            case Instruction::pushAccessVal:
+            case Instruction::pushMoveVal: {
+                auto accessor = readFromMemory<value::SlotAccessor*>(pcPointer);
+                pcPointer += sizeof(accessor);
+
+                emitter.loadImm(Emitter::rsi, reinterpret_cast<uint64_t>(accessor));
+                callAndCheck(i.tag == Instruction::pushAccessVal
+                                 ? reinterpret_cast<const void*>(&T::pushAccessVal)
+                                 : reinterpret_cast<const void*>(&T::pushMoveVal));
+                break;
+            }
+            case Instruction::pushLocalVal:
+            case Instruction::pushMoveLocalVal: {
+                auto stackOffset = readFromMemory<int>(pcPointer);
+                pcPointer += sizeof(stackOffset);
+
+                emitter.loadImm(Emitter::rsi, static_cast<uint64_t>(stackOffset));
+                callAndCheck(i.tag == Instruction::pushLocalVal
+                                 ? reinterpret_cast<const void*>(&T::pushLocalVal)
+                                 : reinterpret_cast<const void*>(&T::pushMoveLocalVal));
+                break;
+            }
+            case Instruction::pushLocalLambda: {
+                auto offset = readFromMemory<int>(pcPointer);
+                pcPointer += sizeof(offset);
+                auto position = jumpTarget(offset);
+                if (!position) {
+                    return nullptr;
+                }
+
+                emitter.loadImm(Emitter::rsi, *position);
+                callAndCheck(reinterpret_cast<const void*>(&T::pushLocalLambda));
+                break;
+            }
+            case Instruction::pop:
+                emitter.call(reinterpret_cast<const void*>(&T::pop));
+                break;
+            case Instruction::swap:
+                emitter.call(reinterpret_cast<const void*>(&T::swap));
+                break;
+            case Instruction::add:
+                callAndCheck(reinterpret_cast<const void*>(&T::add));
+                break;
+            case Instruction::sub:
+                callAndCheck(reinterpret_cast<const void*>(&T::sub));
+                break;
+            case Instruction::mul:
+                callAndCheck(reinterpret_cast<const void*>(&T::mul));
+                break;
+            case Instruction::div:
+                callAndCheck(reinterpret_cast<const void*>(&T::div));
+                break;
+            case Instruction::logicNot:
+                callAndCheck(reinterpret_cast<const void*>(&T::logicNot));
+                break;
+            case Instruction::less:
+                callAndCheck(reinterpret_cast<const void*>(&T::compare<std::less<>>));
+                break;
+            case Instruction::lessEq:
+                callAndCheck(reinterpret_cast<const void*>(&T::compare<std::less_equal<>>));
+                break;
+            case Instruction::greater:
+                callAndCheck(reinterpret_cast<const void*>(&T::compare<std::greater<>>));
+                break;
+            case Instruction::greaterEq:
+                callAndCheck(reinterpret_cast<const void*>(&T::compare<std::greater_equal<>>));
+                break;
+            case Instruction::eq:
+                callAndCheck(reinterpret_cast<const void*>(&T::compare<std::equal_to<>>));
+                break;
+            case Instruction::neq:
+                callAndCheck(reinterpret_cast<const void*>(&T::compare<std::equal_to<>, true>));
+                break;
+            case Instruction::cmp3w:
+                callAndCheck(reinterpret_cast<const void*>(&T::cmp3w));
+                break;
+            case Instruction::fillEmpty:
+                emitter.call(reinterpret_cast<const void*>(&T::fillEmpty));
+                break;
+            case Instruction::getField:
+                callAndCheck(reinterpret_cast<const void*>(&T::getField));
+                break;
+            case Instruction::traverseP:
+            case Instruction::traverseF:
+                emitter.loadCode();
+                callAndCheck(i.tag == Instruction::traverseP
+                                 ? reinterpret_cast<const void*>(&T::traverseP)
+                                 : reinterpret_cast<const void*>(&T::traverseF));
+                break;
+            case Instruction::exists:
+                emitter.call(reinterpret_cast<const void*>(&T::exists));
+                break;
+            case Instruction::isNull:
+                emitter.call(reinterpret_cast<const void*>(&T::checkType<&T::isNullTag>));
+                break;
+            case Instruction::isObject:
+                emitter.call(reinterpret_cast<const void*>(&T::checkType<&value::isObject>));
+                break;
+            case Instruction::isArray:
+                emitter.call(reinterpret_cast<const void*>(&T::checkType<&value::isArray>));
+                break;
+            case Instruction::isString:
+                emitter.call(reinterpret_cast<const void*>(&T::checkType<&value::isString>));
+                break;
+            case Instruction::isNumber:
+                emitter.call(reinterpret_cast<const void*>(&T::checkType<&value::isNumber>));
+                break;
+            case Instruction::function:
+            case Instruction::functionSmall: {
+                auto f = readFromMemory<Builtin>(pcPointer);
+                pcPointer += sizeof(f);
+                ArityType arity{0};
+                if (i.tag == Instruction::function) {
+                    arity = readFromMemory<ArityType>(pcPointer);
+                    pcPointer += sizeof(ArityType);
+                } else {
+                    arity = readFromMemory<SmallArityType>(pcPointer);
+                    pcPointer += sizeof(SmallArityType);
+                }
+
+                emitter.loadImm(Emitter::rsi, static_cast<uint64_t>(f));
+                emitter.loadImm(Emitter::rdx, arity);
+                callAndCheck(reinterpret_cast<const void*>(&T::function));
+                break;
+            }
+            case Instruction::jmp:
+            case Instruction::jmpTrue:
+            case Instruction::jmpNothing: {
+                auto jumpOffset = readFromMemory<int>(pcPointer);
+                pcPointer += sizeof(jumpOffset);
+                auto target = jumpTarget(jumpOffset);
+                if (!target) {
+                    return nullptr;
+                }
+
+                if (i.tag == Instruction::jmp) {
+                    jumps.emplace_back(emitter.jump(), *target);
+                } else {
+                    emitter.call(i.tag == Instruction::jmpTrue
+                                     ? reinterpret_cast<const void*>(&T::jmpTrue)
+                                     : reinterpret_cast<const void*>(&T::jmpNothing));
+                    jumps.emplace_back(emitter.jumpIfNonZero(), *target);
+                }
+                break;
+            }
+            case Instruction::ret:
+                jumps.emplace_back(emitter.jump(), codeSize);
+                break;
+            case Instruction::fail:
+                callAndCheck(reinterpret_cast<const void*>(&T::fail));
+                break;
+            default:
+                // The remaining instructions, such as the collation-aware comparisons and the
+                // aggregates, have no template and keep the fragment in the interpreter.
+                return nullptr;
+        }
+    }
+
+    labels[codeSize] = emitter.size();
+    emitter.epilogue(false);
+    auto exceptionLabel = emitter.size();
+    emitter.epilogue(true);
+
+    for (auto [displacement, target] : jumps) {
+        if (labels[target] < 0) {
+            return nullptr;
+        }
+        emitter.patch(displacement, labels[target]);
+    }
+    for (auto displacement : exceptionJumps) {
+        emitter.patch(displacement, exceptionLabel);
+    }
+
+    static const size_t pageSize = sysconf(_SC_PAGESIZE);
+    auto size = (emitter.size() + pageSize - 1) / pageSize * pageSize;
+    auto memory = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (memory == MAP_FAILED) {
+        LOGV2_DEBUG(7132220,
+                    1,
+                    "Failed to allocate memory for SBE native code",
+                    "error"_attr = errorMessage(lastSystemError()));
+        return nullptr;
+    }
+    memcpy(memory, emitter.data(), emitter.size());
+    if (mprotect(memory, size, PROT_READ | PROT_EXEC) != 0) {
+        LOGV2_DEBUG(7132221,
+                    1,
+                    "Failed to make SBE native code executable",
+                    "error"_attr = errorMessage(lastSystemError()));
+        munmap(memory, size);
+        return nullptr;
+    }
+
+    return std::unique_ptr<NativeCode>(new NativeCode(memory, size));
+#else
+    return nullptr;
+#endif
+}
+
+NativeCode::~NativeCode() {
+#ifdef MONGO_SBE_HAVE_NATIVE_CODE
+    munmap(_memory, _size);
+#endif
+}
+}  // namespace vm
+}  // namespace sbe
+}  // namespace mongo
@@ -0,0 +1,102 @@
+/**
+ *    Copyright (C) 2022-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace mongo {
+namespace sbe {
+namespace vm {
+class ByteCode;
+class CodeFragment;
+
+/**
+ * Machine code compiled from the bytecode of a CodeFragment by the native tier of the VM.
+ *
+ * The code is produced by a template emitter: every instruction is replaced by a fixed sequence
+ * of machine instructions that calls a helper implementing it, with the operands of the
+ * instruction baked in as immediates, and the jumps of the bytecode become native jumps. This
+ * removes the decoding and the dispatch of the interpreter loop. The bodies of the lambdas, which
+ * are entered from the 'traverseP' and 'traverseF' helpers, still run in the interpreter.
+ *
+ * The helpers never let an exception escape into the native frames, as these have no unwind
+ * information. They store it in the ByteCode instead, and the native code returns early so that
+ * 'ByteCode::run()' can rethrow it.
+ *
+ * Only x86-64 on Linux is supported. On other platforms, and for fragments containing
+ * instructions the emitter has no template for, 'compile()' returns nullptr and the fragment keeps
+ * running in the interpreter.
+ */
+class NativeCode {
+public:
+    /**
+     * Returned by the native code, and by the helpers it calls, when an instruction has thrown.
+     */
+    static constexpr int32_t kException = -1;
+
+    using EntryFn = int32_t (*)(ByteCode* bytecode, const CodeFragment* code);
+
+    /**
+     * Compiles 'code', or returns nullptr if it contains an instruction that is not supported by
+     * the native tier or the platform has no emitter.
+     */
+    static std::unique_ptr<NativeCode> compile(const CodeFragment& code);
+
+    NativeCode(const NativeCode&) = delete;
+    NativeCode& operator=(const NativeCode&) = delete;
+
+    ~NativeCode();
+
+    /**
+     * Runs the compiled fragment on the stack of 'bytecode'. Returns 0, or 'kException' if an
+     * instruction has thrown.
+     */
+    int32_t run(ByteCode* bytecode, const CodeFragment* code) const {
+        return _entry(bytecode, code);
+    }
+
+    size_t size() const {
+        return _size;
+    }
+
+private:
+    NativeCode(void* memory, size_t size)
+        : _memory(memory), _size(size), _entry(reinterpret_cast<EntryFn>(memory)) {}
+
+    // The executable mapping holding the code, and its size in bytes.
+    void* _memory;
+    size_t _size;
+    EntryFn _entry;
+};
+}  // namespace vm
+}  // namespace sbe
+}  // namespace mongo
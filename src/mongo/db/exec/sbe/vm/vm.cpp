@@ -332,6 +332,22 @@ void CodeFragment::copyCodeAndFixup(CodeFragment&& from) {
     }
 }
 
+const NativeCode* CodeFragment::getNativeCode() const {
+    if (!internalQuerySlotBasedExecutionEnableNativeCode.load()) {
+        return nullptr;
+    }
+    if (_nativeCode || _nativeCodeUnsupported) {
+        return _nativeCode.get();
+    }
+    if (++_numRuns < internalQuerySlotBasedExecutionNativeCodeThreshold.load()) {
+        return nullptr;
+    }
+
+    _nativeCode = NativeCode::compile(*this);
+    _nativeCodeUnsupported = !_nativeCode;
+    return _nativeCode.get();
+}
+
 void CodeFragment::append(CodeFragment&& code) {
     // Fixup before copying.
     code.fixup(_stackSize);
@@ -1053,6 +1069,17 @@ std::tuple<bool, value::TypeTags, value::Value> ByteCode::aggSum(value::TypeTags
     return genericAdd(accTag, accValue, fieldTag, fieldValue);
 }
 
+void ByteCode::initDoubleDoubleSumState(value::Array* arr) {
+    arr->reserve(AggSumValueElems::kMaxSizeOfArray);
+
+    // The order of the following three elements should match to 'AggSumValueElems'.
+    arr->push_back(value::TypeTags::NumberInt32, value::bitcastFrom<int32_t>(0));
+    arr->push_back(value::TypeTags::NumberDouble, value::bitcastFrom<double>(0.0));
+    arr->push_back(value::TypeTags::NumberDouble, value::bitcastFrom<double>(0.0));
+    // The absent 'kDecimalTotal' element means that we've not seen any decimal value. So, we're
+    // not adding 'kDecimalTotal' element yet.
+}
+
 std::tuple<bool, value::TypeTags, value::Value> ByteCode::builtinAggDoubleDoubleSum(
     ArityType arity) {
 
@@ -1067,14 +1094,7 @@ std::tuple<bool, value::TypeTags, value::Value> ByteCode::builtinAggDoubleDouble
         std::tie(accTag, accValue) = value::makeNewArray();
         value::ValueGuard guard{accTag, accValue};
         auto arr = value::getArrayView(accValue);
-        arr->reserve(AggSumValueElems::kMaxSizeOfArray);
-
-        // The order of the following three elements should match to 'AggSumValueElems'.
-        arr->push_back(value::TypeTags::NumberInt32, value::bitcastFrom<int32_t>(0));
-        arr->push_back(value::TypeTags::NumberDouble, value::bitcastFrom<double>(0.0));
-        arr->push_back(value::TypeTags::NumberDouble, value::bitcastFrom<double>(0.0));
-        // The absent 'kDecimalTotal' element means that we've not seen any decimal value. So, we're
-        // not adding 'kDecimalTotal' element yet.
+        initDoubleDoubleSumState(arr);
         aggDoubleDoubleSumImpl(arr, fieldTag, fieldValue);
         guard.reset();
         return {true, accTag, accValue};
@@ -1086,6 +1106,33 @@ std::tuple<bool, value::TypeTags, value::Value> ByteCode::builtinAggDoubleDouble
     return {true, accTag, accValue};
 }
 
+// Merges the partial sums produced by 'aggDoubleDoubleSum()', for example by the partial
+// aggregations running in the producers of a parallel plan, into a single partial sum.
+std::tuple<bool, value::TypeTags, value::Value> ByteCode::builtinAggMergeDoubleDoubleSums(
+    ArityType arity) {
+    auto [_, fieldTag, fieldValue] = getFromStack(1);
+    auto [accTag, accValue] = moveOwnedFromStack(0);
+    value::ValueGuard guard{accTag, accValue};
+
+    // Skip aggregation step if we don't have the input.
+    if (fieldTag == value::TypeTags::Nothing) {
+        guard.reset();
+        return {true, accTag, accValue};
+    }
+    tassert(7131300, "The partial sum must be Array-typed", fieldTag == value::TypeTags::Array);
+
+    // Initialize the accumulator with the first partial sum.
+    if (accTag == value::TypeTags::Nothing) {
+        auto [tag, val] = value::copyValue(fieldTag, fieldValue);
+        return {true, tag, val};
+    }
+    tassert(7131301, "The result slot must be Array-typed", accTag == value::TypeTags::Array);
+
+    aggMergeDoubleDoubleSumsImpl(value::getArrayView(accValue), value::getArrayView(fieldValue));
+    guard.reset();
+    return {true, accTag, accValue};
+}
+
 // This function is necessary because 'aggDoubleDoubleSum()' result is 'Array' type but we need
 // to produce a scalar value out of it.
 //
@@ -1094,7 +1141,11 @@ template <bool keepIntegerPrecision>
 std::tuple<bool, value::TypeTags, value::Value> ByteCode::builtinDoubleDoubleSumFinalize(
     ArityType arity) {
     auto [_, fieldTag, fieldValue] = getFromStack(0);
-    auto arr = value::getArrayView(fieldValue);
+    return finalizeDoubleDoubleSum(value::getArrayView(fieldValue), keepIntegerPrecision);
+}
+
+std::tuple<bool, value::TypeTags, value::Value> ByteCode::finalizeDoubleDoubleSum(
+    const value::Array* arr, bool keepIntegerPrecision) {
     tassert(5755321,
             str::stream() << "The result slot must have at least "
                           << AggSumValueElems::kMaxSizeOfArray - 1
@@ -1134,7 +1185,7 @@ std::tuple<bool, value::TypeTags, value::Value> ByteCode::builtinDoubleDoubleSum
                     }
                 }
 
-                if constexpr (keepIntegerPrecision) {
+                if (keepIntegerPrecision) {
                     // The value was too large for a NumberInt64, so output an array with two
                     // values adding up to the desired total. The mongos computes the final sum,
                     // considering errors.
@@ -4050,6 +4101,8 @@ std::tuple<bool, value::TypeTags, value::Value> ByteCode::dispatchBuiltin(Builti
             return builtinDoubleDoubleSum(arity);
         case Builtin::aggDoubleDoubleSum:
             return builtinAggDoubleDoubleSum(arity);
+        case Builtin::aggMergeDoubleDoubleSums:
+            return builtinAggMergeDoubleDoubleSums(arity);
         case Builtin::doubleDoubleSumFinalize:
             return builtinDoubleDoubleSumFinalize<>(arity);
         case Builtin::doubleDoubleMergeSumFinalize:
@@ -4178,6 +4231,30 @@ std::tuple<bool, value::TypeTags, value::Value> ByteCode::dispatchBuiltin(Builti
             return builtinTsIncrement(arity);
         case Builtin::typeMatch:
             return builtinTypeMatch(arity);
+        case Builtin::valueBlockFillEmpty:
+        case Builtin::valueBlockIsNumber:
+        case Builtin::valueBlockGtScalar:
+        case Builtin::valueBlockGteScalar:
+        case Builtin::valueBlockLtScalar:
+        case Builtin::valueBlockLteScalar:
+        case Builtin::valueBlockEqScalar:
+        case Builtin::valueBlockNeqScalar:
+        case Builtin::valueBlockMatchGtScalar:
+        case Builtin::valueBlockMatchGteScalar:
+        case Builtin::valueBlockMatchLtScalar:
+        case Builtin::valueBlockMatchLteScalar:
+        case Builtin::valueBlockMatchEqScalar:
+        case Builtin::valueBlockAdd:
+        case Builtin::valueBlockSub:
+        case Builtin::valueBlockMult:
+        case Builtin::valueBlockLogicalAnd:
+        case Builtin::valueBlockLogicalOr:
+        case Builtin::valueBlockCount:
+        case Builtin::valueBlockSum:
+        case Builtin::valueBlockAggDoubleDoubleSum:
+        case Builtin::valueBlockMin:
+        case Builtin::valueBlockMax:
+            return dispatchValueBlockBuiltin(f, arity);
     }
 
     MONGO_UNREACHABLE;
@@ -5302,7 +5379,13 @@ std::tuple<uint8_t, value::TypeTags, value::Value> ByteCode::run(const CodeFragm
         _argStack.resize(0);
     });
 
-    runInternal(code, 0);
+    if (auto nativeCode = code->getNativeCode()) {
+        if (nativeCode->run(this, code) == NativeCode::kException) {
+            std::rethrow_exception(std::exchange(_nativeException, nullptr));
+        }
+    } else {
+        runInternal(code, 0);
+    }
 
     uassert(4822801, "The evaluation stack must hold only a single value", _argStack.size() == 1);
 
@@ -30,6 +30,7 @@
 #pragma once
 
 #include <cstdint>
+#include <exception>
 #include <memory>
 #include <vector>
 
@@ -37,6 +38,7 @@
 #include "mongo/db/exec/sbe/values/slot.h"
 #include "mongo/db/exec/sbe/values/value.h"
 #include "mongo/db/exec/sbe/vm/datetime.h"
+#include "mongo/db/exec/sbe/vm/native_code.h"
 #include "mongo/db/query/collation/collator_interface.h"
 #include "mongo/db/query/datetime/date_time_support.h"
 
@@ -503,6 +505,7 @@ enum class Builtin : uint8_t {
     collAddToSet,     // agg function to append to a set (with collation)
     doubleDoubleSum,  // special double summation
     aggDoubleDoubleSum,
+    aggMergeDoubleDoubleSums,
     doubleDoubleSumFinalize,
     doubleDoubleMergeSumFinalize,
     doubleDoublePartialSumFinalize,
@@ -566,6 +569,31 @@ enum class Builtin : uint8_t {
     tsSecond,
     tsIncrement,
     typeMatch,
+
+    // Builtins of the block-at-a-time execution mode, which operate on value::ValueBlock.
+    valueBlockFillEmpty,
+    valueBlockIsNumber,
+    valueBlockGtScalar,
+    valueBlockGteScalar,
+    valueBlockLtScalar,
+    valueBlockLteScalar,
+    valueBlockEqScalar,
+    valueBlockNeqScalar,
+    valueBlockMatchGtScalar,
+    valueBlockMatchGteScalar,
+    valueBlockMatchLtScalar,
+    valueBlockMatchLteScalar,
+    valueBlockMatchEqScalar,
+    valueBlockAdd,
+    valueBlockSub,
+    valueBlockMult,
+    valueBlockLogicalAnd,
+    valueBlockLogicalOr,
+    valueBlockCount,
+    valueBlockSum,
+    valueBlockAggDoubleDoubleSum,
+    valueBlockMin,
+    valueBlockMax,
 };
 
 /**
@@ -737,6 +765,15 @@ public:
 
     void fixup(int offset);
 
+    /**
+     * Returns the native code of this fragment, compiling it once the fragment has been run
+     * 'internalQuerySlotBasedExecutionNativeCodeThreshold' times, or nullptr if the fragment must
+     * run in the interpreter. This is the case while the fragment is not hot yet, when the native
+     * tier is disabled, and when the fragment cannot be compiled. The fragment must not be
+     * modified once it has started running.
+     */
+    const NativeCode* getNativeCode() const;
+
 private:
     void appendSimpleInstruction(Instruction::Tags tag);
     auto allocateSpace(size_t size) {
@@ -768,6 +805,12 @@ private:
     std::vector<FixUp> _fixUps;
 
     size_t _stackSize{0};
+
+    // The state of the native tier. Like the rest of a plan, a fragment is only run by one thread
+    // at a time.
+    mutable int64_t _numRuns{0};
+    mutable std::unique_ptr<NativeCode> _nativeCode;
+    mutable bool _nativeCodeUnsupported{false};
 };
 
 class ByteCode {
@@ -776,6 +819,9 @@ public:
     bool runPredicate(const CodeFragment* code);
 
 private:
+    // The templates of the native tier run the instructions on the stack of the ByteCode.
+    friend struct NativeCodeTemplates;
+
     // The VM stack is used to pass inputs to instructions and hold the outputs produced by
     // instructions. Each element of the VM stack is 3-tuple comprised of a boolean ('owned'),
     // a value::TypeTags ('tag'), and a value::Value ('value').
@@ -858,6 +904,10 @@ private:
 
     Stack _argStack;
 
+    // The exception thrown by an instruction of the native code, which is rethrown once the native
+    // code has returned.
+    std::exception_ptr _nativeException;
+
     void runInternal(const CodeFragment* code, int64_t position);
     std::tuple<bool, value::TypeTags, value::Value> runLambdaInternal(const CodeFragment* code,
                                                                       int64_t position);
@@ -963,8 +1013,19 @@ private:
                                                            value::TypeTags fieldTag,
                                                            value::Value fieldValue);
 
+    // Fills the empty array 'arr' with the initial partial sum of 'aggDoubleDoubleSum'.
+    void initDoubleDoubleSumState(value::Array* arr);
+
     void aggDoubleDoubleSumImpl(value::Array* arr, value::TypeTags rhsTag, value::Value rhsValue);
 
+    // Returns the total of the partial sum 'arr' produced by 'aggDoubleDoubleSum'. See
+    // 'builtinDoubleDoubleSumFinalize()'.
+    std::tuple<bool, value::TypeTags, value::Value> finalizeDoubleDoubleSum(
+        const value::Array* arr, bool keepIntegerPrecision);
+
+    // Adds the partial sum 'rhsArr' produced by 'aggDoubleDoubleSum' to the partial sum 'arr'.
+    void aggMergeDoubleDoubleSumsImpl(value::Array* arr, const value::Array* rhsArr);
+
     // This is an implementation of the following algorithm:
     // https://en.wikipedia.org/wiki/Algorithms_for_calculating_variance#Welford's_online_algorithm
     void aggStdDevImpl(value::Array* arr, value::TypeTags rhsTag, value::Value rhsValue);
@@ -1078,6 +1139,8 @@ private:
     std::tuple<bool, value::TypeTags, value::Value> builtinCollAddToSet(ArityType arity);
     std::tuple<bool, value::TypeTags, value::Value> builtinDoubleDoubleSum(ArityType arity);
     std::tuple<bool, value::TypeTags, value::Value> builtinAggDoubleDoubleSum(ArityType arity);
+    std::tuple<bool, value::TypeTags, value::Value> builtinAggMergeDoubleDoubleSums(
+        ArityType arity);
     // This is only for compatibility with mongos/sharding and we will revisit this later.
     template <bool keepIntegerPrecision = false>
     std::tuple<bool, value::TypeTags, value::Value> builtinDoubleDoubleSumFinalize(ArityType arity);
@@ -1144,6 +1207,32 @@ private:
     std::tuple<bool, value::TypeTags, value::Value> builtinTsIncrement(ArityType arity);
     std::tuple<bool, value::TypeTags, value::Value> builtinTypeMatch(ArityType arity);
 
+    using GenericArithmeticOp = std::tuple<bool, value::TypeTags, value::Value> (ByteCode::*)(
+        value::TypeTags, value::Value, value::TypeTags, value::Value);
+
+    // The 'valueBlock*' builtins are implemented in vm_block.cpp.
+    std::tuple<bool, value::TypeTags, value::Value> builtinValueBlockFillEmpty(ArityType arity);
+    std::tuple<bool, value::TypeTags, value::Value> builtinValueBlockIsNumber(ArityType arity);
+    template <typename Op>
+    std::tuple<bool, value::TypeTags, value::Value> builtinValueBlockCompareScalar(
+        ArityType arity);
+    template <typename Op>
+    std::tuple<bool, value::TypeTags, value::Value> builtinValueBlockMatchCompareScalar(
+        ArityType arity);
+    template <typename DoubleOp>
+    std::tuple<bool, value::TypeTags, value::Value> builtinValueBlockArithmetic(
+        ArityType arity, GenericArithmeticOp genericOp);
+    template <bool IsAnd>
+    std::tuple<bool, value::TypeTags, value::Value> builtinValueBlockLogicalOp(ArityType arity);
+    std::tuple<bool, value::TypeTags, value::Value> builtinValueBlockCount(ArityType arity);
+    std::tuple<bool, value::TypeTags, value::Value> builtinValueBlockSum(ArityType arity);
+    std::tuple<bool, value::TypeTags, value::Value> builtinValueBlockAggDoubleDoubleSum(
+        ArityType arity);
+    template <bool IsMin>
+    std::tuple<bool, value::TypeTags, value::Value> builtinValueBlockMinMax(ArityType arity);
+    std::tuple<bool, value::TypeTags, value::Value> dispatchValueBlockBuiltin(Builtin f,
+                                                                              ArityType arity);
+
     std::tuple<bool, value::TypeTags, value::Value> dispatchBuiltin(Builtin f, ArityType arity);
 
     std::tuple<bool, value::TypeTags, value::Value> getFromStack(size_t offset) {
@@ -0,0 +1,640 @@
+/**
+ *    Copyright (C) 2022-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/exec/sbe/vm/vm.h"
+
+#include "mongo/db/exec/sbe/values/value_block.h"
+#include "mongo/util/summation.h"
+
+namespace mongo {
+namespace sbe {
+namespace vm {
+namespace {
+std::tuple<bool, value::TypeTags, value::Value> makeBlockResult(
+    std::unique_ptr<value::ValueBlock> block) {
+    return {true,
+            value::TypeTags::valueBlock,
+            value::bitcastFrom<value::ValueBlock*>(block.release())};
+}
+
+/**
+ * Returns the selection bitmap passed to a 'valueBlock*' aggregate, or nullptr if all of the values
+ * are selected.
+ */
+const value::ValueBlock* getBitmap(value::TypeTags tag, value::Value val, size_t blockSize) {
+    if (tag == value::TypeTags::Nothing) {
+        return nullptr;
+    }
+
+    tassert(7131400, "the selection bitmap must be a block", tag == value::TypeTags::valueBlock);
+    auto bitmap = value::getValueBlockView(val);
+    tassert(7131401,
+            "the selection bitmap must have the same size as the block",
+            bitmap->size() == blockSize);
+    return bitmap;
+}
+
+bool isSelected(const value::ValueBlock* bitmap, size_t idx) {
+    if (!bitmap) {
+        return true;
+    }
+
+    auto [tag, val] = bitmap->at(idx);
+    return tag == value::TypeTags::Boolean && value::bitcastTo<bool>(val);
+}
+
+/**
+ * Applies 'op' to every value of 'block' and the scalar 'rhs', both of which are of the C++ type
+ * 'T'. The loop does not branch on the tags, so the compiler is free to vectorize it.
+ */
+template <typename T, typename Op>
+void compareBlockToScalarFast(const value::ValueBlock& block,
+                              T rhs,
+                              value::ValueBlock& out,
+                              Op op) {
+    const size_t size = block.size();
+    const value::Value* vals = block.vals();
+    std::vector<value::Value> results(size);
+    for (size_t idx = 0; idx < size; ++idx) {
+        results[idx] = value::bitcastFrom<bool>(op(value::bitcastTo<T>(vals[idx]), rhs));
+    }
+    out.appendShallow(value::TypeTags::Boolean, results.data(), size);
+}
+
+template <typename Op>
+std::unique_ptr<value::ValueBlock> compareBlockToScalar(const value::ValueBlock& block,
+                                                        value::TypeTags rhsTag,
+                                                        value::Value rhsVal) {
+    auto out = std::make_unique<value::ValueBlock>();
+    out->reserve(block.size());
+
+    Op op{};
+    if (rhsTag == value::TypeTags::NumberDouble &&
+        block.allOfType(value::TypeTags::NumberDouble)) {
+        compareBlockToScalarFast(block, value::bitcastTo<double>(rhsVal), *out, op);
+    } else if (rhsTag == value::TypeTags::NumberInt64 &&
+               block.allOfType(value::TypeTags::NumberInt64)) {
+        compareBlockToScalarFast(block, value::bitcastTo<int64_t>(rhsVal), *out, op);
+    } else if (rhsTag == value::TypeTags::NumberInt32 &&
+               block.allOfType(value::TypeTags::NumberInt32)) {
+        compareBlockToScalarFast(block, value::bitcastTo<int32_t>(rhsVal), *out, op);
+    } else {
+        for (size_t idx = 0; idx < block.size(); ++idx) {
+            auto [tag, val] = block.at(idx);
+            auto [resTag, resVal] = genericCompare<Op>(tag, val, rhsTag, rhsVal);
+            out->push_back(resTag, resVal);
+        }
+    }
+
+    return out;
+}
+
+/**
+ * Returns true if the value is a number other than NaN which compares to 'rhs' with 'Op', or if it
+ * is an array with such a number as one of its elements. These are the values which match the
+ * comparison of a top-level field to a number in the query language.
+ */
+template <typename Op>
+bool matchCompareScalar(value::TypeTags tag,
+                        value::Value val,
+                        value::TypeTags rhsTag,
+                        value::Value rhsVal) {
+    auto matchNumber = [&](value::TypeTags elemTag, value::Value elemVal) {
+        if (!value::isNumber(elemTag) || value::isNaN(elemTag, elemVal)) {
+            return false;
+        }
+        auto [resTag, resVal] = genericCompare<Op>(elemTag, elemVal, rhsTag, rhsVal);
+        return resTag == value::TypeTags::Boolean && value::bitcastTo<bool>(resVal);
+    };
+
+    if (value::isArray(tag)) {
+        for (value::ArrayEnumerator enumerator{tag, val}; !enumerator.atEnd();
+             enumerator.advance()) {
+            auto [elemTag, elemVal] = enumerator.getViewOfValue();
+            if (matchNumber(elemTag, elemVal)) {
+                return true;
+            }
+        }
+        return false;
+    }
+    return matchNumber(tag, val);
+}
+
+template <typename Op>
+std::unique_ptr<value::ValueBlock> matchCompareBlockToScalar(const value::ValueBlock& block,
+                                                             value::TypeTags rhsTag,
+                                                             value::Value rhsVal) {
+    auto out = std::make_unique<value::ValueBlock>();
+    out->reserve(block.size());
+
+    // A comparison with NaN on either side is false, which is also the result of the comparison
+    // operators of the fast path.
+    Op op{};
+    if (rhsTag == value::TypeTags::NumberDouble &&
+        block.allOfType(value::TypeTags::NumberDouble)) {
+        compareBlockToScalarFast(block, value::bitcastTo<double>(rhsVal), *out, op);
+    } else if (rhsTag == value::TypeTags::NumberInt64 &&
+               block.allOfType(value::TypeTags::NumberInt64)) {
+        compareBlockToScalarFast(block, value::bitcastTo<int64_t>(rhsVal), *out, op);
+    } else if (rhsTag == value::TypeTags::NumberInt32 &&
+               block.allOfType(value::TypeTags::NumberInt32)) {
+        compareBlockToScalarFast(block, value::bitcastTo<int32_t>(rhsVal), *out, op);
+    } else {
+        for (size_t idx = 0; idx < block.size(); ++idx) {
+            auto [tag, val] = block.at(idx);
+            const bool matches = matchCompareScalar<Op>(tag, val, rhsTag, rhsVal);
+            out->push_back(value::TypeTags::Boolean, value::bitcastFrom<bool>(matches));
+        }
+    }
+
+    return out;
+}
+
+/**
+ * Applies an arithmetic operation to every value of 'lhs' and either the matching value of
+ * 'rhsBlock' or, if 'rhsBlock' is nullptr, the scalar 'rhs'. If all of the operands are doubles
+ * 'doubleOp' is applied in a loop that does not branch on the tags, otherwise 'genericOp' is called
+ * for each pair of values.
+ */
+template <typename DoubleOp, typename GenericOp>
+std::unique_ptr<value::ValueBlock> arithmeticOnBlock(const value::ValueBlock& lhs,
+                                                     const value::ValueBlock* rhsBlock,
+                                                     value::TypeTags rhsTag,
+                                                     value::Value rhsVal,
+                                                     DoubleOp doubleOp,
+                                                     GenericOp genericOp) {
+    const size_t size = lhs.size();
+    auto out = std::make_unique<value::ValueBlock>();
+    out->reserve(size);
+
+    const bool rhsIsDouble = rhsBlock ? rhsBlock->allOfType(value::TypeTags::NumberDouble)
+                                      : rhsTag == value::TypeTags::NumberDouble;
+    if (rhsIsDouble && lhs.allOfType(value::TypeTags::NumberDouble)) {
+        const value::Value* lhsVals = lhs.vals();
+        std::vector<value::Value> results(size);
+        if (rhsBlock) {
+            const value::Value* rhsVals = rhsBlock->vals();
+            for (size_t idx = 0; idx < size; ++idx) {
+                results[idx] = value::bitcastFrom<double>(
+                    doubleOp(value::bitcastTo<double>(lhsVals[idx]),
+                             value::bitcastTo<double>(rhsVals[idx])));
+            }
+        } else {
+            const double rhs = value::bitcastTo<double>(rhsVal);
+            for (size_t idx = 0; idx < size; ++idx) {
+                results[idx] = value::bitcastFrom<double>(
+                    doubleOp(value::bitcastTo<double>(lhsVals[idx]), rhs));
+            }
+        }
+        out->appendShallow(value::TypeTags::NumberDouble, results.data(), size);
+        return out;
+    }
+
+    for (size_t idx = 0; idx < size; ++idx) {
+        auto [lhsElemTag, lhsElemVal] = lhs.at(idx);
+        auto [rhsElemTag, rhsElemVal] =
+            rhsBlock ? rhsBlock->at(idx) : std::pair<value::TypeTags, value::Value>{rhsTag, rhsVal};
+        auto [owned, tag, val] = genericOp(lhsElemTag, lhsElemVal, rhsElemTag, rhsElemVal);
+        if (!owned) {
+            std::tie(tag, val) = value::copyValue(tag, val);
+        }
+        out->push_back(tag, val);
+    }
+
+    return out;
+}
+}  // namespace
+
+std::tuple<bool, value::TypeTags, value::Value> ByteCode::builtinValueBlockFillEmpty(
+    ArityType arity) {
+    invariant(arity == 2);
+
+    auto [blockOwned, blockTag, blockVal] = getFromStack(0);
+    if (blockTag != value::TypeTags::valueBlock) {
+        return {false, value::TypeTags::Nothing, 0};
+    }
+    auto [fillOwned, fillTag, fillVal] = getFromStack(1);
+
+    auto block = value::getValueBlockView(blockVal);
+    auto out = std::make_unique<value::ValueBlock>();
+    out->reserve(block->size());
+    for (size_t idx = 0; idx < block->size(); ++idx) {
+        auto [tag, val] = block->at(idx);
+        if (tag == value::TypeTags::Nothing) {
+            std::tie(tag, val) = value::copyValue(fillTag, fillVal);
+        } else {
+            std::tie(tag, val) = value::copyValue(tag, val);
+        }
+        out->push_back(tag, val);
+    }
+
+    return makeBlockResult(std::move(out));
+}
+
+std::tuple<bool, value::TypeTags, value::Value> ByteCode::builtinValueBlockIsNumber(
+    ArityType arity) {
+    invariant(arity == 1);
+
+    auto [blockOwned, blockTag, blockVal] = getFromStack(0);
+    if (blockTag != value::TypeTags::valueBlock) {
+        return {false, value::TypeTags::Nothing, 0};
+    }
+
+    auto block = value::getValueBlockView(blockVal);
+    auto out = std::make_unique<value::ValueBlock>();
+    out->reserve(block->size());
+    const value::TypeTags* tags = block->tags();
+    for (size_t idx = 0; idx < block->size(); ++idx) {
+        if (tags[idx] == value::TypeTags::Nothing) {
+            out->push_back(value::TypeTags::Nothing, 0);
+        } else {
+            out->push_back(value::TypeTags::Boolean,
+                           value::bitcastFrom<bool>(value::isNumber(tags[idx])));
+        }
+    }
+
+    return makeBlockResult(std::move(out));
+}
+
+template <typename Op>
+std::tuple<bool, value::TypeTags, value::Value> ByteCode::builtinValueBlockCompareScalar(
+    ArityType arity) {
+    invariant(arity == 2);
+
+    auto [blockOwned, blockTag, blockVal] = getFromStack(0);
+    if (blockTag != value::TypeTags::valueBlock) {
+        return {false, value::TypeTags::Nothing, 0};
+    }
+    auto [rhsOwned, rhsTag, rhsVal] = getFromStack(1);
+
+    return makeBlockResult(
+        compareBlockToScalar<Op>(*value::getValueBlockView(blockVal), rhsTag, rhsVal));
+}
+
+template <typename Op>
+std::tuple<bool, value::TypeTags, value::Value> ByteCode::builtinValueBlockMatchCompareScalar(
+    ArityType arity) {
+    invariant(arity == 2);
+
+    auto [blockOwned, blockTag, blockVal] = getFromStack(0);
+    if (blockTag != value::TypeTags::valueBlock) {
+        return {false, value::TypeTags::Nothing, 0};
+    }
+    auto block = value::getValueBlockView(blockVal);
+    auto [rhsOwned, rhsTag, rhsVal] = getFromStack(1);
+
+    // An auto-parameterized plan can be reused with a constant which is not a number, or is NaN.
+    // All of the rows are then selected, and the comparison is left to the row filter.
+    if (!value::isNumber(rhsTag) || value::isNaN(rhsTag, rhsVal)) {
+        auto out = std::make_unique<value::ValueBlock>();
+        std::vector<value::Value> results(block->size(), value::bitcastFrom<bool>(true));
+        out->appendShallow(value::TypeTags::Boolean, results.data(), results.size());
+        return makeBlockResult(std::move(out));
+    }
+
+    return makeBlockResult(matchCompareBlockToScalar<Op>(*block, rhsTag, rhsVal));
+}
+
+template <typename DoubleOp>
+std::tuple<bool, value::TypeTags, value::Value> ByteCode::builtinValueBlockArithmetic(
+    ArityType arity, GenericArithmeticOp genericOp) {
+    invariant(arity == 2);
+
+    auto [lhsOwned, lhsTag, lhsVal] = getFromStack(0);
+    if (lhsTag != value::TypeTags::valueBlock) {
+        return {false, value::TypeTags::Nothing, 0};
+    }
+    auto [rhsOwned, rhsTag, rhsVal] = getFromStack(1);
+
+    auto lhs = value::getValueBlockView(lhsVal);
+    const value::ValueBlock* rhsBlock = nullptr;
+    if (rhsTag == value::TypeTags::valueBlock) {
+        rhsBlock = value::getValueBlockView(rhsVal);
+        tassert(7131402,
+                "the operands of a block arithmetic operation must have the same size",
+                lhs->size() == rhsBlock->size());
+    }
+
+    return makeBlockResult(arithmeticOnBlock(
+        *lhs,
+        rhsBlock,
+        rhsTag,
+        rhsVal,
+        DoubleOp{},
+        [&](value::TypeTags lhsElemTag,
+            value::Value lhsElemVal,
+            value::TypeTags rhsElemTag,
+            value::Value rhsElemVal) {
+            return (this->*genericOp)(lhsElemTag, lhsElemVal, rhsElemTag, rhsElemVal);
+        }));
+}
+
+template <bool IsAnd>
+std::tuple<bool, value::TypeTags, value::Value> ByteCode::builtinValueBlockLogicalOp(
+    ArityType arity) {
+    invariant(arity == 2);
+
+    auto [lhsOwned, lhsTag, lhsVal] = getFromStack(0);
+    auto [rhsOwned, rhsTag, rhsVal] = getFromStack(1);
+    if (lhsTag != value::TypeTags::valueBlock || rhsTag != value::TypeTags::valueBlock) {
+        return {false, value::TypeTags::Nothing, 0};
+    }
+
+    auto lhs = value::getValueBlockView(lhsVal);
+    auto rhs = value::getValueBlockView(rhsVal);
+    tassert(7131403,
+            "the operands of a block logical operation must have the same size",
+            lhs->size() == rhs->size());
+
+    const size_t size = lhs->size();
+    auto out = std::make_unique<value::ValueBlock>();
+    out->reserve(size);
+
+    if (lhs->allOfType(value::TypeTags::Boolean) && rhs->allOfType(value::TypeTags::Boolean)) {
+        const value::Value* lhsVals = lhs->vals();
+        const value::Value* rhsVals = rhs->vals();
+        std::vector<value::Value> results(size);
+        for (size_t idx = 0; idx < size; ++idx) {
+            results[idx] = IsAnd ? (lhsVals[idx] & rhsVals[idx]) : (lhsVals[idx] | rhsVals[idx]);
+        }
+        out->appendShallow(value::TypeTags::Boolean, results.data(), size);
+        return makeBlockResult(std::move(out));
+    }
+
+    for (size_t idx = 0; idx < size; ++idx) {
+        auto [lhsElemTag, lhsElemVal] = lhs->at(idx);
+        auto [rhsElemTag, rhsElemVal] = rhs->at(idx);
+        const bool lhsIsBool = lhsElemTag == value::TypeTags::Boolean;
+        const bool rhsIsBool = rhsElemTag == value::TypeTags::Boolean;
+        // A false operand decides the result of an 'and', and a true operand decides the result
+        // of an 'or', even if the other operand is not a boolean.
+        if ((lhsIsBool && value::bitcastTo<bool>(lhsElemVal) != IsAnd) ||
+            (rhsIsBool && value::bitcastTo<bool>(rhsElemVal) != IsAnd)) {
+            out->push_back(value::TypeTags::Boolean, value::bitcastFrom<bool>(!IsAnd));
+        } else if (lhsIsBool && rhsIsBool) {
+            out->push_back(value::TypeTags::Boolean, value::bitcastFrom<bool>(IsAnd));
+        } else {
+            out->push_back(value::TypeTags::Nothing, 0);
+        }
+    }
+
+    return makeBlockResult(std::move(out));
+}
+
+std::tuple<bool, value::TypeTags, value::Value> ByteCode::builtinValueBlockCount(ArityType arity) {
+    invariant(arity == 2);
+
+    auto [blockOwned, blockTag, blockVal] = getFromStack(1);
+    if (blockTag != value::TypeTags::valueBlock) {
+        return {false, value::TypeTags::Nothing, 0};
+    }
+    auto block = value::getValueBlockView(blockVal);
+    auto [bitmapOwned, bitmapTag, bitmapVal] = getFromStack(0);
+    auto bitmap = getBitmap(bitmapTag, bitmapVal, block->size());
+
+    int64_t count = 0;
+    for (size_t idx = 0; idx < block->size(); ++idx) {
+        count += isSelected(bitmap, idx);
+    }
+
+    return {false, value::TypeTags::NumberInt64, value::bitcastFrom<int64_t>(count)};
+}
+
+std::tuple<bool, value::TypeTags, value::Value> ByteCode::builtinValueBlockSum(ArityType arity) {
+    invariant(arity == 2);
+
+    auto [blockOwned, blockTag, blockVal] = getFromStack(1);
+    if (blockTag != value::TypeTags::valueBlock) {
+        return {false, value::TypeTags::Nothing, 0};
+    }
+    auto block = value::getValueBlockView(blockVal);
+    auto [bitmapOwned, bitmapTag, bitmapVal] = getFromStack(0);
+    auto bitmap = getBitmap(bitmapTag, bitmapVal, block->size());
+
+    // The values are summed the same way as by 'aggDoubleDoubleSum', so that the result does not
+    // depend on whether the rows were processed in blocks.
+    if (!bitmap && block->allOfType(value::TypeTags::NumberDouble)) {
+        if (block->empty()) {
+            return {false, value::TypeTags::Nothing, 0};
+        }
+        const value::Value* vals = block->vals();
+        DoubleDoubleSummation sum;
+        for (size_t idx = 0; idx < block->size(); ++idx) {
+            sum.addDouble(value::bitcastTo<double>(vals[idx]));
+        }
+        return {false, value::TypeTags::NumberDouble, value::bitcastFrom<double>(sum.getDouble())};
+    }
+
+    auto [accTag, accVal] = value::makeNewArray();
+    value::ValueGuard guard{accTag, accVal};
+    auto acc = value::getArrayView(accVal);
+    initDoubleDoubleSumState(acc);
+
+    bool anySummed = false;
+    for (size_t idx = 0; idx < block->size(); ++idx) {
+        auto [tag, val] = block->at(idx);
+        if (!value::isNumber(tag) || !isSelected(bitmap, idx)) {
+            continue;
+        }
+        aggDoubleDoubleSumImpl(acc, tag, val);
+        anySummed = true;
+    }
+
+    if (!anySummed) {
+        return {false, value::TypeTags::Nothing, 0};
+    }
+    return finalizeDoubleDoubleSum(acc, false /* keepIntegerPrecision */);
+}
+
+std::tuple<bool, value::TypeTags, value::Value> ByteCode::builtinValueBlockAggDoubleDoubleSum(
+    ArityType arity) {
+    invariant(arity == 2 || arity == 3);
+
+    auto [blockOwned, blockTag, blockVal] = getFromStack(1);
+    if (blockTag != value::TypeTags::valueBlock) {
+        return {false, value::TypeTags::Nothing, 0};
+    }
+    auto block = value::getValueBlockView(blockVal);
+    auto [bitmapOwned, bitmapTag, bitmapVal] = getFromStack(0);
+    auto bitmap = getBitmap(bitmapTag, bitmapVal, block->size());
+
+    auto [accTag, accVal] = value::makeNewArray();
+    value::ValueGuard guard{accTag, accVal};
+    auto acc = value::getArrayView(accVal);
+    initDoubleDoubleSumState(acc);
+
+    if (arity == 3) {
+        // The 'addend' is summed once for every selected row, as for {$sum: <constant>}.
+        auto [addendOwned, addendTag, addendVal] = getFromStack(2);
+        tassert(7132217,
+                "the addend must be a 32-bit integer",
+                addendTag == value::TypeTags::NumberInt32);
+        int64_t count = 0;
+        for (size_t idx = 0; idx < block->size(); ++idx) {
+            count += isSelected(bitmap, idx);
+        }
+        if (count == 0) {
+            return {false, value::TypeTags::Nothing, 0};
+        }
+
+        // The state keeps track of the widest type summed, so the total is added as a 32-bit
+        // integer whenever it fits, like the sum of the individual addends would have been.
+        int64_t total = count * value::bitcastTo<int32_t>(addendVal);
+        if (int32_t intTotal = total; intTotal == total) {
+            aggDoubleDoubleSumImpl(
+                acc, value::TypeTags::NumberInt32, value::bitcastFrom<int32_t>(intTotal));
+        } else {
+            aggDoubleDoubleSumImpl(
+                acc, value::TypeTags::NumberInt64, value::bitcastFrom<int64_t>(total));
+        }
+        guard.reset();
+        return {true, accTag, accVal};
+    }
+
+    // Like 'aggDoubleDoubleSum', the state is initialized as soon as a row is selected, even if
+    // none of the values is a number, so that the sum of such values is 0.
+    bool anySelected = false;
+    for (size_t idx = 0; idx < block->size(); ++idx) {
+        if (!isSelected(bitmap, idx)) {
+            continue;
+        }
+        anySelected = true;
+        auto [tag, val] = block->at(idx);
+        aggDoubleDoubleSumImpl(acc, tag, val);
+    }
+
+    if (!anySelected) {
+        return {false, value::TypeTags::Nothing, 0};
+    }
+    guard.reset();
+    return {true, accTag, accVal};
+}
+
+template <bool IsMin>
+std::tuple<bool, value::TypeTags, value::Value> ByteCode::builtinValueBlockMinMax(
+    ArityType arity) {
+    invariant(arity == 2);
+
+    auto [blockOwned, blockTag, blockVal] = getFromStack(1);
+    if (blockTag != value::TypeTags::valueBlock) {
+        return {false, value::TypeTags::Nothing, 0};
+    }
+    auto block = value::getValueBlockView(blockVal);
+    auto [bitmapOwned, bitmapTag, bitmapVal] = getFromStack(0);
+    auto bitmap = getBitmap(bitmapTag, bitmapVal, block->size());
+
+    value::TypeTags accTag = value::TypeTags::Nothing;
+    value::Value accVal = 0;
+    for (size_t idx = 0; idx < block->size(); ++idx) {
+        // Like the $min and $max accumulators, ignore the null and undefined values.
+        auto [tag, val] = block->at(idx);
+        if (tag == value::TypeTags::Nothing || tag == value::TypeTags::Null ||
+            tag == value::TypeTags::bsonUndefined || !isSelected(bitmap, idx)) {
+            continue;
+        }
+
+        if (accTag == value::TypeTags::Nothing) {
+            accTag = tag;
+            accVal = val;
+            continue;
+        }
+
+        auto [cmpTag, cmpVal] = value::compareValue(tag, val, accTag, accVal);
+        if (cmpTag == value::TypeTags::NumberInt32 &&
+            (IsMin ? value::bitcastTo<int32_t>(cmpVal) < 0
+                   : value::bitcastTo<int32_t>(cmpVal) > 0)) {
+            accTag = tag;
+            accVal = val;
+        }
+    }
+
+    // The result is a view into the block, so it needs to be copied.
+    auto [tag, val] = value::copyValue(accTag, accVal);
+    return {true, tag, val};
+}
+
+std::tuple<bool, value::TypeTags, value::Value> ByteCode::dispatchValueBlockBuiltin(
+    Builtin f, ArityType arity) {
+    switch (f) {
+        case Builtin::valueBlockFillEmpty:
+            return builtinValueBlockFillEmpty(arity);
+        case Builtin::valueBlockIsNumber:
+            return builtinValueBlockIsNumber(arity);
+        case Builtin::valueBlockGtScalar:
+            return builtinValueBlockCompareScalar<std::greater<>>(arity);
+        case Builtin::valueBlockGteScalar:
+            return builtinValueBlockCompareScalar<std::greater_equal<>>(arity);
+        case Builtin::valueBlockLtScalar:
+            return builtinValueBlockCompareScalar<std::less<>>(arity);
+        case Builtin::valueBlockLteScalar:
+            return builtinValueBlockCompareScalar<std::less_equal<>>(arity);
+        case Builtin::valueBlockEqScalar:
+            return builtinValueBlockCompareScalar<std::equal_to<>>(arity);
+        case Builtin::valueBlockNeqScalar:
+            return builtinValueBlockCompareScalar<std::not_equal_to<>>(arity);
+        case Builtin::valueBlockMatchGtScalar:
+            return builtinValueBlockMatchCompareScalar<std::greater<>>(arity);
+        case Builtin::valueBlockMatchGteScalar:
+            return builtinValueBlockMatchCompareScalar<std::greater_equal<>>(arity);
+        case Builtin::valueBlockMatchLtScalar:
+            return builtinValueBlockMatchCompareScalar<std::less<>>(arity);
+        case Builtin::valueBlockMatchLteScalar:
+            return builtinValueBlockMatchCompareScalar<std::less_equal<>>(arity);
+        case Builtin::valueBlockMatchEqScalar:
+            return builtinValueBlockMatchCompareScalar<std::equal_to<>>(arity);
+        case Builtin::valueBlockAdd:
+            return builtinValueBlockArithmetic<std::plus<>>(arity, &ByteCode::genericAdd);
+        case Builtin::valueBlockSub:
+            return builtinValueBlockArithmetic<std::minus<>>(arity, &ByteCode::genericSub);
+        case Builtin::valueBlockMult:
+            return builtinValueBlockArithmetic<std::multiplies<>>(arity, &ByteCode::genericMul);
+        case Builtin::valueBlockLogicalAnd:
+            return builtinValueBlockLogicalOp<true>(arity);
+        case Builtin::valueBlockLogicalOr:
+            return builtinValueBlockLogicalOp<false>(arity);
+        case Builtin::valueBlockCount:
+            return builtinValueBlockCount(arity);
+        case Builtin::valueBlockSum:
+            return builtinValueBlockSum(arity);
+        case Builtin::valueBlockAggDoubleDoubleSum:
+            return builtinValueBlockAggDoubleDoubleSum(arity);
+        case Builtin::valueBlockMin:
+            return builtinValueBlockMinMax<true>(arity);
+        case Builtin::valueBlockMax:
+            return builtinValueBlockMinMax<false>(arity);
+        default:
+            MONGO_UNREACHABLE;
+    }
+}
+}  // namespace vm
+}  // namespace sbe
+}  // namespace mongo
@@ -46,6 +46,8 @@ namespace mongo {
  *
  * db.runCommand({sbe: "sbe query text"})
  *
+ * The stages of the query may only spill to disk if the command also has 'allowDiskUse: true'.
+ *
  * This command is only for testing/experimentation, and requires the 'enableTestCommands' flag to
  * be turned on.
  */
@@ -98,7 +100,8 @@ public:
 
         auto env = std::make_unique<sbe::RuntimeEnvironment>();
         sbe::Parser parser(env.get());
-        auto root = parser.parse(opCtx, dbname, cmdObj["sbe"].String());
+        auto root = parser.parse(
+            opCtx, dbname, cmdObj["sbe"].String(), cmdObj["allowDiskUse"].trueValue());
         auto [resultSlot, recordIdSlot] = parser.getTopLevelSlots();
 
         std::unique_ptr<PlanExecutor, PlanExecutor::Deleter> exec;
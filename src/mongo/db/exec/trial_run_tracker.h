@@ -29,11 +29,14 @@
 
 #pragma once
 
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
 #include <functional>
 #include <type_traits>
 
+#include "mongo/platform/atomic_word.h"
+
 namespace mongo {
 /**
  * During the runtime planning phase this tracker is used to track the progress of the work done
@@ -105,8 +108,15 @@ public:
             return true;
         }
 
+        auto maxMetric = _maxMetrics[metric];
+        if constexpr (metric == TrialRunMetric::kNumReads) {
+            if (_sharedMaxNumReads) {
+                maxMetric = std::min(maxMetric, _sharedMaxNumReads->loadRelaxed());
+            }
+        }
+
         _metrics[metric] += metricIncrement;
-        if (_metrics[metric] > _maxMetrics[metric]) {
+        if (_metrics[metric] > maxMetric) {
             if (_onMetricReached) {
                 _done = _onMetricReached(metric);
             } else {
@@ -116,6 +126,17 @@ public:
         return _done;
     }
 
+    /**
+     * Makes the tracker also end the trial period once the number of reads exceeds
+     * 'sharedMaxNumReads'. Trial runs executing concurrently on different threads lower it as they
+     * complete, so that each of them gets the same budget of reads as if they had run one after
+     * another, whether it started before or after the others completed. The value must outlive
+     * the tracker.
+     */
+    void setSharedMaxNumReads(const AtomicWord<size_t>* sharedMaxNumReads) {
+        _sharedMaxNumReads = sharedMaxNumReads;
+    }
+
     template <TrialRunMetric metric>
     size_t getMetric() const {
         static_assert(metric >= 0 && metric < sizeof(_metrics) / sizeof(size_t));
@@ -127,5 +148,6 @@ private:
     size_t _metrics[TrialRunMetric::kLastElem]{0};
     bool _done{false};
     std::function<bool(TrialRunMetric)> _onMetricReached{};
+    const AtomicWord<size_t>* _sharedMaxNumReads{nullptr};
 };
 }  // namespace mongo
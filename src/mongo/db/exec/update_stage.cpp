@@ -178,6 +178,12 @@ BSONObj UpdateStage::transformAndUpdate(const Snapshotted<BSONObj>& oldObj,
     const bool isInsert = false;
     FieldRefSet immutablePaths;
 
+    // Operator and delta updates report the paths they write, which lets the index catalog skip
+    // key generation for every index over none of them.
+    const bool trackModifiedPaths = driver->type() == UpdateDriver::UpdateType::kOperator ||
+        driver->type() == UpdateDriver::UpdateType::kDelta;
+    FieldRefSetWithStorage modifiedPaths;
+
     if (_isUserInitiatedWrite) {
         // Documents coming directly from users should be validated for storage. It is safe to
         // access the CollectionShardingState in this write context and to throw SSV if the sharding
@@ -198,7 +204,8 @@ BSONObj UpdateStage::transformAndUpdate(const Snapshotted<BSONObj>& oldObj,
                                 immutablePaths,
                                 isInsert,
                                 &logObj,
-                                &docWasModified);
+                                &docWasModified,
+                                trackModifiedPaths ? &modifiedPaths : nullptr);
     } else {
         // If there was a matched field, obtain it.
         MatchDetails matchDetails;
@@ -218,7 +225,8 @@ BSONObj UpdateStage::transformAndUpdate(const Snapshotted<BSONObj>& oldObj,
                                 immutablePaths,
                                 isInsert,
                                 &logObj,
-                                &docWasModified);
+                                &docWasModified,
+                                trackModifiedPaths ? &modifiedPaths : nullptr);
     }
 
     if (!status.isOK()) {
@@ -276,6 +284,11 @@ BSONObj UpdateStage::transformAndUpdate(const Snapshotted<BSONObj>& oldObj,
         // Ensure we set the type correctly
         args.source = writeToOrphan ? OperationSource::kFromMigrate : request->source();
 
+        // A document without an _id has one generated above, which no modifier reports.
+        if (trackModifiedPaths && oldObj.value().hasField(idFieldName)) {
+            args.modifiedPaths = &modifiedPaths.getFieldRefSet();
+        }
+
         if (inPlace) {
             if (!request->explain()) {
                 newObj = oldObj.value();
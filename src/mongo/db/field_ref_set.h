@@ -185,6 +185,10 @@ public:
         return _fieldRefSet.toString();
     }
 
+    const FieldRefSet& getFieldRefSet() const {
+        return _fieldRefSet;
+    }
+
 private:
     // Holds the storage for FieldRef's inserted into the set. This may become out of sync with
     // '_fieldRefSet' since we don't attempt to remove conflicts from the backing set, which can
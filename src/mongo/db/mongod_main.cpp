@@ -109,9 +109,16 @@
 #include "mongo/db/op_observer_registry.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/db/periodic_runner_job_abort_expired_transactions.h"
+#include "mongo/db/pipeline/aggregation_result_cache_op_observer.h"
 #include "mongo/db/pipeline/change_stream_expired_pre_image_remover.h"
+#include "mongo/db/pipeline/document_source_facet.h"
+#include "mongo/db/pipeline/document_source_group.h"
 #include "mongo/db/pipeline/process_interface/replica_set_node_process_interface.h"
+#include "mongo/db/plan_cache_persistence.h"
+#include "mongo/db/query/ce/collection_statistics_cache_op_observer.h"
 #include "mongo/db/query/internal_plans.h"
+#include "mongo/db/query/sbe_plan_cache.h"
+#include "mongo/db/query/sbe_runtime_planner.h"
 #include "mongo/db/read_write_concern_defaults_cache_lookup_mongod.h"
 #include "mongo/db/repl/drop_pending_collection_reaper.h"
 #include "mongo/db/repl/initial_syncer_factory.h"
@@ -789,6 +796,13 @@ ExitCode _initAndListen(ServiceContext* serviceContext, int listenPort) {
         startChangeStreamExpiredPreImagesRemover(serviceContext);
     }
 
+    // Start a background task to periodically evict the least recently used entries from the SBE
+    // plan cache.
+    sbe::startPlanCacheEvictionJob(serviceContext);
+
+    // Start a background task to save the plan caches and to prewarm them from the saved entries.
+    plan_cache_persistence::startPlanCachePersistenceJob(serviceContext);
+
     // Set up the logical session cache
     LogicalSessionCacheServer kind = LogicalSessionCacheServer::kStandalone;
     if (serverGlobalParams.clusterRole == ClusterRole::ShardServer) {
@@ -1128,6 +1142,8 @@ void setUpObservers(ServiceContext* serviceContext) {
     opObserverRegistry->addObserver(
         std::make_unique<repl::PrimaryOnlyServiceOpObserver>(serviceContext));
     opObserverRegistry->addObserver(std::make_unique<FcvOpObserver>());
+    opObserverRegistry->addObserver(std::make_unique<AggregationResultCacheOpObserver>());
+    opObserverRegistry->addObserver(std::make_unique<ce::CollectionStatisticsCacheOpObserver>());
 
     if (gFeatureFlagClusterWideConfig.isEnabledAndIgnoreFCV()) {
         opObserverRegistry->addObserver(std::make_unique<ClusterServerParameterOpObserver>());
@@ -1177,6 +1193,10 @@ void shutdownTask(const ShutdownTaskArgs& shutdownArgs) {
         hangBeforeShutdown.pauseWhileSet();
     }
 
+    // Save the plan caches while this node may still be primary, so that the node which takes
+    // over, or this node after a restart, can prewarm its plan caches from them.
+    plan_cache_persistence::snapshotPlanCachesForShutdown(serviceContext);
+
     // If we don't have shutdownArgs, we're shutting down from a signal, or other clean shutdown
     // path.
     //
@@ -1230,6 +1250,15 @@ void shutdownTask(const ShutdownTaskArgs& shutdownArgs) {
     LOGV2_OPTIONS(6371601, {LogComponent::kDefault}, "Shutting down the FLE Crud thread pool");
     stopFLECrud();
 
+    LOGV2_OPTIONS(7132216, {LogComponent::kQuery}, "Shutting down the SBE trial run thread pool");
+    sbe::shutdownTrialRunThreadPool();
+
+    LOGV2_OPTIONS(7132223, {LogComponent::kQuery}, "Shutting down the $facet worker thread pool");
+    shutdownFacetWorkerThreadPool();
+
+    LOGV2_OPTIONS(7132225, {LogComponent::kQuery}, "Shutting down the $group worker thread pool");
+    shutdownGroupWorkerThreadPool();
+
     LOGV2_OPTIONS(4784901, {LogComponent::kCommand}, "Shutting down the MirrorMaestro");
     MirrorMaestro::shutdown(serviceContext);
 
@@ -209,6 +209,10 @@ bool NamespaceString::isLegalClientSystemNS(
     if (isChangeStreamPreImagesCollection()) {
         return true;
     }
+    if (isStatisticsCollection() &&
+        validCollectionName(coll().substr(kStatisticsCollectionPrefix.size()))) {
+        return true;
+    }
 
     return false;
 }
@@ -359,6 +363,10 @@ bool NamespaceString::isTimeseriesBucketsCollection() const {
     return coll().startsWith(kTimeseriesBucketsCollectionPrefix);
 }
 
+bool NamespaceString::isStatisticsCollection() const {
+    return coll().startsWith(kStatisticsCollectionPrefix);
+}
+
 bool NamespaceString::isChangeStreamPreImagesCollection() const {
     return ns() == kChangeStreamPreImagesNamespace.ns();
 }
@@ -380,6 +388,10 @@ NamespaceString NamespaceString::getTimeseriesViewNamespace() const {
     return {db(), coll().substr(kTimeseriesBucketsCollectionPrefix.size())};
 }
 
+NamespaceString NamespaceString::makeStatisticsNamespace() const {
+    return {db(), kStatisticsCollectionPrefix.toString() + coll()};
+}
+
 bool NamespaceString::isImplicitlyReplicated() const {
     if (isChangeStreamPreImagesCollection() || isConfigImagesCollection() || isChangeCollection()) {
         // Implicitly replicated namespaces are replicated, although they only replicate a subset of
@@ -95,6 +95,9 @@ public:
     // Prefix for time-series buckets collection.
     static constexpr StringData kTimeseriesBucketsCollectionPrefix = "system.buckets."_sd;
 
+    // Prefix for the collection holding the statistics gathered by 'analyze' for a collection.
+    static constexpr StringData kStatisticsCollectionPrefix = "system.statistics."_sd;
+
     // Namespace for storing configuration data, which needs to be replicated if the server is
     // running as a replica set. Documents in this collection should represent some configuration
     // state of the server, which needs to be recovered/consulted at startup. Each document in this
@@ -396,6 +399,11 @@ public:
      */
     bool isTimeseriesBucketsCollection() const;
 
+    /**
+     * Returns whether the specified namespace is <database>.system.statistics.<>.
+     */
+    bool isStatisticsCollection() const;
+
     /**
      * Returns whether the specified namespace is config.system.preimages.
      */
@@ -421,6 +429,11 @@ public:
      */
     NamespaceString getTimeseriesViewNamespace() const;
 
+    /**
+     * Returns the namespace of the collection holding the statistics of this collection.
+     */
+    NamespaceString makeStatisticsNamespace() const;
+
     /**
      * Returns whether the namespace is implicitly replicated, based only on its string value.
      *
@@ -134,6 +134,9 @@ TEST(NamespaceStringTest, IsLegalClientSystemNamespace) {
     ASSERT_FALSE(NamespaceString{"test.system.buckets..1234"}.isLegalClientSystemNS(currentFCV));
     ASSERT_FALSE(NamespaceString{"test.system.buckets.a234$"}.isLegalClientSystemNS(currentFCV));
     ASSERT_FALSE(NamespaceString{"test.system.buckets."}.isLegalClientSystemNS(currentFCV));
+    ASSERT_TRUE(NamespaceString{"test.system.statistics.abcde"}.isLegalClientSystemNS(currentFCV));
+    ASSERT_FALSE(NamespaceString{"test.system.statistics.a234$"}.isLegalClientSystemNS(currentFCV));
+    ASSERT_FALSE(NamespaceString{"test.system.statistics."}.isLegalClientSystemNS(currentFCV));
 }
 
 TEST(NamespaceStringTest, IsDropPendingNamespace) {
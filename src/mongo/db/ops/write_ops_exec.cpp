@@ -1380,11 +1380,13 @@ Status performAtomicTimeseriesWrites(
         auto recordId = record_id_helpers::keyForOID(update.getQ()["_id"].OID());
 
         auto original = coll->docFor(opCtx, recordId);
+        FieldRefSetWithStorage modifiedPaths;
         auto [updated, indexesAffected] =
             doc_diff::applyDiff(original.value(),
                                 update.getU().getDiff(),
                                 &CollectionQueryInfo::get(*coll).getIndexKeys(opCtx),
-                                static_cast<bool>(repl::tenantMigrationRecipientInfo(opCtx)));
+                                static_cast<bool>(repl::tenantMigrationRecipientInfo(opCtx)),
+                                &modifiedPaths);
 
         CollectionUpdateArgs args;
         if (const auto& stmtIds = op.getStmtIds()) {
@@ -1394,6 +1396,7 @@ Status performAtomicTimeseriesWrites(
         args.update = update_oplog_entry::makeDeltaOplogEntry(update.getU().getDiff());
         args.criteria = update.getQ();
         args.source = OperationSource::kTimeseriesInsert;
+        args.modifiedPaths = &modifiedPaths.getFieldRefSet();
         if (slot) {
             args.oplogSlots = {**slot};
             fassert(5481600,
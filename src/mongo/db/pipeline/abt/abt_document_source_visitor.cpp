@@ -287,8 +287,10 @@ private:
 
 class ABTDocumentSourceVisitor : public DocumentSourceConstVisitor {
 public:
-    ABTDocumentSourceVisitor(DSAlgebrizerContext& ctx, const Metadata& metadata)
-        : _ctx(ctx), _metadata(metadata) {}
+    ABTDocumentSourceVisitor(DSAlgebrizerContext& ctx,
+                             const Metadata& metadata,
+                             std::string scanDefName)
+        : _ctx(ctx), _metadata(metadata), _scanDefName(std::move(scanDefName)) {}
 
     void visit(const DocumentSourceBucketAuto* source) override {
         unsupportedStage(source);
@@ -488,7 +490,70 @@ public:
     }
 
     void visit(const DocumentSourceLookUp* source) override {
-        unsupportedStage(source);
+        // We only support the localField/foreignField form of $lookup followed by an $unwind of
+        // the result, which is equivalent to an inner equi-join.
+        const auto& unwindSource = source->getUnwindSource();
+        if (!source->hasLocalFieldForeignFieldJoin() || source->hasPipeline() ||
+            !source->getLetVariables().empty() || source->getAdditionalFilter() ||
+            !unwindSource || unwindSource->preserveNullAndEmptyArrays() ||
+            unwindSource->indexPath() || source->getAsField().getPathLength() != 1) {
+            unsupportedStage(source);
+        }
+
+        const FieldPath& localField = *source->getLocalField();
+        const std::string asFieldName = source->getAsField().fullPath();
+
+        const auto& entry = _ctx.getNode();
+        if (!_lookupChain || entry._node.cast<Node>() != _lookupChain->_lastNode ||
+            _lookupChain->refersToLookupOutput(localField)) {
+            // Start a new chain of lookups over the current node.
+            _lookupChain.emplace(entry._node, entry._rootProjection);
+        }
+
+        const FieldPath& foreignField = *source->getForeignField();
+        const std::string scanDefName = source->getFromNs().coll().toString();
+        const ProjectionName& foreignProjName = _ctx.getNextId("lookupScan");
+        ABT foreignNode = _metadata._scanDefs.at(scanDefName).exists()
+            ? make<ScanNode>(foreignProjName, scanDefName)
+            : make<ValueScanNode>(ProjectionNameVector{foreignProjName});
+
+        // An equality of the join keys only implements $lookup if neither key can be an array. We
+        // know this if a non-multikey index covers the key path of the collection documents.
+        // Otherwise we match the values element-wise, which only a nested loop join can do.
+        const bool canUseEquiJoin =
+            _lookupChain->_inputRootProjection == _ctx.getScanProjName() &&
+            isNonMultikeyPath(_scanDefName, localField) &&
+            isNonMultikeyPath(scanDefName, foreignField);
+        ABT joinPredicate = Constant::boolean(true);
+        if (canUseEquiJoin) {
+            const ProjectionName& foreignKeyProjName = _ctx.getNextId("lookupForeignKey");
+            foreignNode = make<EvaluationNode>(foreignKeyProjName,
+                                               generateLookupKey(foreignField, foreignProjName),
+                                               std::move(foreignNode));
+
+            // Local keys are computed over the input of the chain.
+            const ProjectionName& localKeyProjName = _ctx.getNextId("lookupLocalKey");
+            _lookupChain->_localKeys.emplace_back(
+                localKeyProjName,
+                generateLookupKey(localField, _lookupChain->_inputRootProjection));
+
+            joinPredicate = make<BinaryOp>(Operations::Eq,
+                                           make<Variable>(localKeyProjName),
+                                           make<Variable>(foreignKeyProjName));
+        } else {
+            joinPredicate = generateLookupMatch(
+                localField, _lookupChain->_inputRootProjection, foreignField, foreignProjName);
+        }
+
+        _lookupChain->_lookups.push_back({foreignProjName,
+                                          std::move(foreignNode),
+                                          std::move(joinPredicate),
+                                          asFieldName,
+                                          _ctx.getNextId("lookupRoot")});
+
+        ProjectionName rootProjName = _lookupChain->_lookups.back()._rootProjection;
+        _ctx.setNode(std::move(rootProjName), _lookupChain->generateABT());
+        _lookupChain->_lastNode = _ctx.getNode()._node.cast<Node>();
     }
 
     void visit(const DocumentSourceMatch* source) override {
@@ -738,6 +803,224 @@ public:
     }
 
 private:
+    /**
+     * A sequence of consecutive $lookup stages translated into inner joins. We compute the local
+     * keys of all lookups directly above the input of the sequence and place the joins next to
+     * each other, so that the optimizer is free to reorder them.
+     */
+    struct LookupChain {
+        struct Lookup {
+            ProjectionName _foreignProjection;
+            ABT _foreignNode;
+            ABT _joinPredicate;
+            std::string _asFieldName;
+            // Projection for the input document with the 'as' field set to the foreign document.
+            ProjectionName _rootProjection;
+        };
+
+        LookupChain(ABT input, ProjectionName inputRootProjection)
+            : _input(std::move(input)), _inputRootProjection(std::move(inputRootProjection)) {}
+
+        bool refersToLookupOutput(const FieldPath& localField) const {
+            for (const Lookup& lookup : _lookups) {
+                if (localField.getFieldName(0) == lookup._asFieldName) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        ABT generateABT() const {
+            ABT result = _input;
+            for (const auto& [projName, expr] : _localKeys) {
+                result = make<EvaluationNode>(projName, expr, std::move(result));
+            }
+            for (const Lookup& lookup : _lookups) {
+                result = make<BinaryJoinNode>(JoinType::Inner,
+                                              ProjectionNameSet{},
+                                              lookup._joinPredicate,
+                                              std::move(result),
+                                              lookup._foreignNode);
+            }
+
+            ProjectionName rootProjName = _inputRootProjection;
+            for (const Lookup& lookup : _lookups) {
+                result = make<EvaluationNode>(
+                    lookup._rootProjection,
+                    make<EvalPath>(
+                        make<PathField>(lookup._asFieldName,
+                                        make<PathConstant>(
+                                            make<Variable>(lookup._foreignProjection))),
+                        make<Variable>(rootProjName)),
+                    std::move(result));
+                rootProjName = lookup._rootProjection;
+            }
+            return result;
+        }
+
+        const ABT _input;
+        const ProjectionName _inputRootProjection;
+
+        std::vector<std::pair<ProjectionName, ABT>> _localKeys;
+        std::vector<Lookup> _lookups;
+
+        // The node generated by the last $lookup. Used to detect if the next stage is a $lookup
+        // which continues the chain.
+        const Node* _lastNode = nullptr;
+    };
+
+    /**
+     * Returns true if a non-multikey index of the collection 'scanDefName' proves that no array
+     * appears along 'fieldPath'. Partial indexes only describe some of the documents and are
+     * ignored.
+     */
+    bool isNonMultikeyPath(const std::string& scanDefName, const FieldPath& fieldPath) const {
+        auto scanDefIt = _metadata._scanDefs.find(scanDefName);
+        if (scanDefIt == _metadata._scanDefs.cend()) {
+            return false;
+        }
+
+        // The index metadata marks each multikey component of a key path with a traverse.
+        const ABT path = translateFieldPath(
+            fieldPath,
+            make<PathIdentity>(),
+            [](const std::string& fieldName, const bool isLastElement, ABT input) {
+                return make<PathGet>(fieldName, std::move(input));
+            });
+        for (const auto& [indexDefName, indexDef] : scanDefIt->second.getIndexDefs()) {
+            if (!indexDef.getPartialReqMap().empty()) {
+                continue;
+            }
+            for (const IndexCollationEntry& entry : indexDef.getCollationSpec()) {
+                if (entry._path == path) {
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    /**
+     * Generates the join key of a $lookup over the document in 'inputProjName', for a path which
+     * the index metadata proves cannot hold an array. A missing value matches null. An array can
+     * only appear if a write made the path multikey after the query was planned, in which case
+     * an equality would not implement the element-wise matching of $lookup and we fail the query.
+     */
+    ABT generateLookupKey(const FieldPath& fieldPath, const ProjectionName& inputProjName) const {
+        // Evaluates the path prefix, replacing a missing value with null.
+        const auto generateGetPath = [&](const FieldPath& path) {
+            const ProjectionName& valueVarName = _ctx.getNextId("lookupKeyValue");
+            return make<Let>(
+                valueVarName,
+                make<EvalPath>(
+                    translateFieldPath(
+                        path,
+                        make<PathIdentity>(),
+                        [](const std::string& fieldName, const bool isLastElement, ABT input) {
+                            return make<PathGet>(fieldName, std::move(input));
+                        }),
+                    make<Variable>(inputProjName)),
+                make<If>(make<FunctionCall>("exists", makeSeq(make<Variable>(valueVarName))),
+                         make<Variable>(valueVarName),
+                         Constant::null()));
+        };
+
+        boost::optional<ABT> hasArray;
+        for (size_t i = 0; i < fieldPath.getPathLength(); i++) {
+            ABT isArray = make<FunctionCall>(
+                "isArray", makeSeq(generateGetPath(FieldPath(fieldPath.getSubpath(i)))));
+            hasArray = hasArray
+                ? make<BinaryOp>(Operations::Or, std::move(*hasArray), std::move(isArray))
+                : std::move(isArray);
+        }
+
+        return make<If>(std::move(*hasArray),
+                        make<FunctionCall>("fail",
+                                           makeSeq(Constant::int32(7131902),
+                                                   Constant::str("$lookup key path became "
+                                                                 "multikey during the query"))),
+                        generateGetPath(fieldPath));
+    }
+
+    /**
+     * Generates the predicate matching the document in 'localProjName' with the document in
+     * 'foreignProjName' the way $lookup does. Every value found along 'localField', with the
+     * arrays along the path expanded, is compared with 'foreignField' like an equality in a $match
+     * would. A local document without any value at 'localField' matches as null.
+     */
+    ABT generateLookupMatch(const FieldPath& localField,
+                            const ProjectionName& localProjName,
+                            const FieldPath& foreignField,
+                            const ProjectionName& foreignProjName) const {
+        // Builds a path applying 'leaf' to every value at 'fieldPath', traversing the arrays along
+        // the path as well as an array at its end.
+        const auto generateTraversePath = [](const FieldPath& fieldPath, ABT leaf) {
+            return translateFieldPath(
+                fieldPath,
+                make<PathTraverse>(std::move(leaf)),
+                [](const std::string& fieldName, const bool isLastElement, ABT input) {
+                    return make<PathGet>(fieldName,
+                                         isLastElement ? std::move(input)
+                                                       : make<PathTraverse>(std::move(input)));
+                });
+        };
+
+        // Matches the foreign document if 'localValue' is equal to one of the values at
+        // 'foreignField' or to an array at its end. A missing foreign value only matches null.
+        const auto generateForeignMatch = [&](const ABT& localValue) {
+            const auto makeEqualsLocal = [&]() {
+                const ProjectionName& valueVarName = _ctx.getNextId("lookupForeignValue");
+                return make<PathLambda>(make<LambdaAbstraction>(
+                    valueVarName,
+                    make<If>(make<FunctionCall>("exists", makeSeq(make<Variable>(valueVarName))),
+                             make<FunctionCall>("fillEmpty",
+                                                makeSeq(make<BinaryOp>(Operations::Eq,
+                                                                       make<Variable>(valueVarName),
+                                                                       localValue),
+                                                        Constant::boolean(false))),
+                             make<FunctionCall>("isNull", makeSeq(localValue)))));
+            };
+
+            ABT path = translateFieldPath(
+                foreignField,
+                make<PathComposeA>(make<PathTraverse>(makeEqualsLocal()), makeEqualsLocal()),
+                [](const std::string& fieldName, const bool isLastElement, ABT input) {
+                    return make<PathGet>(fieldName,
+                                         isLastElement ? std::move(input)
+                                                       : make<PathTraverse>(std::move(input)));
+                });
+            return make<EvalFilter>(std::move(path), make<Variable>(foreignProjName));
+        };
+
+        const ProjectionName& localValueVarName = _ctx.getNextId("lookupLocalValue");
+        ABT anyLocalValueMatches = make<EvalFilter>(
+            generateTraversePath(
+                localField,
+                make<PathLambda>(make<LambdaAbstraction>(
+                    localValueVarName,
+                    make<If>(
+                        make<FunctionCall>("exists", makeSeq(make<Variable>(localValueVarName))),
+                        generateForeignMatch(make<Variable>(localValueVarName)),
+                        Constant::boolean(false))))),
+            make<Variable>(localProjName));
+
+        const ProjectionName& existsVarName = _ctx.getNextId("lookupLocalExists");
+        ABT hasLocalValue = make<EvalFilter>(
+            generateTraversePath(
+                localField,
+                make<PathLambda>(make<LambdaAbstraction>(
+                    existsVarName,
+                    make<FunctionCall>("exists", makeSeq(make<Variable>(existsVarName)))))),
+            make<Variable>(localProjName));
+
+        return make<BinaryOp>(
+            Operations::Or,
+            std::move(anyLocalValueMatches),
+            make<BinaryOp>(Operations::And,
+                           make<UnaryOp>(Operations::Not, std::move(hasLocalValue)),
+                           generateForeignMatch(Constant::null())));
+    }
+
     void unsupportedStage(const DocumentSource* source) const {
         uasserted(ErrorCodes::InternalErrorNotSupported,
                   str::stream() << "Stage is not supported: " << source->getSourceName());
@@ -752,6 +1035,10 @@ private:
 
     DSAlgebrizerContext& _ctx;
     const Metadata& _metadata;
+    // The scan definition of the collection the pipeline runs on, or empty if it does not exist.
+    const std::string _scanDefName;
+
+    boost::optional<LookupChain> _lookupChain;
 };
 
 ABT translatePipelineToABT(const Metadata& metadata,
@@ -759,8 +1046,12 @@ ABT translatePipelineToABT(const Metadata& metadata,
                            ProjectionName scanProjName,
                            ABT initialNode,
                            PrefixId& prefixId) {
+    std::string scanDefName;
+    if (const auto* scanNode = initialNode.cast<ScanNode>()) {
+        scanDefName = scanNode->getScanDefName();
+    }
     DSAlgebrizerContext ctx(prefixId, {scanProjName, std::move(initialNode)});
-    ABTDocumentSourceVisitor visitor(ctx, metadata);
+    ABTDocumentSourceVisitor visitor(ctx, metadata, std::move(scanDefName));
 
     DocumentSourceWalker walker(nullptr /*preVisitor*/, &visitor);
     walker.walk(pipeline);
@@ -0,0 +1,195 @@
+/**
+ *    Copyright (C) 2022-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "mongo/db/pipeline/accumulation_statement.h"
+
+namespace mongo {
+
+/**
+ * $approxCountDistinct estimates the number of distinct values in a group with a HyperLogLog
+ * sketch, so its memory use does not grow with the number of distinct values. Values are hashed
+ * with the collation-aware ValueComparator, so values which compare equal are counted once.
+ *
+ * While a group has few distinct values the sketch keeps their hashes, which makes the count
+ * exact. Once the hashes would take more space than the registers they are folded into the
+ * registers and the count becomes an estimate with a relative standard error of about 0.8%.
+ */
+class AccumulatorApproxCountDistinct final : public AccumulatorState {
+public:
+    static constexpr auto kName = "$approxCountDistinct"_sd;
+
+    // Field names of the partial result returned by getValue(true).
+    static constexpr auto kFieldNameHashes = "hashes"_sd;
+    static constexpr auto kFieldNameRegisters = "registers"_sd;
+
+    // Number of hash bits which select a register.
+    static constexpr int kPrecision = 14;
+    static constexpr size_t kNumRegisters = size_t{1} << kPrecision;
+    static constexpr size_t kMaxHashes = kNumRegisters / sizeof(uint64_t);
+
+    const char* getOpName() const final {
+        return kName.rawData();
+    }
+
+    explicit AccumulatorApproxCountDistinct(ExpressionContext* expCtx);
+
+    void processInternal(const Value& input, bool merging) final;
+    Value getValue(bool toBeMerged) final;
+    void reset() final;
+
+    static boost::intrusive_ptr<AccumulatorState> create(ExpressionContext* expCtx);
+
+    bool isAssociative() const final {
+        return true;
+    }
+
+    bool isCommutative() const final {
+        return true;
+    }
+
+private:
+    uint64_t hashValue(const Value& input) const;
+    void addHash(uint64_t hash);
+    void addToRegisters(uint64_t hash);
+    void convertToRegisters();
+    void updateMemUsage();
+    long long estimate() const;
+
+    // The distinct hashes seen so far in sorted order. Only used until there are more than
+    // 'kMaxHashes' of them.
+    std::vector<uint64_t> _hashes;
+
+    // Holds the highest rank seen for each register. Empty until the hashes are converted.
+    std::vector<uint8_t> _registers;
+};
+
+/**
+ * $percentileApprox estimates the requested percentiles of the numeric values in a group with a
+ * merging t-digest. Its syntax is
+ *
+ *     {$percentileApprox: {input: <expression>, p: [<number between 0 and 1>, ...]}}
+ *
+ * and it returns an array holding the estimate of each percentile in 'p', or null if the group had
+ * no numeric values. The digest keeps a bounded number of centroids, which are smallest near the
+ * extremes, so the tail percentiles are the most accurate ones.
+ */
+class AccumulatorPercentileApprox final : public AccumulatorState {
+public:
+    static constexpr auto kName = "$percentileApprox"_sd;
+
+    static constexpr auto kFieldNameInput = "input"_sd;
+    static constexpr auto kFieldNameP = "p"_sd;
+
+    // Field names of the partial result returned by getValue(true).
+    static constexpr auto kFieldNameMeans = "means"_sd;
+    static constexpr auto kFieldNameWeights = "weights"_sd;
+    static constexpr auto kFieldNameMin = "min"_sd;
+    static constexpr auto kFieldNameMax = "max"_sd;
+
+    // The digest holds at most about kCompression * pi / 2 centroids.
+    static constexpr double kCompression = 100;
+
+    // Number of values which are buffered before they are merged into the centroids.
+    static constexpr size_t kMaxBufferSize = 500;
+
+    const char* getOpName() const final {
+        return kName.rawData();
+    }
+
+    AccumulatorPercentileApprox(ExpressionContext* expCtx, std::vector<double> percentiles);
+
+    void processInternal(const Value& input, bool merging) final;
+    Value getValue(bool toBeMerged) final;
+    void reset() final;
+
+    Document serialize(boost::intrusive_ptr<Expression> initializer,
+                       boost::intrusive_ptr<Expression> argument,
+                       bool explain) const final;
+
+    static boost::intrusive_ptr<AccumulatorState> create(ExpressionContext* expCtx,
+                                                         std::vector<double> percentiles);
+
+    /**
+     * Parses the {input: <expression>, p: [...]} argument, returning the 'input' expression and the
+     * requested percentiles. Also used to parse the $percentileApprox window function.
+     */
+    static std::pair<boost::intrusive_ptr<Expression>, std::vector<double>> parseArgs(
+        ExpressionContext* expCtx, BSONElement elem, VariablesParseState vps);
+
+    static AccumulationExpression parse(ExpressionContext* expCtx,
+                                        BSONElement elem,
+                                        VariablesParseState vps);
+
+    static Value serializePercentiles(const std::vector<double>& percentiles);
+
+    bool isAssociative() const final {
+        return true;
+    }
+
+    bool isCommutative() const final {
+        return true;
+    }
+
+private:
+    struct Centroid {
+        double mean;
+        double weight;
+    };
+
+    void add(double mean, double weight);
+
+    /**
+     * Merges the buffered values into the centroids.
+     */
+    void compress();
+
+    /**
+     * Estimates the value at percentile 'p'. The buffer must be empty.
+     */
+    double quantile(double p) const;
+
+    void updateMemUsage();
+
+    const std::vector<double> _percentiles;
+
+    // Sorted by mean.
+    std::vector<Centroid> _centroids;
+    std::vector<Centroid> _buffer;
+
+    double _totalWeight = 0;
+    double _min = 0;
+    double _max = 0;
+};
+
+}  // namespace mongo
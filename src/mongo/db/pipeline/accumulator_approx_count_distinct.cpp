@@ -0,0 +1,252 @@
+/**
+ *    Copyright (C) 2022-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+#include "mongo/db/pipeline/accumulator_approx.h"
+
+#include "mongo/base/data_view.h"
+#include "mongo/db/exec/document_value/document.h"
+#include "mongo/db/exec/document_value/value.h"
+#include "mongo/db/pipeline/accumulation_statement.h"
+#include "mongo/db/pipeline/expression_context.h"
+#include "mongo/db/pipeline/window_function/window_function_expression.h"
+#include "mongo/db/query/query_feature_flags_gen.h"
+#include "mongo/platform/bits.h"
+
+namespace mongo {
+using boost::intrusive_ptr;
+
+REGISTER_ACCUMULATOR_CONDITIONALLY(
+    approxCountDistinct,
+    genericParseSBEUnsupportedSingleExpressionAccumulator<AccumulatorApproxCountDistinct>,
+    AllowedWithApiStrict::kNeverInVersion1,
+    AllowedWithClientType::kAny,
+    feature_flags::gFeatureFlagApproxAccumulators.getVersion(),
+    feature_flags::gFeatureFlagApproxAccumulators.isEnabledAndIgnoreFCV());
+REGISTER_WINDOW_FUNCTION_CONDITIONALLY(
+    approxCountDistinct,
+    window_function::ExpressionFromAccumulator<AccumulatorApproxCountDistinct>::parse,
+    feature_flags::gFeatureFlagApproxAccumulators.getVersion(),
+    feature_flags::gFeatureFlagApproxAccumulators.isEnabledAndIgnoreFCV());
+
+namespace {
+// Number of hash bits left after the register index has been taken off.
+constexpr int kRankBits = 64 - AccumulatorApproxCountDistinct::kPrecision;
+
+/**
+ * The finalizer of MurmurHash3. The hash of a Value is built with boost::hash_combine(), so its bits
+ * need not be evenly distributed, which the sketch relies on.
+ */
+uint64_t mixHash(uint64_t hash) {
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdULL;
+    hash ^= hash >> 33;
+    hash *= 0xc4ceb9fe1a85ec53ULL;
+    hash ^= hash >> 33;
+    return hash;
+}
+
+uint8_t rankOf(uint64_t hash) {
+    const uint64_t rest = hash << AccumulatorApproxCountDistinct::kPrecision;
+    return rest == 0 ? kRankBits + 1 : countLeadingZerosNonZero64(rest) + 1;
+}
+
+// The sigma and tau functions of the improved raw estimator from Otmar Ertl, "New cardinality
+// estimation algorithms for HyperLogLog sketches" (2017). Unlike the original estimator, it needs
+// neither range corrections nor empirical bias tables.
+double sigma(double x) {
+    if (x == 1.0) {
+        return std::numeric_limits<double>::infinity();
+    }
+    double y = 1.0;
+    double z = x;
+    double previousZ;
+    do {
+        x *= x;
+        previousZ = z;
+        z += x * y;
+        y += y;
+    } while (z != previousZ);
+    return z;
+}
+
+double tau(double x) {
+    if (x == 0.0 || x == 1.0) {
+        return 0.0;
+    }
+    double y = 1.0;
+    double z = 1.0 - x;
+    double previousZ;
+    do {
+        x = std::sqrt(x);
+        previousZ = z;
+        y *= 0.5;
+        z -= (1.0 - x) * (1.0 - x) * y;
+    } while (z != previousZ);
+    return z / 3.0;
+}
+}  // namespace
+
+AccumulatorApproxCountDistinct::AccumulatorApproxCountDistinct(ExpressionContext* const expCtx)
+    : AccumulatorState(expCtx) {
+    updateMemUsage();
+}
+
+intrusive_ptr<AccumulatorState> AccumulatorApproxCountDistinct::create(
+    ExpressionContext* const expCtx) {
+    return make_intrusive<AccumulatorApproxCountDistinct>(expCtx);
+}
+
+uint64_t AccumulatorApproxCountDistinct::hashValue(const Value& input) const {
+    return mixHash(getExpressionContext()->getValueComparator().hash(input));
+}
+
+void AccumulatorApproxCountDistinct::processInternal(const Value& input, bool merging) {
+    if (!merging) {
+        // Like $addToSet, count null but not missing values.
+        if (!input.missing()) {
+            addHash(hashValue(input));
+            updateMemUsage();
+        }
+        return;
+    }
+
+    // This is what getValue(true) produced below.
+    tassert(7132208, "input must be an object when 'merging' is true", input.getType() == Object);
+    if (auto hashes = input[kFieldNameHashes]; !hashes.missing()) {
+        tassert(7132209, "'hashes' must be BinData", hashes.getType() == BinData);
+        auto binData = hashes.getBinData();
+        tassert(7132210, "'hashes' has an invalid length", binData.length % sizeof(uint64_t) == 0);
+        ConstDataView view(static_cast<const char*>(binData.data));
+        for (int offset = 0; offset < binData.length; offset += sizeof(uint64_t)) {
+            addHash(view.read<LittleEndian<uint64_t>>(offset));
+        }
+    } else {
+        auto registers = input[kFieldNameRegisters];
+        tassert(7132211,
+                "'registers' must be BinData with one byte per register",
+                registers.getType() == BinData &&
+                    static_cast<size_t>(registers.getBinData().length) == kNumRegisters);
+        convertToRegisters();
+        auto data = static_cast<const uint8_t*>(registers.getBinData().data);
+        for (size_t i = 0; i < kNumRegisters; ++i) {
+            _registers[i] = std::max(_registers[i], data[i]);
+        }
+    }
+    updateMemUsage();
+}
+
+void AccumulatorApproxCountDistinct::addHash(uint64_t hash) {
+    if (!_registers.empty()) {
+        addToRegisters(hash);
+        return;
+    }
+
+    auto it = std::lower_bound(_hashes.begin(), _hashes.end(), hash);
+    if (it != _hashes.end() && *it == hash) {
+        return;
+    }
+    _hashes.insert(it, hash);
+    if (_hashes.size() > kMaxHashes) {
+        convertToRegisters();
+    }
+}
+
+void AccumulatorApproxCountDistinct::addToRegisters(uint64_t hash) {
+    auto& reg = _registers[hash >> kRankBits];
+    reg = std::max(reg, rankOf(hash));
+}
+
+void AccumulatorApproxCountDistinct::convertToRegisters() {
+    if (!_registers.empty()) {
+        return;
+    }
+    _registers.resize(kNumRegisters, 0);
+    for (auto hash : _hashes) {
+        addToRegisters(hash);
+    }
+    _hashes.clear();
+    _hashes.shrink_to_fit();
+}
+
+void AccumulatorApproxCountDistinct::updateMemUsage() {
+    _memUsageBytes =
+        sizeof(*this) + _hashes.capacity() * sizeof(uint64_t) + _registers.capacity();
+}
+
+long long AccumulatorApproxCountDistinct::estimate() const {
+    // Histogram of the register values, which are between 0 and kRankBits + 1.
+    std::array<int, kRankBits + 2> counts{};
+    for (auto reg : _registers) {
+        ++counts[reg];
+    }
+
+    const double m = kNumRegisters;
+    double z = m * tau(1.0 - counts[kRankBits + 1] / m);
+    for (int k = kRankBits; k >= 1; --k) {
+        z = 0.5 * (z + counts[k]);
+    }
+    z += m * sigma(counts[0] / m);
+    return std::llround(m * m / (2 * std::log(2.0) * z));
+}
+
+Value AccumulatorApproxCountDistinct::getValue(bool toBeMerged) {
+    if (!toBeMerged) {
+        return Value(_registers.empty() ? static_cast<long long>(_hashes.size()) : estimate());
+    }
+
+    if (_registers.empty()) {
+        std::vector<char> buffer(_hashes.size() * sizeof(uint64_t));
+        DataView view(buffer.data());
+        for (size_t i = 0; i < _hashes.size(); ++i) {
+            view.write<LittleEndian<uint64_t>>(_hashes[i], i * sizeof(uint64_t));
+        }
+        return Value(DOC(kFieldNameHashes << BSONBinData(buffer.data(),
+                                                         static_cast<int>(buffer.size()),
+                                                         BinDataGeneral)));
+    }
+    return Value(DOC(kFieldNameRegisters << BSONBinData(_registers.data(),
+                                                        static_cast<int>(_registers.size()),
+                                                        BinDataGeneral)));
+}
+
+void AccumulatorApproxCountDistinct::reset() {
+    _hashes.clear();
+    _hashes.shrink_to_fit();
+    _registers.clear();
+    _registers.shrink_to_fit();
+    updateMemUsage();
+}
+
+}  // namespace mongo
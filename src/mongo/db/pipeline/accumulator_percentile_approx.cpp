@@ -0,0 +1,296 @@
+/**
+ *    Copyright (C) 2022-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "mongo/db/pipeline/accumulator_approx.h"
+
+#include "mongo/db/exec/document_value/document.h"
+#include "mongo/db/exec/document_value/value.h"
+#include "mongo/db/pipeline/accumulation_statement.h"
+#include "mongo/db/pipeline/expression.h"
+#include "mongo/db/pipeline/expression_context.h"
+#include "mongo/db/pipeline/window_function/window_function_expression.h"
+#include "mongo/db/query/query_feature_flags_gen.h"
+
+namespace mongo {
+using boost::intrusive_ptr;
+
+REGISTER_ACCUMULATOR_CONDITIONALLY(
+    percentileApprox,
+    AccumulatorPercentileApprox::parse,
+    AllowedWithApiStrict::kNeverInVersion1,
+    AllowedWithClientType::kAny,
+    feature_flags::gFeatureFlagApproxAccumulators.getVersion(),
+    feature_flags::gFeatureFlagApproxAccumulators.isEnabledAndIgnoreFCV());
+REGISTER_WINDOW_FUNCTION_CONDITIONALLY(
+    percentileApprox,
+    window_function::ExpressionPercentileApprox::parse,
+    feature_flags::gFeatureFlagApproxAccumulators.getVersion(),
+    feature_flags::gFeatureFlagApproxAccumulators.isEnabledAndIgnoreFCV());
+
+namespace {
+/**
+ * Returns the largest percentile which a centroid starting at percentile 'q' may reach. This is
+ * the k1 scale function of Ted Dunning and Otmar Ertl, "Computing extremely accurate quantiles
+ * using t-digests" (2019), which allows one unit of k between the edges of a centroid.
+ */
+double percentileLimit(double q) {
+    constexpr double kScale = AccumulatorPercentileApprox::kCompression / (2 * M_PI);
+    const double k = kScale * std::asin(2 * q - 1) + 1;
+    return k >= kScale * M_PI / 2 ? 1.0 : (std::sin(k / kScale) + 1) / 2;
+}
+}  // namespace
+
+AccumulatorPercentileApprox::AccumulatorPercentileApprox(ExpressionContext* const expCtx,
+                                                         std::vector<double> percentiles)
+    : AccumulatorState(expCtx), _percentiles(std::move(percentiles)) {
+    updateMemUsage();
+}
+
+intrusive_ptr<AccumulatorState> AccumulatorPercentileApprox::create(
+    ExpressionContext* const expCtx, std::vector<double> percentiles) {
+    return make_intrusive<AccumulatorPercentileApprox>(expCtx, std::move(percentiles));
+}
+
+std::pair<intrusive_ptr<Expression>, std::vector<double>> AccumulatorPercentileApprox::parseArgs(
+    ExpressionContext* const expCtx, BSONElement elem, VariablesParseState vps) {
+    uassert(7132201,
+            str::stream() << kName << " requires an object argument; found " << elem,
+            elem.type() == BSONType::Object);
+
+    intrusive_ptr<Expression> input;
+    boost::optional<std::vector<double>> percentiles;
+    for (auto&& arg : elem.embeddedObject()) {
+        auto fieldName = arg.fieldNameStringData();
+        if (fieldName == kFieldNameInput) {
+            input = Expression::parseOperand(expCtx, arg, vps);
+        } else if (fieldName == kFieldNameP) {
+            uassert(7132202,
+                    str::stream() << kName << " 'p' must be a non-empty array; found " << arg,
+                    arg.type() == BSONType::Array && !arg.embeddedObject().isEmpty());
+            percentiles.emplace();
+            for (auto&& p : arg.embeddedObject()) {
+                uassert(7132203,
+                        str::stream() << kName << " 'p' must only contain numbers between 0 and 1; "
+                                      << "found " << p,
+                        p.isNumber() && p.numberDouble() >= 0 && p.numberDouble() <= 1);
+                percentiles->push_back(p.numberDouble());
+            }
+        } else {
+            uasserted(7132204, str::stream() << "Unknown argument for " << kName << ": " << arg);
+        }
+    }
+    uassert(7132205, str::stream() << kName << " requires an 'input' argument", input);
+    uassert(7132206, str::stream() << kName << " requires a 'p' argument", percentiles);
+    return {std::move(input), std::move(*percentiles)};
+}
+
+AccumulationExpression AccumulatorPercentileApprox::parse(ExpressionContext* const expCtx,
+                                                          BSONElement elem,
+                                                          VariablesParseState vps) {
+    expCtx->sbeGroupCompatible = false;
+    auto args = parseArgs(expCtx, elem, vps);
+    auto initializer = ExpressionConstant::create(expCtx, Value(BSONNULL));
+    return {std::move(initializer),
+            std::move(args.first),
+            [expCtx, percentiles = std::move(args.second)]() {
+                return AccumulatorPercentileApprox::create(expCtx, percentiles);
+            },
+            kName};
+}
+
+Value AccumulatorPercentileApprox::serializePercentiles(const std::vector<double>& percentiles) {
+    return Value(std::vector<Value>(percentiles.begin(), percentiles.end()));
+}
+
+Document AccumulatorPercentileApprox::serialize(intrusive_ptr<Expression> initializer,
+                                                intrusive_ptr<Expression> argument,
+                                                bool explain) const {
+    return DOC(getOpName() << DOC(kFieldNameInput << argument->serialize(explain) << kFieldNameP
+                                                  << serializePercentiles(_percentiles)));
+}
+
+void AccumulatorPercentileApprox::processInternal(const Value& input, bool merging) {
+    if (!merging) {
+        // Like $avg, ignore non-numeric values. NaN has no place in the order either.
+        if (input.numeric() && !std::isnan(input.coerceToDouble())) {
+            add(input.coerceToDouble(), 1);
+        }
+    } else {
+        // This is what getValue(true) produced below.
+        tassert(
+            7132212, "input must be an object when 'merging' is true", input.getType() == Object);
+        auto means = input[kFieldNameMeans];
+        auto weights = input[kFieldNameWeights];
+        tassert(7132213,
+                "'means' and 'weights' must be arrays of the same length",
+                means.isArray() && weights.isArray() &&
+                    means.getArrayLength() == weights.getArrayLength());
+        if (means.getArrayLength() == 0) {
+            return;  // This partition had no data to contribute.
+        }
+
+        for (size_t i = 0; i < means.getArrayLength(); ++i) {
+            add(means[i].getDouble(), weights[i].getDouble());
+        }
+        _min = std::min(_min, input[kFieldNameMin].coerceToDouble());
+        _max = std::max(_max, input[kFieldNameMax].coerceToDouble());
+    }
+    updateMemUsage();
+}
+
+void AccumulatorPercentileApprox::add(double mean, double weight) {
+    if (_totalWeight == 0) {
+        _min = mean;
+        _max = mean;
+    } else {
+        _min = std::min(_min, mean);
+        _max = std::max(_max, mean);
+    }
+    _totalWeight += weight;
+    _buffer.push_back({mean, weight});
+    if (_buffer.size() >= kMaxBufferSize) {
+        compress();
+    }
+}
+
+void AccumulatorPercentileApprox::compress() {
+    if (_buffer.empty()) {
+        return;
+    }
+
+    _buffer.insert(_buffer.end(), _centroids.begin(), _centroids.end());
+    std::sort(_buffer.begin(), _buffer.end(), [](const Centroid& lhs, const Centroid& rhs) {
+        return lhs.mean < rhs.mean;
+    });
+
+    // Grow each centroid from the left for as long as it stays within the limit of the scale
+    // function at its left edge.
+    _centroids.clear();
+    double weightSoFar = 0;
+    double weightLimit = _totalWeight * percentileLimit(0);
+    Centroid current = _buffer.front();
+    for (auto it = std::next(_buffer.begin()); it != _buffer.end(); ++it) {
+        if (weightSoFar + current.weight + it->weight <= weightLimit) {
+            current.weight += it->weight;
+            if (it->mean != current.mean) {
+                current.mean += (it->mean - current.mean) * it->weight / current.weight;
+            }
+        } else {
+            weightSoFar += current.weight;
+            _centroids.push_back(current);
+            weightLimit = _totalWeight * percentileLimit(weightSoFar / _totalWeight);
+            current = *it;
+        }
+    }
+    _centroids.push_back(current);
+    _buffer.clear();
+}
+
+double AccumulatorPercentileApprox::quantile(double p) const {
+    invariant(_buffer.empty() && !_centroids.empty());
+    if (p <= 0) {
+        return _min;
+    }
+    if (p >= 1) {
+        return _max;
+    }
+    if (_centroids.size() == 1) {
+        return _centroids.front().mean;
+    }
+
+    // Each centroid is treated as having half of its weight on either side of its mean, and the
+    // estimate is interpolated linearly between the means of neighboring centroids. The tails are
+    // interpolated between the extreme centroids and the exact minimum and maximum.
+    const double target = p * _totalWeight;
+    const auto& first = _centroids.front();
+    if (target < first.weight / 2) {
+        return _min + (first.mean - _min) * target / (first.weight / 2);
+    }
+
+    double weightSoFar = first.weight / 2;
+    for (size_t i = 0; i + 1 < _centroids.size(); ++i) {
+        const double step = (_centroids[i].weight + _centroids[i + 1].weight) / 2;
+        if (weightSoFar + step > target) {
+            return _centroids[i].mean +
+                (_centroids[i + 1].mean - _centroids[i].mean) * (target - weightSoFar) / step;
+        }
+        weightSoFar += step;
+    }
+
+    const auto& last = _centroids.back();
+    return last.mean + (_max - last.mean) * (target - weightSoFar) / (last.weight / 2);
+}
+
+Value AccumulatorPercentileApprox::getValue(bool toBeMerged) {
+    compress();
+    updateMemUsage();
+
+    if (toBeMerged) {
+        std::vector<Value> means;
+        std::vector<Value> weights;
+        for (auto&& centroid : _centroids) {
+            means.emplace_back(centroid.mean);
+            weights.emplace_back(centroid.weight);
+        }
+        return Value(DOC(kFieldNameMeans << Value(std::move(means)) << kFieldNameWeights
+                                         << Value(std::move(weights)) << kFieldNameMin << _min
+                                         << kFieldNameMax << _max));
+    }
+
+    if (_totalWeight == 0) {
+        return Value(BSONNULL);
+    }
+
+    std::vector<Value> result;
+    for (auto p : _percentiles) {
+        result.emplace_back(quantile(p));
+    }
+    return Value(std::move(result));
+}
+
+void AccumulatorPercentileApprox::updateMemUsage() {
+    _memUsageBytes = sizeof(*this) + _percentiles.capacity() * sizeof(double) +
+        (_centroids.capacity() + _buffer.capacity()) * sizeof(Centroid);
+}
+
+void AccumulatorPercentileApprox::reset() {
+    _centroids.clear();
+    _buffer.clear();
+    _totalWeight = 0;
+    _min = 0;
+    _max = 0;
+    updateMemUsage();
+}
+
+}  // namespace mongo
@@ -38,6 +38,7 @@
 #include "mongo/db/exec/document_value/document_value_test_util.h"
 #include "mongo/db/pipeline/accumulation_statement.h"
 #include "mongo/db/pipeline/accumulator.h"
+#include "mongo/db/pipeline/accumulator_approx.h"
 #include "mongo/db/pipeline/accumulator_for_window_functions.h"
 #include "mongo/db/pipeline/accumulator_multi.h"
 #include "mongo/db/pipeline/aggregation_context_fixture.h"
@@ -1743,6 +1744,173 @@ TEST(Accumulators, CovarianceWithRandomVariables) {
     assertCovariance<AccumulatorCovarianceSamp>(&expCtx, randomVariables, boost::none);
 }
 
+/* ------------------------- AccumulatorApproxCountDistinct -------------------------- */
+
+TEST(Accumulators, ApproxCountDistinctIsExactForFewValues) {
+    auto expCtx = ExpressionContextForTest{};
+    assertExpectedResults<AccumulatorApproxCountDistinct>(
+        &expCtx,
+        {{{}, Value(0LL)},
+         {{Value()}, Value(0LL)},
+         {{Value(BSONNULL), Value()}, Value(1LL)},
+         {{Value(1), Value(1.0), Value(1LL), Value(2)}, Value(2LL)},
+         {{Value("a"_sd), Value("b"_sd), Value("a"_sd), Value(1)}, Value(3LL)}});
+}
+
+TEST(Accumulators, ApproxCountDistinctRespectsCollation) {
+    auto expCtx = ExpressionContextForTest{};
+    auto collator =
+        std::make_unique<CollatorInterfaceMock>(CollatorInterfaceMock::MockType::kAlwaysEqual);
+    expCtx.setCollator(std::move(collator));
+    assertExpectedResults<AccumulatorApproxCountDistinct>(
+        &expCtx, {{{Value("a"_sd), Value("b"_sd), Value("c"_sd)}, Value(1LL)}});
+}
+
+TEST(Accumulators, ApproxCountDistinctEstimatesManyValuesInBoundedMemory) {
+    auto expCtx = ExpressionContextForTest{};
+    const int numDistinct = 200000;
+    const size_t numShards = 4;
+
+    auto merger = AccumulatorApproxCountDistinct::create(&expCtx);
+    std::vector<intrusive_ptr<AccumulatorState>> shards;
+    for (size_t i = 0; i < numShards; ++i) {
+        shards.push_back(AccumulatorApproxCountDistinct::create(&expCtx));
+    }
+    auto single = AccumulatorApproxCountDistinct::create(&expCtx);
+
+    // Each value is seen twice, by different shards, and half of the values are strings.
+    for (int i = 0; i < 2 * numDistinct; ++i) {
+        const int n = i % numDistinct;
+        Value val = n % 2 ? Value(n) : Value("str" + std::to_string(n));
+        shards[i % numShards]->process(val, false);
+        single->process(val, false);
+    }
+    for (auto&& shard : shards) {
+        merger->process(shard->getValue(true), true);
+    }
+
+    const size_t maxMemUsage =
+        sizeof(AccumulatorApproxCountDistinct) + AccumulatorApproxCountDistinct::kNumRegisters;
+    for (auto&& accum : {merger, single}) {
+        auto estimate = accum->getValue(false).getLong();
+        ASSERT_LT(std::abs(estimate - numDistinct), numDistinct * 0.03) << estimate;
+        ASSERT_LTE(static_cast<size_t>(accum->getMemUsage()), maxMemUsage);
+    }
+
+    // Merging a sketch with itself does not change the estimate.
+    auto estimate = merger->getValue(false);
+    merger->process(single->getValue(true), true);
+    ASSERT_VALUE_EQ(merger->getValue(false), estimate);
+}
+
+/* ------------------------- AccumulatorPercentileApprox -------------------------- */
+
+TEST(Accumulators, PercentileApproxIsExactForFewValues) {
+    auto expCtx = ExpressionContextForTest{};
+    auto initializeAccumulator = [](ExpressionContext* const expCtx) {
+        return AccumulatorPercentileApprox::create(expCtx, {0, 0.5, 1});
+    };
+    assertExpectedResults(
+        &expCtx,
+        {{{}, Value(BSONNULL)},
+         {{Value("a"_sd), Value(BSONNULL), Value(std::nan(""))}, Value(BSONNULL)},
+         {{Value(4)}, Value(std::vector<Value>{Value(4.0), Value(4.0), Value(4.0)})},
+         {{Value(4), Value(2LL), Value(5.0), Value(1), Value(Decimal128(3)), Value("a"_sd)},
+          Value(std::vector<Value>{Value(1.0), Value(3.0), Value(5.0)})}},
+        initializeAccumulator);
+}
+
+TEST(Accumulators, PercentileApproxEstimatesManyValuesInBoundedMemory) {
+    auto expCtx = ExpressionContextForTest{};
+    const std::vector<double> percentiles{0, 0.01, 0.25, 0.5, 0.99, 1};
+    const int numValues = 100000;
+    const size_t numShards = 4;
+
+    auto merger = AccumulatorPercentileApprox::create(&expCtx, percentiles);
+    std::vector<intrusive_ptr<AccumulatorState>> shards;
+    for (size_t i = 0; i < numShards; ++i) {
+        shards.push_back(AccumulatorPercentileApprox::create(&expCtx, percentiles));
+    }
+    auto single = AccumulatorPercentileApprox::create(&expCtx, percentiles);
+
+    // Visit the values 0 to 'numValues' - 1 in a scrambled order.
+    size_t maxMemUsage = 0;
+    for (int i = 0; i < numValues; ++i) {
+        Value val(static_cast<int>((i * 7919LL) % numValues));
+        shards[i % numShards]->process(val, false);
+        single->process(val, false);
+        maxMemUsage = std::max(maxMemUsage, static_cast<size_t>(single->getMemUsage()));
+    }
+    for (auto&& shard : shards) {
+        merger->process(shard->getValue(true), true);
+    }
+    ASSERT_LT(maxMemUsage, 32 * 1024UL);
+
+    for (auto&& accum : {merger, single}) {
+        auto result = accum->getValue(false);
+        ASSERT_EQ(result.getArrayLength(), percentiles.size());
+        for (size_t i = 0; i < percentiles.size(); ++i) {
+            const double expected = percentiles[i] * (numValues - 1);
+            ASSERT_LT(std::abs(result[i].getDouble() - expected), numValues * 0.005)
+                << "p: " << percentiles[i] << ", estimate: " << result[i].getDouble();
+        }
+        ASSERT_EQ(result[0].getDouble(), 0);
+        ASSERT_EQ(result[percentiles.size() - 1].getDouble(), numValues - 1);
+    }
+}
+
+TEST(Accumulators, PercentileApproxRejectsInvalidArguments) {
+    auto expCtx = ExpressionContextForTest{};
+    auto parse = [&](BSONObj spec) {
+        return AccumulatorPercentileApprox::parseArgs(
+            &expCtx, spec.firstElement(), expCtx.variablesParseState);
+    };
+    ASSERT_THROWS_CODE(parse(BSON("$percentileApprox"
+                                  << "$x")),
+                       AssertionException,
+                       7132201);
+    ASSERT_THROWS_CODE(parse(BSON("$percentileApprox" << BSON("input"
+                                                              << "$x"
+                                                              << "p" << 0.5))),
+                       AssertionException,
+                       7132202);
+    ASSERT_THROWS_CODE(parse(BSON("$percentileApprox" << BSON("input"
+                                                              << "$x"
+                                                              << "p" << BSONArray()))),
+                       AssertionException,
+                       7132202);
+    ASSERT_THROWS_CODE(parse(BSON("$percentileApprox" << BSON("input"
+                                                              << "$x"
+                                                              << "p" << BSON_ARRAY(0.5 << 1.5)))),
+                       AssertionException,
+                       7132203);
+    ASSERT_THROWS_CODE(parse(BSON("$percentileApprox" << BSON("input"
+                                                              << "$x"
+                                                              << "p" << BSON_ARRAY("$y")))),
+                       AssertionException,
+                       7132203);
+    ASSERT_THROWS_CODE(parse(BSON("$percentileApprox" << BSON("input"
+                                                              << "$x"
+                                                              << "p" << BSON_ARRAY(0.5) << "n"
+                                                              << 1))),
+                       AssertionException,
+                       7132204);
+    ASSERT_THROWS_CODE(parse(BSON("$percentileApprox" << BSON("p" << BSON_ARRAY(0.5)))),
+                       AssertionException,
+                       7132205);
+    ASSERT_THROWS_CODE(parse(BSON("$percentileApprox" << BSON("input"
+                                                              << "$x"))),
+                       AssertionException,
+                       7132206);
+
+    auto spec = BSON("$percentileApprox" << BSON("input"
+                                                 << "$x"
+                                                 << "p" << BSON_ARRAY(0 << 0.5 << 1)));
+    auto [input, percentiles] = parse(spec);
+    ASSERT_EQ(percentiles.size(), 3UL);
+    ASSERT_EQ(percentiles[1], 0.5);
+}
+
 /* ------------------------- AccumulatorMergeObjects -------------------------- */
 
 TEST(AccumulatorMergeObjects, MergingZeroObjectsShouldReturnEmptyDocument) {
@@ -0,0 +1,302 @@
+/**
+ *    Copyright (C) 2022-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/aggregation_result_cache.h"
+
+#include <set>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/catalog/collection_catalog.h"
+#include "mongo/db/commands/server_status_metric.h"
+#include "mongo/db/operation_context.h"
+#include "mongo/db/pipeline/expression_context.h"
+#include "mongo/db/pipeline/pipeline.h"
+#include "mongo/db/query/query_knobs_gen.h"
+#include "mongo/db/server_options.h"
+#include "mongo/db/service_context.h"
+#include "mongo/db/storage/recovery_unit.h"
+
+namespace mongo {
+namespace {
+
+const auto getAggregationResultCache = ServiceContext::declareDecoration<AggregationResultCache>();
+
+Counter64 aggregationResultCacheHits;
+Counter64 aggregationResultCacheMisses;
+Counter64 aggregationResultCacheInvalidations;
+Counter64 aggregationResultCacheEvictions;
+Counter64 aggregationResultCacheSizeBytes;
+
+ServerStatusMetricField<Counter64> aggregationResultCacheHitsMetric(
+    "query.aggregationResultCache.hits", &aggregationResultCacheHits);
+ServerStatusMetricField<Counter64> aggregationResultCacheMissesMetric(
+    "query.aggregationResultCache.misses", &aggregationResultCacheMisses);
+ServerStatusMetricField<Counter64> aggregationResultCacheInvalidationsMetric(
+    "query.aggregationResultCache.invalidations", &aggregationResultCacheInvalidations);
+ServerStatusMetricField<Counter64> aggregationResultCacheEvictionsMetric(
+    "query.aggregationResultCache.evictions", &aggregationResultCacheEvictions);
+ServerStatusMetricField<Counter64> aggregationResultCacheSizeBytesMetric(
+    "query.aggregationResultCache.sizeBytes", &aggregationResultCacheSizeBytes);
+
+// Stages which only read from the collections named in the pipeline and produce the same output
+// for the same input. Any other stage prevents an aggregation from being cached.
+const std::set<StringData> kCacheableStages{
+    "$_internalUnpackBucket"_sd,
+    "$_unpackBucket"_sd,
+    "$addFields"_sd,
+    "$bucket"_sd,
+    "$bucketAuto"_sd,
+    "$count"_sd,
+    "$densify"_sd,
+    "$facet"_sd,
+    "$fill"_sd,
+    "$geoNear"_sd,
+    "$graphLookup"_sd,
+    "$group"_sd,
+    "$limit"_sd,
+    "$lookup"_sd,
+    "$match"_sd,
+    "$project"_sd,
+    "$redact"_sd,
+    "$replaceRoot"_sd,
+    "$replaceWith"_sd,
+    "$set"_sd,
+    "$setWindowFields"_sd,
+    "$skip"_sd,
+    "$sort"_sd,
+    "$sortByCount"_sd,
+    "$unionWith"_sd,
+    "$unset"_sd,
+    "$unwind"_sd,
+};
+
+// Operators and variables whose value differs between executions of the same pipeline.
+const std::set<StringData> kNonDeterministicOperators{
+    "$accumulator"_sd, "$function"_sd, "$rand"_sd, "$sampleRate"_sd, "$where"_sd};
+const std::vector<StringData> kNonDeterministicVariables{
+    "$$CLUSTER_TIME"_sd, "$$NOW"_sd, "$$SEARCH_META"_sd, "$$USER_ROLES"_sd};
+
+bool isDeterministic(const BSONObj& obj) {
+    for (auto&& elem : obj) {
+        if (kNonDeterministicOperators.count(elem.fieldNameStringData())) {
+            return false;
+        }
+        if (elem.type() == String &&
+            std::any_of(kNonDeterministicVariables.begin(),
+                        kNonDeterministicVariables.end(),
+                        [&](StringData var) { return elem.valueStringData().startsWith(var); })) {
+            return false;
+        }
+        if (elem.isABSONObj() && !isDeterministic(elem.Obj())) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool isCacheablePipeline(const NamespaceString& nss, const std::vector<BSONObj>& pipeline) {
+    return LiteParsedPipeline(nss, pipeline).allStageNamesSatisfy([](StringData stageName) {
+        return kCacheableStages.count(stageName) > 0;
+    }) && std::all_of(pipeline.begin(), pipeline.end(), isDeterministic);
+}
+
+}  // namespace
+
+AggregationResultCache& AggregationResultCache::get(ServiceContext* serviceContext) {
+    return getAggregationResultCache(serviceContext);
+}
+
+bool AggregationResultCache::isEnabled() {
+    return internalQueryAggregationResultCacheMaxSizeBytes.load() > 0;
+}
+
+boost::optional<AggregationResultCache::Key> AggregationResultCache::makeKey(
+    OperationContext* opCtx,
+    const NamespaceString& nss,
+    const AggregateCommandRequest& request,
+    const LiteParsedPipeline& liteParsedPipeline,
+    const Pipeline& pipeline,
+    const UUID& collectionUUID) {
+    // Only cache the results of reads of the latest data, which every write invalidates. Reads at
+    // an older timestamp, such as majority reads and reads on secondaries, could observe a write
+    // only after it was used to invalidate the cache.
+    if (opCtx->inMultiDocumentTransaction() ||
+        opCtx->recoveryUnit()->getTimestampReadSource() != RecoveryUnit::kNoTimestamp ||
+        serverGlobalParams.clusterRole == ClusterRole::ShardServer) {
+        return boost::none;
+    }
+    if (request.getExplain() || request.getExchange() || request.getFromMongos() ||
+        request.getNeedsMerge() || request.getRequestReshardingResumeToken() ||
+        request.getLegacyRuntimeConstants() || request.getEncryptionInformation() ||
+        !liteParsedPipeline.allStageNamesSatisfy(
+            [](StringData stageName) { return kCacheableStages.count(stageName) > 0; }) ||
+        !std::all_of(request.getPipeline().begin(), request.getPipeline().end(), isDeterministic) ||
+        (request.getLet() && !isDeterministic(*request.getLet()))) {
+        return boost::none;
+    }
+
+    const auto& expCtx = pipeline.getContext();
+    std::set<UUID> uuids{collectionUUID};
+    BSONObjBuilder shape;
+    shape.append("ns", nss.ns());
+    shape.append("pipeline", pipeline.serializeToBson());
+    shape.append("collation", expCtx->getCollatorBSON());
+    shape.append("let", request.getLet().value_or(BSONObj()));
+    shape.append("hint", request.getHint().value_or(BSONObj()));
+
+    // Views read by the pipeline are identified by their definition, and the collections they are
+    // defined on.
+    BSONObjBuilder views(shape.subobjStart("views"));
+    for (auto&& involvedNss : liteParsedPipeline.getInvolvedNamespaces()) {
+        const auto& resolvedNs = expCtx->getResolvedNamespace(involvedNss);
+        auto uuid = CollectionCatalog::get(opCtx)->lookupUUIDByNSS(opCtx, resolvedNs.ns);
+        if (!uuid || !isCacheablePipeline(resolvedNs.ns, resolvedNs.pipeline)) {
+            return boost::none;
+        }
+        uuids.insert(*uuid);
+        views.append(involvedNss.ns(), resolvedNs.pipeline);
+    }
+    views.done();
+
+    BSONArrayBuilder uuidsBuilder(shape.subarrayStart("uuids"));
+    for (auto&& uuid : uuids) {
+        uuid.appendToArrayBuilder(&uuidsBuilder);
+    }
+    uuidsBuilder.done();
+
+    auto shapeObj = shape.obj();
+    return Key{std::string(shapeObj.objdata(), shapeObj.objsize()), {uuids.begin(), uuids.end()}};
+}
+
+AggregationResultCache::Generations AggregationResultCache::getGenerations() const {
+    Generations generations;
+    for (size_t i = 0; i < kNumGenerationStripes; ++i) {
+        generations[i] = _generations[i].load();
+    }
+    return generations;
+}
+
+std::shared_ptr<const std::vector<BSONObj>> AggregationResultCache::lookup(const Key& key,
+                                                                           Date_t now) {
+    stdx::lock_guard<Latch> lk(_mutex);
+    _updateBudget(lk);
+
+    auto entry = _cache.get(key.serialized);
+    if (!entry.isOK()) {
+        aggregationResultCacheMisses.increment();
+        return nullptr;
+    }
+
+    const auto maxAge = Seconds(internalQueryAggregationResultCacheMaxEntryAgeSecs.load());
+    if (_isStale(*entry.getValue()) || now - entry.getValue()->createdAt > maxAge) {
+        aggregationResultCacheSizeBytes.decrement(entry.getValue()->size);
+        _cache.erase(key.serialized);
+        aggregationResultCacheInvalidations.increment();
+        aggregationResultCacheMisses.increment();
+        return nullptr;
+    }
+
+    aggregationResultCacheHits.increment();
+    return entry.getValue()->results;
+}
+
+void AggregationResultCache::insert(const Key& key,
+                                    std::vector<BSONObj> results,
+                                    const Generations& readGenerations,
+                                    Date_t now) {
+    auto entry = std::make_unique<Entry>();
+    entry->createdAt = now;
+    entry->size = sizeof(Entry) + 2 * key.serialized.size();
+    for (auto&& result : results) {
+        entry->size += sizeof(BSONObj) + result.objsize();
+    }
+    for (auto&& uuid : key.uuids) {
+        const auto stripe = stripeOf(uuid);
+        entry->generations.emplace_back(stripe, readGenerations[stripe]);
+    }
+    entry->results = std::make_shared<const std::vector<BSONObj>>(std::move(results));
+
+    stdx::lock_guard<Latch> lk(_mutex);
+    _updateBudget(lk);
+
+    // Results read before a write to one of their collections committed may not reflect it.
+    if (entry->size > _maxSizeBytes || _isStale(*entry)) {
+        return;
+    }
+
+    const auto sizeBefore = _cache.size();
+    aggregationResultCacheEvictions.increment(_cache.add(key.serialized, entry.release()));
+    aggregationResultCacheSizeBytes.increment(_cache.size());
+    aggregationResultCacheSizeBytes.decrement(sizeBefore);
+}
+
+void AggregationResultCache::onCollectionWrite(const UUID& uuid) {
+    _generations[stripeOf(uuid)].fetchAndAdd(1);
+}
+
+void AggregationResultCache::onAllCollectionsWrite() {
+    for (auto&& generation : _generations) {
+        generation.fetchAndAdd(1);
+    }
+}
+
+void AggregationResultCache::clear() {
+    stdx::lock_guard<Latch> lk(_mutex);
+    aggregationResultCacheSizeBytes.decrement(_cache.size());
+    _cache.clear();
+}
+
+size_t AggregationResultCache::size() const {
+    stdx::lock_guard<Latch> lk(_mutex);
+    return _cache.size();
+}
+
+bool AggregationResultCache::_isStale(const Entry& entry) const {
+    return std::any_of(entry.generations.begin(), entry.generations.end(), [&](auto&& generation) {
+        return _generations[generation.first].load() != generation.second;
+    });
+}
+
+void AggregationResultCache::_updateBudget(WithLock) {
+    const auto maxSizeBytes =
+        static_cast<size_t>(internalQueryAggregationResultCacheMaxSizeBytes.load());
+    if (maxSizeBytes == _maxSizeBytes) {
+        return;
+    }
+
+    _maxSizeBytes = maxSizeBytes;
+    const auto sizeBefore = _cache.size();
+    aggregationResultCacheEvictions.increment(_cache.reset(_maxSizeBytes));
+    aggregationResultCacheSizeBytes.decrement(sizeBefore - _cache.size());
+}
+
+}  // namespace mongo
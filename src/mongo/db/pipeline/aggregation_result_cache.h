@@ -0,0 +1,173 @@
+/**
+ *    Copyright (C) 2022-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include <array>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "mongo/bson/bsonobj.h"
+#include "mongo/db/pipeline/aggregate_command_gen.h"
+#include "mongo/db/pipeline/lite_parsed_pipeline.h"
+#include "mongo/db/query/lru_key_value.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/platform/mutex.h"
+#include "mongo/util/time_support.h"
+#include "mongo/util/uuid.h"
+
+namespace mongo {
+
+class ExpressionContext;
+class OperationContext;
+class Pipeline;
+class ServiceContext;
+
+/**
+ * Caches the results of read-only, deterministic aggregations whose whole result set was returned
+ * in their first batch, so that an identical aggregation can be answered without executing its
+ * pipeline as long as none of the collections it reads have been written to in the meantime.
+ *
+ * Writes are tracked by generation counters, striped by collection UUID, which are bumped when a
+ * write to a collection commits. An entry remembers the generations of its collections observed
+ * before its results were read, and is discarded when it is looked up after any of them moved on.
+ * The cache is disabled unless 'internalQueryAggregationResultCacheMaxSizeBytes' is positive.
+ */
+class AggregationResultCache {
+public:
+    static constexpr size_t kNumGenerationStripes = 256;
+
+    /**
+     * The write generations of all collections. These must be captured before an aggregation
+     * opens its storage snapshot, so that a write committed concurrently with the aggregation
+     * prevents its possibly stale results from being cached.
+     */
+    using Generations = std::array<uint64_t, kNumGenerationStripes>;
+
+    /**
+     * Identifies the results of an aggregation. 'serialized' holds the shape of its optimized
+     * pipeline and of the views it reads, together with the UUIDs of the collections it reads,
+     * which are also listed in 'uuids'.
+     */
+    struct Key {
+        std::string serialized;
+        std::vector<UUID> uuids;
+    };
+
+    static AggregationResultCache& get(ServiceContext* serviceContext);
+
+    /**
+     * Returns true if the size budget of the cache is positive.
+     */
+    static bool isEnabled();
+
+    /**
+     * Returns the key under which the results of the optimized 'pipeline', run against the
+     * collection 'collectionUUID' and returned on a cursor over 'nss', are cached. Returns
+     * boost::none if they must not be cached: when the pipeline writes data or is not
+     * deterministic, when it reads a collection which does not exist, or when the operation does
+     * not read the latest data.
+     */
+    static boost::optional<Key> makeKey(OperationContext* opCtx,
+                                        const NamespaceString& nss,
+                                        const AggregateCommandRequest& request,
+                                        const LiteParsedPipeline& liteParsedPipeline,
+                                        const Pipeline& pipeline,
+                                        const UUID& collectionUUID);
+
+    Generations getGenerations() const;
+
+    /**
+     * Returns the results cached under 'key', or nullptr if there are none or if they are stale.
+     */
+    std::shared_ptr<const std::vector<BSONObj>> lookup(const Key& key, Date_t now);
+
+    /**
+     * Caches 'results' under 'key', unless any of its collections has been written to since
+     * 'readGenerations' were captured.
+     */
+    void insert(const Key& key,
+                std::vector<BSONObj> results,
+                const Generations& readGenerations,
+                Date_t now);
+
+    /**
+     * Marks the results of all aggregations which read the collection 'uuid' as stale.
+     */
+    void onCollectionWrite(const UUID& uuid);
+
+    /**
+     * Marks the results of all aggregations as stale.
+     */
+    void onAllCollectionsWrite();
+
+    void clear();
+
+    /**
+     * Returns the estimated size in bytes of all cached results.
+     */
+    size_t size() const;
+
+private:
+    struct Entry {
+        std::shared_ptr<const std::vector<BSONObj>> results;
+
+        // The stripes of the collections the results were read from, and their generations at the
+        // time.
+        std::vector<std::pair<size_t, uint64_t>> generations;
+
+        Date_t createdAt;
+        size_t size = 0;
+    };
+
+    struct EntrySizeEstimator {
+        size_t operator()(const Entry& entry) const {
+            return entry.size;
+        }
+    };
+
+    static size_t stripeOf(const UUID& uuid) {
+        return UUID::Hash{}(uuid) % kNumGenerationStripes;
+    }
+
+    bool _isStale(const Entry& entry) const;
+
+    // Applies the current value of the size budget knob to '_cache'. Requires '_mutex'.
+    void _updateBudget(WithLock);
+
+    std::array<AtomicWord<unsigned long long>, kNumGenerationStripes> _generations;
+
+    mutable Mutex _mutex = MONGO_MAKE_LATCH("AggregationResultCache::_mutex");
+    size_t _maxSizeBytes = 0;
+    LRUKeyValue<std::string, Entry, EntrySizeEstimator> _cache{0};
+};
+
+}  // namespace mongo
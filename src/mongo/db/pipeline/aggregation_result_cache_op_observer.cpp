@@ -0,0 +1,140 @@
+/**
+ *    Copyright (C) 2022-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/aggregation_result_cache_op_observer.h"
+
+#include "mongo/db/concurrency/locker.h"
+#include "mongo/db/operation_context.h"
+#include "mongo/db/pipeline/aggregation_result_cache.h"
+
+namespace mongo {
+namespace {
+
+/**
+ * Marks the cached results which read the collection 'uuid', or all cached results if 'uuid' is
+ * not given, as stale once the current write unit of work commits. The generations must only move
+ * on after the write is visible, so that results read concurrently with it are never cached.
+ */
+void invalidateOnCommit(OperationContext* opCtx, boost::optional<UUID> uuid) {
+    auto invalidate = [serviceContext = opCtx->getServiceContext(),
+                       uuid = std::move(uuid)](boost::optional<Timestamp>) {
+        auto& cache = AggregationResultCache::get(serviceContext);
+        if (uuid) {
+            cache.onCollectionWrite(*uuid);
+        } else {
+            cache.onAllCollectionsWrite();
+        }
+    };
+
+    if (opCtx->lockState()->inAWriteUnitOfWork()) {
+        opCtx->recoveryUnit()->onCommit(std::move(invalidate));
+    } else {
+        invalidate(boost::none);
+    }
+}
+
+}  // namespace
+
+void AggregationResultCacheOpObserver::onInserts(OperationContext* opCtx,
+                                                 const NamespaceString& nss,
+                                                 const UUID& uuid,
+                                                 std::vector<InsertStatement>::const_iterator begin,
+                                                 std::vector<InsertStatement>::const_iterator end,
+                                                 bool fromMigrate) {
+    invalidateOnCommit(opCtx, uuid);
+}
+
+void AggregationResultCacheOpObserver::onUpdate(OperationContext* opCtx,
+                                                const OplogUpdateEntryArgs& args) {
+    invalidateOnCommit(opCtx, args.uuid);
+}
+
+void AggregationResultCacheOpObserver::onDelete(OperationContext* opCtx,
+                                                const NamespaceString& nss,
+                                                const UUID& uuid,
+                                                StmtId stmtId,
+                                                const OplogDeleteEntryArgs& args) {
+    invalidateOnCommit(opCtx, uuid);
+}
+
+void AggregationResultCacheOpObserver::onCreateCollection(OperationContext* opCtx,
+                                                          const CollectionPtr& coll,
+                                                          const NamespaceString& collectionName,
+                                                          const CollectionOptions& options,
+                                                          const BSONObj& idIndex,
+                                                          const OplogSlot& createOpTime) {
+    // A collection may be recreated with the UUID of a dropped one, for example by initial sync.
+    if (options.uuid) {
+        invalidateOnCommit(opCtx, *options.uuid);
+    }
+}
+
+void AggregationResultCacheOpObserver::onImportCollection(OperationContext* opCtx,
+                                                          const UUID& importUUID,
+                                                          const NamespaceString& nss,
+                                                          long long numRecords,
+                                                          long long dataSize,
+                                                          const BSONObj& catalogEntry,
+                                                          const BSONObj& storageMetadata,
+                                                          bool isDryRun) {
+    if (!isDryRun) {
+        invalidateOnCommit(opCtx, importUUID);
+    }
+}
+
+void AggregationResultCacheOpObserver::onDropDatabase(OperationContext* opCtx,
+                                                      const std::string& dbName) {
+    invalidateOnCommit(opCtx, boost::none);
+}
+
+repl::OpTime AggregationResultCacheOpObserver::onDropCollection(
+    OperationContext* opCtx,
+    const NamespaceString& collectionName,
+    const UUID& uuid,
+    std::uint64_t numRecords,
+    const CollectionDropType dropType) {
+    invalidateOnCommit(opCtx, uuid);
+    return {};
+}
+
+void AggregationResultCacheOpObserver::onEmptyCapped(OperationContext* opCtx,
+                                                     const NamespaceString& collectionName,
+                                                     const UUID& uuid) {
+    invalidateOnCommit(opCtx, uuid);
+}
+
+void AggregationResultCacheOpObserver::_onReplicationRollback(OperationContext* opCtx,
+                                                              const RollbackObserverInfo& rbInfo) {
+    AggregationResultCache::get(opCtx->getServiceContext()).onAllCollectionsWrite();
+}
+
+}  // namespace mongo
@@ -0,0 +1,163 @@
+/**
+ *    Copyright (C) 2022-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/pipeline/aggregation_result_cache.h"
+#include "mongo/idl/server_parameter_test_util.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+const Date_t kNow = Date_t::fromMillisSinceEpoch(1000000);
+
+std::vector<BSONObj> makeResults(int n) {
+    std::vector<BSONObj> results;
+    for (int i = 0; i < n; ++i) {
+        results.push_back(BSON("_id" << i));
+    }
+    return results;
+}
+
+// Returns a UUID whose writes are tracked separately from those of 'other'.
+UUID makeUUIDInOtherStripe(const UUID& other) {
+    const auto stripe = [](const UUID& uuid) {
+        return UUID::Hash{}(uuid) % AggregationResultCache::kNumGenerationStripes;
+    };
+    auto uuid = UUID::gen();
+    while (stripe(uuid) == stripe(other)) {
+        uuid = UUID::gen();
+    }
+    return uuid;
+}
+
+class AggregationResultCacheTest : public unittest::Test {
+protected:
+    RAIIServerParameterControllerForTest _maxSizeBytes{
+        "internalQueryAggregationResultCacheMaxSizeBytes", 1024 * 1024};
+    AggregationResultCache _cache;
+};
+
+TEST_F(AggregationResultCacheTest, ReturnsInsertedResults) {
+    const AggregationResultCache::Key key{"a", {UUID::gen()}};
+    ASSERT_FALSE(_cache.lookup(key, kNow));
+
+    _cache.insert(key, makeResults(3), _cache.getGenerations(), kNow);
+    auto results = _cache.lookup(key, kNow);
+    ASSERT(results);
+    ASSERT_EQ(3U, results->size());
+    ASSERT_BSONOBJ_EQ(BSON("_id" << 2), (*results)[2]);
+    ASSERT_GT(_cache.size(), 0U);
+
+    // Keys of other pipeline shapes miss.
+    ASSERT_FALSE(_cache.lookup({"b", key.uuids}, kNow));
+}
+
+TEST_F(AggregationResultCacheTest, DoesNotCacheWhenDisabled) {
+    RAIIServerParameterControllerForTest maxSizeBytes(
+        "internalQueryAggregationResultCacheMaxSizeBytes", 0);
+    ASSERT_FALSE(AggregationResultCache::isEnabled());
+
+    const AggregationResultCache::Key key{"a", {UUID::gen()}};
+    _cache.insert(key, makeResults(3), _cache.getGenerations(), kNow);
+    ASSERT_FALSE(_cache.lookup(key, kNow));
+    ASSERT_EQ(0U, _cache.size());
+}
+
+TEST_F(AggregationResultCacheTest, WriteToCollectionInvalidatesResults) {
+    const auto uuid = UUID::gen();
+    const auto otherUUID = makeUUIDInOtherStripe(uuid);
+    _cache.insert({"a", {uuid}}, makeResults(1), _cache.getGenerations(), kNow);
+    _cache.insert({"b", {otherUUID, uuid}}, makeResults(1), _cache.getGenerations(), kNow);
+
+    // Only the results read from the written collection are invalidated.
+    _cache.onCollectionWrite(otherUUID);
+    ASSERT(_cache.lookup({"a", {uuid}}, kNow));
+    ASSERT_FALSE(_cache.lookup({"b", {otherUUID, uuid}}, kNow));
+
+    _cache.onCollectionWrite(uuid);
+    ASSERT_FALSE(_cache.lookup({"a", {uuid}}, kNow));
+    ASSERT_EQ(0U, _cache.size());
+}
+
+TEST_F(AggregationResultCacheTest, WriteDuringReadPreventsCaching) {
+    const AggregationResultCache::Key key{"a", {UUID::gen()}};
+    const auto readGenerations = _cache.getGenerations();
+    _cache.onCollectionWrite(key.uuids[0]);
+    _cache.insert(key, makeResults(1), readGenerations, kNow);
+    ASSERT_FALSE(_cache.lookup(key, kNow));
+
+    // Results read after the write are cached.
+    _cache.insert(key, makeResults(1), _cache.getGenerations(), kNow);
+    ASSERT(_cache.lookup(key, kNow));
+}
+
+TEST_F(AggregationResultCacheTest, RollbackInvalidatesAllResults) {
+    const AggregationResultCache::Key key{"a", {UUID::gen()}};
+    _cache.insert(key, makeResults(1), _cache.getGenerations(), kNow);
+    _cache.onAllCollectionsWrite();
+    ASSERT_FALSE(_cache.lookup(key, kNow));
+}
+
+TEST_F(AggregationResultCacheTest, ExpiredResultsAreNotReturned) {
+    RAIIServerParameterControllerForTest maxAge(
+        "internalQueryAggregationResultCacheMaxEntryAgeSecs", 10);
+    const AggregationResultCache::Key key{"a", {UUID::gen()}};
+    _cache.insert(key, makeResults(1), _cache.getGenerations(), kNow);
+    ASSERT(_cache.lookup(key, kNow + Seconds(10)));
+    ASSERT_FALSE(_cache.lookup(key, kNow + Seconds(11)));
+}
+
+TEST_F(AggregationResultCacheTest, EvictsLeastRecentlyUsedResultsOverBudget) {
+    const auto uuid = UUID::gen();
+    _cache.insert({"a", {uuid}}, makeResults(10), _cache.getGenerations(), kNow);
+    const auto entrySize = _cache.size();
+
+    RAIIServerParameterControllerForTest maxSizeBytes(
+        "internalQueryAggregationResultCacheMaxSizeBytes",
+        static_cast<long long>(2 * entrySize + entrySize / 2));
+    _cache.insert({"b", {uuid}}, makeResults(10), _cache.getGenerations(), kNow);
+    ASSERT(_cache.lookup({"a", {uuid}}, kNow));
+    _cache.insert({"c", {uuid}}, makeResults(10), _cache.getGenerations(), kNow);
+
+    ASSERT(_cache.lookup({"a", {uuid}}, kNow));
+    ASSERT_FALSE(_cache.lookup({"b", {uuid}}, kNow));
+    ASSERT(_cache.lookup({"c", {uuid}}, kNow));
+    ASSERT_EQ(2 * entrySize, _cache.size());
+
+    // Results larger than the whole budget are not cached.
+    _cache.insert({"d", {uuid}}, makeResults(100), _cache.getGenerations(), kNow);
+    ASSERT_FALSE(_cache.lookup({"d", {uuid}}, kNow));
+}
+
+}  // namespace
+}  // namespace mongo
@@ -66,6 +66,18 @@ DocumentSource::DocumentSource(const StringData stageName,
     }
 }
 
+DocumentSource::GetNextResult::ReturnStatus DocumentSource::doGetNextBatch(
+    std::vector<Document>* batch, size_t maxBatchSize) {
+    for (size_t numAdvanced = 0; numAdvanced < maxBatchSize; ++numAdvanced) {
+        auto next = doGetNext();
+        if (!next.isAdvanced()) {
+            return next.getStatus();
+        }
+        batch->push_back(next.releaseDocument());
+    }
+    return GetNextResult::ReturnStatus::kAdvanced;
+}
+
 namespace {
 struct ParserRegistration {
     Parser parser;
@@ -338,6 +338,44 @@ public:
         return next;
     }
 
+    /**
+     * The batched counterpart of getNext(). Appends up to 'maxBatchSize' results to 'batch', and
+     * returns the status which ended the batch:
+     *  - kAdvanced if the batch is full, or if the stage chose to return a partial batch. A stage
+     *    never returns kAdvanced without appending at least one result.
+     *  - kEOF or kPauseExecution if the stage reached that status after appending the results
+     *    which are in the batch. The caller must process these results before it handles the
+     *    status.
+     *
+     * Calls to getNext() and getNextBatch() can be interleaved. The same rule applies as for
+     * getNext(): a streaming stage must not keep references to the documents of a batch once it
+     * has returned them or asks its child for the next batch.
+     */
+    GetNextResult::ReturnStatus getNextBatch(std::vector<Document>* batch, size_t maxBatchSize) {
+        invariant(maxBatchSize > 0);
+        pExpCtx->checkForInterrupt();
+
+        if (MONGO_likely(!pExpCtx->shouldCollectDocumentSourceExecStats())) {
+            return doGetNextBatch(batch, maxBatchSize);
+        }
+
+        auto serviceCtx = pExpCtx->opCtx->getServiceContext();
+        invariant(serviceCtx);
+        auto fcs = serviceCtx->getFastClockSource();
+        invariant(fcs);
+
+        invariant(_commonStats.executionTimeMillis);
+        ScopedTimer timer(fcs, _commonStats.executionTimeMillis.get_ptr());
+
+        const auto sizeBefore = batch->size();
+        auto status = doGetNextBatch(batch, maxBatchSize);
+        const auto numAdvanced = batch->size() - sizeBefore;
+        _commonStats.advanced += numAdvanced;
+        _commonStats.works +=
+            numAdvanced + (status == GetNextResult::ReturnStatus::kAdvanced ? 0 : 1);
+        return status;
+    }
+
     /**
      * Returns a struct containing information about any special constraints imposed on using this
      * stage. Input parameter Pipeline::SplitState is used by stages whose requirements change
@@ -666,6 +704,14 @@ protected:
      */
     virtual GetNextResult doGetNext() = 0;
 
+    /**
+     * The batched counterpart of doGetNext(). See comment at getNextBatch(). The default
+     * implementation calls doGetNext() until the batch is full or the stage stops advancing. Stages
+     * which can produce a batch of results more cheaply than one result at a time override it.
+     */
+    virtual GetNextResult::ReturnStatus doGetNextBatch(std::vector<Document>* batch,
+                                                       size_t maxBatchSize);
+
     /**
      * Attempt to perform an optimization with the following source in the pipeline. 'container'
      * refers to the entire pipeline, and 'itr' points to this stage within the pipeline.
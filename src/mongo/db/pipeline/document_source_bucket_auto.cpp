@@ -157,12 +157,26 @@ DocumentSource::GetNextResult DocumentSourceBucketAuto::populateSorter() {
         };
 
         _sorter.reset(Sorter<Value, Document>::make(opts, comparator));
+
+        DepsTracker deps;
+        for (auto&& accumulatedField : _accumulatedFields) {
+            accumulatedField.expr.argument->addDependencies(&deps);
+        }
+        _argumentsNeedMetadata = deps.getNeedsAnyMetadata();
+        _argumentFields.reset();
+        if (!deps.needWholeDocument) {
+            _argumentFields.emplace();
+            for (auto&& field : deps.fields) {
+                _argumentFields->insert(
+                    FieldPath::extractFirstFieldFromDottedPath(field).toString());
+            }
+        }
     }
 
     auto next = pSource->getNext();
     for (; next.isAdvanced(); next = pSource->getNext()) {
         auto nextDoc = next.releaseDocument();
-        _sorter->add(extractKey(nextDoc), nextDoc);
+        _sorter->add(extractKey(nextDoc), extractArgumentFields(nextDoc));
         ++_nDocuments;
     }
     return next;
@@ -199,8 +213,25 @@ Value DocumentSourceBucketAuto::extractKey(const Document& doc) {
     return key.missing() ? Value(BSONNULL) : std::move(key);
 }
 
-void DocumentSourceBucketAuto::addDocumentToBucket(const pair<Value, Document>& entry,
-                                                   Bucket& bucket) {
+Document DocumentSourceBucketAuto::extractArgumentFields(const Document& doc) {
+    if (!_argumentFields) {
+        return doc;
+    }
+
+    MutableDocument out;
+    for (auto&& field : *_argumentFields) {
+        auto value = doc[field];
+        if (!value.missing()) {
+            out.addField(field, std::move(value));
+        }
+    }
+    if (_argumentsNeedMetadata) {
+        out.copyMetaDataFrom(doc);
+    }
+    return out.freeze();
+}
+
+void DocumentSourceBucketAuto::addDocumentToBucket(const SortedValue& entry, Bucket& bucket) {
     invariant(pExpCtx->getValueComparator().evaluate(entry.first >= bucket._max));
     bucket._max = entry.first;
 
@@ -219,6 +250,10 @@ void DocumentSourceBucketAuto::initializeBucketIteration() {
     invariant(_sorter);
     _sortedInput.reset(_sorter->done());
 
+    _stats.keysSorted = _sorter->numSorted();
+    _stats.spills = _sorter->numSpills();
+    _stats.totalDataSizeBytes = _sorter->totalDataSizeSorted();
+
     auto& metricsCollector = ResourceConsumption::MetricsCollector::get(pExpCtx->opCtx);
     metricsCollector.incrementKeysSorted(_sorter->numSorted());
     metricsCollector.incrementSorterSpills(_sorter->numSpills());
@@ -241,10 +276,10 @@ void DocumentSourceBucketAuto::initializeBucketIteration() {
     }
 }
 
-boost::optional<pair<Value, Document>>
+boost::optional<DocumentSourceBucketAuto::SortedValue>
 DocumentSourceBucketAuto::adjustBoundariesAndGetMinForNextBucket(Bucket* currentBucket) {
     auto getNextValIfPresent = [this]() {
-        return _sortedInput->more() ? boost::optional<pair<Value, Document>>(_sortedInput->next())
+        return _sortedInput->more() ? boost::optional<SortedValue>(_sortedInput->next())
                                     : boost::none;
     };
 
@@ -298,7 +333,7 @@ boost::optional<DocumentSourceBucketAuto::Bucket> DocumentSourceBucketAuto::popu
         return {};
     }
 
-    std::pair<Value, Document> currentValue =
+    SortedValue currentValue =
         _currentBucketDetails.currentMin ? *_currentBucketDetails.currentMin : _sortedInput->next();
 
     Bucket currentBucket(pExpCtx, currentValue.first, currentValue.first, _accumulatedFields);
@@ -393,7 +428,17 @@ Value DocumentSourceBucketAuto::serialize(
     }
     insides["output"] = outputSpec.freezeToValue();
 
-    return Value{Document{{getSourceName(), insides.freezeToValue()}}};
+    MutableDocument out;
+    out[getSourceName()] = insides.freezeToValue();
+
+    if (explain && *explain >= ExplainOptions::Verbosity::kExecStats) {
+        out["totalDataSizeSortedBytesEstimate"] =
+            Value(static_cast<long long>(_stats.totalDataSizeBytes));
+        out["usedDisk"] = Value(_stats.spills > 0);
+        out["spills"] = Value(static_cast<long long>(_stats.spills));
+    }
+
+    return out.freezeToValue();
 }
 
 intrusive_ptr<DocumentSourceBucketAuto> DocumentSourceBucketAuto::create(
@@ -436,7 +481,8 @@ DocumentSourceBucketAuto::DocumentSourceBucketAuto(
       _groupByExpression(groupByExpression),
       _granularityRounder(granularityRounder),
       _nBuckets(numBuckets),
-      _currentBucketDetails{0} {
+      _currentBucketDetails{0},
+      _stats(0 /* limit */, maxMemoryUsageBytes) {
     invariant(!accumulationStatements.empty());
     for (auto&& accumulationStatement : accumulationStatements) {
         _accumulatedFields.push_back(accumulationStatement);
@@ -29,6 +29,7 @@
 
 #pragma once
 
+#include "mongo/db/exec/plan_stats.h"
 #include "mongo/db/pipeline/accumulation_statement.h"
 #include "mongo/db/pipeline/accumulator.h"
 #include "mongo/db/pipeline/document_source.h"
@@ -41,6 +42,10 @@ namespace mongo {
 /**
  * The $bucketAuto stage takes a user-specified number of buckets and automatically determines
  * boundaries such that the values are approximately equally distributed between those buckets.
+ *
+ * The input is sorted by its 'groupBy' value, then the buckets are accumulated one at a time while
+ * streaming through the sorted values. Only the 'groupBy' value of each document and the fields its
+ * accumulator arguments read are sorted, so that the sort spills as little data as possible.
  */
 class DocumentSourceBucketAuto final : public DocumentSource {
 public:
@@ -95,6 +100,14 @@ public:
     const boost::intrusive_ptr<Expression> getGroupByExpression() const;
     const std::vector<AccumulationStatement>& getAccumulatedFields() const;
 
+    bool usedDisk() final {
+        return _stats.spills > 0;
+    }
+
+    const SpecificStats* getSpecificStats() const final {
+        return &_stats;
+    }
+
 protected:
     GetNextResult doGetNext() final;
     void doDispose() final;
@@ -118,11 +131,15 @@ private:
         std::vector<boost::intrusive_ptr<AccumulatorState>> _accums;
     };
 
+    // The 'groupBy' value of a document, paired with the fields of the document its accumulator
+    // arguments read.
+    using SortedValue = std::pair<Value, Document>;
+
     struct BucketDetails {
         int currentBucketNum;
         long long approxBucketSize = 0;
         boost::optional<Value> previousMax;
-        boost::optional<std::pair<Value, Document>> currentMin;
+        boost::optional<SortedValue> currentMin;
     };
 
     /**
@@ -140,17 +157,23 @@ private:
      */
     Value extractKey(const Document& doc);
 
+    /**
+     * Returns the top-level fields of 'doc' which the accumulator arguments read, or 'doc' itself
+     * if they need the whole document. The arguments are only evaluated once the document is added
+     * to a bucket whose accumulators still need input.
+     */
+    Document extractArgumentFields(const Document& doc);
+
     /**
      * Returns the next bucket if exists. boost::none if none exist.
      */
     boost::optional<Bucket> populateNextBucket();
 
-    boost::optional<std::pair<Value, Document>> adjustBoundariesAndGetMinForNextBucket(
-        Bucket* currentBucket);
+    boost::optional<SortedValue> adjustBoundariesAndGetMinForNextBucket(Bucket* currentBucket);
     /**
      * Adds the document in 'entry' to 'bucket' by updating the accumulators in 'bucket'.
      */
-    void addDocumentToBucket(const std::pair<Value, Document>& entry, Bucket& bucket);
+    void addDocumentToBucket(const SortedValue& entry, Bucket& bucket);
 
     /**
      * Makes a document using the information from bucket. This is what is returned when getNext()
@@ -163,6 +186,11 @@ private:
 
     std::vector<AccumulationStatement> _accumulatedFields;
 
+    // The top-level fields read by the accumulator arguments, which are sorted with the 'groupBy'
+    // values, or none if the arguments need the whole document. Populated when the sort starts.
+    boost::optional<std::set<std::string>> _argumentFields;
+    bool _argumentsNeedMetadata = false;
+
     uint64_t _maxMemoryUsageBytes;
     bool _populated = false;
     boost::intrusive_ptr<Expression> _groupByExpression;
@@ -170,6 +198,8 @@ private:
     int _nBuckets;
     long long _nDocuments = 0;
     BucketDetails _currentBucketDetails;
+
+    SortStats _stats;
 };
 
 }  // namespace mongo
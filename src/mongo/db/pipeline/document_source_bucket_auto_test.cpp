@@ -41,6 +41,7 @@
 #include "mongo/db/exec/document_value/document.h"
 #include "mongo/db/exec/document_value/document_value_test_util.h"
 #include "mongo/db/exec/document_value/value.h"
+#include "mongo/db/pipeline/accumulation_statement.h"
 #include "mongo/db/pipeline/aggregation_context_fixture.h"
 #include "mongo/db/pipeline/dependencies.h"
 #include "mongo/db/pipeline/document_source_bucket_auto.h"
@@ -56,6 +57,23 @@ using std::deque;
 using std::string;
 using std::vector;
 
+/**
+ * Returns the statements {count: {$sum: 1}, largeStr: {$max: "$largeStr"}}. They make $bucketAuto
+ * buffer the 'largeStr' field of its input, which it does not need for the default count.
+ */
+vector<AccumulationStatement> makeLargeStrAccumulationStatements(
+    const boost::intrusive_ptr<ExpressionContext>& expCtx) {
+    auto output = BSON("count" << BSON("$sum" << 1) << "largeStr"
+                               << BSON("$max"
+                                       << "$largeStr"));
+    vector<AccumulationStatement> statements;
+    for (auto&& elem : output) {
+        statements.push_back(AccumulationStatement::parseAccumulationStatement(
+            expCtx.get(), elem, expCtx->variablesParseState));
+    }
+    return statements;
+}
+
 class BucketAutoTests : public AggregationContextFixture {
 public:
     intrusive_ptr<DocumentSource> createBucketAuto(BSONObj bucketAutoSpec) {
@@ -307,6 +325,19 @@ TEST_F(BucketAutoTests, EvaluatesAccumulatorsInOutputField) {
     ASSERT_DOCUMENT_EQ(results[1], Document(fromjson("{_id : {min : 4, max : 6}, avg : 5}")));
 }
 
+TEST_F(BucketAutoTests, EvaluatesAccumulatorArgumentsOnlyWhileTheyAreNeeded) {
+    // $first needs no input after the first document of a bucket, so the division by zero in the
+    // argument of the second document is never evaluated.
+    auto bucketAutoSpec = fromjson(
+        "{$bucketAuto : {groupBy : '$x', buckets : 1, output : {first : {$first : {$divide : [1, "
+        "'$y']}}}}}");
+    auto results =
+        getResults(bucketAutoSpec, {Document{{"x", 1}, {"y", 0}}, Document{{"x", 0}, {"y", 2}}});
+
+    ASSERT_EQUALS(results.size(), 1UL);
+    ASSERT_DOCUMENT_EQ(results[0], Document(fromjson("{_id : {min : 0, max : 1}, first : 0.5}")));
+}
+
 TEST_F(BucketAutoTests, EvaluatesNonFieldPathExpressionInGroupByField) {
     auto bucketAutoSpec = fromjson("{$bucketAuto : {groupBy : {$add : ['$x', 1]}, buckets : 2}}");
     auto results = getResults(
@@ -378,8 +409,13 @@ TEST_F(BucketAutoTests, ShouldBeAbleToCorrectlySpillToDisk) {
     auto groupByExpression = ExpressionFieldPath::parse(expCtx.get(), "$a", vps);
 
     const int numBuckets = 2;
-    auto bucketAutoStage = DocumentSourceBucketAuto::create(
-        expCtx, groupByExpression, numBuckets, {}, nullptr, maxMemoryUsageBytes);
+    auto bucketAutoStage =
+        DocumentSourceBucketAuto::create(expCtx,
+                                         groupByExpression,
+                                         numBuckets,
+                                         makeLargeStrAccumulationStatements(expCtx),
+                                         nullptr,
+                                         maxMemoryUsageBytes);
 
     string largeStr(maxMemoryUsageBytes, 'x');
     auto mock = DocumentSourceMock::createForTest({Document{{"a", 0}, {"largeStr", largeStr}},
@@ -389,6 +425,52 @@ TEST_F(BucketAutoTests, ShouldBeAbleToCorrectlySpillToDisk) {
                                                   expCtx);
     bucketAutoStage->setSource(mock.get());
 
+    auto next = bucketAutoStage->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(
+        next.releaseDocument(),
+        (Document{
+            {"_id", Document{{"min", 0}, {"max", 2}}}, {"count", 2}, {"largeStr", largeStr}}));
+
+    next = bucketAutoStage->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(
+        next.releaseDocument(),
+        (Document{
+            {"_id", Document{{"min", 2}, {"max", 3}}}, {"count", 2}, {"largeStr", largeStr}}));
+
+    ASSERT_TRUE(bucketAutoStage->getNext().isEOF());
+    ASSERT_TRUE(bucketAutoStage->usedDisk());
+
+    vector<Value> explain;
+    bucketAutoStage->serializeToArray(explain, ExplainOptions::Verbosity::kExecStats);
+    ASSERT_EQ(explain.size(), 1UL);
+    ASSERT_VALUE_EQ(explain[0]["usedDisk"], Value(true));
+    ASSERT_GT(explain[0]["spills"].getLong(), 0);
+}
+
+TEST_F(BucketAutoTests, ShouldNotBufferFieldsWhichAreNotAccumulated) {
+    auto expCtx = getExpCtx();
+    expCtx->allowDiskUse = false;
+    const size_t maxMemoryUsageBytes = 1000;
+
+    VariablesParseState vps = expCtx->variablesParseState;
+    auto groupByExpression = ExpressionFieldPath::parse(expCtx.get(), "$a", vps);
+
+    // Only the 'groupBy' values are sorted, as the default count accumulator has a constant
+    // argument. The documents would not fit in memory together.
+    const int numBuckets = 2;
+    auto bucketAutoStage = DocumentSourceBucketAuto::create(
+        expCtx, groupByExpression, numBuckets, {}, nullptr, maxMemoryUsageBytes);
+
+    string largeStr(maxMemoryUsageBytes, 'x');
+    auto mock = DocumentSourceMock::createForTest({Document{{"a", 3}, {"largeStr", largeStr}},
+                                                   Document{{"a", 1}, {"largeStr", largeStr}},
+                                                   Document{{"a", 2}, {"largeStr", largeStr}},
+                                                   Document{{"a", 0}, {"largeStr", largeStr}}},
+                                                  expCtx);
+    bucketAutoStage->setSource(mock.get());
+
     auto next = bucketAutoStage->getNext();
     ASSERT_TRUE(next.isAdvanced());
     ASSERT_DOCUMENT_EQ(next.releaseDocument(),
@@ -400,6 +482,7 @@ TEST_F(BucketAutoTests, ShouldBeAbleToCorrectlySpillToDisk) {
                        (Document{{"_id", Document{{"min", 2}, {"max", 3}}}, {"count", 2}}));
 
     ASSERT_TRUE(bucketAutoStage->getNext().isEOF());
+    ASSERT_FALSE(bucketAutoStage->usedDisk());
 }
 
 TEST_F(BucketAutoTests, ShouldBeAbleToPauseLoadingWhileSpilled) {
@@ -415,8 +498,13 @@ TEST_F(BucketAutoTests, ShouldBeAbleToPauseLoadingWhileSpilled) {
     auto groupByExpression = ExpressionFieldPath::parse(expCtx.get(), "$a", vps);
 
     const int numBuckets = 2;
-    auto bucketAutoStage = DocumentSourceBucketAuto::create(
-        expCtx, groupByExpression, numBuckets, {}, nullptr, maxMemoryUsageBytes);
+    auto bucketAutoStage =
+        DocumentSourceBucketAuto::create(expCtx,
+                                         groupByExpression,
+                                         numBuckets,
+                                         makeLargeStrAccumulationStatements(expCtx),
+                                         nullptr,
+                                         maxMemoryUsageBytes);
     auto sort =
         DocumentSourceSort::create(expCtx, {BSON("_id" << -1), expCtx}, 0, maxMemoryUsageBytes);
 
@@ -439,15 +527,20 @@ TEST_F(BucketAutoTests, ShouldBeAbleToPauseLoadingWhileSpilled) {
     // Now we expect to get the results back.
     auto next = bucketAutoStage->getNext();
     ASSERT_TRUE(next.isAdvanced());
-    ASSERT_DOCUMENT_EQ(next.releaseDocument(),
-                       (Document{{"_id", Document{{"min", 0}, {"max", 2}}}, {"count", 2}}));
+    ASSERT_DOCUMENT_EQ(
+        next.releaseDocument(),
+        (Document{
+            {"_id", Document{{"min", 0}, {"max", 2}}}, {"count", 2}, {"largeStr", largeStr}}));
 
     next = bucketAutoStage->getNext();
     ASSERT_TRUE(next.isAdvanced());
-    ASSERT_DOCUMENT_EQ(next.releaseDocument(),
-                       (Document{{"_id", Document{{"min", 2}, {"max", 3}}}, {"count", 2}}));
+    ASSERT_DOCUMENT_EQ(
+        next.releaseDocument(),
+        (Document{
+            {"_id", Document{{"min", 2}, {"max", 3}}}, {"count", 2}, {"largeStr", largeStr}}));
 
     ASSERT_TRUE(bucketAutoStage->getNext().isEOF());
+    ASSERT_TRUE(bucketAutoStage->usedDisk());
 }
 
 TEST_F(BucketAutoTests, SourceNameIsBucketAuto) {
@@ -658,8 +751,13 @@ void assertCannotSpillToDisk(const boost::intrusive_ptr<ExpressionContext>& expC
     auto groupByExpression = ExpressionFieldPath::parse(expCtx.get(), "$a", vps);
 
     const int numBuckets = 2;
-    auto bucketAutoStage = DocumentSourceBucketAuto::create(
-        expCtx, groupByExpression, numBuckets, {}, nullptr, maxMemoryUsageBytes);
+    auto bucketAutoStage =
+        DocumentSourceBucketAuto::create(expCtx,
+                                         groupByExpression,
+                                         numBuckets,
+                                         makeLargeStrAccumulationStatements(expCtx),
+                                         nullptr,
+                                         maxMemoryUsageBytes);
 
     string largeStr(maxMemoryUsageBytes, 'x');
     auto mock = DocumentSourceMock::createForTest(
@@ -697,8 +795,13 @@ TEST_F(BucketAutoTests, ShouldCorrectlyTrackMemoryUsageBetweenPauses) {
     auto groupByExpression = ExpressionFieldPath::parse(expCtx.get(), "$a", vps);
 
     const int numBuckets = 2;
-    auto bucketAutoStage = DocumentSourceBucketAuto::create(
-        expCtx, groupByExpression, numBuckets, {}, nullptr, maxMemoryUsageBytes);
+    auto bucketAutoStage =
+        DocumentSourceBucketAuto::create(expCtx,
+                                         groupByExpression,
+                                         numBuckets,
+                                         makeLargeStrAccumulationStatements(expCtx),
+                                         nullptr,
+                                         maxMemoryUsageBytes);
 
     string largeStr(maxMemoryUsageBytes / 2, 'x');
     auto mock =
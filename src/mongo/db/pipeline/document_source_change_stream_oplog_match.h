@@ -78,6 +78,12 @@ public:
         MONGO_UNREACHABLE;
     }
 
+    GetNextResult::ReturnStatus doGetNextBatch(std::vector<Document>* batch,
+                                               size_t maxBatchSize) final {
+        // See doGetNext().
+        MONGO_UNREACHABLE;
+    }
+
     StageConstraints constraints(Pipeline::SplitState pipeState) const final;
 
     Value serialize(boost::optional<ExplainOptions::Verbosity> explain) const final;
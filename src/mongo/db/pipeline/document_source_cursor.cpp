@@ -33,6 +33,8 @@
 
 #include "mongo/db/pipeline/document_source_cursor.h"
 
+#include <iterator>
+
 #include "mongo/db/catalog/collection.h"
 #include "mongo/db/exec/document_value/document.h"
 #include "mongo/db/exec/working_set_common.h"
@@ -101,6 +103,29 @@ Document DocumentSourceCursor::Batch::dequeue() {
     MONGO_UNREACHABLE;
 }
 
+void DocumentSourceCursor::Batch::dequeue(std::vector<Document>* out, size_t maxCount) {
+    invariant(!isEmpty());
+    switch (_type) {
+        case CursorType::kRegular: {
+            const auto count = std::min(maxCount, _batchOfDocs.size());
+            auto end = _batchOfDocs.begin() + count;
+            std::move(_batchOfDocs.begin(), end, std::back_inserter(*out));
+            _batchOfDocs.erase(_batchOfDocs.begin(), end);
+            if (_batchOfDocs.empty()) {
+                _memUsageBytes = 0;
+            }
+            return;
+        }
+        case CursorType::kEmptyDocuments: {
+            const auto count = std::min(maxCount, _count);
+            out->resize(out->size() + count);
+            _count -= count;
+            return;
+        }
+    }
+    MONGO_UNREACHABLE;
+}
+
 void DocumentSourceCursor::Batch::clear() {
     _batchOfDocs.clear();
     _count = 0;
@@ -122,6 +147,25 @@ DocumentSource::GetNextResult DocumentSourceCursor::doGetNext() {
     return _currentBatch.dequeue();
 }
 
+DocumentSource::GetNextResult::ReturnStatus DocumentSourceCursor::doGetNextBatch(
+    std::vector<Document>* batch, size_t maxBatchSize) {
+    // The cached oplog timestamp must be updated as each document is returned.
+    if (_trackOplogTS) {
+        return DocumentSource::doGetNextBatch(batch, maxBatchSize);
+    }
+
+    if (_currentBatch.isEmpty()) {
+        loadBatch();
+    }
+
+    if (_currentBatch.isEmpty()) {
+        return GetNextResult::ReturnStatus::kEOF;
+    }
+
+    _currentBatch.dequeue(batch, maxBatchSize);
+    return GetNextResult::ReturnStatus::kAdvanced;
+}
+
 void DocumentSourceCursor::loadBatch() {
     if (!_exec || _exec->isDisposed()) {
         // No more documents.
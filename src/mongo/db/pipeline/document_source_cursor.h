@@ -140,6 +140,13 @@ protected:
 
     GetNextResult doGetNext() final;
 
+    /**
+     * Hands over the documents already loaded from '_exec' without going through doGetNext() for
+     * each of them.
+     */
+    GetNextResult::ReturnStatus doGetNextBatch(std::vector<Document>* batch,
+                                               size_t maxBatchSize) final;
+
     ~DocumentSourceCursor();
 
     /**
@@ -178,6 +185,12 @@ private:
          */
         Document dequeue();
 
+        /**
+         * Removes up to 'maxCount' documents from the front of the batch, and appends them to
+         * 'out'.
+         */
+        void dequeue(std::vector<Document>* out, size_t maxCount);
+
         void clear();
 
         bool isEmpty() const;
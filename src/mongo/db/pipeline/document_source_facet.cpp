@@ -31,6 +31,7 @@
 
 #include "mongo/db/pipeline/document_source_facet.h"
 
+#include <algorithm>
 #include <memory>
 #include <vector>
 
@@ -38,14 +39,21 @@
 #include "mongo/bson/bsonobj.h"
 #include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/bson/bsontypes.h"
+#include "mongo/db/client.h"
 #include "mongo/db/exec/document_value/document.h"
 #include "mongo/db/exec/document_value/value.h"
+#include "mongo/db/pipeline/document_source_set_window_fields.h"
 #include "mongo/db/pipeline/document_source_tee_consumer.h"
 #include "mongo/db/pipeline/expression_context.h"
 #include "mongo/db/pipeline/field_path.h"
 #include "mongo/db/pipeline/pipeline.h"
 #include "mongo/db/pipeline/tee_buffer.h"
+#include "mongo/db/query/query_knobs_gen.h"
+#include "mongo/platform/mutex.h"
 #include "mongo/util/assert_util.h"
+#include "mongo/util/concurrency/thread_pool.h"
+#include "mongo/util/future.h"
+#include "mongo/util/scopeguard.h"
 #include "mongo/util/str.h"
 
 namespace mongo {
@@ -65,12 +73,53 @@ DocumentSourceFacet::DocumentSourceFacet(std::vector<FacetPipeline> facetPipelin
       _maxOutputDocSizeBytes(maxOutputDocBytes) {
     for (size_t facetId = 0; facetId < _facets.size(); ++facetId) {
         auto& facet = _facets[facetId];
-        facet.pipeline->addInitialSource(
-            DocumentSourceTeeConsumer::create(pExpCtx, facetId, _teeBuffer, kTeeConsumerStageName));
+        facet.pipeline->addInitialSource(DocumentSourceTeeConsumer::create(
+            facet.pipeline->getContext(), facetId, _teeBuffer, kTeeConsumerStageName));
     }
 }
 
 namespace {
+// The threads on which the sub-pipelines of $facet stages run concurrently. The threads are
+// reserved with 'reserveFacetWorkers()' before the sub-pipelines are scheduled, as a sub-pipeline
+// which is waiting for a thread would block all the other sub-pipelines of its stage. The pool is
+// sized for the largest value of 'internalQueryFacetMaxParallelWorkers', so that a reserved
+// sub-pipeline never waits for a thread.
+std::unique_ptr<ThreadPool> facetWorkerThreadPool;
+MONGO_INITIALIZER(FacetWorkerThreadPool)(InitializerContext* context) {
+    ThreadPool::Options options;
+    options.poolName = "facet worker pool";
+    options.threadNamePrefix = "FacetWorker";
+    options.minThreads = 0;
+    options.maxThreads = 64;
+    options.onCreateThread = [](const std::string& name) { Client::initThread(name); };
+    facetWorkerThreadPool = std::make_unique<ThreadPool>(options);
+    facetWorkerThreadPool->startup();
+}
+}  // namespace
+
+void shutdownFacetWorkerThreadPool() {
+    facetWorkerThreadPool->shutdown();
+    facetWorkerThreadPool->join();
+}
+
+namespace {
+AtomicWord<int> numFacetWorkersInUse{0};
+
+/**
+ * Reserves 'numWorkers' threads of 'facetWorkerThreadPool'. Returns false if this would exceed
+ * 'internalQueryFacetMaxParallelWorkers'.
+ */
+bool reserveFacetWorkers(int numWorkers) {
+    const auto maxWorkers = internalQueryFacetMaxParallelWorkers.load();
+    auto inUse = numFacetWorkersInUse.load();
+    do {
+        if (inUse + numWorkers > maxWorkers) {
+            return false;
+        }
+    } while (!numFacetWorkersInUse.compareAndSwap(&inUse, inUse + numWorkers));
+    return true;
+}
+
 /**
  * Extracts the names of the facets and the vectors of raw BSONObjs representing the stages within
  * that facet's pipeline.
@@ -151,28 +200,37 @@ DocumentSource::GetNextResult DocumentSourceFacet::doGetNext() {
         return GetNextResult::makeEOF();
     }
 
+    // The results of all facets count towards the same limit, whether they are produced by this
+    // thread or by the worker threads.
     const size_t maxBytes = _maxOutputDocSizeBytes;
-    auto ensureUnderMemoryLimit = [usedBytes = 0ul, &maxBytes](long long additional) mutable {
-        usedBytes += additional;
+    AtomicWord<long long> usedBytes{0};
+    auto ensureUnderMemoryLimit = [&usedBytes, &maxBytes](long long additional) {
+        const auto totalBytes = usedBytes.addAndFetch(additional);
         uassert(4031700,
-                str::stream() << "document constructed by $facet is " << usedBytes
+                str::stream() << "document constructed by $facet is " << totalBytes
                               << " bytes, which exceeds the limit of " << maxBytes << " bytes",
-                usedBytes <= maxBytes);
+                static_cast<size_t>(totalBytes) <= maxBytes);
     };
 
     vector<vector<Value>> results(_facets.size());
-    bool allPipelinesEOF = false;
-    while (!allPipelinesEOF) {
-        allPipelinesEOF = true;  // Set this to false if any pipeline isn't EOF.
-        for (size_t facetId = 0; facetId < _facets.size(); ++facetId) {
-            const auto& pipeline = _facets[facetId].pipeline;
-            auto next = pipeline->getSources().back()->getNext();
-            for (; next.isAdvanced(); next = pipeline->getSources().back()->getNext()) {
-                ensureUnderMemoryLimit(next.getDocument().getApproximateSize());
-                results[facetId].emplace_back(next.releaseDocument());
+    const int numWorkers = _facets.size();
+    if (canRunFacetsConcurrently() && reserveFacetWorkers(numWorkers)) {
+        ON_BLOCK_EXIT([&] { numFacetWorkersInUse.subtractAndFetch(numWorkers); });
+        runFacetsConcurrently(&results, ensureUnderMemoryLimit);
+    } else {
+        bool allPipelinesEOF = false;
+        while (!allPipelinesEOF) {
+            allPipelinesEOF = true;  // Set this to false if any pipeline isn't EOF.
+            for (size_t facetId = 0; facetId < _facets.size(); ++facetId) {
+                const auto& pipeline = _facets[facetId].pipeline;
+                auto next = pipeline->getSources().back()->getNext();
+                for (; next.isAdvanced(); next = pipeline->getSources().back()->getNext()) {
+                    ensureUnderMemoryLimit(next.getDocument().getApproximateSize());
+                    results[facetId].emplace_back(next.releaseDocument());
+                }
+                allPipelinesEOF = allPipelinesEOF && next.isEOF();
+                accumulatePipelinePlanSummaryStats(*pipeline, _stats.planSummaryStats);
             }
-            allPipelinesEOF = allPipelinesEOF && next.isEOF();
-            accumulatePipelinePlanSummaryStats(*pipeline, _stats.planSummaryStats);
         }
     }
 
@@ -185,6 +243,154 @@ DocumentSource::GetNextResult DocumentSourceFacet::doGetNext() {
     return resultDoc.freeze();
 }
 
+bool DocumentSourceFacet::canRunFacetsConcurrently() const {
+    if (_facets.size() < 2 || !pExpCtx->opCtx) {
+        return false;
+    }
+
+    // Stages which read other collections need the locks and the storage snapshot of this
+    // operation, so they can only run on its thread.
+    stdx::unordered_set<NamespaceString> involvedCollections;
+    addInvolvedCollections(&involvedCollections);
+    if (!involvedCollections.empty()) {
+        return false;
+    }
+
+    stdx::unordered_set<ExpressionContext*> contexts{pExpCtx.get()};
+    for (auto&& facet : _facets) {
+        // Expressions keep their state in the ExpressionContext, so sub-pipelines which share an
+        // ExpressionContext cannot run at the same time.
+        if (!contexts.insert(facet.pipeline->getContext().get()).second) {
+            return false;
+        }
+
+        // $$SEARCH_META is only set in the ExpressionContext of this stage as the pipeline runs.
+        if (facet.pipeline->getDependencies(boost::none).vars.count(Variables::kSearchMetaId)) {
+            return false;
+        }
+        for (auto&& stage : facet.pipeline->getSources()) {
+            // $setWindowFields spills to a temporary record store, which needs the storage engine.
+            if (stage->getSourceName() == DocumentSourceInternalSetWindowFields::kStageName) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+void DocumentSourceFacet::runFacetsConcurrently(
+    vector<vector<Value>>* results, const std::function<void(long long)>& ensureUnderMemoryLimit) {
+    auto opCtx = pExpCtx->opCtx;
+    _teeBuffer->enableConcurrentConsumers();
+
+    // Each worker thread attaches its sub-pipeline to its own operation context.
+    for (auto&& facet : _facets) {
+        facet.pipeline->detachFromOperationContext();
+    }
+
+    // The operation contexts of the workers, so that a failure of the stage, or an interrupt of
+    // this operation such as a killOp, is forwarded to them. The deadline is instead copied to each
+    // of them. Only the first failure is reported, as the others may result from stopping.
+    auto workerOpCtxsMutex = MONGO_MAKE_LATCH("DocumentSourceFacet::workerOpCtxsMutex");
+    std::vector<OperationContext*> workerOpCtxs;
+    Status firstError = Status::OK();
+    auto killWorker = [&](WithLock, OperationContext* workerOpCtx) {
+        stdx::lock_guard<Client> clientLock(*workerOpCtx->getClient());
+        workerOpCtx->getServiceContext()->killOperation(clientLock, workerOpCtx);
+    };
+
+    AtomicWord<bool> stopped{false};
+    auto stop = [&](Status status) {
+        {
+            stdx::lock_guard<Latch> lk(workerOpCtxsMutex);
+            if (!firstError.isOK()) {
+                return;
+            }
+            firstError = status;
+            for (auto workerOpCtx : workerOpCtxs) {
+                killWorker(lk, workerOpCtx);
+            }
+        }
+        stopped.store(true);
+        _teeBuffer->abort(std::move(status));
+    };
+
+    const auto deadline = opCtx->getDeadline();
+    const auto timeoutError = opCtx->getTimeoutError();
+    vector<Future<void>> workers;
+    for (size_t facetId = 0; facetId < _facets.size(); ++facetId) {
+        auto pf = makePromiseFuture<void>();
+        facetWorkerThreadPool->schedule(
+            [&, facetId, promise = std::move(pf.promise)](auto status) mutable {
+                // The pool is shut down, so the stage fails with the error of the pool.
+                if (!status.isOK()) {
+                    stop(status);
+                    promise.setError(std::move(status));
+                    return;
+                }
+
+                promise.setWith([&] {
+                    auto workerOpCtx = cc().makeOperationContext();
+                    if (deadline != Date_t::max()) {
+                        workerOpCtx->setDeadlineByDate(deadline, timeoutError);
+                    }
+
+                    {
+                        stdx::lock_guard<Latch> lk(workerOpCtxsMutex);
+                        workerOpCtxs.push_back(workerOpCtx.get());
+                        if (!firstError.isOK()) {
+                            killWorker(lk, workerOpCtx.get());
+                        }
+                    }
+                    ON_BLOCK_EXIT([&] {
+                        stdx::lock_guard<Latch> lk(workerOpCtxsMutex);
+                        workerOpCtxs.erase(std::find(
+                            workerOpCtxs.begin(), workerOpCtxs.end(), workerOpCtx.get()));
+                    });
+
+                    const auto& pipeline = _facets[facetId].pipeline;
+                    pipeline->reattachToOperationContext(workerOpCtx.get());
+                    ON_BLOCK_EXIT([&] { pipeline->detachFromOperationContext(); });
+                    try {
+                        auto next = pipeline->getNext();
+                        for (; next && !stopped.load(); next = pipeline->getNext()) {
+                            ensureUnderMemoryLimit(next->getApproximateSize());
+                            (*results)[facetId].emplace_back(std::move(*next));
+                        }
+                    } catch (const DBException& ex) {
+                        stop(ex.toStatus());
+                        throw;
+                    }
+
+                    // This facet needs no more input, even if it stopped before the end of it.
+                    _teeBuffer->dispose(facetId);
+                });
+            });
+        workers.push_back(std::move(pf.future));
+    }
+
+    try {
+        _teeBuffer->feedConsumers(opCtx, internalDocumentSourceGetNextBatchSize.load());
+    } catch (const DBException& ex) {
+        stop(ex.toStatus());
+    }
+
+    // Stop the workers early if one of them fails or if this operation is interrupted, but wait for
+    // all of them before reporting any failure, as they use the state of this stage.
+    for (auto&& worker : workers) {
+        if (auto status = worker.getNoThrow(opCtx); !status.isOK()) {
+            stop(std::move(status));
+            worker.getNoThrow().ignore();
+        }
+    }
+
+    for (auto&& facet : _facets) {
+        facet.pipeline->reattachToOperationContext(opCtx);
+        accumulatePipelinePlanSummaryStats(*facet.pipeline, _stats.planSummaryStats);
+    }
+    uassertStatusOK(firstError);
+}
+
 Value DocumentSourceFacet::serialize(boost::optional<ExplainOptions::Verbosity> explain) const {
     MutableDocument serialized;
     for (auto&& facet : _facets) {
@@ -308,11 +514,18 @@ intrusive_ptr<DocumentSource> DocumentSourceFacet::createFromBson(
     boost::optional<std::string> needsMongoS;
     boost::optional<std::string> needsShard;
 
+    // The sub-pipelines can only run concurrently if each has its own ExpressionContext. Nested
+    // pipelines are excluded, as the variables of their enclosing stage change as they run.
+    const bool ownExpressionContexts = internalQueryFacetMaxParallelWorkers.load() > 0 &&
+        expCtx->subPipelineDepth == 0 && !expCtx->isParsingViewDefinition;
+
     std::vector<FacetPipeline> facetPipelines;
     for (auto&& rawFacet : extractRawPipelines(elem)) {
         const auto facetName = rawFacet.first;
 
-        auto pipeline = Pipeline::parse(rawFacet.second, expCtx, [](const Pipeline& pipeline) {
+        auto facetExpCtx =
+            ownExpressionContexts ? expCtx->copyWith(expCtx->ns, expCtx->uuid) : expCtx;
+        auto pipeline = Pipeline::parse(rawFacet.second, facetExpCtx, [](const Pipeline& pipeline) {
             auto sources = pipeline.getSources();
             std::for_each(sources.begin(), sources.end(), [](auto& stage) {
                 auto stageConstraints = stage->constraints();
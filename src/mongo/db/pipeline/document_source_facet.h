@@ -31,6 +31,7 @@
 
 #include <boost/intrusive_ptr.hpp>
 #include <boost/optional.hpp>
+#include <functional>
 #include <memory>
 #include <vector>
 
@@ -161,6 +162,20 @@ private:
 
     Value serialize(boost::optional<ExplainOptions::Verbosity> explain = boost::none) const final;
 
+    /**
+     * Returns true if the sub-pipelines can run on worker threads. This requires each of them to
+     * have its own ExpressionContext, and to not access any storage.
+     */
+    bool canRunFacetsConcurrently() const;
+
+    /**
+     * Runs each sub-pipeline on its own worker thread, while this thread pulls the input from the
+     * source and publishes it to '_teeBuffer'. Appends the results of each facet to 'results',
+     * calling 'ensureUnderMemoryLimit' with the size of each result from the worker threads.
+     */
+    void runFacetsConcurrently(std::vector<std::vector<Value>>* results,
+                               const std::function<void(long long)>& ensureUnderMemoryLimit);
+
     boost::intrusive_ptr<TeeBuffer> _teeBuffer;
     std::vector<FacetPipeline> _facets;
 
@@ -170,4 +185,10 @@ private:
 
     DocumentSourceFacetStats _stats;
 };
+
+/**
+ * Shuts down and joins the threads on which the sub-pipelines of $facet stages run concurrently.
+ * Any $facet stage which runs concurrently afterwards fails with the error of the pool.
+ */
+void shutdownFacetWorkerThreadPool();
 }  // namespace mongo
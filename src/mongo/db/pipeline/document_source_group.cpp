@@ -36,12 +36,19 @@
 #include "mongo/db/exec/document_value/value_comparator.h"
 #include "mongo/db/pipeline/accumulation_statement.h"
 #include "mongo/db/pipeline/accumulator.h"
+#include "mongo/db/pipeline/accumulator_js_reduce.h"
+#include "mongo/db/pipeline/dependencies.h"
 #include "mongo/db/pipeline/document_source_group.h"
 #include "mongo/db/pipeline/expression.h"
 #include "mongo/db/pipeline/expression_context.h"
+#include "mongo/db/pipeline/expression_visitor.h"
+#include "mongo/db/pipeline/expression_walker.h"
 #include "mongo/db/pipeline/lite_parsed_document_source.h"
+#include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/db/stats/resource_consumption_metrics.h"
+#include "mongo/util/concurrency/thread_pool.h"
 #include "mongo/util/destructor_guard.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 
@@ -61,6 +68,116 @@ std::string nextFileName() {
     return "extsort-doc-group." + std::to_string(documentSourceGroupFileCounter.fetchAndAdd(1));
 }
 
+// The threads on which $group stages build their groups in parallel. The threads are reserved
+// with 'reserveGroupWorkers()' before the workers are scheduled, as each worker runs until the
+// input of its stage is exhausted. The pool is sized for the largest value of
+// 'internalQueryGroupMaxParallelWorkers', so that a reserved worker never waits for a thread. The
+// workers only evaluate expressions, update groups and write spill files, so they have no Client.
+std::unique_ptr<ThreadPool> groupWorkerThreadPool;
+MONGO_INITIALIZER(GroupWorkerThreadPool)(InitializerContext* context) {
+    ThreadPool::Options options;
+    options.poolName = "group worker pool";
+    options.threadNamePrefix = "GroupWorker";
+    options.minThreads = 0;
+    options.maxThreads = 64;
+    groupWorkerThreadPool = std::make_unique<ThreadPool>(options);
+    groupWorkerThreadPool->startup();
+}
+}  // namespace
+
+void shutdownGroupWorkerThreadPool() {
+    groupWorkerThreadPool->shutdown();
+    groupWorkerThreadPool->join();
+}
+
+namespace {
+
+AtomicWord<int> numGroupWorkersInUse{0};
+
+/**
+ * Reserves 'numWorkers' threads of 'groupWorkerThreadPool'. Returns false if this would exceed
+ * 'internalQueryGroupMaxParallelWorkers'.
+ */
+bool reserveGroupWorkers(int numWorkers) {
+    const auto maxWorkers = internalQueryGroupMaxParallelWorkers.load();
+    auto inUse = numGroupWorkersInUse.load();
+    do {
+        if (inUse + numWorkers > maxWorkers) {
+            return false;
+        }
+    } while (!numGroupWorkersInUse.compareAndSwap(&inUse, inUse + numWorkers));
+    return true;
+}
+
+/**
+ * Runs 'work' on a thread of 'groupWorkerThreadPool'. If 'work' fails, or if the pool is shut down,
+ * 'onError' is called with the error before the returned future is set to it.
+ */
+Future<void> scheduleGroupWorker(unique_function<void()> work,
+                                 unique_function<void(const Status&)> onError = nullptr) {
+    auto pf = makePromiseFuture<void>();
+    groupWorkerThreadPool->schedule([work = std::move(work),
+                                     onError = std::move(onError),
+                                     promise = std::move(pf.promise)](Status status) mutable {
+        if (status.isOK()) {
+            try {
+                work();
+                promise.emplaceValue();
+                return;
+            } catch (const DBException& ex) {
+                status = ex.toStatus();
+            }
+        }
+        if (onError) {
+            onError(status);
+        }
+        promise.setError(std::move(status));
+    });
+    return std::move(pf.future);
+}
+
+/**
+ * Finds the expressions which run JavaScript in the scope of the operation.
+ */
+struct JsExpressionVisitor final : public SelectiveConstExpressionVisitorBase {
+    // To avoid overloaded-virtual warnings.
+    using SelectiveConstExpressionVisitorBase::visit;
+
+    void visit(const ExpressionFunction*) final {
+        found = true;
+    }
+    void visit(const ExpressionInternalJsEmit*) final {
+        found = true;
+    }
+
+    bool found = false;
+};
+
+struct JsExpressionWalker {
+    void preVisit(const Expression* expr) {
+        expr->acceptVisitor(&visitor);
+    }
+
+    JsExpressionVisitor visitor;
+};
+
+/**
+ * Returns true if 'expr' can be evaluated on a worker thread with its own copy of the variables.
+ * The JavaScript expressions use the scope of the operation, and $$SEARCH_META is only set in the
+ * variables of the ExpressionContext as the pipeline runs.
+ */
+bool canEvaluateOnWorkerThread(const Expression* expr) {
+    JsExpressionWalker walker;
+    expression_walker::walk<const Expression>(expr, &walker);
+    if (walker.visitor.found) {
+        return false;
+    }
+
+    DepsTracker deps;
+    expr->addDependencies(&deps);
+    return !deps.vars.count(Variables::kSearchMetaId);
+}
+
 }  // namespace
 
 using boost::intrusive_ptr;
@@ -132,37 +249,37 @@ const char* DocumentSourceGroup::getSourceName() const {
     return kStageName.rawData();
 }
 
-bool DocumentSourceGroup::shouldSpillWithAttemptToSaveMemory() {
-    if (!_memoryTracker._allowDiskUse &&
-        (_memoryTracker.currentMemoryBytes() >
-         static_cast<long long>(_memoryTracker._maxAllowedMemoryUsageBytes))) {
-        freeMemory();
+bool DocumentSourceGroup::shouldSpillWithAttemptToSaveMemory(
+    GroupsMap* groups, MemoryUsageTracker* memoryTracker) const {
+    if (!memoryTracker->_allowDiskUse &&
+        (memoryTracker->currentMemoryBytes() >
+         static_cast<long long>(memoryTracker->_maxAllowedMemoryUsageBytes))) {
+        freeMemory(groups, memoryTracker);
     }
 
-    if (_memoryTracker.currentMemoryBytes() >
-        static_cast<long long>(_memoryTracker._maxAllowedMemoryUsageBytes)) {
+    if (memoryTracker->currentMemoryBytes() >
+        static_cast<long long>(memoryTracker->_maxAllowedMemoryUsageBytes)) {
         uassert(ErrorCodes::QueryExceededMemoryLimitNoDiskUseAllowed,
                 "Exceeded memory limit for $group, but didn't allow external sort."
                 " Pass allowDiskUse:true to opt in.",
-                _memoryTracker._allowDiskUse);
-        _memoryTracker.resetCurrent();
+                memoryTracker->_allowDiskUse);
+        memoryTracker->resetCurrent();
         return true;
     }
     return false;
 }
 
-void DocumentSourceGroup::freeMemory() {
-    invariant(_groups);
-    for (auto&& group : *_groups) {
+void DocumentSourceGroup::freeMemory(GroupsMap* groups, MemoryUsageTracker* memoryTracker) const {
+    for (auto&& group : *groups) {
         for (size_t i = 0; i < group.second.size(); i++) {
             // Subtract the current usage.
-            _memoryTracker.update(_accumulatedFields[i].fieldName,
+            memoryTracker->update(_accumulatedFields[i].fieldName,
                                   -1 * group.second[i]->getMemUsage());
 
             group.second[i]->reduceMemoryConsumptionIfAble();
 
             // Update the memory usage for this AccumulationStatement.
-            _memoryTracker.update(_accumulatedFields[i].fieldName, group.second[i]->getMemUsage());
+            memoryTracker->update(_accumulatedFields[i].fieldName, group.second[i]->getMemUsage());
         }
     }
 }
@@ -239,7 +356,7 @@ DocumentSource::GetNextResult DocumentSourceGroup::getNextStandard() {
 
     Document out = makeDocument(groupsIterator->first, groupsIterator->second, pExpCtx->needsMerge);
 
-    if (++groupsIterator == _groups->end())
+    if (++groupsIterator == _groups->end() && !loadNextPartition())
         dispose();
 
     return out;
@@ -249,6 +366,9 @@ void DocumentSourceGroup::doDispose() {
     // Free our resources.
     _groups = pExpCtx->getValueComparator().makeUnorderedValueMap<Accumulators>();
     _sorterIterator.reset();
+    _inputBatch.clear();
+    stopPartitionWorkers();
+    _partitions.clear();
 
     // Make us look done.
     groupsIterator = _groups->end();
@@ -333,6 +453,9 @@ Value DocumentSourceGroup::serialize(boost::optional<ExplainOptions::Verbosity>
             Value(static_cast<long long>(_stats.totalOutputDataSizeBytes));
         out["usedDisk"] = Value(_stats.spills > 0);
         out["spills"] = Value(static_cast<long long>(_stats.spills));
+        if (_stats.parallelPartitions > 0) {
+            out["parallelPartitions"] = Value(static_cast<long long>(_stats.parallelPartitions));
+        }
     }
 
     return Value(out.freezeToValue());
@@ -548,86 +671,132 @@ private:
 }  // namespace
 
 DocumentSource::GetNextResult DocumentSourceGroup::initialize() {
-    GetNextResult input = pSource->getNext();
-    return initializeSelf(input);
+    auto inputStatus =
+        pSource->getNextBatch(&_inputBatch, internalDocumentSourceGetNextBatchSize.load());
+    // Only an input which does not fit in a single batch is worth partitioning across threads.
+    if (!_triedToPartitionGroups && inputStatus == GetNextResult::ReturnStatus::kAdvanced) {
+        tryToPartitionGroups();
+    }
+    _triedToPartitionGroups = true;
+    return initializeSelf(inputStatus);
 }
 
-// This separate NOINLINE function is used here to decrease stack utilization of initialize() and
-// prevent stack overflows.
-MONGO_COMPILER_NOINLINE DocumentSource::GetNextResult DocumentSourceGroup::initializeSelf(
-    GetNextResult input) {
+template <typename GetArgument>
+bool DocumentSourceGroup::accumulate(GroupsMap* groups,
+                                     MemoryUsageTracker* memoryTracker,
+                                     const Value& id,
+                                     const GetArgument& getArgument) const {
     const size_t numAccumulators = _accumulatedFields.size();
-    // Barring any pausing, this loop exhausts 'pSource' and populates '_groups'.
-    for (; input.isAdvanced(); input = pSource->getNext()) {
-        if (shouldSpillWithAttemptToSaveMemory()) {
-            _sortedFiles.push_back(spill());
+
+    // Look for the _id value in the map. If it's not there, add a new entry with a blank
+    // accumulator. This is done in a somewhat odd way in order to avoid hashing 'id' and
+    // looking it up in 'groups' multiple times.
+    const size_t oldSize = groups->size();
+    vector<intrusive_ptr<AccumulatorState>>& group = (*groups)[id];
+    const bool inserted = groups->size() != oldSize;
+
+    if (inserted) {
+        memoryTracker->set(memoryTracker->currentMemoryBytes() + id.getApproximateSize());
+
+        // Initialize and add the accumulators
+        Value expandedId = expandId(id);
+        Document idDoc =
+            expandedId.getType() == BSONType::Object ? expandedId.getDocument() : Document();
+        group.reserve(numAccumulators);
+        for (auto&& accumulatedField : _accumulatedFields) {
+            auto accum = accumulatedField.makeAccumulator();
+            Value initializerValue =
+                accumulatedField.expr.initializer->evaluate(idDoc, &pExpCtx->variables);
+            accum->startNewGroup(initializerValue);
+            group.push_back(accum);
         }
+    }
 
-        // We release the result document here so that it does not outlive the end of this loop
-        // iteration. Not releasing could lead to an array copy when this group follows an unwind.
-        auto rootDocument = input.releaseDocument();
-        Value id = computeId(rootDocument);
-
-        // Look for the _id value in the map. If it's not there, add a new entry with a blank
-        // accumulator. This is done in a somewhat odd way in order to avoid hashing 'id' and
-        // looking it up in '_groups' multiple times.
-        const size_t oldSize = _groups->size();
-        vector<intrusive_ptr<AccumulatorState>>& group = (*_groups)[id];
-        const bool inserted = _groups->size() != oldSize;
-
-        vector<uint64_t> oldAccumMemUsage(numAccumulators, 0);
-        if (inserted) {
-            _memoryTracker.set(_memoryTracker.currentMemoryBytes() + id.getApproximateSize());
-
-            // Initialize and add the accumulators
-            Value expandedId = expandId(id);
-            Document idDoc =
-                expandedId.getType() == BSONType::Object ? expandedId.getDocument() : Document();
-            group.reserve(numAccumulators);
-            for (auto&& accumulatedField : _accumulatedFields) {
-                auto accum = accumulatedField.makeAccumulator();
-                Value initializerValue =
-                    accumulatedField.expr.initializer->evaluate(idDoc, &pExpCtx->variables);
-                accum->startNewGroup(initializerValue);
-                group.push_back(accum);
-            }
+    /* tickle all the accumulators for the group we found */
+    dassert(numAccumulators == group.size());
+
+    for (size_t i = 0; i < numAccumulators; i++) {
+        // Only process the input and update the memory footprint if the current accumulator
+        // needs more input.
+        if (group[i]->needsInput()) {
+            const auto prevMemUsage = inserted ? 0 : group[i]->getMemUsage();
+            group[i]->process(getArgument(i), _doingMerge);
+            memoryTracker->update(_accumulatedFields[i].fieldName,
+                                  group[i]->getMemUsage() - prevMemUsage);
         }
+    }
+    return inserted;
+}
 
-        /* tickle all the accumulators for the group we found */
-        dassert(numAccumulators == group.size());
+void DocumentSourceGroup::processDocument(const Document& rootDocument) {
+    Value id = computeId(rootDocument);
+    const bool inserted = accumulate(&*_groups, &_memoryTracker, id, [&](size_t i) {
+        return _accumulatedFields[i].expr.argument->evaluate(rootDocument, &pExpCtx->variables);
+    });
 
-        for (size_t i = 0; i < numAccumulators; i++) {
-            // Only process the input and update the memory footprint if the current accumulator
-            // needs more input.
-            if (group[i]->needsInput()) {
-                const auto prevMemUsage = inserted ? 0 : group[i]->getMemUsage();
-                group[i]->process(_accumulatedFields[i].expr.argument->evaluate(
-                                      rootDocument, &pExpCtx->variables),
-                                  _doingMerge);
-                _memoryTracker.update(_accumulatedFields[i].fieldName,
-                                      group[i]->getMemUsage() - prevMemUsage);
-            }
+    if (kDebugBuild && !storageGlobalParams.readOnly) {
+        // In debug mode, spill every time we have a duplicate id to stress merge logic.
+        if (!inserted &&           // is a dup
+            !pExpCtx->inMongos &&  // can't spill to disk in mongos
+            !_memoryTracker
+                 ._allowDiskUse &&       // don't change behavior when testing external sort
+            _sortedFiles.size() < 20) {  // don't open too many FDs
+
+            _sortedFiles.push_back(spill());
         }
+    }
+}
+
+// This separate NOINLINE function is used here to decrease stack utilization of initialize() and
+// prevent stack overflows.
+MONGO_COMPILER_NOINLINE DocumentSource::GetNextResult DocumentSourceGroup::initializeSelf(
+    GetNextResult::ReturnStatus inputStatus) {
+    const size_t numAccumulators = _accumulatedFields.size();
+    const size_t batchSize = internalDocumentSourceGetNextBatchSize.load();
 
-        if (kDebugBuild && !storageGlobalParams.readOnly) {
-            // In debug mode, spill every time we have a duplicate id to stress merge logic.
-            if (!inserted &&           // is a dup
-                !pExpCtx->inMongos &&  // can't spill to disk in mongos
-                !_memoryTracker
-                     ._allowDiskUse &&       // don't change behavior when testing external sort
-                _sortedFiles.size() < 20) {  // don't open too many FDs
+    // The workers use the state of this stage, so they must finish before an error leaves it.
+    ScopeGuard stopWorkersOnError([&] { stopPartitionWorkers(); });
+
+    // Barring any pausing, this loop exhausts 'pSource' and populates '_groups', or the groups of
+    // '_partitions'.
+    while (true) {
+        if (!_partitions.empty()) {
+            dispatchToPartitions();
+        } else {
+            for (auto&& input : _inputBatch) {
+                if (shouldSpillWithAttemptToSaveMemory(&*_groups, &_memoryTracker)) {
+                    _sortedFiles.push_back(spill());
+                }
 
-                _sortedFiles.push_back(spill());
+                // We release each input document once it has been processed, so that it does not
+                // outlive its iteration. Not releasing could lead to an array copy when this group
+                // follows an unwind.
+                auto rootDocument = std::move(input);
+                processDocument(rootDocument);
             }
         }
+        _inputBatch.clear();
+
+        if (inputStatus != GetNextResult::ReturnStatus::kAdvanced) {
+            break;
+        }
+        inputStatus = pSource->getNextBatch(&_inputBatch, batchSize);
+    }
+
+    // On a pause, the workers wait for the rest of the input.
+    if (!_partitions.empty() && inputStatus == GetNextResult::ReturnStatus::kEOF) {
+        _partitionInput->endInput();
+        uassertStatusOK(waitForPartitionWorkers());
+        finishPartitions();
     }
+    stopWorkersOnError.dismiss();
 
-    switch (input.getStatus()) {
+    switch (inputStatus) {
         case DocumentSource::GetNextResult::ReturnStatus::kAdvanced: {
             MONGO_UNREACHABLE;  // We consumed all advances above.
         }
         case DocumentSource::GetNextResult::ReturnStatus::kPauseExecution: {
-            return input;  // Propagate pause.
+            return GetNextResult::makePauseExecution();  // Propagate pause.
         }
         case DocumentSource::GetNextResult::ReturnStatus::kEOF: {
             // Do any final steps necessary to prepare to output results.
@@ -659,7 +828,7 @@ MONGO_COMPILER_NOINLINE DocumentSource::GetNextResult DocumentSourceGroup::initi
             // This must happen last so that, unless control gets here, we will re-enter
             // initialization after getting a GetNextResult::ResultState::kPauseExecution.
             _initialized = true;
-            return input;
+            return GetNextResult::makeEOF();
         }
     }
     MONGO_UNREACHABLE;
@@ -668,15 +837,26 @@ MONGO_COMPILER_NOINLINE DocumentSource::GetNextResult DocumentSourceGroup::initi
 shared_ptr<Sorter<Value, Value>::Iterator> DocumentSourceGroup::spill() {
     _stats.spills++;
 
+    auto& metricsCollector = ResourceConsumption::MetricsCollector::get(pExpCtx->opCtx);
+    metricsCollector.incrementKeysSorted(_groups->size());
+    metricsCollector.incrementSorterSpills(1);
+
+    return spillGroups(&*_groups, &_memoryTracker, _file);
+}
+
+shared_ptr<Sorter<Value, Value>::Iterator> DocumentSourceGroup::spillGroups(
+    GroupsMap* groups,
+    MemoryUsageTracker* memoryTracker,
+    const shared_ptr<Sorter<Value, Value>::File>& file) const {
     vector<const GroupsMap::value_type*> ptrs;  // using pointers to speed sorting
-    ptrs.reserve(_groups->size());
-    for (GroupsMap::const_iterator it = _groups->begin(), end = _groups->end(); it != end; ++it) {
+    ptrs.reserve(groups->size());
+    for (GroupsMap::const_iterator it = groups->begin(), end = groups->end(); it != end; ++it) {
         ptrs.push_back(&*it);
     }
 
     stable_sort(ptrs.begin(), ptrs.end(), SpillSTLComparator(pExpCtx->getValueComparator()));
 
-    SortedFileWriter<Value, Value> writer(SortOptions().TempDir(pExpCtx->tempDir), _file);
+    SortedFileWriter<Value, Value> writer(SortOptions().TempDir(pExpCtx->tempDir), file);
     switch (_accumulatedFields.size()) {  // same as ptrs[i]->second.size() for all i.
         case 0:                           // no values, essentially a distinct
             for (size_t i = 0; i < ptrs.size(); i++) {
@@ -702,25 +882,205 @@ shared_ptr<Sorter<Value, Value>::Iterator> DocumentSourceGroup::spill() {
             break;
     }
 
-    auto& metricsCollector = ResourceConsumption::MetricsCollector::get(pExpCtx->opCtx);
-    metricsCollector.incrementKeysSorted(ptrs.size());
-    metricsCollector.incrementSorterSpills(1);
-
-    _groups->clear();
+    groups->clear();
     // Zero out the current per-accumulation statement memory consumption, as the memory has been
     // freed by spilling.
     for (auto accum : _accumulatedFields) {
-        _memoryTracker.set(accum.fieldName, 0);
+        memoryTracker->set(accum.fieldName, 0);
     }
 
     Sorter<Value, Value>::Iterator* iteratorPtr = writer.done();
     return shared_ptr<Sorter<Value, Value>::Iterator>(iteratorPtr);
 }
 
+void DocumentSourceGroup::tryToPartitionGroups() {
+    // The workers wait for the input published by this stage's thread, which must be interruptible.
+    // The workers copy the variables when they start, while those of a nested pipeline change as
+    // it runs.
+    if (!pExpCtx->opCtx || pExpCtx->subPipelineDepth > 0) {
+        return;
+    }
+    for (auto&& accumulatedField : _accumulatedFields) {
+        // The JavaScript accumulators run in the scope of the operation, and the initializers of
+        // the other accumulators are evaluated when a worker creates a group.
+        if (accumulatedField.expr.name == AccumulatorJs::kName ||
+            accumulatedField.expr.name == AccumulatorInternalJsReduce::kName ||
+            !dynamic_cast<ExpressionConstant*>(accumulatedField.expr.initializer.get()) ||
+            !canEvaluateOnWorkerThread(accumulatedField.expr.argument.get())) {
+            return;
+        }
+    }
+    for (auto&& idExpression : _idExpressions) {
+        if (!canEvaluateOnWorkerThread(idExpression.get())) {
+            return;
+        }
+    }
+
+    const int numPartitions = internalQueryGroupParallelPartitions.load();
+    if (!reserveGroupWorkers(numPartitions)) {
+        return;
+    }
+    _numReservedWorkers = numPartitions;
+
+    // Each partition gets an equal share of the memory limit.
+    const size_t maxMemoryUsageBytes = _memoryTracker._maxAllowedMemoryUsageBytes / numPartitions;
+    for (int i = 0; i < numPartitions; ++i) {
+        _partitions.push_back(std::make_unique<Partition>(
+            i,
+            pExpCtx->getValueComparator().makeUnorderedValueMap<Accumulators>(),
+            pExpCtx->variables,
+            _memoryTracker._allowDiskUse,
+            maxMemoryUsageBytes,
+            _file ? std::make_shared<Sorter<Value, Value>::File>(pExpCtx->tempDir + "/" +
+                                                                 nextFileName())
+                  : nullptr));
+    }
+    _stats.parallelPartitions = numPartitions;
+
+    // Each worker runs until the input is exhausted. The input which the slowest worker has not
+    // read yet is bounded by the size of a batch of a cursor.
+    _partitionInput =
+        TeeBuffer::create(numPartitions, internalDocumentSourceCursorBatchSizeBytes.load());
+    _partitionInput->enableConcurrentConsumers();
+    for (auto&& partition : _partitions) {
+        _partitionWorkers.push_back(scheduleGroupWorker(
+            [this, partition = partition.get()] { runPartitionWorker(partition); },
+            [input = _partitionInput](const Status& status) { input->abort(status); }));
+    }
+}
+
+void DocumentSourceGroup::dispatchToPartitions() {
+    if (_partitionInput->publishBatch(pExpCtx->opCtx, std::move(_inputBatch))) {
+        return;
+    }
+
+    // The input is only aborted when a worker fails.
+    uassertStatusOK(waitForPartitionWorkers());
+    MONGO_UNREACHABLE_TASSERT(7132224);
+}
+
+void DocumentSourceGroup::runPartitionWorker(Partition* partition) const {
+    const auto& valueComparator = pExpCtx->getValueComparator();
+    for (auto next = _partitionInput->getNext(partition->index); next.isAdvanced();
+         next = _partitionInput->getNext(partition->index)) {
+        // Every worker evaluates the key of every document, so that each group gets its input in
+        // the order of the input without any exchange between the workers. The arguments of the
+        // accumulators are only evaluated by the worker of the group.
+        const auto& rootDocument = next.getDocument();
+        Value id = computeId(rootDocument, &partition->variables);
+
+        // The groups maps of the partitions hash the keys again, so the partition is chosen from
+        // the high bits of the hash to keep the keys of a partition spread across its map.
+        const uint64_t hash = valueComparator.hash(id);
+        if (((hash * 0x9E3779B97F4A7C15ULL) >> 32) % _partitions.size() != partition->index) {
+            continue;
+        }
+
+        if (shouldSpillWithAttemptToSaveMemory(&partition->groups, &partition->memoryTracker)) {
+            partition->numKeysSpilled += partition->groups.size();
+            partition->sortedFiles.push_back(
+                spillGroups(&partition->groups, &partition->memoryTracker, partition->file));
+        }
+        accumulate(&partition->groups, &partition->memoryTracker, id, [&](size_t i) {
+            return _accumulatedFields[i].expr.argument->evaluate(rootDocument,
+                                                                 &partition->variables);
+        });
+    }
+}
+
+Status DocumentSourceGroup::waitForPartitionWorkers() {
+    Status status = Status::OK();
+    for (auto&& worker : _partitionWorkers) {
+        auto workerStatus = worker.getNoThrow();
+        if (status.isOK()) {
+            status = std::move(workerStatus);
+        }
+    }
+    _partitionWorkers.clear();
+    return status;
+}
+
+void DocumentSourceGroup::stopPartitionWorkers() {
+    if (_partitionInput) {
+        _partitionInput->abort({ErrorCodes::Interrupted, "$group stopped before its input ended"});
+    }
+    waitForPartitionWorkers().ignore();
+    releasePartitionWorkers();
+}
+
+void DocumentSourceGroup::finishPartitions() {
+    _partitionInput.reset();
+
+    const bool spilled = std::any_of(_partitions.begin(), _partitions.end(), [](auto&& partition) {
+        return !partition->sortedFiles.empty();
+    });
+    if (spilled) {
+        // The groups are then all read back from disk in the order of their keys, so the groups
+        // which are still in memory are spilled too.
+        for (auto&& partition : _partitions) {
+            if (partition->groups.empty()) {
+                continue;
+            }
+            _partitionWorkers.push_back(scheduleGroupWorker([this, partition = partition.get()] {
+                partition->numKeysSpilled += partition->groups.size();
+                partition->sortedFiles.push_back(
+                    spillGroups(&partition->groups, &partition->memoryTracker, partition->file));
+            }));
+        }
+        uassertStatusOK(waitForPartitionWorkers());
+    }
+    releasePartitionWorkers();
+
+    auto& metricsCollector = ResourceConsumption::MetricsCollector::get(pExpCtx->opCtx);
+    for (auto&& accumulatedField : _accumulatedFields) {
+        long long maxMemoryBytes = 0;
+        for (auto&& partition : _partitions) {
+            maxMemoryBytes += partition->memoryTracker[accumulatedField.fieldName].maxMemoryBytes();
+        }
+        _memoryTracker.set(accumulatedField.fieldName, maxMemoryBytes);
+    }
+    for (auto&& partition : _partitions) {
+        _stats.spills += partition->sortedFiles.size();
+        metricsCollector.incrementKeysSorted(partition->numKeysSpilled);
+        metricsCollector.incrementSorterSpills(partition->sortedFiles.size());
+        std::move(partition->sortedFiles.begin(),
+                  partition->sortedFiles.end(),
+                  std::back_inserter(_sortedFiles));
+        partition->sortedFiles.clear();
+    }
+
+    // Since the keys of the partitions are distinct, their groups are returned one partition
+    // after the other.
+    if (!spilled) {
+        loadNextPartition();
+    }
+}
+
+bool DocumentSourceGroup::loadNextPartition() {
+    while (_nextPartition < _partitions.size()) {
+        auto& partition = _partitions[_nextPartition++];
+        if (!partition->groups.empty()) {
+            _groups = std::move(partition->groups);
+            groupsIterator = _groups->begin();
+            return true;
+        }
+    }
+    return false;
+}
+
+void DocumentSourceGroup::releasePartitionWorkers() {
+    numGroupWorkersInUse.subtractAndFetch(_numReservedWorkers);
+    _numReservedWorkers = 0;
+}
+
 Value DocumentSourceGroup::computeId(const Document& root) {
+    return computeId(root, &pExpCtx->variables);
+}
+
+Value DocumentSourceGroup::computeId(const Document& root, Variables* variables) const {
     // If only one expression, return result directly
     if (_idExpressions.size() == 1) {
-        Value retValue = _idExpressions[0]->evaluate(root, &pExpCtx->variables);
+        Value retValue = _idExpressions[0]->evaluate(root, variables);
         return retValue.missing() ? Value(BSONNULL) : std::move(retValue);
     }
 
@@ -728,12 +1088,12 @@ Value DocumentSourceGroup::computeId(const Document& root) {
     vector<Value> vals;
     vals.reserve(_idExpressions.size());
     for (size_t i = 0; i < _idExpressions.size(); i++) {
-        vals.push_back(_idExpressions[i]->evaluate(root, &pExpCtx->variables));
+        vals.push_back(_idExpressions[i]->evaluate(root, variables));
     }
     return Value(std::move(vals));
 }
 
-Value DocumentSourceGroup::expandId(const Value& val) {
+Value DocumentSourceGroup::expandId(const Value& val) const {
     // _id doesn't get wrapped in a document
     if (_idFieldNames.empty())
         return val;
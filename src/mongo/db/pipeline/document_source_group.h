@@ -36,8 +36,10 @@
 #include "mongo/db/pipeline/accumulator.h"
 #include "mongo/db/pipeline/document_source.h"
 #include "mongo/db/pipeline/memory_usage_tracker.h"
+#include "mongo/db/pipeline/tee_buffer.h"
 #include "mongo/db/pipeline/transformer_interface.h"
 #include "mongo/db/sorter/sorter.h"
+#include "mongo/util/future.h"
 
 namespace mongo {
 
@@ -231,9 +233,55 @@ private:
 
     /**
      * Initializes this $group after any children are potentially initialized see initialize() for
-     * more details.
+     * more details. 'inputStatus' is the status which ended the batch of input documents in
+     * '_inputBatch'.
      */
-    GetNextResult initializeSelf(GetNextResult input);
+    GetNextResult initializeSelf(GetNextResult::ReturnStatus inputStatus);
+
+    /**
+     * The groups whose keys hash to one of the worker threads of a parallel $group, along with what
+     * the worker needs to evaluate the input and to spill the groups. While a worker runs, only it
+     * uses its partition.
+     */
+    struct Partition {
+        Partition(size_t index,
+                  GroupsMap groups,
+                  const Variables& variables,
+                  bool allowDiskUse,
+                  size_t maxMemoryUsageBytes,
+                  std::shared_ptr<Sorter<Value, Value>::File> file)
+            : index(index),
+              groups(std::move(groups)),
+              variables(variables),
+              memoryTracker{allowDiskUse, maxMemoryUsageBytes},
+              file(std::move(file)) {}
+
+        // The index of this partition, which is also its consumer id in '_partitionInput'.
+        const size_t index;
+        GroupsMap groups;
+        // The expressions keep their state in the variables, so each worker has its own copy.
+        Variables variables;
+        MemoryUsageTracker memoryTracker;
+        std::shared_ptr<Sorter<Value, Value>::File> file;
+        std::vector<std::shared_ptr<Sorter<Value, Value>::Iterator>> sortedFiles;
+        uint64_t numKeysSpilled = 0;
+    };
+
+    /**
+     * Adds 'rootDocument' to the group it belongs to.
+     */
+    void processDocument(const Document& rootDocument);
+
+    /**
+     * Adds an input whose group key is 'id' to its group in 'groups', creating the group if it does
+     * not exist yet. 'getArgument(i)' returns the argument of the i-th accumulator for this input.
+     * Returns true if a new group was created.
+     */
+    template <typename GetArgument>
+    bool accumulate(GroupsMap* groups,
+                    MemoryUsageTracker* memoryTracker,
+                    const Value& id,
+                    const GetArgument& getArgument) const;
 
     /**
      * Spill groups map to disk and returns an iterator to the file. Note: Since a sorted $group
@@ -242,24 +290,79 @@ private:
      */
     std::shared_ptr<Sorter<Value, Value>::Iterator> spill();
 
+    /**
+     * Writes 'groups' to 'file' in the order of their keys, and empties 'groups'. Returns an
+     * iterator over the spilled groups.
+     */
+    std::shared_ptr<Sorter<Value, Value>::Iterator> spillGroups(
+        GroupsMap* groups,
+        MemoryUsageTracker* memoryTracker,
+        const std::shared_ptr<Sorter<Value, Value>::File>& file) const;
+
     /**
      * If we ran out of memory, finish all the pending operations so that some memory
      * can be freed.
      */
-    void freeMemory();
+    void freeMemory(GroupsMap* groups, MemoryUsageTracker* memoryTracker) const;
+
+    /**
+     * Sets up '_partitions' and starts their workers if this $group can build its groups on several
+     * threads and enough of them are available.
+     */
+    void tryToPartitionGroups();
+
+    /**
+     * Publishes the documents in '_inputBatch' to the workers of the partitions. Blocks while the
+     * workers are more than '_partitionInput' can hold behind. Throws the error of a worker which
+     * failed.
+     */
+    void dispatchToPartitions();
+
+    /**
+     * Runs on the worker thread of 'partition' until all the input is published. Evaluates the
+     * group key of every document, and adds the documents whose keys hash to 'partition' to its
+     * groups.
+     */
+    void runPartitionWorker(Partition* partition) const;
+
+    /**
+     * Waits for every scheduled worker to finish. Returns the first error any of them hit.
+     */
+    Status waitForPartitionWorkers();
+
+    /**
+     * Stops the workers of the partitions, waits for them and releases their threads.
+     */
+    void stopPartitionWorkers();
+
+    /**
+     * Once all the input has been processed, prepares the groups of the partitions for output. If
+     * any partition spilled, the groups of all of them are merged from disk.
+     */
+    void finishPartitions();
+
+    /**
+     * Moves the groups of the next non-empty partition into '_groups' to be returned. Returns false
+     * if there are no more groups.
+     */
+    bool loadNextPartition();
+
+    void releasePartitionWorkers();
 
     Document makeDocument(const Value& id, const Accumulators& accums, bool mergeableOutput);
 
     /**
-     * Computes the internal representation of the group key.
+     * Computes the internal representation of the group key, evaluating the expressions with
+     * 'variables', or with the variables of the ExpressionContext if none are given.
      */
     Value computeId(const Document& root);
+    Value computeId(const Document& root, Variables* variables) const;
 
     /**
      * Converts the internal representation of the group key to the _id shape specified by the
      * user.
      */
-    Value expandId(const Value& val);
+    Value expandId(const Value& val) const;
 
     /**
      * Returns true if 'dottedPath' is one of the group keys present in '_idExpressions'.
@@ -272,7 +375,8 @@ private:
      *
      * Returns true, if the caller should spill to disk, false otherwise.
      */
-    bool shouldSpillWithAttemptToSaveMemory();
+    bool shouldSpillWithAttemptToSaveMemory(GroupsMap* groups,
+                                            MemoryUsageTracker* memoryTracker) const;
 
     std::vector<AccumulationStatement> _accumulatedFields;
 
@@ -314,7 +418,28 @@ private:
 
     std::pair<Value, Value> _firstPartOfNextGroup;
 
+    // The input documents are read from 'pSource' a batch at a time while the groups are built.
+    std::vector<Document> _inputBatch;
+
+    // When the groups are built on several threads, each of these holds the groups whose keys hash
+    // to one of the threads. Empty if the groups are built on this stage's thread.
+    std::vector<std::unique_ptr<Partition>> _partitions;
+    // The input documents, which this stage's thread publishes to the workers of the partitions.
+    boost::intrusive_ptr<TeeBuffer> _partitionInput;
+    std::vector<Future<void>> _partitionWorkers;
+    int _numReservedWorkers = 0;
+    bool _triedToPartitionGroups = false;
+    // The index in '_partitions' of the next partition whose groups are returned.
+    size_t _nextPartition = 0;
+
     bool _sbeCompatible;
 };
 
+/**
+ * Shuts down and joins the threads on which $group stages build their groups in parallel. Any
+ * $group stage which starts building its groups in parallel afterwards fails with the error of the
+ * pool.
+ */
+void shutdownGroupWorkerThreadPool();
+
 }  // namespace mongo
@@ -52,6 +52,7 @@
 #include "mongo/db/pipeline/expression_context_for_test.h"
 #include "mongo/db/query/query_test_service_context.h"
 #include "mongo/dbtests/dbtests.h"
+#include "mongo/idl/server_parameter_test_util.h"
 #include "mongo/stdx/unordered_set.h"
 #include "mongo/unittest/temp_dir.h"
 #include "mongo/unittest/unittest.h"
@@ -207,6 +208,162 @@ TEST_F(DocumentSourceGroupTest, ShouldCorrectlyTrackMemoryUsageBetweenPauses) {
         group->getNext(), AssertionException, ErrorCodes::QueryExceededMemoryLimitNoDiskUseAllowed);
 }
 
+TEST_F(DocumentSourceGroupTest, ShouldPartitionGroupsAcrossWorkerThreads) {
+    RAIIServerParameterControllerForTest maxWorkers("internalQueryGroupMaxParallelWorkers", 4);
+    RAIIServerParameterControllerForTest partitions("internalQueryGroupParallelPartitions", 4);
+    RAIIServerParameterControllerForTest batchSize("internalDocumentSourceGetNextBatchSize", 10);
+    auto expCtx = getExpCtx();
+
+    auto group = DocumentSourceGroup::createFromBson(
+        fromjson("{$group: {_id: '$key', count: {$sum: 1}, values: {$addToSet: '$value'}}}")
+            .firstElement(),
+        expCtx);
+    const int numGroups = 100;
+    deque<DocumentSource::GetNextResult> docs;
+    for (int i = 0; i < 10 * numGroups; ++i) {
+        docs.push_back(Document{{"key", i % numGroups}, {"value", i % 3}});
+        if (i == numGroups / 2) {
+            docs.push_back(DocumentSource::GetNextResult::makePauseExecution());
+        }
+    }
+    auto mock = DocumentSourceMock::createForTest(std::move(docs), expCtx);
+    group->setSource(mock.get());
+
+    ASSERT_TRUE(group->getNext().isPaused());
+    stdx::unordered_set<int> keys;
+    for (auto result = group->getNext(); result.isAdvanced(); result = group->getNext()) {
+        auto doc = result.releaseDocument();
+        ASSERT_TRUE(keys.insert(doc["_id"].coerceToInt()).second);
+        ASSERT_VALUE_EQ(doc["count"], Value(10));
+        ASSERT_EQ(doc["values"].getArrayLength(), 3UL);
+    }
+    ASSERT_EQ(keys.size(), static_cast<size_t>(numGroups));
+
+    auto stats = static_cast<const GroupStats*>(group->getSpecificStats());
+    ASSERT_EQ(stats->parallelPartitions, 4UL);
+    ASSERT_EQ(stats->spills, 0UL);
+}
+
+TEST_F(DocumentSourceGroupTest, ShouldMergeSpilledPartitions) {
+    RAIIServerParameterControllerForTest maxWorkers("internalQueryGroupMaxParallelWorkers", 2);
+    RAIIServerParameterControllerForTest partitions("internalQueryGroupParallelPartitions", 2);
+    RAIIServerParameterControllerForTest batchSize("internalDocumentSourceGetNextBatchSize", 4);
+    auto expCtx = getExpCtx();
+    TempDir tempDir("DocumentSourceGroupTest");
+    expCtx->tempDir = tempDir.path();
+    expCtx->allowDiskUse = true;
+    const size_t maxMemoryUsageBytes = 2000;
+
+    auto&& [parser, _1, _2, _3] = AccumulationStatement::getParser("$push");
+    auto accumulatorArg = BSON(""
+                               << "$largeStr");
+    auto accExpr = parser(expCtx.get(), accumulatorArg.firstElement(), expCtx->variablesParseState);
+    AccumulationStatement pushStatement{"spaceHog", accExpr};
+    auto groupByExpression =
+        ExpressionFieldPath::parse(expCtx.get(), "$key", expCtx->variablesParseState);
+    auto group = DocumentSourceGroup::create(
+        expCtx, groupByExpression, {pushStatement}, maxMemoryUsageBytes);
+
+    // Each partition may hold a single large string before it spills.
+    string largeStr(maxMemoryUsageBytes / 4, 'x');
+    const int numGroups = 10;
+    deque<DocumentSource::GetNextResult> docs;
+    for (int i = 0; i < 3 * numGroups; ++i) {
+        docs.push_back(Document{{"key", i % numGroups}, {"largeStr", largeStr}});
+    }
+    auto mock = DocumentSourceMock::createForTest(std::move(docs), expCtx);
+    group->setSource(mock.get());
+
+    // The groups come back in the order of their keys, each merged from every spill.
+    int expectedKey = 0;
+    for (auto result = group->getNext(); result.isAdvanced(); result = group->getNext()) {
+        auto doc = result.releaseDocument();
+        ASSERT_VALUE_EQ(doc["_id"], Value(expectedKey++));
+        ASSERT_EQ(doc["spaceHog"].getArrayLength(), 3UL);
+    }
+    ASSERT_EQ(expectedKey, numGroups);
+
+    auto stats = static_cast<const GroupStats*>(group->getSpecificStats());
+    ASSERT_EQ(stats->parallelPartitions, 2UL);
+    ASSERT_GT(stats->spills, 2UL);
+}
+
+TEST_F(DocumentSourceGroupTest, ShouldKeepTheOrderOfTheInputOfEachPartitionedGroup) {
+    RAIIServerParameterControllerForTest maxWorkers("internalQueryGroupMaxParallelWorkers", 4);
+    RAIIServerParameterControllerForTest partitions("internalQueryGroupParallelPartitions", 4);
+    RAIIServerParameterControllerForTest batchSize("internalDocumentSourceGetNextBatchSize", 8);
+    auto expCtx = getExpCtx();
+
+    // The workers evaluate the key and the arguments, including with variables of their own.
+    auto group = DocumentSourceGroup::createFromBson(
+        fromjson("{$group: {_id: {$mod: ['$i', 7]}, first: {$first: '$i'}, "
+                 "all: {$push: {$let: {vars: {x: '$i'}, in: {$multiply: ['$$x', 2]}}}}}}")
+            .firstElement(),
+        expCtx);
+    const int numDocs = 200;
+    deque<DocumentSource::GetNextResult> docs;
+    for (int i = 0; i < numDocs; ++i) {
+        docs.push_back(Document{{"i", i}});
+    }
+    auto mock = DocumentSourceMock::createForTest(std::move(docs), expCtx);
+    group->setSource(mock.get());
+
+    size_t numGroups = 0;
+    for (auto result = group->getNext(); result.isAdvanced(); result = group->getNext()) {
+        auto doc = result.releaseDocument();
+        const int key = doc["_id"].coerceToInt();
+        ASSERT_VALUE_EQ(doc["first"], Value(key));
+        const auto& all = doc["all"].getArray();
+        for (size_t j = 0; j < all.size(); ++j) {
+            ASSERT_VALUE_EQ(all[j], Value(2 * (key + 7 * static_cast<int>(j))));
+        }
+        ++numGroups;
+    }
+    ASSERT_EQ(numGroups, 7UL);
+    ASSERT_EQ(static_cast<const GroupStats*>(group->getSpecificStats())->parallelPartitions, 4UL);
+}
+
+TEST_F(DocumentSourceGroupTest, ShouldReportTheErrorOfAPartitionWorker) {
+    RAIIServerParameterControllerForTest maxWorkers("internalQueryGroupMaxParallelWorkers", 2);
+    RAIIServerParameterControllerForTest partitions("internalQueryGroupParallelPartitions", 2);
+    RAIIServerParameterControllerForTest batchSize("internalDocumentSourceGetNextBatchSize", 4);
+    auto expCtx = getExpCtx();
+
+    auto group = DocumentSourceGroup::createFromBson(
+        fromjson("{$group: {_id: '$key', total: {$sum: {$divide: [1, '$divisor']}}}}")
+            .firstElement(),
+        expCtx);
+    deque<DocumentSource::GetNextResult> docs;
+    for (int i = 0; i < 100; ++i) {
+        docs.push_back(Document{{"key", i % 10}, {"divisor", i == 50 ? 0 : 1}});
+    }
+    auto mock = DocumentSourceMock::createForTest(std::move(docs), expCtx);
+    group->setSource(mock.get());
+
+    ASSERT_THROWS_CODE(group->getNext(), AssertionException, 2);
+    group->dispose();
+}
+
+TEST_F(DocumentSourceGroupTest, ShouldNotPartitionGroupsWithoutAvailableWorkers) {
+    RAIIServerParameterControllerForTest maxWorkers("internalQueryGroupMaxParallelWorkers", 1);
+    RAIIServerParameterControllerForTest partitions("internalQueryGroupParallelPartitions", 2);
+    RAIIServerParameterControllerForTest batchSize("internalDocumentSourceGetNextBatchSize", 2);
+    auto expCtx = getExpCtx();
+
+    auto group = DocumentSourceGroup::createFromBson(
+        fromjson("{$group: {_id: '$key', count: {$sum: 1}}}").firstElement(), expCtx);
+    auto mock = DocumentSourceMock::createForTest(
+        {Document{{"key", 1}}, Document{{"key", 2}}, Document{{"key", 1}}}, expCtx);
+    group->setSource(mock.get());
+
+    size_t numGroups = 0;
+    for (auto result = group->getNext(); result.isAdvanced(); result = group->getNext()) {
+        ++numGroups;
+    }
+    ASSERT_EQ(numGroups, 2UL);
+    ASSERT_EQ(static_cast<const GroupStats*>(group->getSpecificStats())->parallelPartitions, 0UL);
+}
+
 TEST_F(DocumentSourceGroupTest, ShouldReportSingleFieldGroupKeyAsARename) {
     auto expCtx = getExpCtx();
     VariablesParseState vps = expCtx->variablesParseState;
@@ -250,10 +250,24 @@ public:
         return _sbeCompatible;
     }
 
-    const NamespaceString& getFromNs() {
+    const NamespaceString& getFromNs() const {
         return _fromNs;
     }
 
+    /**
+     * Returns the $unwind stage absorbed into this $lookup, if any.
+     */
+    const boost::intrusive_ptr<DocumentSourceUnwind>& getUnwindSource() const {
+        return _unwindSrc;
+    }
+
+    /**
+     * Returns the filter on the foreign collection absorbed from a $match following the $unwind.
+     */
+    const boost::optional<BSONObj>& getAdditionalFilter() const {
+        return _additionalFilter;
+    }
+
 protected:
     GetNextResult doGetNext() final;
     void doDispose() final;
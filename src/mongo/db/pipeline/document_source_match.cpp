@@ -86,20 +86,22 @@ intrusive_ptr<DocumentSource> DocumentSourceMatch::optimize() {
     return this;
 }
 
+bool DocumentSourceMatch::matches(const Document& document) const {
+    // MatchExpression only takes BSON documents, so we have to make one. As an optimization, only
+    // serialize the fields we need to do the match.
+    BSONObj toMatch = _dependencies.needWholeDocument
+        ? document.toBson()
+        : document_path_support::documentToBsonWithPaths(document, _dependencies.fields);
+    return _expression->matchesBSON(toMatch);
+}
+
 DocumentSource::GetNextResult DocumentSourceMatch::doGetNext() {
     // The user facing error should have been generated earlier.
     massert(17309, "Should never call getNext on a $match stage with $text clause", !_isTextQuery);
 
     auto nextInput = pSource->getNext();
     for (; nextInput.isAdvanced(); nextInput = pSource->getNext()) {
-        // MatchExpression only takes BSON documents, so we have to make one. As an optimization,
-        // only serialize the fields we need to do the match.
-        BSONObj toMatch = _dependencies.needWholeDocument
-            ? nextInput.getDocument().toBson()
-            : document_path_support::documentToBsonWithPaths(nextInput.getDocument(),
-                                                             _dependencies.fields);
-
-        if (_expression->matchesBSON(toMatch)) {
+        if (matches(nextInput.getDocument())) {
             return nextInput;
         }
 
@@ -114,6 +116,35 @@ DocumentSource::GetNextResult DocumentSourceMatch::doGetNext() {
     return nextInput;
 }
 
+DocumentSource::GetNextResult::ReturnStatus DocumentSourceMatch::doGetNextBatch(
+    std::vector<Document>* batch, size_t maxBatchSize) {
+    massert(7132200,
+            "Should never call getNextBatch on a $match stage with $text clause",
+            !_isTextQuery);
+
+    // Filter the batches of the child in place, until we have a full batch or the child stops
+    // advancing.
+    const auto batchStart = batch->size();
+    auto status = GetNextResult::ReturnStatus::kAdvanced;
+    while (status == GetNextResult::ReturnStatus::kAdvanced &&
+           batch->size() - batchStart < maxBatchSize) {
+        const auto inputStart = batch->size();
+        status = pSource->getNextBatch(batch, maxBatchSize - (inputStart - batchStart));
+
+        auto output = batch->begin() + inputStart;
+        for (auto input = output; input != batch->end(); ++input) {
+            if (matches(*input)) {
+                if (output != input) {
+                    *output = std::move(*input);
+                }
+                ++output;
+            }
+        }
+        batch->erase(output, batch->end());
+    }
+    return status;
+}
+
 Pipeline::SourceContainer::iterator DocumentSourceMatch::doOptimizeAt(
     Pipeline::SourceContainer::iterator itr, Pipeline::SourceContainer* container) {
     invariant(*itr == this);
@@ -211,6 +211,8 @@ protected:
               other.pExpCtx) {}
 
     GetNextResult doGetNext() override;
+    GetNextResult::ReturnStatus doGetNextBatch(std::vector<Document>* batch,
+                                               size_t maxBatchSize) override;
     DocumentSourceMatch(const BSONObj& query,
                         const boost::intrusive_ptr<ExpressionContext>& expCtx);
 
@@ -222,6 +224,11 @@ private:
                       const StringMap<std::string>& renames,
                       expression::ShouldSplitExprFunc func) &&;
 
+    /**
+     * Returns whether 'document' matches the predicate of this stage.
+     */
+    bool matches(const Document& document) const;
+
     std::unique_ptr<MatchExpression> _expression;
 
     bool _isTextQuery;
@@ -72,6 +72,24 @@ DocumentSource::GetNextResult DocumentSourceSingleDocumentTransformation::doGetN
     return _parsedTransform->applyTransformation(input.releaseDocument());
 }
 
+DocumentSource::GetNextResult::ReturnStatus
+DocumentSourceSingleDocumentTransformation::doGetNextBatch(std::vector<Document>* batch,
+                                                           size_t maxBatchSize) {
+    if (!_parsedTransform) {
+        return GetNextResult::ReturnStatus::kEOF;
+    }
+
+    // Transform the batch of the child in place. Each input document is moved out of the batch
+    // before it is transformed, so that the transformation does not copy it on write.
+    const auto batchStart = batch->size();
+    auto status = pSource->getNextBatch(batch, maxBatchSize);
+    for (auto it = batch->begin() + batchStart; it != batch->end(); ++it) {
+        Document input = std::move(*it);
+        *it = _parsedTransform->applyTransformation(input);
+    }
+    return status;
+}
+
 intrusive_ptr<DocumentSource> DocumentSourceSingleDocumentTransformation::optimize() {
     if (_parsedTransform) {
         _parsedTransform->optimize();
@@ -219,6 +219,27 @@ DocumentSource::GetNextResult DocumentSourceUnwind::doGetNext() {
     return nextOut;
 }
 
+DocumentSource::GetNextResult::ReturnStatus DocumentSourceUnwind::doGetNextBatch(
+    std::vector<Document>* batch, size_t maxBatchSize) {
+    // The input documents are still pulled one at a time, so that the unwinder is the only holder
+    // of the document it is unwinding. Each of them usually produces several output documents.
+    for (size_t numAdvanced = 0; numAdvanced < maxBatchSize;) {
+        auto nextOut = _unwinder->getNext();
+        if (nextOut.isAdvanced()) {
+            batch->push_back(nextOut.releaseDocument());
+            ++numAdvanced;
+            continue;
+        }
+
+        auto nextInput = pSource->getNext();
+        if (!nextInput.isAdvanced()) {
+            return nextInput.getStatus();
+        }
+        _unwinder->resetDocument(nextInput.releaseDocument());
+    }
+    return GetNextResult::ReturnStatus::kAdvanced;
+}
+
 DocumentSource::GetModPathsReturn DocumentSourceUnwind::getModifiedPaths() const {
     std::set<std::string> modifiedFields{_unwindPath.fullPath()};
     if (_indexPath) {
@@ -154,6 +154,17 @@ void LiteParsedPipeline::tickGlobalStageCounters() const {
     }
 }
 
+bool LiteParsedPipeline::allStageNamesSatisfy(
+    const std::function<bool(StringData)>& predicate) const {
+    return std::all_of(_stageSpecs.begin(), _stageSpecs.end(), [&](auto&& stage) {
+        const auto& subPipelines = stage->getSubPipelines();
+        return predicate(stage->getParseTimeName()) &&
+            std::all_of(subPipelines.begin(), subPipelines.end(), [&](auto&& subPipeline) {
+                   return subPipeline.allStageNamesSatisfy(predicate);
+               });
+    });
+}
+
 void LiteParsedPipeline::validate(const OperationContext* opCtx,
                                   bool performApiVersionChecks) const {
 
@@ -205,6 +205,12 @@ public:
      */
     void tickGlobalStageCounters() const;
 
+    /**
+     * Returns true if 'predicate' holds for the name of every stage in this pipeline and in all of
+     * its sub-pipelines.
+     */
+    bool allStageNamesSatisfy(const std::function<bool(StringData)>& predicate) const;
+
     /**
      * Verifies that the pipeline contains valid stages. Optionally calls
      * 'validatePipelineStagesforAPIVersion' with 'opCtx', and throws UserException if there is
@@ -289,6 +289,12 @@ public:
      */
     boost::optional<Document> getNext();
 
+    /**
+     * Appends up to 'maxBatchSize' results from the pipeline to 'batch'. Returns false once the
+     * pipeline is exhausted; the results appended by that final call are still valid.
+     */
+    bool getNextBatch(std::vector<Document>* batch, size_t maxBatchSize);
+
     /**
      * Write the pipeline's operators to a std::vector<Value>, providing the level of detail
      * specified by 'verbosity'.
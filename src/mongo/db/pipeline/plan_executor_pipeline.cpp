@@ -36,6 +36,7 @@
 #include "mongo/db/pipeline/pipeline_d.h"
 #include "mongo/db/pipeline/plan_explainer_pipeline.h"
 #include "mongo/db/pipeline/resume_token.h"
+#include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/db/repl/speculative_majority_read_info.h"
 
 namespace mongo {
@@ -127,7 +128,26 @@ boost::optional<Document> PlanExecutorPipeline::_getNext() {
 }
 
 boost::optional<Document> PlanExecutorPipeline::_tryGetNext() try {
-    return _pipeline->getNext();
+    if (_batchPosition < _batch.size()) {
+        return std::move(_batch[_batchPosition++]);
+    }
+
+    // Change streams and resumable oplog scans update their scan state after every document, so
+    // they must not read ahead of the results which have been returned by this executor.
+    const auto batchSize = internalDocumentSourceGetNextBatchSize.load();
+    if (ResumableScanType::kNone != _resumableScanType || batchSize <= 1) {
+        return _pipeline->getNext();
+    }
+
+    _batch.clear();
+    _batchPosition = 0;
+    while (_batch.empty() && !_batchedPipelineIsEof) {
+        _batchedPipelineIsEof = !_pipeline->getNextBatch(&_batch, batchSize);
+    }
+    if (_batch.empty()) {
+        return boost::none;
+    }
+    return std::move(_batch[_batchPosition++]);
 } catch (const ExceptionFor<ErrorCodes::ChangeStreamTopologyChange>& ex) {
     // This exception contains the next document to be returned by the pipeline.
     const auto extraInfo = ex.extraInfo<ChangeStreamTopologyChangeInfo>();
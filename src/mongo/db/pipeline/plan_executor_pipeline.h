@@ -30,6 +30,7 @@
 #pragma once
 
 #include <queue>
+#include <vector>
 
 #include "mongo/db/exec/document_value/document.h"
 #include "mongo/db/pipeline/pipeline.h"
@@ -223,6 +224,15 @@ private:
 
     std::queue<BSONObj> _stash;
 
+    // Results which have been pulled from '_pipeline' in a single batch but not yet returned.
+    // Documents before '_batchPosition' have already been returned.
+    std::vector<Document> _batch;
+    size_t _batchPosition = 0;
+
+    // Set once a batched call to '_pipeline' has reported end-of-stream. Results may still remain
+    // in '_batch'.
+    bool _batchedPipelineIsEof = false;
+
     // If _killStatus has a non-OK value, then we have been killed and the value represents the
     // reason for the kill.
     Status _killStatus = Status::OK();
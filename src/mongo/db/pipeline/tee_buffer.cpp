@@ -32,6 +32,7 @@
 #include "mongo/db/pipeline/tee_buffer.h"
 
 #include <algorithm>
+#include <limits>
 
 #include "mongo/db/exec/document_value/document.h"
 
@@ -50,6 +51,10 @@ boost::intrusive_ptr<TeeBuffer> TeeBuffer::create(size_t nConsumers, int bufferS
 }
 
 DocumentSource::GetNextResult TeeBuffer::getNext(size_t consumerId) {
+    if (_concurrent) {
+        return getNextConcurrent(consumerId);
+    }
+
     size_t nConsumersStillProcessingThisBatch =
         std::count_if(_consumers.begin(), _consumers.end(), [](const ConsumerInfo& info) {
             return info.nLeftToReturn > 0;
@@ -104,4 +109,126 @@ void TeeBuffer::loadNextBatch() {
     }
 }
 
+void TeeBuffer::feedConsumers(Interruptible* interruptible, size_t maxBatchSize) {
+    invariant(_concurrent);
+    auto status = DocumentSource::GetNextResult::ReturnStatus::kAdvanced;
+    while (status != DocumentSource::GetNextResult::ReturnStatus::kEOF) {
+        std::vector<Document> batch;
+        status = _source->getNextBatch(&batch, maxBatchSize);
+
+        // As in loadNextBatch(), the input of a $facet stage can never pause.
+        invariant(status != DocumentSource::GetNextResult::ReturnStatus::kPauseExecution);
+        if (!publishBatch(interruptible, std::move(batch))) {
+            return;
+        }
+    }
+    endInput();
+}
+
+void TeeBuffer::endInput() {
+    invariant(_concurrent);
+    stdx::lock_guard<Latch> lk(_mutex);
+    _inputExhausted = true;
+    _consumerCV.notify_all();
+}
+
+bool TeeBuffer::publishBatch(Interruptible* interruptible, std::vector<Document> batch) {
+    invariant(_concurrent);
+    if (batch.empty()) {
+        return true;
+    }
+
+    // The documents are read from several threads at once, so anything which they would load
+    // lazily when accessed must be loaded now.
+    size_t bytes = 0;
+    for (auto&& doc : batch) {
+        doc.fillCache();
+        doc.metadata();
+        bytes += doc.getApproximateSize();
+    }
+
+    auto anyConsumerInUse = [&] {
+        return std::any_of(_consumers.begin(), _consumers.end(), [](const ConsumerInfo& info) {
+            return info.stillInUse;
+        });
+    };
+
+    stdx::unique_lock<Latch> lk(_mutex);
+    interruptible->waitForConditionOrInterrupt(_producerCV, lk, [&] {
+        return !_abortStatus.isOK() || !anyConsumerInUse() ||
+            _bytesInSharedBatches < _bufferSizeBytes;
+    });
+    if (!_abortStatus.isOK() || !anyConsumerInUse()) {
+        return false;
+    }
+
+    _bytesInSharedBatches += bytes;
+    _sharedBatches.push_back(
+        std::make_shared<const SharedBatch>(SharedBatch{std::move(batch), bytes}));
+    _consumerCV.notify_all();
+    return true;
+}
+
+
+void TeeBuffer::abort(Status status) {
+    invariant(!status.isOK());
+    stdx::lock_guard<Latch> lk(_mutex);
+    if (_abortStatus.isOK()) {
+        _abortStatus = std::move(status);
+    }
+    _producerCV.notify_all();
+    _consumerCV.notify_all();
+}
+
+DocumentSource::GetNextResult TeeBuffer::getNextConcurrent(size_t consumerId) {
+    auto& consumer = _consumers[consumerId];
+    if (consumer.batch && consumer.positionInBatch < consumer.batch->docs.size()) {
+        return Document{consumer.batch->docs[consumer.positionInBatch++]};
+    }
+
+    stdx::unique_lock<Latch> lk(_mutex);
+    if (!consumer.stillInUse) {
+        return DocumentSource::GetNextResult::makeEOF();
+    }
+    if (consumer.batch) {
+        consumer.batch.reset();
+        ++consumer.nBatchesRead;
+        releaseReadBatches(lk);
+    }
+
+    auto nextBatchPublished = [&] {
+        return consumer.nBatchesRead < _firstBatchNumber + _sharedBatches.size();
+    };
+    _consumerCV.wait(
+        lk, [&] { return !_abortStatus.isOK() || _inputExhausted || nextBatchPublished(); });
+    uassertStatusOK(_abortStatus);
+    if (!nextBatchPublished()) {
+        return DocumentSource::GetNextResult::makeEOF();
+    }
+
+    consumer.batch = _sharedBatches[consumer.nBatchesRead - _firstBatchNumber];
+    consumer.positionInBatch = 0;
+    return Document{consumer.batch->docs[consumer.positionInBatch++]};
+}
+
+void TeeBuffer::releaseReadBatches(WithLock) {
+    auto nBatchesReadByAll = std::numeric_limits<uint64_t>::max();
+    for (auto&& consumer : _consumers) {
+        if (consumer.stillInUse) {
+            nBatchesReadByAll = std::min(nBatchesReadByAll, consumer.nBatchesRead);
+        }
+    }
+
+    bool released = false;
+    while (!_sharedBatches.empty() && _firstBatchNumber < nBatchesReadByAll) {
+        _bytesInSharedBatches -= _sharedBatches.front()->bytes;
+        _sharedBatches.pop_front();
+        ++_firstBatchNumber;
+        released = true;
+    }
+    if (released || nBatchesReadByAll == std::numeric_limits<uint64_t>::max()) {
+        _producerCV.notify_all();
+    }
+}
+
 }  // namespace mongo
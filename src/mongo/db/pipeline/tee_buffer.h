@@ -31,11 +31,17 @@
 
 #include <algorithm>
 #include <boost/intrusive_ptr.hpp>
+#include <deque>
+#include <memory>
 #include <vector>
 
 #include "mongo/db/exec/document_value/document.h"
 #include "mongo/db/pipeline/document_source.h"
 #include "mongo/db/query/query_knobs_gen.h"
+#include "mongo/platform/mutex.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/util/concurrency/with_lock.h"
+#include "mongo/util/interruptible.h"
 #include "mongo/util/intrusive_counter.h"
 
 namespace mongo {
@@ -45,6 +51,11 @@ namespace mongo {
  * do so, it will batch incoming documents and allow each consumer to consume one batch at a time.
  * As a consequence, consumers must be able to pause their execution to allow other consumers to
  * process the batch before moving to the next batch.
+ *
+ * In concurrent mode, the consumers instead run on their own threads. The input is pushed into the
+ * buffer by a single producer thread, in immutable batches which all the consumers share. Each
+ * consumer reads the batches at its own pace, and the producer blocks while the batches which some
+ * consumer has not finished reading hold more than the buffer size.
  */
 class TeeBuffer : public RefCountable {
 public:
@@ -59,11 +70,59 @@ public:
         _source = source;
     }
 
+    /**
+     * Switches this buffer to concurrent mode. Must be called before any consumer requests input.
+     */
+    void enableConcurrentConsumers() {
+        invariant(_buffer.empty());
+        _concurrent = true;
+    }
+
+    bool isConcurrent() const {
+        return _concurrent;
+    }
+
+    /**
+     * Concurrent mode only. Pulls the input from the source in batches of up to 'maxBatchSize'
+     * documents and publishes them to the consumers, until the input is exhausted or no consumer
+     * needs more of it. Blocks while the buffer is full.
+     */
+    void feedConsumers(Interruptible* interruptible, size_t maxBatchSize);
+
+    /**
+     * Concurrent mode only. Makes 'batch' available to all the consumers which are still in use.
+     * Blocks while the buffer is full. Returns false without publishing 'batch' if no consumer
+     * needs more input, or if the buffer has been aborted. This lets a producer which reads the
+     * input itself publish it, instead of calling feedConsumers().
+     */
+    bool publishBatch(Interruptible* interruptible, std::vector<Document> batch);
+
+    /**
+     * Concurrent mode only. Tells the consumers that no more batches will be published, so that
+     * they return EOF once they have read the published ones.
+     */
+    void endInput();
+
+    /**
+     * Concurrent mode only. Wakes up the producer and the consumers. Any consumer which requests
+     * more input afterwards fails with 'status'.
+     */
+    void abort(Status status);
+
     /**
      * Removes 'consumerId' as a consumer of this buffer. This is required to be called if a
      * consumer will not consume all input.
      */
     void dispose(size_t consumerId) {
+        if (_concurrent) {
+            // The source belongs to the producer thread, which stops once no consumer is left.
+            stdx::lock_guard<Latch> lk(_mutex);
+            _consumers[consumerId].stillInUse = false;
+            _consumers[consumerId].batch.reset();
+            releaseReadBatches(lk);
+            return;
+        }
+
         _consumers[consumerId].stillInUse = false;
         _consumers[consumerId].nLeftToReturn = 0;
         if (std::none_of(_consumers.begin(), _consumers.end(), [](const ConsumerInfo& info) {
@@ -93,15 +152,61 @@ private:
      */
     void loadNextBatch();
 
+    /**
+     * Implements getNext() in concurrent mode. Blocks until a new batch is published if
+     * 'consumerId' has read all published batches.
+     */
+    DocumentSource::GetNextResult getNextConcurrent(size_t consumerId);
+
+    /**
+     * Concurrent mode only. Releases the published batches which every consumer still in use has
+     * finished reading.
+     */
+    void releaseReadBatches(WithLock);
+
     DocumentSource* _source = nullptr;
 
     const size_t _bufferSizeBytes;
     std::vector<DocumentSource::GetNextResult> _buffer;
 
+    // An immutable batch of documents published in concurrent mode.
+    struct SharedBatch {
+        std::vector<Document> docs;
+        size_t bytes = 0;
+    };
+
     struct ConsumerInfo {
         bool stillInUse = true;
         int nLeftToReturn = 0;
+
+        // Concurrent mode only. The batch this consumer is reading, and the position of the next
+        // document to return from it. These are only accessed by the consumer's own thread.
+        std::shared_ptr<const SharedBatch> batch;
+        size_t positionInBatch = 0;
+
+        // Concurrent mode only. The number of published batches this consumer has finished.
+        uint64_t nBatchesRead = 0;
     };
     std::vector<ConsumerInfo> _consumers;
+
+    bool _concurrent = false;
+
+    // Guards the state below, which is used in concurrent mode only.
+    Mutex _mutex = MONGO_MAKE_LATCH("TeeBuffer::_mutex");
+
+    // Signalled when a published batch is released, or when a consumer is disposed.
+    stdx::condition_variable _producerCV;
+
+    // Signalled when a batch is published, or when the input is exhausted.
+    stdx::condition_variable _consumerCV;
+
+    // The published batches which some consumer has not finished yet, oldest first.
+    // '_firstBatchNumber' is the number of batches which were published before the first of them.
+    std::deque<std::shared_ptr<const SharedBatch>> _sharedBatches;
+    uint64_t _firstBatchNumber = 0;
+    size_t _bytesInSharedBatches = 0;
+
+    bool _inputExhausted = false;
+    Status _abortStatus = Status::OK();
 };
 }  // namespace mongo
@@ -35,6 +35,7 @@
 #include "mongo/db/exec/document_value/document_value_test_util.h"
 #include "mongo/db/pipeline/aggregation_context_fixture.h"
 #include "mongo/db/pipeline/document_source_mock.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/assert_util.h"
 
@@ -170,5 +171,76 @@ TEST_F(TeeBufferTest, ShouldAllowOtherConsumersToAdvanceOnceTrailingConsumerIsDi
     ASSERT_TRUE(teeBuffer->getNext(0).isEOF());
     ASSERT_TRUE(teeBuffer->getNext(0).isEOF());
 }
+
+TEST_F(TeeBufferTest, ConcurrentConsumersShouldEachSeeAllInputThroughASmallBuffer) {
+    const int nDocs = 100;
+    std::deque<DocumentSource::GetNextResult> inputs;
+    for (int i = 0; i < nDocs; ++i) {
+        inputs.emplace_back(Document{{"a", i}, {"b", Document{{"c", i}}}});
+    }
+    auto mock = DocumentSourceMock::createForTest(inputs, getExpCtx());
+
+    const size_t nConsumers = 3;
+    const size_t bufferBytes = 1;  // Every batch fills the buffer.
+    auto teeBuffer = TeeBuffer::create(nConsumers, bufferBytes);
+    teeBuffer->setSource(mock.get());
+    teeBuffer->enableConcurrentConsumers();
+
+    std::vector<std::vector<Document>> results(nConsumers);
+    std::vector<stdx::thread> consumers;
+    for (size_t consumerId = 0; consumerId < nConsumers; ++consumerId) {
+        consumers.emplace_back([&, consumerId] {
+            for (auto next = teeBuffer->getNext(consumerId); next.isAdvanced();
+                 next = teeBuffer->getNext(consumerId)) {
+                results[consumerId].push_back(next.releaseDocument());
+            }
+        });
+    }
+    teeBuffer->feedConsumers(getOpCtx(), 7);
+    for (auto&& consumer : consumers) {
+        consumer.join();
+    }
+
+    for (auto&& result : results) {
+        ASSERT_EQ(result.size(), static_cast<size_t>(nDocs));
+        for (int i = 0; i < nDocs; ++i) {
+            ASSERT_DOCUMENT_EQ(result[i], inputs[i].getDocument());
+        }
+    }
+}
+
+TEST_F(TeeBufferTest, ConcurrentProducerShouldStopOnceAllConsumersAreDisposed) {
+    std::deque<DocumentSource::GetNextResult> inputs{
+        Document{{"a", 1}}, Document{{"a", 2}}, Document{{"a", 3}}};
+    auto mock = DocumentSourceMock::createForTest(inputs, getExpCtx());
+
+    const size_t nConsumers = 2;
+    const size_t bufferBytes = 1;
+    auto teeBuffer = TeeBuffer::create(nConsumers, bufferBytes);
+    teeBuffer->setSource(mock.get());
+    teeBuffer->enableConcurrentConsumers();
+
+    stdx::thread consumer([&] {
+        // Consumer #0 reads one document, consumer #1 never reads.
+        ASSERT_TRUE(teeBuffer->getNext(0).isAdvanced());
+        teeBuffer->dispose(0);
+        teeBuffer->dispose(1);
+    });
+
+    // The producer would block on the full buffer if it waited for a disposed consumer.
+    teeBuffer->feedConsumers(getOpCtx(), 1);
+    consumer.join();
+    ASSERT_TRUE(teeBuffer->getNext(0).isEOF());
+}
+
+TEST_F(TeeBufferTest, ConcurrentConsumersShouldFailOnceAborted) {
+    auto mock = DocumentSourceMock::createForTest(getExpCtx());
+    auto teeBuffer = TeeBuffer::create(1);
+    teeBuffer->setSource(mock.get());
+    teeBuffer->enableConcurrentConsumers();
+
+    teeBuffer->abort({ErrorCodes::Interrupted, "test abort"});
+    ASSERT_THROWS_CODE(teeBuffer->getNext(0), AssertionException, ErrorCodes::Interrupted);
+}
 }  // namespace
 }  // namespace mongo
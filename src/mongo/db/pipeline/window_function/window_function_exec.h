@@ -31,6 +31,7 @@
 
 #include <queue>
 
+#include "mongo/db/pipeline/dependencies.h"
 #include "mongo/db/pipeline/document_source.h"
 #include "mongo/db/pipeline/document_source_set_window_fields.h"
 #include "mongo/db/pipeline/expression.h"
@@ -88,6 +89,11 @@ protected:
  * 'WindowFunctionState' parameter must expose an 'add()' and corresponding
  * 'getValue()' method to get the accumulation result. It must also expose a 'remove()' method to
  * remove a specific document from the calculation.
+ *
+ * The documents in the window are held by the PartitionIterator, which can spill them to disk, so
+ * the value of a document leaving the window is computed again rather than kept in memory. Only an
+ * 'input' which may evaluate differently each time, such as one using $rand, has its values
+ * buffered.
  */
 class WindowFunctionExecRemovable : public WindowFunctionExec {
 public:
@@ -110,30 +116,51 @@ protected:
                                 MemoryUsageTracker::PerFunctionMemoryTracker* memTracker)
         : WindowFunctionExec(PartitionAccessor(iter, policy), memTracker),
           _input(std::move(input)),
-          _function(std::move(function)) {}
+          _function(std::move(function)) {
+        DepsTracker deps;
+        _input->addDependencies(&deps);
+        _bufferValues = deps.needRandomGenerator;
+    }
+
+    Value evaluateInput(const Document& doc) {
+        return _input->evaluate(doc, &_input->getExpressionContext()->variables);
+    }
 
     void addValue(Value v) {
         long long prior = _function->getApproximateSize();
-        long long valueSize = v.getApproximateSize();
+        long long valueSize = 0;
         _function->add(v);
-        _values.push(v);
+        if (_bufferValues) {
+            valueSize = v.getApproximateSize();
+            _values.push(std::move(v));
+        }
         _memTracker->update(valueSize + static_cast<long long>(_function->getApproximateSize()) -
                             prior);
     }
 
-    void removeValue() {
-        tassert(5429400, "Tried to remove more values than we added", !_values.empty());
-        auto v = _values.front();
+    /**
+     * Removes 'doc', which is leaving the window, from the function. The document must have been
+     * added with addValue(evaluateInput(doc)), and windows must add and remove their documents in
+     * the same order.
+     */
+    void removeValue(const Document& doc) {
+        long long valueSize = 0;
+        Value v;
+        if (_bufferValues) {
+            tassert(5429400, "Tried to remove more values than we added", !_values.empty());
+            v = std::move(_values.front());
+            _values.pop();
+            valueSize = v.getApproximateSize();
+        } else {
+            v = evaluateInput(doc);
+        }
         long long prior = _function->getApproximateSize();
         _function->remove(v);
         _memTracker->update(static_cast<long long>(_function->getApproximateSize()) - prior -
-                            v.getApproximateSize());
-        _values.pop();
+                            valueSize);
     }
 
     boost::intrusive_ptr<Expression> _input;
-    // Keep track of values in the window function that will need to be removed later.
-    std::queue<Value> _values;
 
 private:
     /**
@@ -151,6 +178,11 @@ private:
     virtual void doReset() = 0;
 
     std::unique_ptr<WindowFunctionState> _function;
+
+    // Whether the values added to '_function' are kept in '_values' to be removed later, rather
+    // than being evaluated again.
+    bool _bufferValues = false;
+    std::queue<Value> _values;
 };
 
 }  // namespace mongo
@@ -40,10 +40,9 @@ WindowFunctionExecRemovableDocument::WindowFunctionExecRemovableDocument(
     WindowBounds::DocumentBased bounds,
     MemoryUsageTracker::PerFunctionMemoryTracker* memTracker)
     : WindowFunctionExecRemovable(iter,
-                                  PartitionAccessor::Policy::kDefaultSequential,
+                                  PartitionAccessor::Policy::kManual,
                                   std::move(input),
                                   std::move(function),
-
                                   memTracker) {
     stdx::visit(
         visit_helper::Overloaded{
@@ -76,11 +75,13 @@ void WindowFunctionExecRemovableDocument::initialize() {
     for (int i = lowerBoundForInit; !_upperBound || i <= _upperBound.get(); ++i) {
         // If this is false, we're over the end of the partition.
         if (auto doc = (this->_iter)[i]) {
-            addValue(_input->evaluate(*doc, &_input->getExpressionContext()->variables));
+            addValue(evaluateInput(*doc));
         } else {
             break;
         }
     }
+    // The documents in the window stay in the cache until they are removed from the window.
+    _iter.manualExpireUpTo(_lowerBound - 1);
     _initialized = true;
 }
 
@@ -94,17 +95,17 @@ void WindowFunctionExecRemovableDocument::update() {
     if (_upperBound) {
         // If this is false, we're over the end of the partition.
         if (auto doc = (this->_iter)[_upperBound.get()]) {
-            addValue(_input->evaluate(*doc, &_input->getExpressionContext()->variables));
+            addValue(evaluateInput(*doc));
         }
     }
 
-    // For a positive lower bound the first pass loads the correct window, so subsequent passes
-    // must always remove a document if there is a document left to remove.
-    // For a negative lower bound we can start removing every time only after we have seen
-    // documents to fill the left side of the window.
-    if (_lowerBound >= 0 || _iter.getCurrentPartitionIndex() > abs(_lowerBound)) {
-        removeFirstValueIfExists();
+    // The document just before the lower bound has left the window. For a positive lower bound it
+    // was part of the previous window if it exists in the partition. For a negative lower bound
+    // it does not exist until we have seen enough documents to fill the left side of the window.
+    if (auto doc = _iter[_lowerBound - 1]) {
+        removeValue(*doc);
     }
+    _iter.manualExpireUpTo(_lowerBound - 1);
 }
 
 }  // namespace mongo
@@ -65,13 +65,6 @@ private:
     }
 
 
-    void removeFirstValueIfExists() {
-        if (_values.size() == 0) {
-            return;
-        }
-        removeValue();
-    }
-
     // In one of two states: either the initial window has not been populated or we are sliding and
     // accumulating/removing values.
     bool _initialized = false;
@@ -105,13 +105,13 @@ void WindowFunctionExecRemovableRange::update() {
     if (added) {
         auto [lower, upper] = *added;
         for (auto i = lower; i <= upper; ++i) {
-            addValue(_input->evaluate(*_iter[i], &_input->getExpressionContext()->variables));
+            addValue(evaluateInput(*_iter[i]));
         }
     }
     if (removed) {
         auto [lower, upper] = *removed;
         for (auto i = lower; i <= upper; ++i) {
-            removeValue();
+            removeValue(*_iter[i]);
         }
     }
 
@@ -41,6 +41,7 @@
 #include "mongo/db/pipeline/window_function/window_function_exec_removable_document.h"
 #include "mongo/db/pipeline/window_function/window_function_integral.h"
 #include "mongo/db/pipeline/window_function/window_function_min_max.h"
+#include "mongo/db/pipeline/window_function/window_function_sum.h"
 #include "mongo/db/query/collation/collator_interface_mock.h"
 #include "mongo/unittest/unittest.h"
 
@@ -399,5 +400,63 @@ TEST_F(WindowFunctionExecRemovableDocumentTest, CanReceiveSortByExpression) {
     ASSERT_VALUE_EQ(Value(expectedIntegral), mgr.getNext());
 }
 
+TEST_F(WindowFunctionExecRemovableDocumentTest, SlidingWindowDoesNotBufferInputValues) {
+    const int nDocs = 200;
+    std::deque<DocumentSource::GetNextResult> docs;
+    for (int i = 0; i < nDocs; ++i) {
+        docs.push_back(Document{{"a", i}});
+    }
+    auto docSource = DocumentSourceMock::createForTest(std::move(docs), getExpCtx());
+    auto iter = std::make_unique<PartitionIterator>(
+        getExpCtx().get(), docSource.get(), &_tracker, boost::none, boost::none);
+    auto input =
+        ExpressionFieldPath::parse(getExpCtx().get(), "$a", getExpCtx()->variablesParseState);
+    auto mgr = WindowFunctionExecRemovableDocument(iter.get(),
+                                                   std::move(input),
+                                                   WindowFunctionSum::create(getExpCtx().get()),
+                                                   WindowBounds::DocumentBased{-50, 0},
+                                                   &_tracker["output"]);
+
+    // The values leaving the window are evaluated again from the documents in the partition, so
+    // the memory used by the executor does not grow with the size of the window.
+    ASSERT_VALUE_EQ(Value(0), mgr.getNext());
+    auto initialMemory = _tracker["output"].currentMemoryBytes();
+    for (int i = 1; i < nDocs; ++i) {
+        iter->advance();
+        int lower = std::max(0, i - 50);
+        ASSERT_VALUE_EQ(Value((i * (i + 1) - (lower - 1) * lower) / 2), mgr.getNext());
+        ASSERT_EQ(initialMemory, _tracker["output"].currentMemoryBytes());
+    }
+}
+
+TEST_F(WindowFunctionExecRemovableDocumentTest, NonDeterministicInputIsBuffered) {
+    const auto docs = std::deque<DocumentSource::GetNextResult>{
+        Document{{"a", 1}}, Document{{"a", 2}}, Document{{"a", 3}}, Document{{"a", 4}}};
+    auto docSource = DocumentSourceMock::createForTest(std::move(docs), getExpCtx());
+    auto iter = std::make_unique<PartitionIterator>(
+        getExpCtx().get(), docSource.get(), &_tracker, boost::none, boost::none);
+    // Evaluating the input again would give a different value, so the executor must keep the values
+    // it added to be able to remove them.
+    auto input = Expression::parseExpression(getExpCtx().get(),
+                                             fromjson("{$add: ['$a', {$rand: {}}]}"),
+                                             getExpCtx()->variablesParseState);
+    auto mgr = WindowFunctionExecRemovableDocument(iter.get(),
+                                                   std::move(input),
+                                                   WindowFunctionSum::create(getExpCtx().get()),
+                                                   WindowBounds::DocumentBased{-1, 0},
+                                                   &_tracker["output"]);
+    auto first = mgr.getNext().coerceToDouble();
+    ASSERT_GTE(first, 1);
+    ASSERT_LT(first, 2);
+    auto initialMemory = _tracker["output"].currentMemoryBytes();
+    for (int a = 2; a <= 4; ++a) {
+        iter->advance();
+        auto sum = mgr.getNext().coerceToDouble();
+        ASSERT_GTE(sum, 2 * a - 1);
+        ASSERT_LT(sum, 2 * a + 1);
+        ASSERT_GT(_tracker["output"].currentMemoryBytes(), initialMemory);
+    }
+}
+
 }  // namespace
 }  // namespace mongo
@@ -31,6 +31,7 @@
 
 #include "mongo/db/commands/feature_compatibility_version_documentation.h"
 #include "mongo/db/pipeline/accumulation_statement.h"
+#include "mongo/db/pipeline/accumulator_approx.h"
 #include "mongo/db/pipeline/document_source_add_fields.h"
 #include "mongo/db/pipeline/document_source_project.h"
 #include "mongo/db/pipeline/document_source_set_window_fields.h"
@@ -400,6 +401,65 @@ boost::intrusive_ptr<Expression> ExpressionN<WindowFunctionN, AccumulatorNType>:
         std::move(innerSortPattern));
 }
 
+boost::intrusive_ptr<Expression> ExpressionPercentileApprox::parse(
+    BSONObj obj, const boost::optional<SortPattern>& sortBy, ExpressionContext* expCtx) {
+    // 'obj' is something like '{$percentileApprox: {input: <arg>, p: [...]}, window: {...}}'
+    boost::optional<StringData> accumulatorName;
+    boost::intrusive_ptr<::mongo::Expression> input;
+    std::vector<double> percentiles;
+    WindowBounds bounds = WindowBounds::defaultBounds();
+    for (const auto& arg : obj) {
+        auto argName = arg.fieldNameStringData();
+        if (argName == kWindowArg) {
+            uassert(ErrorCodes::FailedToParse,
+                    "'window' field must be an object",
+                    arg.type() == BSONType::Object);
+            bounds = WindowBounds::parse(arg.embeddedObject(), sortBy, expCtx);
+        } else if (argName == AccumulatorPercentileApprox::kName) {
+            accumulatorName = argName;
+            std::tie(input, percentiles) =
+                AccumulatorPercentileApprox::parseArgs(expCtx, arg, expCtx->variablesParseState);
+        } else {
+            uasserted(ErrorCodes::FailedToParse,
+                      str::stream() << "Window function found an unknown argument: " << argName);
+        }
+    }
+
+    uassert(ErrorCodes::FailedToParse,
+            "Must specify a window function in output field",
+            accumulatorName);
+    return make_intrusive<ExpressionPercentileApprox>(expCtx,
+                                                      accumulatorName->toString(),
+                                                      std::move(input),
+                                                      std::move(bounds),
+                                                      std::move(percentiles));
+}
+
+Value ExpressionPercentileApprox::serialize(
+    boost::optional<ExplainOptions::Verbosity> explain) const {
+    MutableDocument result;
+    result[_accumulatorName] = Value(
+        DOC(AccumulatorPercentileApprox::kFieldNameInput
+            << _input->serialize(static_cast<bool>(explain))
+            << AccumulatorPercentileApprox::kFieldNameP
+            << AccumulatorPercentileApprox::serializePercentiles(_percentiles)));
+
+    MutableDocument windowField;
+    _bounds.serialize(windowField);
+    result[kWindowArg] = windowField.freezeToValue();
+    return result.freezeToValue();
+}
+
+boost::intrusive_ptr<AccumulatorState> ExpressionPercentileApprox::buildAccumulatorOnly() const {
+    return AccumulatorPercentileApprox::create(_expCtx, _percentiles);
+}
+
+std::unique_ptr<WindowFunctionState> ExpressionPercentileApprox::buildRemovable() const {
+    uasserted(7132207,
+              str::stream() << "Window function " << _accumulatorName
+                            << " is not supported with a removable window");
+}
+
 MONGO_INITIALIZER_GROUP(BeginWindowFunctionRegistration,
                         ("default"),
                         ("EndWindowFunctionRegistration"))
@@ -902,4 +902,33 @@ public:
     boost::intrusive_ptr<::mongo::Expression> nExpr;
     boost::optional<SortPattern> sortPattern;
 };
+
+/**
+ * Describes the $percentileApprox window function, which has the same {input: ..., p: [...]}
+ * argument as the accumulator. The t-digest cannot forget values, so it is only supported with
+ * left-unbounded windows.
+ */
+class ExpressionPercentileApprox : public Expression {
+public:
+    static boost::intrusive_ptr<Expression> parse(BSONObj obj,
+                                                  const boost::optional<SortPattern>& sortBy,
+                                                  ExpressionContext* expCtx);
+
+    ExpressionPercentileApprox(ExpressionContext* expCtx,
+                               std::string accumulatorName,
+                               boost::intrusive_ptr<::mongo::Expression> input,
+                               WindowBounds bounds,
+                               std::vector<double> percentiles)
+        : Expression(expCtx, std::move(accumulatorName), std::move(input), std::move(bounds)),
+          _percentiles(std::move(percentiles)) {}
+
+    Value serialize(boost::optional<ExplainOptions::Verbosity> explain) const final;
+
+    boost::intrusive_ptr<AccumulatorState> buildAccumulatorOnly() const final;
+
+    std::unique_ptr<WindowFunctionState> buildRemovable() const final;
+
+private:
+    std::vector<double> _percentiles;
+};
 }  // namespace mongo::window_function
@@ -0,0 +1,627 @@
+/**
+ *    Copyright (C) 2022-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#define MONGO_LOGV2_DEFAULT_COMPONENT ::mongo::logv2::LogComponent::kQuery
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/plan_cache_persistence.h"
+
+#include "mongo/db/auth/authorization_session.h"
+#include "mongo/db/catalog/collection_catalog.h"
+#include "mongo/db/catalog/index_catalog.h"
+#include "mongo/db/client.h"
+#include "mongo/db/db_raii.h"
+#include "mongo/db/dbdirectclient.h"
+#include "mongo/db/exec/plan_cache_util.h"
+#include "mongo/db/index/index_descriptor.h"
+#include "mongo/db/matcher/extensions_callback_real.h"
+#include "mongo/db/namespace_string.h"
+#include "mongo/db/query/canonical_query.h"
+#include "mongo/db/query/collection_query_info.h"
+#include "mongo/db/query/get_executor.h"
+#include "mongo/db/query/plan_cache_key_factory.h"
+#include "mongo/db/query/query_knobs_gen.h"
+#include "mongo/db/query/query_planner.h"
+#include "mongo/db/query/sbe_utils.h"
+#include "mongo/db/repl/replication_coordinator.h"
+#include "mongo/db/service_context.h"
+#include "mongo/logv2/log.h"
+#include "mongo/platform/mutex.h"
+#include "mongo/rpc/get_status_from_command_result.h"
+#include "mongo/util/hex.h"
+#include "mongo/util/md5.hpp"
+#include "mongo/util/periodic_runner.h"
+
+namespace mongo::plan_cache_persistence {
+namespace {
+const NamespaceString kPlanCacheSnapshotNamespace(NamespaceString::kConfigDb, "planCacheSnapshot");
+
+constexpr Milliseconds kPlanCachePersistencePeriod{1000};
+
+constexpr StringData kIdFieldName = "_id"_sd;
+constexpr StringData kCollectionUuidFieldName = "collectionUUID"_sd;
+constexpr StringData kPlanCacheKeyFieldName = "planCacheKey"_sd;
+constexpr StringData kNsFieldName = "ns"_sd;
+constexpr StringData kQueryHashFieldName = "queryHash"_sd;
+constexpr StringData kFilterFieldName = "filter"_sd;
+constexpr StringData kSortFieldName = "sort"_sd;
+constexpr StringData kProjectionFieldName = "projection"_sd;
+constexpr StringData kCollationFieldName = "collation"_sd;
+constexpr StringData kSolutionHashFieldName = "solutionHash"_sd;
+constexpr StringData kIndexesFieldName = "indexes"_sd;
+constexpr StringData kIndexNameFieldName = "name"_sd;
+constexpr StringData kKeyPatternFieldName = "keyPattern"_sd;
+constexpr StringData kWorksFieldName = "works"_sd;
+constexpr StringData kTimeOfCreationFieldName = "timeOfCreation"_sd;
+
+const std::string kCollectionUuidPath = "_id.collectionUUID";
+
+/**
+ * The state of the persistence job. Apart from the anchor, which is protected by the mutex, the
+ * state is only accessed by the job.
+ */
+struct PersistenceState {
+    Mutex mutex = MONGO_MAKE_LATCH("PlanCachePersistenceState::mutex");
+
+    // Whether the plan caches have been prewarmed since the node started serving reads.
+    bool prewarmed = false;
+
+    // Whether the node was writable the last time the job ran.
+    bool wasWritable = false;
+
+    // When the plan caches were last saved.
+    Date_t lastSnapshot;
+
+    boost::optional<PeriodicJobAnchor> anchor;
+};
+
+const auto getPersistenceState = ServiceContext::declareDecoration<PersistenceState>();
+
+/**
+ * Returns a hash identifying the plan cached for an entry. The planner produces the same cache
+ * data for a query shape as long as the indexes it can use are unchanged.
+ */
+std::string hashSolution(const SolutionCacheData& cacheData) {
+    return md5simpledigest(cacheData.toString());
+}
+
+void collectIndexNames(const PlanCacheIndexTree& tree, std::set<std::string>* indexNames) {
+    if (tree.entry) {
+        indexNames->insert(tree.entry->identifier.catalogName);
+    }
+    for (auto&& orPushdown : tree.orPushdowns) {
+        indexNames->insert(orPushdown.indexEntryId.catalogName);
+    }
+    for (auto&& child : tree.children) {
+        collectIndexNames(*child, indexNames);
+    }
+}
+
+/**
+ * Appends a placeholder of the same BSON type in place of the literal 'value', so that the saved
+ * queries keep their shape without the values they were run with. The 'ordinal' makes the
+ * placeholders of the elements of an array distinct. Values which carry no data, like null or a
+ * boolean, are kept as they are. Returns false for a literal which has no placeholder.
+ */
+bool appendPlaceholder(BSONObjBuilder* builder,
+                       StringData fieldName,
+                       const BSONElement& value,
+                       int ordinal = 0) {
+    switch (value.type()) {
+        case NumberInt:
+            builder->append(fieldName, ordinal);
+            return true;
+        case NumberLong:
+            builder->append(fieldName, static_cast<long long>(ordinal));
+            return true;
+        case NumberDouble:
+            builder->append(fieldName, static_cast<double>(ordinal));
+            return true;
+        case NumberDecimal:
+            builder->append(fieldName, Decimal128(ordinal));
+            return true;
+        case String:
+            builder->append(fieldName, std::to_string(ordinal));
+            return true;
+        case Date:
+            builder->append(fieldName, Date_t::fromMillisSinceEpoch(ordinal));
+            return true;
+        case RegEx:
+            // The flags are part of the shape of the query.
+            builder->appendRegex(fieldName, ""_sd, value.regexFlags());
+            return ordinal == 0;
+        case Object:
+            builder->append(fieldName, BSONObj());
+            return ordinal == 0;
+        case Array:
+            builder->append(fieldName, BSONArray());
+            return ordinal == 0;
+        case jstNULL:
+        case Undefined:
+        case Bool:
+        case MinKey:
+        case MaxKey:
+            builder->append(value);
+            return true;
+        default:
+            return false;
+    }
+}
+
+bool appendPlaceholderArray(BSONObjBuilder* builder, const BSONElement& values) {
+    if (values.type() != Array) {
+        return appendPlaceholder(builder, values.fieldNameStringData(), values);
+    }
+    BSONObjBuilder placeholders(builder->subarrayStart(values.fieldNameStringData()));
+    int ordinal = 0;
+    for (auto&& value : values.Obj()) {
+        if (!appendPlaceholder(&placeholders, value.fieldNameStringData(), value, ++ordinal)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool appendFilterShape(BSONObjBuilder* builder, const BSONObj& filter);
+
+/**
+ * Appends the shape of the operators applied to a path, e.g. {$gt: 1, $lt: 5}.
+ */
+bool appendOperatorsShape(BSONObjBuilder* builder, const BSONObj& operators) {
+    for (auto&& op : operators) {
+        const auto name = op.fieldNameStringData();
+        if (name == "$eq"_sd || name == "$ne"_sd || name == "$gt"_sd || name == "$gte"_sd ||
+            name == "$lt"_sd || name == "$lte"_sd || name == "$regex"_sd || name == "$size"_sd) {
+            if (!appendPlaceholder(builder, name, op)) {
+                return false;
+            }
+        } else if (name == "$in"_sd || name == "$nin"_sd || name == "$all"_sd ||
+                   name == "$mod"_sd || name == "$bitsAllSet"_sd || name == "$bitsAllClear"_sd ||
+                   name == "$bitsAnySet"_sd || name == "$bitsAnyClear"_sd) {
+            if (!appendPlaceholderArray(builder, op)) {
+                return false;
+            }
+        } else if (name == "$exists"_sd || name == "$type"_sd || name == "$options"_sd) {
+            builder->append(op);
+        } else if (name == "$not"_sd && op.type() == Object) {
+            BSONObjBuilder notBuilder(builder->subobjStart(name));
+            if (!appendOperatorsShape(&notBuilder, op.Obj())) {
+                return false;
+            }
+        } else if (name == "$not"_sd) {
+            if (!appendPlaceholder(builder, name, op)) {
+                return false;
+            }
+        } else if (name == "$elemMatch"_sd && op.type() == Object) {
+            // The predicate applies either to the elements themselves or to their fields.
+            const auto predicate = op.Obj();
+            const auto firstName = predicate.firstElementFieldNameStringData();
+            const bool onElements = firstName.startsWith("$"_sd) && firstName != "$and"_sd &&
+                firstName != "$or"_sd && firstName != "$nor"_sd;
+            BSONObjBuilder elemMatchBuilder(builder->subobjStart(name));
+            if (!(onElements ? appendOperatorsShape(&elemMatchBuilder, predicate)
+                             : appendFilterShape(&elemMatchBuilder, predicate))) {
+                return false;
+            }
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Appends the shape of 'filter' with its literals replaced by placeholders. Returns false if the
+ * filter uses an operator whose arguments are not known to be placeholders, such as $expr or the
+ * geo operators.
+ */
+bool appendFilterShape(BSONObjBuilder* builder, const BSONObj& filter) {
+    for (auto&& elem : filter) {
+        const auto name = elem.fieldNameStringData();
+        if (name == "$and"_sd || name == "$or"_sd || name == "$nor"_sd) {
+            if (elem.type() != Array) {
+                return false;
+            }
+            BSONArrayBuilder children(builder->subarrayStart(name));
+            for (auto&& child : elem.Obj()) {
+                if (child.type() != Object) {
+                    return false;
+                }
+                BSONObjBuilder childBuilder(children.subobjStart());
+                if (!appendFilterShape(&childBuilder, child.Obj())) {
+                    return false;
+                }
+            }
+        } else if (name.startsWith("$"_sd)) {
+            return false;
+        } else if (elem.type() == Object &&
+                   elem.Obj().firstElementFieldNameStringData().startsWith("$"_sd)) {
+            BSONObjBuilder operators(builder->subobjStart(name));
+            if (!appendOperatorsShape(&operators, elem.Obj())) {
+                return false;
+            }
+        } else if (!appendPlaceholder(builder, name, elem)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Returns the shape of the given query filter, or boost::none if it has no known shape.
+ */
+boost::optional<BSONObj> makeFilterShape(const BSONObj& filter) {
+    BSONObjBuilder builder;
+    if (!appendFilterShape(&builder, filter)) {
+        return boost::none;
+    }
+    return builder.obj();
+}
+
+/**
+ * Returns true if 'projection' only includes or excludes fields, so it holds no literal values.
+ */
+bool isInclusionOrExclusionProjection(const BSONObj& projection) {
+    for (auto&& elem : projection) {
+        const bool isFlag =
+            elem.isBoolean() || (elem.isNumber() && (elem.number() == 0 || elem.number() == 1));
+        if (!isFlag) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool isWritable(OperationContext* opCtx) {
+    auto replCoord = repl::ReplicationCoordinator::get(opCtx);
+    return !replCoord->isReplEnabled() || replCoord->canAcceptNonLocalWrites();
+}
+
+bool isReadable(OperationContext* opCtx) {
+    auto replCoord = repl::ReplicationCoordinator::get(opCtx);
+    return !replCoord->isReplEnabled() || replCoord->getMemberState().readable();
+}
+
+/**
+ * Serializes up to 'limit' active entries of the classic plan cache of the given collection. Only
+ * the shape of the query an entry was created from is saved, as the saved entries are replicated,
+ * so the values of the query are replaced with placeholders. Entries whose debug info was stripped
+ * do not have the query they were created from, and entries whose query has no known shape cannot
+ * be saved.
+ */
+std::vector<BSONObj> makeSnapshotDocuments(OperationContext* opCtx,
+                                           const CollectionPtr& collection,
+                                           size_t limit) {
+    std::vector<BSONObj> docs;
+    auto entries = CollectionQueryInfo::get(collection).getPlanCache()->getAllEntries();
+    for (auto&& entry : entries) {
+        if (docs.size() >= limit) {
+            break;
+        }
+        if (!entry->isActive || entry->isPinned() || !entry->debugInfo) {
+            continue;
+        }
+
+        const auto& createdFromQuery = entry->debugInfo->createdFromQuery;
+        auto filterShape = makeFilterShape(createdFromQuery.filter);
+        if (!filterShape || !isInclusionOrExclusionProjection(createdFromQuery.projection)) {
+            continue;
+        }
+
+        std::set<std::string> indexNames;
+        if (entry->cachedPlan->tree) {
+            collectIndexNames(*entry->cachedPlan->tree, &indexNames);
+        }
+
+        BSONArrayBuilder indexes;
+        bool allIndexesFound = true;
+        for (auto&& indexName : indexNames) {
+            auto descriptor = collection->getIndexCatalog()->findIndexByName(opCtx, indexName);
+            if (!descriptor) {
+                allIndexesFound = false;
+                break;
+            }
+            indexes.append(BSON(kIndexNameFieldName << indexName << kKeyPatternFieldName
+                                                    << descriptor->keyPattern()));
+        }
+        if (!allIndexesFound) {
+            continue;
+        }
+
+        BSONObjBuilder doc;
+        {
+            BSONObjBuilder id(doc.subobjStart(kIdFieldName));
+            collection->uuid().appendToBuilder(&id, kCollectionUuidFieldName);
+            id.append(kPlanCacheKeyFieldName, zeroPaddedHex(entry->planCacheKey));
+        }
+        doc.append(kNsFieldName, collection->ns().ns());
+        doc.append(kQueryHashFieldName, zeroPaddedHex(entry->queryHash));
+        doc.append(kFilterFieldName, *filterShape);
+        doc.append(kSortFieldName, createdFromQuery.sort);
+        doc.append(kProjectionFieldName, createdFromQuery.projection);
+        doc.append(kCollationFieldName, createdFromQuery.collation);
+        doc.append(kSolutionHashFieldName, hashSolution(*entry->cachedPlan));
+        doc.append(kIndexesFieldName, indexes.arr());
+        doc.append(kWorksFieldName, static_cast<long long>(*entry->works));
+        doc.append(kTimeOfCreationFieldName, entry->timeOfCreation);
+        docs.push_back(doc.obj());
+    }
+    return docs;
+}
+
+void checkWriteStatus(const BSONObj& reply) {
+    uassertStatusOK(getStatusFromWriteCommandReply(reply));
+}
+
+/**
+ * Restores a single saved entry. Returns false if the entry is no longer valid for the current
+ * indexes of its collection, or if the plan cache already has an entry for its query shape.
+ */
+bool restoreEntry(OperationContext* opCtx, const BSONObj& doc) {
+    const auto id = doc[kIdFieldName].Obj();
+    const auto uuid = uassertStatusOK(UUID::parse(id[kCollectionUuidFieldName]));
+    const NamespaceString savedNss(doc[kNsFieldName].String());
+
+    // Throws NamespaceNotFound if the collection was dropped.
+    AutoGetCollectionForRead collection(opCtx,
+                                        NamespaceStringOrUUID(savedNss.db().toString(), uuid));
+    const auto nss = collection->ns();
+
+    for (auto&& index : doc[kIndexesFieldName].Obj()) {
+        auto descriptor = collection->getIndexCatalog()->findIndexByName(
+            opCtx, index[kIndexNameFieldName].String());
+        if (!descriptor ||
+            descriptor->keyPattern().woCompare(index[kKeyPatternFieldName].Obj()) != 0) {
+            return false;
+        }
+    }
+
+    auto findCommand = std::make_unique<FindCommandRequest>(nss);
+    findCommand->setFilter(doc[kFilterFieldName].Obj().getOwned());
+    findCommand->setSort(doc[kSortFieldName].Obj().getOwned());
+    findCommand->setProjection(doc[kProjectionFieldName].Obj().getOwned());
+    findCommand->setCollation(doc[kCollationFieldName].Obj().getOwned());
+    auto statusWithCQ =
+        CanonicalQuery::canonicalize(opCtx,
+                                     std::move(findCommand),
+                                     false /* explain */,
+                                     nullptr /* expCtx */,
+                                     ExtensionsCallbackReal(opCtx, &nss),
+                                     MatchExpressionParser::kAllowAllSpecialFeatures);
+    if (!statusWithCQ.isOK()) {
+        return false;
+    }
+    auto cq = std::move(statusWithCQ.getValue());
+    cq->setSbeCompatible(sbe::isQuerySbeCompatible(
+        &collection.getCollection(), cq.get(), QueryPlannerParams::DEFAULT));
+    if (!shouldCacheQuery(*cq)) {
+        return false;
+    }
+
+    // The plan cache key encodes which indexes the query can use, so a different key means that
+    // the indexes changed in a way the saved plan did not account for.
+    auto key = plan_cache_key_factory::make<PlanCacheKey>(*cq, collection.getCollection());
+    if (zeroPaddedHex(key.planCacheKeyHash()) != id[kPlanCacheKeyFieldName].String()) {
+        return false;
+    }
+
+    QueryPlannerParams plannerParams;
+    fillOutPlannerParams(opCtx, collection.getCollection(), cq.get(), &plannerParams);
+    auto statusWithSolutions = QueryPlanner::plan(*cq, plannerParams);
+    if (!statusWithSolutions.isOK()) {
+        return false;
+    }
+
+    const auto solutionHash = doc[kSolutionHashFieldName].String();
+    for (auto&& solution : statusWithSolutions.getValue()) {
+        if (!solution->cacheData || hashSolution(*solution->cacheData) != solutionHash) {
+            continue;
+        }
+
+        // The saved entry does not keep the ranking decision, only the number of works the
+        // winning plan needed, which the cached plan stage uses to decide when to replan.
+        auto decision = std::make_unique<plan_ranker::PlanRankingDecision>();
+        decision->stats = plan_ranker::StatsDetails{};
+        return CollectionQueryInfo::get(collection.getCollection())
+            .getPlanCache()
+            ->setActiveIfAbsent(key,
+                                solution->cacheData->clone(),
+                                doc[kWorksFieldName].safeNumberLong(),
+                                opCtx->getServiceContext()->getPreciseClockSource()->now(),
+                                plan_cache_util::buildDebugInfo(*cq, std::move(decision)));
+    }
+    return false;
+}
+
+void runPersistenceJob(Client* client) {
+    auto& state = getPersistenceState(client->getServiceContext());
+
+    AuthorizationSession::get(client)->grantInternalAuthorization(client);
+    {
+        stdx::lock_guard<Client> clientLock(*client);
+        client->setSystemOperationKillableByStepdown(clientLock);
+    }
+    auto opCtx = client->makeOperationContext();
+
+    try {
+        const bool writable = isWritable(opCtx.get());
+        if (internalQueryPlanCachePrewarmEnabled.load() && isReadable(opCtx.get()) &&
+            (!state.prewarmed || (writable && !state.wasWritable))) {
+            auto numRestored = prewarmPlanCaches(opCtx.get());
+            LOGV2(7132100, "Prewarmed the plan caches", "restoredEntries"_attr = numRestored);
+            state.prewarmed = true;
+        }
+        state.wasWritable = writable;
+
+        const auto now = opCtx->getServiceContext()->getFastClockSource()->now();
+        if (state.lastSnapshot == Date_t()) {
+            // Give the plan caches a full interval to fill up after startup.
+            state.lastSnapshot = now;
+        }
+        const auto interval = Seconds(internalQueryPlanCacheSnapshotIntervalSecs.load());
+        if (writable && interval > Seconds(0) && now - state.lastSnapshot >= interval) {
+            auto numSaved = snapshotPlanCaches(opCtx.get());
+            LOGV2_DEBUG(7132101, 1, "Saved the plan caches", "savedEntries"_attr = numSaved);
+            state.lastSnapshot = now;
+        }
+    } catch (const DBException& ex) {
+        LOGV2_DEBUG(7132102,
+                    1,
+                    "Plan cache persistence job failed, it will be retried",
+                    "error"_attr = ex.toStatus());
+    }
+}
+}  // namespace
+
+void startPlanCachePersistenceJob(ServiceContext* serviceContext) {
+    auto periodicRunner = serviceContext->getPeriodicRunner();
+    invariant(periodicRunner);
+
+    PeriodicRunner::PeriodicJob job(
+        "PlanCachePersistence", runPersistenceJob, kPlanCachePersistencePeriod);
+
+    auto& state = getPersistenceState(serviceContext);
+    stdx::lock_guard<Latch> lk(state.mutex);
+    invariant(!state.anchor);
+    state.anchor.emplace(periodicRunner->makeJob(std::move(job)));
+    state.anchor->start();
+}
+
+void snapshotPlanCachesForShutdown(ServiceContext* serviceContext) {
+    {
+        auto& state = getPersistenceState(serviceContext);
+        stdx::lock_guard<Latch> lk(state.mutex);
+        if (!state.anchor || internalQueryPlanCacheSnapshotIntervalSecs.load() == 0) {
+            return;
+        }
+        // Waits for a running job to finish, so that it cannot overwrite the snapshot below.
+        state.anchor->stop();
+    }
+
+    auto client = serviceContext->makeClient("PlanCachePersistenceShutdown");
+    AlternativeClientRegion acr(client);
+    AuthorizationSession::get(cc())->grantInternalAuthorization(&cc());
+    auto opCtx = cc().makeOperationContext();
+    try {
+        if (isWritable(opCtx.get())) {
+            auto numSaved = snapshotPlanCaches(opCtx.get());
+            LOGV2(7132103, "Saved the plan caches for shutdown", "savedEntries"_attr = numSaved);
+        }
+    } catch (const DBException& ex) {
+        LOGV2_WARNING(
+            7132104, "Failed to save the plan caches for shutdown", "error"_attr = ex.toStatus());
+    }
+}
+
+size_t snapshotPlanCaches(OperationContext* opCtx) {
+    const size_t maxEntries = internalQueryPlanCacheSnapshotMaxEntries.load();
+    DBDirectClient client(opCtx);
+    BSONArrayBuilder existingCollections;
+    size_t numSaved = 0;
+
+    auto catalog = CollectionCatalog::get(opCtx);
+    for (auto&& dbName : catalog->getAllDbNames()) {
+        if (dbName.dbName() == NamespaceString::kLocalDb ||
+            dbName.dbName() == NamespaceString::kConfigDb) {
+            continue;
+        }
+        for (auto&& uuid : catalog->getAllCollectionUUIDsFromDb(dbName)) {
+            uuid.appendToArrayBuilder(&existingCollections);
+            if (numSaved >= maxEntries) {
+                continue;
+            }
+
+            std::vector<BSONObj> docs;
+            try {
+                AutoGetCollectionForRead collection(opCtx,
+                                                    NamespaceStringOrUUID(dbName.fullName(), uuid));
+                docs = makeSnapshotDocuments(
+                    opCtx, collection.getCollection(), maxEntries - numSaved);
+            } catch (const ExceptionFor<ErrorCodes::NamespaceNotFound>&) {
+                // The collection was dropped concurrently.
+                continue;
+            }
+
+            // An empty plan cache, for example right after a restart, does not overwrite the
+            // entries saved earlier.
+            if (docs.empty()) {
+                continue;
+            }
+
+            BSONObjBuilder filter;
+            uuid.appendToBuilder(&filter, kCollectionUuidPath);
+            checkWriteStatus(client.removeAcknowledged(kPlanCacheSnapshotNamespace.ns(),
+                                                       filter.obj()));
+            checkWriteStatus(client.insertAcknowledged(kPlanCacheSnapshotNamespace.ns(), docs));
+            numSaved += docs.size();
+        }
+    }
+
+    checkWriteStatus(client.removeAcknowledged(
+        kPlanCacheSnapshotNamespace.ns(),
+        BSON(kCollectionUuidPath << BSON("$nin" << existingCollections.arr()))));
+    return numSaved;
+}
+
+size_t prewarmPlanCaches(OperationContext* opCtx) {
+    std::vector<BSONObj> docs;
+    {
+        DBDirectClient client(opCtx);
+        FindCommandRequest findRequest{kPlanCacheSnapshotNamespace};
+        findRequest.setLimit(internalQueryPlanCacheSnapshotMaxEntries.load());
+        auto cursor = client.find(std::move(findRequest),
+                                  ReadPreferenceSetting{ReadPreference::SecondaryPreferred});
+        while (cursor->more()) {
+            docs.push_back(cursor->nextSafe().getOwned());
+        }
+    }
+
+    size_t numRestored = 0;
+    for (auto&& doc : docs) {
+        try {
+            if (restoreEntry(opCtx, doc)) {
+                ++numRestored;
+            }
+        } catch (const DBException& ex) {
+            // Stop on interruption, but skip the entries of dropped collections and the entries
+            // which can no longer be parsed.
+            opCtx->checkForInterrupt();
+            LOGV2_DEBUG(7132105,
+                        2,
+                        "Skipping saved plan cache entry",
+                        "entry"_attr = doc[kIdFieldName],
+                        "error"_attr = ex.toStatus());
+        }
+    }
+    return numRestored;
+}
+
+}  // namespace mongo::plan_cache_persistence
@@ -0,0 +1,74 @@
+/**
+ *    Copyright (C) 2022-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include <cstddef>
+
+namespace mongo {
+
+class OperationContext;
+class ServiceContext;
+
+namespace plan_cache_persistence {
+
+/**
+ * Starts the periodic job which persists the classic plan caches across restarts and elections:
+ *  - Every 'internalQueryPlanCacheSnapshotIntervalSecs', a writable node saves the active entries
+ *    of its classic plan caches to the replicated 'config.planCacheSnapshot' collection. Only the
+ *    shapes of the queries are saved, without the values they were run with.
+ *  - Once a node can serve reads, and again whenever it becomes primary, it loads the saved
+ *    entries into its plan caches, so that the queries it serves next are not all multi-planned.
+ */
+void startPlanCachePersistenceJob(ServiceContext* serviceContext);
+
+/**
+ * Saves the active entries of the classic plan caches at clean shutdown, if saving is enabled and
+ * the node is still writable. Must be called before the node steps down for shutdown.
+ */
+void snapshotPlanCachesForShutdown(ServiceContext* serviceContext);
+
+/**
+ * Replaces the saved entries of every collection which has active classic plan cache entries with
+ * its current entries, and removes the saved entries of collections which no longer exist. Returns
+ * the number of saved entries.
+ */
+size_t snapshotPlanCaches(OperationContext* opCtx);
+
+/**
+ * Adds the saved entries to the classic plan caches. An entry is only restored if the indexes used
+ * by its plan still exist with the same key patterns, the query still has the same plan cache key,
+ * and the planner still generates the saved plan. Entries already present in a plan cache are left
+ * untouched. Returns the number of restored entries.
+ */
+size_t prewarmPlanCaches(OperationContext* opCtx);
+
+}  // namespace plan_cache_persistence
+}  // namespace mongo
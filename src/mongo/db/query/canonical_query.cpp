@@ -286,6 +286,12 @@ void CanonicalQuery::initSortPattern(QueryMetadataBitSet unavailableMetadata) {
     }
 }
 
+void CanonicalQuery::parameterize() {
+    if (!_parameterized) {
+        _parameterized = MatchExpression::parameterize(_root.get());
+    }
+}
+
 void CanonicalQuery::setCollator(std::unique_ptr<CollatorInterface> collator) {
     auto collatorRaw = collator.get();
     // We must give the ExpressionContext the same collator.
@@ -237,6 +237,13 @@ public:
         return _parameterized;
     }
 
+    /**
+     * Adds parameter markers to the appropriate match expression leaf nodes, unless the query has
+     * already been parameterized. Used by the classic engine, which does not parameterize queries
+     * up front.
+     */
+    void parameterize();
+
     void setExplain(bool explain) {
         _explain = explain;
     }
@@ -701,6 +701,17 @@ public:
         encodeFull(expr);
     }
 
+    /**
+     * Geo predicates are not parameterized. SBE does not support them, but the classic plan cache
+     * uses this encoding to identify the shape of parameterized geo queries.
+     */
+    void visit(const GeoMatchExpression* expr) final {
+        encodeRhs(expr);
+    }
+    void visit(const GeoNearMatchExpression* expr) final {
+        encodeRhs(expr);
+    }
+
     void visit(const EqualityMatchExpression* expr) final {
         encodeSingleParamPathNode(expr);
     }
@@ -806,12 +817,6 @@ public:
     void visit(const ElemMatchValueMatchExpression* matchExpr) final {
         MONGO_UNREACHABLE_TASSERT(6142110);
     }
-    void visit(const GeoMatchExpression* expr) final {
-        MONGO_UNREACHABLE_TASSERT(6142111);
-    }
-    void visit(const GeoNearMatchExpression* expr) final {
-        MONGO_UNREACHABLE_TASSERT(6142112);
-    }
     void visit(const InternalBucketGeoWithinMatchExpression* expr) final {
         // This is only used for time-series collections, but SBE isn't yet used for querying
         // time-series collections.
@@ -1030,7 +1035,8 @@ private:
  * following property: Two match expression trees which are identical after auto-parameterization
  * have the same key, otherwise the keys must differ.
  */
-void encodeKeyForAutoParameterizedMatchSBE(MatchExpression* matchExpr, BufBuilder* builder) {
+void encodeKeyForAutoParameterizedMatchSBE(const MatchExpression* matchExpr,
+                                           BufBuilder* builder) {
     MatchExpressionSbePlanCacheKeySerializationWalker walker{builder};
     tree_walker::walk<true, MatchExpression>(matchExpr, &walker);
 }
@@ -1078,6 +1084,12 @@ std::string encodeSBE(const CanonicalQuery& cq) {
     return base64::encode(StringData(bufBuilder.buf(), bufBuilder.len()));
 }
 
+std::string encodeParameterizedMatch(const MatchExpression* root) {
+    BufBuilder bufBuilder;
+    encodeKeyForAutoParameterizedMatchSBE(root, &bufBuilder);
+    return std::string(bufBuilder.buf(), bufBuilder.len());
+}
+
 CanonicalQuery::QueryShapeString encodeForIndexFilters(const CanonicalQuery& cq) {
     StringBuilder keyBuilder;
     encodeKeyForMatch(cq.root(), &keyBuilder);
@@ -57,6 +57,15 @@ CanonicalQuery::QueryShapeString encode(const CanonicalQuery& cq);
  */
 CanonicalQuery::QueryShapeString encodeSBE(const CanonicalQuery& cq);
 
+/**
+ * Encode the given match expression in the same manner as the match expression part of the SBE
+ * plan cache key: the constants of the auto-parameterized predicates are replaced by parameter
+ * markers, and all other constants are encoded verbatim. Two parameterized match expressions with
+ * the same encoding only differ by the values of their parameters. Geo predicates, which SBE does
+ * not support, are encoded verbatim.
+ */
+std::string encodeParameterizedMatch(const MatchExpression* root);
+
 /**
  * Encode the given CanonicalQuery into a string representation which represents the shape of the
  * query for matching the query against index filters. This is done by encoding the match,
@@ -0,0 +1,242 @@
+/**
+ *    Copyright (C) 2022-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/db/query/ce/ce_histogram.h"
+
+#include "mongo/db/exec/sbe/values/bson.h"
+#include "mongo/db/query/optimizer/cascades/ce_heuristic.h"
+#include "mongo/db/query/optimizer/utils/memo_utils.h"
+
+namespace mongo::optimizer::cascades {
+
+using namespace properties;
+
+namespace {
+// The selectivity the heuristic estimator assigns to each predicate.
+constexpr SelectivityType kDefaultFilterSelectivity = 0.1;
+
+/**
+ * Returns the dotted field path matched by 'path', if it is only made of Get and Traverse elements.
+ */
+boost::optional<std::string> getFieldPath(const ABT& path) {
+    std::string result;
+    ABT::reference_type ref = path.ref();
+    while (true) {
+        if (auto get = ref.cast<PathGet>(); get != nullptr) {
+            if (!result.empty()) {
+                result += '.';
+            }
+            result += get->name();
+            ref = get->getPath().ref();
+        } else if (auto traverse = ref.cast<PathTraverse>(); traverse != nullptr) {
+            ref = traverse->getPath().ref();
+        } else if (ref.is<PathIdentity>() && !result.empty()) {
+            return result;
+        } else {
+            return {};
+        }
+    }
+}
+
+/**
+ * Converts a constant interval bound to BSON, stored in 'holder'. Returns boost::none for an
+ * infinite bound. Sets 'supported' to false if the bound is not a constant.
+ */
+boost::optional<BSONElement> getBound(const BoundRequirement& bound,
+                                      bool isLow,
+                                      BSONObj& holder,
+                                      bool& supported) {
+    if (bound.isInfinite()) {
+        return {};
+    }
+
+    auto constant = bound.getBound().cast<Constant>();
+    if (!constant) {
+        supported = false;
+        return {};
+    }
+
+    const auto [tag, val] = constant->get();
+    if ((isLow && tag == sbe::value::TypeTags::MinKey) ||
+        (!isLow && tag == sbe::value::TypeTags::MaxKey)) {
+        return {};
+    }
+
+    BSONObjBuilder builder;
+    sbe::bson::appendValueToBsonObj(builder, ""_sd, tag, val);
+    holder = builder.obj();
+    if (holder.isEmpty()) {
+        supported = false;
+        return {};
+    }
+    return holder.firstElement();
+}
+
+/**
+ * Estimates the selectivity of 'intervals' using the statistics of their path. Conjunctions are
+ * assumed to be independent and disjunctions disjoint. Returns boost::none if an interval has a
+ * bound which is not a constant.
+ */
+boost::optional<SelectivityType> estimateIntervals(const ce::PathStatistics& stats,
+                                                   const IntervalReqExpr::Node& intervals) {
+    if (auto disjunction = intervals.cast<IntervalReqExpr::Disjunction>()) {
+        SelectivityType result = 0.0;
+        for (const auto& child : disjunction->nodes()) {
+            auto childSelectivity = estimateIntervals(stats, child);
+            if (!childSelectivity) {
+                return {};
+            }
+            result += *childSelectivity;
+        }
+        return std::min(result, 1.0);
+    } else if (auto conjunction = intervals.cast<IntervalReqExpr::Conjunction>()) {
+        SelectivityType result = 1.0;
+        for (const auto& child : conjunction->nodes()) {
+            auto childSelectivity = estimateIntervals(stats, child);
+            if (!childSelectivity) {
+                return {};
+            }
+            result *= *childSelectivity;
+        }
+        return result;
+    }
+
+    const auto& interval = intervals.cast<IntervalReqExpr::Atom>()->getExpr();
+    const auto& lowBound = interval.getLowBound();
+    const auto& highBound = interval.getHighBound();
+
+    bool supported = true;
+    BSONObj lowHolder;
+    BSONObj highHolder;
+    auto low = getBound(lowBound, true /*isLow*/, lowHolder, supported);
+    auto high = getBound(highBound, false /*isLow*/, highHolder, supported);
+    if (!supported) {
+        return {};
+    }
+
+    const double count = stats.histogram.estimateInterval(
+        low, lowBound.isInclusive(), high, highBound.isInclusive());
+    return std::min(count / stats.numDocuments, 1.0);
+}
+}  // namespace
+
+class CEHistogramTransportImpl {
+public:
+    CEHistogramTransportImpl(std::string scanDefName,
+                             std::shared_ptr<const ce::CollectionStatistics> stats)
+        : _heuristicCE(), _scanDefName(std::move(scanDefName)), _stats(std::move(stats)) {}
+
+    CEType transport(const ABT& n,
+                     const SargableNode& node,
+                     const Memo& memo,
+                     const LogicalProps& logicalProps,
+                     CEType childResult,
+                     CEType /*bindsResult*/,
+                     CEType /*refsResult*/) {
+        if (!hasProperty<IndexingAvailability>(logicalProps)) {
+            return _heuristicCE.deriveCE(memo, logicalProps, n.ref());
+        }
+        const auto& indexingAvailability = getPropertyConst<IndexingAvailability>(logicalProps);
+        if (indexingAvailability.getScanDefName() != _scanDefName) {
+            return _heuristicCE.deriveCE(memo, logicalProps, n.ref());
+        }
+
+        CEType result = childResult;
+        for (const auto& [key, req] : node.getReqMap()) {
+            if (isIntervalReqFullyOpenDNF(req.getIntervals())) {
+                continue;
+            }
+
+            boost::optional<SelectivityType> selectivity;
+            if (key._projectionName == indexingAvailability.getScanProjection()) {
+                selectivity = estimateSelectivity(key._path, req.getIntervals());
+            }
+            // Assume independence.
+            result *= selectivity.value_or(kDefaultFilterSelectivity);
+        }
+
+        return result;
+    }
+
+    /**
+     * Other ABT types.
+     */
+    template <typename T, typename... Ts>
+    CEType transport(const ABT& n,
+                     const T& /*node*/,
+                     const Memo& memo,
+                     const LogicalProps& logicalProps,
+                     Ts&&...) {
+        if (canBeLogicalNode<T>()) {
+            return _heuristicCE.deriveCE(memo, logicalProps, n.ref());
+        }
+        return 0.0;
+    }
+
+    CEType derive(const Memo& memo,
+                  const LogicalProps& logicalProps,
+                  const ABT::reference_type logicalNodeRef) {
+        return algebra::transport<true>(logicalNodeRef, *this, memo, logicalProps);
+    }
+
+private:
+    boost::optional<SelectivityType> estimateSelectivity(const ABT& path,
+                                                         const IntervalReqExpr::Node& intervals) {
+        auto fieldPath = getFieldPath(path);
+        if (!fieldPath) {
+            return {};
+        }
+
+        auto stats = _stats->getPathStatistics(*fieldPath);
+        if (!stats || stats->numDocuments <= 0.0) {
+            return {};
+        }
+        return estimateIntervals(*stats, intervals);
+    }
+
+    HeuristicCE _heuristicCE;
+    const std::string _scanDefName;
+    const std::shared_ptr<const ce::CollectionStatistics> _stats;
+};
+
+CEHistogramTransport::CEHistogramTransport(std::string scanDefName,
+                                           std::shared_ptr<const ce::CollectionStatistics> stats)
+    : _impl(std::make_unique<CEHistogramTransportImpl>(std::move(scanDefName), std::move(stats))) {
+}
+
+CEHistogramTransport::~CEHistogramTransport() {}
+
+CEType CEHistogramTransport::deriveCE(const Memo& memo,
+                                      const LogicalProps& logicalProps,
+                                      const ABT::reference_type logicalNodeRef) const {
+    return _impl->derive(memo, logicalProps, logicalNodeRef);
+}
+
+}  // namespace mongo::optimizer::cascades
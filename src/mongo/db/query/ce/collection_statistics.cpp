@@ -0,0 +1,72 @@
+/**
+ *    Copyright (C) 2022-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query/ce/collection_statistics.h"
+
+#include "mongo/util/str.h"
+
+namespace mongo::ce {
+
+BSONObj CollectionStatistics::makeStatisticsDocument(StringData path,
+                                                     const PathStatistics& stats,
+                                                     Date_t lastUpdated) {
+    return BSON("_id" << path << kNumDocumentsFieldName << stats.numDocuments
+                      << kHistogramFieldName << stats.histogram.toBSON() << kLastUpdatedFieldName
+                      << lastUpdated);
+}
+
+const PathStatistics* CollectionStatistics::getPathStatistics(StringData path) const {
+    auto it = _paths.find(path);
+    return it != _paths.end() ? &it->second : nullptr;
+}
+
+void CollectionStatistics::addPathStatistics(std::string path, PathStatistics stats) {
+    _paths.insert_or_assign(std::move(path), std::move(stats));
+}
+
+Status CollectionStatistics::addStatisticsDocument(const BSONObj& doc) try {
+    auto path = doc["_id"];
+    auto numDocuments = doc[kNumDocumentsFieldName];
+    auto histogram = doc[kHistogramFieldName];
+    if (path.type() != String || !numDocuments.isNumber() || histogram.type() != Object) {
+        return Status(ErrorCodes::BadValue,
+                      str::stream() << "Invalid statistics document: " << doc.toString());
+    }
+
+    addPathStatistics(path.str(),
+                      PathStatistics{numDocuments.numberDouble(), Histogram::parse(histogram.Obj())});
+    return Status::OK();
+} catch (const DBException& ex) {
+    return ex.toStatus();
+}
+
+}  // namespace mongo::ce
@@ -0,0 +1,89 @@
+/**
+ *    Copyright (C) 2022-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include <map>
+#include <string>
+
+#include "mongo/base/status.h"
+#include "mongo/db/query/ce/histogram.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo::ce {
+
+/**
+ * The statistics of a single field path.
+ */
+struct PathStatistics {
+    // The number of documents in the collection, or in the sample, the histogram was built from.
+    double numDocuments;
+
+    // The values of the path in each document, with arrays unwound. Each distinct value is counted
+    // once per document.
+    Histogram histogram;
+};
+
+/**
+ * The statistics gathered by the 'analyze' command for the fields of a collection. They are stored
+ * in the '<db>.system.statistics.<collection>' collection, with one document per field path:
+ *   {_id: <path>, numDocuments: <n>, histogram: <histogram>, lastUpdated: <date>}
+ */
+class CollectionStatistics {
+public:
+    static constexpr StringData kNumDocumentsFieldName = "numDocuments"_sd;
+    static constexpr StringData kHistogramFieldName = "histogram"_sd;
+    static constexpr StringData kLastUpdatedFieldName = "lastUpdated"_sd;
+
+    static BSONObj makeStatisticsDocument(StringData path,
+                                          const PathStatistics& stats,
+                                          Date_t lastUpdated);
+
+    bool empty() const {
+        return _paths.empty();
+    }
+
+    /**
+     * Returns the statistics of 'path', or nullptr if 'path' was not analyzed.
+     */
+    const PathStatistics* getPathStatistics(StringData path) const;
+
+    void addPathStatistics(std::string path, PathStatistics stats);
+
+    /**
+     * Parses a document of the statistics collection and adds the statistics it holds.
+     */
+    Status addStatisticsDocument(const BSONObj& doc);
+
+private:
+    std::map<std::string, PathStatistics, std::less<>> _paths;
+};
+
+}  // namespace mongo::ce
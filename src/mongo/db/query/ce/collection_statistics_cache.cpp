@@ -0,0 +1,95 @@
+/**
+ *    Copyright (C) 2022-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query/ce/collection_statistics_cache.h"
+
+#include "mongo/db/service_context.h"
+
+namespace mongo::ce {
+namespace {
+
+const auto getCollectionStatisticsCache =
+    ServiceContext::declareDecoration<CollectionStatisticsCache>();
+
+}  // namespace
+
+CollectionStatisticsCache& CollectionStatisticsCache::get(ServiceContext* serviceContext) {
+    return getCollectionStatisticsCache(serviceContext);
+}
+
+std::shared_ptr<const CollectionStatistics> CollectionStatisticsCache::getOrLoad(
+    const NamespaceString& statsNss, const Loader& load) {
+    uint64_t generation;
+    {
+        stdx::lock_guard<Latch> lk(_mutex);
+        if (auto it = _entries.find(statsNss.ns()); it != _entries.end()) {
+            return it->second;
+        }
+        generation = _generation;
+    }
+
+    // Read the statistics without holding the mutex, as this reads a collection.
+    auto stats = std::make_shared<const CollectionStatistics>(load());
+
+    stdx::lock_guard<Latch> lk(_mutex);
+    if (_generation == generation) {
+        _entries.insert_or_assign(statsNss.ns(), stats);
+    }
+    return stats;
+}
+
+void CollectionStatisticsCache::invalidate(const NamespaceString& statsNss) {
+    stdx::lock_guard<Latch> lk(_mutex);
+    ++_generation;
+    _entries.erase(statsNss.ns());
+}
+
+void CollectionStatisticsCache::invalidateDatabase(StringData dbName) {
+    stdx::lock_guard<Latch> lk(_mutex);
+    ++_generation;
+    for (auto it = _entries.begin(); it != _entries.end();) {
+        if (nsToDatabaseSubstring(it->first) == dbName) {
+            _entries.erase(it++);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void CollectionStatisticsCache::invalidateAll() {
+    stdx::lock_guard<Latch> lk(_mutex);
+    ++_generation;
+    _entries.clear();
+}
+
+}  // namespace mongo::ce
@@ -0,0 +1,99 @@
+/**
+ *    Copyright (C) 2022-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include <functional>
+#include <memory>
+
+#include "mongo/db/namespace_string.h"
+#include "mongo/db/query/ce/collection_statistics.h"
+#include "mongo/platform/mutex.h"
+#include "mongo/util/string_map.h"
+
+namespace mongo {
+
+class ServiceContext;
+
+namespace ce {
+
+/**
+ * Caches the statistics parsed from the '<db>.system.statistics.<collection>' collections, so that
+ * the optimizer does not read and parse them for every query. The statistics of a collection are
+ * dropped from the cache once a write to its statistics collection commits, including the writes
+ * made by the 'analyze' command. See CollectionStatisticsCacheOpObserver.
+ *
+ * Statistics loaded from a storage snapshot which was opened before a write committed may still be
+ * cached after that write, until the statistics collection is written again. The statistics are
+ * only used to estimate cardinalities, so this can affect the choice of plan but not the results.
+ */
+class CollectionStatisticsCache {
+public:
+    using Loader = std::function<CollectionStatistics()>;
+
+    static CollectionStatisticsCache& get(ServiceContext* serviceContext);
+
+    /**
+     * Returns the cached statistics stored in the collection 'statsNss', or reads them with 'load'
+     * and caches them. They are not cached if a statistics collection was written to while they
+     * were loaded.
+     */
+    std::shared_ptr<const CollectionStatistics> getOrLoad(const NamespaceString& statsNss,
+                                                          const Loader& load);
+
+    /**
+     * Drops the cached statistics stored in the collection 'statsNss'.
+     */
+    void invalidate(const NamespaceString& statsNss);
+
+    /**
+     * Drops the cached statistics of all of the collections of the database 'dbName'.
+     */
+    void invalidateDatabase(StringData dbName);
+
+    /**
+     * Drops all of the cached statistics.
+     */
+    void invalidateAll();
+
+private:
+    Mutex _mutex = MONGO_MAKE_LATCH("CollectionStatisticsCache::_mutex");
+
+    // Incremented by every invalidation, so that statistics loaded concurrently with a write to a
+    // statistics collection are not cached.
+    uint64_t _generation = 0;
+
+    // The cached statistics, keyed by the namespace of the statistics collection they were read
+    // from. Collections without statistics are cached as empty statistics.
+    StringMap<std::shared_ptr<const CollectionStatistics>> _entries;
+};
+
+}  // namespace ce
+}  // namespace mongo
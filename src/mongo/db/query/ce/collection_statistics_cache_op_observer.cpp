@@ -0,0 +1,141 @@
+/**
+ *    Copyright (C) 2022-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query/ce/collection_statistics_cache_op_observer.h"
+
+#include "mongo/db/concurrency/locker.h"
+#include "mongo/db/operation_context.h"
+#include "mongo/db/query/ce/collection_statistics_cache.h"
+
+namespace mongo::ce {
+namespace {
+
+/**
+ * Runs 'invalidate' on the statistics cache once the current write unit of work commits, so that
+ * the statistics read concurrently with the write are not cached after it.
+ */
+void invalidateOnCommit(OperationContext* opCtx,
+                        std::function<void(CollectionStatisticsCache&)> invalidate) {
+    auto onCommit = [serviceContext = opCtx->getServiceContext(),
+                     invalidate = std::move(invalidate)](boost::optional<Timestamp>) {
+        invalidate(CollectionStatisticsCache::get(serviceContext));
+    };
+
+    if (opCtx->lockState()->inAWriteUnitOfWork()) {
+        opCtx->recoveryUnit()->onCommit(std::move(onCommit));
+    } else {
+        onCommit(boost::none);
+    }
+}
+
+void invalidateIfStatisticsCollection(OperationContext* opCtx, const NamespaceString& nss) {
+    if (nss.isStatisticsCollection()) {
+        invalidateOnCommit(opCtx, [nss](CollectionStatisticsCache& cache) {
+            cache.invalidate(nss);
+        });
+    }
+}
+
+}  // namespace
+
+void CollectionStatisticsCacheOpObserver::onInserts(
+    OperationContext* opCtx,
+    const NamespaceString& nss,
+    const UUID& uuid,
+    std::vector<InsertStatement>::const_iterator begin,
+    std::vector<InsertStatement>::const_iterator end,
+    bool fromMigrate) {
+    invalidateIfStatisticsCollection(opCtx, nss);
+}
+
+void CollectionStatisticsCacheOpObserver::onUpdate(OperationContext* opCtx,
+                                                   const OplogUpdateEntryArgs& args) {
+    invalidateIfStatisticsCollection(opCtx, args.nss);
+}
+
+void CollectionStatisticsCacheOpObserver::onDelete(OperationContext* opCtx,
+                                                   const NamespaceString& nss,
+                                                   const UUID& uuid,
+                                                   StmtId stmtId,
+                                                   const OplogDeleteEntryArgs& args) {
+    invalidateIfStatisticsCollection(opCtx, nss);
+}
+
+void CollectionStatisticsCacheOpObserver::onImportCollection(OperationContext* opCtx,
+                                                             const UUID& importUUID,
+                                                             const NamespaceString& nss,
+                                                             long long numRecords,
+                                                             long long dataSize,
+                                                             const BSONObj& catalogEntry,
+                                                             const BSONObj& storageMetadata,
+                                                             bool isDryRun) {
+    if (!isDryRun) {
+        invalidateIfStatisticsCollection(opCtx, nss);
+    }
+}
+
+void CollectionStatisticsCacheOpObserver::onRenameCollection(
+    OperationContext* opCtx,
+    const NamespaceString& fromCollection,
+    const NamespaceString& toCollection,
+    const UUID& uuid,
+    const boost::optional<UUID>& dropTargetUUID,
+    std::uint64_t numRecords,
+    bool stayTemp) {
+    invalidateIfStatisticsCollection(opCtx, fromCollection);
+    invalidateIfStatisticsCollection(opCtx, toCollection);
+}
+
+void CollectionStatisticsCacheOpObserver::onDropDatabase(OperationContext* opCtx,
+                                                         const std::string& dbName) {
+    invalidateOnCommit(opCtx, [dbName](CollectionStatisticsCache& cache) {
+        cache.invalidateDatabase(dbName);
+    });
+}
+
+repl::OpTime CollectionStatisticsCacheOpObserver::onDropCollection(
+    OperationContext* opCtx,
+    const NamespaceString& collectionName,
+    const UUID& uuid,
+    std::uint64_t numRecords,
+    const CollectionDropType dropType) {
+    invalidateIfStatisticsCollection(opCtx, collectionName);
+    return {};
+}
+
+void CollectionStatisticsCacheOpObserver::_onReplicationRollback(
+    OperationContext* opCtx, const RollbackObserverInfo& rbInfo) {
+    CollectionStatisticsCache::get(opCtx->getServiceContext()).invalidateAll();
+}
+
+}  // namespace mongo::ce
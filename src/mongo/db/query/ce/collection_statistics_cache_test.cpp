@@ -0,0 +1,120 @@
+/**
+ *    Copyright (C) 2022-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query/ce/collection_statistics_cache.h"
+
+#include "mongo/unittest/unittest.h"
+
+namespace mongo::ce {
+namespace {
+
+const NamespaceString kStatsNss("test.system.statistics.coll");
+const NamespaceString kOtherStatsNss("other.system.statistics.coll");
+
+CollectionStatistics makeStatistics(int numDocuments) {
+    CollectionStatistics stats;
+    stats.addPathStatistics("a", PathStatistics{static_cast<double>(numDocuments), Histogram()});
+    return stats;
+}
+
+TEST(CollectionStatisticsCacheTest, LoadsStatisticsOnce) {
+    CollectionStatisticsCache cache;
+    int numLoads = 0;
+    auto load = [&] {
+        ++numLoads;
+        return makeStatistics(numLoads);
+    };
+
+    auto stats = cache.getOrLoad(kStatsNss, load);
+    ASSERT_EQ(1, numLoads);
+    ASSERT_EQ(1.0, stats->getPathStatistics("a")->numDocuments);
+    ASSERT_EQ(stats, cache.getOrLoad(kStatsNss, load));
+    ASSERT_EQ(1, numLoads);
+
+    // Collections without statistics are cached too.
+    auto empty = cache.getOrLoad(kOtherStatsNss, [] { return CollectionStatistics(); });
+    ASSERT_TRUE(empty->empty());
+    ASSERT_EQ(empty, cache.getOrLoad(kOtherStatsNss, load));
+    ASSERT_EQ(1, numLoads);
+}
+
+TEST(CollectionStatisticsCacheTest, InvalidationReloadsStatistics) {
+    CollectionStatisticsCache cache;
+    int numLoads = 0;
+    auto load = [&] {
+        ++numLoads;
+        return makeStatistics(numLoads);
+    };
+
+    cache.getOrLoad(kStatsNss, load);
+    cache.getOrLoad(kOtherStatsNss, load);
+    ASSERT_EQ(2, numLoads);
+
+    cache.invalidate(kStatsNss);
+    ASSERT_EQ(3.0, cache.getOrLoad(kStatsNss, load)->getPathStatistics("a")->numDocuments);
+    cache.getOrLoad(kOtherStatsNss, load);
+    ASSERT_EQ(3, numLoads);
+
+    cache.invalidateDatabase("other");
+    cache.getOrLoad(kStatsNss, load);
+    ASSERT_EQ(4.0, cache.getOrLoad(kOtherStatsNss, load)->getPathStatistics("a")->numDocuments);
+    ASSERT_EQ(4, numLoads);
+
+    cache.invalidateAll();
+    cache.getOrLoad(kStatsNss, load);
+    cache.getOrLoad(kOtherStatsNss, load);
+    ASSERT_EQ(6, numLoads);
+}
+
+TEST(CollectionStatisticsCacheTest, StatisticsLoadedDuringInvalidationAreNotCached) {
+    CollectionStatisticsCache cache;
+    int numLoads = 0;
+    auto load = [&] {
+        ++numLoads;
+        return makeStatistics(numLoads);
+    };
+
+    // A write to a statistics collection commits while the statistics are being loaded.
+    auto stats = cache.getOrLoad(kStatsNss, [&] {
+        cache.invalidate(kOtherStatsNss);
+        return load();
+    });
+    ASSERT_EQ(1.0, stats->getPathStatistics("a")->numDocuments);
+
+    ASSERT_EQ(2.0, cache.getOrLoad(kStatsNss, load)->getPathStatistics("a")->numDocuments);
+    ASSERT_EQ(2.0, cache.getOrLoad(kStatsNss, load)->getPathStatistics("a")->numDocuments);
+    ASSERT_EQ(2, numLoads);
+}
+
+}  // namespace
+}  // namespace mongo::ce
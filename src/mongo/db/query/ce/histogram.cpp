@@ -0,0 +1,217 @@
+/**
+ *    Copyright (C) 2022-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query/ce/histogram.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "mongo/util/assert_util.h"
+#include "mongo/util/str.h"
+
+namespace mongo::ce {
+namespace {
+bool lessThan(const BSONElement& lhs, const BSONElement& rhs) {
+    return lhs.woCompare(rhs, 0 /* ignore field names */) < 0;
+}
+
+/**
+ * Returns the estimated fraction of the values strictly between 'low' and 'high' which are less
+ * than 'value'. Only numbers can be interpolated, otherwise the values are assumed to be split
+ * evenly.
+ */
+double interpolate(const BSONElement* low, const BSONElement& high, const BSONElement& value) {
+    constexpr double kDefaultFraction = 0.5;
+    if (!low || !low->isNumber() || !high.isNumber() || !value.isNumber()) {
+        return kDefaultFraction;
+    }
+
+    const double lowValue = low->numberDouble();
+    const double highValue = high.numberDouble();
+    const double v = value.numberDouble();
+    if (std::isnan(lowValue) || std::isnan(v) || !(highValue > lowValue)) {
+        return kDefaultFraction;
+    }
+    return std::clamp((v - lowValue) / (highValue - lowValue), 0.0, 1.0);
+}
+}  // namespace
+
+Histogram Histogram::build(std::vector<BSONElement> values, size_t maxBuckets) {
+    invariant(maxBuckets > 0);
+    std::sort(values.begin(), values.end(), lessThan);
+
+    std::map<BSONType, double> typeCounts;
+    for (auto&& value : values) {
+        typeCounts[value.type()] += 1.0;
+    }
+
+    // Every bucket but the last one holds at least 'depth' values, so there are at most
+    // 'maxBuckets' buckets.
+    const double depth = std::ceil(static_cast<double>(values.size()) / maxBuckets);
+
+    BSONObjBuilder builder;
+    {
+        BSONArrayBuilder buckets(builder.subarrayStart(kBucketsFieldName));
+        double rangeFreq = 0.0;
+        double ndv = 0.0;
+        for (auto it = values.begin(); it != values.end();) {
+            auto next = std::upper_bound(it, values.end(), *it, lessThan);
+            const double equalFreq = std::distance(it, next);
+
+            if (next == values.end() || rangeFreq + equalFreq >= depth) {
+                BSONObjBuilder bucket(buckets.subobjStart());
+                bucket.appendAs(*it, kBoundaryFieldName);
+                bucket.append(kEqualFreqFieldName, equalFreq);
+                bucket.append(kRangeFreqFieldName, rangeFreq);
+                bucket.append(kNdvFieldName, ndv);
+                rangeFreq = 0.0;
+                ndv = 0.0;
+            } else {
+                rangeFreq += equalFreq;
+                ndv += 1.0;
+            }
+            it = next;
+        }
+    }
+    {
+        BSONObjBuilder typeCountsBuilder(builder.subobjStart(kTypeCountsFieldName));
+        for (auto&& [type, count] : typeCounts) {
+            typeCountsBuilder.append(typeName(type), count);
+        }
+    }
+
+    return Histogram(builder.obj());
+}
+
+Histogram Histogram::parse(const BSONObj& obj) {
+    return Histogram(obj.getOwned());
+}
+
+Histogram::Histogram(BSONObj obj) : _obj(std::move(obj)) {
+    auto readFreq = [](const BSONObj& bucket, StringData fieldName) {
+        auto elem = bucket[fieldName];
+        uassert(7131800,
+                str::stream() << "Histogram bucket field '" << fieldName
+                              << "' must be a non-negative number",
+                elem.isNumber() && elem.numberDouble() >= 0.0);
+        return elem.numberDouble();
+    };
+
+    auto bucketsElem = _obj[kBucketsFieldName];
+    uassert(7131801, "Histogram buckets must be an array", bucketsElem.type() == Array);
+    for (auto&& bucketElem : bucketsElem.Obj()) {
+        uassert(7131802, "Histogram bucket must be an object", bucketElem.type() == Object);
+        auto bucket = bucketElem.Obj();
+
+        auto boundary = bucket[kBoundaryFieldName];
+        uassert(7131803, "Histogram bucket is missing its boundary", !boundary.eoo());
+        uassert(7131804,
+                "Histogram bucket boundaries must be in increasing order",
+                _buckets.empty() || lessThan(_buckets.back().boundary, boundary));
+
+        _buckets.push_back({boundary,
+                            readFreq(bucket, kEqualFreqFieldName),
+                            readFreq(bucket, kRangeFreqFieldName),
+                            readFreq(bucket, kNdvFieldName)});
+        _numValues += _buckets.back().equalFreq + _buckets.back().rangeFreq;
+    }
+
+    auto typeCountsElem = _obj[kTypeCountsFieldName];
+    uassert(7131805, "Histogram type counts must be an object", typeCountsElem.type() == Object);
+    for (auto&& typeCount : typeCountsElem.Obj()) {
+        uassert(7131806, "Histogram type count must be a number", typeCount.isNumber());
+        _typeCounts[typeFromName(typeCount.fieldNameStringData())] = typeCount.numberDouble();
+    }
+}
+
+double Histogram::estimateEqual(const BSONElement& value) const {
+    auto it = std::lower_bound(
+        _buckets.begin(), _buckets.end(), value, [](const Bucket& bucket, const BSONElement& v) {
+            return lessThan(bucket.boundary, v);
+        });
+    if (it == _buckets.end()) {
+        return 0.0;
+    }
+    if (!lessThan(value, it->boundary)) {
+        return it->equalFreq;
+    }
+    // Assume a uniform distribution of the distinct values within the bucket.
+    return it->ndv > 0.0 ? it->rangeFreq / it->ndv : 0.0;
+}
+
+double Histogram::estimateLess(const BSONElement& value, bool inclusive) const {
+    double result = 0.0;
+    const BSONElement* prevBoundary = nullptr;
+    for (auto&& bucket : _buckets) {
+        if (lessThan(bucket.boundary, value)) {
+            result += bucket.rangeFreq + bucket.equalFreq;
+            prevBoundary = &bucket.boundary;
+        } else if (!lessThan(value, bucket.boundary)) {
+            result += bucket.rangeFreq + (inclusive ? bucket.equalFreq : 0.0);
+            break;
+        } else {
+            result += bucket.rangeFreq * interpolate(prevBoundary, bucket.boundary, value);
+            break;
+        }
+    }
+    return result;
+}
+
+double Histogram::countCanonicalTypesBefore(const BSONElement& value, bool inclusive) const {
+    const int canonicalType = canonicalizeBSONType(value.type());
+    double result = 0.0;
+    for (auto&& [type, count] : _typeCounts) {
+        const int otherCanonicalType = canonicalizeBSONType(type);
+        if (otherCanonicalType < canonicalType ||
+            (inclusive && otherCanonicalType == canonicalType)) {
+            result += count;
+        }
+    }
+    return result;
+}
+
+double Histogram::estimateInterval(const boost::optional<BSONElement>& low,
+                                   bool lowInclusive,
+                                   const boost::optional<BSONElement>& high,
+                                   bool highInclusive) const {
+    if (low && high && lowInclusive && highInclusive && low->woCompare(*high, 0) == 0) {
+        return estimateEqual(*low);
+    }
+
+    const double highCount = high ? estimateLess(*high, highInclusive)
+                                  : (low ? countCanonicalTypesBefore(*low, true) : _numValues);
+    const double lowCount = low ? estimateLess(*low, !lowInclusive)
+                                : (high ? countCanonicalTypesBefore(*high, false) : 0.0);
+    return std::max(0.0, highCount - lowCount);
+}
+
+}  // namespace mongo::ce
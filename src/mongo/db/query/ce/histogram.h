@@ -0,0 +1,140 @@
+/**
+ *    Copyright (C) 2022-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include <boost/optional.hpp>
+#include <map>
+#include <vector>
+
+#include "mongo/bson/bsonobj.h"
+#include "mongo/bson/bsonobjbuilder.h"
+
+namespace mongo::ce {
+
+/**
+ * An equi-depth histogram over the values of a field, together with the number of values of each
+ * BSON type. Each bucket is delimited by a boundary value which is present in the data, and holds:
+ *  - 'equalFreq': the number of values equal to the boundary,
+ *  - 'rangeFreq': the number of values strictly between the previous boundary and this one,
+ *  - 'ndv': the number of distinct values strictly between the previous boundary and this one.
+ * Values are ordered as in the query language, without a collation.
+ *
+ * The histogram is stored as BSON and is the same object the 'analyze' command persists:
+ *   {buckets: [{boundary: <value>, equalFreq: <n>, rangeFreq: <n>, ndv: <n>}, ...],
+ *    typeCounts: {<type name>: <n>, ...}}
+ */
+class Histogram {
+public:
+    struct Bucket {
+        BSONElement boundary;
+        double equalFreq;
+        double rangeFreq;
+        double ndv;
+    };
+
+    static constexpr StringData kBucketsFieldName = "buckets"_sd;
+    static constexpr StringData kBoundaryFieldName = "boundary"_sd;
+    static constexpr StringData kEqualFreqFieldName = "equalFreq"_sd;
+    static constexpr StringData kRangeFreqFieldName = "rangeFreq"_sd;
+    static constexpr StringData kNdvFieldName = "ndv"_sd;
+    static constexpr StringData kTypeCountsFieldName = "typeCounts"_sd;
+
+    /**
+     * Builds a histogram of at most 'maxBuckets' buckets from 'values', which do not need to be
+     * sorted. The elements must stay valid for the duration of the call only.
+     */
+    static Histogram build(std::vector<BSONElement> values, size_t maxBuckets);
+
+    /**
+     * Parses a histogram serialized by toBSON(). Throws if 'obj' is malformed.
+     */
+    static Histogram parse(const BSONObj& obj);
+
+    Histogram() = default;
+
+    const BSONObj& toBSON() const {
+        return _obj;
+    }
+
+    const std::vector<Bucket>& getBuckets() const {
+        return _buckets;
+    }
+
+    const std::map<BSONType, double>& getTypeCounts() const {
+        return _typeCounts;
+    }
+
+    /**
+     * The total number of values summarized by the histogram.
+     */
+    double getNumValues() const {
+        return _numValues;
+    }
+
+    /**
+     * Estimates the number of values equal to 'value'.
+     */
+    double estimateEqual(const BSONElement& value) const;
+
+    /**
+     * Estimates the number of values which are less than, or less than or equal to if 'inclusive'
+     * is true, 'value'.
+     */
+    double estimateLess(const BSONElement& value, bool inclusive) const;
+
+    /**
+     * Estimates the number of values within the interval between 'low' and 'high'. An unset bound
+     * is infinite. As in the query language, an interval with a single infinite bound only covers
+     * the values with the same canonical type as the other bound.
+     */
+    double estimateInterval(const boost::optional<BSONElement>& low,
+                            bool lowInclusive,
+                            const boost::optional<BSONElement>& high,
+                            bool highInclusive) const;
+
+private:
+    explicit Histogram(BSONObj obj);
+
+    /**
+     * Returns the number of values whose canonical type is less than, or less than or equal to if
+     * 'inclusive' is true, the canonical type of 'value'.
+     */
+    double countCanonicalTypesBefore(const BSONElement& value, bool inclusive) const;
+
+    // The serialized histogram, which owns the bucket boundaries.
+    BSONObj _obj;
+
+    std::vector<Bucket> _buckets;
+    std::map<BSONType, double> _typeCounts;
+    double _numValues = 0.0;
+};
+
+}  // namespace mongo::ce
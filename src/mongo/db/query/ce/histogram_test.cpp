@@ -0,0 +1,138 @@
+/**
+ *    Copyright (C) 2022-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query/ce/histogram.h"
+
+#include "mongo/bson/json.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo::ce {
+namespace {
+
+std::vector<BSONElement> toElements(const BSONObj& values) {
+    std::vector<BSONElement> result;
+    for (auto&& elem : values) {
+        result.push_back(elem);
+    }
+    return result;
+}
+
+BSONObj makeValues(int n) {
+    BSONArrayBuilder builder;
+    for (int i = 0; i < n; ++i) {
+        builder.append(i);
+    }
+    return builder.arr();
+}
+
+TEST(HistogramTest, BuildsEquiDepthBuckets) {
+    auto values = makeValues(100);
+    auto histogram = Histogram::build(toElements(values), 10);
+
+    ASSERT_EQ(100.0, histogram.getNumValues());
+    ASSERT_EQ(10U, histogram.getBuckets().size());
+    for (auto&& bucket : histogram.getBuckets()) {
+        ASSERT_EQ(1.0, bucket.equalFreq);
+        ASSERT_EQ(9.0, bucket.rangeFreq);
+        ASSERT_EQ(9.0, bucket.ndv);
+    }
+    ASSERT_EQ(1U, histogram.getTypeCounts().size());
+    ASSERT_EQ(100.0, histogram.getTypeCounts().at(NumberInt));
+}
+
+TEST(HistogramTest, EstimatesEquality) {
+    auto values = fromjson("{a: [1, 1, 1, 2, 3, 3, 5, 5, 5, 5, 'x']}");
+    auto histogram = Histogram::build(toElements(values["a"].Obj()), 3);
+
+    // The buckets are [.. 2], [.. 5] and ['x'].
+    auto probes = BSON_ARRAY(1 << 5 << "x" << 6 << "y");
+    ASSERT_EQ(3.0, histogram.estimateEqual(probes[0]));
+    ASSERT_EQ(4.0, histogram.estimateEqual(probes[1]));
+    ASSERT_EQ(1.0, histogram.estimateEqual(probes[2]));
+    // There are no values between 5 and 'x', nor past the last bucket.
+    ASSERT_EQ(0.0, histogram.estimateEqual(probes[3]));
+    ASSERT_EQ(0.0, histogram.estimateEqual(probes[4]));
+}
+
+TEST(HistogramTest, EstimatesRangesWithInterpolation) {
+    auto values = makeValues(1000);
+    auto histogram = Histogram::build(toElements(values), 10);
+
+    auto bounds = BSON_ARRAY(250 << 500 << 99.5);
+    ASSERT_APPROX_EQUAL(250.0, histogram.estimateLess(bounds[0], false), 2.0);
+    ASSERT_APPROX_EQUAL(
+        250.0, histogram.estimateInterval(bounds[0], true, bounds[1], false), 2.0);
+    ASSERT_APPROX_EQUAL(100.0, histogram.estimateLess(bounds[2], true), 2.0);
+}
+
+TEST(HistogramTest, OneSidedIntervalsAreTypeBracketed) {
+    auto values = fromjson("{a: [1, 2, 3, 4, 'a', 'b', null, {b: 1}]}");
+    auto histogram = Histogram::build(toElements(values["a"].Obj()), 4);
+
+    auto bounds = BSON_ARRAY(3 << "a");
+    // {$gt: 3} only matches the numbers greater than 3.
+    ASSERT_EQ(1.0, histogram.estimateInterval(bounds[0], false, boost::none, false));
+    // {$lte: 3} only matches the numbers up to 3.
+    ASSERT_EQ(3.0, histogram.estimateInterval(boost::none, false, bounds[0], true));
+    // {$gte: 'a'} only matches strings.
+    ASSERT_EQ(2.0, histogram.estimateInterval(bounds[1], true, boost::none, false));
+    ASSERT_EQ(8.0, histogram.estimateInterval(boost::none, false, boost::none, false));
+}
+
+TEST(HistogramTest, RoundTripsThroughBSON) {
+    auto values = fromjson("{a: [1, 2.5, 'str', true, null, 3, 3]}");
+    auto histogram = Histogram::build(toElements(values["a"].Obj()), 3);
+    auto parsed = Histogram::parse(histogram.toBSON());
+
+    ASSERT_BSONOBJ_EQ(histogram.toBSON(), parsed.toBSON());
+    ASSERT_EQ(histogram.getNumValues(), parsed.getNumValues());
+    ASSERT_EQ(histogram.getBuckets().size(), parsed.getBuckets().size());
+    ASSERT(histogram.getTypeCounts() == parsed.getTypeCounts());
+}
+
+TEST(HistogramTest, RejectsMalformedHistograms) {
+    ASSERT_THROWS_CODE(Histogram::parse(fromjson("{typeCounts: {}}")), DBException, 7131801);
+    ASSERT_THROWS_CODE(
+        Histogram::parse(fromjson("{buckets: [{boundary: 1, equalFreq: -1, rangeFreq: 0, ndv: 0}],"
+                                  " typeCounts: {}}")),
+        DBException,
+        7131800);
+    ASSERT_THROWS_CODE(
+        Histogram::parse(fromjson("{buckets: [{boundary: 2, equalFreq: 1, rangeFreq: 0, ndv: 0},"
+                                  "{boundary: 1, equalFreq: 1, rangeFreq: 0, ndv: 0}],"
+                                  " typeCounts: {}}")),
+        DBException,
+        7131804);
+}
+
+}  // namespace
+}  // namespace mongo::ce
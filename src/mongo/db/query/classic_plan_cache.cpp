@@ -105,6 +105,7 @@ std::unique_ptr<SolutionCacheData> SolutionCacheData::clone() const {
     other->solnType = this->solnType;
     other->wholeIXSolnDir = this->wholeIXSolnDir;
     other->indexFilterApplied = this->indexFilterApplied;
+    other->skeleton = this->skeleton;
     return other;
 }
 
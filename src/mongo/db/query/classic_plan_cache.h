@@ -38,6 +38,8 @@
 
 namespace mongo {
 
+class SolutionSkeleton;
+
 /**
  * Represents the "key" used in the PlanCache mapping from query shape -> query plan.
  */
@@ -228,6 +230,11 @@ struct SolutionCacheData {
 
     // True if index filter was applied.
     bool indexFilterApplied;
+
+    // A parameterized copy of the data access plan of a USE_INDEX_TAGS_SOLN solution, from which
+    // the plan can be rebuilt for the parameters of a query without using 'tree'. Null if the plan
+    // cannot be parameterized. The skeleton is immutable, so it is shared between copies.
+    std::shared_ptr<const SolutionSkeleton> skeleton;
 };
 
 using PlanCacheEntry = PlanCacheEntryBase<SolutionCacheData, plan_cache_debug_info::DebugInfo>;
@@ -77,6 +77,73 @@ CoreIndexInfo indexInfoFromIndexCatalogEntry(const IndexCatalogEntry& ice) {
             projExec};
 }
 
+/**
+ * Registers with 'indexedPaths' every path whose value can change the keys, or the membership of a
+ * partial index, of the index in 'entry'.
+ */
+void addIndexedPaths(const IndexCatalogEntry* entry, UpdateIndexData* indexedPaths) {
+    const IndexDescriptor* descriptor = entry->descriptor();
+    const IndexAccessMethod* iam = entry->accessMethod();
+
+    if (descriptor->getAccessMethodName() == IndexNames::WILDCARD) {
+        // Obtain the projection used by the $** index's key generator.
+        const auto* pathProj =
+            static_cast<const WildcardAccessMethod*>(iam)->getWildcardProjection();
+        // If the projection is an exclusion, then we must check the new document's keys on all
+        // updates, since we do not exhaustively know the set of paths to be indexed.
+        if (pathProj->exec()->getType() ==
+            TransformerInterface::TransformerType::kExclusionProjection) {
+            indexedPaths->allPathsIndexed();
+        } else {
+            // If a subtree was specified in the keyPattern, or if an inclusion projection is
+            // present, then we need only index the path(s) preserved by the projection.
+            const auto& exhaustivePaths = pathProj->exhaustivePaths();
+            invariant(exhaustivePaths);
+            for (const auto& path : *exhaustivePaths) {
+                indexedPaths->addPath(path);
+            }
+        }
+    } else if (descriptor->getAccessMethodName() == IndexNames::TEXT) {
+        fts::FTSSpec ftsSpec(descriptor->infoObj());
+
+        if (ftsSpec.wildcard()) {
+            indexedPaths->allPathsIndexed();
+        } else {
+            for (size_t i = 0; i < ftsSpec.numExtraBefore(); ++i) {
+                indexedPaths->addPath(FieldRef(ftsSpec.extraBefore(i)));
+            }
+            for (fts::Weights::const_iterator it = ftsSpec.weights().begin();
+                 it != ftsSpec.weights().end();
+                 ++it) {
+                indexedPaths->addPath(FieldRef(it->first));
+            }
+            for (size_t i = 0; i < ftsSpec.numExtraAfter(); ++i) {
+                indexedPaths->addPath(FieldRef(ftsSpec.extraAfter(i)));
+            }
+            // Any update to a path containing "language" as a component could change the
+            // language of a subdocument.  Add the override field as a path component.
+            indexedPaths->addPathComponent(ftsSpec.languageOverrideField());
+        }
+    } else {
+        BSONObj key = descriptor->keyPattern();
+        BSONObjIterator j(key);
+        while (j.more()) {
+            BSONElement e = j.next();
+            indexedPaths->addPath(FieldRef(e.fieldName()));
+        }
+    }
+
+    // handle partial indexes
+    const MatchExpression* filter = entry->getFilterExpression();
+    if (filter) {
+        stdx::unordered_set<std::string> paths;
+        QueryPlannerIXSelect::getFields(filter, &paths);
+        for (auto it = paths.begin(); it != paths.end(); ++it) {
+            indexedPaths->addPath(FieldRef(*it));
+        }
+    }
+}
+
 }  // namespace
 
 CollectionQueryInfo::PlanCacheState::PlanCacheState()
@@ -114,73 +181,25 @@ const UpdateIndexData& CollectionQueryInfo::getIndexKeys(OperationContext* opCtx
     return _indexedPaths;
 }
 
+const UpdateIndexData* CollectionQueryInfo::getIndexKeys(OperationContext* opCtx,
+                                                         StringData indexName) const {
+    if (!_keysComputed) {
+        return nullptr;
+    }
+    auto it = _indexedPathsByIndex.find(indexName);
+    return it == _indexedPathsByIndex.end() ? nullptr : &it->second;
+}
+
 void CollectionQueryInfo::computeIndexKeys(OperationContext* opCtx, const CollectionPtr& coll) {
     _indexedPaths.clear();
+    _indexedPathsByIndex.clear();
 
     std::unique_ptr<IndexCatalog::IndexIterator> it =
         coll->getIndexCatalog()->getIndexIterator(opCtx, true);
     while (it->more()) {
         const IndexCatalogEntry* entry = it->next();
-        const IndexDescriptor* descriptor = entry->descriptor();
-        const IndexAccessMethod* iam = entry->accessMethod();
-
-        if (descriptor->getAccessMethodName() == IndexNames::WILDCARD) {
-            // Obtain the projection used by the $** index's key generator.
-            const auto* pathProj =
-                static_cast<const WildcardAccessMethod*>(iam)->getWildcardProjection();
-            // If the projection is an exclusion, then we must check the new document's keys on all
-            // updates, since we do not exhaustively know the set of paths to be indexed.
-            if (pathProj->exec()->getType() ==
-                TransformerInterface::TransformerType::kExclusionProjection) {
-                _indexedPaths.allPathsIndexed();
-            } else {
-                // If a subtree was specified in the keyPattern, or if an inclusion projection is
-                // present, then we need only index the path(s) preserved by the projection.
-                const auto& exhaustivePaths = pathProj->exhaustivePaths();
-                invariant(exhaustivePaths);
-                for (const auto& path : *exhaustivePaths) {
-                    _indexedPaths.addPath(path);
-                }
-            }
-        } else if (descriptor->getAccessMethodName() == IndexNames::TEXT) {
-            fts::FTSSpec ftsSpec(descriptor->infoObj());
-
-            if (ftsSpec.wildcard()) {
-                _indexedPaths.allPathsIndexed();
-            } else {
-                for (size_t i = 0; i < ftsSpec.numExtraBefore(); ++i) {
-                    _indexedPaths.addPath(FieldRef(ftsSpec.extraBefore(i)));
-                }
-                for (fts::Weights::const_iterator it = ftsSpec.weights().begin();
-                     it != ftsSpec.weights().end();
-                     ++it) {
-                    _indexedPaths.addPath(FieldRef(it->first));
-                }
-                for (size_t i = 0; i < ftsSpec.numExtraAfter(); ++i) {
-                    _indexedPaths.addPath(FieldRef(ftsSpec.extraAfter(i)));
-                }
-                // Any update to a path containing "language" as a component could change the
-                // language of a subdocument.  Add the override field as a path component.
-                _indexedPaths.addPathComponent(ftsSpec.languageOverrideField());
-            }
-        } else {
-            BSONObj key = descriptor->keyPattern();
-            BSONObjIterator j(key);
-            while (j.more()) {
-                BSONElement e = j.next();
-                _indexedPaths.addPath(FieldRef(e.fieldName()));
-            }
-        }
-
-        // handle partial indexes
-        const MatchExpression* filter = entry->getFilterExpression();
-        if (filter) {
-            stdx::unordered_set<std::string> paths;
-            QueryPlannerIXSelect::getFields(filter, &paths);
-            for (auto it = paths.begin(); it != paths.end(); ++it) {
-                _indexedPaths.addPath(FieldRef(*it));
-            }
-        }
+        addIndexedPaths(entry, &_indexedPaths);
+        addIndexedPaths(entry, &_indexedPathsByIndex[entry->descriptor()->indexName()]);
     }
 
     _keysComputed = true;
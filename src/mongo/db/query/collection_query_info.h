@@ -35,6 +35,7 @@
 #include "mongo/db/query/plan_cache_invalidator.h"
 #include "mongo/db/query/plan_summary_stats.h"
 #include "mongo/db/update_index_data.h"
+#include "mongo/util/string_map.h"
 
 namespace mongo {
 
@@ -85,6 +86,12 @@ public:
     */
     const UpdateIndexData& getIndexKeys(OperationContext* opCtx) const;
 
+    /**
+     * Returns the paths that can affect the keys of the index named 'indexName', or nullptr if they
+     * have not been computed for that index.
+     */
+    const UpdateIndexData* getIndexKeys(OperationContext* opCtx, StringData indexName) const;
+
     /**
      * Builds internal cache state based on the current state of the Collection's IndexCatalog.
      */
@@ -151,6 +158,7 @@ private:
     // ---  index keys cache
     bool _keysComputed;
     UpdateIndexData _indexedPaths;
+    StringMap<UpdateIndexData> _indexedPathsByIndex;
 
     std::shared_ptr<PlanCacheState> _planCacheState;
 };
@@ -0,0 +1,536 @@
+/**
+ *    Copyright (C) 2022-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "mongo/db/query/lru_key_value.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/platform/mutex.h"
+#include "mongo/platform/random.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/stdx/unordered_map.h"
+#include "mongo/util/aligned.h"
+#include "mongo/util/assert_util.h"
+
+namespace mongo {
+namespace concurrent_lru_detail {
+
+/**
+ * Epoch-based protection for the read side of 'ConcurrentLRUKeyValue'. Readers announce themselves
+ * in one of a fixed number of cache-aligned reader slots, so that concurrent readers on different
+ * threads rarely write to the same cache line. Writers unlink objects from the shared structure
+ * first, and then call synchronize() to wait for a grace period, after which no reader can still
+ * hold a reference to the unlinked objects and they can be freed.
+ *
+ * Every slot holds one reader counter for each parity of the epoch. Each grace period advances the
+ * epoch twice and waits for the counters of the previous parity to drain every time, so that new
+ * readers, which enter under the current parity, cannot hold off a writer indefinitely.
+ */
+class ReaderEpochs {
+public:
+    static constexpr size_t kNumReaderSlots = 64;
+
+    /**
+     * A scope in which the objects reachable from the shared structure are not freed.
+     */
+    class ReadSection {
+    public:
+        explicit ReadSection(const ReaderEpochs& epochs) {
+            const auto epoch = epochs._epoch.load();
+            _counter = &epochs._slots[readerSlotForThisThread()]->counters[epoch & 1];
+            _counter->fetchAndAdd(1);
+        }
+
+        ~ReadSection() {
+            _counter->fetchAndSubtract(1);
+        }
+
+        ReadSection(const ReadSection&) = delete;
+        ReadSection& operator=(const ReadSection&) = delete;
+
+    private:
+        AtomicWord<uint64_t>* _counter;
+    };
+
+    /**
+     * Waits until all the readers which entered a read section before this call have left it.
+     */
+    void synchronize() const {
+        stdx::lock_guard<Latch> lk(_synchronizeMutex);
+        for (int flip = 0; flip < 2; ++flip) {
+            const auto parity = _epoch.fetchAndAdd(1) & 1;
+            for (auto&& slot : _slots) {
+                while (slot->counters[parity].load() != 0) {
+                    stdx::this_thread::yield();
+                }
+            }
+        }
+    }
+
+private:
+    struct ReaderSlot {
+        AtomicWord<uint64_t> counters[2];
+    };
+
+    static size_t readerSlotForThisThread() {
+        static AtomicWord<size_t> nextSlot{0};
+        thread_local const size_t slot = nextSlot.fetchAndAdd(1) % kNumReaderSlots;
+        return slot;
+    }
+
+    mutable AtomicWord<uint64_t> _epoch{0};
+    mutable std::array<CacheAligned<ReaderSlot>, kNumReaderSlots> _slots;
+
+    // Grace periods are serialized so that the epoch only moves on once the readers of the
+    // previous parity have drained.
+    mutable Mutex _synchronizeMutex = MONGO_MAKE_LATCH("ReaderEpochs::_synchronizeMutex");
+};
+}  // namespace concurrent_lru_detail
+
+/**
+ * Controls when a 'ConcurrentLRUKeyValue' evicts entries to get back under its budget.
+ */
+enum class LRUEvictionPolicy {
+    // Entries are evicted by the writer which takes the store over its budget.
+    kInline,
+    // Entries are evicted by periodic calls to 'evictIfOverBudget()'. Writers only evict entries
+    // themselves once the store grows beyond 'kBackgroundEvictionBudgetFactor' times its budget,
+    // which bounds the memory use if the background eviction falls behind.
+    kBackground,
+};
+
+/**
+ * A thread-safe key-value store for read-mostly workloads, with an approximate least recently used
+ * (LRU) replacement policy. The size allowed in the kv-store is controlled by 'LRUBudgetTracker'
+ * set in the constructor, and is split evenly between the partitions of the store.
+ *
+ * Lookups do not take any lock. Every partition publishes an immutable index of its entries, which
+ * is replaced by writers on every change. The replaced index and the removed entries are freed
+ * once all the concurrent lookups have finished, as tracked by 'ReaderEpochs'. Writers to the same
+ * partition are serialized by a mutex, and each pays for a copy of the index of the partition, so
+ * this store is only suitable for workloads with far more lookups than changes.
+ *
+ * Instead of moving an entry to the front of a list on every lookup, each entry records the value
+ * of a logical access clock of its partition when it was last used. A lookup only advances the
+ * clock and refreshes the access time of the entry when it has fallen noticeably behind the most
+ * recently used entries, so repeated lookups of hot entries do not write to shared memory. When the
+ * partition is over budget, the entry with the oldest access time amongst a random sample of
+ * entries is evicted, in the manner of sampled LRU.
+ *
+ * The values are owned by the kv-store and cannot be modified once added. Callers replace a value
+ * to change it.
+ */
+template <class K,
+          class V,
+          class BudgetEstimator,
+          class KeyPartitioner,
+          class KeyHasher = std::hash<K>>
+class ConcurrentLRUKeyValue {
+public:
+    // The number of entries the eviction chooses the least recently used entry from.
+    static constexpr size_t kEvictionSampleSize = 16;
+
+    // See 'LRUEvictionPolicy::kBackground'.
+    static constexpr size_t kBackgroundEvictionBudgetFactor = 2;
+
+    ConcurrentLRUKeyValue(size_t maxSize,
+                          size_t numPartitions,
+                          LRUEvictionPolicy evictionPolicy = LRUEvictionPolicy::kInline)
+        : _evictionPolicy(evictionPolicy) {
+        invariant(numPartitions > 0);
+        for (size_t partitionId = 0; partitionId < numPartitions; ++partitionId) {
+            _partitions.push_back(
+                std::make_unique<Partition>(maxSize / numPartitions, partitionId));
+        }
+    }
+
+    ConcurrentLRUKeyValue(const ConcurrentLRUKeyValue&) = delete;
+    ConcurrentLRUKeyValue& operator=(const ConcurrentLRUKeyValue&) = delete;
+
+    /**
+     * Looks up the value associated with 'key' and calls 'fn' with a pointer to it, or with a
+     * nullptr if there is no such value. The pointer is only valid within 'fn'. As a side effect,
+     * the retrieved entry may be marked as recently used. Returns the result of 'fn'.
+     */
+    template <typename Fn>
+    auto withValue(const K& key, Fn&& fn) const {
+        concurrent_lru_detail::ReaderEpochs::ReadSection readSection{_epochs};
+
+        const auto& partition = getPartition(key);
+        const Index* index = partition.index.load();
+        auto it = index->find(&key);
+        if (it == index->end()) {
+            return fn(static_cast<const V*>(nullptr));
+        }
+
+        const Slot* slot = it->second;
+        touch(partition, *slot, index->size());
+        return fn(static_cast<const V*>(slot->value.get()));
+    }
+
+    /**
+     * Calls 'fn' with a pointer to the current value associated with 'key', or with a nullptr if
+     * there is no such value. If 'fn' returns a new value, it replaces the current value, or is
+     * added as the most recently used entry if there was no value for 'key'. Writers to the same
+     * partition are serialized, so the current value cannot change while 'fn' runs. Returns the
+     * number of evicted entries.
+     */
+    template <typename Fn>
+    size_t update(const K& key, Fn&& fn) {
+        auto& partition = getPartition(key);
+        stdx::lock_guard<Latch> lk(partition.mutex);
+
+        auto& current = partition.ownedIndex;
+        auto it = current->find(&key);
+        const V* currentValue = it != current->end() ? it->second->value.get() : nullptr;
+        std::unique_ptr<V> newValue = fn(currentValue);
+        if (!newValue) {
+            return 0;
+        }
+
+        Change change{partition, _epochs};
+        if (it != current->end()) {
+            change.remove(it->second);
+        }
+        change.add(key, std::move(newValue));
+        return change.commit(shouldEvictInline(partition));
+    }
+
+    /**
+     * Adds a (K, V) pair to the store, replacing any value already associated with 'key'. Returns
+     * the number of evicted entries.
+     */
+    size_t add(const K& key, std::unique_ptr<V> value) {
+        return update(key, [&](const V*) { return std::move(value); });
+    }
+
+    /**
+     * Removes the entry keyed by 'key'. Returns false if there is no such entry, otherwise returns
+     * true.
+     */
+    bool erase(const K& key) {
+        auto& partition = getPartition(key);
+        stdx::lock_guard<Latch> lk(partition.mutex);
+
+        auto it = partition.ownedIndex->find(&key);
+        if (it == partition.ownedIndex->end()) {
+            return false;
+        }
+
+        Change change{partition, _epochs};
+        change.remove(it->second);
+        change.commit(false /* evict */);
+        return true;
+    }
+
+    /**
+     * Removes all the entries for keys for which the predicate returns true. Returns the number of
+     * removed entries.
+     */
+    template <typename UnaryPredicate>
+    size_t removeIf(UnaryPredicate predicate) {
+        size_t removed = 0;
+        for (auto&& partition : _partitions) {
+            stdx::lock_guard<Latch> lk(partition->mutex);
+
+            std::vector<Slot*> toRemove;
+            for (auto&& slot : partition->slots) {
+                if (predicate(slot->key)) {
+                    toRemove.push_back(slot.get());
+                }
+            }
+
+            Change change{*partition, _epochs};
+            for (auto slot : toRemove) {
+                change.remove(slot);
+            }
+            change.commit(false /* evict */);
+            removed += toRemove.size();
+        }
+        return removed;
+    }
+
+    /**
+     * Deletes all entries in the kv-store.
+     */
+    void clear() {
+        removeIf([](const K&) { return true; });
+    }
+
+    /**
+     * Resets the budget of the kv-store. Returns the number of evicted entries.
+     */
+    size_t reset(size_t newMaxSize) {
+        size_t evicted = 0;
+        for (auto&& partition : _partitions) {
+            stdx::lock_guard<Latch> lk(partition->mutex);
+            partition->budgetTracker.reset(newMaxSize / _partitions.size());
+
+            Change change{*partition, _epochs};
+            evicted += change.commit(true /* evict */);
+        }
+        return evicted;
+    }
+
+    /**
+     * Evicts the least recently used entries of every partition which is over its budget, until it
+     * is under budget again. Returns the number of evicted entries.
+     */
+    size_t evictIfOverBudget() {
+        size_t evicted = 0;
+        for (auto&& partition : _partitions) {
+            stdx::lock_guard<Latch> lk(partition->mutex);
+            if (!partition->budgetTracker.isOverBudget()) {
+                continue;
+            }
+
+            Change change{*partition, _epochs};
+            evicted += change.commit(true /* evict */);
+        }
+        return evicted;
+    }
+
+    /**
+     * Returns the size (current budget) of the kv-store.
+     */
+    size_t size() const {
+        size_t size = 0;
+        for (auto&& partition : _partitions) {
+            stdx::lock_guard<Latch> lk(partition->mutex);
+            size += partition->budgetTracker.currentBudget();
+        }
+        return size;
+    }
+
+    /**
+     * Calls 'fn' with every (K, V) pair in the store. Changes to each partition are blocked while
+     * its entries are visited, but 'fn' does not see a point-in-time view of the whole store.
+     */
+    template <typename Fn>
+    void forEach(Fn&& fn) const {
+        for (auto&& partition : _partitions) {
+            stdx::lock_guard<Latch> lk(partition->mutex);
+            for (auto&& slot : partition->slots) {
+                fn(slot->key, static_cast<const V&>(*slot->value));
+            }
+        }
+    }
+
+private:
+    struct Slot {
+        Slot(const K& key, std::unique_ptr<V> value, uint64_t lastAccess)
+            : key(key), value(std::move(value)), lastAccess(lastAccess) {}
+
+        const K key;
+        const std::unique_ptr<V> value;
+
+        // The value of the access clock of the partition when this entry was last used.
+        mutable AtomicWord<uint64_t> lastAccess;
+
+        // The position of this slot in 'Partition::slots'. Only used by writers.
+        size_t position = 0;
+    };
+
+    struct IndexHasher {
+        size_t operator()(const K* key) const {
+            return KeyHasher{}(*key);
+        }
+    };
+
+    struct IndexEq {
+        bool operator()(const K* lhs, const K* rhs) const {
+            return *lhs == *rhs;
+        }
+    };
+
+    // The index of a partition is keyed by pointers to the keys held in the slots, so that copying
+    // the index does not copy the keys.
+    using Index = stdx::unordered_map<const K*, Slot*, IndexHasher, IndexEq>;
+
+    struct Partition {
+        Partition(size_t maxSize, size_t partitionId)
+            : ownedIndex(std::make_unique<Index>()),
+              index(ownedIndex.get()),
+              budgetTracker(maxSize),
+              random(static_cast<uint64_t>(partitionId)) {}
+
+        // Serializes the writers of this partition.
+        mutable Mutex mutex = MONGO_MAKE_LATCH("ConcurrentLRUKeyValue::Partition::mutex");
+
+        // The index of the entries of this partition. The index is owned by the writers, and is
+        // published to the readers through 'index'.
+        std::unique_ptr<Index> ownedIndex;
+        AtomicWord<const Index*> index;
+
+        // The entries of this partition, in no particular order. Only used by writers.
+        std::vector<std::unique_ptr<Slot>> slots;
+
+        LRUBudgetTracker<V, BudgetEstimator> budgetTracker;
+
+        // A logical clock which is advanced whenever an entry is marked as recently used.
+        mutable AtomicWord<uint64_t> accessClock{0};
+
+        // Used by writers to sample the entries to evict.
+        PseudoRandom random;
+    };
+
+    /**
+     * Collects the changes to a partition, and applies them in a single copy of the index. The
+     * partition mutex must be held for the lifetime of this object.
+     */
+    class Change {
+    public:
+        Change(Partition& partition, const concurrent_lru_detail::ReaderEpochs& epochs)
+            : _partition(partition), _epochs(epochs) {}
+
+        void add(const K& key, std::unique_ptr<V> value) {
+            _partition.budgetTracker.onAdd(*value);
+            auto slot = std::make_unique<Slot>(
+                key, std::move(value), _partition.accessClock.addAndFetch(1));
+            slot->position = _partition.slots.size();
+            _added.push_back(slot.get());
+            _partition.slots.push_back(std::move(slot));
+        }
+
+        void remove(Slot* slot) {
+            _partition.budgetTracker.onRemove(*slot->value);
+
+            // Swap the slot with the last one to remove it from the writer side vector.
+            auto& slots = _partition.slots;
+            const auto position = slot->position;
+            std::swap(slots[position], slots.back());
+            slots[position]->position = position;
+            _removed.push_back(std::move(slots.back()));
+            slots.pop_back();
+        }
+
+        /**
+         * Publishes the changes to the readers, after evicting the least recently used entries
+         * until the partition is under budget if 'evict' is true. Frees the removed entries once
+         * no reader can still see them. Returns the number of evicted entries.
+         */
+        size_t commit(bool evict) {
+            size_t evicted = 0;
+            if (evict) {
+                while (_partition.budgetTracker.isOverBudget()) {
+                    invariant(!_partition.slots.empty());
+                    remove(pickEvictionVictim());
+                    ++evicted;
+                }
+            }
+
+            if (_added.empty() && _removed.empty()) {
+                return evicted;
+            }
+
+            auto newIndex = std::make_unique<Index>(*_partition.ownedIndex);
+            for (auto&& slot : _removed) {
+                auto it = newIndex->find(&slot->key);
+                if (it != newIndex->end() && it->second == slot.get()) {
+                    newIndex->erase(it);
+                }
+            }
+            for (auto slot : _added) {
+                if (slot->position < _partition.slots.size() &&
+                    _partition.slots[slot->position].get() == slot) {
+                    (*newIndex)[&slot->key] = slot;
+                }
+            }
+
+            _partition.index.store(newIndex.get());
+            auto oldIndex = std::exchange(_partition.ownedIndex, std::move(newIndex));
+
+            // Wait for the readers which may still use the old index or the removed entries.
+            _epochs.synchronize();
+            oldIndex.reset();
+            _removed.clear();
+            return evicted;
+        }
+
+    private:
+        Slot* pickEvictionVictim() {
+            auto& slots = _partition.slots;
+            const auto sampleSize = std::min(kEvictionSampleSize, slots.size());
+            const bool sampleAll = sampleSize == slots.size();
+
+            Slot* victim = nullptr;
+            for (size_t i = 0; i < sampleSize; ++i) {
+                auto slot = sampleAll ? slots[i].get()
+                                      : slots[_partition.random.nextInt64(slots.size())].get();
+                if (!victim || slot->lastAccess.load() < victim->lastAccess.load()) {
+                    victim = slot;
+                }
+            }
+            return victim;
+        }
+
+        Partition& _partition;
+        const concurrent_lru_detail::ReaderEpochs& _epochs;
+        std::vector<Slot*> _added;
+        std::vector<std::unique_ptr<Slot>> _removed;
+    };
+
+    Partition& getPartition(const K& key) const {
+        return *_partitions[KeyPartitioner()(key, _partitions.size())];
+    }
+
+    bool shouldEvictInline(const Partition& partition) const {
+        if (_evictionPolicy == LRUEvictionPolicy::kInline) {
+            return true;
+        }
+        return partition.budgetTracker.currentBudget() >
+            partition.budgetTracker.maxBudget() * kBackgroundEvictionBudgetFactor;
+    }
+
+    /**
+     * Marks the entry held in 'slot' as recently used, unless it is still amongst the most recently
+     * used entries of a partition of 'numEntries' entries.
+     */
+    static void touch(const Partition& partition, const Slot& slot, size_t numEntries) {
+        const auto now = partition.accessClock.loadRelaxed();
+        const auto lastAccess = slot.lastAccess.loadRelaxed();
+        const uint64_t staleness = std::max<uint64_t>(1, numEntries / 4);
+        if (lastAccess < now && now - lastAccess >= staleness) {
+            slot.lastAccess.store(partition.accessClock.addAndFetch(1));
+        }
+    }
+
+    const LRUEvictionPolicy _evictionPolicy;
+    concurrent_lru_detail::ReaderEpochs _epochs;
+    std::vector<std::unique_ptr<Partition>> _partitions;
+};
+
+}  // namespace mongo
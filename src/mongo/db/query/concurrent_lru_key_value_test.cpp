@@ -0,0 +1,253 @@
+/**
+ *    Copyright (C) 2022-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/db/query/concurrent_lru_key_value.h"
+
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+struct TrivialBudgetEstimator {
+    size_t operator()(int) {
+        return 1;
+    }
+};
+
+struct ModuloPartitioner {
+    size_t operator()(int key, size_t nPartitions) const {
+        return static_cast<size_t>(key) % nPartitions;
+    }
+};
+
+using TestKeyValue = ConcurrentLRUKeyValue<int, int, TrivialBudgetEstimator, ModuloPartitioner>;
+
+// The values stored in the tests are never negative.
+constexpr int kNotFound = -1;
+
+int lookup(const TestKeyValue& cache, int key) {
+    return cache.withValue(key, [](const int* value) { return value ? *value : kNotFound; });
+}
+
+TEST(ConcurrentLRUKeyValueTest, BasicAddGet) {
+    TestKeyValue cache{100, 1};
+    cache.add(1, std::make_unique<int>(2));
+    ASSERT_EQ(lookup(cache, 1), 2);
+    ASSERT_EQ(lookup(cache, 2), kNotFound);
+    ASSERT_EQ(cache.size(), 1U);
+}
+
+TEST(ConcurrentLRUKeyValueTest, SizeZeroCache) {
+    TestKeyValue cache{0, 1};
+    cache.add(1, std::make_unique<int>(2));
+    ASSERT_EQ(lookup(cache, 1), kNotFound);
+    ASSERT_EQ(cache.size(), 0U);
+}
+
+TEST(ConcurrentLRUKeyValueTest, AddReplacesExistingValue) {
+    TestKeyValue cache{10, 1};
+    cache.add(1, std::make_unique<int>(2));
+    cache.add(1, std::make_unique<int>(3));
+    ASSERT_EQ(lookup(cache, 1), 3);
+    ASSERT_EQ(cache.size(), 1U);
+}
+
+TEST(ConcurrentLRUKeyValueTest, UpdateSeesCurrentValue) {
+    TestKeyValue cache{10, 1};
+
+    // Returning no value leaves the store unchanged.
+    cache.update(1, [](const int* current) {
+        ASSERT_FALSE(current);
+        return std::unique_ptr<int>{};
+    });
+    ASSERT_EQ(lookup(cache, 1), kNotFound);
+
+    cache.update(1, [](const int* current) {
+        ASSERT_FALSE(current);
+        return std::make_unique<int>(1);
+    });
+    cache.update(1, [](const int* current) {
+        ASSERT(current);
+        return std::make_unique<int>(*current + 1);
+    });
+    ASSERT_EQ(lookup(cache, 1), 2);
+}
+
+TEST(ConcurrentLRUKeyValueTest, EvictsLeastRecentlyUsedEntry) {
+    const int maxSize = 8;
+    TestKeyValue cache{maxSize, 1};
+    for (int i = 0; i < maxSize; ++i) {
+        cache.add(i, std::make_unique<int>(i));
+    }
+
+    // Use every entry but the first one, so that the first one is the least recently used.
+    for (int i = 1; i < maxSize; ++i) {
+        ASSERT_EQ(lookup(cache, i), i);
+    }
+
+    ASSERT_EQ(cache.add(maxSize, std::make_unique<int>(maxSize)), 1U);
+    ASSERT_EQ(lookup(cache, 0), kNotFound);
+    for (int i = 1; i <= maxSize; ++i) {
+        ASSERT_EQ(lookup(cache, i), i);
+    }
+    ASSERT_EQ(cache.size(), static_cast<size_t>(maxSize));
+}
+
+TEST(ConcurrentLRUKeyValueTest, SplitsBudgetBetweenPartitions) {
+    TestKeyValue cache{4, 2};
+    for (int i = 0; i < 10; ++i) {
+        cache.add(i, std::make_unique<int>(i));
+    }
+    ASSERT_EQ(cache.size(), 4U);
+
+    // Every partition keeps its two most recently added entries.
+    for (int i = 6; i < 10; ++i) {
+        ASSERT_EQ(lookup(cache, i), i);
+    }
+}
+
+TEST(ConcurrentLRUKeyValueTest, EraseAndRemoveIf) {
+    TestKeyValue cache{100, 4};
+    for (int i = 0; i < 20; ++i) {
+        cache.add(i, std::make_unique<int>(i));
+    }
+
+    ASSERT_TRUE(cache.erase(3));
+    ASSERT_FALSE(cache.erase(3));
+    ASSERT_EQ(lookup(cache, 3), kNotFound);
+
+    ASSERT_EQ(cache.removeIf([](int key) { return key % 2 == 0; }), 10U);
+    ASSERT_EQ(cache.size(), 9U);
+    for (int i = 0; i < 20; ++i) {
+        ASSERT_EQ(lookup(cache, i) != kNotFound, i % 2 == 1 && i != 3);
+    }
+
+    size_t visited = 0;
+    cache.forEach([&](const int& key, const int& value) {
+        ASSERT_EQ(key, value);
+        ++visited;
+    });
+    ASSERT_EQ(visited, 9U);
+
+    cache.clear();
+    ASSERT_EQ(cache.size(), 0U);
+    ASSERT_EQ(lookup(cache, 1), kNotFound);
+}
+
+TEST(ConcurrentLRUKeyValueTest, ResetEvictsEntries) {
+    TestKeyValue cache{10, 1};
+    for (int i = 0; i < 10; ++i) {
+        cache.add(i, std::make_unique<int>(i));
+    }
+    ASSERT_EQ(cache.reset(4), 6U);
+    ASSERT_EQ(cache.size(), 4U);
+}
+
+TEST(ConcurrentLRUKeyValueTest, BackgroundEvictionPolicy) {
+    const int maxSize = 4;
+    TestKeyValue cache{maxSize, 1, LRUEvictionPolicy::kBackground};
+
+    // Writers let the store grow over its budget, up to the hard limit.
+    const int hardLimit = maxSize * TestKeyValue::kBackgroundEvictionBudgetFactor;
+    for (int i = 0; i < hardLimit; ++i) {
+        ASSERT_EQ(cache.add(i, std::make_unique<int>(i)), 0U);
+    }
+    ASSERT_EQ(cache.size(), static_cast<size_t>(hardLimit));
+
+    ASSERT_EQ(cache.evictIfOverBudget(), static_cast<size_t>(hardLimit - maxSize));
+    ASSERT_EQ(cache.size(), static_cast<size_t>(maxSize));
+    ASSERT_EQ(cache.evictIfOverBudget(), 0U);
+
+    // Beyond the hard limit, writers evict entries themselves.
+    for (int i = 0; i < hardLimit * 2; ++i) {
+        cache.add(hardLimit + i, std::make_unique<int>(i));
+        ASSERT_LTE(cache.size(), static_cast<size_t>(hardLimit));
+    }
+}
+
+TEST(ConcurrentLRUKeyValueTest, ConcurrentReadersAndWriters) {
+    const int numKeys = 64;
+    TestKeyValue cache{numKeys / 2, 4};
+
+    AtomicWord<bool> done{false};
+    std::vector<stdx::thread> readers;
+    for (int t = 0; t < 4; ++t) {
+        readers.emplace_back([&, t] {
+            int key = t;
+            while (!done.load()) {
+                key = (key + 7) % numKeys;
+                // The value of every key is always a multiple of the key.
+                auto value = lookup(cache, key);
+                if (value != kNotFound && key != 0) {
+                    ASSERT_EQ(value % key, 0);
+                }
+            }
+        });
+    }
+
+    std::vector<stdx::thread> writers;
+    for (int t = 0; t < 2; ++t) {
+        writers.emplace_back([&, t] {
+            for (int i = 0; i < 5000; ++i) {
+                int key = (i * 13 + t) % numKeys;
+                switch (i % 4) {
+                    case 0:
+                        cache.add(key, std::make_unique<int>(key));
+                        break;
+                    case 1:
+                        cache.update(key, [&](const int* current) {
+                            return std::make_unique<int>(current ? *current + key : key);
+                        });
+                        break;
+                    case 2:
+                        cache.erase(key);
+                        break;
+                    case 3:
+                        cache.removeIf([&](int k) { return k == key; });
+                        break;
+                }
+            }
+        });
+    }
+
+    for (auto&& writer : writers) {
+        writer.join();
+    }
+    done.store(true);
+    for (auto&& reader : readers) {
+        reader.join();
+    }
+
+    ASSERT_LTE(cache.size(), static_cast<size_t>(numKeys / 2));
+}
+
+}  // namespace
+}  // namespace mongo
@@ -689,6 +689,7 @@ public:
 
         if (1 == solutions.size()) {
             // Only one possible plan. Build the stages from the solution.
+            solutions[0]->allowParallelExecution = true;
             auto result = makeResult();
             auto root = buildExecutableTree(*solutions[0]);
             result->emplace(std::move(root), std::move(solutions[0]));
@@ -1180,6 +1181,11 @@ StatusWith<std::unique_ptr<PlanExecutor, PlanExecutor::Deleter>> getClassicExecu
     if (!opDebug.classicEngineUsed) {
         opDebug.classicEngineUsed = true;
     }
+    if (internalQueryCacheEnableParameterizedClassicPlans.load()) {
+        // Parameterize the query, so that the classic plan cache can rebuild a cached plan from
+        // the parameters of the query.
+        canonicalQuery->parameterize();
+    }
     auto ws = std::make_unique<WorkingSet>();
     ClassicPrepareExecutionHelper helper{
         opCtx, collection, ws.get(), canonicalQuery.get(), nullptr, plannerOptions};
@@ -1149,6 +1149,11 @@ void IndexBoundsBuilder::_translatePredicate(const MatchExpression* expr,
                           "element"_attr = elt.toString());
             verify(0);
         }
+
+        // Geo predicates are never parameterized, so their bounds are constant.
+        if (ietBuilder != nullptr) {
+            ietBuilder->addConst(*oilOut);
+        }
     } else if (MatchExpression::INTERNAL_BUCKET_GEO_WITHIN == expr->matchType()) {
         const InternalBucketGeoWithinMatchExpression* ibgwme =
             static_cast<const InternalBucketGeoWithinMatchExpression*>(expr);
@@ -1167,6 +1172,10 @@ void IndexBoundsBuilder::_translatePredicate(const MatchExpression* expr,
                           "element"_attr = elt.toString());
             MONGO_UNREACHABLE_TASSERT(5837103);
         }
+
+        if (ietBuilder != nullptr) {
+            ietBuilder->addConst(*oilOut);
+        }
     } else {
         LOGV2_WARNING(20935,
                       "Planner error while trying to build bounds for expression",
@@ -1616,6 +1625,87 @@ bool IndexBoundsBuilder::isSingleInterval(const IndexBounds& bounds,
     }
 }
 
+namespace {
+/**
+ * Evaluates the nodes of an Interval Evaluation Tree into index bounds, in the same manner as
+ * translateAndIntersect(), translateAndUnion() and the translation of $not build them.
+ */
+class IntervalEvaluator {
+public:
+    IntervalEvaluator(const interval_evaluation_tree::InputParamIdMap& inputParams,
+                      const BSONElement& elt,
+                      const IndexEntry& index,
+                      std::vector<IndexBoundsBuilder::BoundsTightness>* tightnessOut)
+        : _inputParams{inputParams}, _elt{elt}, _index{index}, _tightnessOut{tightnessOut} {}
+
+    OrderedIntervalList operator()(const interval_evaluation_tree::IET&,
+                                   const interval_evaluation_tree::ConstNode& node) {
+        return node.oil;
+    }
+
+    OrderedIntervalList operator()(const interval_evaluation_tree::IET&,
+                                   const interval_evaluation_tree::EvalNode& node) {
+        auto it = _inputParams.find(node.inputParamId());
+        tassert(7132001,
+                str::stream() << "Missing value for input parameter " << node.inputParamId(),
+                it != _inputParams.end());
+        const auto* expr = it->second;
+        tassert(7132002,
+                str::stream() << "Unexpected match type " << expr->matchType()
+                              << " for input parameter " << node.inputParamId(),
+                expr->matchType() == node.matchType());
+
+        OrderedIntervalList oil;
+        auto tightness = IndexBoundsBuilder::EXACT;
+        IndexBoundsBuilder::translate(expr, _elt, _index, &oil, &tightness);
+        _tightnessOut->push_back(tightness);
+        return oil;
+    }
+
+    OrderedIntervalList operator()(const interval_evaluation_tree::IET&,
+                                   const interval_evaluation_tree::IntersectNode& node) {
+        auto oil = node.get<0>().visit(*this);
+        IndexBoundsBuilder::intersectize(node.get<1>().visit(*this), &oil);
+        return oil;
+    }
+
+    OrderedIntervalList operator()(const interval_evaluation_tree::IET&,
+                                   const interval_evaluation_tree::UnionNode& node) {
+        auto oil = node.get<0>().visit(*this);
+        auto rhs = node.get<1>().visit(*this);
+        oil.intervals.insert(oil.intervals.end(), rhs.intervals.begin(), rhs.intervals.end());
+        IndexBoundsBuilder::unionize(&oil);
+        return oil;
+    }
+
+    OrderedIntervalList operator()(const interval_evaluation_tree::IET&,
+                                   const interval_evaluation_tree::ComplementNode& node) {
+        auto oil = node.get<0>().visit(*this);
+        oil.complement();
+        return oil;
+    }
+
+private:
+    const interval_evaluation_tree::InputParamIdMap& _inputParams;
+    const BSONElement& _elt;
+    const IndexEntry& _index;
+    std::vector<IndexBoundsBuilder::BoundsTightness>* _tightnessOut;
+};
+}  // namespace
+
+// static
+void IndexBoundsBuilder::evaluateIntervals(
+    const interval_evaluation_tree::IET& iet,
+    const interval_evaluation_tree::InputParamIdMap& inputParams,
+    const BSONElement& elt,
+    const IndexEntry& index,
+    OrderedIntervalList* oilOut,
+    std::vector<BoundsTightness>* tightnessOut) {
+    IntervalEvaluator evaluator{inputParams, elt, index, tightnessOut};
+    auto oil = iet.visit(evaluator);
+    oilOut->intervals = std::move(oil.intervals);
+}
+
 // static
 bool IndexBoundsBuilder::isNullInterval(const OrderedIntervalList& oil) {
     // Checks if the the intervals are [undefined, undefined] and [null, null].
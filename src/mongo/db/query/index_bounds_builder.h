@@ -115,6 +115,20 @@ public:
                           BoundsTightness* tightnessOut,
                           interval_evaluation_tree::Builder* ietBuilder = nullptr);
 
+    /**
+     * Evaluates the Interval Evaluation Tree 'iet', which was built for the key pattern element
+     * 'elt' of index 'index', into a set of index bounds. The values of the parameters of the tree
+     * are taken from the parameterized predicates in 'inputParams', so 'oilOut' holds the bounds
+     * which translate() would build for these predicates. The tightness of the bounds of every
+     * evaluated predicate is appended to 'tightnessOut', in evaluation order.
+     */
+    static void evaluateIntervals(const interval_evaluation_tree::IET& iet,
+                                  const interval_evaluation_tree::InputParamIdMap& inputParams,
+                                  const BSONElement& elt,
+                                  const IndexEntry& index,
+                                  OrderedIntervalList* oilOut,
+                                  std::vector<BoundsTightness>* tightnessOut);
+
     /**
      * Creates bounds for 'expr' (indexed according to 'elt').  Intersects those bounds
      * with the bounds in oilOut, which is an in/out parameter.
@@ -37,6 +37,7 @@
 #include "mongo/db/query/index_entry.h"
 #include "mongo/db/query/optimizer/algebra/operator.h"
 #include "mongo/db/query/optimizer/algebra/polyvalue.h"
+#include "mongo/stdx/unordered_map.h"
 
 namespace mongo::interval_evaluation_tree {
 class ConstNode;
@@ -116,6 +117,12 @@ public:
     ComplementNode(IET child) : Base(std::move(child)) {}
 };
 
+/**
+ * Maps the input parameter ids of a parameterized query to the match expression nodes which hold
+ * the values of the parameters.
+ */
+using InputParamIdMap = stdx::unordered_map<MatchExpression::InputParamId, const MatchExpression*>;
+
 std::string ietToString(const IET& iet);
 std::string ietsToString(const IndexEntry& index, const std::vector<IET>& iets);
 
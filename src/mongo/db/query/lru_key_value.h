@@ -76,6 +76,10 @@ public:
         return _current;
     }
 
+    size_t maxBudget() const {
+        return _max;
+    }
+
     void reset(size_t newMaxSize) {
         _max = newMaxSize;
     }
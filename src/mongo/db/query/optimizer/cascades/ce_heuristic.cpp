@@ -91,10 +91,30 @@ public:
     }
 
     CEType transport(const BinaryJoinNode& node,
-                     CEType /*leftChildResult*/,
-                     CEType /*rightChildResult*/,
+                     CEType leftChildResult,
+                     CEType rightChildResult,
                      CEType /*exprResult*/) {
-        uasserted(6624039, "CE derivation not implemented.");
+        const LogicalProps& leftProps = getChildLogicalProps(node.getLeftChild());
+        const LogicalProps& rightProps = getChildLogicalProps(node.getRightChild());
+        const EquiJoinKeys joinKeys = extractEquiJoinKeys(
+            node.getFilter(),
+            getPropertyConst<ProjectionAvailability>(leftProps).getProjections(),
+            getPropertyConst<ProjectionAvailability>(rightProps).getProjections());
+
+        CEType result = leftChildResult * rightChildResult;
+        if (!joinKeys._leftKeys.empty()) {
+            // Assume the join keys are unique within each collection, so each side has as many
+            // distinct keys as its underlying collection has documents, and the keys of the side
+            // with fewer distinct keys are contained in the other side.
+            const CEType distinctKeys = std::max(getBaseCE(leftProps, leftChildResult),
+                                                 getBaseCE(rightProps, rightChildResult));
+            result /= std::max(distinctKeys, 1.0);
+        }
+        for (size_t i = 0; i < joinKeys._residualConjunctCount; i++) {
+            // Estimate the selectivity of each residual conjunct at 0.1, same as for filters.
+            result *= 0.1;
+        }
+        return result;
     }
 
     CEType transport(const UnionNode& node,
@@ -179,6 +199,30 @@ public:
 private:
     CEHeuristicTransport(const Memo& memo) : _memo(memo) {}
 
+    const LogicalProps& getChildLogicalProps(const ABT& child) const {
+        const auto* delegator = child.cast<MemoLogicalDelegatorNode>();
+        uassert(7131900, "Join children must be memo delegators", delegator != nullptr);
+        return _memo.getGroup(delegator->getGroupId())._logicalProperties;
+    }
+
+    /**
+     * Returns the cardinality of the largest collection scanned below a group, or 'childCE' if the
+     * group does not scan a collection.
+     */
+    CEType getBaseCE(const LogicalProps& props, const CEType childCE) const {
+        const auto& scanDefSet = getPropertyConst<CollectionAvailability>(props).getScanDefSet();
+        if (scanDefSet.empty()) {
+            return childCE;
+        }
+
+        CEType result = 0.0;
+        for (const auto& scanDefName : scanDefSet) {
+            const CEType metadataCE = _memo.getMetadata()._scanDefs.at(scanDefName).getCE();
+            result = std::max(result, (metadataCE < 0.0) ? 1000.00 : metadataCE);
+        }
+        return result;
+    }
+
     // We don't own this.
     const Memo& _memo;
 };
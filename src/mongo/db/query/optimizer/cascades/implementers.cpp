@@ -822,8 +822,150 @@ public:
     }
 
     void operator()(const ABT& /*n*/, const BinaryJoinNode& node) {
-        // TODO: optimize binary joins
-        uasserted(6624105, "not implemented");
+        if (node.getJoinType() != JoinType::Inner ||
+            !node.getCorrelatedProjectionNames().empty()) {
+            // Only uncorrelated inner joins are currently implemented.
+            return;
+        }
+        if (hasProperty<LimitSkipRequirement>(_physProps)) {
+            // We cannot satisfy limit-skip requirements.
+            return;
+        }
+
+        const auto& distribRequirement = getPropertyConst<DistributionRequirement>(_physProps);
+        if (distribRequirement.getDistributionAndProjections()._type !=
+            DistributionType::Centralized) {
+            // Joins are only performed on a single node for now.
+            return;
+        }
+
+        const GroupIdType leftGroupId =
+            node.getLeftChild().cast<MemoLogicalDelegatorNode>()->getGroupId();
+        const GroupIdType rightGroupId =
+            node.getRightChild().cast<MemoLogicalDelegatorNode>()->getGroupId();
+        const LogicalProps& leftLogicalProps = _memo.getGroup(leftGroupId)._logicalProperties;
+        const LogicalProps& rightLogicalProps = _memo.getGroup(rightGroupId)._logicalProperties;
+        const ProjectionNameSet& leftProjections =
+            getPropertyConst<ProjectionAvailability>(leftLogicalProps).getProjections();
+        const ProjectionNameSet& rightProjections =
+            getPropertyConst<ProjectionAvailability>(rightLogicalProps).getProjections();
+
+        // Split required projections between the two sides, and add the projections the join
+        // predicate refers to.
+        ProjectionNameOrderPreservingSet leftChildProjections;
+        ProjectionNameOrderPreservingSet rightChildProjections;
+        for (const ProjectionName& projectionName :
+             getPropertyConst<ProjectionRequirement>(_physProps).getProjections().getVector()) {
+            if (leftProjections.count(projectionName) > 0) {
+                leftChildProjections.emplace_back(projectionName);
+            } else if (rightProjections.count(projectionName) > 0) {
+                rightChildProjections.emplace_back(projectionName);
+            } else {
+                uasserted(7131901,
+                          "Required projection must appear in either the left or the right child "
+                          "projections");
+            }
+        }
+        for (const ProjectionName& projectionName : collectVariableReferences(node.getFilter())) {
+            if (leftProjections.count(projectionName) > 0) {
+                leftChildProjections.emplace_back(projectionName);
+            } else if (rightProjections.count(projectionName) > 0) {
+                rightChildProjections.emplace_back(projectionName);
+            }
+        }
+
+        PhysProps leftPhysProps = _physProps;
+        PhysProps rightPhysProps = _physProps;
+        removeProperty<CollationRequirement>(leftPhysProps);
+        removeProperty<CollationRequirement>(rightPhysProps);
+        getProperty<DistributionRequirement>(leftPhysProps).setDisableExchanges(false);
+        getProperty<DistributionRequirement>(rightPhysProps).setDisableExchanges(false);
+        setPropertyOverwrite<ProjectionRequirement>(leftPhysProps, std::move(leftChildProjections));
+        setPropertyOverwrite<ProjectionRequirement>(rightPhysProps,
+                                                    std::move(rightChildProjections));
+
+        const EquiJoinKeys joinKeys =
+            extractEquiJoinKeys(node.getFilter(), leftProjections, rightProjections);
+        const bool isEquiJoin =
+            !joinKeys._leftKeys.empty() && joinKeys._residualConjunctCount == 0;
+
+        if (hasProperty<CollationRequirement>(_physProps)) {
+            // A nested loop join preserves the order of its outer side, so we can satisfy a
+            // collation requirement only on left projections.
+            const ProjectionCollationSpec& collationSpec =
+                getPropertyConst<CollationRequirement>(_physProps).getCollationSpec();
+            for (const auto& [projectionName, op] : collationSpec) {
+                if (leftProjections.count(projectionName) == 0) {
+                    return;
+                }
+            }
+            setPropertyOverwrite<CollationRequirement>(leftPhysProps, collationSpec);
+        } else if (isEquiJoin) {
+            if (!_hints._disableHashJoin) {
+                // The right side is used to build the hash table.
+                ABT physicalJoin = make<HashJoinNode>(JoinType::Inner,
+                                                      joinKeys._leftKeys,
+                                                      joinKeys._rightKeys,
+                                                      node.getLeftChild(),
+                                                      node.getRightChild());
+                optimizeChildren<HashJoinNode>(_queue,
+                                               kDefaultPriority,
+                                               std::move(physicalJoin),
+                                               leftPhysProps,
+                                               rightPhysProps);
+            }
+
+            if (!_hints._disableMergeJoin) {
+                // Require both sides to be sorted on the join keys.
+                ProjectionCollationSpec leftCollationSpec;
+                ProjectionCollationSpec rightCollationSpec;
+                for (size_t i = 0; i < joinKeys._leftKeys.size(); i++) {
+                    leftCollationSpec.emplace_back(joinKeys._leftKeys.at(i),
+                                                   CollationOp::Ascending);
+                    rightCollationSpec.emplace_back(joinKeys._rightKeys.at(i),
+                                                    CollationOp::Ascending);
+                }
+
+                PhysProps leftPhysPropsLocal = leftPhysProps;
+                PhysProps rightPhysPropsLocal = rightPhysProps;
+                setPropertyOverwrite<CollationRequirement>(leftPhysPropsLocal,
+                                                           std::move(leftCollationSpec));
+                setPropertyOverwrite<CollationRequirement>(rightPhysPropsLocal,
+                                                           std::move(rightCollationSpec));
+
+                ABT physicalJoin = make<MergeJoinNode>(
+                    joinKeys._leftKeys,
+                    joinKeys._rightKeys,
+                    std::vector<CollationOp>(joinKeys._leftKeys.size(), CollationOp::Ascending),
+                    node.getLeftChild(),
+                    node.getRightChild());
+                optimizeChildren<MergeJoinNode>(_queue,
+                                                kDefaultPriority,
+                                                std::move(physicalJoin),
+                                                std::move(leftPhysPropsLocal),
+                                                std::move(rightPhysPropsLocal));
+            }
+        }
+
+        // Nested loop join. The inner side is executed once for each row of the outer side.
+        CEType estimatedRepetitions = hasProperty<RepetitionEstimate>(_physProps)
+            ? getPropertyConst<RepetitionEstimate>(_physProps).getEstimate()
+            : 1.0;
+        estimatedRepetitions *=
+            getPropertyConst<CardinalityEstimate>(leftLogicalProps).getEstimate();
+        setPropertyOverwrite<RepetitionEstimate>(rightPhysProps,
+                                                 RepetitionEstimate{estimatedRepetitions});
+
+        ABT physicalJoin = make<BinaryJoinNode>(JoinType::Inner,
+                                                ProjectionNameSet{},
+                                                node.getFilter(),
+                                                node.getLeftChild(),
+                                                node.getRightChild());
+        optimizeChildren<BinaryJoinNode>(_queue,
+                                         kDefaultPriority,
+                                         std::move(physicalJoin),
+                                         std::move(leftPhysProps),
+                                         std::move(rightPhysProps));
     }
 
     void operator()(const ABT& n, const UnionNode& node) {
@@ -248,12 +248,24 @@ public:
     }
 
     LogicalProps transport(const BinaryJoinNode& node,
-                           LogicalProps /*leftChildResult*/,
-                           LogicalProps /*rightChildResult*/,
+                           LogicalProps leftChildResult,
+                           LogicalProps rightChildResult,
                            LogicalProps /*exprResult*/) {
-        // TODO: remove indexing availability property when implemented.
-        // TODO: combine scan defs from all children for CollectionAvailability.
-        uasserted(6624043, "Logical property derivation not implemented.");
+        // We are specifically not adding the node's projections to ProjectionAvailability here.
+        // The logical properties already contains projection availability which is derived first
+        // when the memo group is created.
+        LogicalProps result = std::move(leftChildResult);
+        auto childScanDefs = getProperty<CollectionAvailability>(rightChildResult).getScanDefSet();
+        getProperty<CollectionAvailability>(result).getScanDefSet().merge(
+            std::move(childScanDefs));
+
+        // The join is performed on a single node, regardless of how the children are distributed.
+        auto& distributions = getProperty<DistributionAvailability>(result).getDistributionSet();
+        distributions.clear();
+        addCentralizedAndRoundRobinDistributions<false /*addRoundRobin*/>(distributions);
+
+        removeProperty<IndexingAvailability>(result);
+        return maybeUpdateNodePropsMap(node, std::move(result));
     }
 
     LogicalProps transport(const UnionNode& node,
@@ -34,6 +34,7 @@ namespace mongo::optimizer::cascades {
 
 LogicalRewriter::RewriteSet LogicalRewriter::_explorationSet = {
     {LogicalRewriteType::GroupByExplore, 1},
+    {LogicalRewriteType::BinaryJoinExplore, 1},
     {LogicalRewriteType::SargableSplit, 2},
     {LogicalRewriteType::FilterRIDIntersectReorder, 2},
     {LogicalRewriteType::EvaluationRIDIntersectReorder, 2}};
@@ -55,6 +56,7 @@ LogicalRewriter::RewriteSet LogicalRewriter::_substitutionSet = {
     {LogicalRewriteType::ExchangeEvaluationReorder, 1},
 
     {LogicalRewriteType::FilterUnionReorder, 1},
+    {LogicalRewriteType::FilterBinaryJoinReorder, 1},
 
     {LogicalRewriteType::CollationMerge, 1},
     {LogicalRewriteType::LimitSkipMerge, 1},
@@ -382,6 +384,35 @@ struct SubstituteReorder<FilterNode, UnionNode> {
     }
 };
 
+template <>
+struct SubstituteReorder<FilterNode, BinaryJoinNode> {
+    void operator()(ABT::reference_type aboveNode,
+                    ABT::reference_type belowNode,
+                    RewriteContext& ctx) const {
+        const BinaryJoinNode& node = *belowNode.cast<BinaryJoinNode>();
+        if (node.getJoinType() != JoinType::Inner || !node.getCorrelatedProjectionNames().empty()) {
+            return;
+        }
+
+        const ReorderDependencies leftDeps =
+            computeDependencies<FilterNode, BinaryJoinNode, LeftChildAccessor>(
+                aboveNode, belowNode, ctx);
+        const ReorderDependencies rightDeps =
+            computeDependencies<FilterNode, BinaryJoinNode, RightChildAccessor>(
+                aboveNode, belowNode, ctx);
+
+        if (!rightDeps._hasChildRef) {
+            // Push the filter into the left side.
+            defaultReorder<FilterNode, BinaryJoinNode, DefaultChildAccessor, LeftChildAccessor>(
+                aboveNode, belowNode, ctx);
+        } else if (!leftDeps._hasChildRef) {
+            // Push the filter into the right side.
+            defaultReorder<FilterNode, BinaryJoinNode, DefaultChildAccessor, RightChildAccessor>(
+                aboveNode, belowNode, ctx);
+        }
+    }
+};
+
 template <class AboveType>
 void unwindBelowReorder(ABT::reference_type aboveNode,
                         ABT::reference_type unwindNode,
@@ -1022,6 +1053,103 @@ struct ExploreConvert<GroupByNode> {
     }
 };
 
+static const ProjectionNameSet& getGroupProjections(const Memo& memo, const ABT& node) {
+    const GroupIdType groupId = node.cast<MemoLogicalDelegatorNode>()->getGroupId();
+    return properties::getPropertyConst<properties::ProjectionAvailability>(
+               memo.getGroup(groupId)._logicalProperties)
+        .getProjections();
+}
+
+static bool isReorderableJoin(const BinaryJoinNode& node) {
+    return node.getJoinType() == JoinType::Inner && node.getCorrelatedProjectionNames().empty();
+}
+
+template <>
+struct ExploreConvert<BinaryJoinNode> {
+    void operator()(ABT::reference_type node, RewriteContext& ctx) {
+        using namespace properties;
+
+        const BinaryJoinNode& joinNode = *node.cast<BinaryJoinNode>();
+        if (!isReorderableJoin(joinNode)) {
+            return;
+        }
+        if (getPropertyConst<CollectionAvailability>(ctx.getAboveLogicalProps())
+                .getScanDefSet()
+                .size() > LogicalRewriter::kMaxJoinReorderCollectionCount) {
+            return;
+        }
+
+        // Copy the node's components since adding nodes to the memo may invalidate the reference.
+        const ABT filter = joinNode.getFilter();
+        const ABT leftChild = joinNode.getLeftChild();
+        const ABT rightChild = joinNode.getRightChild();
+
+        const Memo& memo = ctx.getMemo();
+        const ProjectionNameSet& rightProjections = getGroupProjections(memo, rightChild);
+        const VariableNameSetType filterReferences = collectVariableReferences(filter);
+
+        // Returns true if the predicate can be evaluated over the join of 'input' and the right
+        // child, and refers to 'input', so we do not introduce a cross product.
+        const auto canJoinWithRightChild = [&](const ProjectionNameSet& input,
+                                               const ProjectionNameSet& other) {
+            bool refersToInput = false;
+            for (const std::string& varName : filterReferences) {
+                if (input.count(varName) > 0) {
+                    refersToInput = true;
+                } else if (other.count(varName) > 0 && rightProjections.count(varName) == 0) {
+                    return false;
+                }
+            }
+            return refersToInput;
+        };
+
+        // (A join B) join C -> A join (B join C), if the top predicate refers only to B and C. We
+        // also consider the commuted inputs of the left join, that is (A join B) join C -> B join
+        // (A join C), since the left group may not be fully explored yet.
+        ABTVector newNodes;
+        const GroupIdType leftGroupId = leftChild.cast<MemoLogicalDelegatorNode>()->getGroupId();
+        const auto& leftGroupNodes = memo.getGroup(leftGroupId)._logicalNodes;
+        for (size_t index = 0; index < leftGroupNodes.size(); index++) {
+            const auto* childJoinPtr = leftGroupNodes.at(index).cast<BinaryJoinNode>();
+            if (childJoinPtr == nullptr || !isReorderableJoin(*childJoinPtr)) {
+                continue;
+            }
+
+            const ABT& childLeft = childJoinPtr->getLeftChild();
+            const ABT& childRight = childJoinPtr->getRightChild();
+            const ProjectionNameSet& childLeftProjections = getGroupProjections(memo, childLeft);
+            const ProjectionNameSet& childRightProjections = getGroupProjections(memo, childRight);
+
+            if (canJoinWithRightChild(childRightProjections, childLeftProjections)) {
+                newNodes.push_back(make<BinaryJoinNode>(
+                    JoinType::Inner,
+                    ProjectionNameSet{},
+                    childJoinPtr->getFilter(),
+                    childLeft,
+                    make<BinaryJoinNode>(
+                        JoinType::Inner, ProjectionNameSet{}, filter, childRight, rightChild)));
+            }
+            if (canJoinWithRightChild(childLeftProjections, childRightProjections)) {
+                newNodes.push_back(make<BinaryJoinNode>(
+                    JoinType::Inner,
+                    ProjectionNameSet{},
+                    childJoinPtr->getFilter(),
+                    childRight,
+                    make<BinaryJoinNode>(
+                        JoinType::Inner, ProjectionNameSet{}, filter, childLeft, rightChild)));
+            }
+        }
+
+        // A join B -> B join A.
+        newNodes.push_back(make<BinaryJoinNode>(
+            JoinType::Inner, ProjectionNameSet{}, filter, rightChild, leftChild));
+
+        for (const ABT& newNode : newNodes) {
+            ctx.addNode(newNode, false /*substitute*/);
+        }
+    }
+};
+
 template <class AboveType, class BelowType>
 struct ExploreReorder {
     void operator()(ABT::reference_type aboveNode,
@@ -1125,6 +1253,9 @@ void LogicalRewriter::initializeRewrites() {
 
     registerRewrite(LogicalRewriteType::FilterUnionReorder,
                     &LogicalRewriter::bindAboveBelow<FilterNode, UnionNode, SubstituteReorder>);
+    registerRewrite(
+        LogicalRewriteType::FilterBinaryJoinReorder,
+        &LogicalRewriter::bindAboveBelow<FilterNode, BinaryJoinNode, SubstituteReorder>);
 
     registerRewrite(
         LogicalRewriteType::CollationMerge,
@@ -1169,6 +1300,8 @@ void LogicalRewriter::initializeRewrites() {
 
     registerRewrite(LogicalRewriteType::GroupByExplore,
                     &LogicalRewriter::bindSingleNode<GroupByNode, ExploreConvert>);
+    registerRewrite(LogicalRewriteType::BinaryJoinExplore,
+                    &LogicalRewriter::bindSingleNode<BinaryJoinNode, ExploreConvert>);
     registerRewrite(LogicalRewriteType::SargableSplit,
                     &LogicalRewriter::bindSingleNode<SargableNode, ExploreConvert>);
 
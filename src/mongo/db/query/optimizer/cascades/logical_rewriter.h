@@ -53,6 +53,12 @@ public:
      */
     static constexpr size_t kMaxSargableNodeSplitCount = 2;
 
+    /**
+     * Maximum number of collections joined below a binary join for which we explore join orders.
+     * The number of enumerated join trees grows exponentially with the number of inputs.
+     */
+    static constexpr size_t kMaxJoinReorderCollectionCount = 6;
+
     /**
      * Map of rewrite type to rewrite priority
      */
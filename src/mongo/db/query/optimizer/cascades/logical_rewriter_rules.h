@@ -51,6 +51,7 @@ namespace mongo::optimizer::cascades {
     F(ExchangeEvaluationReorder)                                  \
                                                                   \
     F(FilterUnionReorder)                                         \
+    F(FilterBinaryJoinReorder)                                    \
                                                                   \
     /* Merging rewrites. */                                       \
     F(CollationMerge)                                             \
@@ -60,6 +61,9 @@ namespace mongo::optimizer::cascades {
     /* Local-global optimization for GroupBy */                   \
     F(GroupByExplore)                                             \
                                                                   \
+    /* Join enumeration */                                        \
+    F(BinaryJoinExplore)                                          \
+                                                                  \
     F(SargableFilterReorder)                                      \
     F(SargableEvaluationReorder)                                  \
                                                                   \
@@ -246,6 +246,12 @@ struct QueryHints {
     // Disable placing a group-by and union based RIDIntersect implementation.
     bool _disableGroupByAndUnionRIDIntersect = false;
 
+    // Disable placing a hash-join when implementing a binary join.
+    bool _disableHashJoin = false;
+
+    // Disable placing a merge-join when implementing a binary join.
+    bool _disableMergeJoin = false;
+
     // If set keep track of rejected plans in the memo.
     bool _keepRejectedPlans = false;
 
@@ -400,7 +400,8 @@ const ProjectionNameSet& BinaryJoinNode::getCorrelatedProjectionNames() const {
 bool BinaryJoinNode::operator==(const BinaryJoinNode& other) const {
     return _joinType == other._joinType &&
         _correlatedProjectionNames == other._correlatedProjectionNames &&
-        getLeftChild() == other.getLeftChild() && getRightChild() == other.getRightChild();
+        getFilter() == other.getFilter() && getLeftChild() == other.getLeftChild() &&
+        getRightChild() == other.getRightChild();
 }
 
 const ABT& BinaryJoinNode::getLeftChild() const {
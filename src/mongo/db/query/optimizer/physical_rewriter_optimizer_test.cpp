@@ -4746,5 +4746,115 @@ TEST(PhysRewriter, UnionRewrite) {
         optimized);
 }
 
+/**
+ * Builds the joins generated for a chain of two $lookup stages from 'test1' into 'test2' and
+ * 'test3', with a filter on 'test3' above the joins.
+ */
+static ABT makeLookupChainJoins() {
+    using namespace properties;
+
+    ABT scanNode1 = make<ScanNode>("ptest1", "test1");
+    ABT evalNode1 = make<EvaluationNode>(
+        "pKey12",
+        make<EvalPath>(make<PathGet>("a", make<PathIdentity>()), make<Variable>("ptest1")),
+        std::move(scanNode1));
+    ABT evalNode2 = make<EvaluationNode>(
+        "pKey13",
+        make<EvalPath>(make<PathGet>("b", make<PathIdentity>()), make<Variable>("ptest1")),
+        std::move(evalNode1));
+
+    ABT scanNode2 = make<ScanNode>("ptest2", "test2");
+    ABT evalNode3 = make<EvaluationNode>(
+        "pKey2",
+        make<EvalPath>(make<PathGet>("a", make<PathIdentity>()), make<Variable>("ptest2")),
+        std::move(scanNode2));
+
+    ABT scanNode3 = make<ScanNode>("ptest3", "test3");
+    ABT evalNode4 = make<EvaluationNode>(
+        "pKey3",
+        make<EvalPath>(make<PathGet>("b", make<PathIdentity>()), make<Variable>("ptest3")),
+        std::move(scanNode3));
+
+    ABT joinNode1 = make<BinaryJoinNode>(
+        JoinType::Inner,
+        ProjectionNameSet{},
+        make<BinaryOp>(Operations::Eq, make<Variable>("pKey12"), make<Variable>("pKey2")),
+        std::move(evalNode2),
+        std::move(evalNode3));
+    ABT joinNode2 = make<BinaryJoinNode>(
+        JoinType::Inner,
+        ProjectionNameSet{},
+        make<BinaryOp>(Operations::Eq, make<Variable>("pKey13"), make<Variable>("pKey3")),
+        std::move(joinNode1),
+        std::move(evalNode4));
+
+    ABT filterNode = make<FilterNode>(
+        make<EvalFilter>(make<PathGet>("c", make<PathCompare>(Operations::Eq, Constant::int64(1))),
+                         make<Variable>("ptest3")),
+        std::move(joinNode2));
+
+    return make<RootNode>(ProjectionRequirement{ProjectionNameVector{"ptest1", "ptest2", "ptest3"}},
+                          std::move(filterNode));
+}
+
+static Metadata makeLookupChainMetadata() {
+    return {{{"test1", {{}, {}, {DistributionType::Centralized}, true /*exists*/, 10000.0}},
+             {"test2", {{}, {}, {DistributionType::Centralized}, true /*exists*/, 100.0}},
+             {"test3", {{}, {}, {DistributionType::Centralized}, true /*exists*/, 1000.0}}}};
+}
+
+TEST(PhysRewriter, JoinReorder) {
+    PrefixId prefixId;
+    OptPhaseManager phaseManager(
+        {OptPhaseManager::OptPhase::MemoSubstitutionPhase,
+         OptPhaseManager::OptPhase::MemoExplorationPhase,
+         OptPhaseManager::OptPhase::MemoImplementationPhase},
+        prefixId,
+        makeLookupChainMetadata(),
+        {true /*debugMode*/, 2 /*debugLevel*/, DebugInfo::kIterationLimitForTests});
+
+    ABT optimized = makeLookupChainJoins();
+    ASSERT_TRUE(phaseManager.optimize(optimized));
+
+    // Both joins are commuted, and the top join is re-associated to join 'test1' with 'test3'
+    // first.
+    const Memo& memo = phaseManager.getMemo();
+    size_t joinCount = 0;
+    for (size_t groupId = 0; groupId < memo.getGroupCount(); groupId++) {
+        for (const ABT& node : memo.getGroup(groupId)._logicalNodes.getVector()) {
+            if (node.is<BinaryJoinNode>()) {
+                joinCount++;
+            }
+        }
+    }
+    ASSERT_GTE(joinCount, 5);
+
+    // The filter is pushed below the joins, and we do not pick a nested loop join.
+    const ABT& rootChild = optimized.cast<RootNode>()->getChild();
+    ASSERT_TRUE(rootChild.is<HashJoinNode>() || rootChild.is<MergeJoinNode>());
+    ASSERT_EQ(std::string::npos, ExplainGenerator::explainV2(optimized).find("BinaryJoin"));
+}
+
+TEST(PhysRewriter, JoinNestedLoop) {
+    PrefixId prefixId;
+    OptPhaseManager phaseManager(
+        {OptPhaseManager::OptPhase::MemoSubstitutionPhase,
+         OptPhaseManager::OptPhase::MemoExplorationPhase,
+         OptPhaseManager::OptPhase::MemoImplementationPhase},
+        prefixId,
+        makeLookupChainMetadata(),
+        {true /*debugMode*/, 2 /*debugLevel*/, DebugInfo::kIterationLimitForTests});
+    phaseManager.getHints()._disableHashJoin = true;
+    phaseManager.getHints()._disableMergeJoin = true;
+
+    ABT optimized = makeLookupChainJoins();
+    ASSERT_TRUE(phaseManager.optimize(optimized));
+
+    const std::string explain = ExplainGenerator::explainV2(optimized);
+    ASSERT_EQ(std::string::npos, explain.find("HashJoin"));
+    ASSERT_EQ(std::string::npos, explain.find("MergeJoin"));
+    ASSERT_NE(std::string::npos, explain.find("BinaryJoin [joinType: Inner]"));
+}
+
 }  // namespace
 }  // namespace mongo::optimizer
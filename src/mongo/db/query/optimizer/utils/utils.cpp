@@ -183,6 +183,51 @@ CollationSplitResult splitCollationSpec(const ProjectionName& ridProjName,
 
     return {true /*validSplit*/, std::move(leftCollationSpec), std::move(rightCollationSpec)};
 }
+
+static void extractEquiJoinKeys(const ABT& filter,
+                                const ProjectionNameSet& leftProjections,
+                                const ProjectionNameSet& rightProjections,
+                                EquiJoinKeys& result) {
+    if (const auto* binaryOp = filter.cast<BinaryOp>(); binaryOp != nullptr) {
+        if (binaryOp->op() == Operations::And) {
+            extractEquiJoinKeys(
+                binaryOp->getLeftChild(), leftProjections, rightProjections, result);
+            extractEquiJoinKeys(
+                binaryOp->getRightChild(), leftProjections, rightProjections, result);
+            return;
+        }
+
+        const auto* leftVar = binaryOp->getLeftChild().cast<Variable>();
+        const auto* rightVar = binaryOp->getRightChild().cast<Variable>();
+        if (binaryOp->op() == Operations::Eq && leftVar != nullptr && rightVar != nullptr) {
+            if (leftProjections.count(leftVar->name()) > 0 &&
+                rightProjections.count(rightVar->name()) > 0) {
+                result._leftKeys.push_back(leftVar->name());
+                result._rightKeys.push_back(rightVar->name());
+                return;
+            }
+            if (leftProjections.count(rightVar->name()) > 0 &&
+                rightProjections.count(leftVar->name()) > 0) {
+                result._leftKeys.push_back(rightVar->name());
+                result._rightKeys.push_back(leftVar->name());
+                return;
+            }
+        }
+    } else if (filter == Constant::boolean(true)) {
+        return;
+    }
+
+    result._residualConjunctCount++;
+}
+
+EquiJoinKeys extractEquiJoinKeys(const ABT& filter,
+                                 const ProjectionNameSet& leftProjections,
+                                 const ProjectionNameSet& rightProjections) {
+    EquiJoinKeys result;
+    extractEquiJoinKeys(filter, leftProjections, rightProjections, result);
+    return result;
+}
+
 /**
  * Helper class used to extract variable references from a node.
  */
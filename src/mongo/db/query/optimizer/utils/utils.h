@@ -127,6 +127,23 @@ CollationSplitResult splitCollationSpec(const ProjectionName& ridProjName,
                                         const ProjectionNameSet& leftProjections,
                                         const ProjectionNameSet& rightProjections);
 
+struct EquiJoinKeys {
+    ProjectionNameVector _leftKeys;
+    ProjectionNameVector _rightKeys;
+
+    // Number of conjuncts of the join predicate which are not equalities between a left and a right
+    // projection.
+    size_t _residualConjunctCount = 0;
+};
+
+/**
+ * Split the conjuncts of a join predicate into equalities between a projection of the left and a
+ * projection of the right side, and residual conjuncts.
+ */
+EquiJoinKeys extractEquiJoinKeys(const ABT& filter,
+                                 const ProjectionNameSet& leftProjections,
+                                 const ProjectionNameSet& rightProjections);
+
 /**
  * Used to extract variable references from a node.
  */
@@ -29,8 +29,7 @@
 
 #pragma once
 
-#include "mongo/db/catalog/util/partitioned.h"
-#include "mongo/db/query/lru_key_value.h"
+#include "mongo/db/query/concurrent_lru_key_value.h"
 #include "mongo/db/query/plan_cache_callbacks.h"
 #include "mongo/db/query/plan_cache_debug_info.h"
 #include "mongo/platform/mutex.h"
@@ -268,8 +267,12 @@ private:
  * A data structure for caching execution plans, to avoid repeatedly performing query optimization
  * and plan compilation on each invocation of a query. The cache is logically a mapping from
  * 'KeyType' to 'CachedPlanType'. The cache key is derived from the query, and can be used to
- * determine whether a cached plan is available. The cache has an LRU replacement policy, so it only
- * keeps the most recently used plans.
+ * determine whether a cached plan is available. The cache has an approximate LRU replacement
+ * policy, so it only keeps the most recently used plans.
+ *
+ * Lookups do not take any lock, and cached plans are cloned for the caller without blocking other
+ * lookups or writers. Plan cache entries are immutable once they are in the cache: changes to the
+ * state of an entry replace it with an updated copy.
  */
 template <class KeyType,
           class CachedPlanType,
@@ -284,7 +287,7 @@ private:
 
 public:
     using Entry = PlanCacheEntryBase<CachedPlanType, DebugInfoType>;
-    using Lru = LRUKeyValue<KeyType, Entry, BudgetEstimator, KeyHasher>;
+    using Store = ConcurrentLRUKeyValue<KeyType, Entry, BudgetEstimator, Partitioner, KeyHasher>;
 
     // We have three states for a cache entry to be in. Rather than just 'present' or 'not
     // present', we use a notion of 'inactive entries' as a way of remembering how performant our
@@ -314,14 +317,14 @@ public:
     };
 
     /**
-     * Initialize plan cache with the total cache size in bytes and number of partitions.
+     * Initialize plan cache with the total cache size in bytes and number of partitions. With the
+     * background eviction policy, the owner of the cache must call evictIfOverBudget()
+     * periodically.
      */
-    explicit PlanCacheBase(size_t cacheSize, size_t numPartitions = 1)
-        : _numPartitions(numPartitions) {
-        invariant(numPartitions > 0);
-        Lru lru{cacheSize / numPartitions};
-        _partitionedCache = std::make_unique<Partitioned<Lru, Partitioner>>(numPartitions, lru);
-    }
+    explicit PlanCacheBase(size_t cacheSize,
+                           size_t numPartitions = 1,
+                           LRUEvictionPolicy evictionPolicy = LRUEvictionPolicy::kInline)
+        : _store(cacheSize, numPartitions, evictionPolicy) {}
 
     ~PlanCacheBase() = default;
 
@@ -364,23 +367,10 @@ public:
                                      }},
             why.stats);
 
-        auto partition = _partitionedCache->lockOnePartition(key);
-        auto [queryHash, planCacheKey, isNewEntryActive, shouldBeCreated] = [&]() {
-            if (internalQueryCacheDisableInactiveEntries.load()) {
-                // All entries are always active.
-                return std::make_tuple(key.queryHash(),
-                                       key.planCacheKeyHash(),
-                                       true /* isNewEntryActive  */,
-                                       true /* shouldBeCreated  */);
-            } else {
-                auto oldEntryWithStatus = partition->get(key);
-                tassert(6007020,
-                        "LRU store must get value or NoSuchKey error code",
-                        oldEntryWithStatus.isOK() ||
-                            oldEntryWithStatus.getStatus() == ErrorCodes::NoSuchKey);
-                Entry* oldEntry =
-                    oldEntryWithStatus.isOK() ? oldEntryWithStatus.getValue() : nullptr;
-
+        _store.update(key, [&](const Entry* oldEntry) -> std::unique_ptr<Entry> {
+            // All entries are always active if inactive entries are disabled.
+            bool isNewEntryActive = true;
+            if (!internalQueryCacheDisableInactiveEntries.load()) {
                 const auto newState = getNewEntryState(
                     key,
                     oldEntry,
@@ -388,33 +378,34 @@ public:
                     worksGrowthCoefficient.get_value_or(internalQueryCacheWorksGrowthCoefficient),
                     callbacks);
 
-                // Avoid recomputing the hashes if we've got an old entry to grab them from.
-                return oldEntry ? std::make_tuple(oldEntry->queryHash,
-                                                  oldEntry->planCacheKey,
-                                                  newState.shouldBeActive,
-                                                  newState.shouldBeCreated)
-                                : std::make_tuple(key.queryHash(),
-                                                  key.planCacheKeyHash(),
-                                                  newState.shouldBeActive,
-                                                  newState.shouldBeCreated);
-            }
-        }();
+                if (newState.increasedWorks) {
+                    // Lookups may be reading the old entry concurrently, so replace it with a copy
+                    // which only differs in 'works' rather than modifying it.
+                    auto updatedEntry = oldEntry->clone();
+                    updatedEntry->works = *newState.increasedWorks;
+                    return updatedEntry;
+                }
 
-        if (!shouldBeCreated) {
-            return Status::OK();
-        }
+                if (!newState.shouldBeCreated) {
+                    return nullptr;
+                }
+                isNewEntryActive = newState.shouldBeActive;
+            }
 
-        // We use callback function here to build the 'DebugInfo' rather than pass in a constructed
-        // DebugInfo for performance.
-        auto newEntry(Entry::create(std::move(cachedPlan),
-                                    queryHash,
-                                    planCacheKey,
-                                    now,
-                                    isNewEntryActive,
-                                    newWorks,
-                                    callbacks->buildDebugInfo()));
-
-        partition->add(key, newEntry.release());
+            // Avoid recomputing the hashes if we've got an old entry to grab them from.
+            const auto queryHash = oldEntry ? oldEntry->queryHash : key.queryHash();
+            const auto planCacheKey = oldEntry ? oldEntry->planCacheKey : key.planCacheKeyHash();
+
+            // We use callback function here to build the 'DebugInfo' rather than pass in a
+            // constructed DebugInfo for performance.
+            return Entry::create(std::move(cachedPlan),
+                                 queryHash,
+                                 planCacheKey,
+                                 now,
+                                 isNewEntryActive,
+                                 newWorks,
+                                 callbacks->buildDebugInfo());
+        });
         return Status::OK();
     }
 
@@ -429,10 +420,38 @@ public:
         invariant(plan);
         auto entry = Entry::createPinned(
             std::move(plan), key.queryHash(), key.planCacheKeyHash(), now, std::move(debugInfo));
-        auto partition = _partitionedCache->lockOnePartition(key);
         // We're not interested in the number of evicted entries if the cache store exceeds the
         // budget after add(), so we just ignore the return value.
-        partition->add(key, entry.release());
+        _store.add(key, std::move(entry));
+    }
+
+    /**
+     * Adds an active cache entry for 'cachedPlan' with the given 'works' value, unless there is
+     * already an entry for 'key'. Used to restore entries from a plan cache snapshot: the plan has
+     * already won a trial period before the snapshot was taken, so it does not need to be vetted
+     * as an inactive entry again. Returns whether the entry was added.
+     */
+    bool setActiveIfAbsent(const KeyType& key,
+                           std::unique_ptr<CachedPlanType> cachedPlan,
+                           size_t works,
+                           Date_t now,
+                           DebugInfoType debugInfo) {
+        invariant(cachedPlan);
+        bool added = false;
+        _store.update(key, [&](const Entry* oldEntry) -> std::unique_ptr<Entry> {
+            if (oldEntry) {
+                return nullptr;
+            }
+            added = true;
+            return Entry::create(std::move(cachedPlan),
+                                 key.queryHash(),
+                                 key.planCacheKeyHash(),
+                                 now,
+                                 true,  // isActive
+                                 works,
+                                 std::move(debugInfo));
+        });
+        return added;
     }
 
     /**
@@ -446,16 +465,16 @@ public:
             return;
         }
 
-        auto partition = _partitionedCache->lockOnePartition(key);
-        auto entry = partition->get(key);
-        if (!entry.isOK()) {
-            tassert(6007021,
-                    "Unexpected error code from LRU store",
-                    entry.getStatus() == ErrorCodes::NoSuchKey);
-            return;
-        }
-        tassert(6007022, "LRU store must get a value or an error code", entry.getValue());
-        entry.getValue()->isActive = false;
+        _store.update(key, [](const Entry* entry) -> std::unique_ptr<Entry> {
+            if (!entry || !entry->isActive) {
+                return nullptr;
+            }
+
+            // Lookups may be reading the entry concurrently, so replace it with an inactive copy.
+            auto inactiveEntry = entry->clone();
+            inactiveEntry->isActive = false;
+            return inactiveEntry;
+        });
     }
 
     /**
@@ -466,21 +485,16 @@ public:
      * for the query (if there is one).
      */
     GetResult get(const KeyType& key) const {
-        auto partition = _partitionedCache->lockOnePartition(key);
-        auto entry = partition->get(key);
-        if (!entry.isOK()) {
-            tassert(6007023,
-                    "Unexpected error code from LRU store",
-                    entry.getStatus() == ErrorCodes::NoSuchKey);
-            return {CacheEntryState::kNotPresent, nullptr};
-        }
-        tassert(6007024, "LRU store must get a value or an error code", entry.getValue());
+        return _store.withValue(key, [](const Entry* entry) -> GetResult {
+            if (!entry) {
+                return {CacheEntryState::kNotPresent, nullptr};
+            }
 
-        auto state = entry.getValue()->isActive ? CacheEntryState::kPresentActive
-                                                : CacheEntryState::kPresentInactive;
-        return {
-            state,
-            std::make_unique<CachedPlanHolder<CachedPlanType, DebugInfoType>>(*entry.getValue())};
+            auto state = entry->isActive ? CacheEntryState::kPresentActive
+                                         : CacheEntryState::kPresentInactive;
+            return {state,
+                    std::make_unique<CachedPlanHolder<CachedPlanType, DebugInfoType>>(*entry)};
+        });
     }
 
     /**
@@ -503,7 +517,7 @@ public:
      * the cache, this call is a no-op.
      */
     void remove(const KeyType& key) {
-        _partitionedCache->erase(key);
+        _store.erase(key);
     }
 
     /**
@@ -512,19 +526,14 @@ public:
      */
     template <typename UnaryPredicate>
     size_t removeIf(UnaryPredicate predicate) {
-        size_t nRemoved = 0;
-        for (size_t partitionId = 0; partitionId < _numPartitions; ++partitionId) {
-            auto lockedPartition = _partitionedCache->lockOnePartitionById(partitionId);
-            nRemoved += lockedPartition->removeIf(predicate);
-        }
-        return nRemoved;
+        return _store.removeIf(predicate);
     }
 
     /**
      * Remove *all* cached plans.  Does not clear index information.
      */
     void clear() {
-        _partitionedCache->clear();
+        _store.clear();
     }
 
     /**
@@ -532,10 +541,16 @@ public:
      * evicted in order to ensure that the cache fits within the new budget.
      */
     void reset(size_t cacheSize) {
-        for (size_t partitionId = 0; partitionId < _numPartitions; ++partitionId) {
-            auto lockedPartition = _partitionedCache->lockOnePartitionById(partitionId);
-            lockedPartition->reset(cacheSize / _numPartitions);
-        }
+        _store.reset(cacheSize);
+    }
+
+    /**
+     * Evicts the least recently used entries until the cache fits within its budget again. Must be
+     * called periodically if the cache uses the background eviction policy. Returns the number of
+     * evicted entries.
+     */
+    size_t evictIfOverBudget() {
+        return _store.evictIfOverBudget();
     }
 
     /**
@@ -544,14 +559,12 @@ public:
      * If there is no entry in the cache for the 'query', returns an error Status.
      */
     StatusWith<std::unique_ptr<Entry>> getEntry(const KeyType& key) const {
-        auto partition = _partitionedCache->lockOnePartition(key);
-        auto entry = partition->get(key);
-        if (!entry.isOK()) {
-            return entry.getStatus();
-        }
-        invariant(entry.getValue());
-
-        return std::unique_ptr<Entry>(entry.getValue()->clone());
+        return _store.withValue(key, [](const Entry* entry) -> StatusWith<std::unique_ptr<Entry>> {
+            if (!entry) {
+                return Status(ErrorCodes::NoSuchKey, "no such key in the plan cache");
+            }
+            return entry->clone();
+        });
     }
 
     /**
@@ -559,15 +572,8 @@ public:
      */
     std::vector<std::unique_ptr<Entry>> getAllEntries() const {
         std::vector<std::unique_ptr<Entry>> entries;
-
-        for (size_t partitionId = 0; partitionId < _numPartitions; ++partitionId) {
-            auto lockedPartition = _partitionedCache->lockOnePartitionById(partitionId);
-
-            for (auto&& [key, entry] : *lockedPartition) {
-                entries.emplace_back(entry->clone());
-            }
-        }
-
+        _store.forEach(
+            [&](const KeyType&, const Entry& entry) { entries.emplace_back(entry.clone()); });
         return entries;
     }
 
@@ -576,7 +582,7 @@ public:
      * Used for testing.
      */
     size_t size() const {
-        return _partitionedCache->size();
+        return _store.size();
     }
 
     /**
@@ -595,22 +601,15 @@ public:
                 serializationFunc && filterFunc);
 
         std::vector<BSONObj> results;
-
-        for (size_t partitionId = 0; partitionId < _numPartitions; ++partitionId) {
-            auto lockedPartition = _partitionedCache->lockOnePartitionById(partitionId);
-
-            for (auto&& cacheEntry : *lockedPartition) {
-                if (cacheKeyFilterFunc && !cacheKeyFilterFunc(cacheEntry.first)) {
-                    continue;
-                }
-                const auto& entry = cacheEntry.second;
-                auto serializedEntry = serializationFunc(*entry);
-                if (filterFunc(serializedEntry)) {
-                    results.push_back(serializedEntry);
-                }
+        _store.forEach([&](const KeyType& key, const Entry& entry) {
+            if (cacheKeyFilterFunc && !cacheKeyFilterFunc(key)) {
+                return;
             }
-        }
-
+            auto serializedEntry = serializationFunc(entry);
+            if (filterFunc(serializedEntry)) {
+                results.push_back(serializedEntry);
+            }
+        });
         return results;
     }
 
@@ -618,6 +617,9 @@ private:
     struct NewEntryState {
         bool shouldBeCreated = false;
         bool shouldBeActive = false;
+
+        // Set if the old entry should be kept, but with an increased 'works' value.
+        boost::optional<size_t> increasedWorks;
     };
 
     /**
@@ -625,10 +627,11 @@ private:
      * whether:
      * - We should create a new entry
      * - The new entry should be marked 'active'
+     * - The 'works' value of the old entry should be increased
      */
     NewEntryState getNewEntryState(
         const KeyType& key,
-        Entry* oldEntry,
+        const Entry* oldEntry,
         size_t newWorks,
         double growthCoefficient,
         const PlanCacheCallbacks<KeyType, CachedPlanType, DebugInfoType>* callbacks) {
@@ -677,7 +680,7 @@ private:
             if (callbacks) {
                 callbacks->onIncreasingWorkValue(key, oldEntry, increasedWorks);
             }
-            oldEntry->works = increasedWorks;
+            res.increasedWorks = increasedWorks;
 
             // Don't create a new entry.
             res.shouldBeCreated = false;
@@ -696,8 +699,7 @@ private:
         return res;
     }
 
-    std::size_t _numPartitions;
-    std::unique_ptr<Partitioned<Lru, Partitioner>> _partitionedCache;
+    Store _store;
 };
 
 }  // namespace mongo
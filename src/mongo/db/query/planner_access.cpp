@@ -950,20 +950,24 @@ void QueryPlannerAccess::finishLeafNode(
 
     IndexEntry* nodeIndex = nullptr;
     IndexBounds* bounds = nullptr;
+    std::vector<interval_evaluation_tree::IET>* iets = nullptr;
 
     if (STAGE_GEO_NEAR_2D == type) {
         GeoNear2DNode* gnode = static_cast<GeoNear2DNode*>(node);
         bounds = &gnode->baseBounds;
         nodeIndex = &gnode->index;
+        iets = &gnode->iets;
     } else if (STAGE_GEO_NEAR_2DSPHERE == type) {
         GeoNear2DSphereNode* gnode = static_cast<GeoNear2DSphereNode*>(node);
         bounds = &gnode->baseBounds;
         nodeIndex = &gnode->index;
+        iets = &gnode->iets;
     } else {
         verify(type == STAGE_IXSCAN);
         IndexScanNode* scan = static_cast<IndexScanNode*>(node);
         nodeIndex = &scan->index;
         bounds = &scan->bounds;
+        iets = &scan->iets;
 
         // If this is a $** index, update and populate the keyPattern, bounds, and multikeyPaths.
         if (index.type == IndexType::INDEX_WILDCARD) {
@@ -981,20 +985,22 @@ void QueryPlannerAccess::finishLeafNode(
         }
     }
 
-    if (node->getType() == STAGE_IXSCAN && !ietBuilders.empty()) {
-        auto ixScan = static_cast<IndexScanNode*>(node);
-        ixScan->iets.reserve(ietBuilders.size());
+    if (!ietBuilders.empty()) {
+        // The IET builders follow the key pattern of 'index'. The bounds of a $** index scan have
+        // an additional leading '$_path' field, which is not built from the predicates.
+        const size_t firstBuiltField = bounds->fields.size() - ietBuilders.size();
+        iets->reserve(ietBuilders.size());
         for (size_t i = 0; i < ietBuilders.size(); ++i) {
             auto iet = ietBuilders[i].done();
             if (iet) {
-                ixScan->iets.push_back(*iet);
+                iets->push_back(*iet);
             } else {
-                ixScan->iets.push_back(
+                iets->push_back(
                     interval_evaluation_tree::IET::make<interval_evaluation_tree::ConstNode>(
-                        bounds->fields[i]));
+                        bounds->fields[firstBuiltField + i]));
             }
         }
-        LOGV2_DEBUG(6334900, 5, "Build IETs", "iets"_attr = ietsToString(index, ixScan->iets));
+        LOGV2_DEBUG(6334900, 5, "Build IETs", "iets"_attr = ietsToString(index, *iets));
     }
 
     // All fields are filled out with bounds, nothing to do.
@@ -170,6 +170,7 @@ private:
             currentIndexNumber = newTag->index;
             tightness = IndexBoundsBuilder::INEXACT_FETCH;
             loosestBounds = IndexBoundsBuilder::EXACT;
+            ietBuilders.clear();
 
             if (isQueryParameterized) {
                 const auto& index = indices[newTag->index];
@@ -613,16 +613,10 @@ std::unique_ptr<QuerySolution> QueryPlannerAnalysis::removeProjectSimpleBelowGro
     return soln;
 }
 
-// Checks if the foreign collection is eligible for the hash join algorithm. We conservatively
-// choose the hash join algorithm for cases when the hash table is unlikely to spill data.
-bool isEligibleForHashJoin(const SecondaryCollectionInfo& foreignCollInfo) {
-    return !internalQueryDisableLookupExecutionUsingHashJoin.load() &&
-        foreignCollInfo.noOfRecords <=
-        internalQueryCollectionMaxNoOfDocumentsToChooseHashJoin.load() &&
-        foreignCollInfo.approximateDataSizeBytes <=
-        internalQueryCollectionMaxDataSizeBytesToChooseHashJoin.load() &&
-        foreignCollInfo.storageSizeBytes <=
-        internalQueryCollectionMaxStorageSizeBytesToChooseHashJoin.load();
+// Checks if the hash join algorithm can be used. The size of the foreign collection is not taken
+// into account, since the hash lookup stage spills to disk when the hash table grows too large.
+bool isEligibleForHashJoin() {
+    return !internalQueryDisableLookupExecutionUsingHashJoin.load();
 }
 
 bool isEligibleForIndexedLoopJoin() {
@@ -675,7 +669,7 @@ void QueryPlannerAnalysis::determineLookupStrategy(
     if (foreignIndex && isEligibleForIndexedLoopJoin()) {
         eqLookupNode->lookupStrategy = EqLookupNode::LookupStrategy::kIndexedLoopJoin;
         eqLookupNode->idxEntry = foreignIndex;
-    } else if (allowDiskUse && isEligibleForHashJoin(foreignCollItr->second)) {
+    } else if (allowDiskUse && isEligibleForHashJoin()) {
         eqLookupNode->lookupStrategy = EqLookupNode::LookupStrategy::kHashJoin;
     } else {
         eqLookupNode->lookupStrategy = EqLookupNode::LookupStrategy::kNestedLoopJoin;
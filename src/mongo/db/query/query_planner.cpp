@@ -55,8 +55,10 @@
 #include "mongo/db/query/planner_access.h"
 #include "mongo/db/query/planner_analysis.h"
 #include "mongo/db/query/planner_ixselect.h"
+#include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/db/query/query_planner_common.h"
 #include "mongo/db/query/query_solution.h"
+#include "mongo/db/query/solution_skeleton.h"
 #include "mongo/logv2/log.h"
 
 namespace mongo {
@@ -164,6 +166,15 @@ bool hintMatchesClusterKey(const boost::optional<ClusteredCollectionInfo>& clust
     return hintObj.woCompare(clusteredIndexSpec.getKey()) == 0;
 }
 
+/**
+ * Returns true if the classic plan cache should keep a parameterized copy of the solutions for
+ * 'query'. SBE plans are cached by the SBE plan cache instead.
+ */
+bool shouldBuildSolutionSkeleton(const CanonicalQuery& query) {
+    return internalQueryCacheEnableParameterizedClassicPlans.load() && query.isParameterized() &&
+        (query.getForceClassicEngine() || !query.isSbeCompatible());
+}
+
 }  // namespace
 
 using std::numeric_limits;
@@ -579,7 +590,22 @@ StatusWith<std::unique_ptr<QuerySolution>> QueryPlanner::planFromCache(
 
     // SolutionCacheData::USE_TAGS_SOLN == cacheData->solnType
     // If we're here then this is neither the whole index scan or collection scan
-    // cases, and we proceed by using the PlanCacheIndexTree to tag the query tree.
+    // cases. If the cached data access plan can be rebound to the parameters of the query, there
+    // is no need to run access planning again.
+    if (winnerCacheData.skeleton && internalQueryCacheEnableParameterizedClassicPlans.load()) {
+        if (auto solnRoot = winnerCacheData.skeleton->bind(query)) {
+            auto soln = QueryPlannerAnalysis::analyzeDataAccess(query, params, std::move(solnRoot));
+            if (soln) {
+                LOGV2_DEBUG(7132005,
+                            5,
+                            "Planner: solution rebuilt from the parameterized cache entry",
+                            "solution"_attr = redact(soln->toString()));
+                return {std::move(soln)};
+            }
+        }
+    }
+
+    // Otherwise, we proceed by using the PlanCacheIndexTree to tag the query tree.
 
     // Create a copy of the expression tree.  We use cachedSoln to annotate this with indices.
     unique_ptr<MatchExpression> clone = query.root()->shallowClone();
@@ -1008,6 +1034,11 @@ StatusWith<std::vector<std::unique_ptr<QuerySolution>>> QueryPlanner::plan(
                 continue;
             }
 
+            std::unique_ptr<SolutionSkeleton> skeleton;
+            if (statusWithCacheData.isOK() && shouldBuildSolutionSkeleton(query)) {
+                skeleton = SolutionSkeleton::make(query, *solnRoot);
+            }
+
             auto soln = QueryPlannerAnalysis::analyzeDataAccess(query, params, std::move(solnRoot));
             if (soln) {
                 soln->_enumeratorExplainInfo.merge(planEnumerator._explainInfo);
@@ -1018,6 +1049,7 @@ StatusWith<std::vector<std::unique_ptr<QuerySolution>>> QueryPlanner::plan(
                 if (statusWithCacheData.isOK()) {
                     SolutionCacheData* scd = new SolutionCacheData();
                     scd->tree = std::move(cacheData);
+                    scd->skeleton = std::move(skeleton);
                     soln->cacheData.reset(scd);
                 }
                 out.push_back(std::move(soln));
@@ -1043,8 +1043,10 @@ QuerySolutionNode* IndexScanNode::clone() const {
 
     copy->direction = this->direction;
     copy->addKeyMetadata = this->addKeyMetadata;
+    copy->shouldDedup = this->shouldDedup;
     copy->bounds = this->bounds;
     copy->queryCollator = this->queryCollator;
+    copy->iets = this->iets;
 
     return copy;
 }
@@ -1313,6 +1315,7 @@ QuerySolutionNode* GeoNear2DNode::clone() const {
 
     copy->nq = this->nq;
     copy->baseBounds = this->baseBounds;
+    copy->iets = this->iets;
     copy->addPointMeta = this->addPointMeta;
     copy->addDistMeta = this->addDistMeta;
 
@@ -1346,6 +1349,7 @@ QuerySolutionNode* GeoNear2DSphereNode::clone() const {
 
     copy->nq = this->nq;
     copy->baseBounds = this->baseBounds;
+    copy->iets = this->iets;
     copy->addPointMeta = this->addPointMeta;
     copy->addDistMeta = this->addDistMeta;
 
@@ -413,6 +413,10 @@ public:
     // if the planning process for this solution was based on filtered indices.
     bool indexFilterApplied{false};
 
+    // Set when this is the only solution for the query, so that it is executed without a trial run
+    // and is not cached. The SBE stage builder may then run parts of the plan in parallel.
+    bool allowParallelExecution{false};
+
     // Owned here. Used by the plan cache.
     std::unique_ptr<SolutionCacheData> cacheData;
 
@@ -1106,6 +1110,10 @@ struct GeoNear2DNode : public QuerySolutionNodeWithSortSet {
     const GeoNearExpression* nq;
     IndexBounds baseBounds;
 
+    // The Interval Evaluation Trees of 'baseBounds', with the same ordering as the index key
+    // pattern. Only built for parameterized queries.
+    std::vector<interval_evaluation_tree::IET> iets;
+
     IndexEntry index;
     bool addPointMeta;
     bool addDistMeta;
@@ -1138,6 +1146,10 @@ struct GeoNear2DSphereNode : public QuerySolutionNodeWithSortSet {
     const GeoNearExpression* nq;
     IndexBounds baseBounds;
 
+    // The Interval Evaluation Trees of 'baseBounds', with the same ordering as the index key
+    // pattern. Only built for parameterized queries.
+    std::vector<interval_evaluation_tree::IET> iets;
+
     IndexEntry index;
     bool addPointMeta;
     bool addDistMeta;
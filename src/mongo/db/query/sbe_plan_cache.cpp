@@ -34,6 +34,7 @@
 #include "mongo/db/query/plan_cache_size_parameter.h"
 #include "mongo/db/server_options.h"
 #include "mongo/logv2/log.h"
+#include "mongo/util/periodic_runner.h"
 #include "mongo/util/processinfo.h"
 
 namespace mongo::sbe {
@@ -42,6 +43,14 @@ namespace {
 const auto sbePlanCacheDecoration =
     ServiceContext::declareDecoration<std::unique_ptr<sbe::PlanCache>>();
 
+// Declared after the plan cache, so that the eviction job is stopped before the plan cache is
+// destroyed.
+const auto planCacheEvictionJobDecoration =
+    ServiceContext::declareDecoration<boost::optional<PeriodicJobAnchor>>();
+
+// How often the eviction job brings the plan cache back under its budget.
+constexpr Milliseconds kPlanCacheEvictionPeriod{100};
+
 size_t convertToSizeInBytes(const plan_cache_util::PlanCacheSizeParameter& param) {
     constexpr size_t kBytesInMB = 1014 * 1024;
     constexpr size_t kMBytesInGB = 1014;
@@ -129,7 +138,8 @@ ServiceContext::ConstructorActionRegisterer planCacheRegisterer{
 
             auto size = getPlanCacheSizeInBytes(status.getValue());
             auto& globalPlanCache = sbePlanCacheDecoration(serviceCtx);
-            globalPlanCache = std::make_unique<sbe::PlanCache>(size, ProcessInfo::getNumCores());
+            globalPlanCache = std::make_unique<sbe::PlanCache>(
+                size, ProcessInfo::getNumCores(), LRUEvictionPolicy::kBackground);
         }
     }};
 
@@ -150,6 +160,31 @@ sbe::PlanCache& getPlanCache(OperationContext* opCtx) {
     return getPlanCache(opCtx->getServiceContext());
 }
 
+void startPlanCacheEvictionJob(ServiceContext* serviceCtx) {
+    if (!feature_flags::gFeatureFlagSbePlanCache.isEnabledAndIgnoreFCV()) {
+        return;
+    }
+
+    auto periodicRunner = serviceCtx->getPeriodicRunner();
+    invariant(periodicRunner);
+
+    PeriodicRunner::PeriodicJob job(
+        "SBEPlanCacheEviction",
+        [](Client* client) {
+            auto evicted = getPlanCache(client->getServiceContext()).evictIfOverBudget();
+            if (evicted > 0) {
+                LOGV2_DEBUG(
+                    7132000, 3, "Evicted SBE plan cache entries", "evictedEntries"_attr = evicted);
+            }
+        },
+        kPlanCacheEvictionPeriod);
+
+    auto& anchor = planCacheEvictionJobDecoration(serviceCtx);
+    invariant(!anchor);
+    anchor.emplace(periodicRunner->makeJob(std::move(job)));
+    anchor->start();
+}
+
 void clearPlanCacheEntriesWith(ServiceContext* serviceCtx,
                                UUID collectionUuid,
                                size_t collectionVersion) {
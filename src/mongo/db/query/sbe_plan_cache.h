@@ -162,6 +162,13 @@ PlanCache& getPlanCache(ServiceContext* serviceCtx);
  */
 PlanCache& getPlanCache(OperationContext* opCtx);
 
+/**
+ * Starts the periodic job which evicts the least recently used entries from the global SBE plan
+ * cache once it has grown over budget. Until the job runs, the plan cache evicts entries inline
+ * only when it grows far beyond its budget.
+ */
+void startPlanCacheEvictionJob(ServiceContext* serviceCtx);
+
 /**
  * Removes cached plan entries with the given collection UUID and collection version number.
  */
@@ -30,14 +30,47 @@
 
 #include "mongo/db/query/sbe_runtime_planner.h"
 
+#include "mongo/base/init.h"
 #include "mongo/db/catalog/collection.h"
+#include "mongo/db/client.h"
+#include "mongo/db/concurrency/d_concurrency.h"
 #include "mongo/db/exec/sbe/expressions/expression.h"
 #include "mongo/db/exec/trial_period_utils.h"
 #include "mongo/db/exec/trial_run_tracker.h"
 #include "mongo/db/query/plan_executor_sbe.h"
+#include "mongo/db/query/query_knobs_gen.h"
+#include "mongo/db/repl/read_concern_args.h"
+#include "mongo/platform/mutex.h"
+#include "mongo/util/concurrency/thread_pool.h"
+#include "mongo/util/fail_point.h"
+#include "mongo/util/future.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo::sbe {
 namespace {
+MONGO_FAIL_POINT_DEFINE(hangInSbeTrialRunWorker);
+
+// The threads on which the multi-planner runs trial periods concurrently.
+std::unique_ptr<ThreadPool> trialRunThreadPool;
+MONGO_INITIALIZER(SbeTrialRunThreadPool)(InitializerContext* context) {
+    ThreadPool::Options options;
+    options.poolName = "runtime planner pool";
+    options.threadNamePrefix = "TrialRun";
+    options.minThreads = 0;
+    options.maxThreads = 64;
+    options.onCreateThread = [](const std::string& name) { Client::initThread(name); };
+    trialRunThreadPool = std::make_unique<ThreadPool>(options);
+    trialRunThreadPool->startup();
+}
+}  // namespace
+
+void shutdownTrialRunThreadPool() {
+    trialRunThreadPool->shutdown();
+    trialRunThreadPool->join();
+}
+
+namespace {
+
 /**
  * Fetches a next document form the given plan stage tree and returns 'true' if the plan stage
  * returns EOF, or throws 'TrialRunTracker::EarlyExitException' exception. Otherwise, the
@@ -83,17 +116,13 @@ FetchDocStatus fetchNextDocument(
     }
     return FetchDocStatus::inProgress;
 }
-}  // namespace
-
-StatusWith<std::tuple<value::SlotAccessor*, value::SlotAccessor*, bool>>
-BaseRuntimePlanner::prepareExecutionPlan(PlanStage* root,
-                                         stage_builder::PlanStageData* data) const {
-    invariant(root);
-    invariant(data);
-
-    stage_builder::prepareSlotBasedExecutableTree(
-        _opCtx, root, data, _cq, _collections, _yieldPolicy);
 
+/**
+ * Returns the accessors of the result and recordId slots of the given prepared plan, or nullptr if
+ * the plan does not produce such a slot.
+ */
+std::pair<value::SlotAccessor*, value::SlotAccessor*> getResultAccessors(
+    PlanStage* root, stage_builder::PlanStageData* data) {
     value::SlotAccessor* resultSlot{nullptr};
     if (auto slot = data->outputs.getIfExists(stage_builder::PlanStageSlots::kResult); slot) {
         resultSlot = root->getAccessor(data->ctx, *slot);
@@ -106,6 +135,57 @@ BaseRuntimePlanner::prepareExecutionPlan(PlanStage* root,
         tassert(4822872, "Query does not have a recordId slot.", recordIdSlot);
     }
 
+    return {resultSlot, recordIdSlot};
+}
+
+/**
+ * Fetches documents from the opened 'candidate' plan until it reaches EOF or the 'maxNumResults'
+ * limit, exits early, or fails.
+ */
+void fetchTrialDocuments(plan_ranker::CandidatePlan* candidate,
+                         const std::pair<value::SlotAccessor*, value::SlotAccessor*>& slots,
+                         size_t maxNumResults) {
+    for (size_t i = 0; i < maxNumResults && candidate->status.isOK(); ++i) {
+        FetchDocStatus fetch = fetchNextDocument(candidate, slots);
+        if (fetch == FetchDocStatus::done || fetch == FetchDocStatus::exitedEarly) {
+            candidate->exitedEarly = (fetch == FetchDocStatus::exitedEarly);
+            return;
+        }
+    }
+}
+
+/**
+ * Opens the prepared 'candidate' plan and runs its trial period.
+ */
+void openAndExecuteTrial(plan_ranker::CandidatePlan* candidate,
+                         const std::pair<value::SlotAccessor*, value::SlotAccessor*>& slots,
+                         size_t maxNumResults) {
+    try {
+        candidate->root->open(false);
+    } catch (const ExceptionFor<ErrorCodes::QueryTrialRunCompleted>&) {
+        candidate->exitedEarly = true;
+        return;
+    } catch (const ExceptionFor<ErrorCodes::QueryExceededMemoryLimitNoDiskUseAllowed>& ex) {
+        candidate->root->close();
+        candidate->status = ex.toStatus();
+        return;
+    }
+
+    fetchTrialDocuments(candidate, slots, maxNumResults);
+}
+}  // namespace
+
+StatusWith<std::tuple<value::SlotAccessor*, value::SlotAccessor*, bool>>
+BaseRuntimePlanner::prepareExecutionPlan(PlanStage* root,
+                                         stage_builder::PlanStageData* data) const {
+    invariant(root);
+    invariant(data);
+
+    stage_builder::prepareSlotBasedExecutableTree(
+        _opCtx, root, data, _cq, _collections, _yieldPolicy);
+
+    auto [resultSlot, recordIdSlot] = getResultAccessors(root, data);
+
     auto exitedEarly{false};
     try {
         root->open(false);
@@ -135,12 +215,189 @@ void BaseRuntimePlanner::executeCandidateTrial(plan_ranker::CandidatePlan* candi
         return;
     }
 
-    for (size_t i = 0; i < maxNumResults && candidate->status.isOK(); ++i) {
-        FetchDocStatus fetch =
-            fetchNextDocument(candidate, std::make_pair(resultAccessor, recordIdAccessor));
-        if (fetch == FetchDocStatus::done || fetch == FetchDocStatus::exitedEarly) {
-            candidate->exitedEarly = (fetch == FetchDocStatus::exitedEarly);
-            return;
+    fetchTrialDocuments(
+        candidate, std::make_pair(resultAccessor, recordIdAccessor), maxNumResults);
+}
+
+size_t BaseRuntimePlanner::getTrialRunConcurrency(size_t numCandidates) const {
+    const size_t maxConcurrency = internalQueryPlanEvaluationParallelTrialsSbe.load();
+    if (maxConcurrency <= 1 || numCandidates <= 1) {
+        return 1;
+    }
+
+    // Every trial reads from the latest snapshot with its own operation context, which is only
+    // consistent with the guarantees of the 'local' and 'available' read concerns.
+    if (_opCtx->inMultiDocumentTransaction() ||
+        _opCtx->recoveryUnit()->getTimestampReadSource() !=
+            RecoveryUnit::ReadSource::kNoTimestamp) {
+        return 1;
+    }
+    const auto readConcernLevel = repl::ReadConcernArgs::get(_opCtx).getLevel();
+    if (readConcernLevel != repl::ReadConcernLevel::kLocalReadConcern &&
+        readConcernLevel != repl::ReadConcernLevel::kAvailableReadConcern) {
+        return 1;
+    }
+
+    return std::min(maxConcurrency, numCandidates);
+}
+
+void BaseRuntimePlanner::executeCandidateTrialsInParallel(
+    const std::vector<plan_ranker::CandidatePlan*>& trialCandidates,
+    size_t maxNumResults,
+    size_t concurrency,
+    const std::function<void(size_t)>& onTrialCompleted) {
+    invariant(concurrency > 1);
+    _indexExistenceChecker.check();
+
+    struct Trial {
+        plan_ranker::CandidatePlan* candidate;
+        std::pair<value::SlotAccessor*, value::SlotAccessor*> slots;
+        std::unique_ptr<PlanYieldPolicySBE> yieldPolicy;
+        bool executed{false};
+    };
+
+    // The plans are prepared on this thread, as preparing a plan registers it with the yield policy
+    // of this operation. The plans are then switched to yield policies which only check for
+    // interrupt, as the worker threads cannot yield the locks held by this operation.
+    std::vector<Trial> trials;
+    for (auto candidate : trialCandidates) {
+        auto root = candidate->root.get();
+        stage_builder::prepareSlotBasedExecutableTree(
+            _opCtx, root, &candidate->data, _cq, _collections, _yieldPolicy);
+        auto slots = getResultAccessors(root, &candidate->data);
+
+        auto yieldPolicy = std::make_unique<PlanYieldPolicySBE>(
+            PlanYieldPolicy::YieldPolicy::INTERRUPT_ONLY,
+            _opCtx->getServiceContext()->getFastClockSource(),
+            internalQueryExecYieldIterations.load(),
+            Milliseconds{internalQueryExecYieldPeriodMS.load()},
+            nullptr /* yieldable */,
+            nullptr /* callbacks */,
+            false /* useExperimentalCommitTxnBehavior */);
+        root->attachNewYieldPolicy(yieldPolicy.get());
+        root->detachFromOperationContext();
+        trials.push_back({candidate, slots, std::move(yieldPolicy)});
+    }
+
+    // The operation contexts of the workers, so that an interrupt of this operation, such as a
+    // killOp, is forwarded to them. The deadline is instead copied to each of them.
+    auto workerOpCtxsMutex = MONGO_MAKE_LATCH("BaseRuntimePlanner::workerOpCtxsMutex");
+    std::vector<OperationContext*> workerOpCtxs;
+    boost::optional<ErrorCodes::Error> workersKillCode;
+    auto killWorker = [&](WithLock, OperationContext* workerOpCtx) {
+        stdx::lock_guard<Client> clientLock(*workerOpCtx->getClient());
+        workerOpCtx->getServiceContext()->killOperation(
+            clientLock, workerOpCtx, *workersKillCode);
+    };
+
+    const auto deadline = _opCtx->getDeadline();
+    const auto timeoutError = _opCtx->getTimeoutError();
+    AtomicWord<size_t> nextTrial{0};
+    std::vector<Future<void>> workers;
+    for (size_t idx = 0; idx < concurrency; ++idx) {
+        auto pf = makePromiseFuture<void>();
+        trialRunThreadPool->schedule([&, promise = std::move(pf.promise)](auto status) mutable {
+            // The pool is shut down, so the trials are left to the thread of this operation.
+            if (!status.isOK()) {
+                promise.emplaceValue();
+                return;
+            }
+
+            promise.setWith([&] {
+                auto opCtx = cc().makeOperationContext();
+                if (deadline != Date_t::max()) {
+                    opCtx->setDeadlineByDate(deadline, timeoutError);
+                }
+
+                {
+                    stdx::lock_guard<Latch> lk(workerOpCtxsMutex);
+                    workerOpCtxs.push_back(opCtx.get());
+                    if (workersKillCode) {
+                        killWorker(lk, opCtx.get());
+                    }
+                }
+                ON_BLOCK_EXIT([&] {
+                    stdx::lock_guard<Latch> lk(workerOpCtxsMutex);
+                    workerOpCtxs.erase(
+                        std::find(workerOpCtxs.begin(), workerOpCtxs.end(), opCtx.get()));
+                });
+
+                // This operation already holds the locks needed to read the collections. Taking
+                // the global lock must not wait, or it could deadlock behind a pending exclusive
+                // request which waits for this operation. The remaining trials are then run on
+                // the thread of this operation.
+                Lock::GlobalLock lock(opCtx.get(),
+                                      MODE_IS,
+                                      Date_t::now(),
+                                      Lock::InterruptBehavior::kLeaveUnlocked);
+                if (!lock.isLocked()) {
+                    return;
+                }
+                hangInSbeTrialRunWorker.pauseWhileSet(opCtx.get());
+
+                for (auto trialIdx = nextTrial.fetchAndAdd(1); trialIdx < trials.size();
+                     trialIdx = nextTrial.fetchAndAdd(1)) {
+                    auto& trial = trials[trialIdx];
+                    auto root = trial.candidate->root.get();
+
+                    // The storage cursors of the plan belong to the operation context of this
+                    // thread, so they must be given up before the plan moves back to '_opCtx',
+                    // including when the trial throws.
+                    root->attachToOperationContext(opCtx.get());
+                    ON_BLOCK_EXIT([root] {
+                        root->saveState(true /* relinquishCursor */);
+                        root->detachFromOperationContext();
+                    });
+                    trial.executed = true;
+
+                    openAndExecuteTrial(trial.candidate, trial.slots, maxNumResults);
+                    if (trial.candidate->status.isOK() && !trial.candidate->exitedEarly) {
+                        onTrialCompleted(trialIdx);
+                    }
+                }
+            });
+        });
+        workers.push_back(std::move(pf.future));
+    }
+
+    // Wait for all the workers before reporting any failure, as they use the state of this frame.
+    Status workersStatus = Status::OK();
+    for (auto&& worker : workers) {
+        if (auto interrupted = worker.waitNoThrow(_opCtx); !interrupted.isOK()) {
+            stdx::lock_guard<Latch> lk(workerOpCtxsMutex);
+            if (!workersKillCode) {
+                workersKillCode = interrupted.code();
+                for (auto workerOpCtx : workerOpCtxs) {
+                    killWorker(lk, workerOpCtx);
+                }
+            }
+        }
+        if (auto status = worker.getNoThrow(); !status.isOK() && workersStatus.isOK()) {
+            workersStatus = std::move(status);
+        }
+    }
+
+    for (auto&& trial : trials) {
+        auto root = trial.candidate->root.get();
+        root->attachToOperationContext(_opCtx);
+        root->attachNewYieldPolicy(_yieldPolicy);
+    }
+    uassertStatusOK(workersStatus);
+    _opCtx->checkForInterrupt();
+
+    for (auto&& trial : trials) {
+        if (trial.executed) {
+            trial.candidate->root->restoreState(true /* relinquishCursor */);
+        }
+    }
+
+    for (size_t trialIdx = 0; trialIdx < trials.size(); ++trialIdx) {
+        auto& trial = trials[trialIdx];
+        if (!trial.executed) {
+            openAndExecuteTrial(trial.candidate, trial.slots, maxNumResults);
+            if (trial.candidate->status.isOK() && !trial.candidate->exitedEarly) {
+                onTrialCompleted(trialIdx);
+            }
         }
     }
 }
@@ -184,7 +441,73 @@ std::vector<plan_ranker::CandidatePlan> BaseRuntimePlanner::collectExecutionStat
     // plans which could artificially favor the blocking plans.
     const size_t trackerResultsBudget = nonBlockingPlanIndexes.empty() ? maxNumResults : 0;
 
+    // Runs the trial periods of the given plans concurrently. When a plan completes its trial
+    // period, the budget of reads of all the plans is lowered to the reads of that plan, as it is
+    // for the next plans when they run one after another. A plan which has already done more reads
+    // then stops, while a plan which starts later still gets the same budget, so that the plans
+    // are ranked on the same amount of work.
+    auto runPlansInParallel = [&](const std::vector<size_t>& planIndexes,
+                                  size_t& maxNumReads,
+                                  size_t concurrency) -> void {
+        AtomicWord<size_t> sharedMaxNumReads{maxNumReads};
+        std::vector<std::unique_ptr<TrialRunTracker>> trackers;
+        std::vector<plan_ranker::CandidatePlan*> trialCandidates;
+
+        const auto firstCandidateIdx = candidates.size();
+        for (auto planIndex : planIndexes) {
+            auto&& [root, data] = roots[planIndex];
+            auto origPlan =
+                std::make_pair<std::unique_ptr<PlanStage>, stage_builder::PlanStageData>(
+                    root->clone(), stage_builder::PlanStageData(data));
+
+            auto tracker = std::make_unique<TrialRunTracker>(trackerResultsBudget, maxNumReads);
+            tracker->setSharedMaxNumReads(&sharedMaxNumReads);
+            root->attachToTrialRunTracker(tracker.get());
+            trackers.push_back(std::move(tracker));
+
+            candidates.push_back({std::move(solutions[planIndex]),
+                                  std::move(root),
+                                  std::move(data),
+                                  false /* exitedEarly */,
+                                  Status::OK()});
+            candidates.back().clonedPlan.emplace(std::move(origPlan));
+        }
+        // The candidates vector must not grow while the trials reference its elements.
+        for (size_t idx = firstCandidateIdx; idx < candidates.size(); ++idx) {
+            trialCandidates.push_back(&candidates[idx]);
+        }
+        ON_BLOCK_EXIT([&] {
+            for (auto candidate : trialCandidates) {
+                candidate->root->detachFromTrialRunTracker();
+            }
+        });
+
+        executeCandidateTrialsInParallel(
+            trialCandidates, maxNumResults, concurrency, [&](size_t idx) {
+                const auto numReads =
+                    trackers[idx]->getMetric<TrialRunTracker::TrialRunMetric::kNumReads>();
+                auto current = sharedMaxNumReads.load();
+                while (numReads < current &&
+                       !sharedMaxNumReads.compareAndSwap(&current, numReads)) {
+                }
+            });
+
+        for (size_t idx = 0; idx < trialCandidates.size(); ++idx) {
+            auto candidate = trialCandidates[idx];
+            if (candidate->status.isOK() && !candidate->exitedEarly) {
+                maxNumReads = std::min(
+                    maxNumReads,
+                    trackers[idx]->getMetric<TrialRunTracker::TrialRunMetric::kNumReads>());
+            }
+        }
+    };
+
     auto runPlans = [&](const std::vector<size_t>& planIndexes, size_t& maxNumReads) -> void {
+        if (auto concurrency = getTrialRunConcurrency(planIndexes.size()); concurrency > 1) {
+            runPlansInParallel(planIndexes, maxNumReads, concurrency);
+            return;
+        }
+
         for (auto planIndex : planIndexes) {
             // Prepare the plan.
             auto&& [root, data] = roots[planIndex];
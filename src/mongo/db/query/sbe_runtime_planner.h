@@ -29,6 +29,8 @@
 
 #pragma once
 
+#include <functional>
+
 #include "mongo/db/catalog/collection.h"
 #include "mongo/db/exec/sbe/stages/stages.h"
 #include "mongo/db/query/all_indices_required_checker.h"
@@ -133,6 +135,32 @@ protected:
         std::vector<std::pair<std::unique_ptr<PlanStage>, stage_builder::PlanStageData>> roots,
         size_t maxTrialPeriodNumReads);
 
+    /**
+     * Returns the number of threads on which the trial periods of 'numCandidates' candidate plans
+     * can run concurrently, as per 'internalQueryPlanEvaluationParallelTrialsSbe'. Returns 1 if
+     * the trial periods must run one after another on the thread of this operation.
+     */
+    size_t getTrialRunConcurrency(size_t numCandidates) const;
+
+    /**
+     * Runs the trial periods of the 'trialCandidates' concurrently on 'concurrency' threads of
+     * the runtime planner thread pool, each thread with its own operation context. The plans
+     * are prepared on the thread of this operation, and are attached back to '_opCtx' before this
+     * function returns. The candidate plans must already be attached to their trial run trackers.
+     * 'onTrialCompleted' is called, possibly concurrently, with the index of each candidate which
+     * completes its trial period without exiting early, so that the caller can lower the budget of
+     * the other trials.
+     *
+     * The worker threads cannot yield the locks held by this operation, so the plans only check
+     * for interrupt during the trial period. A trial which no worker thread could start is run on
+     * the thread of this operation.
+     */
+    void executeCandidateTrialsInParallel(
+        const std::vector<plan_ranker::CandidatePlan*>& trialCandidates,
+        size_t maxNumResults,
+        size_t concurrency,
+        const std::function<void(size_t)>& onTrialCompleted);
+
     OperationContext* const _opCtx;
     const MultipleCollectionAccessor& _collections;
     const CanonicalQuery& _cq;
@@ -143,4 +171,10 @@ protected:
     //  to be extended to support checking for index existence on multiple collections.
     const AllIndicesRequiredChecker _indexExistenceChecker;
 };
+
+/**
+ * Shuts down and joins the threads on which the multi-planner runs trial periods concurrently. Any
+ * trial period which starts afterwards runs on the thread of its operation.
+ */
+void shutdownTrialRunThreadPool();
 }  // namespace mongo::sbe
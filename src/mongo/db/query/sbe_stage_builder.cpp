@@ -37,8 +37,10 @@
 
 #include "mongo/db/catalog/collection.h"
 #include "mongo/db/exec/sbe/abt/abt_lower.h"
+#include "mongo/db/exec/sbe/stages/branch.h"
 #include "mongo/db/exec/sbe/stages/co_scan.h"
 #include "mongo/db/exec/sbe/stages/column_scan.h"
+#include "mongo/db/exec/sbe/stages/exchange.h"
 #include "mongo/db/exec/sbe/stages/filter.h"
 #include "mongo/db/exec/sbe/stages/hash_agg.h"
 #include "mongo/db/exec/sbe/stages/hash_join.h"
@@ -66,6 +68,8 @@
 #include "mongo/db/query/expression_walker.h"
 #include "mongo/db/query/optimizer/rewrites/const_eval.h"
 #include "mongo/db/query/optimizer/rewrites/path_lower.h"
+#include "mongo/db/query/query_knobs_gen.h"
+#include "mongo/db/query/query_request_helper.h"
 #include "mongo/db/query/sbe_stage_builder_accumulator.h"
 #include "mongo/db/query/sbe_stage_builder_coll_scan.h"
 #include "mongo/db/query/sbe_stage_builder_expression.h"
@@ -74,6 +78,7 @@
 #include "mongo/db/query/sbe_stage_builder_projection.h"
 #include "mongo/db/query/shard_filterer_factory_impl.h"
 #include "mongo/db/query/util/make_data_structure.h"
+#include "mongo/db/repl/read_concern_args.h"
 #include "mongo/db/s/collection_sharding_state.h"
 #include "mongo/db/storage/execution_context.h"
 #include "mongo/logv2/log.h"
@@ -628,11 +633,13 @@ std::pair<std::unique_ptr<sbe::PlanStage>, PlanStageSlots> SlotBasedStageBuilder
     invariant(!reqs.getIndexKeyBitset());
 
     auto csn = static_cast<const CollectionScanNode*>(root);
+    auto degreeOfParallelism = getCollScanDegreeOfParallelism(root, reqs);
     auto [stage, outputs] = generateCollScan(_state,
                                              getCurrentCollection(reqs),
                                              csn,
                                              _yieldPolicy,
-                                             reqs.getIsTailableCollScanResumeBranch());
+                                             reqs.getIsTailableCollScanResumeBranch(),
+                                             degreeOfParallelism > 1);
 
     if (reqs.has(kReturnKey)) {
         // Assign the 'returnKeySlot' to be the empty object.
@@ -643,6 +650,24 @@ std::pair<std::unique_ptr<sbe::PlanStage>, PlanStageSlots> SlotBasedStageBuilder
                                       sbe::makeE<sbe::EFunction>("newObj", sbe::makeEs()));
     }
 
+    // Unless the parent runs a partial group in the producers as well, gather the scanned documents
+    // from the producers right away. The documents are returned in no particular order.
+    if (degreeOfParallelism > 1 && !reqs.getIsBuildingPartialGroupForParallelCollScan()) {
+        sbe::value::SlotVector fields;
+        for (auto&& name : {kResult, kRecordId, kReturnKey}) {
+            if (auto slot = outputs.getIfExists(name); slot) {
+                fields.push_back(*slot);
+            }
+        }
+        stage = sbe::makeS<sbe::ExchangeConsumer>(std::move(stage),
+                                                  degreeOfParallelism,
+                                                  std::move(fields),
+                                                  sbe::ExchangePolicy::roundrobin,
+                                                  nullptr /* partition */,
+                                                  nullptr /* orderLess */,
+                                                  root->nodeId());
+    }
+
     return {std::move(stage), std::move(outputs)};
 }
 
@@ -860,6 +885,32 @@ std::pair<std::unique_ptr<sbe::PlanStage>, PlanStageSlots> SlotBasedStageBuilder
     slotMap[rootStr] = rowStoreSlot;
     auto abt = builder.generateABT();
     auto exprOut = abt ? abtToExpr(*abt, slotMap) : emptyExpr->clone();
+
+    // Push the predicates on single paths down into the scan, so that the rows failing them are
+    // never assembled. The predicates which cannot be pushed down are applied on top of the scan.
+    // The columnar index has no ColumnStore behind it yet, so the scan runs the predicates against
+    // the row store; the cell predicates are used as soon as it is given one.
+    // Visit the paths in order to keep the generated plan stable.
+    std::vector<std::string> filteredPaths;
+    for (auto&& [path, _] : csn->filtersByPath) {
+        filteredPaths.push_back(path);
+    }
+    std::sort(filteredPaths.begin(), filteredPaths.end());
+
+    auto cellSlot = _slotIdGenerator.generate();
+    std::vector<sbe::ColumnScanStage::PathFilter> pushedDownFilters;
+    std::vector<const MatchExpression*> residualFilters;
+    for (auto&& path : filteredPaths) {
+        const auto* filter = csn->filtersByPath.find(path)->second.get();
+        if (auto filterExpr = generateColumnFilterExpr(_state, filter, rowStoreSlot)) {
+            pushedDownFilters.emplace_back(path,
+                                           std::move(filterExpr),
+                                           generateColumnCellFilterExpr(_state, filter, cellSlot));
+        } else {
+            residualFilters.push_back(filter);
+        }
+    }
+
     auto stage = std::make_unique<sbe::ColumnScanStage>(getCurrentCollection(reqs)->uuid(),
                                                         csn->indexEntry.catalogName,
                                                         fieldSlotIds,
@@ -869,10 +920,28 @@ std::pair<std::unique_ptr<sbe::PlanStage>, PlanStageSlots> SlotBasedStageBuilder
                                                         std::move(exprOut),
                                                         std::move(pathExprs),
                                                         rowStoreSlot,
+                                                        std::move(pushedDownFilters),
+                                                        cellSlot,
+                                                        nullptr /* columnStore */,
                                                         _yieldPolicy,
                                                         csn->nodeId());
 
-    return {std::move(stage), std::move(outputs)};
+    std::unique_ptr<sbe::PlanStage> resultStage = std::move(stage);
+    for (auto filter : residualFilters) {
+        auto relevantSlots = sbe::makeSV(rowStoreSlot, recordSlot);
+        if (ridSlot) {
+            relevantSlots.push_back(*ridSlot);
+        }
+
+        auto [_, outputStage] = generateFilter(_state,
+                                               filter,
+                                               {std::move(resultStage), std::move(relevantSlots)},
+                                               rowStoreSlot,
+                                               csn->nodeId());
+        resultStage = std::move(outputStage.stage);
+    }
+
+    return {std::move(resultStage), std::move(outputs)};
 }
 
 std::pair<std::unique_ptr<sbe::PlanStage>, PlanStageSlots> SlotBasedStageBuilder::buildFetch(
@@ -1926,6 +1995,7 @@ std::pair<std::unique_ptr<sbe::PlanStage>, PlanStageSlots> SlotBasedStageBuilder
                                                         innerCondSlots,
                                                         innerProjectSlots,
                                                         collatorSlot,
+                                                        _cq.getExpCtx()->allowDiskUse,
                                                         root->nodeId());
 
     // If there are more than 2 children, iterate all remaining children and hash
@@ -1948,6 +2018,7 @@ std::pair<std::unique_ptr<sbe::PlanStage>, PlanStageSlots> SlotBasedStageBuilder
                                                        innerCondSlots,
                                                        innerProjectSlots,
                                                        collatorSlot,
+                                                       _cq.getExpCtx()->allowDiskUse,
                                                        root->nodeId());
     }
 
@@ -2402,6 +2473,216 @@ sbe::value::SlotVector dedupGroupBySlots(const sbe::value::SlotVector& groupBySl
 
     return dedupedGroupBySlots;
 }
+
+/**
+ * Builds the stage(s) which finalize the accumulators of the group stage 'groupEvalStage' and
+ * return the groups, either as a result object or, if the parent does not request it, as separate
+ * slots for the _id and the accumulators.
+ */
+std::pair<std::unique_ptr<sbe::PlanStage>, PlanStageSlots> generateGroupOutput(
+    StageBuilderState& state,
+    EvalStage groupEvalStage,
+    std::unique_ptr<sbe::EExpression> idDocExpr,
+    const sbe::value::SlotVector& dedupedGroupBySlots,
+    const std::vector<AccumulationStatement>& accStmts,
+    const std::vector<sbe::value::SlotVector>& aggSlotsVec,
+    const PlanStageReqs& reqs,
+    PlanNodeId nodeId,
+    sbe::value::SlotIdGenerator* slotIdGenerator) {
+    tassert(
+        5851603,
+        "Group stage's output slots must include deduped slots for group-by keys and slots for all "
+        "accumulators",
+        groupEvalStage.outSlots.size() ==
+            std::accumulate(aggSlotsVec.begin(),
+                            aggSlotsVec.end(),
+                            dedupedGroupBySlots.size(),
+                            [](int sum, const auto& aggSlots) { return sum + aggSlots.size(); }));
+    tassert(5851604,
+            "Group stage's output slots must contain the deduped groupBySlots at the front",
+            std::equal(dedupedGroupBySlots.begin(),
+                       dedupedGroupBySlots.end(),
+                       groupEvalStage.outSlots.begin()));
+
+    // Builds the final stage(s) over the collected accumulators.
+    auto [fieldNames, finalSlots, groupFinalEvalStage] =
+        generateGroupFinalStage(state,
+                                std::move(groupEvalStage),
+                                std::move(idDocExpr),
+                                dedupedGroupBySlots,
+                                accStmts,
+                                aggSlotsVec,
+                                nodeId,
+                                slotIdGenerator);
+
+    tassert(5851605,
+            "The number of final slots must be as 1 (the final group-by slot) + the number of acc "
+            "slots",
+            finalSlots.size() == 1 + accStmts.size());
+
+    // Cleans up optimized expressions.
+    state.preGeneratedExprs.clear();
+
+    PlanStageSlots outputs;
+    std::unique_ptr<sbe::PlanStage> outStage;
+    // Builds a stage to create a result object out of a group-by slot and gathered accumulator
+    // result slots if the parent node requests so. Otherwise, returns field names and associated
+    // slots so that a parent stage above can directly refer to a slot by its name because there's
+    // no returned object.
+    if (reqs.has(SlotBasedStageBuilder::kResult)) {
+        outputs.set(SlotBasedStageBuilder::kResult, slotIdGenerator->generate());
+        // This mkbson stage combines 'finalSlots' into a bsonObject result slot which has
+        // 'fieldNames' fields.
+        outStage = sbe::makeS<sbe::MakeBsonObjStage>(
+            std::move(groupFinalEvalStage.stage),
+            outputs.get(SlotBasedStageBuilder::kResult),  // objSlot
+            boost::none,                                  // rootSlot
+            boost::none,                                  // fieldBehavior
+            std::vector<std::string>{},                   // fields
+            std::move(fieldNames),                        // projectFields
+            std::move(finalSlots),                        // projectVars
+            true,                                         // forceNewObject
+            false,                                        // returnOldObject
+            nodeId);
+    } else {
+        for (size_t i = 0; i < finalSlots.size(); ++i) {
+            outputs.set("CURRENT." + fieldNames[i], finalSlots[i]);
+        };
+
+        outStage = std::move(groupFinalEvalStage.stage);
+    }
+
+    return {std::move(outStage), std::move(outputs)};
+}
+
+/**
+ * A group stage which computes its accumulators over blocks of rows, as generated by
+ * 'generateBlockGroup()'.
+ */
+struct BlockGroup {
+    EvalStage groupEvalStage;
+    sbe::value::SlotId idSlot;
+    std::vector<sbe::value::SlotVector> aggSlotsVec;
+
+    // If the filter of the collection scan is auto-parameterized, an expression which is true if
+    // the block builtins can apply it with the bound parameters. Otherwise nullptr.
+    std::unique_ptr<sbe::EExpression> paramGuard;
+};
+
+/**
+ * Generates the group stage of 'groupNode' over blocks of rows, if the group has a constant _id,
+ * its child is a collection scan which can return blocks and its accumulators can be computed over
+ * blocks (see 'canBuildBlockAccumulator()'). Otherwise returns boost::none.
+ *
+ * The accumulators of each block are computed by the 'valueBlock*' builtins, and a hash_agg stage
+ * combines these partial results the same way as the partial groups of a parallel plan:
+ *
+ *   group [s5] [s6 = aggMergeDoubleDoubleSums (s4)]
+ *   project [s5 = 1]
+ *   project [s4 = valueBlockAggDoubleDoubleSum (s3, s2)]
+ *   filter {valueBlockCount (s3, s2) > 0}
+ *   project [s3 = valueBlockMatchGtScalar (s2, 10)]
+ *   row_to_block [s2] [s1] 64
+ *   scan [a = s1]
+ */
+boost::optional<BlockGroup> generateBlockGroup(StageBuilderState& state,
+                                               const CollectionPtr& collection,
+                                               const GroupNode* groupNode,
+                                               PlanYieldPolicy* yieldPolicy,
+                                               size_t blockSize,
+                                               bool allowDiskUse,
+                                               sbe::value::SlotIdGenerator* slotIdGenerator) {
+    const auto& childNode = groupNode->children[0];
+    const auto& accStmts = groupNode->accumulators;
+    auto idConstant = dynamic_cast<const ExpressionConstant*>(groupNode->groupByExpression.get());
+    if (childNode->getType() != STAGE_COLLSCAN || !idConstant ||
+        state.data->env->getSlotIfExists("collator"_sd) ||
+        !std::all_of(accStmts.begin(), accStmts.end(), [](const auto& accStmt) {
+            return canBuildBlockAccumulator(accStmt);
+        })) {
+        return boost::none;
+    }
+
+    std::vector<std::string> fields;
+    for (const auto& accStmt : accStmts) {
+        auto field = getBlockAccumulatorField(accStmt);
+        if (field && std::find(fields.begin(), fields.end(), *field) == fields.end()) {
+            fields.push_back(std::move(*field));
+        }
+    }
+
+    auto blockScan = generateBlockCollScan(state,
+                                           collection,
+                                           static_cast<const CollectionScanNode*>(childNode),
+                                           yieldPolicy,
+                                           fields,
+                                           blockSize);
+    if (!blockScan) {
+        return boost::none;
+    }
+
+    const auto nodeId = groupNode->nodeId();
+    auto stage = std::move(blockScan->stage);
+
+    // Skips the blocks which have no matching rows, so that they do not create the group.
+    if (blockScan->bitmapSlot) {
+        stage = sbe::makeS<sbe::FilterStage<false>>(
+            std::move(stage),
+            makeBinaryOp(sbe::EPrimBinary::greater,
+                         makeFunction("valueBlockCount",
+                                      makeVariable(*blockScan->bitmapSlot),
+                                      makeVariable(blockScan->rowBlockSlot)),
+                         makeConstant(sbe::value::TypeTags::NumberInt64,
+                                      sbe::value::bitcastFrom<int64_t>(0))),
+            nodeId);
+    }
+
+    sbe::value::SlotVector partialSlots;
+    sbe::value::SlotMap<std::unique_ptr<sbe::EExpression>> partialSlotToExprMap;
+    for (const auto& accStmt : accStmts) {
+        auto field = getBlockAccumulatorField(accStmt);
+        auto blockSlot = field ? blockScan->fieldBlockSlots.at(*field) : blockScan->rowBlockSlot;
+        auto slot = slotIdGenerator->generate();
+        partialSlots.push_back(slot);
+        partialSlotToExprMap.emplace(
+            slot, buildBlockAccumulator(state, accStmt, blockScan->bitmapSlot, blockSlot));
+    }
+    if (!partialSlotToExprMap.empty()) {
+        stage = sbe::makeS<sbe::ProjectStage>(
+            std::move(stage), std::move(partialSlotToExprMap), nodeId);
+    }
+
+    auto idSlot = slotIdGenerator->generate();
+    auto [idTag, idVal] = makeValue(idConstant->getValue());
+    stage = sbe::makeProjectStage(std::move(stage), nodeId, idSlot, makeConstant(idTag, idVal));
+
+    // The accumulators are combined in the order of 'accStmts', so that their output slots are
+    // generated in the order 'generateGroupFinalStage()' expects.
+    BlockGroup out;
+    sbe::value::SlotMap<std::unique_ptr<sbe::EExpression>> combineSlotToExprMap;
+    for (size_t idxAcc = 0; idxAcc < accStmts.size(); ++idxAcc) {
+        auto combineExprs = buildCombinePartialAggregates(
+            state, accStmts[idxAcc], sbe::makeSV(partialSlots[idxAcc]));
+        sbe::value::SlotVector combineSlots;
+        for (auto& combineExpr : combineExprs) {
+            auto slot = slotIdGenerator->generate();
+            combineSlots.push_back(slot);
+            combineSlotToExprMap.emplace(slot, std::move(combineExpr));
+        }
+        out.aggSlotsVec.emplace_back(std::move(combineSlots));
+    }
+
+    partialSlots.push_back(idSlot);
+    out.groupEvalStage = makeHashAgg(EvalStage{std::move(stage), std::move(partialSlots)},
+                                     sbe::makeSV(idSlot),
+                                     std::move(combineSlotToExprMap),
+                                     boost::none /* collatorSlot */,
+                                     allowDiskUse,
+                                     nodeId);
+    out.idSlot = idSlot;
+    out.paramGuard = std::move(blockScan->paramGuard);
+    return out;
+}
 }  // namespace
 
 /**
@@ -2453,6 +2734,82 @@ std::pair<std::unique_ptr<sbe::PlanStage>, PlanStageSlots> SlotBasedStageBuilder
         childReqs.clear(kResult);
     }
 
+    // If the child is a collection scan which runs in parallel, the group is split into a partial
+    // group, which runs in the producers of the exchange along with the scan, and a final group,
+    // which combines the partial groups. This requires that the partial results of all the
+    // accumulators can be combined.
+    const auto degreeOfParallelism =
+        std::all_of(accStmts.begin(),
+                    accStmts.end(),
+                    [](const auto& accStmt) { return canCombinePartialAggregates(accStmt); })
+        ? getCollScanDegreeOfParallelism(childNode, childReqs)
+        : 1;
+    childReqs.setIsBuildingPartialGroupForParallelCollScan(degreeOfParallelism > 1);
+
+    // If the child is a collection scan which can return blocks of rows, the accumulators may be
+    // computed over the blocks instead of the individual rows. When the filter of the scan is
+    // auto-parameterized, a branch stage falls back to the row-at-a-time group if the plan is
+    // reused with constants the block builtins cannot apply the filter with.
+    if (auto blockSize = internalQuerySlotBasedExecutionBlockSize.load(); blockSize > 0 &&
+        degreeOfParallelism == 1 && !reqs.getIsBlockGroupFallbackBranch()) {
+        if (auto blockGroup = generateBlockGroup(_state,
+                                                 getCurrentCollection(childReqs),
+                                                 groupNode,
+                                                 _yieldPolicy,
+                                                 blockSize,
+                                                 _cq.getExpCtx()->allowDiskUse,
+                                                 &_slotIdGenerator)) {
+            _shouldProduceRecordIdSlot = false;
+            auto [blockStage, blockOutputs] =
+                generateGroupOutput(_state,
+                                    std::move(blockGroup->groupEvalStage),
+                                    nullptr /* idDocExpr */,
+                                    sbe::makeSV(blockGroup->idSlot),
+                                    accStmts,
+                                    blockGroup->aggSlotsVec,
+                                    reqs,
+                                    nodeId,
+                                    &_slotIdGenerator);
+            if (!blockGroup->paramGuard) {
+                return {std::move(blockStage), std::move(blockOutputs)};
+            }
+
+            auto fallbackReqs = reqs.copy();
+            fallbackReqs.setIsBlockGroupFallbackBranch(true);
+            auto [rowStage, rowOutputs] = build(root, fallbackReqs);
+
+            std::vector<std::string> outputNames;
+            if (reqs.has(kResult)) {
+                outputNames.push_back(kResult.toString());
+            } else {
+                outputNames.push_back("CURRENT._id");
+                for (const auto& accStmt : accStmts) {
+                    outputNames.push_back("CURRENT." + accStmt.fieldName);
+                }
+            }
+
+            PlanStageSlots outputs;
+            sbe::value::SlotVector blockSlots;
+            sbe::value::SlotVector rowSlots;
+            sbe::value::SlotVector outputSlots;
+            for (const auto& name : outputNames) {
+                blockSlots.push_back(blockOutputs.get(name));
+                rowSlots.push_back(rowOutputs.get(name));
+                outputSlots.push_back(_slotIdGenerator.generate());
+                outputs.set(name, outputSlots.back());
+            }
+
+            auto stage = sbe::makeS<sbe::BranchStage>(std::move(blockStage),
+                                                      std::move(rowStage),
+                                                      std::move(blockGroup->paramGuard),
+                                                      std::move(blockSlots),
+                                                      std::move(rowSlots),
+                                                      std::move(outputSlots),
+                                                      nodeId);
+            return {std::move(stage), std::move(outputs)};
+        }
+    }
+
     // Builds the child and gets the child result slot.
     auto [childStage, childOutputs] = build(childNode, childReqs);
     _shouldProduceRecordIdSlot = false;
@@ -2495,69 +2852,49 @@ std::pair<std::unique_ptr<sbe::PlanStage>, PlanStageSlots> SlotBasedStageBuilder
                                       _cq.getExpCtx()->allowDiskUse,
                                       nodeId);
 
-    tassert(
-        5851603,
-        "Group stage's output slots must include deduped slots for group-by keys and slots for all "
-        "accumulators",
-        groupEvalStage.outSlots.size() ==
-            std::accumulate(aggSlotsVec.begin(),
-                            aggSlotsVec.end(),
-                            dedupedGroupBySlots.size(),
-                            [](int sum, const auto& aggSlots) { return sum + aggSlots.size(); }));
-    tassert(5851604,
-            "Group stage's output slots must contain the deduped groupBySlots at the front",
-            std::equal(dedupedGroupBySlots.begin(),
-                       dedupedGroupBySlots.end(),
-                       groupEvalStage.outSlots.begin()));
-
-    // Builds the final stage(s) over the collected accumulators.
-    auto [fieldNames, finalSlots, groupFinalEvalStage] =
-        generateGroupFinalStage(_state,
-                                std::move(groupEvalStage),
-                                std::move(idDocExpr),
-                                dedupedGroupBySlots,
-                                accStmts,
-                                aggSlotsVec,
-                                nodeId,
-                                &_slotIdGenerator);
-
-    tassert(5851605,
-            "The number of final slots must be as 1 (the final group-by slot) + the number of acc "
-            "slots",
-            finalSlots.size() == 1 + accStmts.size());
-
-    // Cleans up optimized expressions.
-    _state.preGeneratedExprs.clear();
-
-    PlanStageSlots outputs;
-    std::unique_ptr<sbe::PlanStage> outStage;
-    // Builds a stage to create a result object out of a group-by slot and gathered accumulator
-    // result slots if the parent node requests so. Otherwise, returns field names and associated
-    // slots so that a parent stage above can directly refer to a slot by its name because there's
-    // no returned object.
-    if (reqs.has(kResult)) {
-        outputs.set(kResult, _slotIdGenerator.generate());
-        // This mkbson stage combines 'finalSlots' into a bsonObject result slot which has
-        // 'fieldNames' fields.
-        outStage = sbe::makeS<sbe::MakeBsonObjStage>(std::move(groupFinalEvalStage.stage),
-                                                     outputs.get(kResult),        // objSlot
-                                                     boost::none,                 // rootSlot
-                                                     boost::none,                 // fieldBehavior
-                                                     std::vector<std::string>{},  // fields
-                                                     std::move(fieldNames),       // projectFields
-                                                     std::move(finalSlots),       // projectVars
-                                                     true,                        // forceNewObject
-                                                     false,                       // returnOldObject
-                                                     nodeId);
-    } else {
-        for (size_t i = 0; i < finalSlots.size(); ++i) {
-            outputs.set("CURRENT." + fieldNames[i], finalSlots[i]);
-        };
-
-        outStage = std::move(groupFinalEvalStage.stage);
-    }
+    if (degreeOfParallelism > 1) {
+        // Gathers the partial groups from the producers and combines them by the same group-by
+        // slots. The combined accumulators take the place of the partial ones in 'aggSlotsVec'.
+        auto partialGroupSlots = groupEvalStage.outSlots;
+        auto exchangeStage = sbe::makeS<sbe::ExchangeConsumer>(std::move(groupEvalStage.stage),
+                                                               degreeOfParallelism,
+                                                               partialGroupSlots,
+                                                               sbe::ExchangePolicy::roundrobin,
+                                                               nullptr /* partition */,
+                                                               nullptr /* orderLess */,
+                                                               nodeId);
+
+        sbe::value::SlotMap<std::unique_ptr<sbe::EExpression>> combineSlotToExprMap;
+        for (size_t idxAcc = 0; idxAcc < accStmts.size(); ++idxAcc) {
+            auto combineExprs =
+                buildCombinePartialAggregates(_state, accStmts[idxAcc], aggSlotsVec[idxAcc]);
+            sbe::value::SlotVector combineSlots;
+            for (auto& combineExpr : combineExprs) {
+                auto slot = _slotIdGenerator.generate();
+                combineSlots.push_back(slot);
+                combineSlotToExprMap.emplace(slot, std::move(combineExpr));
+            }
+            aggSlotsVec[idxAcc] = std::move(combineSlots);
+        }
 
-    return {std::move(outStage), std::move(outputs)};
+        groupEvalStage = makeHashAgg(
+            EvalStage{std::move(exchangeStage), std::move(partialGroupSlots)},
+            dedupedGroupBySlots,
+            std::move(combineSlotToExprMap),
+            _state.data->env->getSlotIfExists("collator"_sd),
+            _cq.getExpCtx()->allowDiskUse,
+            nodeId);
+    }
+
+    return generateGroupOutput(_state,
+                               std::move(groupEvalStage),
+                               std::move(idDocExpr),
+                               dedupedGroupBySlots,
+                               accStmts,
+                               aggSlotsVec,
+                               reqs,
+                               nodeId,
+                               &_slotIdGenerator);
 }
 
 std::pair<std::unique_ptr<sbe::PlanStage>, PlanStageSlots>
@@ -2895,6 +3232,56 @@ const CollectionPtr& SlotBasedStageBuilder::getCurrentCollection(const PlanStage
     return _collections.lookupCollection(reqs.getTargetNamespace());
 }
 
+size_t SlotBasedStageBuilder::getCollScanDegreeOfParallelism(const QuerySolutionNode* root,
+                                                             const PlanStageReqs& reqs) const {
+    const auto degreeOfParallelism = internalQuerySBEDegreeOfParallelism.load();
+    if (degreeOfParallelism <= 1 || !_solution.allowParallelExecution ||
+        root->getType() != STAGE_COLLSCAN) {
+        return 1;
+    }
+
+    // The parallel scan does not preserve the order of the documents, so it can only be used for
+    // a plain forward scan which has not been asked for the natural order explicitly.
+    auto csn = static_cast<const CollectionScanNode*>(root);
+    const auto& findCommand = _cq.getFindCommandRequest();
+    if (csn->direction != CollectionScanParams::FORWARD || csn->tailable || csn->minRecord ||
+        csn->maxRecord || csn->resumeAfterRecordId || csn->requestResumeToken ||
+        csn->shouldTrackLatestOplogTimestamp || csn->assertTsHasNotFallenOffOplog ||
+        csn->stopApplyingFilterAfterFirstMatch || findCommand.getTailable() ||
+        findCommand.getHint().hasField(query_request_helper::kNaturalSortField) ||
+        findCommand.getSort().hasField(query_request_helper::kNaturalSortField) ||
+        reqs.getIsBuildingUnionForTailableCollScan()) {
+        return 1;
+    }
+
+    // The stats of the producers are not available once the plan has been opened.
+    if (_cq.getExplain()) {
+        return 1;
+    }
+
+    // Every producer reads from the latest snapshot with its own operation context, which is only
+    // consistent with the guarantees of the 'local' and 'available' read concerns.
+    if (_opCtx->inMultiDocumentTransaction() ||
+        _opCtx->recoveryUnit()->getTimestampReadSource() !=
+            RecoveryUnit::ReadSource::kNoTimestamp) {
+        return 1;
+    }
+    const auto readConcernLevel = repl::ReadConcernArgs::get(_opCtx).getLevel();
+    if (readConcernLevel != repl::ReadConcernLevel::kLocalReadConcern &&
+        readConcernLevel != repl::ReadConcernLevel::kAvailableReadConcern) {
+        return 1;
+    }
+
+    const auto& collection = getCurrentCollection(reqs);
+    if (collection->isCapped() ||
+        collection->getRecordStore()->numRecords(_opCtx) <
+            internalQuerySBEParallelScanMinRecords.load()) {
+        return 1;
+    }
+
+    return degreeOfParallelism;
+}
+
 // Returns a non-null pointer to the root of a plan tree, or a non-OK status if the PlanStage tree
 // could not be constructed.
 std::pair<std::unique_ptr<sbe::PlanStage>, PlanStageSlots> SlotBasedStageBuilder::build(
@@ -196,6 +196,22 @@ public:
         _isTailableCollScanResumeBranch = b;
     }
 
+    bool getIsBuildingPartialGroupForParallelCollScan() const {
+        return _isBuildingPartialGroupForParallelCollScan;
+    }
+
+    void setIsBuildingPartialGroupForParallelCollScan(bool b) {
+        _isBuildingPartialGroupForParallelCollScan = b;
+    }
+
+    bool getIsBlockGroupFallbackBranch() const {
+        return _isBlockGroupFallbackBranch;
+    }
+
+    void setIsBlockGroupFallbackBranch(bool b) {
+        _isBlockGroupFallbackBranch = b;
+    }
+
     void setTargetNamespace(const NamespaceString& nss) {
         _targetNamespace = nss;
     }
@@ -226,6 +242,16 @@ private:
     // branch. At all other times, this flag will be false.
     bool _isTailableCollScanResumeBranch{false};
 
+    // When a GROUP node builds a parallel collection scan child, so that a partial group runs in
+    // the producers of the exchange as well, this flag will be set to true and the exchange is
+    // built by the GROUP node instead of the collection scan. Otherwise this flag will be false.
+    bool _isBuildingPartialGroupForParallelCollScan{false};
+
+    // When a GROUP node computing its accumulators over blocks of rows builds its row-at-a-time
+    // fallback plan, this flag will be set to true so that the GROUP node is not built over blocks
+    // again. Otherwise this flag will be false.
+    bool _isBlockGroupFallbackBranch{false};
+
     // Tracks the current namespace that we're building a plan over. Given that the stage builder
     // can build plans for multiple namespaces, a node in the tree that targets a namespace
     // different from its parent node can set this value to notify any child nodes of the correct
@@ -458,6 +484,14 @@ private:
      */
     const CollectionPtr& getCurrentCollection(const PlanStageReqs& reqs) const;
 
+    /**
+     * Returns the number of threads to use if 'root' is a collection scan that can run in parallel
+     * under an exchange, or 1 if it must run serially. See
+     * 'internalQuerySlotBasedExecutionDegreeOfParallelism'.
+     */
+    size_t getCollScanDegreeOfParallelism(const QuerySolutionNode* root,
+                                          const PlanStageReqs& reqs) const;
+
     sbe::value::SlotIdGenerator _slotIdGenerator;
     sbe::value::FrameIdGenerator _frameIdGenerator;
     sbe::value::SpoolIdGenerator _spoolIdGenerator;
@@ -469,6 +469,100 @@ std::pair<std::vector<std::unique_ptr<sbe::EExpression>>, EvalStage> buildAccumu
     aggs.push_back(makeFunction("mergeObjects", std::move(arg)));
     return {std::move(aggs), std::move(inputStage)};
 }
+
+std::vector<std::unique_ptr<sbe::EExpression>> buildCombinePartialAggsMin(
+    StageBuilderState& state,
+    const AccumulationExpression& expr,
+    const sbe::value::SlotVector& inputSlots) {
+    tassert(7131310,
+            str::stream() << "Expected one input slot for merging of min, got: "
+                          << inputSlots.size(),
+            inputSlots.size() == 1);
+
+    std::vector<std::unique_ptr<sbe::EExpression>> aggs;
+    auto collatorSlot = state.data->env->getSlotIfExists("collator"_sd);
+    if (collatorSlot) {
+        aggs.push_back(makeFunction("collMin"_sd,
+                                    sbe::makeE<sbe::EVariable>(*collatorSlot),
+                                    makeVariable(inputSlots[0])));
+    } else {
+        aggs.push_back(makeFunction("min"_sd, makeVariable(inputSlots[0])));
+    }
+    return aggs;
+}
+
+std::vector<std::unique_ptr<sbe::EExpression>> buildCombinePartialAggsMax(
+    StageBuilderState& state,
+    const AccumulationExpression& expr,
+    const sbe::value::SlotVector& inputSlots) {
+    tassert(7131311,
+            str::stream() << "Expected one input slot for merging of max, got: "
+                          << inputSlots.size(),
+            inputSlots.size() == 1);
+
+    std::vector<std::unique_ptr<sbe::EExpression>> aggs;
+    auto collatorSlot = state.data->env->getSlotIfExists("collator"_sd);
+    if (collatorSlot) {
+        aggs.push_back(makeFunction("collMax"_sd,
+                                    sbe::makeE<sbe::EVariable>(*collatorSlot),
+                                    makeVariable(inputSlots[0])));
+    } else {
+        aggs.push_back(makeFunction("max"_sd, makeVariable(inputSlots[0])));
+    }
+    return aggs;
+}
+
+std::vector<std::unique_ptr<sbe::EExpression>> buildCombinePartialAggsAvg(
+    StageBuilderState& state,
+    const AccumulationExpression& expr,
+    const sbe::value::SlotVector& inputSlots) {
+    // Slot 0 contains the partial sum, and slot 1 contains the partial count of summed items.
+    tassert(7131312,
+            str::stream() << "Expected two input slots for merging of avg, got: "
+                          << inputSlots.size(),
+            inputSlots.size() == 2);
+
+    std::vector<std::unique_ptr<sbe::EExpression>> aggs;
+    aggs.push_back(makeFunction("aggMergeDoubleDoubleSums", makeVariable(inputSlots[0])));
+    aggs.push_back(makeFunction("sum", makeVariable(inputSlots[1])));
+    return aggs;
+}
+
+std::vector<std::unique_ptr<sbe::EExpression>> buildCombinePartialAggsSum(
+    StageBuilderState& state,
+    const AccumulationExpression& expr,
+    const sbe::value::SlotVector& inputSlots) {
+    tassert(7131313,
+            str::stream() << "Expected one input slot for merging of sum, got: "
+                          << inputSlots.size(),
+            inputSlots.size() == 1);
+
+    std::vector<std::unique_ptr<sbe::EExpression>> aggs;
+    aggs.push_back(makeFunction("aggMergeDoubleDoubleSums", makeVariable(inputSlots[0])));
+    return aggs;
+}
+
+using BuildCombinePartialAggsFn = std::function<std::vector<std::unique_ptr<sbe::EExpression>>(
+    StageBuilderState&, const AccumulationExpression&, const sbe::value::SlotVector&)>;
+
+// Only the accumulators whose partial results do not depend on the order of the input can be
+// combined. The others map to nullptr.
+const StringDataMap<BuildCombinePartialAggsFn>& getCombinePartialAggsBuilders() {
+    static const StringDataMap<BuildCombinePartialAggsFn> kCombinePartialAggsBuilders = {
+        {AccumulatorMin::kName, &buildCombinePartialAggsMin},
+        {AccumulatorMax::kName, &buildCombinePartialAggsMax},
+        {AccumulatorFirst::kName, nullptr},
+        {AccumulatorLast::kName, nullptr},
+        {AccumulatorAvg::kName, &buildCombinePartialAggsAvg},
+        {AccumulatorAddToSet::kName, nullptr},
+        {AccumulatorSum::kName, &buildCombinePartialAggsSum},
+        {AccumulatorPush::kName, nullptr},
+        {AccumulatorMergeObjects::kName, nullptr},
+        {AccumulatorStdDevPop::kName, nullptr},
+        {AccumulatorStdDevSamp::kName, nullptr},
+    };
+    return kCombinePartialAggsBuilders;
+}
 };  // namespace
 
 std::pair<std::unique_ptr<sbe::EExpression>, EvalStage> buildArgument(
@@ -562,4 +656,79 @@ std::pair<std::unique_ptr<sbe::EExpression>, EvalStage> buildFinalize(
         return {nullptr, std::move(inputStage)};
     }
 }
+
+bool canCombinePartialAggregates(const AccumulationStatement& acc) {
+    const auto& builders = getCombinePartialAggsBuilders();
+    auto it = builders.find(acc.expr.name);
+    return it != builders.end() && it->second;
+}
+
+std::vector<std::unique_ptr<sbe::EExpression>> buildCombinePartialAggregates(
+    StageBuilderState& state,
+    const AccumulationStatement& acc,
+    const sbe::value::SlotVector& inputSlots) {
+    auto accExprName = acc.expr.name;
+    tassert(7131314,
+            str::stream() << "Cannot combine the partial results of accumulator: " << accExprName,
+            canCombinePartialAggregates(acc));
+
+    return std::invoke(
+        getCombinePartialAggsBuilders().at(accExprName), state, acc.expr, inputSlots);
+}
+
+bool canBuildBlockAccumulator(const AccumulationStatement& acc) {
+    auto accExprName = acc.expr.name;
+    if (accExprName != AccumulatorSum::kName && accExprName != AccumulatorMin::kName &&
+        accExprName != AccumulatorMax::kName) {
+        return false;
+    }
+
+    if (auto constant = dynamic_cast<const ExpressionConstant*>(acc.expr.argument.get())) {
+        return accExprName == AccumulatorSum::kName &&
+            constant->getValue().getType() == BSONType::NumberInt;
+    }
+    auto fieldPath = dynamic_cast<const ExpressionFieldPath*>(acc.expr.argument.get());
+    return fieldPath && !fieldPath->isVariableReference() &&
+        fieldPath->getFieldPath().getPathLength() == 2;
+}
+
+boost::optional<std::string> getBlockAccumulatorField(const AccumulationStatement& acc) {
+    tassert(7132218, "Cannot compute the accumulator over blocks", canBuildBlockAccumulator(acc));
+
+    if (auto fieldPath = dynamic_cast<const ExpressionFieldPath*>(acc.expr.argument.get())) {
+        return fieldPath->getFieldPath().getFieldName(1).toString();
+    }
+    return boost::none;
+}
+
+std::unique_ptr<sbe::EExpression> buildBlockAccumulator(
+    StageBuilderState& state,
+    const AccumulationStatement& acc,
+    boost::optional<sbe::value::SlotId> bitmapSlot,
+    sbe::value::SlotId blockSlot) {
+    tassert(7132219, "Cannot compute the accumulator over blocks", canBuildBlockAccumulator(acc));
+
+    auto bitmap =
+        bitmapSlot ? makeVariable(*bitmapSlot) : makeConstant(sbe::value::TypeTags::Nothing, 0);
+    auto accExprName = acc.expr.name;
+    if (accExprName == AccumulatorMin::kName || accExprName == AccumulatorMax::kName) {
+        return makeFunction(accExprName == AccumulatorMin::kName ? "valueBlockMin"_sd
+                                                                 : "valueBlockMax"_sd,
+                            std::move(bitmap),
+                            makeVariable(blockSlot));
+    }
+
+    // The partial sums are kept in the same state as by 'aggDoubleDoubleSum', so that they can be
+    // combined with 'aggMergeDoubleDoubleSums'. The sum of a constant adds it once per row.
+    if (auto constant = dynamic_cast<const ExpressionConstant*>(acc.expr.argument.get())) {
+        return makeFunction("valueBlockAggDoubleDoubleSum"_sd,
+                            std::move(bitmap),
+                            makeVariable(blockSlot),
+                            makeConstant(sbe::value::TypeTags::NumberInt32,
+                                         sbe::value::bitcastFrom<int32_t>(
+                                             constant->getValue().getInt())));
+    }
+    return makeFunction(
+        "valueBlockAggDoubleDoubleSum"_sd, std::move(bitmap), makeVariable(blockSlot));
+}
 }  // namespace mongo::stage_builder
@@ -71,4 +71,45 @@ std::pair<std::unique_ptr<sbe::EExpression>, EvalStage> buildFinalize(
     const sbe::value::SlotVector& aggSlots,
     EvalStage stage,
     PlanNodeId planNodeId);
+
+/**
+ * Returns true if the partial results that the accumulator of 'acc' computes over disjoint parts of
+ * its input can be combined with 'buildCombinePartialAggregates()'.
+ */
+bool canCombinePartialAggregates(const AccumulationStatement& acc);
+
+/**
+ * Translates an input AccumulationStatement into SBE EExpressions for the accumulation expressions
+ * that combine the partial results held in 'inputSlots', as produced by the expressions returned
+ * from 'buildAccumulator()'. The combined results can be finalized with 'buildFinalize()'.
+ */
+std::vector<std::unique_ptr<sbe::EExpression>> buildCombinePartialAggregates(
+    StageBuilderState& state,
+    const AccumulationStatement& acc,
+    const sbe::value::SlotVector& inputSlots);
+
+/**
+ * Returns true if the accumulator of 'acc' can be computed over blocks of rows with
+ * 'buildBlockAccumulator()'. These are the $sum of a 32-bit integer constant, and the $sum, $min and
+ * $max of a top-level field.
+ */
+bool canBuildBlockAccumulator(const AccumulationStatement& acc);
+
+/**
+ * Returns the top-level field which the accumulator of 'acc' is computed over, or boost::none if
+ * the accumulator is computed over a constant. The 'acc' must satisfy 'canBuildBlockAccumulator()'.
+ */
+boost::optional<std::string> getBlockAccumulatorField(const AccumulationStatement& acc);
+
+/**
+ * Translates an input AccumulationStatement into an SBE EExpression which computes the partial
+ * result of the accumulator over the rows of the block held in 'blockSlot' which are selected by
+ * the bitmap held in 'bitmapSlot', or over all of them if there is no bitmap. The partial results
+ * of the blocks can be combined with 'buildCombinePartialAggregates()'.
+ */
+std::unique_ptr<sbe::EExpression> buildBlockAccumulator(
+    StageBuilderState& state,
+    const AccumulationStatement& acc,
+    boost::optional<sbe::value::SlotId> bitmapSlot,
+    sbe::value::SlotId blockSlot);
 }  // namespace mongo::stage_builder
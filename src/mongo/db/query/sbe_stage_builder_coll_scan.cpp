@@ -34,14 +34,20 @@
 #include "mongo/db/query/sbe_stage_builder_coll_scan.h"
 
 #include "mongo/db/catalog/collection.h"
+#include "mongo/db/exec/sbe/stages/block_to_row.h"
+#include "mongo/db/exec/sbe/stages/branch.h"
 #include "mongo/db/exec/sbe/stages/co_scan.h"
 #include "mongo/db/exec/sbe/stages/exchange.h"
 #include "mongo/db/exec/sbe/stages/filter.h"
 #include "mongo/db/exec/sbe/stages/limit_skip.h"
 #include "mongo/db/exec/sbe/stages/loop_join.h"
 #include "mongo/db/exec/sbe/stages/project.h"
+#include "mongo/db/exec/sbe/stages/row_to_block.h"
 #include "mongo/db/exec/sbe/stages/scan.h"
 #include "mongo/db/exec/sbe/stages/union.h"
+#include "mongo/db/matcher/expression_leaf.h"
+#include "mongo/db/matcher/expression_tree.h"
+#include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/db/query/sbe_stage_builder.h"
 #include "mongo/db/query/sbe_stage_builder_filter.h"
 #include "mongo/db/query/util/make_data_structure.h"
@@ -526,6 +532,310 @@ std::pair<std::unique_ptr<sbe::PlanStage>, PlanStageSlots> generateOptimizedOplo
     return {std::move(stage), std::move(outputs)};
 }
 
+std::pair<std::unique_ptr<sbe::PlanStage>, PlanStageSlots> generateGenericCollScan(
+    StageBuilderState& state,
+    const CollectionPtr& collection,
+    const CollectionScanNode* csn,
+    PlanYieldPolicy* yieldPolicy,
+    bool isTailableResumeBranch,
+    bool isParallelScan,
+    bool allowBlockScan = true);
+
+/**
+ * Returns true if the collection scan 'csn' can return its rows in blocks. Only the plain scans of
+ * a collection can, as opposed to the scans which resume from a RecordId or track the latest oplog
+ * timestamp, and the tailable ones.
+ */
+bool canUseBlockScan(const CollectionScanNode* csn, bool isTailableResumeBranch) {
+    return !csn->resumeAfterRecordId && !csn->shouldTrackLatestOplogTimestamp && !csn->tailable &&
+        !isTailableResumeBranch;
+}
+
+/**
+ * Returns the comparisons of the collection scan filter 'filter' which can be evaluated for a whole
+ * block of rows at a time: the comparisons of a top-level field to a number other than NaN, either
+ * at the root of the filter or as the children of a root $and.
+ */
+std::vector<const ComparisonMatchExpression*> getBlockComparisons(const MatchExpression* filter) {
+    auto isEligible = [](const MatchExpression* expr) {
+        switch (expr->matchType()) {
+            case MatchExpression::EQ:
+            case MatchExpression::LT:
+            case MatchExpression::LTE:
+            case MatchExpression::GT:
+            case MatchExpression::GTE:
+                break;
+            default:
+                return false;
+        }
+
+        auto cmp = static_cast<const ComparisonMatchExpression*>(expr);
+        const auto& rhs = cmp->getData();
+        return !cmp->path().empty() && cmp->path().find('.') == std::string::npos &&
+            rhs.isNumber() && !std::isnan(rhs.numberDouble());
+    };
+
+    std::vector<const ComparisonMatchExpression*> comparisons;
+    if (filter->matchType() == MatchExpression::AND) {
+        for (size_t idx = 0; idx < filter->numChildren(); ++idx) {
+            if (auto child = filter->getChild(idx); isEligible(child)) {
+                comparisons.push_back(static_cast<const ComparisonMatchExpression*>(child));
+            }
+        }
+    } else if (isEligible(filter)) {
+        comparisons.push_back(static_cast<const ComparisonMatchExpression*>(filter));
+    }
+    return comparisons;
+}
+
+/**
+ * Returns a copy of the collection scan filter 'filter' without the 'comparisons' which are applied
+ * to blocks of rows, or nullptr if nothing else is left of the filter.
+ */
+std::unique_ptr<MatchExpression> removeBlockComparisons(
+    const MatchExpression* filter,
+    const std::vector<const ComparisonMatchExpression*>& comparisons) {
+    auto isBlockComparison = [&](const MatchExpression* expr) {
+        return std::find(comparisons.begin(), comparisons.end(), expr) != comparisons.end();
+    };
+
+    if (filter->matchType() != MatchExpression::AND) {
+        return isBlockComparison(filter) ? nullptr : filter->shallowClone();
+    }
+
+    auto residual = filter->shallowClone();
+    auto residualAnd = static_cast<AndMatchExpression*>(residual.get());
+    for (size_t idx = filter->numChildren(); idx-- > 0;) {
+        if (isBlockComparison(filter->getChild(idx))) {
+            residualAnd->removeChild(idx);
+        }
+    }
+    return residualAnd->numChildren() > 0 ? std::move(residual) : nullptr;
+}
+
+/**
+ * Generates an expression which computes, for the block of values of a top-level field held in
+ * 'fieldBlockSlot', the bitmap of the rows which match the comparison 'cmp'. The bitmap is exact:
+ * the comparison does not have to be applied to the rows again.
+ */
+std::unique_ptr<sbe::EExpression> generateBlockComparisonBitmap(
+    StageBuilderState& state,
+    const ComparisonMatchExpression* cmp,
+    sbe::value::SlotId fieldBlockSlot) {
+    auto rhs = [&]() -> std::unique_ptr<sbe::EExpression> {
+        if (auto inputParam = cmp->getInputParamId()) {
+            return makeVariable(state.registerInputParamSlot(*inputParam));
+        }
+        auto [tag, val] = sbe::bson::convertFrom<false>(cmp->getData());
+        return makeConstant(tag, val);
+    }();
+
+    auto builtinName = [&]() -> StringData {
+        switch (cmp->matchType()) {
+            case MatchExpression::EQ:
+                return "valueBlockMatchEqScalar"_sd;
+            case MatchExpression::LT:
+                return "valueBlockMatchLtScalar"_sd;
+            case MatchExpression::LTE:
+                return "valueBlockMatchLteScalar"_sd;
+            case MatchExpression::GT:
+                return "valueBlockMatchGtScalar"_sd;
+            case MatchExpression::GTE:
+                return "valueBlockMatchGteScalar"_sd;
+            default:
+                MONGO_UNREACHABLE_TASSERT(7132215);
+        }
+    }();
+
+    return makeFunction(builtinName, makeVariable(fieldBlockSlot), std::move(rhs));
+}
+
+/**
+ * Generates an expression which is true if the auto-parameterized 'comparisons' are bound to
+ * numbers other than NaN. A cached plan can be reused with constants of any type, and the block
+ * builtins only decide the comparisons to such numbers. Returns nullptr if none of the comparisons
+ * is auto-parameterized.
+ */
+std::unique_ptr<sbe::EExpression> generateBlockParamGuard(
+    StageBuilderState& state, const std::vector<const ComparisonMatchExpression*>& comparisons) {
+    std::unique_ptr<sbe::EExpression> guard;
+    for (auto cmp : comparisons) {
+        auto inputParam = cmp->getInputParamId();
+        if (!inputParam) {
+            continue;
+        }
+
+        auto paramSlot = state.registerInputParamSlot(*inputParam);
+        auto isValid = makeBinaryOp(sbe::EPrimBinary::logicAnd,
+                                    makeFunction("isNumber", makeVariable(paramSlot)),
+                                    makeNot(makeFunction("isNaN", makeVariable(paramSlot))));
+        guard = guard
+            ? makeBinaryOp(sbe::EPrimBinary::logicAnd, std::move(guard), std::move(isValid))
+            : std::move(isValid);
+    }
+    return guard;
+}
+
+/**
+ * Generates a scan of the collection 'csn' which returns up to 'blockSize' rows at a time. The
+ * values of the top-level 'fields', along with the compared fields of the 'comparisons', are
+ * collected into blocks by a row_to_block stage, and so are the documents and their RecordIds if
+ * 'withRecords' is true. If there are 'comparisons', a project computes the bitmap of the rows of
+ * each block which match all of them.
+ */
+BlockCollScan generateBlockScan(StageBuilderState& state,
+                                const CollectionPtr& collection,
+                                const CollectionScanNode* csn,
+                                PlanYieldPolicy* yieldPolicy,
+                                const std::vector<std::string>& fields,
+                                const std::vector<const ComparisonMatchExpression*>& comparisons,
+                                bool withRecords,
+                                size_t blockSize) {
+    const auto nodeId = csn->nodeId();
+    BlockCollScan out;
+
+    // The documents themselves are only read if they are returned.
+    auto resultSlot = withRecords ? boost::make_optional(state.slotId()) : boost::none;
+    auto recordIdSlot = state.slotId();
+    std::vector<std::string> scanFields;
+    sbe::value::SlotVector scanSlots;
+    auto addField = [&](const std::string& field) {
+        if (std::find(scanFields.begin(), scanFields.end(), field) == scanFields.end()) {
+            scanFields.push_back(field);
+            scanSlots.push_back(state.slotId());
+        }
+    };
+    for (auto&& field : fields) {
+        addField(field);
+    }
+    for (auto cmp : comparisons) {
+        addField(cmp->path().toString());
+    }
+
+    sbe::value::SlotVector inputSlots;
+    sbe::value::SlotVector blockSlots;
+    if (withRecords) {
+        out.resultBlockSlot = state.slotId();
+        out.recordIdBlockSlot = state.slotId();
+        inputSlots = sbe::makeSV(*resultSlot, recordIdSlot);
+        blockSlots = sbe::makeSV(*out.resultBlockSlot, *out.recordIdBlockSlot);
+    }
+    for (size_t idx = 0; idx < scanFields.size(); ++idx) {
+        auto blockSlot = state.slotId();
+        inputSlots.push_back(scanSlots[idx]);
+        blockSlots.push_back(blockSlot);
+        out.fieldBlockSlots.emplace(scanFields[idx], blockSlot);
+    }
+    // There has to be at least one block, to tell how many rows there are in each batch.
+    if (inputSlots.empty()) {
+        inputSlots.push_back(recordIdSlot);
+        blockSlots.push_back(state.slotId());
+    }
+    out.rowBlockSlot = blockSlots[0];
+
+    sbe::ScanCallbacks callbacks({}, {}, makeOpenCallbackIfNeeded(collection, csn));
+    out.stage = sbe::makeS<sbe::ScanStage>(collection->uuid(),
+                                           resultSlot,
+                                           recordIdSlot,
+                                           boost::none /* snapshotIdSlot */,
+                                           boost::none /* indexIdSlot */,
+                                           boost::none /* indexKeySlot */,
+                                           boost::none /* keyPatternSlot */,
+                                           boost::none /* oplogTsSlot */,
+                                           std::move(scanFields),
+                                           std::move(scanSlots),
+                                           boost::none /* seekKeySlot */,
+                                           csn->direction == CollectionScanParams::FORWARD,
+                                           yieldPolicy,
+                                           nodeId,
+                                           std::move(callbacks));
+    out.stage = sbe::makeS<sbe::RowToBlockStage>(
+        std::move(out.stage), std::move(inputSlots), std::move(blockSlots), blockSize, nodeId);
+
+    std::unique_ptr<sbe::EExpression> bitmap;
+    for (auto cmp : comparisons) {
+        auto cmpBitmap =
+            generateBlockComparisonBitmap(state, cmp, out.fieldBlockSlots.at(cmp->path()));
+        bitmap = bitmap
+            ? makeFunction("valueBlockLogicalAnd", std::move(bitmap), std::move(cmpBitmap))
+            : std::move(cmpBitmap);
+    }
+    if (bitmap) {
+        out.bitmapSlot = state.slotId();
+        out.stage =
+            makeProjectStage(std::move(out.stage), nodeId, *out.bitmapSlot, std::move(bitmap));
+    }
+    out.paramGuard = generateBlockParamGuard(state, comparisons);
+
+    return out;
+}
+
+/**
+ * Generates a collection scan which applies the 'comparisons' of the filter of 'csn' to blocks of
+ * rows, returns the matching rows with a block_to_row stage, and applies the rest of the filter to
+ * them. If the comparisons are auto-parameterized, a branch stage falls back to the row-at-a-time
+ * plan when the plan is reused with constants the block builtins do not decide.
+ */
+std::pair<std::unique_ptr<sbe::PlanStage>, PlanStageSlots> generateBlockFilterCollScan(
+    StageBuilderState& state,
+    const CollectionPtr& collection,
+    const CollectionScanNode* csn,
+    PlanYieldPolicy* yieldPolicy,
+    const std::vector<const ComparisonMatchExpression*>& comparisons,
+    size_t blockSize) {
+    const auto nodeId = csn->nodeId();
+    auto blockScan = generateBlockScan(
+        state, collection, csn, yieldPolicy, {}, comparisons, true /* withRecords */, blockSize);
+
+    auto resultSlot = state.slotId();
+    auto recordIdSlot = state.slotId();
+    auto stage =
+        sbe::makeS<sbe::BlockToRowStage>(std::move(blockScan.stage),
+                                         sbe::makeSV(*blockScan.resultBlockSlot,
+                                                     *blockScan.recordIdBlockSlot),
+                                         sbe::makeSV(resultSlot, recordIdSlot),
+                                         blockScan.bitmapSlot,
+                                         nodeId);
+
+    if (auto residualFilter = removeBlockComparisons(csn->filter.get(), comparisons)) {
+        auto relevantSlots = sbe::makeSV(resultSlot, recordIdSlot);
+        auto [_, outputStage] = generateFilter(state,
+                                               residualFilter.get(),
+                                               {std::move(stage), std::move(relevantSlots)},
+                                               resultSlot,
+                                               nodeId);
+        stage = std::move(outputStage.stage);
+    }
+
+    if (blockScan.paramGuard) {
+        auto [rowStage, rowOutputs] = generateGenericCollScan(state,
+                                                              collection,
+                                                              csn,
+                                                              yieldPolicy,
+                                                              false /* isTailableResumeBranch */,
+                                                              false /* isParallelScan */,
+                                                              false /* allowBlockScan */);
+        auto outResultSlot = state.slotId();
+        auto outRecordIdSlot = state.slotId();
+        stage = sbe::makeS<sbe::BranchStage>(
+            std::move(stage),
+            std::move(rowStage),
+            std::move(blockScan.paramGuard),
+            sbe::makeSV(resultSlot, recordIdSlot),
+            sbe::makeSV(rowOutputs.get(PlanStageSlots::kResult),
+                        rowOutputs.get(PlanStageSlots::kRecordId)),
+            sbe::makeSV(outResultSlot, outRecordIdSlot),
+            nodeId);
+        resultSlot = outResultSlot;
+        recordIdSlot = outRecordIdSlot;
+    }
+
+    PlanStageSlots outputs;
+    outputs.set(PlanStageSlots::kResult, resultSlot);
+    outputs.set(PlanStageSlots::kRecordId, recordIdSlot);
+    return {std::move(stage), std::move(outputs)};
+}
+
 /**
  * Generates a generic collection scan sub-tree.
  *  - If a resume token has been provided, the scan will start from a RecordId contained within this
@@ -533,19 +843,36 @@ std::pair<std::unique_ptr<sbe::PlanStage>, PlanStageSlots> generateOptimizedOplo
  *  - Else if 'isTailableResumeBranch' is true, the scan will start from a RecordId contained in
  * slot "resumeRecordId".
  *  - Otherwise the scan will start from the beginning of the collection.
+ *
+ * If 'isParallelScan' is true, a parallel scan which splits the collection between the producers of
+ * an exchange built above it is generated instead.
+ *
+ * If 'allowBlockScan' is true and 'internalQuerySlotBasedExecutionBlockSize' is set, the
+ * comparisons of the filter which the block builtins support are applied to blocks of rows.
  */
 std::pair<std::unique_ptr<sbe::PlanStage>, PlanStageSlots> generateGenericCollScan(
     StageBuilderState& state,
     const CollectionPtr& collection,
     const CollectionScanNode* csn,
     PlanYieldPolicy* yieldPolicy,
-    bool isTailableResumeBranch) {
+    bool isTailableResumeBranch,
+    bool isParallelScan,
+    bool allowBlockScan) {
     const auto forward = csn->direction == CollectionScanParams::FORWARD;
 
     invariant(!csn->shouldTrackLatestOplogTimestamp || collection->ns().isOplog());
     invariant(!csn->resumeAfterRecordId || forward);
     invariant(!csn->resumeAfterRecordId || !csn->tailable);
 
+    const auto blockSize = internalQuerySlotBasedExecutionBlockSize.load();
+    if (allowBlockScan && csn->filter && blockSize > 0 && !isParallelScan &&
+        canUseBlockScan(csn, isTailableResumeBranch)) {
+        if (auto comparisons = getBlockComparisons(csn->filter.get()); !comparisons.empty()) {
+            return generateBlockFilterCollScan(
+                state, collection, csn, yieldPolicy, comparisons, blockSize);
+        }
+    }
+
     auto resultSlot = state.slotId();
     auto recordIdSlot = state.slotId();
     auto [seekRecordIdSlot, seekRecordIdExpression] =
@@ -565,21 +892,40 @@ std::pair<std::unique_ptr<sbe::PlanStage>, PlanStageSlots> generateGenericCollSc
         state.data->env, state.slotIdGenerator, csn->shouldTrackLatestOplogTimestamp);
 
     sbe::ScanCallbacks callbacks({}, {}, makeOpenCallbackIfNeeded(collection, csn));
-    auto stage = sbe::makeS<sbe::ScanStage>(collection->uuid(),
-                                            resultSlot,
-                                            recordIdSlot,
-                                            boost::none /* snapshotIdSlot */,
-                                            boost::none /* indexIdSlot */,
-                                            boost::none /* indexKeySlot */,
-                                            boost::none /* keyPatternSlot */,
-                                            tsSlot,
-                                            std::move(fields),
-                                            std::move(slots),
-                                            seekRecordIdSlot,
-                                            forward,
-                                            yieldPolicy,
-                                            csn->nodeId(),
-                                            std::move(callbacks));
+    std::unique_ptr<sbe::PlanStage> stage;
+    if (isParallelScan) {
+        invariant(forward && !seekRecordIdSlot && !tsSlot);
+
+        // The producers of the exchange run with their own operation contexts and do not yield.
+        stage = sbe::makeS<sbe::ParallelScanStage>(collection->uuid(),
+                                                   resultSlot,
+                                                   recordIdSlot,
+                                                   boost::none /* snapshotIdSlot */,
+                                                   boost::none /* indexIdSlot */,
+                                                   boost::none /* indexKeySlot */,
+                                                   boost::none /* keyPatternSlot */,
+                                                   std::move(fields),
+                                                   std::move(slots),
+                                                   nullptr /* yieldPolicy */,
+                                                   csn->nodeId(),
+                                                   std::move(callbacks));
+    } else {
+        stage = sbe::makeS<sbe::ScanStage>(collection->uuid(),
+                                           resultSlot,
+                                           recordIdSlot,
+                                           boost::none /* snapshotIdSlot */,
+                                           boost::none /* indexIdSlot */,
+                                           boost::none /* indexKeySlot */,
+                                           boost::none /* keyPatternSlot */,
+                                           tsSlot,
+                                           std::move(fields),
+                                           std::move(slots),
+                                           seekRecordIdSlot,
+                                           forward,
+                                           yieldPolicy,
+                                           csn->nodeId(),
+                                           std::move(callbacks));
+    }
 
     if (seekRecordIdSlot) {
         stage = buildResumeFromRecordIdSubtree(state,
@@ -622,12 +968,44 @@ std::pair<std::unique_ptr<sbe::PlanStage>, PlanStageSlots> generateCollScan(
     const CollectionPtr& collection,
     const CollectionScanNode* csn,
     PlanYieldPolicy* yieldPolicy,
-    bool isTailableResumeBranch) {
+    bool isTailableResumeBranch,
+    bool isParallelScan) {
     if (csn->minRecord || csn->maxRecord || csn->stopApplyingFilterAfterFirstMatch) {
+        invariant(!isParallelScan);
         return generateOptimizedOplogScan(
             state, collection, csn, yieldPolicy, isTailableResumeBranch);
     } else {
-        return generateGenericCollScan(state, collection, csn, yieldPolicy, isTailableResumeBranch);
+        return generateGenericCollScan(
+            state, collection, csn, yieldPolicy, isTailableResumeBranch, isParallelScan);
     }
 }
+
+boost::optional<BlockCollScan> generateBlockCollScan(StageBuilderState& state,
+                                                     const CollectionPtr& collection,
+                                                     const CollectionScanNode* csn,
+                                                     PlanYieldPolicy* yieldPolicy,
+                                                     const std::vector<std::string>& fields,
+                                                     size_t blockSize) {
+    if (csn->minRecord || csn->maxRecord || csn->stopApplyingFilterAfterFirstMatch ||
+        !canUseBlockScan(csn, false /* isTailableResumeBranch */)) {
+        return boost::none;
+    }
+
+    std::vector<const ComparisonMatchExpression*> comparisons;
+    if (csn->filter) {
+        comparisons = getBlockComparisons(csn->filter.get());
+        if (comparisons.empty() || removeBlockComparisons(csn->filter.get(), comparisons)) {
+            return boost::none;
+        }
+    }
+
+    return generateBlockScan(state,
+                             collection,
+                             csn,
+                             yieldPolicy,
+                             fields,
+                             comparisons,
+                             false /* withRecords */,
+                             blockSize);
+}
 }  // namespace mongo::stage_builder
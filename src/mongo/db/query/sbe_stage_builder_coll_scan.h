@@ -35,6 +35,7 @@
 #include "mongo/db/exec/sbe/values/value.h"
 #include "mongo/db/query/query_solution.h"
 #include "mongo/db/query/sbe_stage_builder_helpers.h"
+#include "mongo/util/string_map.h"
 
 namespace mongo::stage_builder {
 
@@ -50,6 +51,9 @@ class PlanStageSlots;
  *     were requested to track this data.
  *   * A generated PlanStage sub-tree.
  *
+ * If 'isParallelScan' is true, the generated sub-tree is meant to run in the producers of an
+ * exchange and scans a part of the collection in each of them.
+ *
  * In cases of an error, throws.
  */
 std::pair<std::unique_ptr<sbe::PlanStage>, PlanStageSlots> generateCollScan(
@@ -57,6 +61,44 @@ std::pair<std::unique_ptr<sbe::PlanStage>, PlanStageSlots> generateCollScan(
     const CollectionPtr& collection,
     const CollectionScanNode* csn,
     PlanYieldPolicy* yieldPolicy,
-    bool isTailableResumeBranch);
+    bool isTailableResumeBranch,
+    bool isParallelScan);
+
+/**
+ * The slots of a collection scan which returns blocks of rows, as generated by
+ * 'generateBlockCollScan()'.
+ */
+struct BlockCollScan {
+    std::unique_ptr<sbe::PlanStage> stage;
+
+    // The blocks of values of the requested top-level fields, keyed by the field name.
+    StringMap<sbe::value::SlotId> fieldBlockSlots;
+
+    // A block with a value for every row of the batch, to count the rows of the batch.
+    sbe::value::SlotId rowBlockSlot;
+
+    // The bitmap of the rows of the batch which match the filter of the scan, if it has any.
+    boost::optional<sbe::value::SlotId> bitmapSlot;
+
+    // The blocks of the documents and of their RecordIds, if they are returned.
+    boost::optional<sbe::value::SlotId> resultBlockSlot;
+    boost::optional<sbe::value::SlotId> recordIdBlockSlot;
+
+    // If the filter is auto-parameterized, an expression which is true if the parameters are
+    // constants the block builtins can apply the filter with. Otherwise nullptr.
+    std::unique_ptr<sbe::EExpression> paramGuard;
+};
+
+/**
+ * Generates a scan of the collection 'csn' which returns up to 'blockSize' rows at a time, with the
+ * values of the top-level 'fields' in blocks. Returns boost::none if the scan cannot return blocks,
+ * or if its filter cannot be fully applied to the blocks.
+ */
+boost::optional<BlockCollScan> generateBlockCollScan(StageBuilderState& state,
+                                                     const CollectionPtr& collection,
+                                                     const CollectionScanNode* csn,
+                                                     PlanYieldPolicy* yieldPolicy,
+                                                     const std::vector<std::string>& fields,
+                                                     size_t blockSize);
 
 }  // namespace mongo::stage_builder
@@ -2025,6 +2025,205 @@ public:
 private:
     MatchExpressionVisitorContext* _context;
 };
+
+/**
+ * Generates an expression which applies the predicate built by 'makePredicate' to the values found
+ * at 'path' in the document produced by 'inputExpr', traversing arrays along the path the same way
+ * 'generatePathTraversal()' does. If 'compareArrays' is true, the predicate is also applied to the
+ * arrays found at the leaf of the path, as well as to their elements.
+ */
+std::unique_ptr<sbe::EExpression> generateTraverseFExpr(
+    StageBuilderState& state,
+    const FieldRef& path,
+    FieldIndex level,
+    std::unique_ptr<sbe::EExpression> inputExpr,
+    const std::function<std::unique_ptr<sbe::EExpression>(std::unique_ptr<sbe::EExpression>)>&
+        makePredicate,
+    bool compareArrays) {
+    const bool isLeafField = (level == path.numParts() - 1u);
+    auto frameId = state.frameId();
+
+    auto innerExpr = isLeafField
+        ? makePredicate(makeVariable(frameId, 0))
+        : generateTraverseFExpr(
+              state, path, level + 1, makeVariable(frameId, 0), makePredicate, compareArrays);
+
+    return makeFunction(
+        "traverseF",
+        makeFunction("getField", std::move(inputExpr), makeConstant(path.getPart(level))),
+        sbe::makeE<sbe::ELocalLambda>(frameId, std::move(innerExpr)),
+        makeConstant(sbe::value::TypeTags::Boolean,
+                     sbe::value::bitcastFrom<bool>(isLeafField && compareArrays)));
+}
+
+/**
+ * Returns true if the comparison 'expr' does not need the special handling of MinKey, MaxKey, null
+ * or NaN done by 'generateComparison()'.
+ */
+bool isSimpleComparison(const ComparisonMatchExpression* expr) {
+    const auto& rhs = expr->getData();
+    auto [tagView, valView] = sbe::bson::convertFrom<true>(
+        rhs.rawdata(), rhs.rawdata() + rhs.size(), rhs.fieldNameSize() - 1);
+
+    return tagView != sbe::value::TypeTags::MinKey && tagView != sbe::value::TypeTags::MaxKey &&
+        tagView != sbe::value::TypeTags::Null && !sbe::value::isNaN(tagView, valView);
+}
+
+/**
+ * Returns an expression applying the comparison 'expr', which must satisfy 'isSimpleComparison()',
+ * to a value produced by 'inputExpr'.
+ */
+std::unique_ptr<sbe::EExpression> generateSimpleComparisonExpr(
+    StageBuilderState& state,
+    const ComparisonMatchExpression* expr,
+    sbe::EPrimBinary::Op binaryOp,
+    std::unique_ptr<sbe::EExpression> inputExpr) {
+    const auto& rhs = expr->getData();
+    auto [tagView, valView] = sbe::bson::convertFrom<true>(
+        rhs.rawdata(), rhs.rawdata() + rhs.size(), rhs.fieldNameSize() - 1);
+
+    auto valExpr = [&](sbe::value::TypeTags typeTag,
+                       sbe::value::Value value) -> std::unique_ptr<sbe::EExpression> {
+        if (auto inputParam = expr->getInputParamId()) {
+            return makeVariable(state.registerInputParamSlot(*inputParam));
+        }
+        auto [tag, val] = sbe::value::copyValue(typeTag, value);
+        return makeConstant(tag, val);
+    }(tagView, valView);
+
+    return makeFillEmptyFalse(
+        makeBinaryOp(binaryOp, std::move(inputExpr), std::move(valExpr), state.data->env));
+}
+
+/**
+ * Returns an expression applying the leaf predicate 'me' to the values found at its path in the
+ * document produced by 'inputExpr', or nullptr if 'me' is not supported. If 'isScalar' is true,
+ * 'inputExpr' produces the single scalar value found at the path instead, and the predicate is
+ * applied to it directly.
+ */
+std::unique_ptr<sbe::EExpression> generateColumnLeafFilterExpr(
+    StageBuilderState& state,
+    const MatchExpression* me,
+    std::unique_ptr<sbe::EExpression> inputExpr,
+    bool isScalar) {
+    auto makeComparison = [&](sbe::EPrimBinary::Op binaryOp) -> std::unique_ptr<sbe::EExpression> {
+        auto expr = checked_cast<const ComparisonMatchExpression*>(me);
+        // Comparisons with an array must also be applied to the arrays themselves.
+        const bool compareArrays = expr->getData().type() == BSONType::Array;
+        if (!isSimpleComparison(expr)) {
+            return nullptr;
+        }
+        if (isScalar) {
+            return generateSimpleComparisonExpr(state, expr, binaryOp, std::move(inputExpr));
+        }
+        return generateTraverseFExpr(
+            state,
+            *expr->fieldRef(),
+            0,
+            std::move(inputExpr),
+            [&](std::unique_ptr<sbe::EExpression> valueExpr) {
+                return generateSimpleComparisonExpr(state, expr, binaryOp, std::move(valueExpr));
+            },
+            compareArrays);
+    };
+
+    switch (me->matchType()) {
+        case MatchExpression::EQ:
+            return makeComparison(sbe::EPrimBinary::eq);
+        case MatchExpression::LT:
+            return makeComparison(sbe::EPrimBinary::less);
+        case MatchExpression::LTE:
+            return makeComparison(sbe::EPrimBinary::lessEq);
+        case MatchExpression::GT:
+            return makeComparison(sbe::EPrimBinary::greater);
+        case MatchExpression::GTE:
+            return makeComparison(sbe::EPrimBinary::greaterEq);
+        case MatchExpression::MATCH_IN: {
+            auto expr = checked_cast<const InMatchExpression*>(me);
+            if (!expr->getRegexes().empty()) {
+                return nullptr;
+            }
+
+            auto [arrSetTag, arrSetVal, hasArray, hasNull] = convertInExpressionEqualities(expr);
+            sbe::value::ValueGuard arrSetGuard{arrSetTag, arrSetVal};
+            if (hasNull) {
+                return nullptr;
+            }
+
+            std::unique_ptr<sbe::EExpression> equalitiesExpr;
+            if (auto inputParam = expr->getInputParamId()) {
+                equalitiesExpr = makeVariable(state.registerInputParamSlot(*inputParam));
+            } else {
+                arrSetGuard.reset();
+                equalitiesExpr = makeConstant(arrSetTag, arrSetVal);
+            }
+
+            if (isScalar) {
+                return makeIsMember(
+                    std::move(inputExpr), std::move(equalitiesExpr), state.data->env);
+            }
+            return generateTraverseFExpr(
+                state,
+                *expr->fieldRef(),
+                0,
+                std::move(inputExpr),
+                [&](std::unique_ptr<sbe::EExpression> valueExpr) {
+                    return makeIsMember(
+                        std::move(valueExpr), std::move(equalitiesExpr), state.data->env);
+                },
+                hasArray);
+        }
+        default:
+            return nullptr;
+    }
+}
+
+/**
+ * Returns the conjunction of the leaf predicates of 'root', each built by
+ * 'generateColumnLeafFilterExpr()' on the value of 'inputSlot', or nullptr if one of them is not
+ * supported.
+ */
+std::unique_ptr<sbe::EExpression> generateColumnConjunctionExpr(StageBuilderState& state,
+                                                                const MatchExpression* root,
+                                                                sbe::value::SlotId inputSlot,
+                                                                bool isScalar) {
+    // Positional path components need the array index semantics implemented by 'generateFilter()'.
+    auto hasPositionalComponent = [](const FieldRef& path) {
+        for (FieldIndex i = 0; i < path.numParts(); ++i) {
+            if (FieldRef::isNumericPathComponentLenient(path.getPart(i))) {
+                return true;
+            }
+        }
+        return false;
+    };
+
+    std::vector<const MatchExpression*> leaves;
+    if (root->matchType() == MatchExpression::AND) {
+        for (size_t i = 0; i < root->numChildren(); ++i) {
+            leaves.push_back(root->getChild(i));
+        }
+    } else {
+        leaves.push_back(root);
+    }
+
+    std::unique_ptr<sbe::EExpression> result;
+    for (auto leaf : leaves) {
+        if (!leaf->fieldRef() || leaf->fieldRef()->empty() ||
+            hasPositionalComponent(*leaf->fieldRef())) {
+            return nullptr;
+        }
+
+        auto leafExpr =
+            generateColumnLeafFilterExpr(state, leaf, makeVariable(inputSlot), isScalar);
+        if (!leafExpr) {
+            return nullptr;
+        }
+        result = result
+            ? makeBinaryOp(sbe::EPrimBinary::logicAnd, std::move(result), std::move(leafExpr))
+            : std::move(leafExpr);
+    }
+    return result;
+}
 }  // namespace
 
 std::pair<boost::optional<sbe::value::SlotId>, EvalStage> generateFilter(
@@ -2087,6 +2286,18 @@ EvalStage generateIndexFilter(StageBuilderState& state,
     return std::move(resultStage);
 }
 
+std::unique_ptr<sbe::EExpression> generateColumnFilterExpr(StageBuilderState& state,
+                                                           const MatchExpression* root,
+                                                           sbe::value::SlotId inputSlot) {
+    return generateColumnConjunctionExpr(state, root, inputSlot, false /* isScalar */);
+}
+
+std::unique_ptr<sbe::EExpression> generateColumnCellFilterExpr(StageBuilderState& state,
+                                                               const MatchExpression* root,
+                                                               sbe::value::SlotId cellSlot) {
+    return generateColumnConjunctionExpr(state, root, cellSlot, true /* isScalar */);
+}
+
 std::tuple<sbe::value::TypeTags, sbe::value::Value, bool, bool> convertInExpressionEqualities(
     const InMatchExpression* expr) {
     auto& equalities = expr->getEqualities();
@@ -77,6 +77,27 @@ EvalStage generateIndexFilter(StageBuilderState& state,
                               std::vector<std::string> keyFields,
                               PlanNodeId planNodeId);
 
+/**
+ * Generates an expression evaluating the predicate 'root' against the document held in
+ * 'inputSlot', for a predicate on a single path which a column scan evaluates before assembling the
+ * rest of a row. Only comparisons and $in on a non-positional path, or conjunctions of them, are
+ * supported; for anything else nullptr is returned and the caller is expected to fall back to
+ * 'generateFilter()'.
+ */
+std::unique_ptr<sbe::EExpression> generateColumnFilterExpr(StageBuilderState& state,
+                                                           const MatchExpression* root,
+                                                           sbe::value::SlotId inputSlot);
+
+/**
+ * Generates the same predicate as 'generateColumnFilterExpr()', but evaluated against the single
+ * scalar value held in 'cellSlot', which the column scan decodes from a cell of the column store.
+ * On a cell holding one value and no array along the path, it gives the same result as the
+ * predicate on the whole document. Returns nullptr if 'root' is not supported.
+ */
+std::unique_ptr<sbe::EExpression> generateColumnCellFilterExpr(StageBuilderState& state,
+                                                               const MatchExpression* root,
+                                                               sbe::value::SlotId cellSlot);
+
 /**
  * Converts the list of equalities inside the given $in expression ('expr') into an SBE array, which
  * is returned as a (typeTag, value) pair. The caller owns the resulting value.
@@ -1000,6 +1000,10 @@ makeLoopJoinForFetch(std::unique_ptr<sbe::PlanStage> inputStage,
 
 sbe::value::SlotId StageBuilderState::registerInputParamSlot(
     MatchExpression::InputParamId paramId) {
+    if (auto it = data->inputParamToSlotMap.find(paramId); it != data->inputParamToSlotMap.end()) {
+        return it->second;
+    }
+
     auto slotId = data->env->registerSlot(
         sbe::value::TypeTags::Nothing, 0, false /* owned */, slotIdGenerator);
     data->inputParamToSlotMap.emplace(paramId, slotId);
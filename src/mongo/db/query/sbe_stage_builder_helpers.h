@@ -923,7 +923,8 @@ struct StageBuilderState {
      * Register a Slot in the 'RuntimeEnvironment'. The newly registered Slot should be associated
      * with 'paramId' and tracked in the 'InputParamToSlotMap' for auto-parameterization use. The
      * slot is set to 'Nothing' on registration and will be populated with the real value when
-     * preparing the SBE plan for execution.
+     * preparing the SBE plan for execution. If a slot has already been registered for 'paramId',
+     * that slot is returned.
      */
     sbe::value::SlotId registerInputParamSlot(MatchExpression::InputParamId paramId);
 
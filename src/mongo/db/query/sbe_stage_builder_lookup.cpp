@@ -675,6 +675,7 @@ std::pair<SlotId /*matched docs*/, std::unique_ptr<sbe::PlanStage>> buildHashJoi
     std::unique_ptr<sbe::PlanStage> foreignStage,
     SlotId foreignRecordSlot,
     const FieldPath& foreignFieldName,
+    bool allowDiskUse,
     const PlanNodeId nodeId,
     SlotIdGenerator& slotIdGenerator) {
 
@@ -707,6 +708,7 @@ std::pair<SlotId /*matched docs*/, std::unique_ptr<sbe::PlanStage>> buildHashJoi
                                                                 makeSV(foreignRecordSlot),
                                                                 std::move(aggs),
                                                                 boost::none /*collatorSlot*/,
+                                                                allowDiskUse,
                                                                 nodeId);
 
     // Add a projection that makes so that empty array is returned if no foreign row were matched.
@@ -729,6 +731,7 @@ std::pair<SlotId /*matched docs*/, std::unique_ptr<sbe::PlanStage>> buildLookupS
     std::unique_ptr<sbe::PlanStage> foreignStage,
     SlotId foreignRecordSlot,
     const FieldPath& foreignFieldName,
+    bool allowDiskUse,
     const PlanNodeId nodeId,
     SlotIdGenerator& slotIdGenerator) {
     switch (lookupStrategy) {
@@ -748,6 +751,7 @@ std::pair<SlotId /*matched docs*/, std::unique_ptr<sbe::PlanStage>> buildLookupS
                                             std::move(foreignStage),
                                             foreignRecordSlot,
                                             foreignFieldName,
+                                            allowDiskUse,
                                             nodeId,
                                             slotIdGenerator);
         default:
@@ -853,6 +857,7 @@ std::pair<std::unique_ptr<sbe::PlanStage>, PlanStageSlots> SlotBasedStageBuilder
                                         std::move(foreignStage),
                                         foreignResultSlot,
                                         eqLookupNode->joinFieldForeign,
+                                        _cq.getExpCtx()->allowDiskUse,
                                         eqLookupNode->nodeId(),
                                         _slotIdGenerator);
             }
@@ -0,0 +1,559 @@
+/**
+ *    Copyright (C) 2022-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/db/query/solution_skeleton.h"
+
+#include "mongo/db/matcher/expression_always_boolean.h"
+#include "mongo/db/matcher/expression_array.h"
+#include "mongo/db/matcher/expression_geo.h"
+#include "mongo/db/matcher/expression_leaf.h"
+#include "mongo/db/matcher/expression_tree.h"
+#include "mongo/db/matcher/expression_type.h"
+#include "mongo/db/matcher/expression_where_base.h"
+#include "mongo/db/query/canonical_query_encoder.h"
+#include "mongo/db/query/planner_wildcard_helpers.h"
+
+namespace mongo {
+namespace {
+namespace wcp = ::mongo::wildcard_planning;
+using InputParamId = MatchExpression::InputParamId;
+
+/**
+ * Returns false if 'expr' contains a predicate which the parameterized encoding of match
+ * expressions does not support. These predicates are never used by the SBE plan cache.
+ */
+bool canEncodeParameterizedMatch(const MatchExpression* expr) {
+    switch (expr->matchType()) {
+        case MatchExpression::ELEM_MATCH_VALUE:
+        case MatchExpression::INTERNAL_2D_POINT_IN_ANNULUS:
+        case MatchExpression::INTERNAL_BUCKET_GEO_WITHIN:
+        case MatchExpression::INTERNAL_SCHEMA_ALLOWED_PROPERTIES:
+        case MatchExpression::INTERNAL_SCHEMA_ALL_ELEM_MATCH_FROM_INDEX:
+        case MatchExpression::INTERNAL_SCHEMA_BIN_DATA_ENCRYPTED_TYPE:
+        case MatchExpression::INTERNAL_SCHEMA_BIN_DATA_FLE2_ENCRYPTED_TYPE:
+        case MatchExpression::INTERNAL_SCHEMA_BIN_DATA_SUBTYPE:
+        case MatchExpression::INTERNAL_SCHEMA_COND:
+        case MatchExpression::INTERNAL_SCHEMA_EQ:
+        case MatchExpression::INTERNAL_SCHEMA_FMOD:
+        case MatchExpression::INTERNAL_SCHEMA_MATCH_ARRAY_INDEX:
+        case MatchExpression::INTERNAL_SCHEMA_MAX_ITEMS:
+        case MatchExpression::INTERNAL_SCHEMA_MAX_LENGTH:
+        case MatchExpression::INTERNAL_SCHEMA_MAX_PROPERTIES:
+        case MatchExpression::INTERNAL_SCHEMA_MIN_ITEMS:
+        case MatchExpression::INTERNAL_SCHEMA_MIN_LENGTH:
+        case MatchExpression::INTERNAL_SCHEMA_MIN_PROPERTIES:
+        case MatchExpression::INTERNAL_SCHEMA_OBJECT_MATCH:
+        case MatchExpression::INTERNAL_SCHEMA_ROOT_DOC_EQ:
+        case MatchExpression::INTERNAL_SCHEMA_TYPE:
+        case MatchExpression::INTERNAL_SCHEMA_UNIQUE_ITEMS:
+        case MatchExpression::INTERNAL_SCHEMA_XOR:
+            return false;
+        default:
+            break;
+    }
+    for (size_t i = 0; i < expr->numChildren(); ++i) {
+        if (!canEncodeParameterizedMatch(expr->getChild(i))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Returns the $near predicate of 'expr', or nullptr if it has none. A query has at most one.
+ */
+const GeoNearMatchExpression* findGeoNear(const MatchExpression* expr) {
+    if (expr->matchType() == MatchExpression::GEO_NEAR) {
+        return static_cast<const GeoNearMatchExpression*>(expr);
+    }
+    for (size_t i = 0; i < expr->numChildren(); ++i) {
+        if (auto geoNear = findGeoNear(expr->getChild(i))) {
+            return geoNear;
+        }
+    }
+    return nullptr;
+}
+
+void setGeoNearExpression(QuerySolutionNode* node, const GeoNearExpression* nq) {
+    if (node->getType() == STAGE_GEO_NEAR_2D) {
+        static_cast<GeoNear2DNode*>(node)->nq = nq;
+    } else {
+        static_cast<GeoNear2DSphereNode*>(node)->nq = nq;
+    }
+}
+
+/**
+ * The index bounds of a solution node which the access planner builds from the predicates of the
+ * query: the bounds of an index scan, or the base bounds of a geoNear.
+ */
+struct NodeBounds {
+    const IndexEntry* index;
+    IndexBounds* bounds;
+    const std::vector<interval_evaluation_tree::IET>* iets;
+};
+
+boost::optional<NodeBounds> getNodeBounds(QuerySolutionNode* node) {
+    switch (node->getType()) {
+        case STAGE_IXSCAN: {
+            auto ixscan = static_cast<IndexScanNode*>(node);
+            return NodeBounds{&ixscan->index, &ixscan->bounds, &ixscan->iets};
+        }
+        case STAGE_GEO_NEAR_2D: {
+            auto geoNear = static_cast<GeoNear2DNode*>(node);
+            return NodeBounds{&geoNear->index, &geoNear->baseBounds, &geoNear->iets};
+        }
+        case STAGE_GEO_NEAR_2DSPHERE: {
+            auto geoNear = static_cast<GeoNear2DSphereNode*>(node);
+            return NodeBounds{&geoNear->index, &geoNear->baseBounds, &geoNear->iets};
+        }
+        default:
+            return boost::none;
+    }
+}
+
+/**
+ * Returns the ids of the input parameters of 'expr', or an empty vector if 'expr' is not a
+ * parameterized predicate.
+ */
+std::vector<InputParamId> getInputParamIds(const MatchExpression* expr) {
+    std::vector<InputParamId> ids;
+    auto addId = [&](boost::optional<InputParamId> id) {
+        if (id) {
+            ids.push_back(*id);
+        }
+    };
+
+    switch (expr->matchType()) {
+        case MatchExpression::EQ:
+        case MatchExpression::LT:
+        case MatchExpression::LTE:
+        case MatchExpression::GT:
+        case MatchExpression::GTE:
+            addId(static_cast<const ComparisonMatchExpressionBase*>(expr)->getInputParamId());
+            break;
+        case MatchExpression::MATCH_IN:
+            addId(static_cast<const InMatchExpression*>(expr)->getInputParamId());
+            break;
+        case MatchExpression::TYPE_OPERATOR:
+            addId(static_cast<const TypeMatchExpression*>(expr)->getInputParamId());
+            break;
+        case MatchExpression::REGEX: {
+            const auto* regex = static_cast<const RegexMatchExpression*>(expr);
+            addId(regex->getSourceRegexInputParamId());
+            addId(regex->getCompiledRegexInputParamId());
+            break;
+        }
+        case MatchExpression::MOD: {
+            const auto* mod = static_cast<const ModMatchExpression*>(expr);
+            addId(mod->getDivisorInputParamId());
+            addId(mod->getRemainderInputParamId());
+            break;
+        }
+        case MatchExpression::SIZE:
+            addId(static_cast<const SizeMatchExpression*>(expr)->getInputParamId());
+            break;
+        case MatchExpression::BITS_ALL_SET:
+        case MatchExpression::BITS_ALL_CLEAR:
+        case MatchExpression::BITS_ANY_SET:
+        case MatchExpression::BITS_ANY_CLEAR: {
+            const auto* bitTest = static_cast<const BitTestMatchExpression*>(expr);
+            addId(bitTest->getBitPositionsParamId());
+            addId(bitTest->getBitMaskParamId());
+            break;
+        }
+        case MatchExpression::WHERE:
+            addId(static_cast<const WhereMatchExpressionBase*>(expr)->getInputParamId());
+            break;
+        default:
+            break;
+    }
+    return ids;
+}
+
+void collectInputParams(const MatchExpression* expr,
+                        interval_evaluation_tree::InputParamIdMap* inputParams) {
+    for (auto id : getInputParamIds(expr)) {
+        (*inputParams)[id] = expr;
+    }
+    for (size_t i = 0; i < expr->numChildren(); ++i) {
+        collectInputParams(expr->getChild(i), inputParams);
+    }
+}
+
+/**
+ * Calls 'fn' on every node of the solution tree rooted at 'node', in pre-order.
+ */
+template <typename Fn>
+void forEachNode(QuerySolutionNode* node, const Fn& fn) {
+    fn(node);
+    for (auto child : node->children) {
+        forEachNode(child, fn);
+    }
+}
+}  // namespace
+
+std::unique_ptr<SolutionSkeleton> SolutionSkeleton::make(const CanonicalQuery& query,
+                                                         const QuerySolutionNode& accessRoot) {
+    if (!query.isParameterized() || !canEncodeParameterizedMatch(query.root())) {
+        return nullptr;
+    }
+
+    interval_evaluation_tree::InputParamIdMap inputParams;
+    collectInputParams(query.root(), &inputParams);
+
+    std::unique_ptr<SolutionSkeleton> skeleton{
+        new SolutionSkeleton(canonical_query_encoder::encodeParameterizedMatch(query.root()),
+                             std::unique_ptr<QuerySolutionNode>(accessRoot.clone()))};
+
+    bool supported = true;
+    forEachNode(skeleton->_root.get(), [&](QuerySolutionNode* node) {
+        if (!supported) {
+            return;
+        }
+        auto nodeTemplate = makeNodeTemplate(node, inputParams);
+        if (!nodeTemplate) {
+            supported = false;
+            return;
+        }
+        skeleton->_nodes.push_back(std::move(*nodeTemplate));
+    });
+
+    if (!supported) {
+        return nullptr;
+    }
+    return skeleton;
+}
+
+std::unique_ptr<QuerySolutionNode> SolutionSkeleton::bind(const CanonicalQuery& query) const {
+    if (!query.isParameterized() ||
+        canonical_query_encoder::encodeParameterizedMatch(query.root()) != _parameterizedShape) {
+        return nullptr;
+    }
+
+    interval_evaluation_tree::InputParamIdMap inputParams;
+    collectInputParams(query.root(), &inputParams);
+
+    std::unique_ptr<QuerySolutionNode> root{_root->clone()};
+    size_t nodeIndex = 0;
+    bool bound = true;
+    forEachNode(root.get(), [&](QuerySolutionNode* node) {
+        const auto& nodeTemplate = _nodes[nodeIndex++];
+        if (!bound) {
+            return;
+        }
+        if (nodeTemplate.filter) {
+            node->filter = bindFilter(*nodeTemplate.filter, inputParams);
+        }
+        if (node->getType() == STAGE_GEO_NEAR_2D || node->getType() == STAGE_GEO_NEAR_2DSPHERE) {
+            auto geoNear = findGeoNear(query.root());
+            tassert(7132006, "Missing $near predicate", geoNear);
+            setGeoNearExpression(node, &geoNear->getData());
+        }
+        if (node->getType() == STAGE_IXSCAN) {
+            static_cast<IndexScanNode*>(node)->queryCollator = query.getCollator();
+        }
+        if (!nodeTemplate.evaluatedFields.empty()) {
+            bound = bindIndexBounds(nodeTemplate, inputParams, node);
+        }
+    });
+    if (!bound) {
+        return nullptr;
+    }
+
+    // Index intersections and merge sorts are only chosen by the access planner if their children
+    // provide the order they rely on, which depends on whether the bounds of the index scans are
+    // point intervals.
+    root->computeProperties();
+    bool sortsProvided = true;
+    forEachNode(root.get(), [&](QuerySolutionNode* node) {
+        if (node->getType() == STAGE_AND_SORTED) {
+            for (auto child : node->children) {
+                sortsProvided = sortsProvided && child->sortedByDiskLoc();
+            }
+        } else if (node->getType() == STAGE_SORT_MERGE) {
+            const auto& sort = static_cast<MergeSortNode*>(node)->sort;
+            for (auto child : node->children) {
+                sortsProvided = sortsProvided && child->providedSorts().contains(sort);
+            }
+        }
+    });
+    if (!sortsProvided) {
+        return nullptr;
+    }
+    return root;
+}
+
+boost::optional<SolutionSkeleton::NodeTemplate> SolutionSkeleton::makeNodeTemplate(
+    QuerySolutionNode* node, const interval_evaluation_tree::InputParamIdMap& inputParams) {
+    switch (node->getType()) {
+        case STAGE_AND_HASH:
+        case STAGE_AND_SORTED:
+        case STAGE_EOF:
+        case STAGE_FETCH:
+        case STAGE_GEO_NEAR_2D:
+        case STAGE_GEO_NEAR_2DSPHERE:
+        case STAGE_IXSCAN:
+        case STAGE_OR:
+        case STAGE_SORT_MERGE:
+        case STAGE_TEXT_MATCH:
+        case STAGE_TEXT_OR:
+            break;
+        default:
+            return boost::none;
+    }
+
+    NodeTemplate nodeTemplate;
+    if (node->filter) {
+        nodeTemplate.filter = makeFilterTemplate(node->filter.get());
+        if (!nodeTemplate.filter) {
+            return boost::none;
+        }
+        node->filter.reset();
+    }
+
+    switch (node->getType()) {
+        case STAGE_SORT_MERGE: {
+            auto mergeSort = static_cast<MergeSortNode*>(node);
+            mergeSort->sort = mergeSort->sort.getOwned();
+            return nodeTemplate;
+        }
+        case STAGE_TEXT_MATCH:
+            // The index scans of a text plan are built from the terms of the $text predicate,
+            // which is part of the parameterized shape, and from the equality predicates on the
+            // prefix fields of the text index, which hold parameters. Only the former are constant.
+            if (static_cast<TextMatchNode*>(node)->numPrefixFields > 0) {
+                return boost::none;
+            }
+            return nodeTemplate;
+        case STAGE_GEO_NEAR_2D:
+        case STAGE_GEO_NEAR_2DSPHERE:
+            // The $near predicate is part of the parameterized shape, so the node only needs to
+            // refer to the predicate of the query it is bound to.
+            setGeoNearExpression(node, nullptr);
+            break;
+        default:
+            break;
+    }
+
+    auto nodeBounds = getNodeBounds(node);
+    if (!nodeBounds) {
+        return nodeTemplate;
+    }
+    const auto& index = *nodeBounds->index;
+    auto& bounds = *nodeBounds->bounds;
+    const auto& iets = *nodeBounds->iets;
+
+    // The index entry the access planner built the bounds with. $** index scans are planned with
+    // the single field key pattern of the expanded index entry, and their leading '$_path' field
+    // is only added once planning is complete. The bounds of that field only depend on the path
+    // and on whether the scan covers its subpaths.
+    const IndexEntry* planningIndex = &index;
+    size_t numPathFields = 0;
+    if (node->getType() == STAGE_IXSCAN) {
+        auto ixscan = static_cast<IndexScanNode*>(node);
+        ixscan->queryCollator = nullptr;
+        switch (index.type) {
+            case INDEX_BTREE:
+            case INDEX_HASHED:
+                break;
+            case INDEX_TEXT:
+                // See STAGE_TEXT_MATCH above.
+                return nodeTemplate;
+            case INDEX_WILDCARD: {
+                nodeTemplate.wildcardIndex = index;
+                nodeTemplate.wildcardIndex->keyPattern =
+                    std::next(index.keyPattern.begin())->wrap();
+                nodeTemplate.wildcardIndex->multikeyPaths = {index.multikeyPaths.back()};
+                nodeTemplate.wildcardSubpathScan = wcp::isWildcardObjectSubpathScan(ixscan);
+                planningIndex = &*nodeTemplate.wildcardIndex;
+                numPathFields = 1;
+                break;
+            }
+            default:
+                return boost::none;
+        }
+    }
+
+    if (bounds.isSimpleRange || iets.size() + numPathFields != bounds.fields.size() ||
+        static_cast<int>(bounds.fields.size()) != index.keyPattern.nFields()) {
+        return boost::none;
+    }
+
+    // Only use the Interval Evaluation Trees which evaluate to the bounds the access planner built
+    // for the query, such that the skeleton builds the same plan as the access planner.
+    BSONObjIterator keyPatternIt{index.keyPattern};
+    for (size_t i = 0; i < bounds.fields.size(); ++i) {
+        const auto keyElt = keyPatternIt.next();
+        if (i < numPathFields) {
+            nodeTemplate.evaluatedFields.push_back(false);
+            continue;
+        }
+        auto& oil = bounds.fields[i];
+
+        OrderedIntervalList evaluated{oil.name};
+        std::vector<IndexBoundsBuilder::BoundsTightness> tightness;
+        IndexBoundsBuilder::evaluateIntervals(
+            iets[i - numPathFields], inputParams, keyElt, *planningIndex, &evaluated, &tightness);
+        if (keyElt.number() < 0) {
+            evaluated.reverse();
+        }
+
+        const bool isEvaluated = !tightness.empty();
+        if (isEvaluated) {
+            if (!(evaluated == oil)) {
+                return boost::none;
+            }
+            oil.intervals.clear();
+            nodeTemplate.tightness.insert(
+                nodeTemplate.tightness.end(), tightness.begin(), tightness.end());
+        }
+        nodeTemplate.evaluatedFields.push_back(isEvaluated);
+    }
+    return nodeTemplate;
+}
+
+boost::optional<SolutionSkeleton::FilterTemplate> SolutionSkeleton::makeFilterTemplate(
+    const MatchExpression* expr) {
+    FilterTemplate filter;
+    filter.matchType = expr->matchType();
+
+    auto inputParamIds = getInputParamIds(expr);
+    if (!inputParamIds.empty()) {
+        filter.inputParamId = inputParamIds.front();
+        return filter;
+    }
+
+    switch (expr->matchType()) {
+        case MatchExpression::AND:
+        case MatchExpression::OR:
+        case MatchExpression::NOR:
+        case MatchExpression::NOT:
+            for (size_t i = 0; i < expr->numChildren(); ++i) {
+                auto child = makeFilterTemplate(expr->getChild(i));
+                if (!child) {
+                    return boost::none;
+                }
+                filter.children.push_back(std::move(*child));
+            }
+            return filter;
+        case MatchExpression::EXISTS:
+            filter.path = expr->path().toString();
+            return filter;
+        case MatchExpression::ALWAYS_FALSE:
+        case MatchExpression::ALWAYS_TRUE:
+            return filter;
+        default:
+            // Any other predicate holds constants which are not parameters.
+            return boost::none;
+    }
+}
+
+bool SolutionSkeleton::bindIndexBounds(const NodeTemplate& nodeTemplate,
+                                       const interval_evaluation_tree::InputParamIdMap& inputParams,
+                                       QuerySolutionNode* node) {
+    auto nodeBounds = getNodeBounds(node);
+    const auto& index = *nodeBounds->index;
+    auto& bounds = *nodeBounds->bounds;
+    const auto& iets = *nodeBounds->iets;
+    const IndexEntry& planningIndex =
+        nodeTemplate.wildcardIndex ? *nodeTemplate.wildcardIndex : index;
+    const size_t numPathFields = bounds.fields.size() - iets.size();
+
+    std::vector<IndexBoundsBuilder::BoundsTightness> tightness;
+    BSONObjIterator keyPatternIt{index.keyPattern};
+    for (size_t i = 0; i < nodeTemplate.evaluatedFields.size(); ++i) {
+        const auto keyElt = keyPatternIt.next();
+        if (!nodeTemplate.evaluatedFields[i]) {
+            continue;
+        }
+
+        auto& oil = bounds.fields[i];
+        IndexBoundsBuilder::evaluateIntervals(
+            iets[i - numPathFields], inputParams, keyElt, planningIndex, &oil, &tightness);
+        if (keyElt.number() < 0) {
+            oil.reverse();
+        }
+    }
+
+    if (nodeTemplate.wildcardIndex &&
+        wcp::isWildcardObjectSubpathScan(static_cast<IndexScanNode*>(node)) !=
+            nodeTemplate.wildcardSubpathScan) {
+        return false;
+    }
+    return tightness == nodeTemplate.tightness && bounds.isValidFor(index.keyPattern, 1);
+}
+
+std::unique_ptr<MatchExpression> SolutionSkeleton::bindFilter(
+    const FilterTemplate& filter, const interval_evaluation_tree::InputParamIdMap& inputParams) {
+    if (filter.inputParamId) {
+        auto it = inputParams.find(*filter.inputParamId);
+        tassert(7132003,
+                str::stream() << "Missing value for input parameter " << *filter.inputParamId,
+                it != inputParams.end() && it->second->matchType() == filter.matchType);
+        return it->second->shallowClone();
+    }
+
+    auto bindChildren = [&](ListOfMatchExpression* expr) {
+        for (auto&& child : filter.children) {
+            expr->add(bindFilter(child, inputParams));
+        }
+    };
+
+    switch (filter.matchType) {
+        case MatchExpression::AND: {
+            auto expr = std::make_unique<AndMatchExpression>();
+            bindChildren(expr.get());
+            return expr;
+        }
+        case MatchExpression::OR: {
+            auto expr = std::make_unique<OrMatchExpression>();
+            bindChildren(expr.get());
+            return expr;
+        }
+        case MatchExpression::NOR: {
+            auto expr = std::make_unique<NorMatchExpression>();
+            bindChildren(expr.get());
+            return expr;
+        }
+        case MatchExpression::NOT:
+            return std::make_unique<NotMatchExpression>(
+                bindFilter(filter.children[0], inputParams));
+        case MatchExpression::EXISTS:
+            return std::make_unique<ExistsMatchExpression>(filter.path);
+        case MatchExpression::ALWAYS_FALSE:
+            return std::make_unique<AlwaysFalseMatchExpression>();
+        case MatchExpression::ALWAYS_TRUE:
+            return std::make_unique<AlwaysTrueMatchExpression>();
+        default:
+            MONGO_UNREACHABLE_TASSERT(7132004);
+    }
+}
+
+}  // namespace mongo
@@ -0,0 +1,141 @@
+/**
+ *    Copyright (C) 2022-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "mongo/db/query/canonical_query.h"
+#include "mongo/db/query/index_bounds_builder.h"
+#include "mongo/db/query/query_solution.h"
+
+namespace mongo {
+
+/**
+ * A parameterized copy of the data access part of a classic query solution, which is kept in the
+ * classic plan cache next to the index assignments of the solution. A query with the same
+ * parameterized shape as the query the skeleton was built for only differs from it by the values
+ * of its parameters, so its data access plan can be rebuilt from the skeleton without tagging the
+ * query and running access planning:
+ *  - The bounds of the index scans are evaluated from their Interval Evaluation Trees, using the
+ *    parameters of the new query.
+ *  - The filters of the solution nodes are rebuilt around the parameterized predicates of the new
+ *    query.
+ *
+ * The skeleton does not reference any data owned by the query it was built for. Only solutions made
+ * of index scans, fetches, index intersections, $or plans, text plans and geoNear plans are
+ * supported, and only if all the constants in their filters are parameters. Text plans are not
+ * supported over text indexes with prefix fields, as the bounds of their index scans are built from
+ * the values of the equality predicates on these fields.
+ */
+class SolutionSkeleton {
+public:
+    /**
+     * Builds the skeleton of the data access plan 'accessRoot', which was built for the
+     * parameterized query 'query'. Returns nullptr if the plan cannot be parameterized.
+     */
+    static std::unique_ptr<SolutionSkeleton> make(const CanonicalQuery& query,
+                                                  const QuerySolutionNode& accessRoot);
+
+    /**
+     * Rebuilds the data access plan for 'query' from the skeleton. Returns nullptr if 'query' does
+     * not have the same parameterized shape as the query the skeleton was built for, or if the plan
+     * built for the values of its parameters would differ from the cached plan in more than its
+     * index bounds and filters. The caller is expected to plan the query from the cached index
+     * assignments in that case.
+     */
+    std::unique_ptr<QuerySolutionNode> bind(const CanonicalQuery& query) const;
+
+private:
+    /**
+     * A filter of a solution node, in which the parameterized predicates are replaced by the ids of
+     * their parameters.
+     */
+    struct FilterTemplate {
+        MatchExpression::MatchType matchType;
+
+        // Set for the parameterized predicates.
+        boost::optional<MatchExpression::InputParamId> inputParamId;
+
+        // The path of an $exists predicate.
+        std::string path;
+
+        std::vector<FilterTemplate> children;
+    };
+
+    struct NodeTemplate {
+        boost::optional<FilterTemplate> filter;
+
+        // For index scans and geoNear, whether the bounds of each field of the key pattern are
+        // evaluated from the Interval Evaluation Tree of the field. The bounds of the other fields
+        // are constant.
+        std::vector<bool> evaluatedFields;
+
+        // For index scans, the tightness of the bounds of every evaluated predicate, in evaluation
+        // order. The cached plan relies on the bounds having the same tightness for the parameters
+        // of the new query, as the tightness determines which predicates remain in the filters.
+        std::vector<IndexBoundsBuilder::BoundsTightness> tightness;
+
+        // For $** index scans, the expanded index entry the bounds are evaluated with, and whether
+        // the scan covers the subpaths of the queried path. The cached '$_path' bounds are only
+        // valid for parameters which need the same subpaths.
+        boost::optional<IndexEntry> wildcardIndex;
+        bool wildcardSubpathScan = false;
+    };
+
+    SolutionSkeleton(std::string parameterizedShape, std::unique_ptr<QuerySolutionNode> root)
+        : _parameterizedShape{std::move(parameterizedShape)}, _root{std::move(root)} {}
+
+    static boost::optional<NodeTemplate> makeNodeTemplate(
+        QuerySolutionNode* node, const interval_evaluation_tree::InputParamIdMap& inputParams);
+
+    static boost::optional<FilterTemplate> makeFilterTemplate(const MatchExpression* expr);
+
+    static bool bindIndexBounds(const NodeTemplate& nodeTemplate,
+                                const interval_evaluation_tree::InputParamIdMap& inputParams,
+                                QuerySolutionNode* node);
+
+    static std::unique_ptr<MatchExpression> bindFilter(
+        const FilterTemplate& filter, const interval_evaluation_tree::InputParamIdMap& inputParams);
+
+    // The encoding of the match expression of the query the skeleton was built for, with
+    // parameter markers in place of the parameter values.
+    const std::string _parameterizedShape;
+
+    // The data access plan without filters, and without the evaluated bounds of its index scans.
+    const std::unique_ptr<QuerySolutionNode> _root;
+
+    // The filters and bounds information of the nodes of '_root', in pre-order.
+    std::vector<NodeTemplate> _nodes;
+};
+
+}  // namespace mongo
@@ -367,7 +367,7 @@ struct SplitCellView {
                 firstByte = *++firstByteAddr;
             }
 
-            if (Bytes::kFirstArrInfoSize >= firstByte && firstByte <= Bytes::kLastArrInfoSize) {
+            if (Bytes::kFirstArrInfoSize <= firstByte && firstByte <= Bytes::kLastArrInfoSize) {
                 firstByteAddr++;  // Skip size-kind byte.
 
                 // TODO SERVER-63284: This check for the tiny array info case would be more
@@ -421,11 +421,11 @@ struct SplitCellView {
         }
 
         // TODO SERVER-63284: This would be more concisely expressed using the case range syntax.
-        if (Bytes::kTinyIntMin >= byte && byte <= Bytes::kTinyIntMax) {
+        if (Bytes::kTinyIntMin <= byte && byte <= Bytes::kTinyIntMax) {
             return encoder(int32_t(int8_t(byte - TinyNum::kTinyIntZero)));
-        } else if (Bytes::kTinyLongMin >= byte && byte <= Bytes::kTinyLongMax) {
+        } else if (Bytes::kTinyLongMin <= byte && byte <= Bytes::kTinyLongMax) {
             return encoder(int64_t(int8_t(byte - TinyNum::kTinyLongZero)));
-        } else if (Bytes::kStringSizeMin >= byte && byte <= Bytes::kStringSizeMax) {
+        } else if (Bytes::kStringSizeMin <= byte && byte <= Bytes::kStringSizeMax) {
             auto size = size_t(byte - Bytes::kStringSizeMin);
             return encoder(StringData(std::exchange(ptr, ptr + size), size));
         } else {
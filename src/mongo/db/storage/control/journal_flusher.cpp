@@ -34,13 +34,17 @@
 #include "mongo/db/storage/control/journal_flusher.h"
 
 #include "mongo/db/client.h"
+#include "mongo/db/commands/server_status.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/db/storage/recovery_unit.h"
 #include "mongo/db/storage/storage_options.h"
+#include "mongo/db/storage/storage_parameters_gen.h"
 #include "mongo/logv2/log.h"
 #include "mongo/stdx/future.h"
 #include "mongo/util/concurrency/idle_thread_block.h"
 #include "mongo/util/fail_point.h"
+#include "mongo/util/histogram.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 
@@ -51,6 +55,35 @@ const auto getJournalFlusher = ServiceContext::declareDecoration<std::unique_ptr
 MONGO_FAIL_POINT_DEFINE(pauseJournalFlusherBeforeFlush);
 MONGO_FAIL_POINT_DEFINE(pauseJournalFlusherThread);
 
+/**
+ * Reports how many callers the flushing rounds released and how long their flushes took.
+ */
+struct JournalFlusherSSS : ServerStatusSection {
+    JournalFlusherSSS() : ServerStatusSection("journalFlusher") {}
+
+    bool includeByDefault() const override {
+        return true;
+    }
+
+    BSONObj generateSection(OperationContext* opCtx, const BSONElement& configElem) const override {
+        BSONObjBuilder bob;
+        bob.append("rounds", rounds.loadRelaxed());
+        bob.append("waitersReleased", waitersReleased.loadRelaxed());
+        bob.append("totalFlushMicros", totalFlushMicros.loadRelaxed());
+        bob.append("batchDelayMicros", batchDelayMicros.loadRelaxed());
+        appendHistogram(bob, waitersPerRound, "waitersPerRound");
+        appendHistogram(bob, flushLatencyMicros, "flushLatencyMicros");
+        return bob.obj();
+    }
+
+    AtomicWord<long long> rounds{0};
+    AtomicWord<long long> waitersReleased{0};
+    AtomicWord<long long> totalFlushMicros{0};
+    AtomicWord<long long> batchDelayMicros{0};
+    Histogram<int64_t> waitersPerRound{{1, 2, 4, 8, 16, 32, 64, 128}};
+    Histogram<int64_t> flushLatencyMicros{{100, 1000, 10000, 100000, 1000000}};
+} journalFlusherSSS;
+
 }  // namespace
 
 JournalFlusher* JournalFlusher::get(ServiceContext* serviceCtx) {
@@ -94,6 +127,9 @@ void JournalFlusher::run() {
     // Non-replicated writes will not contribute to replication lag and can be safely excluded
     // from Flow Control.
     _uniqueCtx->get()->setShouldParticipateInFlowControl(false);
+
+    // The number of callers waiting on '_currentSharedPromise'.
+    int roundWaiters = 0;
     while (true) {
         pauseJournalFlusherBeforeFlush.pauseWhileSet();
         try {
@@ -111,10 +147,12 @@ void JournalFlusher::run() {
                 _uniqueCtx->get()->setShouldParticipateInFlowControl(false);
             });
 
+            Timer flushTimer;
             _uniqueCtx->get()->recoveryUnit()->waitUntilDurable(_uniqueCtx->get());
 
             // Signal the waiters that a round completed.
             _currentSharedPromise->emplaceValue();
+            _recordRound(roundWaiters, Microseconds(flushTimer.micros()));
         } catch (const AssertionException& e) {
             // Can be caused by killOp.
             if (e.code() == ErrorCodes::Interrupted) {
@@ -161,6 +199,14 @@ void JournalFlusher::run() {
             });
         }
 
+        // While several callers keep requesting flushes, give those about to request one the
+        // chance to join this round rather than wait for the next.
+        if (_flushJournalNow && _batchDelay > Microseconds(0)) {
+            _flushJournalNowCV.wait_for(lk, _batchDelay.toSystemDuration(), [&] {
+                return _needToPause || _shuttingDown;
+            });
+        }
+
         if (_needToPause) {
             _state = States::Paused;
             _stateChangeCV.notify_all();
@@ -189,6 +235,7 @@ void JournalFlusher::run() {
         // Take the next promise as current and reset the next promise.
         _currentSharedPromise =
             std::exchange(_nextSharedPromise, std::make_unique<SharedPromise<void>>());
+        roundWaiters = std::exchange(_nextRoundWaiters, 0);
     }
 }
 
@@ -247,6 +294,28 @@ void JournalFlusher::waitForJournalFlush() {
     }
 }
 
+void JournalFlusher::_recordRound(int waiters, Microseconds flushLatency) {
+    const auto flushMicros = durationCount<Microseconds>(flushLatency);
+    journalFlusherSSS.rounds.fetchAndAddRelaxed(1);
+    journalFlusherSSS.waitersReleased.fetchAndAddRelaxed(waiters);
+    journalFlusherSSS.totalFlushMicros.fetchAndAddRelaxed(flushMicros);
+    journalFlusherSSS.waitersPerRound.increment(waiters);
+    journalFlusherSSS.flushLatencyMicros.increment(flushMicros);
+
+    // Waiting for more callers only pays off while rounds release several of them at once, and
+    // must stay well below the cost of the flush it saves. The delay moves halfway towards its
+    // target every round, so it fades quickly once callers stop overlapping.
+    Microseconds target{0};
+    if (waiters > 1) {
+        target = std::min(Microseconds(flushMicros / 2),
+                          Microseconds(gJournalFlusherMaxBatchDelayMicros.load()));
+    }
+    _batchDelay = Microseconds((durationCount<Microseconds>(_batchDelay) +
+                                durationCount<Microseconds>(target)) /
+                               2);
+    journalFlusherSSS.batchDelayMicros.store(durationCount<Microseconds>(_batchDelay));
+}
+
 void JournalFlusher::interruptJournalFlusherForReplStateChange() {
     stdx::lock_guard<Latch> lk(_opCtxMutex);
     if (_uniqueCtx) {
@@ -262,6 +331,7 @@ void JournalFlusher::_waitForJournalFlushNoRetry() {
             _flushJournalNow = true;
             _flushJournalNowCV.notify_one();
         }
+        ++_nextRoundWaiters;
         return _nextSharedPromise->getFuture();
     }();
     // Throws on error if the flusher round is interrupted or the flusher thread is shutdown.
@@ -32,6 +32,7 @@
 #include "mongo/db/service_context.h"
 #include "mongo/platform/mutex.h"
 #include "mongo/util/background.h"
+#include "mongo/util/duration.h"
 #include "mongo/util/future.h"
 
 namespace mongo {
@@ -47,7 +48,9 @@ class OperationContext;
  *    a great deal of their data across a server crash.
  *  - Asynchronously grouping data flush requests reduces the total number of flushes executed,
  *    reducing i/o load on the system and improving write performance. This thread groups both the
- *    periodic flushes and immediate flush requests from the rest of the system.
+ *    periodic flushes and immediate flush requests from the rest of the system. While several
+ *    callers keep requesting flushes, the thread briefly delays each requested flush so that more
+ *    of them join it (see 'journalFlusherMaxBatchDelayMicros').
  *
  * And incidentally helpful for another reason:
  *  - waitUntilDurable() calls update the replication JournalListener, so more frequent calls may be
@@ -137,6 +140,12 @@ private:
      */
     void _waitForJournalFlushNoRetry();
 
+    /**
+     * Records a completed flushing round, which released 'waiters' callers and took
+     * 'flushLatency', in serverStatus and adapts the delay before the next requested round.
+     */
+    void _recordRound(int waiters, Microseconds flushLatency);
+
     // Serializes setting/resetting _uniqueCtx and marking _uniqueCtx killed.
     mutable Mutex _opCtxMutex = MONGO_MAKE_LATCH("JournalFlusherOpCtxMutex");
 
@@ -162,6 +171,9 @@ private:
     bool _shuttingDown = false;
     Status _shutdownReason = Status::OK();
 
+    // The number of callers waiting on '_nextSharedPromise'.
+    int _nextRoundWaiters = 0;
+
     // New callers get a future from nextSharedPromise. The JournalFlusher thread will swap that to
     // currentSharedPromise at the start of every round of flushing, and reset nextSharedPromise
     // with a new shared promise.
@@ -174,6 +186,10 @@ private:
     // data flushes will only be executed upon explicit request, no longer periodically in addition
     // to upon request.
     bool _disablePeriodicFlushes;
+
+    // How long the thread waits for more callers to join a requested round. Only accessed by the
+    // thread.
+    Microseconds _batchDelay{0};
 };
 
 }  // namespace mongo
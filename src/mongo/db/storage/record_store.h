@@ -112,6 +112,41 @@ public:
      */
     virtual boost::optional<Record> next() = 0;
 
+    /**
+     * Appends up to 'maxRecords' records to 'batch', in the order successive calls to next() would
+     * return them, and returns how many were appended. Returns 0 only once the cursor has reached
+     * EOF; implementations may append fewer than 'maxRecords' records before that.
+     *
+     * The data of the appended records is valid until the next call to any method on this cursor,
+     * the same as for a record returned by next(). If an exception is thrown, the records that
+     * were already appended are valid and have been consumed from the cursor.
+     *
+     * The default implementation calls next() repeatedly and makes each record owned. Storage
+     * engines override it to read a batch of records with less overhead per record.
+     */
+    virtual size_t nextBatch(std::vector<Record>* batch, size_t maxRecords) {
+        size_t appended = 0;
+        while (appended < maxRecords) {
+            auto record = next();
+            if (!record) {
+                break;
+            }
+
+            // The data of a record returned by next() only lives until the cursor moves again.
+            record->data.makeOwned();
+            batch->push_back(std::move(*record));
+            ++appended;
+        }
+        return appended;
+    }
+
+    /**
+     * Hints that the cursor is about to read a long run of records in its direction, such as for a
+     * full collection scan, so that the storage engine may read ahead of it. Only a hint: it does
+     * not change which records the cursor returns. The default implementation does nothing.
+     */
+    virtual void enableReadAhead() {}
+
     //
     // Saving and restoring state
     //
@@ -383,6 +383,74 @@ TEST(RecordStoreTestHarness, RecordIteratorSaveRestore) {
     }
 }
 
+// Read records in batches of varying sizes, saving and restoring the cursor between batches, and
+// check that they come back in the same order as from next() in both directions.
+TEST(RecordStoreTestHarness, RecordIteratorNextBatch) {
+    const auto harnessHelper(newRecordStoreHarnessHelper());
+    unique_ptr<RecordStore> rs(harnessHelper->newRecordStore());
+
+    const int nToInsert = 10;
+    RecordId locs[nToInsert];
+    std::string datas[nToInsert];
+    {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        for (int i = 0; i < nToInsert; i++) {
+            StringBuilder sb;
+            sb << "record " << i;
+            string data = sb.str();
+
+            WriteUnitOfWork uow(opCtx.get());
+            StatusWith<RecordId> res =
+                rs->insertRecord(opCtx.get(), data.c_str(), data.size() + 1, Timestamp());
+            ASSERT_OK(res.getStatus());
+            locs[i] = res.getValue();
+            datas[i] = data;
+            uow.commit();
+        }
+    }
+
+    for (bool forward : {true, false}) {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        auto cursor = rs->getCursor(opCtx.get(), forward);
+
+        // Take the first record from next() to check that batches continue from its position.
+        int nSeen = 0;
+        auto expected = [&](int n) { return forward ? n : nToInsert - 1 - n; };
+        {
+            const auto record = cursor->next();
+            ASSERT(record);
+            ASSERT_EQUALS(locs[expected(nSeen)], record->id);
+            ++nSeen;
+        }
+
+        size_t batchSize = 1;
+        while (nSeen < nToInsert) {
+            std::vector<Record> batch;
+            const size_t nRead = cursor->nextBatch(&batch, batchSize);
+            ASSERT_EQUALS(nRead, batch.size());
+            ASSERT_LTE(nRead, batchSize);
+            ASSERT_GT(nRead, 0U);
+
+            for (auto&& record : batch) {
+                ASSERT_EQUALS(locs[expected(nSeen)], record.id);
+                ASSERT_EQUALS(datas[expected(nSeen)], record.data.data());
+                ++nSeen;
+            }
+
+            ASSERT_LTE(nSeen, nToInsert);
+
+            cursor->save();
+            cursor->restore();
+            batchSize *= 2;
+        }
+
+        std::vector<Record> batch;
+        ASSERT_EQUALS(0U, cursor->nextBatch(&batch, 4));
+        ASSERT(batch.empty());
+        ASSERT(!cursor->next());
+    }
+}
+
 // Insert two records, and iterate a cursor to EOF. Seek the same cursor to the first and ensure
 // that next() returns the second record.
 TEST(RecordStoreTestHarness, SeekAfterEofAndContinue) {
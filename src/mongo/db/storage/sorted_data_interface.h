@@ -276,6 +276,44 @@ public:
         virtual boost::optional<IndexKeyEntry> next(RequestedInfo parts = kKeyAndLoc) = 0;
         virtual boost::optional<KeyStringEntry> nextKeyString() = 0;
 
+        /**
+         * Appends up to 'maxEntries' entries to 'batch', in the order successive calls to next()
+         * or nextKeyString() would return them, and returns how many were appended. Returns 0
+         * only once there is no more data; implementations may append fewer than 'maxEntries'
+         * entries before that.
+         *
+         * If an exception is thrown, the entries that were already appended are valid and the
+         * cursor is positioned on the last of them.
+         */
+        virtual size_t nextBatch(std::vector<IndexKeyEntry>* batch,
+                                 size_t maxEntries,
+                                 RequestedInfo parts = kKeyAndLoc) {
+            size_t appended = 0;
+            while (appended < maxEntries) {
+                auto entry = next(parts);
+                if (!entry) {
+                    break;
+                }
+                entry->key = entry->key.getOwned();
+                batch->push_back(std::move(*entry));
+                ++appended;
+            }
+            return appended;
+        }
+
+        virtual size_t nextKeyStringBatch(std::vector<KeyStringEntry>* batch, size_t maxEntries) {
+            size_t appended = 0;
+            while (appended < maxEntries) {
+                auto entry = nextKeyString();
+                if (!entry) {
+                    break;
+                }
+                batch->push_back(std::move(*entry));
+                ++appended;
+            }
+            return appended;
+        }
+
         //
         // Seeking
         //
@@ -176,6 +176,69 @@ TEST(SortedDataInterface, ExhaustKeyStringCursor) {
     }
 }
 
+// Read the entries after the first one in batches of growing sizes, saving and restoring the cursor
+// between batches, through both nextBatch() and nextKeyStringBatch().
+TEST(SortedDataInterface, ExhaustCursorInBatches) {
+    const auto harnessHelper(newSortedDataInterfaceHarnessHelper());
+    const std::unique_ptr<SortedDataInterface> sorted(
+        harnessHelper->newSortedDataInterface(/*unique=*/false, /*partial=*/false));
+
+    std::vector<KeyString::Value> keyStrings;
+    int nToInsert = 10;
+    for (int i = 0; i < nToInsert; i++) {
+        const ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        {
+            WriteUnitOfWork uow(opCtx.get());
+            BSONObj key = BSON("" << i);
+            RecordId loc(42, i * 2);
+            KeyString::Value ks = makeKeyString(sorted.get(), key, loc);
+            keyStrings.push_back(ks);
+            ASSERT_OK(sorted->insert(opCtx.get(), ks, true));
+            uow.commit();
+        }
+    }
+
+    for (bool keyStringBatches : {false, true}) {
+        const ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        const std::unique_ptr<SortedDataInterface::Cursor> cursor(sorted->newCursor(opCtx.get()));
+        ASSERT_EQ(cursor->seek(makeKeyStringForSeek(sorted.get(), BSONObj(), true, true)),
+                  IndexKeyEntry(BSON("" << 0), RecordId(42, 0)));
+
+        int nSeen = 1;
+        size_t batchSize = 1;
+        while (nSeen < nToInsert) {
+            size_t nRead = 0;
+            if (keyStringBatches) {
+                std::vector<KeyStringEntry> batch;
+                nRead = cursor->nextKeyStringBatch(&batch, batchSize);
+                ASSERT_EQ(nRead, batch.size());
+                for (auto&& entry : batch) {
+                    ASSERT_EQ(entry.keyString, keyStrings.at(nSeen++));
+                }
+            } else {
+                std::vector<IndexKeyEntry> batch;
+                nRead = cursor->nextBatch(&batch, batchSize);
+                ASSERT_EQ(nRead, batch.size());
+                for (auto&& entry : batch) {
+                    ASSERT_EQ(entry, IndexKeyEntry(BSON("" << nSeen), RecordId(42, nSeen * 2)));
+                    ++nSeen;
+                }
+            }
+            ASSERT_GT(nRead, 0U);
+            ASSERT_LTE(nRead, batchSize);
+            ASSERT_LTE(nSeen, nToInsert);
+
+            cursor->save();
+            cursor->restore();
+            batchSize *= 2;
+        }
+
+        std::vector<IndexKeyEntry> batch;
+        ASSERT_EQ(0U, cursor->nextBatch(&batch, 4));
+        ASSERT(!cursor->next());
+    }
+}
+
 // Call advance() on a reverse cursor until it is exhausted.
 // When a cursor positioned at EOF is advanced, it stays at EOF.
 TEST(SortedDataInterface, ExhaustCursorReversed) {
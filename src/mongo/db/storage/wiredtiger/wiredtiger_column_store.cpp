@@ -0,0 +1,660 @@
+/**
+ *    Copyright (C) 2022-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#define MONGO_LOGV2_DEFAULT_COMPONENT ::mongo::logv2::LogComponent::kStorage
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/storage/wiredtiger/wiredtiger_column_store.h"
+
+#include "mongo/base/data_type_endian.h"
+#include "mongo/base/data_view.h"
+#include "mongo/db/concurrency/write_conflict_exception.h"
+#include "mongo/db/global_settings.h"
+#include "mongo/db/repl/repl_settings.h"
+#include "mongo/db/service_context.h"
+#include "mongo/db/stats/resource_consumption_metrics.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_cursor.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_cursor_helpers.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_customization_hooks.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_global_options.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_index.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_prepare_conflict.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_record_store.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_recovery_unit.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
+#include "mongo/logv2/log.h"
+#include "mongo/util/assert_util.h"
+#include "mongo/util/str.h"
+
+namespace mongo {
+namespace {
+// The separator between the path and the RecordId, followed by the 8 bytes of the RecordId.
+constexpr size_t kKeySuffixSize = 1 + sizeof(uint64_t);
+
+// Flipping the sign bit makes the big endian encoding of a signed RecordId sort in numeric order.
+constexpr uint64_t kSignBit = 1ull << 63;
+
+FullCellView decodeCell(const WT_ITEM& key, const WT_ITEM& value) {
+    invariant(key.size >= kKeySuffixSize);
+    const auto keyData = static_cast<const char*>(key.data);
+    const size_t pathSize = key.size - kKeySuffixSize;
+    invariant(keyData[pathSize] == '\0');
+
+    const auto encodedRid = ConstDataView(keyData + pathSize + 1).read<BigEndian<uint64_t>>();
+    return {PathView(keyData, pathSize),
+            RecordId(static_cast<int64_t>(encodedRid ^ kSignBit)),
+            CellView(static_cast<const char*>(value.data), value.size)};
+}
+}  // namespace
+
+void WiredTigerColumnStore::makeKey(std::string& buffer, PathView path, RecordId rid) {
+    invariant(path.find('\0') == std::string::npos);
+
+    buffer.clear();
+    buffer.reserve(path.size() + kKeySuffixSize);
+    buffer.append(path.rawData(), path.size());
+    buffer += '\0';
+    if (rid.isNull())
+        return;
+
+    char encodedRid[sizeof(uint64_t)];
+    DataView(encodedRid).write<BigEndian<uint64_t>>(static_cast<uint64_t>(rid.getLong()) ^
+                                                    kSignBit);
+    buffer.append(encodedRid, sizeof(encodedRid));
+}
+
+// static
+StatusWith<std::string> WiredTigerColumnStore::generateCreateString(
+    const std::string& engineName,
+    const std::string& sysIndexConfig,
+    const std::string& collIndexConfig,
+    const NamespaceString& collectionNamespace,
+    const BSONObj& indexSpec) {
+    str::stream ss;
+
+    // Separate out a prefix and suffix in the default string. User configuration will override
+    // values in the prefix, but not values in the suffix. Every key of a path shares the path as a
+    // prefix, so prefix compression is always enabled.
+    ss << "type=file,internal_page_max=16k,leaf_page_max=16k,";
+    ss << "checksum=on,";
+    ss << "prefix_compression=true,";
+
+    ss << WiredTigerCustomizationHooks::get(getGlobalServiceContext())
+              ->getTableCreateConfig(collectionNamespace.ns());
+    ss << sysIndexConfig << ",";
+    ss << collIndexConfig << ",";
+
+    // Validate configuration object, as for regular indexes.
+    BSONElement storageEngineElement = indexSpec["storageEngine"];
+    if (storageEngineElement.isABSONObj()) {
+        BSONObj storageEngine = storageEngineElement.Obj();
+        StatusWith<std::string> parseStatus =
+            WiredTigerIndex::parseIndexOptions(storageEngine.getObjectField(engineName));
+        if (!parseStatus.isOK()) {
+            return parseStatus;
+        }
+        if (!parseStatus.getValue().empty()) {
+            ss << "," << parseStatus.getValue();
+        }
+    }
+
+    // WARNING: No user-specified config can appear below this line. These options are required
+    // for correct behavior of the server.
+    ss << ",key_format=u";
+    ss << ",value_format=u";
+    ss << ",app_metadata=(formatVersion=1),";
+
+    bool replicatedWrites = getGlobalReplSettings().usingReplSets() ||
+        repl::ReplSettings::shouldRecoverFromOplogAsStandalone();
+    if (WiredTigerUtil::useTableLogging(collectionNamespace, replicatedWrites)) {
+        ss << "log=(enabled=true)";
+    } else {
+        ss << "log=(enabled=false)";
+    }
+
+    LOGV2_DEBUG(7131700, 3, "column store create string", "str"_attr = ss.ss.str());
+    return StatusWith<std::string>(ss);
+}
+
+Status WiredTigerColumnStore::create(OperationContext* opCtx,
+                                     const std::string& uri,
+                                     const std::string& config) {
+    // Don't use the session from the recovery unit: create should not be used in a transaction
+    WiredTigerSession session(WiredTigerRecoveryUnit::get(opCtx)->getSessionCache()->conn());
+    WT_SESSION* s = session.getSession();
+    LOGV2_DEBUG(7131701,
+                1,
+                "create column store uri: {uri} config: {config}",
+                "uri"_attr = uri,
+                "config"_attr = config);
+    return wtRCToStatus(s->create(s, uri.c_str(), config.c_str()), s);
+}
+
+WiredTigerColumnStore::WiredTigerColumnStore(std::string uri, StringData ident)
+    : ColumnStore(ident), _uri(std::move(uri)), _tableId(WiredTigerSession::genTableId()) {}
+
+class WiredTigerColumnStore::WriteCursor final : public ColumnStore::WriteCursor {
+public:
+    WriteCursor(OperationContext* opCtx, const std::string& uri, uint64_t tableId)
+        : _opCtx(opCtx), _curwrap(uri, tableId, true /* allowOverwrite */, opCtx) {
+        _curwrap.assertInActiveTxn();
+    }
+
+    void insert(PathView path, RecordId rid, CellView cell) override {
+        write(path, rid, cell, [&](WT_CURSOR* c) { return wiredTigerCursorInsert(_opCtx, c); });
+    }
+
+    void update(PathView path, RecordId rid, CellView cell) override {
+        write(path, rid, cell, [&](WT_CURSOR* c) { return wiredTigerCursorUpdate(_opCtx, c); });
+    }
+
+    void remove(PathView path, RecordId rid) override {
+        WiredTigerColumnStore::makeKey(_buffer, path, rid);
+        WiredTigerItem keyItem(_buffer.data(), _buffer.size());
+
+        WT_CURSOR* c = _curwrap.get();
+        c->set_key(c, keyItem.Get());
+        int ret = WT_OP_CHECK(wiredTigerCursorRemove(_opCtx, c));
+        if (ret == WT_NOTFOUND) {
+            return;
+        }
+        invariantWTOK(ret, c->session);
+
+        auto& metricsCollector = ResourceConsumption::MetricsCollector::get(_opCtx);
+        metricsCollector.incrementOneIdxEntryWritten(keyItem.size);
+    }
+
+private:
+    template <typename WriteFn>
+    void write(PathView path, RecordId rid, CellView cell, const WriteFn& writeFn) {
+        WiredTigerColumnStore::makeKey(_buffer, path, rid);
+        WiredTigerItem keyItem(_buffer.data(), _buffer.size());
+        WiredTigerItem valueItem(cell.rawData(), cell.size());
+
+        WT_CURSOR* c = _curwrap.get();
+        c->set_key(c, keyItem.Get());
+        c->set_value(c, valueItem.Get());
+        invariantWTOK(WT_OP_CHECK(writeFn(c)), c->session);
+
+        auto& metricsCollector = ResourceConsumption::MetricsCollector::get(_opCtx);
+        metricsCollector.incrementOneIdxEntryWritten(keyItem.size);
+    }
+
+    OperationContext* const _opCtx;
+    WiredTigerCursor _curwrap;
+    std::string _buffer;
+};
+
+std::unique_ptr<ColumnStore::WriteCursor> WiredTigerColumnStore::newWriteCursor(
+    OperationContext* opCtx) {
+    return std::make_unique<WriteCursor>(opCtx, _uri, _tableId);
+}
+
+void WiredTigerColumnStore::insert(OperationContext* opCtx,
+                                   PathView path,
+                                   RecordId rid,
+                                   CellView cell) {
+    WriteCursor(opCtx, _uri, _tableId).insert(path, rid, cell);
+}
+
+void WiredTigerColumnStore::remove(OperationContext* opCtx, PathView path, RecordId rid) {
+    WriteCursor(opCtx, _uri, _tableId).remove(path, rid);
+}
+
+void WiredTigerColumnStore::update(OperationContext* opCtx,
+                                   PathView path,
+                                   RecordId rid,
+                                   CellView cell) {
+    WriteCursor(opCtx, _uri, _tableId).update(path, rid, cell);
+}
+
+/**
+ * A forward cursor over all the cells of the store. The key of the current cell is kept in
+ * '_buffer' so the cursor can be repositioned by restore() after the storage cursor was reset.
+ */
+class WiredTigerColumnStore::Cursor final : public ColumnStore::Cursor {
+public:
+    Cursor(OperationContext* opCtx, const WiredTigerColumnStore& store)
+        : _opCtx(opCtx), _store(store) {
+        _cursor.emplace(_store.uri(), _store.tableId(), false, _opCtx);
+    }
+
+    boost::optional<FullCellView> next() override {
+        if (_eof)
+            return {};
+
+        if (!_lastMoveSkippedKey) {
+            advanceWTCursor();
+        }
+        _lastMoveSkippedKey = false;
+        return updatePosition();
+    }
+
+    boost::optional<FullCellView> seekAtOrPast(PathView path, RecordId rid) override {
+        WiredTigerColumnStore::makeKey(_buffer, path, rid);
+        seekWTCursor();
+        _lastMoveSkippedKey = false;
+        return updatePosition();
+    }
+
+    boost::optional<FullCellView> seekExact(PathView path, RecordId rid) override {
+        // Ensure an active transaction is open.
+        WiredTigerRecoveryUnit::get(_opCtx)->getSession();
+
+        WiredTigerColumnStore::makeKey(_buffer, path, rid);
+        WiredTigerItem searchKey(_buffer.data(), _buffer.size());
+
+        WT_CURSOR* c = _cursor->get();
+        c->set_key(c, searchKey.Get());
+        int ret = wiredTigerPrepareConflictRetry(_opCtx, [&] { return c->search(c); });
+
+        auto& metricsCollector = ResourceConsumption::MetricsCollector::get(_opCtx);
+        metricsCollector.incrementOneCursorSeek();
+
+        _lastMoveSkippedKey = false;
+        if (ret == WT_NOTFOUND) {
+            _eof = true;
+            return {};
+        }
+        invariantWTOK(ret, c->session);
+        _cursorAtEof = false;
+        return updatePosition();
+    }
+
+    void save() override {
+        try {
+            if (_cursor)
+                _cursor->reset();
+        } catch (const WriteConflictException&) {
+            // Ignore since this is only called when we are about to kill our transaction
+            // anyway.
+        }
+
+        // Our saved position is wherever we were when we last called updatePosition().
+    }
+
+    void saveUnpositioned() override {
+        save();
+        _eof = true;
+    }
+
+    void restore() override {
+        if (!_cursor) {
+            _cursor.emplace(_store.uri(), _store.tableId(), false, _opCtx);
+        }
+
+        // Ensure an active session exists, so any restored cursors will bind to it
+        invariant(WiredTigerRecoveryUnit::get(_opCtx)->getSession() == _cursor->getSession());
+
+        if (!_eof) {
+            // If the cell we were positioned on is gone, we are now positioned on the cell that
+            // followed it, which the next call to next() must not skip.
+            _lastMoveSkippedKey = !seekWTCursor();
+        }
+    }
+
+    void detachFromOperationContext() override {
+        _opCtx = nullptr;
+        _cursor = boost::none;
+    }
+
+    void reattachToOperationContext(OperationContext* opCtx) override {
+        _opCtx = opCtx;
+        // _cursor recreated in restore() to avoid risk of WT_ROLLBACK issues.
+    }
+
+private:
+    void advanceWTCursor() {
+        WT_CURSOR* c = _cursor->get();
+        int ret = wiredTigerPrepareConflictRetry(_opCtx, [&] { return c->next(c); });
+        if (ret == WT_NOTFOUND) {
+            _cursorAtEof = true;
+            return;
+        }
+        invariantWTOK(ret, c->session);
+        _cursorAtEof = false;
+    }
+
+    // Seeks to the key in '_buffer'. Returns true on exact match.
+    bool seekWTCursor() {
+        // Ensure an active transaction is open.
+        WiredTigerRecoveryUnit::get(_opCtx)->getSession();
+
+        WT_CURSOR* c = _cursor->get();
+
+        int cmp = -1;
+        WiredTigerItem searchKey(_buffer.data(), _buffer.size());
+        c->set_key(c, searchKey.Get());
+
+        int ret = wiredTigerPrepareConflictRetry(_opCtx, [&] { return c->search_near(c, &cmp); });
+        if (ret == WT_NOTFOUND) {
+            _cursorAtEof = true;
+            return false;
+        }
+        invariantWTOK(ret, c->session);
+
+        auto& metricsCollector = ResourceConsumption::MetricsCollector::get(_opCtx);
+        metricsCollector.incrementOneCursorSeek();
+
+        _cursorAtEof = false;
+        if (cmp == 0) {
+            return true;
+        }
+
+        // Make sure we land on a key after the search key. When ignoring prepare conflicts, the
+        // call to next() may land on a newly-committed prepared entry that still sorts before the
+        // search key, so keep advancing until that is no longer the case. See SERVER-56839.
+        while (!_cursorAtEof && cmp < 0) {
+            advanceWTCursor();
+            if (!_cursorAtEof) {
+                WT_ITEM key;
+                invariantWTOK(c->get_key(c, &key), c->session);
+                cmp = compareKeys(key, searchKey);
+            }
+        }
+        return false;
+    }
+
+    static int compareKeys(const WT_ITEM& lhs, const WT_ITEM& rhs) {
+        return StringData(static_cast<const char*>(lhs.data), lhs.size)
+            .compare(StringData(static_cast<const char*>(rhs.data), rhs.size));
+    }
+
+    // Reads the cell under the storage cursor and remembers its key for restore().
+    boost::optional<FullCellView> updatePosition() {
+        if (_cursorAtEof) {
+            _eof = true;
+            return {};
+        }
+        _eof = false;
+
+        WT_CURSOR* c = _cursor->get();
+        WT_ITEM key;
+        WT_ITEM value;
+        invariantWTOK(c->get_key(c, &key), c->session);
+        invariantWTOK(c->get_value(c, &value), c->session);
+
+        auto& metricsCollector = ResourceConsumption::MetricsCollector::get(_opCtx);
+        metricsCollector.incrementOneIdxEntryRead(key.size);
+
+        _buffer.assign(static_cast<const char*>(key.data), key.size);
+        return decodeCell(key, value);
+    }
+
+    OperationContext* _opCtx;
+    const WiredTigerColumnStore& _store;
+    boost::optional<WiredTigerCursor> _cursor;
+
+    // The key of the current cell, or the key being sought.
+    std::string _buffer;
+
+    bool _cursorAtEof = false;
+    bool _eof = true;
+
+    // For save/restore since next() needs to know if the last seek landed on a new cell.
+    bool _lastMoveSkippedKey = false;
+};
+
+std::unique_ptr<ColumnStore::Cursor> WiredTigerColumnStore::newCursor(
+    OperationContext* opCtx) const {
+    return std::make_unique<Cursor>(opCtx, *this);
+}
+
+/**
+ * Writes cells through a bulk cursor, which requires that they are added in key order: by path
+ * first and RecordId second, as they come out of the sorter during an index build.
+ */
+class WiredTigerColumnStore::BulkBuilder final : public ColumnStore::BulkBuilder {
+public:
+    BulkBuilder(WiredTigerColumnStore* store, OperationContext* opCtx)
+        : _opCtx(opCtx),
+          _session(WiredTigerRecoveryUnit::get(_opCtx)->getSessionCache()->getSession()),
+          _cursor(openBulkCursor(store)) {}
+
+    ~BulkBuilder() {
+        _cursor->close(_cursor);
+    }
+
+    void addCell(PathView path, RecordId rid, CellView cell) override {
+        WiredTigerColumnStore::makeKey(_buffer, path, rid);
+        uassert(7131702,
+                str::stream() << "Cells must be added to a column store in sorted order, path: "
+                              << path << ", RecordId: " << rid,
+                _buffer > _prevKey);
+
+        WiredTigerItem keyItem(_buffer.data(), _buffer.size());
+        WiredTigerItem valueItem(cell.rawData(), cell.size());
+        _cursor->set_key(_cursor, keyItem.Get());
+        _cursor->set_value(_cursor, valueItem.Get());
+        invariantWTOK(wiredTigerCursorInsert(_opCtx, _cursor), _cursor->session);
+
+        auto& metricsCollector = ResourceConsumption::MetricsCollector::get(_opCtx);
+        metricsCollector.incrementOneIdxEntryWritten(keyItem.size);
+
+        std::swap(_buffer, _prevKey);
+    }
+
+private:
+    WT_CURSOR* openBulkCursor(WiredTigerColumnStore* store) {
+        // Open cursors can cause bulk open_cursor to fail with EBUSY.
+        WiredTigerSession* outerSession = WiredTigerRecoveryUnit::get(_opCtx)->getSession();
+        outerSession->closeAllCursors(store->uri());
+
+        // Not using cursor cache since we need to set "bulk". Use a different session to ensure we
+        // don't hijack an existing transaction, and fail quickly rather than wait on a checkpoint.
+        WT_CURSOR* cursor;
+        WT_SESSION* session = _session->getSession();
+        int err = session->open_cursor(
+            session, store->uri().c_str(), nullptr, "bulk,checkpoint_wait=false", &cursor);
+        if (!err)
+            return cursor;
+
+        LOGV2_WARNING(7131703,
+                      "Failed to create WiredTiger bulk cursor, falling back to non-bulk",
+                      "error"_attr = wiredtiger_strerror(err),
+                      "uri"_attr = store->uri());
+
+        invariantWTOK(
+            session->open_cursor(session, store->uri().c_str(), nullptr, nullptr, &cursor),
+            session);
+        return cursor;
+    }
+
+    OperationContext* const _opCtx;
+    UniqueWiredTigerSession const _session;
+    WT_CURSOR* const _cursor;
+
+    std::string _buffer;
+    std::string _prevKey;
+};
+
+std::unique_ptr<ColumnStore::BulkBuilder> WiredTigerColumnStore::makeBulkBuilder(
+    OperationContext* opCtx) {
+    return std::make_unique<BulkBuilder>(this, opCtx);
+}
+
+Status WiredTigerColumnStore::compact(OperationContext* opCtx) {
+    dassert(opCtx->lockState()->isWriteLocked());
+    WiredTigerSessionCache* cache = WiredTigerRecoveryUnit::get(opCtx)->getSessionCache();
+    if (!cache->isEphemeral()) {
+        WT_SESSION* s = WiredTigerRecoveryUnit::get(opCtx)->getSession()->getSession();
+        opCtx->recoveryUnit()->abandonSnapshot();
+        int ret = s->compact(s, uri().c_str(), "timeout=0");
+        if (ret == EBUSY) {
+            return Status(ErrorCodes::Interrupted,
+                          str::stream() << "Compaction interrupted on " << uri().c_str()
+                                        << " due to cache eviction pressure");
+        }
+        invariantWTOK(ret, s);
+    }
+    return Status::OK();
+}
+
+void WiredTigerColumnStore::fullValidate(OperationContext* opCtx,
+                                         int64_t* numKeysOut,
+                                         IndexValidateResults* fullResults) const {
+    if (fullResults && !WiredTigerRecoveryUnit::get(opCtx)->getSessionCache()->isEphemeral()) {
+        int err = WiredTigerUtil::verifyTable(opCtx, _uri, &(fullResults->errors));
+        if (err == EBUSY) {
+            std::string msg = str::stream()
+                << "Could not complete validation of " << _uri << ". "
+                << "This is a transient issue as the collection was actively "
+                   "in use by other operations.";
+
+            LOGV2_WARNING(7131704,
+                          "Could not complete validation. This is a transient issue as "
+                          "the collection was actively in use by other operations",
+                          "uri"_attr = _uri);
+            fullResults->warnings.push_back(msg);
+        } else if (err) {
+            std::string msg = str::stream()
+                << "verify() returned " << wiredtiger_strerror(err) << ". "
+                << "This indicates structural damage. "
+                << "Not examining individual column store entries.";
+            LOGV2_ERROR(7131705,
+                        "verify() returned an error. This indicates structural damage. Not "
+                        "examining individual column store entries.",
+                        "error"_attr = wiredtiger_strerror(err));
+            fullResults->errors.push_back(msg);
+            fullResults->valid = false;
+            return;
+        }
+    }
+
+    auto cursor = newCursor(opCtx);
+    int64_t count = 0;
+    for (auto cell = cursor->seekAtOrPast("", RecordId()); cell; cell = cursor->next()) {
+        count++;
+    }
+    if (numKeysOut) {
+        *numKeysOut = count;
+    }
+}
+
+bool WiredTigerColumnStore::appendCustomStats(OperationContext* opCtx,
+                                              BSONObjBuilder* output,
+                                              double scale) const {
+    dassert(opCtx->lockState()->isReadLocked());
+    {
+        BSONObjBuilder metadata(output->subobjStart("metadata"));
+        Status status = WiredTigerUtil::getApplicationMetadata(opCtx, uri(), &metadata);
+        if (!status.isOK()) {
+            metadata.append("error", "unable to retrieve metadata");
+            metadata.append("code", static_cast<int>(status.code()));
+            metadata.append("reason", status.reason());
+        }
+    }
+    std::string type, sourceURI;
+    WiredTigerUtil::fetchTypeAndSourceURI(opCtx, _uri, &type, &sourceURI);
+    StatusWith<std::string> metadataResult = WiredTigerUtil::getMetadataCreate(opCtx, sourceURI);
+    StringData creationStringName("creationString");
+    if (!metadataResult.isOK()) {
+        BSONObjBuilder creationString(output->subobjStart(creationStringName));
+        creationString.append("error", "unable to retrieve creation config");
+        creationString.append("code", static_cast<int>(metadataResult.getStatus().code()));
+        creationString.append("reason", metadataResult.getStatus().reason());
+    } else {
+        output->append(creationStringName, metadataResult.getValue());
+        // Type can be "lsm" or "file"
+        output->append("type", type);
+    }
+
+    WiredTigerSession* session = WiredTigerRecoveryUnit::get(opCtx)->getSession();
+    WT_SESSION* s = session->getSession();
+    Status status =
+        WiredTigerUtil::exportTableToBSON(s, "statistics:" + uri(), "statistics=(fast)", output);
+    if (!status.isOK()) {
+        output->append("error", "unable to retrieve statistics");
+        output->append("code", static_cast<int>(status.code()));
+        output->append("reason", status.reason());
+    }
+    return true;
+}
+
+long long WiredTigerColumnStore::getSpaceUsedBytes(OperationContext* opCtx) const {
+    dassert(opCtx->lockState()->isReadLocked());
+    auto ru = WiredTigerRecoveryUnit::get(opCtx);
+    WiredTigerSession* session = ru->getSession();
+
+    if (ru->getSessionCache()->isEphemeral()) {
+        // For ephemeral case, use cursor statistics
+        const auto statsUri = "statistics:" + uri();
+
+        auto getStats = [&](int key) -> int64_t {
+            auto result = WiredTigerUtil::getStatisticsValue(
+                session->getSession(), statsUri, "statistics=(fast)", key);
+            if (!result.isOK()) {
+                if (result.getStatus().code() == ErrorCodes::CursorNotFound)
+                    return 0;  // ident gone, so return 0
+
+                uassertStatusOK(result.getStatus());
+            }
+            return result.getValue();
+        };
+
+        auto inserts = getStats(WT_STAT_DSRC_CURSOR_INSERT);
+        auto removes = getStats(WT_STAT_DSRC_CURSOR_REMOVE);
+        auto insertBytes = getStats(WT_STAT_DSRC_CURSOR_INSERT_BYTES);
+
+        if (inserts == 0 || removes >= inserts)
+            return 0;
+
+        // Rough approximation of the size as average entry size times number of entries.
+        auto bytesPerEntry = (insertBytes + inserts - 1) / inserts;  // round up
+        auto numEntries = inserts - removes;
+        return numEntries * bytesPerEntry;
+    }
+
+    return static_cast<long long>(WiredTigerUtil::getIdentSize(session->getSession(), _uri));
+}
+
+long long WiredTigerColumnStore::getFreeStorageBytes(OperationContext* opCtx) const {
+    dassert(opCtx->lockState()->isReadLocked());
+    auto ru = WiredTigerRecoveryUnit::get(opCtx);
+    WiredTigerSession* session = ru->getSessionNoTxn();
+
+    return static_cast<long long>(WiredTigerUtil::getIdentReuseSize(session->getSession(), _uri));
+}
+
+bool WiredTigerColumnStore::isEmpty(OperationContext* opCtx) {
+    WiredTigerCursor curwrap(_uri, _tableId, false, opCtx);
+    WT_CURSOR* c = curwrap.get();
+    if (!c)
+        return true;
+    int ret = wiredTigerPrepareConflictRetry(opCtx, [&] { return c->next(c); });
+    if (ret == WT_NOTFOUND)
+        return true;
+    invariantWTOK(ret, c->session);
+    return false;
+}
+
+}  // namespace mongo
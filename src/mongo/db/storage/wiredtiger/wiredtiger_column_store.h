@@ -0,0 +1,122 @@
+/**
+ *    Copyright (C) 2022-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include <wiredtiger.h>
+
+#include "mongo/base/status_with.h"
+#include "mongo/db/namespace_string.h"
+#include "mongo/db/storage/column_store.h"
+
+namespace mongo {
+
+/**
+ * A ColumnStore backed by a WiredTiger table. Each cell is stored under a key made of its path,
+ * a NUL separator and the RecordId encoded so that keys sort by path first and RecordId second.
+ * Since paths never contain a NUL byte, all cells of a path are adjacent in the table and a path
+ * can be scanned in RecordId order. Only RecordIds in the KeyFormat::Long format are supported.
+ */
+class WiredTigerColumnStore final : public ColumnStore {
+public:
+    /**
+     * Creates a configuration string suitable for 'config' parameter in WT_SESSION::create(). The
+     * user configuration is taken from the 'storageEngine' field of 'indexSpec', as for regular
+     * indexes.
+     */
+    static StatusWith<std::string> generateCreateString(const std::string& engineName,
+                                                        const std::string& sysIndexConfig,
+                                                        const std::string& collIndexConfig,
+                                                        const NamespaceString& collectionNamespace,
+                                                        const BSONObj& indexSpec);
+
+    /**
+     * Creates a WiredTiger table suitable for implementing a column store. 'config' should be
+     * created with generateCreateString().
+     */
+    static Status create(OperationContext* opCtx,
+                         const std::string& uri,
+                         const std::string& config);
+
+    /**
+     * Appends the key of the cell for 'path' and 'rid' to 'buffer', after clearing it. A null
+     * 'rid' produces a key which sorts before the keys of all the cells of 'path'.
+     */
+    static void makeKey(std::string& buffer, PathView path, RecordId rid);
+
+    WiredTigerColumnStore(std::string uri, StringData ident);
+
+    //
+    // CRUD
+    //
+    std::unique_ptr<ColumnStore::WriteCursor> newWriteCursor(OperationContext* opCtx) override;
+    void insert(OperationContext* opCtx, PathView path, RecordId rid, CellView cell) override;
+    void remove(OperationContext* opCtx, PathView path, RecordId rid) override;
+    void update(OperationContext* opCtx, PathView path, RecordId rid, CellView cell) override;
+    std::unique_ptr<ColumnStore::Cursor> newCursor(OperationContext* opCtx) const override;
+    using ColumnStore::newCursor;
+
+    std::unique_ptr<ColumnStore::BulkBuilder> makeBulkBuilder(OperationContext* opCtx) override;
+
+    //
+    // Whole ColumnStore ops
+    //
+    Status compact(OperationContext* opCtx) override;
+    void fullValidate(OperationContext* opCtx,
+                      int64_t* numKeysOut,
+                      IndexValidateResults* fullResults) const override;
+
+    bool appendCustomStats(OperationContext* opCtx,
+                           BSONObjBuilder* output,
+                           double scale) const override;
+
+    long long getSpaceUsedBytes(OperationContext* opCtx) const override;
+    long long getFreeStorageBytes(OperationContext* opCtx) const override;
+
+    bool isEmpty(OperationContext* opCtx) override;
+
+    const std::string& uri() const {
+        return _uri;
+    }
+
+    uint64_t tableId() const {
+        return _tableId;
+    }
+
+    class WriteCursor;
+    class Cursor;
+    class BulkBuilder;
+
+private:
+    const std::string _uri;
+    const uint64_t _tableId;
+};
+
+}  // namespace mongo
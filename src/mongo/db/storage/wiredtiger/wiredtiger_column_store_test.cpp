@@ -0,0 +1,228 @@
+/**
+ *    Copyright (C) 2022-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/storage/wiredtiger/wiredtiger_column_store.h"
+
+#include <memory>
+
+#include "mongo/db/concurrency/locker_noop.h"
+#include "mongo/db/repl/repl_settings.h"
+#include "mongo/db/repl/replication_coordinator_mock.h"
+#include "mongo/db/service_context_test_fixture.h"
+#include "mongo/db/storage/write_unit_of_work.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_kv_engine.h"
+#include "mongo/unittest/temp_dir.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/clock_source_mock.h"
+
+namespace mongo {
+namespace {
+
+class WiredTigerColumnStoreTest : public ServiceContextTest {
+public:
+    WiredTigerColumnStoreTest()
+        : _dbpath("wt-column-store"),
+          _engine(kWiredTigerEngineName,  // .canonicalName
+                  _dbpath.path(),         // .path
+                  &_cs,                   // .cs
+                  "",                     // .extraOpenOptions
+                  1,                      // .cacheSizeMB
+                  0,                      // .maxCacheOverflowFileSizeMB
+                  false,                  // .durable
+                  false,                  // .ephemeral
+                  false,                  // .repair
+                  false                   // .readOnly
+          ) {
+        repl::ReplicationCoordinator::set(
+            getServiceContext(),
+            std::make_unique<repl::ReplicationCoordinatorMock>(getServiceContext(),
+                                                               repl::ReplSettings()));
+        _engine.notifyStartupComplete();
+
+        _opCtx = makeOperationContext();
+        _opCtx->setRecoveryUnit(std::unique_ptr<RecoveryUnit>(_engine.newRecoveryUnit()),
+                                WriteUnitOfWork::RecoveryUnitState::kNotInUnitOfWork);
+        _opCtx->swapLockState(std::make_unique<LockerNoop>(), WithLock::withoutLock());
+
+        const NamespaceString nss("test.column_store");
+        auto config = WiredTigerColumnStore::generateCreateString(
+            kWiredTigerEngineName, "", "", nss, BSON("key" << BSON("$**"
+                                                                  << "columnstore")));
+        ASSERT_OK(config.getStatus());
+
+        const std::string ident = "column-store-1234";
+        const std::string uri = WiredTigerKVEngine::kTableUriPrefix + ident;
+        ASSERT_OK(WiredTigerColumnStore::create(opCtx(), uri, config.getValue()));
+        _store = std::make_unique<WiredTigerColumnStore>(uri, ident);
+    }
+
+protected:
+    OperationContext* opCtx() {
+        return _opCtx.get();
+    }
+
+    void insert(std::vector<std::tuple<PathView, int64_t, CellView>> cells) {
+        WriteUnitOfWork wuow(opCtx());
+        auto cursor = _store->newWriteCursor(opCtx());
+        for (auto&& [path, rid, cell] : cells) {
+            cursor->insert(path, RecordId(rid), cell);
+        }
+        wuow.commit();
+    }
+
+    // Returns all the cells of the store as (path, rid, value) triples.
+    std::vector<std::tuple<std::string, int64_t, std::string>> scanAll() {
+        std::vector<std::tuple<std::string, int64_t, std::string>> out;
+        auto cursor = _store->newCursor(opCtx());
+        for (auto cell = cursor->seekAtOrPast("", RecordId()); cell; cell = cursor->next()) {
+            out.emplace_back(cell->path.toString(), cell->rid.getLong(), cell->value.toString());
+        }
+        return out;
+    }
+
+    unittest::TempDir _dbpath;
+    ClockSourceMock _cs;
+    WiredTigerKVEngine _engine;
+    ServiceContext::UniqueOperationContext _opCtx;
+    std::unique_ptr<WiredTigerColumnStore> _store;
+};
+
+using Cells = std::vector<std::tuple<std::string, int64_t, std::string>>;
+
+TEST_F(WiredTigerColumnStoreTest, InsertUpdateRemove) {
+    ASSERT_TRUE(_store->isEmpty(opCtx()));
+
+    insert({{"a", 1, "x"}, {"a", 2, "y"}, {"b", 1, "z"}});
+    ASSERT_FALSE(_store->isEmpty(opCtx()));
+    ASSERT_EQ(3, _store->numEntries(opCtx()));
+
+    {
+        WriteUnitOfWork wuow(opCtx());
+        _store->update(opCtx(), "a", RecordId(2), "updated");
+        _store->remove(opCtx(), "b", RecordId(1));
+        // Removing a missing cell is a no-op.
+        _store->remove(opCtx(), "b", RecordId(2));
+        wuow.commit();
+    }
+
+    ASSERT(scanAll() == Cells({{"a", 1, "x"}, {"a", 2, "updated"}}));
+}
+
+TEST_F(WiredTigerColumnStoreTest, CellsAreOrderedByPathThenRecordId) {
+    // Negative RecordIds and RecordIds with different byte lengths must sort numerically, and a
+    // path must sort before its extensions.
+    insert({{"a.b", 3, "1"},
+            {"a", 256, "2"},
+            {"a", -5, "3"},
+            {"a", 1, "4"},
+            {ColumnStore::kRowIdPath, 7, ""},
+            {"a.b", 1, "5"}});
+
+    ASSERT(scanAll() ==
+           Cells({{"a", -5, "3"},
+                  {"a", 1, "4"},
+                  {"a", 256, "2"},
+                  {"a.b", 1, "5"},
+                  {"a.b", 3, "1"},
+                  {ColumnStore::kRowIdPath.toString(), 7, ""}}));
+
+    ASSERT(_store->uniquePaths(opCtx()) ==
+           std::vector<PathValue>({"a", "a.b", ColumnStore::kRowIdPath.toString()}));
+    ASSERT_TRUE(_store->haveAnyWithPath(opCtx(), "a.b"));
+    ASSERT_FALSE(_store->haveAnyWithPath(opCtx(), "a.c"));
+}
+
+TEST_F(WiredTigerColumnStoreTest, CursorForPathSeeks) {
+    insert({{"a", 1, "1"}, {"a", 3, "3"}, {"a", 5, "5"}, {"b", 2, "2"}});
+
+    auto cursor = _store->newCursor(opCtx(), "a");
+    auto cell = cursor->seekAtOrPast(RecordId(2));
+    ASSERT(cell);
+    ASSERT_EQ(RecordId(3), cell->rid);
+    ASSERT_EQ("3", cell->value);
+
+    cell = cursor->next();
+    ASSERT(cell);
+    ASSERT_EQ(RecordId(5), cell->rid);
+
+    // The cursor stops at the end of the path.
+    ASSERT_FALSE(cursor->next());
+    ASSERT_FALSE(cursor->seekAtOrPast(RecordId(6)));
+
+    ASSERT_FALSE(cursor->seekExact(RecordId(2)));
+    cell = cursor->seekExact(RecordId(1));
+    ASSERT(cell);
+    ASSERT_EQ("1", cell->value);
+}
+
+TEST_F(WiredTigerColumnStoreTest, CursorRestoresAfterCurrentCellIsRemoved) {
+    insert({{"a", 1, "1"}, {"a", 2, "2"}, {"a", 3, "3"}});
+
+    auto cursor = _store->newCursor(opCtx(), "a");
+    auto cell = cursor->seekExact(RecordId(2));
+    ASSERT(cell);
+
+    cursor->save();
+    {
+        WriteUnitOfWork wuow(opCtx());
+        _store->remove(opCtx(), "a", RecordId(2));
+        wuow.commit();
+    }
+    cursor->restore();
+
+    // The cell following the removed one must not be skipped.
+    cell = cursor->next();
+    ASSERT(cell);
+    ASSERT_EQ(RecordId(3), cell->rid);
+    ASSERT_FALSE(cursor->next());
+}
+
+TEST_F(WiredTigerColumnStoreTest, BulkBuilder) {
+    {
+        auto builder = _store->makeBulkBuilder(opCtx());
+        builder->addCell("a", RecordId(1), "1");
+        builder->addCell("a", RecordId(2), "2");
+        builder->addCell("b", RecordId(1), "3");
+    }
+
+    ASSERT(scanAll() == Cells({{"a", 1, "1"}, {"a", 2, "2"}, {"b", 1, "3"}}));
+}
+
+TEST_F(WiredTigerColumnStoreTest, BulkBuilderRejectsUnsortedCells) {
+    auto builder = _store->makeBulkBuilder(opCtx());
+    builder->addCell("b", RecordId(1), "1");
+    ASSERT_THROWS_CODE(builder->addCell("a", RecordId(2), "2"), DBException, 7131702);
+    ASSERT_THROWS_CODE(builder->addCell("b", RecordId(1), "1"), DBException, 7131702);
+}
+
+}  // namespace
+}  // namespace mongo
@@ -961,6 +961,16 @@ public:
         return getKeyStringEntry();
     }
 
+    size_t nextBatch(std::vector<IndexKeyEntry>* batch,
+                     size_t maxEntries,
+                     RequestedInfo parts) override {
+        return advanceBatch(maxEntries, [&] { batch->push_back(*curr(parts)); });
+    }
+
+    size_t nextKeyStringBatch(std::vector<KeyStringEntry>* batch, size_t maxEntries) override {
+        return advanceBatch(maxEntries, [&] { batch->push_back(getKeyStringEntry()); });
+    }
+
     void setEndPosition(const BSONObj& key, bool inclusive) override {
         LOGV2_TRACE_CURSOR(20098,
                            "setEndPosition inclusive: {inclusive} {key}",
@@ -1308,6 +1318,51 @@ protected:
         return true;
     }
 
+    /**
+     * Advances the cursor up to 'maxEntries' times, calling 'appendCurrent' at every position, and
+     * returns how many positions were appended. The whole batch is read under a single prepare
+     * conflict retry loop, which resumes after the last key read successfully.
+     */
+    template <typename AppendCurrent>
+    size_t advanceBatch(size_t maxEntries, AppendCurrent&& appendCurrent) {
+        if (_eof) {
+            return 0;
+        }
+
+        // Ensure an active transaction is open.
+        WiredTigerRecoveryUnit::get(_opCtx)->getSession();
+
+        WT_CURSOR* c = _cursor->get();
+        size_t appended = 0;
+        int ret = wiredTigerPrepareConflictRetry(_opCtx, [&] {
+            while (appended < maxEntries) {
+                if (!_lastMoveSkippedKey) {
+                    int advanceRet = _forward ? c->next(c) : c->prev(c);
+                    if (advanceRet != 0) {
+                        return advanceRet;
+                    }
+                }
+
+                _cursorAtEof = false;
+                updatePosition(true);
+                if (_eof) {
+                    break;
+                }
+
+                appendCurrent();
+                ++appended;
+            }
+            return 0;
+        });
+        if (ret == WT_NOTFOUND) {
+            _cursorAtEof = true;
+            updatePosition(true);
+        } else {
+            invariantWTOK(ret, c->session);
+        }
+        return appended;
+    }
+
     KeyStringEntry getKeyStringEntry() {
         // Most keys will have a RecordId appended to the end, with the exception of the _id index
         // and timestamp unsafe unique indexes. The contract of this function is to always return a
@@ -516,6 +516,17 @@ WiredTigerKVEngine::WiredTigerKVEngine(const std::string& canonicalName,
     _sessionSweeper = std::make_unique<WiredTigerSessionSweeper>(_sessionCache.get());
     _sessionSweeper->go();
 
+    // An in-memory engine has no pages to read from disk.
+    if (!_ephemeral && gWiredTigerReadAheadThreads > 0) {
+        ThreadPool::Options options;
+        options.poolName = "WTReadAhead";
+        options.threadNamePrefix = "WTReadAhead-";
+        options.minThreads = 0;
+        options.maxThreads = gWiredTigerReadAheadThreads;
+        _readAheadPool = std::make_unique<ThreadPool>(options);
+        _readAheadPool->startup();
+    }
+
     // Until the Replication layer installs a real callback, prevent truncating the oplog.
     setOldestActiveTransactionTimestampCallback(
         [](Timestamp) { return StatusWith(boost::make_optional(Timestamp::min())); });
@@ -727,6 +738,12 @@ void WiredTigerKVEngine::cleanShutdown() {
         _sessionSweeper->shutdown();
         LOGV2(22319, "Finished shutting down session sweeper thread");
     }
+    if (_readAheadPool) {
+        // Read-ahead tasks use their own sessions on the connection, so they must finish before it
+        // is closed.
+        _readAheadPool->shutdown();
+        _readAheadPool->join();
+    }
     LOGV2_FOR_RECOVERY(23988,
                        2,
                        "Shutdown timestamps.",
@@ -47,6 +47,7 @@
 #include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
 #include "mongo/platform/mutex.h"
+#include "mongo/util/concurrency/thread_pool.h"
 #include "mongo/util/concurrency/with_lock.h"
 #include "mongo/util/elapsed_tracker.h"
 
@@ -311,6 +312,14 @@ public:
         return _oplogManager.get();
     }
 
+    /**
+     * Returns the pool on which record store cursors read ahead of forward scans, or nullptr when
+     * read-ahead is disabled.
+     */
+    ThreadPool* getReadAheadPool() const {
+        return _readAheadPool.get();
+    }
+
     static void appendGlobalStats(BSONObjBuilder& b);
 
     Timestamp getStableTimestamp() const override;
@@ -475,6 +484,7 @@ private:
     const bool _keepDataHistory = true;
 
     std::unique_ptr<WiredTigerSessionSweeper> _sessionSweeper;
+    std::unique_ptr<ThreadPool> _readAheadPool;
 
     std::string _rsOptions;
     std::string _indexOptions;
@@ -0,0 +1,275 @@
+/**
+ *    Copyright (C) 2022-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#define MONGO_LOGV2_DEFAULT_COMPONENT ::mongo::logv2::LogComponent::kStorage
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/storage/wiredtiger/wiredtiger_read_ahead.h"
+
+#include "mongo/db/storage/wiredtiger/wiredtiger_parameters_gen.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
+#include "mongo/logv2/log.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/platform/mutex.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/util/concurrency/with_lock.h"
+#include "mongo/util/scopeguard.h"
+
+namespace mongo {
+
+namespace {
+
+// Read-ahead stops after this many consecutive windows that brought nothing into the cache.
+constexpr int kMaxIdleWindows = 2;
+
+struct ReadAheadStats {
+    AtomicWord<long long> tasksScheduled{0};
+    AtomicWord<long long> bytesReadIntoCache{0};
+    AtomicWord<long long> recordsPrefetched{0};
+    AtomicWord<long long> recordsNotPrefetched{0};
+    AtomicWord<long long> scansBackedOff{0};
+};
+
+ReadAheadStats readAheadStats;
+
+void setKey(WT_CURSOR* c, KeyFormat keyFormat, const RecordId& id, WiredTigerItem* item) {
+    if (keyFormat == KeyFormat::String) {
+        auto str = id.getStr();
+        *item = WiredTigerItem(str.rawData(), str.size());
+        c->set_key(c, item->Get());
+    } else {
+        c->set_key(c, id.getLong());
+    }
+}
+
+RecordId getKey(WT_CURSOR* c, KeyFormat keyFormat) {
+    if (keyFormat == KeyFormat::String) {
+        WT_ITEM item;
+        invariantWTOK(c->get_key(c, &item), c->session);
+        return RecordId(static_cast<const char*>(item.data), item.size);
+    }
+    std::int64_t id;
+    invariantWTOK(c->get_key(c, &id), c->session);
+    return RecordId(id);
+}
+
+/**
+ * Returns the number of bytes read into the cache by the operations of the session 's'.
+ */
+long long bytesReadIntoCache(WT_SESSION* s) {
+    WT_CURSOR* c = nullptr;
+    if (s->open_cursor(s, "statistics:session", nullptr, "statistics=(fast)", &c) != 0) {
+        return 0;
+    }
+    ON_BLOCK_EXIT([&] { c->close(c); });
+
+    c->set_key(c, WT_STAT_SESSION_BYTES_READ);
+    if (c->search(c) != 0) {
+        return 0;
+    }
+    const char* desc;
+    uint64_t value;
+    if (c->get_value(c, &desc, nullptr, &value) != 0) {
+        return 0;
+    }
+    return WiredTigerUtil::castStatisticsValue<long long>(value);
+}
+
+}  // namespace
+
+struct WiredTigerReadAhead::Window {
+    Mutex mutex = MONGO_MAKE_LATCH("WiredTigerReadAhead::Window::mutex");
+
+    // The last record read ahead so far.
+    RecordId end;
+
+    // The number of consecutive windows that brought nothing into the cache.
+    int idleWindows = 0;
+
+    // Set once there is nothing more to read ahead, or no point in doing so.
+    bool done = false;
+
+    AtomicWord<bool> inFlight{false};
+    AtomicWord<bool> cancelled{false};
+
+    // Signalled when the task in flight is done.
+    stdx::condition_variable inFlightCV;
+
+    void setNotInFlight(WithLock) {
+        inFlight.store(false);
+        inFlightCV.notify_all();
+    }
+};
+
+void WiredTigerReadAhead::_readAheadWindow(const std::shared_ptr<Window>& window,
+                                           WT_CONNECTION* conn,
+                                           const std::string& uri,
+                                           KeyFormat keyFormat,
+                                           const RecordId& start,
+                                           size_t windowBytes) {
+    RecordId end;
+    bool exhausted = true;
+    long long bytesRead = 0;
+    {
+        WiredTigerSession session(conn);
+        WT_SESSION* s = session.getSession();
+
+        WT_CURSOR* c = nullptr;
+        // The table may be dropped or busy, in which case there is nothing to read ahead.
+        if (s->open_cursor(s, uri.c_str(), nullptr, nullptr, &c) == 0) {
+            ON_BLOCK_EXIT([&] { c->close(c); });
+
+            WiredTigerItem item(nullptr, 0);
+            setKey(c, keyFormat, start, &item);
+            int exact;
+            int ret = c->search_near(c, &exact);
+            size_t bytes = 0;
+            while (ret == 0 && bytes < windowBytes && !window->cancelled.load()) {
+                // Reading the value brings in overflow items as well as the leaf page.
+                WT_ITEM value;
+                ret = c->get_value(c, &value);
+                if (ret == 0) {
+                    bytes += value.size;
+                    ret = c->next(c);
+                }
+            }
+
+            // Any error, including a prepare conflict, ends the read-ahead of the scan.
+            if (ret == 0) {
+                end = getKey(c, keyFormat);
+                exhausted = false;
+            }
+        }
+        bytesRead = bytesReadIntoCache(s);
+    }
+    readAheadStats.bytesReadIntoCache.fetchAndAdd(bytesRead);
+
+    // The session is closed by now, so the scan may go away once the task is no longer in flight.
+    stdx::lock_guard<Latch> lk(window->mutex);
+    if (end > window->end) {
+        window->end = std::move(end);
+    }
+    window->idleWindows = bytesRead > 0 ? 0 : window->idleWindows + 1;
+    if (window->idleWindows >= kMaxIdleWindows) {
+        readAheadStats.scansBackedOff.addAndFetch(1);
+        window->done = true;
+    }
+    window->done = window->done || exhausted;
+    window->setNotInFlight(lk);
+}
+
+WiredTigerReadAhead::WiredTigerReadAhead(WT_CONNECTION* conn,
+                                         ThreadPool* pool,
+                                         std::string uri,
+                                         KeyFormat keyFormat)
+    : _conn(conn),
+      _pool(pool),
+      _uri(std::move(uri)),
+      _keyFormat(keyFormat),
+      _window(std::make_shared<Window>()) {}
+
+WiredTigerReadAhead::~WiredTigerReadAhead() {
+    _window->cancelled.store(true);
+    {
+        stdx::unique_lock<Latch> lk(_window->mutex);
+        _window->inFlightCV.wait(lk, [&] { return !_window->inFlight.load(); });
+    }
+    readAheadStats.recordsPrefetched.fetchAndAdd(_recordsPrefetched);
+    readAheadStats.recordsNotPrefetched.fetchAndAdd(_recordsNotPrefetched);
+}
+
+void WiredTigerReadAhead::onRead(const RecordId& lastId, size_t nRecords, size_t nBytes) {
+    if (_stopped) {
+        return;
+    }
+
+    if (_started) {
+        if (lastId <= _knownEnd) {
+            _recordsPrefetched += nRecords;
+        } else {
+            _recordsNotPrefetched += nRecords;
+        }
+    }
+
+    _bytesSinceSchedule += nBytes;
+    if (_bytesSinceSchedule < static_cast<size_t>(gWiredTigerReadAheadBytes.load()) / 2 ||
+        _window->inFlight.load()) {
+        return;
+    }
+
+    stdx::lock_guard<Latch> lk(_window->mutex);
+    _knownEnd = _window->end;
+    if (_window->done) {
+        _stopped = true;
+        return;
+    }
+    _schedule(_knownEnd > lastId ? _knownEnd : lastId);
+}
+
+void WiredTigerReadAhead::_schedule(const RecordId& start) {
+    _started = true;
+    _bytesSinceSchedule = 0;
+    _window->inFlight.store(true);
+    readAheadStats.tasksScheduled.addAndFetch(1);
+
+    _pool->schedule([window = _window,
+                     conn = _conn,
+                     uri = _uri,
+                     keyFormat = _keyFormat,
+                     start = start,
+                     windowBytes = static_cast<size_t>(gWiredTigerReadAheadBytes.load())](
+                        Status status) {
+        if (!status.isOK()) {
+            // The pool is shutting down.
+            stdx::lock_guard<Latch> lk(window->mutex);
+            window->done = true;
+            window->setNotInFlight(lk);
+            return;
+        }
+        if (window->cancelled.load()) {
+            stdx::lock_guard<Latch> lk(window->mutex);
+            window->setNotInFlight(lk);
+            return;
+        }
+        _readAheadWindow(window, conn, uri, keyFormat, start, windowBytes);
+    });
+}
+
+void WiredTigerReadAhead::appendStats(BSONObjBuilder* builder) {
+    builder->append("tasks scheduled", readAheadStats.tasksScheduled.load());
+    builder->append("bytes read into cache", readAheadStats.bytesReadIntoCache.load());
+    builder->append("records already prefetched", readAheadStats.recordsPrefetched.load());
+    builder->append("records not yet prefetched", readAheadStats.recordsNotPrefetched.load());
+    builder->append("scans backed off", readAheadStats.scansBackedOff.load());
+}
+
+}  // namespace mongo
@@ -0,0 +1,116 @@
+/**
+ *    Copyright (C) 2022-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include <wiredtiger.h>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/record_id.h"
+#include "mongo/db/storage/key_format.h"
+#include "mongo/util/concurrency/thread_pool.h"
+
+namespace mongo {
+
+/**
+ * Reads ahead of a forward scan over a WiredTiger table, so that the pages the scan is about to
+ * visit are already in the cache when it gets to them. WiredTiger has no interface to prefetch
+ * pages, so a background task walks the records ahead of the scan with a cursor of its own, on a
+ * session of its own.
+ *
+ * The scan reports its progress through onRead(). Once it has consumed half of a read-ahead window
+ * (wiredTigerReadAheadBytes), a task reading the next window is scheduled, so that short scans,
+ * such as those with a limit, never read ahead. The read-ahead stops once its windows stop
+ * bringing pages into the cache, as the table is then cached already.
+ *
+ * Not thread-safe; owned by a single record store cursor.
+ */
+class WiredTigerReadAhead {
+public:
+    WiredTigerReadAhead(WT_CONNECTION* conn,
+                        ThreadPool* pool,
+                        std::string uri,
+                        KeyFormat keyFormat);
+
+    /**
+     * Cancels the task in progress, if any, and waits for it to close its cursor and session, so
+     * that no cursor on the table outlives the scan and makes a drop or compact of the table busy.
+     */
+    ~WiredTigerReadAhead();
+
+    /**
+     * Called after the scan has read 'nRecords' records holding 'nBytes' bytes, the last of which
+     * has the id 'lastId'.
+     */
+    void onRead(const RecordId& lastId, size_t nRecords, size_t nBytes);
+
+    /**
+     * Appends the read-ahead statistics of all scans for serverStatus.
+     */
+    static void appendStats(BSONObjBuilder* builder);
+
+private:
+    struct Window;
+
+    void _schedule(const RecordId& start);
+
+    /**
+     * Walks 'windowBytes' bytes worth of records of the table 'uri', starting at 'start'. Runs on
+     * the read-ahead pool.
+     */
+    static void _readAheadWindow(const std::shared_ptr<Window>& window,
+                                 WT_CONNECTION* conn,
+                                 const std::string& uri,
+                                 KeyFormat keyFormat,
+                                 const RecordId& start,
+                                 size_t windowBytes);
+
+    WT_CONNECTION* const _conn;
+    ThreadPool* const _pool;
+    const std::string _uri;
+    const KeyFormat _keyFormat;
+
+    // Shared with the task reading ahead.
+    const std::shared_ptr<Window> _window;
+
+    // The end of the window read ahead so far, as of the last time it was looked at. Records up to
+    // it are counted as prefetched.
+    RecordId _knownEnd;
+    size_t _bytesSinceSchedule = 0;
+    long long _recordsPrefetched = 0;
+    long long _recordsNotPrefetched = 0;
+    bool _started = false;
+    bool _stopped = false;
+};
+
+}  // namespace mongo
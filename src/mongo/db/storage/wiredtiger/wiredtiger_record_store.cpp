@@ -60,6 +60,7 @@
 #include "mongo/db/storage/wiredtiger/wiredtiger_customization_hooks.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_global_options.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_kv_engine.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_parameters_gen.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_prepare_conflict.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_record_store_oplog_stones.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_recovery_unit.h"
@@ -90,6 +91,10 @@ struct RecordIdAndWall {
     RecordIdAndWall(RecordId lastRecord, Date_t wallTime) : id(lastRecord), wall(wallTime) {}
 };
 
+// Once a batch read by WiredTigerRecordStoreCursorBase::nextBatch() holds this many bytes, the
+// batch ends early rather than growing towards the requested number of records.
+const size_t kMaxBatchBytes = 4 * 1024 * 1024;
+
 WiredTigerRecordStore::CursorKey makeCursorKey(const RecordId& rid, KeyFormat format) {
     if (format == KeyFormat::Long) {
         return rid.getLong();
@@ -1161,8 +1166,7 @@ void WiredTigerRecordStore::deleteRecord(OperationContext* opCtx, const RecordId
     auto keyLength = computeRecordIdSize(id);
     metricsCollector.incrementOneDocWritten(old_length + keyLength);
 
-    _changeNumRecords(opCtx, -1);
-    _increaseDataSize(opCtx, -old_length);
+    _changeNumRecordsAndDataSize(opCtx, -1, -old_length);
 }
 
 Timestamp WiredTigerRecordStore::getPinnedOplog() const {
@@ -1287,8 +1291,7 @@ void WiredTigerRecordStore::reclaimOplog(OperationContext* opCtx, Timestamp mayT
             invariantWTOK(cursor->reset(cursor), cursor->session);
             setKey(cursor, &truncateUpToKey);
             invariantWTOK(session->truncate(session, nullptr, nullptr, cursor, nullptr), session);
-            _changeNumRecords(opCtx, -stone->records);
-            _increaseDataSize(opCtx, -stone->bytes);
+            _changeNumRecordsAndDataSize(opCtx, -stone->records, -stone->bytes);
 
             wuow.commit();
 
@@ -1344,7 +1347,18 @@ Status WiredTigerRecordStore::_insertRecords(OperationContext* opCtx,
 
     if (_keyFormat == KeyFormat::Long) {
         // Non-clustered record stores will extract the RecordId key for the oplog and generate
-        // unique int64_t RecordIds if RecordIds are not set.
+        // unique int64_t RecordIds if RecordIds are not set. The generated RecordIds are reserved
+        // for the whole batch at once.
+        int64_t nextId = 0;
+        if (!_isOplog) {
+            auto nIdsNeeded = std::count_if(records, records + nRecords, [](const Record& record) {
+                return record.id.isNull();
+            });
+            if (nIdsNeeded > 0) {
+                nextId = _reserveIds(opCtx, nIdsNeeded).getLong();
+            }
+        }
+
         for (size_t i = 0; i < nRecords; i++) {
             auto& record = records[i];
             if (_isOplog) {
@@ -1357,7 +1371,7 @@ Status WiredTigerRecordStore::_insertRecords(OperationContext* opCtx,
                 // Some RecordStores, like TemporaryRecordStores, may want to set their own
                 // RecordIds.
                 if (record.id.isNull()) {
-                    record.id = _nextId(opCtx);
+                    record.id = RecordId(nextId++);
                 }
             }
             dassert(record.id > highestIdRecord.id);
@@ -1428,8 +1442,7 @@ Status WiredTigerRecordStore::_insertRecords(OperationContext* opCtx,
         }
     }
 
-    _changeNumRecords(opCtx, nRecords);
-    _increaseDataSize(opCtx, totalLength);
+    _changeNumRecordsAndDataSize(opCtx, nRecords, totalLength);
 
     if (_oplogStones) {
         _oplogStones->updateCurrentStoneAfterInsertOnCommit(
@@ -1745,8 +1758,7 @@ Status WiredTigerRecordStore::truncate(OperationContext* opCtx) {
     WT_SESSION* session = WiredTigerRecoveryUnit::get(opCtx)->getSession()->getSession();
     invariantWTOK(WT_OP_CHECK(session->truncate(session, nullptr, start, nullptr, nullptr)),
                   session);
-    _changeNumRecords(opCtx, -numRecords(opCtx));
-    _increaseDataSize(opCtx, -dataSize(opCtx));
+    _changeNumRecordsAndDataSize(opCtx, -numRecords(opCtx), -dataSize(opCtx));
 
     if (_oplogStones) {
         _oplogStones->clearStonesOnCommit(opCtx);
@@ -1966,18 +1978,22 @@ void WiredTigerRecordStore::_initNextIdIfNeeded(OperationContext* opCtx) {
     _nextIdNum.store(nextId);
 }
 
-RecordId WiredTigerRecordStore::_nextId(OperationContext* opCtx) {
+RecordId WiredTigerRecordStore::_reserveIds(OperationContext* opCtx, int64_t nIds) {
     // Clustered record stores do not generate unique ObjectId's for RecordId's as the expectation
     // is for the caller to set the RecordId using the server generated ObjectId.
     invariant(_keyFormat == KeyFormat::Long);
     invariant(!_isOplog);
+    invariant(nIds > 0);
     _initNextIdIfNeeded(opCtx);
-    RecordId out = RecordId(_nextIdNum.fetchAndAdd(1));
+    RecordId out = RecordId(_nextIdNum.fetchAndAdd(nIds));
     invariant(out.isValid());
+    invariant(RecordId(out.getLong() + nIds - 1).isValid());
     return out;
 }
 
-void WiredTigerRecordStore::_changeNumRecords(OperationContext* opCtx, int64_t diff) {
+void WiredTigerRecordStore::_changeNumRecordsAndDataSize(OperationContext* opCtx,
+                                                         int64_t numRecordsDiff,
+                                                         int64_t dataSizeDiff) {
     if (!_tracksSizeAdjustments) {
         return;
     }
@@ -1986,12 +2002,20 @@ void WiredTigerRecordStore::_changeNumRecords(OperationContext* opCtx, int64_t d
         return;
     }
 
-    opCtx->recoveryUnit()->onRollback([this, diff]() {
-        LOGV2_DEBUG(
-            22404, 3, "WiredTigerRecordStore: rolling back NumRecordsChange", "diff"_attr = -diff);
-        _sizeInfo->numRecords.addAndFetch(-diff);
+    // A single change covers both counters, so that a batch of writes registers one rollback
+    // handler for them rather than one for each.
+    opCtx->recoveryUnit()->onRollback([this, numRecordsDiff, dataSizeDiff]() {
+        LOGV2_DEBUG(22404,
+                    3,
+                    "WiredTigerRecordStore: rolling back NumRecordsChange",
+                    "diff"_attr = -numRecordsDiff);
+        _sizeInfo->numRecords.addAndFetch(-numRecordsDiff);
+        _increaseDataSize(nullptr, -dataSizeDiff);
     });
-    _sizeInfo->numRecords.addAndFetch(diff);
+    _sizeInfo->numRecords.addAndFetch(numRecordsDiff);
+
+    // The handler above also rolls back the data size, so none is registered for it here.
+    _increaseDataSize(nullptr, dataSizeDiff);
 }
 
 void WiredTigerRecordStore::_increaseDataSize(OperationContext* opCtx, int64_t amount) {
@@ -2095,8 +2119,7 @@ void WiredTigerRecordStore::cappedTruncateAfter(OperationContext* opCtx,
     WT_SESSION* session = WiredTigerRecoveryUnit::get(opCtx)->getSession()->getSession();
     invariantWTOK(session->truncate(session, nullptr, start, nullptr, nullptr), session);
 
-    _changeNumRecords(opCtx, -recordsRemoved);
-    _increaseDataSize(opCtx, -bytesRemoved);
+    _changeNumRecordsAndDataSize(opCtx, -recordsRemoved, -bytesRemoved);
 
     wuow.commit();
 
@@ -2246,10 +2269,108 @@ boost::optional<Record> WiredTigerRecordStoreCursorBase::next() {
     auto keyLength = computeRecordIdSize(id);
     metricsCollector.incrementOneDocRead(value.size + keyLength);
 
+    if (_readAhead) {
+        _readAhead->onRead(id, 1, value.size);
+    }
+
     _lastReturnedId = id;
     return {{std::move(id), {static_cast<const char*>(value.data), static_cast<int>(value.size)}}};
 }
 
+size_t WiredTigerRecordStoreCursorBase::nextBatch(std::vector<Record>* batch, size_t maxRecords) {
+    // Oplog cursors apply visibility rules to every record, so they are served one record at a
+    // time, as is a cursor that must return the record it is already positioned on.
+    if (_rs._isOplog || _skipNextAdvance) {
+        return SeekableRecordCursor::nextBatch(batch, maxRecords);
+    }
+
+    invariant(_hasRestored);
+    if (_eof)
+        return 0;
+
+    // Ensure an active transaction is open.
+    WiredTigerRecoveryUnit::get(_opCtx)->getSession();
+
+    WT_CURSOR* c = _cursor->get();
+    auto& metricsCollector = ResourceConsumption::MetricsCollector::get(_opCtx);
+
+    _batchBuffer.clear();
+    _batchEntries.clear();
+    RecordId lastId = _lastReturnedId;
+
+    // The whole batch is read under a single prepare conflict retry loop. A retry resumes after the
+    // last record that was read successfully, as a conflicting next() leaves the cursor in place.
+    int ret = wiredTigerPrepareConflictRetry(_opCtx, [&] {
+        while (_batchEntries.size() < maxRecords && _batchBuffer.size() < kMaxBatchBytes) {
+            int advanceRet = _forward ? c->next(c) : c->prev(c);
+            if (advanceRet != 0) {
+                return advanceRet;
+            }
+
+            RecordId id = getKey(c);
+            if (_forward && lastId >= id) {
+                LOGV2_ERROR(7132214,
+                            "WTCursor::nextBatch -- next key was not greater than the last key "
+                            "read, which is a bug",
+                            "next"_attr = id,
+                            "last"_attr = lastId);
+
+                // Crash when testing diagnostics are enabled.
+                invariant(!TestingProctor::instance().isEnabled(),
+                          "next was not greater than last");
+
+                // Force a retry of the operation from our last returned position. None of the
+                // records of this batch have been returned yet.
+                throw WriteConflictException();
+            }
+
+            WT_ITEM value;
+            invariantWTOK(c->get_value(c, &value), c->session);
+            metricsCollector.incrementOneDocRead(value.size + computeRecordIdSize(id));
+
+            const auto* data = static_cast<const char*>(value.data);
+            _batchEntries.push_back({id, _batchBuffer.size(), value.size});
+            _batchBuffer.insert(_batchBuffer.end(), data, data + value.size);
+            lastId = std::move(id);
+        }
+        return 0;
+    });
+    if (ret == WT_NOTFOUND) {
+        _eof = true;
+    } else {
+        invariantWTOK(ret, c->session);
+    }
+
+    if (_batchEntries.empty()) {
+        return 0;
+    }
+
+    _lastReturnedId = std::move(lastId);
+    if (_readAhead) {
+        _readAhead->onRead(_lastReturnedId, _batchEntries.size(), _batchBuffer.size());
+    }
+    for (auto&& entry : _batchEntries) {
+        batch->push_back({std::move(entry.id),
+                          {_batchBuffer.data() + entry.offset, static_cast<int>(entry.size)}});
+    }
+    return _batchEntries.size();
+}
+
+void WiredTigerRecordStoreCursorBase::enableReadAhead() {
+    // The read-ahead only walks forward. The oplog is read at its end, which is normally cached.
+    if (!_forward || _rs._isOplog || _readAhead || !_rs._kvEngine) {
+        return;
+    }
+
+    ThreadPool* pool = _rs._kvEngine->getReadAheadPool();
+    if (!pool || _rs.dataSize(_opCtx) < gWiredTigerReadAheadMinCollectionSizeBytes.load()) {
+        return;
+    }
+
+    _readAhead = std::make_unique<WiredTigerReadAhead>(
+        _rs._kvEngine->getConnection(), pool, _rs.getURI(), _rs.keyFormat());
+}
+
 boost::optional<Record> WiredTigerRecordStoreCursorBase::seekExact(const RecordId& id) {
     invariant(_hasRestored);
     if (_readTimestampForOplog && id.getLong() > *_readTimestampForOplog) {
@@ -38,6 +38,7 @@
 #include "mongo/db/storage/record_store.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_cursor.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_kv_engine.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_read_ahead.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_recovery_unit.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_size_storer.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
@@ -292,7 +293,10 @@ private:
                           const Timestamp* timestamps,
                           size_t nRecords);
 
-    RecordId _nextId(OperationContext* opCtx);
+    /**
+     * Reserves 'nIds' consecutive RecordIds and returns the first of them.
+     */
+    RecordId _reserveIds(OperationContext* opCtx, int64_t nIds);
     RecordData _getData(const WiredTigerCursor& cursor) const;
 
 
@@ -304,9 +308,9 @@ private:
     void _initNextIdIfNeeded(OperationContext* opCtx);
 
     /**
-     * Adjusts the record count and data size metadata for this record store, respectively. These
-     * functions consult the SizeRecoveryState to determine whether or not to actually change the
-     * size metadata if the server is undergoing recovery.
+     * Adjusts the record count and data size metadata for this record store together, or just the
+     * data size, respectively. These functions consult the SizeRecoveryState to determine whether
+     * or not to actually change the size metadata if the server is undergoing recovery.
      *
      * For most record stores, we will not update the size metadata during recovery, as we trust
      * that the values in the SizeStorer are accurate with respect to the end state of recovery.
@@ -320,7 +324,9 @@ private:
      *      are pending writes to this ident as part of the recovery process, and so we must
      *      always adjust size metadata for these idents.
      */
-    void _changeNumRecords(OperationContext* opCtx, int64_t diff);
+    void _changeNumRecordsAndDataSize(OperationContext* opCtx,
+                                      int64_t numRecordsDiff,
+                                      int64_t dataSizeDiff);
     void _increaseDataSize(OperationContext* opCtx, int64_t amount);
 
     const std::string _uri;
@@ -393,6 +399,10 @@ public:
 
     boost::optional<Record> next();
 
+    size_t nextBatch(std::vector<Record>* batch, size_t maxRecords) override;
+
+    void enableReadAhead() override;
+
     boost::optional<Record> seekExact(const RecordId& id);
 
     boost::optional<Record> seekNear(const RecordId& start);
@@ -450,6 +460,22 @@ private:
      */
     boost::optional<std::int64_t> _readTimestampForOplog = boost::none;
     bool _saveStorageCursorOnDetachFromOperationContext = false;
+
+    /**
+     * nextBatch() copies the values it reads into '_batchBuffer', since WiredTiger only keeps a
+     * value valid until its cursor moves. The records are described by '_batchEntries' until the
+     * buffer stops growing. Both are reused across calls to avoid allocating for every batch.
+     */
+    struct BatchEntry {
+        RecordId id;
+        size_t offset;
+        size_t size;
+    };
+    std::vector<char> _batchBuffer;
+    std::vector<BatchEntry> _batchEntries;
+
+    // Set by enableReadAhead() for a forward scan of a large collection.
+    std::unique_ptr<WiredTigerReadAhead> _readAhead;
 };
 
 class WiredTigerRecordStoreStandardCursor final : public WiredTigerRecordStoreCursorBase {
@@ -42,6 +42,8 @@
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/json.h"
 #include "mongo/db/operation_context_noop.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_parameters_gen.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_read_ahead.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_record_store.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_record_store_oplog_stones.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_record_store_test_harness.h"
@@ -1073,6 +1075,117 @@ TEST(WiredTigerRecordStoreTest, CursorInActiveTxnAfterSeek) {
     }
 }
 
+TEST(WiredTigerRecordStoreTest, ScanWithReadAhead) {
+    // Read ahead of every scan, in the smallest windows allowed.
+    const auto minCollectionSize = gWiredTigerReadAheadMinCollectionSizeBytes.swap(0);
+    const auto readAheadBytes = gWiredTigerReadAheadBytes.swap(64 * 1024);
+    ON_BLOCK_EXIT([&] {
+        gWiredTigerReadAheadMinCollectionSizeBytes.store(minCollectionSize);
+        gWiredTigerReadAheadBytes.store(readAheadBytes);
+    });
+
+    unique_ptr<RecordStoreHarnessHelper> harnessHelper(newRecordStoreHarnessHelper());
+    unique_ptr<RecordStore> rs(harnessHelper->newRecordStore());
+
+    const int nToInsert = 4000;
+    const std::string data(100, 'x');
+    {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        WriteUnitOfWork uow(opCtx.get());
+        for (int i = 0; i < nToInsert; i++) {
+            ASSERT_OK(rs->insertRecord(opCtx.get(), data.c_str(), data.size() + 1, Timestamp())
+                          .getStatus());
+        }
+        uow.commit();
+    }
+
+    auto tasksScheduled = [] {
+        BSONObjBuilder builder;
+        WiredTigerReadAhead::appendStats(&builder);
+        return builder.obj()["tasks scheduled"].numberLong();
+    };
+    const auto tasksBefore = tasksScheduled();
+
+    // The read-ahead does not change what the scan returns, whether it reads one record at a time
+    // or in batches.
+    for (bool batched : {false, true}) {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        auto cursor = rs->getCursor(opCtx.get());
+        cursor->enableReadAhead();
+
+        RecordId lastId;
+        int nRead = 0;
+        std::vector<Record> batch;
+        while (true) {
+            batch.clear();
+            if (batched) {
+                if (!cursor->nextBatch(&batch, 64)) {
+                    break;
+                }
+            } else if (auto record = cursor->next()) {
+                batch.push_back(std::move(*record));
+            } else {
+                break;
+            }
+            for (auto&& record : batch) {
+                ASSERT_GT(record.id, lastId);
+                ASSERT_EQ(data, record.data.data());
+                lastId = record.id;
+                ++nRead;
+            }
+        }
+        ASSERT_EQ(nToInsert, nRead);
+    }
+    ASSERT_GT(tasksScheduled(), tasksBefore);
+}
+
+TEST(WiredTigerRecordStoreTest, InsertBatchReservesConsecutiveRecordIds) {
+    unique_ptr<RecordStoreHarnessHelper> harnessHelper(newRecordStoreHarnessHelper());
+    unique_ptr<RecordStore> rs(harnessHelper->newRecordStore());
+
+    const std::string data = "data";
+    auto makeBatch = [&](size_t nRecords) {
+        std::vector<Record> records;
+        for (size_t i = 0; i < nRecords; i++) {
+            records.push_back({RecordId(), RecordData(data.c_str(), data.size() + 1)});
+        }
+        return records;
+    };
+
+    ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+    auto first = makeBatch(10);
+    {
+        WriteUnitOfWork uow(opCtx.get());
+        ASSERT_OK(rs->insertRecords(opCtx.get(), &first, std::vector<Timestamp>(10)));
+        uow.commit();
+    }
+    for (size_t i = 1; i < first.size(); i++) {
+        ASSERT_EQ(first[i - 1].id.getLong() + 1, first[i].id.getLong());
+    }
+    ASSERT_EQ(10, rs->numRecords(opCtx.get()));
+    ASSERT_EQ(10 * static_cast<long long>(data.size() + 1), rs->dataSize(opCtx.get()));
+
+    // A rolled back batch leaves the record count and data size as they were, and the next batch
+    // does not reuse its RecordIds.
+    auto rolledBack = makeBatch(5);
+    {
+        WriteUnitOfWork uow(opCtx.get());
+        ASSERT_OK(rs->insertRecords(opCtx.get(), &rolledBack, std::vector<Timestamp>(5)));
+        ASSERT_EQ(15, rs->numRecords(opCtx.get()));
+    }
+    ASSERT_EQ(10, rs->numRecords(opCtx.get()));
+    ASSERT_EQ(10 * static_cast<long long>(data.size() + 1), rs->dataSize(opCtx.get()));
+
+    auto second = makeBatch(3);
+    {
+        WriteUnitOfWork uow(opCtx.get());
+        ASSERT_OK(rs->insertRecords(opCtx.get(), &second, std::vector<Timestamp>(3)));
+        uow.commit();
+    }
+    ASSERT_GT(second.front().id, rolledBack.back().id);
+    ASSERT_EQ(13, rs->numRecords(opCtx.get()));
+}
+
 // Verify clustered record stores.
 // This test case complements StorageEngineTest:TemporaryRecordStoreClustered which verifies
 // clustered temporary record stores.
@@ -41,8 +41,11 @@ DeltaExecutor::ApplyResult DeltaExecutor::applyUpdate(
     UpdateExecutor::ApplyParams applyParams) const {
     const auto originalDoc = applyParams.element.getDocument().getObject();
 
-    auto applyDiffOutput = doc_diff::applyDiff(
-        originalDoc, _diff, applyParams.indexData, _mustCheckExistenceForInsertOperations);
+    auto applyDiffOutput = doc_diff::applyDiff(originalDoc,
+                                               _diff,
+                                               applyParams.indexData,
+                                               _mustCheckExistenceForInsertOperations,
+                                               applyParams.modifiedPaths);
     const auto& postImage = applyDiffOutput.postImage;
     auto postImageHasId = postImage.hasField("_id");
 
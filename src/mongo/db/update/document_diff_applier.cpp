@@ -483,9 +483,12 @@ int32_t computeDamageOnArray(const BSONObj& preImageRoot,
 
 class DiffApplier {
 public:
-    DiffApplier(const UpdateIndexData* indexData, bool mustCheckExistenceForInsertOperations)
+    DiffApplier(const UpdateIndexData* indexData,
+                bool mustCheckExistenceForInsertOperations,
+                FieldRefSetWithStorage* modifiedPaths)
         : _indexData(indexData),
-          _mustCheckExistenceForInsertOperations{mustCheckExistenceForInsertOperations} {}
+          _mustCheckExistenceForInsertOperations{mustCheckExistenceForInsertOperations},
+          _modifiedPaths(modifiedPaths) {}
 
     void applyDiffToObject(const BSONObj& preImage,
                            FieldRef* path,
@@ -583,6 +586,11 @@ public:
                 // If the path is empty, then the field names are being appended at the top level.
                 // This means that they cannot represent indices of an array, so the 'canonical'
                 // path check does not apply.
+                // A field that is not a canonical index path component is recorded as a write to
+                // its parent, which covers the inserts whose index check is skipped below.
+                if (_modifiedPaths && !isComponentPartOfCanonicalizedIndexPath && !path->empty()) {
+                    _modifiedPaths->keepShortest(*path);
+                }
                 if (isComponentPartOfCanonicalizedIndexPath ||
                     !alreadyDidUpdateIndexAffectedForBasePath || path->empty()) {
                     FieldRef::FieldRefTempAppend tempAppend(*path, elt.fieldNameStringData());
@@ -705,21 +713,26 @@ private:
         if (_indexData) {
             _indexesAffected = _indexesAffected || _indexData->mightBeIndexed(*path);
         }
+        if (_modifiedPaths) {
+            _modifiedPaths->keepShortest(*path);
+        }
     }
 
     const UpdateIndexData* _indexData;
     bool _mustCheckExistenceForInsertOperations = true;
     bool _indexesAffected = false;
+    FieldRefSetWithStorage* _modifiedPaths;
 };
 }  // namespace
 
 ApplyDiffOutput applyDiff(const BSONObj& pre,
                           const Diff& diff,
                           const UpdateIndexData* indexData,
-                          bool mustCheckExistenceForInsertOperations) {
+                          bool mustCheckExistenceForInsertOperations,
+                          FieldRefSetWithStorage* modifiedPaths) {
     DocumentDiffReader reader(diff);
     BSONObjBuilder out;
-    DiffApplier applier(indexData, mustCheckExistenceForInsertOperations);
+    DiffApplier applier(indexData, mustCheckExistenceForInsertOperations, modifiedPaths);
     FieldRef path;
 
     // Use size of pre + diff as an approximation for size needed for post object when the diff is
@@ -30,6 +30,7 @@
 #pragma once
 
 #include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/field_ref_set.h"
 #include "mongo/db/update/document_diff_serialization.h"
 #include "mongo/db/update_index_data.h"
 
@@ -54,11 +55,15 @@ struct DamagesOutput {
  * inserted field already exists within a (sub)document. This should generally be set to true,
  * unless the caller has knowledge of the pre-image and the diff, and can guarantee that we will not
  * re-insert anything.
+ *
+ * If 'modifiedPaths' is not null, it is populated with the paths written by the diff, so that
+ * callers can tell which individual indexes need their keys regenerated.
  */
 ApplyDiffOutput applyDiff(const BSONObj& pre,
                           const Diff& diff,
                           const UpdateIndexData* indexData,
-                          bool mustCheckExistenceForInsertOperations);
+                          bool mustCheckExistenceForInsertOperations,
+                          FieldRefSetWithStorage* modifiedPaths = nullptr);
 
 /**
  * Computes the damage events from the diff for 'pre' and return the pre-image, damage source, and
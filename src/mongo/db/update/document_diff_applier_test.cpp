@@ -352,6 +352,39 @@ TEST(DiffApplierTest, UpdateArrayOfObjectsWithUpdateOperationNonContiguous) {
     checkDiff(preImage, fromjson("{dummyA: 1, arr: null, dummyB: 1}"), diff);
 }
 
+TEST(DiffApplierTest, ReportsModifiedPaths) {
+    const BSONObj preImage(
+        BSON("a" << 0 << "obj" << BSON("x" << 0 << "y" << 0) << "arr" << BSON_ARRAY(0 << 0)
+                 << "untouched" << 0));
+
+    const BSONObj storage(BSON("a" << 1 << "b" << 2 << "c" << 3));
+    diff_tree::DocumentSubDiffNode diffNode;
+    diffNode.addUpdate("a", storage["a"]);
+    {
+        auto subDiffNode = std::make_unique<diff_tree::DocumentSubDiffNode>();
+        subDiffNode->addUpdate("x", storage["b"]);
+        diffNode.addChild("obj", std::move(subDiffNode));
+    }
+    {
+        auto subDiffNode = std::make_unique<diff_tree::ArrayNode>();
+        subDiffNode->addUpdate(1, storage["c"]);
+        diffNode.addChild("arr", std::move(subDiffNode));
+    }
+
+    FieldRefSetWithStorage modifiedPaths;
+    UpdateIndexData indexData;
+    indexData.addPath(FieldRef("untouched"));
+    auto output = applyDiff(preImage, diffNode.serialize(), &indexData, true, &modifiedPaths);
+    ASSERT_FALSE(output.indexesAffected);
+
+    auto paths = modifiedPaths.serialize();
+    std::sort(paths.begin(), paths.end());
+    ASSERT_EQ(3U, paths.size());
+    ASSERT_EQ("a", paths[0]);
+    ASSERT_EQ("arr.1", paths[1]);
+    ASSERT_EQ("obj.x", paths[2]);
+}
+
 TEST(DiffApplierTest, DiffWithDuplicateFields) {
     BSONObj diff = fromjson("{d: {dupField: false}, u: {dupField: 'new value'}}");
     ASSERT_THROWS_CODE(applyDiffTestHelper(BSONObj(), diff), DBException, 4728000);
@@ -102,7 +102,8 @@ public:
         // a noop, an oplog entry may not be produced.
         LogMode logMode = LogMode::kDoNotGenerateOplogEntry;
 
-        // If provided, UpdateNode::apply will populate this with a path to each modified field.
+        // If provided, UpdateNode::apply and DeltaExecutor::applyUpdate will populate this with a
+        // path to each modified field.
         FieldRefSetWithStorage* modifiedPaths = nullptr;
     };
 
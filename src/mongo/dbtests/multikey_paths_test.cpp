@@ -33,7 +33,9 @@
 #include <string>
 
 #include "mongo/db/client.h"
+#include "mongo/db/curop.h"
 #include "mongo/db/db_raii.h"
+#include "mongo/db/field_ref_set.h"
 #include "mongo/db/index/index_descriptor.h"
 #include "mongo/db/index/multikey_paths.h"
 #include "mongo/db/namespace_string.h"
@@ -261,6 +263,69 @@ TEST_F(MultikeyPathsTest, PathsUpdatedOnDocumentUpdate) {
     assertMultikeyPaths(collection.getCollection(), keyPattern, {MultikeyComponents{}, {0U}});
 }
 
+TEST_F(MultikeyPathsTest, OnlyIndexesOverModifiedPathsUpdatedOnDocumentUpdate) {
+    AutoGetCollection collection(_opCtx.get(), _nss, MODE_X);
+    invariant(collection);
+
+    BSONObj keyPatternAB = BSON("a" << 1 << "b" << 1);
+    createIndex(collection.getCollection(),
+                BSON("name"
+                     << "a_1_b_1"
+                     << "key" << keyPatternAB << "v" << static_cast<int>(kIndexVersion)))
+        .transitional_ignore();
+
+    BSONObj keyPatternC = BSON("c" << 1);
+    createIndex(collection.getCollection(),
+                BSON("name"
+                     << "c_1"
+                     << "key" << keyPatternC << "v" << static_cast<int>(kIndexVersion)))
+        .transitional_ignore();
+
+    {
+        WriteUnitOfWork wuow(_opCtx.get());
+        OpDebug* const nullOpDebug = nullptr;
+        ASSERT_OK(collection->insertDocument(
+            _opCtx.get(),
+            InsertStatement(BSON("_id" << 0 << "a" << 5 << "b" << 5 << "c" << 5)),
+            nullOpDebug));
+        wuow.commit();
+    }
+
+    {
+        auto cursor = collection->getCursor(_opCtx.get());
+        auto record = cursor->next();
+        invariant(record);
+
+        auto oldDoc = collection->docFor(_opCtx.get(), record->id);
+        {
+            WriteUnitOfWork wuow(_opCtx.get());
+            const bool indexesAffected = true;
+            OpDebug opDebug;
+            FieldRefSetWithStorage modifiedPaths;
+            modifiedPaths.keepShortest(FieldRef("c"));
+            CollectionUpdateArgs args;
+            args.modifiedPaths = &modifiedPaths.getFieldRefSet();
+            collection->updateDocument(
+                _opCtx.get(),
+                record->id,
+                oldDoc,
+                BSON("_id" << 0 << "a" << 5 << "b" << 5 << "c" << BSON_ARRAY(1 << 2)),
+                indexesAffected,
+                &opDebug,
+                &args);
+            wuow.commit();
+
+            // Only the index over 'c' regenerated its keys.
+            ASSERT_EQ(2, *opDebug.additiveMetrics.keysInserted);
+            ASSERT_EQ(1, *opDebug.additiveMetrics.keysDeleted);
+        }
+    }
+
+    assertMultikeyPaths(
+        collection.getCollection(), keyPatternAB, {MultikeyComponents{}, MultikeyComponents{}});
+    assertMultikeyPaths(collection.getCollection(), keyPatternC, {{0U}});
+}
+
 TEST_F(MultikeyPathsTest, PathsNotUpdatedOnDocumentDelete) {
     AutoGetCollection collection(_opCtx.get(), _nss, MODE_X);
     invariant(collection);